@@ -11,3 +11,9 @@ UNITTESTS {
   YUViewUnitTest.subdir = YUViewUnitTest
   YUViewUnitTest.depends = YUViewLib
 }
+
+BENCHMARKS {
+  SUBDIRS += YUViewBenchmark
+  YUViewBenchmark.subdir = YUViewBenchmark
+  YUViewBenchmark.depends = YUViewLib
+}
@@ -32,11 +32,16 @@
 
 #include <QCoreApplication>
 
+#include <batch/BatchProcessor.h>
 #include <common/Typedef.h>
 #include <ui/YUViewApplication.h>
 
 int main(int argc, char *argv[])
 {
+  // The batch mode does not show a window. The offscreen platform does not need a display.
+  if (BatchProcessor::isBatchMode(argc, argv) && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
 #if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0) && QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
   QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling); // DPI support
   QCoreApplication::setAttribute(Qt::AA_UseHighDpiPixmaps); // DPI support
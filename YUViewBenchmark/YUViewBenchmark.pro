@@ -0,0 +1,43 @@
+QT += core gui widgets opengl xml concurrent network
+
+TEMPLATE = app
+CONFIG += console
+CONFIG += c++1z
+CONFIG -= debug_and_release
+CONFIG -= app_bundle
+
+TARGET = YUViewBenchmark
+
+SOURCES += $$files(src/*.cpp, false)
+HEADERS += $$files(src/*.h, false)
+
+INCLUDEPATH += $$top_srcdir/YUViewLib/src
+LIBS += -L$$top_builddir/YUViewLib -lYUViewLib
+
+win32-msvc* {
+    PRE_TARGETDEPS += $$top_builddir/YUViewLib/YUViewLib.lib
+} else {
+    PRE_TARGETDEPS += $$top_builddir/YUViewLib/libYUViewLib.a
+}
+
+# The version and commit are written to the results so that measurements can be tracked over time
+SVNN = $$system("git describe --tags")
+LASTHASH = $$system("git rev-parse HEAD")
+isEmpty(LASTHASH) {
+    LASTHASH = 0
+}
+isEmpty(SVNN) {
+    SVNN = 0
+}
+
+win32-msvc* {
+    HASHSTRING = '\\"$${LASTHASH}\\"'
+    DEFINES += YUVIEW_HASH=$${HASHSTRING}
+}
+win32-g++ | linux | macx {
+    HASHSTRING = '\\"$${LASTHASH}\\"'
+    DEFINES += YUVIEW_HASH=\"$${HASHSTRING}\"
+}
+
+VERSTR = '\\"$${SVNN}\\"'
+DEFINES += YUVIEW_VERSION=$${VERSTR}
@@ -0,0 +1,179 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRunner.h"
+
+#include <common/CPUFeatures.h>
+#include <common/Typedef.h>
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QThread>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+#ifndef YUVIEW_HASH
+#define YUVIEW_HASH "0"
+#endif
+
+namespace benchmark
+{
+
+namespace
+{
+
+// Increase this if the workloads change so that old results are not compared to new ones
+constexpr auto BenchmarkVersion = 1;
+
+using Clock = std::chrono::steady_clock;
+
+double toMilliseconds(Clock::duration duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+void BenchmarkRunner::add(Benchmark &&benchmark)
+{
+  this->benchmarks.push_back(std::move(benchmark));
+}
+
+QStringList BenchmarkRunner::getNames() const
+{
+  QStringList names;
+  for (const auto &benchmark : this->benchmarks)
+    names.append(benchmark.name);
+  return names;
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::run(const Settings &settings) const
+{
+  std::vector<BenchmarkResult> results;
+  for (const auto &benchmark : this->benchmarks)
+  {
+    if (!settings.filter.pattern().isEmpty() && !settings.filter.match(benchmark.name).hasMatch())
+      continue;
+
+    std::cerr << std::left << std::setw(40) << benchmark.name.toStdString() << std::flush;
+
+    BenchmarkResult result;
+    result.name = benchmark.name;
+    result.unit = benchmark.unit;
+
+    std::vector<double> times;
+    double              unitsPerRun{};
+    try
+    {
+      auto workload = benchmark.setup();
+      unitsPerRun   = workload.unitsPerRun;
+      workload.run();
+
+      const auto start = Clock::now();
+      while (times.size() < settings.maxRuns &&
+             (times.size() < settings.minRuns || Clock::now() - start < settings.minTime))
+      {
+        const auto runStart = Clock::now();
+        workload.run();
+        times.push_back(toMilliseconds(Clock::now() - runStart));
+      }
+    }
+    catch (const std::exception &exception)
+    {
+      result.error = QString::fromStdString(exception.what());
+      std::cerr << "failed: " << exception.what() << "\n";
+      results.push_back(result);
+      continue;
+    }
+
+    result.runs   = unsigned(times.size());
+    result.minMs  = *std::min_element(times.begin(), times.end());
+    result.meanMs = std::accumulate(times.begin(), times.end(), 0.0) / double(times.size());
+    std::sort(times.begin(), times.end());
+    const auto middle = times.size() / 2;
+    result.medianMs =
+        (times.size() % 2 == 1) ? times[middle] : (times[middle - 1] + times[middle]) / 2.0;
+    if (result.medianMs > 0.0)
+      result.throughput = unitsPerRun / (result.medianMs / 1000.0);
+
+    std::cerr << std::right << std::fixed << std::setprecision(3) << std::setw(12)
+              << result.medianMs << " ms " << std::setw(12) << std::setprecision(1)
+              << result.throughput << " " << result.unit.toStdString() << "/s\n";
+
+    results.push_back(result);
+  }
+  return results;
+}
+
+QJsonDocument BenchmarkRunner::toJSON(const std::vector<BenchmarkResult> &results)
+{
+  QJsonObject system;
+  system["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+  system["os"]              = QSysInfo::prettyProductName();
+  system["qt"]              = QString(qVersion());
+  system["threads"]         = QThread::idealThreadCount();
+  system["simd"]            = QString::fromStdString(
+      functions::SIMDInstructionSetMapper.getName(functions::getSIMDInstructionSet()));
+
+  QJsonArray benchmarks;
+  for (const auto &result : results)
+  {
+    QJsonObject entry;
+    entry["name"]       = result.name;
+    entry["unit"]       = result.unit;
+    entry["runs"]       = int(result.runs);
+    entry["minMs"]      = result.minMs;
+    entry["medianMs"]   = result.medianMs;
+    entry["meanMs"]     = result.meanMs;
+    entry["throughput"] = result.throughput;
+    if (!result.error.isEmpty())
+      entry["error"] = result.error;
+    benchmarks.append(entry);
+  }
+
+  QJsonObject root;
+  root["benchmarkVersion"] = BenchmarkVersion;
+  root["version"]          = QString(YUVIEW_VERSION);
+  root["commit"]           = QString(YUVIEW_HASH);
+  root["date"]             = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+  root["system"]           = system;
+  root["benchmarks"]       = benchmarks;
+  return QJsonDocument(root);
+}
+
+} // namespace benchmark
@@ -0,0 +1,105 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QString>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace benchmark
+{
+
+// The prepared work of a benchmark. Everything that should not be measured (generating the input
+// data, opening files) is done when the workload is created. Only run is timed.
+struct Workload
+{
+  std::function<void()> run;
+  double                unitsPerRun{}; // The amount of work of one run in the benchmark unit
+};
+
+struct Benchmark
+{
+  QString                   name; // Hierarchical name, e.g. "conversion/420/8bit"
+  QString                   unit; // The unit of the throughput, e.g. "MPixel" or "MB"
+  std::function<Workload()> setup;
+};
+
+struct BenchmarkResult
+{
+  QString  name;
+  QString  unit;
+  unsigned runs{};
+  double   minMs{};
+  double   medianMs{};
+  double   meanMs{};
+  double   throughput{}; // Units per second (using the median time)
+  QString  error;        // Set if the benchmark could not be run
+};
+
+/* Runs a list of benchmarks one after another. Every benchmark is run once without measuring
+ * (to warm up the caches and the thread pools) and then repeatedly until the minimum time and the
+ * minimum number of runs are reached. The median of all runs is used as the result because it is
+ * less sensitive to outliers than the mean.
+ */
+class BenchmarkRunner
+{
+public:
+  struct Settings
+  {
+    std::chrono::milliseconds minTime{500};
+    unsigned                  minRuns{5};
+    unsigned                  maxRuns{1000};
+    QRegularExpression        filter;
+  };
+
+  void add(Benchmark &&benchmark);
+
+  QStringList getNames() const;
+
+  // Run all benchmarks that match the filter. The progress is written to stderr. A benchmark that
+  // throws an exception is reported with the error and the next one is run.
+  std::vector<BenchmarkResult> run(const Settings &settings) const;
+
+  // The results together with the system information so that results from different machines and
+  // commits can be compared.
+  static QJsonDocument toJSON(const std::vector<BenchmarkResult> &results);
+
+private:
+  std::vector<Benchmark> benchmarks;
+};
+
+} // namespace benchmark
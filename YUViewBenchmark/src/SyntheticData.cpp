@@ -0,0 +1,624 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyntheticData.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace benchmark::synthetic
+{
+
+namespace
+{
+
+// Writes the syntax elements of a raw byte sequence payload (RBSP) MSB first
+class BitWriter
+{
+public:
+  void writeBits(uint64_t value, unsigned nrBits)
+  {
+    for (int i = int(nrBits) - 1; i >= 0; i--)
+      this->writeBit((value >> i) & 1);
+  }
+  void writeFlag(bool flag) { this->writeBit(flag); }
+
+  // Exponential-Golomb code ue(v)
+  void writeUEV(uint64_t value)
+  {
+    unsigned nrBits = 0;
+    while (((value + 1) >> (nrBits + 1)) > 0)
+      nrBits++;
+    this->writeBits(0, nrBits);
+    this->writeBits(value + 1, nrBits + 1);
+  }
+  // Signed Exponential-Golomb code se(v)
+  void writeSEV(int64_t value)
+  {
+    this->writeUEV(value > 0 ? uint64_t(value) * 2 - 1 : uint64_t(-value) * 2);
+  }
+
+  // A stop bit followed by zero bits until the next byte boundary. This is the
+  // rbsp_trailing_bits() and the byte_alignment() syntax.
+  void writeStopBitAndAlign()
+  {
+    this->writeBit(true);
+    while (this->nrBitsInByte != 0)
+      this->writeBit(false);
+  }
+
+  void writeRandomBytes(size_t nrBytes, std::mt19937 &random)
+  {
+    std::uniform_int_distribution<int> byteDistribution(0, 255);
+    for (size_t i = 0; i < nrBytes; i++)
+      this->writeBits(unsigned(byteDistribution(random)), 8);
+  }
+
+  const std::vector<unsigned char> &getData() const { return this->data; }
+
+private:
+  void writeBit(bool bit)
+  {
+    this->currentByte = (this->currentByte << 1) | (bit ? 1 : 0);
+    if (++this->nrBitsInByte == 8)
+    {
+      this->data.push_back(this->currentByte);
+      this->currentByte  = 0;
+      this->nrBitsInByte = 0;
+    }
+  }
+
+  std::vector<unsigned char> data;
+  unsigned char              currentByte{};
+  unsigned                   nrBitsInByte{};
+};
+
+// Append a NAL unit with a 4 byte start code. Emulation prevention bytes are inserted into the
+// payload so that it can not contain a start code.
+void appendNALUnit(QByteArray &                      stream,
+                   const std::vector<unsigned char> &header,
+                   const BitWriter &                 rbsp)
+{
+  stream.append("\x00\x00\x00\x01", 4);
+  for (auto byte : header)
+    stream.append(char(byte));
+
+  unsigned nrZeroBytes = 0;
+  for (auto byte : rbsp.getData())
+  {
+    if (nrZeroBytes == 2 && byte <= 3)
+    {
+      stream.append(char(3));
+      nrZeroBytes = 0;
+    }
+    stream.append(char(byte));
+    nrZeroBytes = (byte == 0) ? nrZeroBytes + 1 : 0;
+  }
+}
+
+size_t getSliceDataSize(const Size &frameSize, bool intra, std::mt19937 &random)
+{
+  // Roughly what an encoder produces at medium quality. Intra frames are much larger.
+  const auto averageSize = frameSize.width * frameSize.height / (intra ? 50 : 400);
+  std::uniform_int_distribution<size_t> sizeDistribution(averageSize * 3 / 4, averageSize * 5 / 4);
+  return sizeDistribution(random);
+}
+
+// AVC (ITU-T H.264): Baseline profile, 4:2:0, pic_order_cnt_type 0, CAVLC
+QByteArray
+generateAVCStream(const Size &frameSize, unsigned nrFrames, unsigned gopSize, std::mt19937 &random)
+{
+  constexpr unsigned log2MaxFrameNum = 8;
+  constexpr unsigned log2MaxPocLsb   = 8;
+
+  const auto widthInMbs  = (frameSize.width + 15) / 16;
+  const auto heightInMbs = (frameSize.height + 15) / 16;
+  const auto cropRight   = (widthInMbs * 16 - frameSize.width) / 2;
+  const auto cropBottom  = (heightInMbs * 16 - frameSize.height) / 2;
+
+  QByteArray stream;
+  for (unsigned frame = 0; frame < nrFrames; frame++)
+  {
+    const auto frameInGop = frame % gopSize;
+    const bool idr        = (frameInGop == 0);
+
+    if (idr)
+    {
+      BitWriter sps;
+      sps.writeBits(66, 8); // profile_idc
+      sps.writeBits(0, 8);  // constraint_set0..5_flag, reserved_zero_2bits
+      sps.writeBits(40, 8); // level_idc
+      sps.writeUEV(0);      // seq_parameter_set_id
+      sps.writeUEV(log2MaxFrameNum - 4);
+      sps.writeUEV(0); // pic_order_cnt_type
+      sps.writeUEV(log2MaxPocLsb - 4);
+      sps.writeUEV(1);      // max_num_ref_frames
+      sps.writeFlag(false); // gaps_in_frame_num_value_allowed_flag
+      sps.writeUEV(widthInMbs - 1);
+      sps.writeUEV(heightInMbs - 1);
+      sps.writeFlag(true); // frame_mbs_only_flag
+      sps.writeFlag(true); // direct_8x8_inference_flag
+      sps.writeFlag(cropRight > 0 || cropBottom > 0);
+      if (cropRight > 0 || cropBottom > 0)
+      {
+        sps.writeUEV(0);
+        sps.writeUEV(cropRight);
+        sps.writeUEV(0);
+        sps.writeUEV(cropBottom);
+      }
+      sps.writeFlag(false); // vui_parameters_present_flag
+      sps.writeStopBitAndAlign();
+      appendNALUnit(stream, {0x67}, sps);
+
+      BitWriter pps;
+      pps.writeUEV(0);      // pic_parameter_set_id
+      pps.writeUEV(0);      // seq_parameter_set_id
+      pps.writeFlag(false); // entropy_coding_mode_flag
+      pps.writeFlag(false); // bottom_field_pic_order_in_frame_present_flag
+      pps.writeUEV(0);      // num_slice_groups_minus1
+      pps.writeUEV(0);      // num_ref_idx_l0_default_active_minus1
+      pps.writeUEV(0);      // num_ref_idx_l1_default_active_minus1
+      pps.writeFlag(false); // weighted_pred_flag
+      pps.writeBits(0, 2);  // weighted_bipred_idc
+      pps.writeSEV(0);      // pic_init_qp_minus26
+      pps.writeSEV(0);      // pic_init_qs_minus26
+      pps.writeSEV(0);      // chroma_qp_index_offset
+      pps.writeFlag(false); // deblocking_filter_control_present_flag
+      pps.writeFlag(false); // constrained_intra_pred_flag
+      pps.writeFlag(false); // redundant_pic_cnt_present_flag
+      pps.writeStopBitAndAlign();
+      appendNALUnit(stream, {0x68}, pps);
+    }
+
+    BitWriter slice;
+    slice.writeUEV(0);           // first_mb_in_slice
+    slice.writeUEV(idr ? 2 : 0); // slice_type (I or P)
+    slice.writeUEV(0);           // pic_parameter_set_id
+    slice.writeBits(frameInGop, log2MaxFrameNum);
+    if (idr)
+      slice.writeUEV((frame / gopSize) % 2); // idr_pic_id
+    slice.writeBits((frameInGop * 2) % (1u << log2MaxPocLsb), log2MaxPocLsb);
+    if (!idr)
+    {
+      slice.writeFlag(false); // num_ref_idx_active_override_flag
+      slice.writeFlag(false); // ref_pic_list_modification_flag_l0
+    }
+    // dec_ref_pic_marking()
+    if (idr)
+    {
+      slice.writeFlag(false); // no_output_of_prior_pics_flag
+      slice.writeFlag(false); // long_term_reference_flag
+    }
+    else
+      slice.writeFlag(false); // adaptive_ref_pic_marking_mode_flag
+    slice.writeSEV(0);        // slice_qp_delta
+    slice.writeStopBitAndAlign();
+    slice.writeRandomBytes(getSliceDataSize(frameSize, idr, random), random);
+    slice.writeStopBitAndAlign();
+    appendNALUnit(stream, {idr ? (unsigned char)(0x65) : (unsigned char)(0x41)}, slice);
+  }
+  return stream;
+}
+
+// HEVC (ITU-T H.265): Main profile, 4:2:0, CTUs of 64x64, one slice per frame
+QByteArray
+generateHEVCStream(const Size &frameSize, unsigned nrFrames, unsigned gopSize, std::mt19937 &random)
+{
+  constexpr unsigned log2MaxPocLsb = 8;
+
+  auto writeProfileTierLevel = [](BitWriter &writer) {
+    writer.writeBits(0, 2);           // general_profile_space
+    writer.writeFlag(false);          // general_tier_flag
+    writer.writeBits(1, 5);           // general_profile_idc (Main)
+    writer.writeBits(0x60000000, 32); // general_profile_compatibility_flag[1] and [2]
+    writer.writeFlag(true);           // general_progressive_source_flag
+    writer.writeFlag(false);          // general_interlaced_source_flag
+    writer.writeFlag(false);          // general_non_packed_constraint_flag
+    writer.writeFlag(true);           // general_frame_only_constraint_flag
+    writer.writeBits(0, 43);          // general_reserved_zero_43bits
+    writer.writeFlag(false);          // general_inbld_flag
+    writer.writeBits(120, 8);         // general_level_idc (4.0)
+  };
+
+  QByteArray stream;
+  for (unsigned frame = 0; frame < nrFrames; frame++)
+  {
+    const auto frameInGop = frame % gopSize;
+    const bool idr        = (frameInGop == 0);
+
+    if (idr)
+    {
+      BitWriter vps;
+      vps.writeBits(0, 4);       // vps_video_parameter_set_id
+      vps.writeFlag(true);       // vps_base_layer_internal_flag
+      vps.writeFlag(true);       // vps_base_layer_available_flag
+      vps.writeBits(0, 6);       // vps_max_layers_minus1
+      vps.writeBits(0, 3);       // vps_max_sub_layers_minus1
+      vps.writeFlag(true);       // vps_temporal_id_nesting_flag
+      vps.writeBits(0xffff, 16); // vps_reserved_0xffff_16bits
+      writeProfileTierLevel(vps);
+      vps.writeFlag(true);   // vps_sub_layer_ordering_info_present_flag
+      vps.writeUEV(1);       // vps_max_dec_pic_buffering_minus1
+      vps.writeUEV(0);       // vps_max_num_reorder_pics
+      vps.writeUEV(0);       // vps_max_latency_increase_plus1
+      vps.writeBits(0, 6);   // vps_max_layer_id
+      vps.writeUEV(0);       // vps_num_layer_sets_minus1
+      vps.writeFlag(true);   // vps_timing_info_present_flag
+      vps.writeBits(1, 32);  // vps_num_units_in_tick
+      vps.writeBits(25, 32); // vps_time_scale
+      vps.writeFlag(false);  // vps_poc_proportional_to_timing_flag
+      vps.writeUEV(0);       // vps_num_hrd_parameters
+      vps.writeFlag(false);  // vps_extension_flag
+      vps.writeStopBitAndAlign();
+      appendNALUnit(stream, {32 << 1, 1}, vps);
+
+      BitWriter sps;
+      sps.writeBits(0, 4); // sps_video_parameter_set_id
+      sps.writeBits(0, 3); // sps_max_sub_layers_minus1
+      sps.writeFlag(true); // sps_temporal_id_nesting_flag
+      writeProfileTierLevel(sps);
+      sps.writeUEV(0); // sps_seq_parameter_set_id
+      sps.writeUEV(1); // chroma_format_idc
+      sps.writeUEV(frameSize.width);
+      sps.writeUEV(frameSize.height);
+      sps.writeFlag(false); // conformance_window_flag
+      sps.writeUEV(0);      // bit_depth_luma_minus8
+      sps.writeUEV(0);      // bit_depth_chroma_minus8
+      sps.writeUEV(log2MaxPocLsb - 4);
+      sps.writeFlag(true);  // sps_sub_layer_ordering_info_present_flag
+      sps.writeUEV(1);      // sps_max_dec_pic_buffering_minus1
+      sps.writeUEV(0);      // sps_max_num_reorder_pics
+      sps.writeUEV(0);      // sps_max_latency_increase_plus1
+      sps.writeUEV(0);      // log2_min_luma_coding_block_size_minus3
+      sps.writeUEV(3);      // log2_diff_max_min_luma_coding_block_size
+      sps.writeUEV(0);      // log2_min_luma_transform_block_size_minus2
+      sps.writeUEV(3);      // log2_diff_max_min_luma_transform_block_size
+      sps.writeUEV(0);      // max_transform_hierarchy_depth_inter
+      sps.writeUEV(0);      // max_transform_hierarchy_depth_intra
+      sps.writeFlag(false); // scaling_list_enabled_flag
+      sps.writeFlag(false); // amp_enabled_flag
+      sps.writeFlag(false); // sample_adaptive_offset_enabled_flag
+      sps.writeFlag(false); // pcm_enabled_flag
+      sps.writeUEV(0);      // num_short_term_ref_pic_sets
+      sps.writeFlag(false); // long_term_ref_pics_present_flag
+      sps.writeFlag(false); // sps_temporal_mvp_enabled_flag
+      sps.writeFlag(false); // strong_intra_smoothing_enabled_flag
+      sps.writeFlag(false); // vui_parameters_present_flag
+      sps.writeFlag(false); // sps_extension_present_flag
+      sps.writeStopBitAndAlign();
+      appendNALUnit(stream, {33 << 1, 1}, sps);
+
+      BitWriter pps;
+      pps.writeUEV(0);      // pps_pic_parameter_set_id
+      pps.writeUEV(0);      // pps_seq_parameter_set_id
+      pps.writeFlag(false); // dependent_slice_segments_enabled_flag
+      pps.writeFlag(false); // output_flag_present_flag
+      pps.writeBits(0, 3);  // num_extra_slice_header_bits
+      pps.writeFlag(false); // sign_data_hiding_enabled_flag
+      pps.writeFlag(false); // cabac_init_present_flag
+      pps.writeUEV(0);      // num_ref_idx_l0_default_active_minus1
+      pps.writeUEV(0);      // num_ref_idx_l1_default_active_minus1
+      pps.writeSEV(0);      // init_qp_minus26
+      pps.writeFlag(false); // constrained_intra_pred_flag
+      pps.writeFlag(false); // transform_skip_enabled_flag
+      pps.writeFlag(false); // cu_qp_delta_enabled_flag
+      pps.writeSEV(0);      // pps_cb_qp_offset
+      pps.writeSEV(0);      // pps_cr_qp_offset
+      pps.writeFlag(false); // pps_slice_chroma_qp_offsets_present_flag
+      pps.writeFlag(false); // weighted_pred_flag
+      pps.writeFlag(false); // weighted_bipred_flag
+      pps.writeFlag(false); // transquant_bypass_enabled_flag
+      pps.writeFlag(false); // tiles_enabled_flag
+      pps.writeFlag(false); // entropy_coding_sync_enabled_flag
+      pps.writeFlag(false); // pps_loop_filter_across_slices_enabled_flag
+      pps.writeFlag(false); // deblocking_filter_control_present_flag
+      pps.writeFlag(false); // pps_scaling_list_data_present_flag
+      pps.writeFlag(false); // lists_modification_present_flag
+      pps.writeUEV(0);      // log2_parallel_merge_level_minus2
+      pps.writeFlag(false); // slice_segment_header_extension_present_flag
+      pps.writeFlag(false); // pps_extension_present_flag
+      pps.writeStopBitAndAlign();
+      appendNALUnit(stream, {34 << 1, 1}, pps);
+    }
+
+    BitWriter slice;
+    slice.writeFlag(true); // first_slice_segment_in_pic_flag
+    if (idr)
+      slice.writeFlag(false);    // no_output_of_prior_pics_flag
+    slice.writeUEV(0);           // slice_pic_parameter_set_id
+    slice.writeUEV(idr ? 2 : 1); // slice_type (I or P)
+    if (!idr)
+    {
+      slice.writeBits(frameInGop % (1u << log2MaxPocLsb), log2MaxPocLsb);
+      slice.writeFlag(false); // short_term_ref_pic_set_sps_flag
+      // st_ref_pic_set(): Only the previous frame is referenced
+      slice.writeUEV(1);      // num_negative_pics
+      slice.writeUEV(0);      // num_positive_pics
+      slice.writeUEV(0);      // delta_poc_s0_minus1
+      slice.writeFlag(true);  // used_by_curr_pic_s0_flag
+      slice.writeFlag(false); // num_ref_idx_active_override_flag
+      slice.writeUEV(0);      // five_minus_max_num_merge_cand
+    }
+    slice.writeSEV(0); // slice_qp_delta
+    slice.writeStopBitAndAlign();
+    slice.writeRandomBytes(getSliceDataSize(frameSize, idr, random), random);
+    slice.writeStopBitAndAlign();
+    // IDR_W_RADL or TRAIL_R
+    appendNALUnit(stream, {(unsigned char)((idr ? 19 : 1) << 1), 1}, slice);
+  }
+  return stream;
+}
+
+// A block of the statistics with the prediction mode (0: intra, 1: inter) and the motion vector
+struct Block
+{
+  unsigned x, y, size;
+  int      predMode;
+  int      mvX, mvY;
+};
+
+void splitBlock(std::vector<Block> &blocks,
+                const Size &        frameSize,
+                unsigned            x,
+                unsigned            y,
+                unsigned            size,
+                std::mt19937 &      random)
+{
+  if (x >= unsigned(frameSize.width) || y >= unsigned(frameSize.height))
+    return;
+
+  const bool insideFrame =
+      (x + size <= unsigned(frameSize.width) && y + size <= unsigned(frameSize.height));
+  std::bernoulli_distribution splitDistribution(0.5);
+  if (size > 8 && (!insideFrame || splitDistribution(random)))
+  {
+    const auto half = size / 2;
+    splitBlock(blocks, frameSize, x, y, half, random);
+    splitBlock(blocks, frameSize, x + half, y, half, random);
+    splitBlock(blocks, frameSize, x, y + half, half, random);
+    splitBlock(blocks, frameSize, x + half, y + half, half, random);
+    return;
+  }
+
+  std::bernoulli_distribution        interDistribution(0.7);
+  std::uniform_int_distribution<int> mvDistribution(-256, 256);
+  Block                              block{x, y, size, 0, 0, 0};
+  if (interDistribution(random))
+  {
+    block.predMode = 1;
+    block.mvX      = mvDistribution(random);
+    block.mvY      = mvDistribution(random);
+  }
+  blocks.push_back(block);
+}
+
+std::vector<Block> generateBlocks(const Size &frameSize, std::mt19937 &random)
+{
+  constexpr unsigned CTUSize = 64;
+  std::vector<Block> blocks;
+  for (unsigned y = 0; y < unsigned(frameSize.height); y += CTUSize)
+    for (unsigned x = 0; x < unsigned(frameSize.width); x += CTUSize)
+      splitBlock(blocks, frameSize, x, y, CTUSize, random);
+  return blocks;
+}
+
+} // namespace
+
+QByteArray generateYUVFrame(const video::yuv::PixelFormatYUV &format,
+                            const Size &                      frameSize,
+                            unsigned                          seed)
+{
+  std::mt19937 random(seed);
+  const auto   maxValue = (1 << format.getBitsPerSample()) - 1;
+  std::uniform_int_distribution<int> sampleDistribution(0, maxValue);
+
+  QByteArray frame(int(format.bytesPerFrame(frameSize)), 0);
+  auto       data = reinterpret_cast<unsigned char *>(frame.data());
+  if (format.getBitsPerSample() > 8)
+  {
+    for (int i = 0; i + 1 < frame.size(); i += 2)
+    {
+      const auto value = sampleDistribution(random);
+      data[i]          = (unsigned char)(value & 0xff);
+      data[i + 1]      = (unsigned char)(value >> 8);
+    }
+  }
+  else
+  {
+    for (int i = 0; i < frame.size(); i++)
+      data[i] = (unsigned char)(sampleDistribution(random));
+  }
+  return frame;
+}
+
+QByteArray addNoise(const QByteArray &                frame,
+                    const video::yuv::PixelFormatYUV &format,
+                    int                               amplitude,
+                    unsigned                          seed)
+{
+  std::mt19937                       random(seed);
+  std::uniform_int_distribution<int> noiseDistribution(-amplitude, amplitude);
+  const auto                         maxValue = (1 << format.getBitsPerSample()) - 1;
+
+  QByteArray noisyFrame = frame;
+  auto       data       = reinterpret_cast<unsigned char *>(noisyFrame.data());
+  if (format.getBitsPerSample() > 8)
+  {
+    for (int i = 0; i + 1 < noisyFrame.size(); i += 2)
+    {
+      const auto value = clip(
+          (data[i] | (data[i + 1] << 8)) + noiseDistribution(random), 0, maxValue);
+      data[i]     = (unsigned char)(value & 0xff);
+      data[i + 1] = (unsigned char)(value >> 8);
+    }
+  }
+  else
+  {
+    for (int i = 0; i < noisyFrame.size(); i++)
+      data[i] = (unsigned char)(clip(data[i] + noiseDistribution(random), 0, maxValue));
+  }
+  return noisyFrame;
+}
+
+QByteArray generateNALUnitBuffer(size_t size, size_t averageNALSize, unsigned seed)
+{
+  std::mt19937                          random(seed);
+  std::uniform_int_distribution<size_t> nalSizeDistribution(averageNALSize / 2,
+                                                            averageNALSize * 3 / 2);
+  std::uniform_int_distribution<int>    byteDistribution(0, 255);
+  std::bernoulli_distribution           longStartCodeDistribution(0.5);
+
+  QByteArray buffer;
+  buffer.reserve(int(size));
+  while (size_t(buffer.size()) < size)
+  {
+    if (longStartCodeDistribution(random))
+      buffer.append(char(0));
+    buffer.append("\x00\x00\x01", 3);
+
+    const auto nalSize     = nalSizeDistribution(random);
+    unsigned   nrZeroBytes = 0;
+    for (size_t i = 0; i < nalSize && size_t(buffer.size()) < size; i++)
+    {
+      auto byte = byteDistribution(random);
+      // Like the emulation prevention in a real bitstream. The last byte must not be zero.
+      if ((nrZeroBytes == 2 && byte <= 3) || (byte == 0 && i + 1 == nalSize))
+        byte = 4;
+      buffer.append(char(byte));
+      nrZeroBytes = (byte == 0) ? nrZeroBytes + 1 : 0;
+    }
+  }
+  return buffer;
+}
+
+QByteArray generateAnnexBStream(
+    Codec codec, const Size &frameSize, unsigned nrFrames, unsigned gopSize, unsigned seed)
+{
+  std::mt19937 random(seed);
+  if (codec == Codec::AVC)
+    return generateAVCStream(frameSize, nrFrames, gopSize, random);
+  return generateHEVCStream(frameSize, nrFrames, gopSize, random);
+}
+
+std::string generateStatisticsCSV(const Size &frameSize, unsigned nrFrames, unsigned seed)
+{
+  std::mt19937 random(seed);
+
+  std::string csv = "%;syntax-version;v1.2\n";
+  csv += "%;seq-specs;synthetic;0;" + std::to_string(frameSize.width) + ";" +
+         std::to_string(frameSize.height) + ";0;\n";
+  csv += "%;type;0;PredMode;range;\n";
+  csv += "%;defaultRange;0;1;jet\n";
+  csv += "%;type;1;MVL0;vector;\n";
+  csv += "%;vectorColor;200;0;0;255\n";
+  csv += "%;scaleFactor;4\n";
+
+  char line[128];
+  for (unsigned poc = 0; poc < nrFrames; poc++)
+  {
+    for (const auto &block : generateBlocks(frameSize, random))
+    {
+      std::snprintf(line,
+                    sizeof(line),
+                    "%u;%u;%u;%u;%u;0;%d\n",
+                    poc,
+                    block.x,
+                    block.y,
+                    block.size,
+                    block.size,
+                    block.predMode);
+      csv += line;
+      if (block.predMode == 1)
+      {
+        std::snprintf(line,
+                      sizeof(line),
+                      "%u;%u;%u;%u;%u;1;%d;%d\n",
+                      poc,
+                      block.x,
+                      block.y,
+                      block.size,
+                      block.size,
+                      block.mvX,
+                      block.mvY);
+        csv += line;
+      }
+    }
+  }
+  return csv;
+}
+
+std::string generateStatisticsVTMBMS(const Size &frameSize, unsigned nrFrames, unsigned seed)
+{
+  std::mt19937 random(seed);
+
+  std::string vtmbms = "# VTMBMS Block Statistics\n";
+  vtmbms += "# Sequence size: [" + std::to_string(frameSize.width) + "x" +
+            std::to_string(frameSize.height) + "]\n";
+  vtmbms += "# Block Statistic Type: PredMode; Integer; [0, 1]\n";
+  vtmbms += "# Block Statistic Type: MVL0; Vector; Scale: 4\n";
+
+  char line[128];
+  for (unsigned poc = 0; poc < nrFrames; poc++)
+  {
+    for (const auto &block : generateBlocks(frameSize, random))
+    {
+      std::snprintf(line,
+                    sizeof(line),
+                    "BlockStat: POC %u @(%4u,%4u) [%2ux%2u] PredMode=%d\n",
+                    poc,
+                    block.x,
+                    block.y,
+                    block.size,
+                    block.size,
+                    block.predMode);
+      vtmbms += line;
+      if (block.predMode == 1)
+      {
+        std::snprintf(line,
+                      sizeof(line),
+                      "BlockStat: POC %u @(%4u,%4u) [%2ux%2u] MVL0={%4d,%4d}\n",
+                      poc,
+                      block.x,
+                      block.y,
+                      block.size,
+                      block.size,
+                      block.mvX,
+                      block.mvY);
+        vtmbms += line;
+      }
+    }
+  }
+  return vtmbms;
+}
+
+} // namespace benchmark::synthetic
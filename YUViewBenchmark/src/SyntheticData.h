@@ -0,0 +1,91 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <common/Typedef.h>
+#include <video/PixelFormatYUV.h>
+
+#include <QByteArray>
+
+#include <string>
+
+/* Generators for the input data of the benchmarks. No files have to be downloaded to run the
+ * benchmarks. All generators use a fixed seed so that every run (and every machine) processes
+ * exactly the same data.
+ */
+namespace benchmark::synthetic
+{
+
+constexpr unsigned DefaultSeed = 42;
+
+// A planar frame (no padding between the planes and lines) with random samples. The values do
+// not exceed the bit depth of the format.
+QByteArray generateYUVFrame(const video::yuv::PixelFormatYUV &format,
+                            const Size &                      frameSize,
+                            unsigned                          seed = DefaultSeed);
+
+// Add random noise in the range [-amplitude, amplitude] to every sample of a frame that was
+// generated with generateYUVFrame. This is used as the distorted version of a frame.
+QByteArray addNoise(const QByteArray &                frame,
+                    const video::yuv::PixelFormatYUV &format,
+                    int                               amplitude,
+                    unsigned                          seed = DefaultSeed);
+
+// A buffer with NAL units of random size (and random payload) separated by 3 or 4 byte start
+// codes. The payload never contains a start code.
+QByteArray generateNALUnitBuffer(size_t size, size_t averageNALSize, unsigned seed = DefaultSeed);
+
+enum class Codec
+{
+  AVC,
+  HEVC
+};
+
+// An Annex B bitstream with an intra frame every gopSize frames and predicted frames in between.
+// The parameter sets and slice headers are valid so that the parsers can follow the stream like
+// a real one. The slice data is random (it is never decoded).
+QByteArray generateAnnexBStream(Codec        codec,
+                                const Size & frameSize,
+                                unsigned     nrFrames,
+                                unsigned     gopSize,
+                                unsigned     seed = DefaultSeed);
+
+// Statistics files (CSV and VTM block statistics format) with a prediction mode value for every
+// block and a motion vector for every inter block. The frame is split into CTUs of 64x64 which
+// are randomly split further like in a real encoder.
+std::string
+generateStatisticsCSV(const Size &frameSize, unsigned nrFrames, unsigned seed = DefaultSeed);
+std::string
+generateStatisticsVTMBMS(const Size &frameSize, unsigned nrFrames, unsigned seed = DefaultSeed);
+
+} // namespace benchmark::synthetic
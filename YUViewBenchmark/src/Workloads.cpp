@@ -0,0 +1,536 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Workloads.h"
+
+#include "SyntheticData.h"
+
+#include <common/CPUFeatures.h>
+#include <common/StartCodeSearch.h>
+#include <common/TemporaryFile.h>
+#include <decoder/decoderFFmpeg.h>
+#include <decoder/decoderLibde265.h>
+#include <filesource/FileSourceAnnexBFile.h>
+#include <filesource/FileSourceFFmpegFile.h>
+#include <parser/AVC/AnnexBAVC.h>
+#include <parser/HEVC/AnnexBHEVC.h>
+#include <statistics/StatisticsDataPainting.h>
+#include <statistics/StatisticsFileCSV.h>
+#include <statistics/StatisticsFileVTMBMS.h>
+#include <video/ConversionYUV.h>
+#include <video/FrameBuffer.h>
+#include <video/FrameMetrics.h>
+
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+namespace benchmark
+{
+
+namespace
+{
+
+using video::yuv::PixelFormatYUV;
+using video::yuv::Subsampling;
+
+const Size FrameSize(1920, 1080);
+
+// The Annex B streams have an intra frame every 32 frames like a typical random access
+// configuration
+constexpr unsigned NrAnnexBFrames = 300;
+constexpr unsigned AnnexBGopSize  = 32;
+
+constexpr unsigned NrStatisticsFrames = 16;
+
+const std::vector<Subsampling> ConversionSubsamplings = {Subsampling::YUV_444,
+                                                         Subsampling::YUV_422,
+                                                         Subsampling::YUV_420,
+                                                         Subsampling::YUV_440,
+                                                         Subsampling::YUV_410,
+                                                         Subsampling::YUV_411};
+const std::vector<unsigned>    ConversionBitDepths    = {8, 10, 12, 16};
+
+double megaPixels(const Size &size) { return double(size.width) * double(size.height) / 1e6; }
+
+double megaBytes(int64_t bytes) { return double(bytes) / (1024.0 * 1024.0); }
+
+QString formatName(const PixelFormatYUV &format)
+{
+  const auto subsampling = video::yuv::SubsamplingMapper.getName(format.getSubsampling());
+  return QString::fromStdString(subsampling) + QString("/%1bit").arg(format.getBitsPerSample());
+}
+
+QString instructionSetName(functions::SIMDInstructionSet instructionSet)
+{
+  return QString::fromStdString(functions::SIMDInstructionSetMapper.getName(instructionSet));
+}
+
+std::shared_ptr<TemporaryFile> writeTemporaryFile(const std::string &extension,
+                                                  const char *       data,
+                                                  size_t             size)
+{
+  auto file = std::make_shared<TemporaryFile>(extension);
+  {
+    std::ofstream stream(file->getFilename(), std::ios::binary);
+    stream.write(data, std::streamsize(size));
+    if (!stream)
+      throw std::runtime_error("Error writing temporary file " + file->getFilename());
+  }
+  return file;
+}
+
+// The planes of a frame that was generated by synthetic::generateYUVFrame
+video::yuv::PlanarYUVSource getPlanes(const QByteArray &frame, const PixelFormatYUV &format)
+{
+  const auto bytesPerSample = (format.getBitsPerSample() > 8) ? 2 : 1;
+  const auto lumaBytes      = FrameSize.width * FrameSize.height * bytesPerSample;
+  const auto chromaBytes    = (FrameSize.width / format.getSubsamplingHor()) *
+                           (FrameSize.height / format.getSubsamplingVer()) * bytesPerSample;
+
+  video::yuv::PlanarYUVSource source;
+  source.y = reinterpret_cast<const unsigned char *>(frame.constData());
+  source.u = source.y + lumaBytes;
+  source.v = source.u + chromaBytes;
+  return source;
+}
+
+Workload createConversionWorkload(const PixelFormatYUV &                       format,
+                                  std::optional<functions::SIMDInstructionSet> instructionSet,
+                                  bool                                         parallel)
+{
+  auto frame  = std::make_shared<QByteArray>(synthetic::generateYUVFrame(format, FrameSize));
+  auto output = std::make_shared<std::vector<unsigned char>>(
+      size_t(FrameSize.width) * size_t(FrameSize.height) * 4);
+  const auto source = getPlanes(*frame, format);
+
+  Workload workload;
+  workload.unitsPerRun = megaPixels(FrameSize);
+  workload.run         = [frame, output, source, format, instructionSet, parallel]() {
+    const video::yuv::ConversionSettings settings;
+    bool                                 success;
+    if (parallel)
+      success = video::yuv::convertPlanarYUVToBGRAParallel(
+          source, format, FrameSize, settings, output->data());
+    else if (instructionSet)
+      success = video::yuv::convertPlanarYUVToBGRA(source,
+                                                   format,
+                                                   FrameSize,
+                                                   settings,
+                                                   output->data(),
+                                                   0,
+                                                   FrameSize.height,
+                                                   *instructionSet);
+    else
+      success = video::yuv::convertPlanarYUVToBGRA(
+          source, format, FrameSize, settings, output->data(), 0, FrameSize.height);
+    if (!success)
+      throw std::runtime_error("Conversion of format " + format.getName() + " failed");
+  };
+  return workload;
+}
+
+Workload createNALScanWorkload(synthetic::Codec codec)
+{
+  const auto stream =
+      synthetic::generateAnnexBStream(codec, FrameSize, NrAnnexBFrames, AnnexBGopSize);
+  auto file = writeTemporaryFile("bin", stream.constData(), size_t(stream.size()));
+
+  Workload workload;
+  workload.unitsPerRun = megaBytes(stream.size());
+  workload.run         = [file]() {
+    FileSourceAnnexBFile annexBFile(QString::fromStdString(file->getFilename()));
+    unsigned             nrNALUnits = 0;
+    while (annexBFile.getNextNALUnitView().size > 0)
+      nrNALUnits++;
+    if (nrNALUnits == 0)
+      throw std::runtime_error("No NAL units found in " + file->getFilename());
+  };
+  return workload;
+}
+
+Workload createAnnexBParsingWorkload(synthetic::Codec codec)
+{
+  const auto stream =
+      synthetic::generateAnnexBStream(codec, FrameSize, NrAnnexBFrames, AnnexBGopSize);
+  auto file = writeTemporaryFile(
+      codec == synthetic::Codec::AVC ? "h264" : "h265", stream.constData(), size_t(stream.size()));
+
+  Workload workload;
+  workload.unitsPerRun = NrAnnexBFrames;
+  workload.run         = [file, codec]() {
+    std::unique_ptr<parser::AnnexB> parser;
+    if (codec == synthetic::Codec::AVC)
+      parser = std::make_unique<parser::AnnexBAVC>();
+    else
+      parser = std::make_unique<parser::AnnexBHEVC>();
+
+    QScopedPointer<FileSourceAnnexBFile> annexBFile(
+        new FileSourceAnnexBFile(QString::fromStdString(file->getFilename())));
+    if (!parser->parseAnnexBFile(annexBFile))
+      throw std::runtime_error("Parsing of " + file->getFilename() + " failed");
+    if (parser->getNumberPOCs() == 0)
+      throw std::runtime_error("No frames found in " + file->getFilename());
+  };
+  return workload;
+}
+
+enum class StatisticsFormat
+{
+  CSV,
+  VTMBMS
+};
+
+std::shared_ptr<TemporaryFile> createStatisticsFile(StatisticsFormat format)
+{
+  if (format == StatisticsFormat::CSV)
+  {
+    const auto csv = synthetic::generateStatisticsCSV(FrameSize, NrStatisticsFrames);
+    return writeTemporaryFile("csv", csv.data(), csv.size());
+  }
+  const auto vtmbms = synthetic::generateStatisticsVTMBMS(FrameSize, NrStatisticsFrames);
+  return writeTemporaryFile("vtmbms", vtmbms.data(), vtmbms.size());
+}
+
+std::unique_ptr<stats::StatisticsFileBase> openStatisticsFile(StatisticsFormat       format,
+                                                              const TemporaryFile &  file,
+                                                              stats::StatisticsData &data)
+{
+  const auto filename = QString::fromStdString(file.getFilename());
+  if (format == StatisticsFormat::CSV)
+    return std::make_unique<stats::StatisticsFileCSV>(filename, data);
+  return std::make_unique<stats::StatisticsFileVTMBMS>(filename, data);
+}
+
+// Parse the whole file to find the positions of all frames and types. This is what happens in
+// the background when a statistics file is opened.
+Workload createStatisticsScanWorkload(StatisticsFormat format)
+{
+  auto file = createStatisticsFile(format);
+
+  Workload workload;
+  workload.unitsPerRun = megaBytes(QFileInfo(QString::fromStdString(file->getFilename())).size());
+  workload.run         = [file, format]() {
+    stats::StatisticsData data;
+    auto                  statisticsFile = openStatisticsFile(format, *file, data);
+    std::atomic_bool      breakFunction(false);
+    statisticsFile->readFrameAndTypePositionsFromFile(breakFunction);
+    if (!*statisticsFile)
+      throw std::runtime_error("Parsing of " + file->getFilename() + " failed");
+  };
+  return workload;
+}
+
+// Load the data of all frames and types from a file that was already scanned. This is what
+// happens when stepping through the frames.
+Workload createStatisticsLoadWorkload(StatisticsFormat format)
+{
+  struct State
+  {
+    std::shared_ptr<TemporaryFile>            file;
+    stats::StatisticsData                     data;
+    std::unique_ptr<stats::StatisticsFileBase> statisticsFile;
+  };
+  auto state            = std::make_shared<State>();
+  state->file           = createStatisticsFile(format);
+  state->statisticsFile = openStatisticsFile(format, *state->file, state->data);
+  std::atomic_bool breakFunction(false);
+  state->statisticsFile->readFrameAndTypePositionsFromFile(breakFunction);
+
+  Workload workload;
+  workload.unitsPerRun = NrStatisticsFrames;
+  workload.run         = [state]() {
+    for (unsigned poc = 0; poc < NrStatisticsFrames; poc++)
+      for (const auto &type : state->data.getStatisticsTypes())
+        state->statisticsFile->loadStatisticData(state->data, int(poc), type.typeID);
+  };
+  return workload;
+}
+
+Workload createStatisticsPaintingWorkload(double zoomFactor)
+{
+  struct State
+  {
+    std::shared_ptr<TemporaryFile> file;
+    stats::StatisticsData          data;
+    QImage                         image;
+  };
+  auto state  = std::make_shared<State>();
+  state->file = createStatisticsFile(StatisticsFormat::CSV);
+  auto statisticsFile = openStatisticsFile(StatisticsFormat::CSV, *state->file, state->data);
+  std::atomic_bool breakFunction(false);
+  statisticsFile->readFrameAndTypePositionsFromFile(breakFunction);
+  for (auto &type : state->data.getStatisticsTypes())
+  {
+    type.render           = true;
+    type.renderValueData  = type.hasValueData;
+    type.renderVectorData = type.hasVectorData;
+    statisticsFile->loadStatisticData(state->data, 0, type.typeID);
+  }
+  state->image = QImage(FrameSize.width, FrameSize.height, QImage::Format_ARGB32_Premultiplied);
+
+  Workload workload;
+  workload.unitsPerRun = 1;
+  workload.run         = [state, zoomFactor]() {
+    state->image.fill(Qt::transparent);
+    QPainter painter(&state->image);
+    // The statistics are drawn centered around the origin like in the view
+    painter.translate(state->image.width() / 2, state->image.height() / 2);
+    stats::paintStatisticsData(&painter, state->data, 0, zoomFactor);
+  };
+  return workload;
+}
+
+// Decode the whole bitstream and get every frame from the decoder. pushData pushes the next data
+// to the decoder. Returns the number of decoded frames.
+unsigned decodeAllFrames(decoder::decoderBase &dec, const std::function<void()> &pushData)
+{
+  unsigned nrFrames = 0;
+  while (dec.state() != decoder::DecoderState::EndOfBitstream)
+  {
+    if (dec.state() == decoder::DecoderState::Error)
+      throw std::runtime_error("Decoding failed: " + dec.decoderErrorString().toStdString());
+    if (dec.state() == decoder::DecoderState::NeedsMoreData)
+      pushData();
+    else if (dec.decodeNextFrame())
+    {
+      if (dec.getFrameBuffer().isNull())
+        throw std::runtime_error("The decoder returned an empty frame");
+      nrFrames++;
+    }
+  }
+  return nrFrames;
+}
+
+// Decode the Annex B file with libde265. The NAL units are read from the file like in the
+// compressed video item.
+Workload createLibde265DecodeWorkload(std::shared_ptr<decoder::decoderLibde265> dec,
+                                      const QString &                           fileName)
+{
+  auto decode = [dec, fileName]() {
+    dec->resetDecoder();
+    FileSourceAnnexBFile annexBFile(fileName);
+    if (!annexBFile.isOk())
+      throw std::runtime_error("Error opening " + fileName.toStdString());
+    bool repushData = false;
+    return decodeAllFrames(*dec, [&]() {
+      auto data  = annexBFile.getNextNALUnit(repushData);
+      repushData = !dec->pushData(data);
+    });
+  };
+
+  // Decode once to count the frames
+  Workload workload;
+  workload.unitsPerRun = decode();
+  workload.run         = decode;
+  return workload;
+}
+
+// Decode the file with FFmpeg. The packets are read using the FFmpeg demuxer.
+Workload createFFmpegDecodeWorkload(std::shared_ptr<FileSourceFFmpegFile>   file,
+                                    std::shared_ptr<decoder::decoderFFmpeg> dec)
+{
+  auto decode = [file, dec]() {
+    dec->resetDecoder();
+    if (!file->seekFileToBeginning())
+      throw std::runtime_error("Error seeking to the beginning of the file");
+    bool repushData = false;
+    return decodeAllFrames(*dec, [&]() {
+      auto packet = file->getNextPacket(repushData);
+      repushData  = false;
+      if (!dec->pushAVPacket(packet))
+      {
+        if (dec->state() != decoder::DecoderState::RetrieveFrames)
+          throw std::runtime_error("Pushing a packet to the decoder failed");
+        repushData = true;
+      }
+    });
+  };
+
+  // Decode once to count the frames
+  Workload workload;
+  workload.unitsPerRun = decode();
+  workload.run         = decode;
+  return workload;
+}
+
+} // namespace
+
+void addConversionBenchmarks(BenchmarkRunner &runner)
+{
+  for (auto subsampling : ConversionSubsamplings)
+  {
+    for (auto bitDepth : ConversionBitDepths)
+    {
+      const PixelFormatYUV format(subsampling, bitDepth);
+      runner.add({"conversion/" + formatName(format), "MPixel", [format]() {
+                    return createConversionWorkload(format, {}, false);
+                  }});
+    }
+  }
+
+  // The kernels of all instruction sets that this CPU supports and the parallel conversion of
+  // the most common formats
+  for (auto bitDepth : {8u, 10u})
+  {
+    const PixelFormatYUV format(Subsampling::YUV_420, bitDepth);
+    for (auto instructionSet : functions::getSupportedSIMDInstructionSets())
+      runner.add({"conversion-simd/" + instructionSetName(instructionSet) + "/" +
+                      formatName(format),
+                  "MPixel",
+                  [format, instructionSet]() {
+                    return createConversionWorkload(format, instructionSet, false);
+                  }});
+    runner.add({"conversion-parallel/" + formatName(format), "MPixel", [format]() {
+                  return createConversionWorkload(format, {}, true);
+                }});
+  }
+}
+
+void addMetricsBenchmarks(BenchmarkRunner &runner)
+{
+  for (const auto &format : {PixelFormatYUV(Subsampling::YUV_420, 8),
+                             PixelFormatYUV(Subsampling::YUV_420, 10),
+                             PixelFormatYUV(Subsampling::YUV_444, 8)})
+  {
+    runner.add({"metrics/" + formatName(format), "MPixel", [format]() {
+                  const auto reference = synthetic::generateYUVFrame(format, FrameSize);
+                  const auto distorted = synthetic::addNoise(reference, format, 4);
+                  Workload   workload;
+                  workload.unitsPerRun = megaPixels(FrameSize);
+                  workload.run         = [reference, distorted, format]() {
+                    auto metrics = video::calculateFrameMetrics(video::FrameBuffer(distorted),
+                                                                format,
+                                                                video::FrameBuffer(reference),
+                                                                format,
+                                                                FrameSize);
+                    if (!metrics)
+                      throw std::runtime_error("Calculation of the metrics failed");
+                  };
+                  return workload;
+                }});
+  }
+}
+
+void addBitstreamBenchmarks(BenchmarkRunner &runner)
+{
+  for (auto instructionSet : functions::getSupportedSIMDInstructionSets())
+  {
+    runner.add({"startcode-search/" + instructionSetName(instructionSet), "MB", [instructionSet]() {
+                  auto buffer = std::make_shared<QByteArray>(
+                      synthetic::generateNALUnitBuffer(64 * 1024 * 1024, 2000));
+                  Workload workload;
+                  workload.unitsPerRun = megaBytes(buffer->size());
+                  workload.run         = [buffer, instructionSet]() {
+                    int64_t offset = 0;
+                    while (true)
+                    {
+                      const auto startCode = functions::findStartCode(
+                          buffer->constData(), buffer->size(), offset, instructionSet);
+                      if (startCode < 0)
+                        break;
+                      offset = startCode + 3;
+                    }
+                  };
+                  return workload;
+                }});
+  }
+
+  runner.add({"annexb/nal-scan", "MB", []() {
+                return createNALScanWorkload(synthetic::Codec::HEVC);
+              }});
+  runner.add({"annexb/parse/avc", "frames", []() {
+                return createAnnexBParsingWorkload(synthetic::Codec::AVC);
+              }});
+  runner.add({"annexb/parse/hevc", "frames", []() {
+                return createAnnexBParsingWorkload(synthetic::Codec::HEVC);
+              }});
+}
+
+void addStatisticsBenchmarks(BenchmarkRunner &runner)
+{
+  for (auto format : {StatisticsFormat::CSV, StatisticsFormat::VTMBMS})
+  {
+    const QString name = (format == StatisticsFormat::CSV) ? "csv" : "vtmbms";
+    runner.add({"statistics/" + name + "/scan", "MB", [format]() {
+                  return createStatisticsScanWorkload(format);
+                }});
+    runner.add({"statistics/" + name + "/load", "frames", [format]() {
+                  return createStatisticsLoadWorkload(format);
+                }});
+  }
+
+  for (auto zoomFactor : {1, 4})
+    runner.add({QString("statistics/paint/zoom%1").arg(zoomFactor), "frames", [zoomFactor]() {
+                  return createStatisticsPaintingWorkload(zoomFactor);
+                }});
+}
+
+void addDecodeBenchmarks(BenchmarkRunner &runner, const QString &fileName)
+{
+  // The synthetic bitstreams contain random slice data that can not be decoded
+  if (fileName.isEmpty())
+    return;
+
+  // A decoder whose library can not be loaded is skipped
+  auto libde265 = std::make_shared<decoder::decoderLibde265>(0);
+  if (libde265->errorInDecoder())
+    std::cerr << "Skipping decode/libde265: " << libde265->decoderErrorString().toStdString()
+              << "\n";
+  else
+    runner.add({"decode/libde265", "frames", [libde265, fileName]() {
+                  return createLibde265DecodeWorkload(libde265, fileName);
+                }});
+
+  auto file = std::make_shared<FileSourceFFmpegFile>();
+  if (!file->openFile(fileName, nullptr, nullptr, false))
+  {
+    std::cerr << "Skipping decode/ffmpeg: The file could not be opened with FFmpeg\n";
+    return;
+  }
+  auto ffmpeg = std::make_shared<decoder::decoderFFmpeg>(file->getVideoCodecPar());
+  if (ffmpeg->errorInDecoder())
+    std::cerr << "Skipping decode/ffmpeg: " << ffmpeg->decoderErrorString().toStdString() << "\n";
+  else
+    runner.add({"decode/ffmpeg", "frames", [file, ffmpeg]() {
+                  return createFFmpegDecodeWorkload(file, ffmpeg);
+                }});
+}
+
+} // namespace benchmark
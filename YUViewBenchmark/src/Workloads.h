@@ -0,0 +1,57 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "BenchmarkRunner.h"
+
+namespace benchmark
+{
+
+// The conversion of YUV frames to RGB for every subsampling and a range of bit depths
+void addConversionBenchmarks(BenchmarkRunner &runner);
+
+// The PSNR, SSIM and MSE calculation between a frame and a distorted version of it
+void addMetricsBenchmarks(BenchmarkRunner &runner);
+
+// The start code search, the NAL unit scan of an Annex B file and the parsing of AVC and HEVC
+// bitstreams
+void addBitstreamBenchmarks(BenchmarkRunner &runner);
+
+// The parsing of CSV and VTM block statistics files and the painting of statistics
+void addStatisticsBenchmarks(BenchmarkRunner &runner);
+
+// The decoding of the given bitstream with libde265 and FFmpeg. The decoders whose libraries can
+// not be loaded are skipped. Nothing is added if no file is given.
+void addDecodeBenchmarks(BenchmarkRunner &runner, const QString &fileName);
+
+} // namespace benchmark
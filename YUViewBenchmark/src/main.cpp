@@ -0,0 +1,163 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRunner.h"
+#include "Workloads.h"
+
+#include <common/CPUFeatures.h>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+
+#include <algorithm>
+#include <iostream>
+
+/* Measures fixed workloads on synthetic data and writes the results as JSON. The data is generated
+ * at runtime with a fixed seed, so no test files are needed and the results of different commits
+ * can be compared directly. Only the decode benchmarks need a real bitstream. Example:
+ *
+ *   YUViewBenchmark --filter "^conversion/" --output results.json
+ *   YUViewBenchmark --filter "^decode/" --decode-file stream.hevc
+ */
+int main(int argc, char *argv[])
+{
+  // The statistics painting needs a QGuiApplication, but no display
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+  QApplication app(argc, argv);
+  QApplication::setApplicationName("YUViewBenchmark");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Run the YUView benchmarks and write the results as JSON.");
+  parser.addHelpOption();
+
+  const QCommandLineOption listOption("list", "List the names of all benchmarks.");
+  const QCommandLineOption filterOption(
+      "filter", "Only run the benchmarks whose name matches the regular expression.", "regex");
+  const QCommandLineOption outputOption(
+      "output", "Write the results to this file instead of stdout.", "file");
+  const QCommandLineOption minTimeOption(
+      "min-time", "The minimum time that each benchmark is run (default 500).", "ms");
+  const QCommandLineOption minRunsOption(
+      "min-runs", "The minimum number of runs of each benchmark (default 5).", "n");
+  const QCommandLineOption simdOption(
+      "simd", "Limit the SIMD instruction set (None, SSE4_1, AVX2 or NEON).", "name");
+  const QCommandLineOption decodeFileOption(
+      "decode-file", "The HEVC Annex B bitstream for the decode benchmarks.", "file");
+  parser.addOptions({listOption,
+                     filterOption,
+                     outputOption,
+                     minTimeOption,
+                     minRunsOption,
+                     simdOption,
+                     decodeFileOption});
+  parser.process(app);
+
+  benchmark::BenchmarkRunner runner;
+  benchmark::addConversionBenchmarks(runner);
+  benchmark::addMetricsBenchmarks(runner);
+  benchmark::addBitstreamBenchmarks(runner);
+  benchmark::addStatisticsBenchmarks(runner);
+  benchmark::addDecodeBenchmarks(runner, parser.value(decodeFileOption));
+
+  if (parser.isSet(listOption))
+  {
+    for (const auto &name : runner.getNames())
+      std::cout << name.toStdString() << "\n";
+    return 0;
+  }
+
+  benchmark::BenchmarkRunner::Settings settings;
+  if (parser.isSet(filterOption))
+  {
+    settings.filter = QRegularExpression(parser.value(filterOption));
+    if (!settings.filter.isValid())
+    {
+      std::cerr << "Invalid filter: " << settings.filter.errorString().toStdString() << "\n";
+      return 2;
+    }
+  }
+  if (parser.isSet(minTimeOption))
+  {
+    bool ok;
+    settings.minTime = std::chrono::milliseconds(parser.value(minTimeOption).toUInt(&ok));
+    if (!ok)
+    {
+      std::cerr << "Invalid minimum time " << parser.value(minTimeOption).toStdString() << "\n";
+      return 2;
+    }
+  }
+  if (parser.isSet(minRunsOption))
+  {
+    bool ok;
+    settings.minRuns = parser.value(minRunsOption).toUInt(&ok);
+    if (!ok || settings.minRuns == 0)
+    {
+      std::cerr << "Invalid number of runs " << parser.value(minRunsOption).toStdString() << "\n";
+      return 2;
+    }
+    settings.maxRuns = std::max(settings.maxRuns, settings.minRuns);
+  }
+  if (parser.isSet(simdOption))
+  {
+    const auto instructionSet =
+        functions::SIMDInstructionSetMapper.getValue(parser.value(simdOption).toStdString());
+    if (!instructionSet || !functions::setSIMDInstructionSet(*instructionSet))
+    {
+      std::cerr << "The instruction set " << parser.value(simdOption).toStdString()
+                << " is not supported\n";
+      return 2;
+    }
+  }
+
+  const auto results = runner.run(settings);
+  const auto json    = benchmark::BenchmarkRunner::toJSON(results).toJson();
+
+  if (parser.isSet(outputOption))
+  {
+    QFile file(parser.value(outputOption));
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size())
+    {
+      std::cerr << "Error writing " << parser.value(outputOption).toStdString() << "\n";
+      return 1;
+    }
+  }
+  else
+    std::cout << json.toStdString();
+
+  for (const auto &result : results)
+    if (!result.error.isEmpty())
+      return 1;
+  return 0;
+}
@@ -0,0 +1,694 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "BatchProcessor.h"
+
+#include <common/TaskScheduler.h>
+#include <playlistitem/playlistItemCompressedVideo.h>
+#include <playlistitem/playlistItemRawFile.h>
+#include <statistics/StatisticsFileBinary.h>
+#include <statistics/StatisticsFileCSV.h>
+#include <statistics/StatisticsFileVTMBMS.h>
+#include <video/FrameMetrics.h>
+#include <video/videoHandlerYUV.h>
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QTextStream>
+#include <QThread>
+
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <optional>
+
+namespace
+{
+
+const auto ComponentNames = QStringList({"y", "u", "v"});
+
+void printError(const QString &message)
+{
+  std::cerr << "YUView batch: " << message.toStdString() << std::endl;
+}
+
+// Split the frame range into segments that can be processed in parallel. Each segment starts at a
+// random access point of the first compressed item so that every caching decoder of the item can
+// decode one segment without seeking. Items without random access points (raw files) are split into
+// a few segments per thread.
+std::vector<indexRange> getSegments(const std::vector<int> &randomAccessPoints,
+                                    indexRange              range,
+                                    int                     nrThreads)
+{
+  std::vector<int> segmentStarts({range.first});
+  if (!randomAccessPoints.empty())
+  {
+    for (auto frame : randomAccessPoints)
+      if (frame > range.first && frame <= range.second)
+        segmentStarts.push_back(frame);
+  }
+  else
+  {
+    const auto nrFrames = range.second - range.first + 1;
+    const auto step     = std::max(nrFrames / (nrThreads * 4), 1);
+    for (auto frame = range.first + step; frame <= range.second; frame += step)
+      segmentStarts.push_back(frame);
+  }
+
+  std::vector<indexRange> segments;
+  for (size_t i = 0; i < segmentStarts.size(); i++)
+  {
+    const auto end = (i + 1 < segmentStarts.size()) ? segmentStarts[i + 1] - 1 : range.second;
+    segments.push_back(indexRange(segmentStarts[i], end));
+  }
+  return segments;
+}
+
+} // namespace
+
+bool BatchProcessor::isBatchMode(int argc, char *argv[])
+{
+  return argc > 1 && std::strcmp(argv[1], BatchArgument) == 0;
+}
+
+BatchProcessor::BatchProcessor()  = default;
+BatchProcessor::~BatchProcessor() = default;
+
+int BatchProcessor::run(const QStringList &arguments)
+{
+  if (!this->parseArguments(arguments))
+    return this->helpShown ? 0 : 2;
+  if (!this->openItems())
+    return 1;
+
+  auto success = true;
+  if (!this->items.empty())
+    success = this->processFrames();
+  if (this->writeBitrate)
+    success &= this->addBitrateTables();
+  if (!this->statisticsFile.isEmpty() && !this->convertStatisticsFile.isEmpty())
+    success &= this->convertStatistics();
+  else if (!this->statisticsFile.isEmpty())
+    success &= this->addStatisticsTable();
+  if (!this->writeOutput())
+    return 1;
+  return success ? 0 : 1;
+}
+
+bool BatchProcessor::parseArguments(const QStringList &arguments)
+{
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Decode and convert all frames of the given file without showing a window. If a reference "
+      "file is given, the PSNR, SSIM and MSE of every frame are calculated.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("file", "The raw or compressed video file to process.");
+  parser.addPositionalArgument("reference", "The file to compare to (optional).", "[reference]");
+
+  const QCommandLineOption metricsOption(
+      "metrics", "Calculate the PSNR, SSIM and MSE. This is the default if a reference is given.");
+  const QCommandLineOption bitrateOption("bitrate",
+                                         "Write the size of every frame of compressed files.");
+  const QCommandLineOption statisticsOption(
+      "statistics", "Write a per frame summary of the statistics file.", "statisticsFile");
+  const QCommandLineOption convertStatisticsOption(
+      "convert-statistics",
+      "Convert the statistics file to the binary statistics format (*.yuvstats).",
+      "binaryFile");
+  const QCommandLineOption saveFramesOption(
+      "save-frames", "Save every converted frame as a PNG file to the directory.", "directory");
+  const QCommandLineOption framesOption(
+      "frames", "Only process the frames first to last.", "first:last");
+  const QCommandLineOption sizeOption("size", "The frame size of raw files.", "WxH");
+  const QCommandLineOption pixelFormatOption(
+      "pixel-format", "The pixel format of raw files (as shown in YUView).", "name");
+  const QCommandLineOption outputOption(
+      "output", "Write the results to the file instead of stdout.", "file");
+  const QCommandLineOption formatOption(
+      "format",
+      "The output format (csv or json). The default is the suffix of the output or csv.",
+      "csv|json");
+  const QCommandLineOption threadsOption(
+      "threads", "The number of frames that are processed in parallel.", "n");
+  parser.addOptions({metricsOption,
+                     bitrateOption,
+                     statisticsOption,
+                     convertStatisticsOption,
+                     saveFramesOption,
+                     framesOption,
+                     sizeOption,
+                     pixelFormatOption,
+                     outputOption,
+                     formatOption,
+                     threadsOption});
+
+  // The parser expects the program name as the first argument
+  if (!parser.parse(QStringList({"yuview"}) + arguments))
+  {
+    printError(parser.errorText());
+    return false;
+  }
+  if (parser.isSet("help"))
+  {
+    std::cout << parser.helpText().toStdString();
+    this->helpShown = true;
+    return false;
+  }
+
+  this->inputFiles = parser.positionalArguments();
+  if (this->inputFiles.size() > 2)
+  {
+    printError("At most two files (a file and a reference) can be processed.");
+    return false;
+  }
+  if (this->inputFiles.empty() && !parser.isSet(statisticsOption))
+  {
+    printError("No input file given. Use --help for a list of options.");
+    return false;
+  }
+
+  this->calculateMetrics      = parser.isSet(metricsOption) || this->inputFiles.size() == 2;
+  this->writeBitrate          = parser.isSet(bitrateOption);
+  this->statisticsFile        = parser.value(statisticsOption);
+  this->convertStatisticsFile = parser.value(convertStatisticsOption);
+  this->saveFramesDirectory   = parser.value(saveFramesOption);
+  this->outputFile            = parser.value(outputOption);
+  this->frameSize             = parser.value(sizeOption);
+  this->pixelFormat           = parser.value(pixelFormatOption);
+  if (this->calculateMetrics && this->inputFiles.size() != 2)
+  {
+    printError("Calculating metrics needs a file and a reference.");
+    return false;
+  }
+  if (!this->convertStatisticsFile.isEmpty() && this->statisticsFile.isEmpty())
+  {
+    printError("Converting statistics needs a statistics file.");
+    return false;
+  }
+  if (this->frameSize.isEmpty() != this->pixelFormat.isEmpty())
+  {
+    printError("The size and the pixel format of raw files must be given together.");
+    return false;
+  }
+
+  auto format = parser.value(formatOption).toLower();
+  if (format.isEmpty())
+    format = QFileInfo(this->outputFile).suffix().toLower() == "json" ? "json" : "csv";
+  if (format != "csv" && format != "json")
+  {
+    printError("Unknown output format " + format);
+    return false;
+  }
+  this->jsonOutput = (format == "json");
+
+  if (parser.isSet(framesOption))
+  {
+    const auto range = parser.value(framesOption).split(':');
+    auto       ok    = range.size() == 2;
+    if (ok)
+    {
+      bool okFirst, okLast;
+      this->firstFrame = range[0].toInt(&okFirst);
+      this->lastFrame  = range[1].toInt(&okLast);
+      ok = okFirst && okLast && this->firstFrame >= 0 && this->lastFrame >= this->firstFrame;
+    }
+    if (!ok)
+    {
+      printError("Invalid frame range " + parser.value(framesOption));
+      return false;
+    }
+  }
+
+  this->nrThreads = QThread::idealThreadCount();
+  if (parser.isSet(threadsOption))
+    this->nrThreads = parser.value(threadsOption).toInt();
+  if (this->nrThreads <= 0)
+  {
+    printError("Invalid number of threads " + parser.value(threadsOption));
+    return false;
+  }
+  return true;
+}
+
+bool BatchProcessor::openItems()
+{
+  QSize size;
+  if (!this->frameSize.isEmpty())
+  {
+    const auto values = this->frameSize.toLower().split('x');
+    if (values.size() == 2)
+      size = QSize(values[0].toInt(), values[1].toInt());
+    if (!size.isValid() || size.isEmpty())
+    {
+      printError("Invalid frame size " + this->frameSize);
+      return false;
+    }
+  }
+
+  for (const auto &file : this->inputFiles)
+  {
+    if (!QFileInfo(file).exists())
+    {
+      printError("The file " + file + " does not exist.");
+      return false;
+    }
+
+    // Only file types that can be opened without asking the user are supported
+    QStringList rawExtensions, compressedExtensions, filters;
+    playlistItemRawFile::getSupportedFileExtensions(rawExtensions, filters);
+    playlistItemCompressedVideo::getSupportedFileExtensions(compressedExtensions, filters);
+    const auto suffix = QFileInfo(file).suffix().toLower();
+    if (rawExtensions.contains(suffix))
+      this->items.emplace_back(new playlistItemRawFile(file, size, this->pixelFormat));
+    else if (compressedExtensions.contains(suffix))
+    {
+      auto item = new playlistItemCompressedVideo(file);
+      this->items.emplace_back(item);
+      item->waitForBackgroundParsing();
+    }
+    else
+    {
+      printError("The type of the file " + file + " is not supported in batch mode.");
+      return false;
+    }
+
+    const auto &item = this->items.back();
+    if (item->isError())
+    {
+      printError("Error opening " + file + ": " + item->getErrorText());
+      return false;
+    }
+    if (!item->getFrameHandler()->isFormatValid())
+    {
+      printError("The format of " + file + " is unknown. Use --size and --pixel-format.");
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BatchProcessor::processFrames()
+{
+  // Only the frames that all items have can be processed
+  auto range = indexRange(0, INT_MAX);
+  for (const auto &item : this->items)
+  {
+    const auto itemRange = item->properties().startEndRange;
+    range.first          = std::max(range.first, itemRange.first);
+    range.second         = std::min(range.second, itemRange.second);
+  }
+  if (this->firstFrame >= 0)
+  {
+    range.first  = std::max(range.first, this->firstFrame);
+    range.second = std::min(range.second, this->lastFrame);
+  }
+  if (range.second < range.first)
+  {
+    printError("There are no frames to process.");
+    return false;
+  }
+
+  std::vector<video::videoHandler *> handlers;
+  for (const auto &item : this->items)
+    handlers.push_back(dynamic_cast<video::videoHandler *>(item->getFrameHandler()));
+
+  std::vector<video::videoHandlerYUV *> handlersYUV;
+  if (this->calculateMetrics)
+  {
+    for (auto handler : handlers)
+      handlersYUV.push_back(dynamic_cast<video::videoHandlerYUV *>(handler));
+    if (!handlersYUV[0] || !handlersYUV[1])
+    {
+      printError("Metrics can only be calculated for YUV files.");
+      return false;
+    }
+    if (handlersYUV[0]->getFrameSize() != handlersYUV[1]->getFrameSize())
+    {
+      printError("The frame sizes of the file and the reference differ.");
+      return false;
+    }
+  }
+
+  if (!this->saveFramesDirectory.isEmpty() && !QDir().mkpath(this->saveFramesDirectory))
+  {
+    printError("Could not create the directory " + this->saveFramesDirectory);
+    return false;
+  }
+
+  // Compressed items can only decode as many segments in parallel as they have caching decoders.
+  // Threads beyond that would only wait for a decoder.
+  auto             nrParallel = this->nrThreads;
+  std::vector<int> randomAccessPoints;
+  for (const auto &item : this->items)
+  {
+    if (randomAccessPoints.empty())
+      randomAccessPoints = item->getRandomAccessPoints();
+    if (item->cachingThreadLimit() > 0)
+      nrParallel = std::min(nrParallel, item->cachingThreadLimit());
+  }
+  const auto segments = getSegments(randomAccessPoints, range, nrParallel);
+
+  // Every frame has its own slot in the results so that the tasks do not have to synchronize
+  const auto nrFrames = range.second - range.first + 1;
+  std::vector<std::optional<video::FrameMetrics>> metrics(size_t(nrFrames));
+
+  std::atomic_int nrFramesFailed{0};
+  QMutex          errorMutex;
+  QStringList     errors;
+  auto            addError = [&](const QString &error) {
+    nrFramesFailed++;
+    QMutexLocker locker(&errorMutex);
+    errors.append(error);
+  };
+
+  auto processFrame = [&](int frame) {
+    QImage image;
+    if (this->calculateMetrics)
+    {
+      video::FrameBuffer frameBuffer, referenceBuffer;
+      if (!handlersYUV[0]->loadRawFrame(frame, frameBuffer) ||
+          !handlersYUV[1]->loadRawFrame(frame, referenceBuffer))
+        return addError(QString("Loading frame %1 failed").arg(frame));
+      const auto frameMetrics = video::calculateFrameMetrics(frameBuffer,
+                                                             handlersYUV[0]->getPixelFormatYUV(),
+                                                             referenceBuffer,
+                                                             handlersYUV[1]->getPixelFormatYUV(),
+                                                             handlersYUV[0]->getFrameSize());
+      metrics[size_t(frame - range.first)] = frameMetrics;
+      if (!frameMetrics)
+        return addError(QString("The formats of frame %1 can not be compared").arg(frame));
+      if (this->saveFramesDirectory.isEmpty())
+        return;
+      // Convert the frame that was loaded for the metrics instead of decoding it again
+      image = handlersYUV[0]->convertRawFrame(frameBuffer);
+    }
+    else
+      // Decode and convert the frame
+      image = handlers[0]->loadFrameImage(frame);
+    if (image.isNull())
+      return addError(QString("Loading frame %1 failed").arg(frame));
+    if (!this->saveFramesDirectory.isEmpty())
+    {
+      const auto fileName = QString("%1/%2_%3.png")
+                                .arg(this->saveFramesDirectory)
+                                .arg(QFileInfo(this->inputFiles[0]).completeBaseName())
+                                .arg(frame, 6, 10, QChar('0'));
+      if (!image.save(fileName))
+        addError("Saving " + fileName + " failed");
+    }
+  };
+
+  QElapsedTimer timer;
+  timer.start();
+  {
+    TaskScheduler scheduler(nrParallel, 0);
+    for (const auto &segment : segments)
+      scheduler.submit(TaskScheduler::Priority::Background,
+                       nullptr,
+                       [segment, &processFrame](const TaskScheduler::CancellationToken &) {
+                         for (auto frame = segment.first; frame <= segment.second; frame++)
+                           processFrame(frame);
+                       });
+    scheduler.waitForAll();
+  }
+  const auto msec = std::max(timer.elapsed(), qint64(1));
+
+  errors.sort();
+  for (const auto &error : errors)
+    printError(error);
+  std::cerr << "Processed " << nrFrames << " frames (" << nrFramesFailed << " failed) in " << msec
+            << " ms using " << nrParallel << " threads (" << (nrFrames * 1000.0 / msec)
+            << " frames per second)" << std::endl;
+
+  if (this->calculateMetrics)
+  {
+    Table table;
+    table.name    = "metrics";
+    table.columns = QStringList({"frame"});
+    // 4:0:0 formats only have the Y component
+    int nrComponents = 0;
+    for (const auto &frameMetrics : metrics)
+      if (frameMetrics)
+        nrComponents = std::max(nrComponents, int(frameMetrics->components.size()));
+    nrComponents = std::min(nrComponents, int(ComponentNames.size()));
+    for (int c = 0; c < nrComponents; c++)
+      table.columns << "mse_" + ComponentNames[c] << "psnr_" + ComponentNames[c]
+                    << "ssim_" + ComponentNames[c];
+    for (int i = 0; i < nrFrames; i++)
+    {
+      if (!metrics[size_t(i)])
+        continue;
+      QVariantList row({range.first + i});
+      const auto & components = metrics[size_t(i)]->components;
+      for (int c = 0; c < nrComponents; c++)
+      {
+        if (c < int(components.size()))
+          row << components[size_t(c)].mse << components[size_t(c)].psnr
+              << components[size_t(c)].ssim;
+        else
+          row << QVariant() << QVariant() << QVariant();
+      }
+      table.rows.push_back(row);
+    }
+    this->tables.push_back(table);
+  }
+  return nrFramesFailed == 0;
+}
+
+bool BatchProcessor::addBitrateTables()
+{
+  Table table;
+  table.name    = "bitrate";
+  table.columns = QStringList({"file", "frame", "poc", "bytes", "randomAccessPoint"});
+  for (size_t i = 0; i < this->items.size(); i++)
+  {
+    auto item = dynamic_cast<playlistItemCompressedVideo *>(this->items[i].get());
+    if (!item)
+      continue;
+
+    // The frames are in coding order
+    const auto index = item->getFileIndex();
+    if (index.frames.empty())
+      printError("The frame sizes of " + this->inputFiles[int(i)] + " are not known.");
+    for (size_t frame = 0; frame < index.frames.size(); frame++)
+    {
+      const auto &indexFrame = index.frames[frame];
+      if (!indexFrame.fileStartEndPos)
+        continue;
+      const auto bytes = indexFrame.fileStartEndPos->second - indexFrame.fileStartEndPos->first + 1;
+      table.rows.push_back(QVariantList({this->inputFiles[int(i)],
+                                         qulonglong(frame),
+                                         qlonglong(indexFrame.timestamp),
+                                         qulonglong(bytes),
+                                         indexFrame.randomAccessPoint}));
+    }
+  }
+  this->tables.push_back(table);
+  return true;
+}
+
+std::unique_ptr<stats::StatisticsFileBase>
+BatchProcessor::openStatisticsFile(stats::StatisticsData &statisticsData) const
+{
+  // All frames are processed once in order. No other frames have to be kept in memory.
+  statisticsData.setCacheSizeLimit(0);
+
+  std::unique_ptr<stats::StatisticsFileBase> file;
+  const auto suffix = QFileInfo(this->statisticsFile).suffix().toLower();
+  if (suffix == "csv")
+    file.reset(new stats::StatisticsFileCSV(this->statisticsFile, statisticsData));
+  else if (suffix == "vtmbmsstats")
+    file.reset(new stats::StatisticsFileVTMBMS(this->statisticsFile, statisticsData));
+  else if (suffix == "yuvstats")
+    file.reset(new stats::StatisticsFileBinary(this->statisticsFile, statisticsData));
+  else
+  {
+    printError("The type of the statistics file " + this->statisticsFile + " is not supported.");
+    return {};
+  }
+
+  std::atomic_bool abortParsing{false};
+  file->readFrameAndTypePositionsFromFile(abortParsing);
+  if (!*file)
+  {
+    printError("Error reading the statistics file " + this->statisticsFile);
+    return {};
+  }
+  return file;
+}
+
+bool BatchProcessor::convertStatistics()
+{
+  stats::StatisticsData statisticsData;
+  auto                  file = this->openStatisticsFile(statisticsData);
+  if (!file)
+    return false;
+
+  QString errorMessage;
+  if (!stats::StatisticsFileBinary::convertFile(
+          *file, statisticsData, this->convertStatisticsFile, errorMessage))
+  {
+    printError(errorMessage);
+    return false;
+  }
+  return true;
+}
+
+bool BatchProcessor::addStatisticsTable()
+{
+  stats::StatisticsData statisticsData;
+  auto                  file = this->openStatisticsFile(statisticsData);
+  if (!file)
+    return false;
+
+  Table table;
+  table.name    = "statistics";
+  table.columns = QStringList({"frame",
+                               "typeID",
+                               "type",
+                               "valueBlocks",
+                               "valueMean",
+                               "valueMin",
+                               "valueMax",
+                               "vectorBlocks",
+                               "polygons"});
+
+  auto first = 0;
+  auto last  = file->getMaxPoc();
+  if (this->firstFrame >= 0)
+  {
+    first = std::max(first, this->firstFrame);
+    last  = std::min(last, this->lastFrame);
+  }
+  for (auto frame = first; frame <= last; frame++)
+  {
+    for (const auto &type : statisticsData.getStatisticsTypes())
+    {
+      file->loadStatisticData(statisticsData, frame, type.typeID);
+      const auto data = statisticsData.getFrameTypeData(type.typeID);
+
+      int64_t sum = 0;
+      auto    min = std::numeric_limits<int>::max();
+      auto    max = std::numeric_limits<int>::min();
+      for (auto value : data.valueData.value)
+      {
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+      }
+      const auto nrValues = data.valueData.size();
+      QVariantList row({frame, type.typeID, type.typeName, qulonglong(nrValues)});
+      if (nrValues > 0)
+        row << double(sum) / nrValues << min << max;
+      else
+        row << QVariant() << QVariant() << QVariant();
+      row << qulonglong(data.vectorData.size() + data.affineTFData.size())
+          << qulonglong(data.polygonValueData.size() + data.polygonVectorData.size());
+      table.rows.push_back(row);
+    }
+  }
+  this->tables.push_back(table);
+  return true;
+}
+
+bool BatchProcessor::writeOutput() const
+{
+  const auto output = this->jsonOutput ? this->toJSON() : this->toCSV().toUtf8();
+  if (this->outputFile.isEmpty())
+  {
+    std::cout << output.toStdString();
+    return true;
+  }
+
+  QFile file(this->outputFile);
+  if (!file.open(QIODevice::WriteOnly) || file.write(output) != output.size())
+  {
+    printError("Error writing the output file " + this->outputFile);
+    return false;
+  }
+  return true;
+}
+
+QString BatchProcessor::toCSV() const
+{
+  // If there are multiple tables, they are separated by an empty line and a line with the name
+  QString     csv;
+  QTextStream stream(&csv);
+  for (const auto &table : this->tables)
+  {
+    if (this->tables.size() > 1)
+      stream << (&table == &this->tables.front() ? "" : "\n") << "# " << table.name << "\n";
+    stream << table.columns.join(',') << "\n";
+    for (const auto &row : table.rows)
+    {
+      QStringList values;
+      for (const auto &value : row)
+      {
+        if (value.userType() == QMetaType::Double)
+          values << QString::number(value.toDouble(), 'f', 4);
+        else
+          values << value.toString();
+      }
+      stream << values.join(',') << "\n";
+    }
+  }
+  stream.flush();
+  return csv;
+}
+
+QByteArray BatchProcessor::toJSON() const
+{
+  QJsonObject root;
+  for (const auto &table : this->tables)
+  {
+    QJsonArray rows;
+    for (const auto &row : table.rows)
+    {
+      QJsonObject object;
+      for (int i = 0; i < table.columns.size() && i < row.size(); i++)
+        object.insert(table.columns[i], QJsonValue::fromVariant(row[i]));
+      rows.append(object);
+    }
+    root.insert(table.name, rows);
+  }
+  return QJsonDocument(root).toJson();
+}
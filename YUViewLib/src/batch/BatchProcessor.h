@@ -0,0 +1,112 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QStringList>
+#include <QVariantList>
+
+#include <memory>
+#include <vector>
+
+class playlistItemWithVideo;
+namespace stats
+{
+class StatisticsData;
+class StatisticsFileBase;
+} // namespace stats
+
+/* The batch mode runs YUView without a window (yuview --batch). The given files are opened like in
+ * the playlist, all frames are decoded and converted in parallel, and the results are written as
+ * CSV or JSON. If a reference file is given, the PSNR, SSIM and MSE of every frame are calculated.
+ * The per-frame summary of a statistics file and the size of every frame of compressed files can
+ * also be written and statistics files can be converted to the binary statistics format. This is
+ * meant for automated testing on machines without a display.
+ */
+class BatchProcessor
+{
+public:
+  static constexpr auto BatchArgument = "--batch";
+  static bool           isBatchMode(int argc, char *argv[]);
+
+  BatchProcessor();
+  ~BatchProcessor();
+
+  // Run the batch processing with the command line arguments (without the program name and the
+  // batch argument). Returns the exit code of the application.
+  int run(const QStringList &arguments);
+
+private:
+  // One table of the output. In CSV format each table is written as a block of lines, in JSON
+  // format each table is an array of objects.
+  struct Table
+  {
+    QString                   name;
+    QStringList               columns;
+    std::vector<QVariantList> rows;
+  };
+
+  bool parseArguments(const QStringList &arguments);
+  bool openItems();
+  bool processFrames();
+  bool addBitrateTables();
+  bool addStatisticsTable();
+  bool convertStatistics();
+  bool writeOutput() const;
+
+  // Open and parse the statistics file. Returns nullptr on failure.
+  std::unique_ptr<stats::StatisticsFileBase>
+  openStatisticsFile(stats::StatisticsData &statisticsData) const;
+
+  QString    toCSV() const;
+  QByteArray toJSON() const;
+
+  // The options from the command line
+  QStringList inputFiles;
+  QString     statisticsFile;
+  QString     convertStatisticsFile;
+  QString     outputFile;
+  QString     saveFramesDirectory;
+  bool        calculateMetrics{};
+  bool        writeBitrate{};
+  bool        jsonOutput{};
+  bool        helpShown{};
+  int         nrThreads{};
+  int         firstFrame{-1};
+  int         lastFrame{-1};
+  QString     frameSize;
+  QString     pixelFormat;
+
+  std::vector<std::unique_ptr<playlistItemWithVideo>> items;
+  std::vector<Table>                                  tables;
+};
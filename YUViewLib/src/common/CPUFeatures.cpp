@@ -0,0 +1,162 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CPUFeatures.h"
+
+#include <atomic>
+
+#if YUVIEW_ARCH_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace functions
+{
+
+namespace
+{
+
+#if YUVIEW_ARCH_X86
+
+void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4])
+{
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuidex(info, int(leaf), int(subleaf));
+  for (int i = 0; i < 4; i++)
+    regs[i] = unsigned(info[i]);
+#else
+  regs[0] = regs[1] = regs[2] = regs[3] = 0;
+  __get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+}
+
+// Read the XCR0 register which tells us which register states the OS saves on a context switch.
+unsigned long long readXCR0()
+{
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  unsigned eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+std::vector<SIMDInstructionSet> detectInstructionSets()
+{
+  std::vector<SIMDInstructionSet> sets;
+  sets.push_back(SIMDInstructionSet::None);
+
+  unsigned regs[4];
+  cpuid(0, 0, regs);
+  const auto maxLeaf = regs[0];
+  if (maxLeaf < 1)
+    return sets;
+
+  cpuid(1, 0, regs);
+  const bool sse41   = (regs[2] & (1u << 19)) != 0;
+  const bool osxsave = (regs[2] & (1u << 27)) != 0;
+  const bool avx     = (regs[2] & (1u << 28)) != 0;
+  if (sse41)
+    sets.push_back(SIMDInstructionSet::SSE4_1);
+
+  // For AVX2, the OS must also save/restore the YMM registers.
+  if (maxLeaf >= 7 && osxsave && avx && (readXCR0() & 0x6) == 0x6)
+  {
+    cpuid(7, 0, regs);
+    if (regs[1] & (1u << 5))
+      sets.push_back(SIMDInstructionSet::AVX2);
+  }
+
+  return sets;
+}
+
+#else
+
+std::vector<SIMDInstructionSet> detectInstructionSets()
+{
+  std::vector<SIMDInstructionSet> sets;
+  sets.push_back(SIMDInstructionSet::None);
+#if YUVIEW_ARCH_NEON
+  // NEON is mandatory on aarch64 and we only enable it for 32 bit arm if the compiler does.
+  sets.push_back(SIMDInstructionSet::NEON);
+#endif
+  return sets;
+}
+
+#endif
+
+const std::vector<SIMDInstructionSet> &supportedInstructionSets()
+{
+  static const auto sets = detectInstructionSets();
+  return sets;
+}
+
+std::atomic<SIMDInstructionSet> &selectedInstructionSet()
+{
+  static std::atomic<SIMDInstructionSet> selected(supportedInstructionSets().back());
+  return selected;
+}
+
+} // namespace
+
+std::vector<SIMDInstructionSet> getSupportedSIMDInstructionSets()
+{
+  return supportedInstructionSets();
+}
+
+bool isSIMDInstructionSetSupported(SIMDInstructionSet instructionSet)
+{
+  for (const auto set : supportedInstructionSets())
+    if (set == instructionSet)
+      return true;
+  return false;
+}
+
+SIMDInstructionSet getSIMDInstructionSet()
+{
+  return selectedInstructionSet().load();
+}
+
+bool setSIMDInstructionSet(SIMDInstructionSet instructionSet)
+{
+  if (!isSIMDInstructionSetSupported(instructionSet))
+    return false;
+  selectedInstructionSet().store(instructionSet);
+  return true;
+}
+
+} // namespace functions
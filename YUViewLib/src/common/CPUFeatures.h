@@ -0,0 +1,95 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <common/EnumMapper.h>
+
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define YUVIEW_ARCH_X86 1
+#else
+#define YUVIEW_ARCH_X86 0
+#endif
+
+#if defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define YUVIEW_ARCH_NEON 1
+#else
+#define YUVIEW_ARCH_NEON 0
+#endif
+
+// With gcc and clang, intrinsics of an instruction set can only be used in functions that are
+// compiled for that instruction set. We do not want to compile the whole library with -mavx2, so
+// only the optimized kernels are tagged. MSVC allows all intrinsics everywhere.
+#if YUVIEW_ARCH_X86 && (defined(__GNUC__) || defined(__clang__))
+#define YUVIEW_TARGET_SSE4_1 __attribute__((target("sse4.1")))
+#define YUVIEW_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define YUVIEW_TARGET_SSE4_1
+#define YUVIEW_TARGET_AVX2
+#endif
+
+namespace functions
+{
+
+// The instruction set extensions that we have optimized code paths for.
+enum class SIMDInstructionSet
+{
+  None,
+  SSE4_1,
+  AVX2,
+  NEON
+};
+
+const auto SIMDInstructionSetMapper =
+    EnumMapper<SIMDInstructionSet>({{SIMDInstructionSet::None, "None", "Scalar (no SIMD)"},
+                                    {SIMDInstructionSet::SSE4_1, "SSE4_1", "SSE 4.1"},
+                                    {SIMDInstructionSet::AVX2, "AVX2", "AVX2"},
+                                    {SIMDInstructionSet::NEON, "NEON", "NEON"}});
+
+// All instruction sets that this CPU (and the OS) supports. None is always in the list.
+// The CPU is only queried once. This function is thread safe.
+std::vector<SIMDInstructionSet> getSupportedSIMDInstructionSets();
+
+bool isSIMDInstructionSetSupported(SIMDInstructionSet instructionSet);
+
+// The instruction set that the optimized code paths should use. By default, this is the best
+// supported one. It can be limited using setSIMDInstructionSet (e.g. for testing or to compare
+// the performance).
+SIMDInstructionSet getSIMDInstructionSet();
+
+// Set the instruction set to use. If the given set is not supported, nothing is changed and false
+// is returned.
+bool setSIMDInstructionSet(SIMDInstructionSet instructionSet);
+
+} // namespace functions
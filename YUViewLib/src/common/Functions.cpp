@@ -54,6 +54,14 @@ unsigned int functions::getOptimalThreadCount()
     return 1;
 }
 
+QByteArray functions::toOwnedByteArray(const QByteArray &data)
+{
+  // The capacity of an array that does not own its data is 0
+  if (data.capacity() >= data.size())
+    return data;
+  return QByteArray(data.constData(), data.size());
+}
+
 unsigned int functions::systemMemorySizeInMB()
 {
   static unsigned int memorySizeInMB;
@@ -60,6 +60,11 @@ QStringList getThemeColors(QString themeName);
 QString formatDataSize(double size, bool isBits = false);
 
 QStringList toQStringList(const std::vector<std::string> &stringVec);
+
+// Arrays created with QByteArray::fromRawData (e.g. views into a memory mapped file) do not own
+// their data. Return a deep copy of such an array so that it can be kept after the referenced
+// memory was released. Other arrays are returned as they are (implicitly shared).
+QByteArray toOwnedByteArray(const QByteArray &data);
 std::string toLower(std::string str);
 
 inline std::string boolToString(bool b) { return b ? "True" : "False"; }
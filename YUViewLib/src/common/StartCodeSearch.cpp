@@ -0,0 +1,159 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "StartCodeSearch.h"
+
+#include <cstring>
+
+#if YUVIEW_ARCH_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace functions
+{
+
+namespace
+{
+
+#if YUVIEW_ARCH_X86
+
+inline int countTrailingZeros(unsigned mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return int(index);
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+// Compare 16 positions at once. For each position, the start code condition is checked on the byte
+// itself and on the following two bytes (three unaligned loads). Bytes that are not zero are
+// rejected right away which is the case for almost all positions in a bitstream.
+YUVIEW_TARGET_SSE4_1 int64_t findStartCodeSSE4_1(const char *data, int64_t size, int64_t pos)
+{
+  const auto zero = _mm_setzero_si128();
+  const auto one  = _mm_set1_epi8(1);
+  for (; pos + 18 <= size; pos += 16)
+  {
+    const auto byte0     = _mm_loadu_si128((const __m128i *)(data + pos));
+    const auto zeroBytes = _mm_cmpeq_epi8(byte0, zero);
+    if (_mm_movemask_epi8(zeroBytes) == 0)
+      continue;
+
+    const auto byte1 = _mm_loadu_si128((const __m128i *)(data + pos + 1));
+    const auto byte2 = _mm_loadu_si128((const __m128i *)(data + pos + 2));
+    const auto match = _mm_and_si128(
+        zeroBytes, _mm_and_si128(_mm_cmpeq_epi8(byte1, zero), _mm_cmpeq_epi8(byte2, one)));
+    const auto mask = unsigned(_mm_movemask_epi8(match));
+    if (mask != 0)
+      return pos + countTrailingZeros(mask);
+  }
+  return pos;
+}
+
+YUVIEW_TARGET_AVX2 int64_t findStartCodeAVX2(const char *data, int64_t size, int64_t pos)
+{
+  const auto zero = _mm256_setzero_si256();
+  const auto one  = _mm256_set1_epi8(1);
+  for (; pos + 34 <= size; pos += 32)
+  {
+    const auto byte0     = _mm256_loadu_si256((const __m256i *)(data + pos));
+    const auto zeroBytes = _mm256_cmpeq_epi8(byte0, zero);
+    if (_mm256_movemask_epi8(zeroBytes) == 0)
+      continue;
+
+    const auto byte1 = _mm256_loadu_si256((const __m256i *)(data + pos + 1));
+    const auto byte2 = _mm256_loadu_si256((const __m256i *)(data + pos + 2));
+    const auto match = _mm256_and_si256(
+        zeroBytes,
+        _mm256_and_si256(_mm256_cmpeq_epi8(byte1, zero), _mm256_cmpeq_epi8(byte2, one)));
+    const auto mask = unsigned(_mm256_movemask_epi8(match));
+    if (mask != 0)
+      return pos + countTrailingZeros(mask);
+  }
+  return pos;
+}
+
+#endif
+
+// Jump from zero byte to zero byte using memchr (which is vectorized in all common C libraries).
+int64_t findStartCodeScalar(const char *data, int64_t size, int64_t pos)
+{
+  while (pos + 3 <= size)
+  {
+    const auto zeroByte = (const char *)std::memchr(data + pos, 0, size_t(size - pos - 2));
+    if (zeroByte == nullptr)
+      return -1;
+    pos = zeroByte - data;
+    if (data[pos + 1] == 0 && data[pos + 2] == 1)
+      return pos;
+    // If the next byte is not zero, it can not be the start of a start code either
+    pos += (data[pos + 1] == 0) ? 1 : 2;
+  }
+  return -1;
+}
+
+} // namespace
+
+int64_t findStartCode(const char *data, int64_t size, int64_t offset)
+{
+  return findStartCode(data, size, offset, getSIMDInstructionSet());
+}
+
+int64_t findStartCode(const char *             data,
+                      int64_t                  size,
+                      int64_t                  offset,
+                      const SIMDInstructionSet instructionSet)
+{
+  if (data == nullptr || offset < 0 || offset + 3 > size)
+    return -1;
+
+  // The vector kernels return the position of the match or where they stopped. The remaining bytes
+  // at the end (less than one vector) are searched by the scalar code.
+  auto pos = offset;
+#if YUVIEW_ARCH_X86
+  if (instructionSet == SIMDInstructionSet::AVX2)
+    pos = findStartCodeAVX2(data, size, pos);
+  else if (instructionSet == SIMDInstructionSet::SSE4_1)
+    pos = findStartCodeSSE4_1(data, size, pos);
+#else
+  (void)instructionSet;
+#endif
+  return findStartCodeScalar(data, size, pos);
+}
+
+} // namespace functions
@@ -0,0 +1,336 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TaskScheduler.h"
+
+#include <QThread>
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+
+constexpr int NrPriorities = 3;
+
+QThread::Priority getThreadPriority(TaskScheduler::Priority priority)
+{
+  if (priority == TaskScheduler::Priority::Interactive)
+    return QThread::HighPriority;
+  if (priority == TaskScheduler::Priority::NextFrames)
+    return QThread::LowPriority;
+  return QThread::LowestPriority;
+}
+
+} // namespace
+
+class TaskScheduler::Worker : public QThread
+{
+public:
+  Worker(TaskScheduler &scheduler, bool interactiveOnly)
+      : scheduler(scheduler), interactiveOnly(interactiveOnly)
+  {
+  }
+
+  TaskScheduler &scheduler;
+  const bool     interactiveOnly;
+  // A retiring worker finishes its current task and quits. It does not take new tasks.
+  bool                   retiring{false};
+  std::deque<QueuedTask> queues[NrPriorities];
+
+protected:
+  void run() override
+  {
+    TaskScheduler::currentWorker = this;
+
+    auto       threadPriority = this->priority();
+    QueuedTask task;
+    while (this->scheduler.waitForTask(this, task))
+    {
+      const auto newThreadPriority = getThreadPriority(task.priority);
+      if (newThreadPriority != threadPriority)
+      {
+        this->setPriority(newThreadPriority);
+        threadPriority = newThreadPriority;
+      }
+
+      task.task(task.token);
+      // Release everything the task captured before waiting for the next one
+      task = {};
+      this->scheduler.taskFinished();
+    }
+  }
+};
+
+thread_local TaskScheduler::Worker *TaskScheduler::currentWorker = nullptr;
+
+TaskScheduler::TaskScheduler(int nrThreads, int nrInteractiveThreads)
+{
+  {
+    // The workers access the list of workers as soon as they are started
+    QMutexLocker locker(&this->mutex);
+
+    // There must always be a worker that can run interactive tasks
+    this->nrInteractiveThreads = std::max(nrInteractiveThreads, 1);
+    for (int i = 0; i < this->nrInteractiveThreads; i++)
+    {
+      this->workers.emplace_back(new Worker(*this, true));
+      this->workers.back()->start(QThread::HighPriority);
+    }
+  }
+  this->setNrThreads(nrThreads);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+  // Queued tasks are still invoked (canceled) so that every task gets its completion
+  this->cancelAll();
+  {
+    QMutexLocker locker(&this->mutex);
+    this->quitting = true;
+    this->taskAvailable.wakeAll();
+  }
+  for (auto &worker : this->workers)
+    worker->wait();
+  for (auto &worker : this->retiredWorkers)
+    worker->wait();
+}
+
+void TaskScheduler::setNrThreads(int nrThreads)
+{
+  QMutexLocker locker(&this->mutex);
+  this->removeFinishedWorkers();
+
+  nrThreads                = std::max(nrThreads, 0);
+  const auto currentNumber = int(this->workers.size()) - this->nrInteractiveThreads;
+  for (int i = currentNumber; i < nrThreads; i++)
+  {
+    this->workers.emplace_back(new Worker(*this, false));
+    this->workers.back()->start(QThread::LowestPriority);
+  }
+
+  if (currentNumber > nrThreads)
+  {
+    const auto firstRemoved = this->workers.end() - (currentNumber - nrThreads);
+    std::vector<std::unique_ptr<Worker>> removedWorkers;
+    std::move(firstRemoved, this->workers.end(), std::back_inserter(removedWorkers));
+    this->workers.erase(firstRemoved, this->workers.end());
+
+    // Pass the queued tasks on to the remaining workers
+    for (auto &worker : removedWorkers)
+    {
+      worker->retiring = true;
+      for (auto &queue : worker->queues)
+      {
+        for (auto &task : queue)
+        {
+          this->nrQueued--;
+          this->enqueue(std::move(task));
+        }
+        queue.clear();
+      }
+      this->retiredWorkers.push_back(std::move(worker));
+    }
+  }
+
+  this->taskAvailable.wakeAll();
+}
+
+int TaskScheduler::getNrThreads() const
+{
+  QMutexLocker locker(&this->mutex);
+  return int(this->workers.size()) - this->nrInteractiveThreads;
+}
+
+void TaskScheduler::submit(Priority priority, const void *group, Task task)
+{
+  QMutexLocker locker(&this->mutex);
+
+  QueuedTask queuedTask;
+  queuedTask.task     = std::move(task);
+  queuedTask.priority = priority;
+  if (group != nullptr)
+    queuedTask.token = this->groupTokens[group];
+  if (this->quitting)
+    queuedTask.token.cancel();
+
+  this->enqueue(std::move(queuedTask));
+  this->taskAvailable.wakeAll();
+}
+
+void TaskScheduler::cancel(const void *group)
+{
+  QMutexLocker locker(&this->mutex);
+  auto         it = this->groupTokens.find(group);
+  if (it == this->groupTokens.end())
+    return;
+  it->second.cancel();
+  this->groupTokens.erase(it);
+}
+
+void TaskScheduler::cancelAll()
+{
+  QMutexLocker locker(&this->mutex);
+  for (auto &groupToken : this->groupTokens)
+    groupToken.second.cancel();
+  this->groupTokens.clear();
+
+  // Tasks without a group have their own token
+  for (auto &worker : this->workers)
+    for (auto &queue : worker->queues)
+      for (auto &task : queue)
+        task.token.cancel();
+}
+
+void TaskScheduler::waitForAll()
+{
+  QMutexLocker locker(&this->mutex);
+  while (this->nrRunning > 0 || this->nrQueued > 0)
+    this->allTasksDone.wait(&this->mutex);
+}
+
+TaskScheduler::Status TaskScheduler::getStatus() const
+{
+  QMutexLocker locker(&this->mutex);
+  Status       status;
+  status.nrThreads = int(this->workers.size()) - this->nrInteractiveThreads;
+  status.nrRunning = this->nrRunning;
+  status.nrQueued  = this->nrQueued;
+  status.nrStolen  = this->nrStolen;
+  return status;
+}
+
+bool TaskScheduler::canRun(const Worker *worker, Priority priority) const
+{
+  if (worker->retiring)
+    return false;
+  if (priority == Priority::Interactive || !worker->interactiveOnly)
+    return true;
+  // The interactive workers only help out if there is nobody else
+  return this->quitting || int(this->workers.size()) == this->nrInteractiveThreads;
+}
+
+void TaskScheduler::enqueue(QueuedTask &&task)
+{
+  auto target = currentWorker;
+  if (target == nullptr || &target->scheduler != this || !this->canRun(target, task.priority))
+  {
+    // Interactive tasks go to the interactive workers, all others to the remaining workers (if
+    // there are any).
+    const auto nrWorkers = int(this->workers.size());
+    auto       begin     = 0;
+    auto       end       = this->nrInteractiveThreads;
+    if (task.priority != Priority::Interactive && nrWorkers > this->nrInteractiveThreads)
+    {
+      begin = this->nrInteractiveThreads;
+      end   = nrWorkers;
+    }
+    else if (task.priority != Priority::Interactive)
+      end = nrWorkers;
+    target = this->workers[begin + this->nextWorker++ % unsigned(end - begin)].get();
+  }
+
+  target->queues[int(task.priority)].push_back(std::move(task));
+  this->nrQueued++;
+}
+
+bool TaskScheduler::takeTask(Worker *worker, QueuedTask &task)
+{
+  for (int p = 0; p < NrPriorities; p++)
+  {
+    if (!this->canRun(worker, Priority(p)))
+      continue;
+
+    auto &ownQueue = worker->queues[p];
+    if (!ownQueue.empty())
+    {
+      task = std::move(ownQueue.front());
+      ownQueue.pop_front();
+      this->nrQueued--;
+      return true;
+    }
+
+    // Steal from the back of another queue. The front is what the owner will work on next.
+    for (auto &other : this->workers)
+    {
+      auto &otherQueue = other->queues[p];
+      if (other.get() != worker && !otherQueue.empty())
+      {
+        task = std::move(otherQueue.back());
+        otherQueue.pop_back();
+        this->nrQueued--;
+        this->nrStolen++;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void TaskScheduler::removeFinishedWorkers()
+{
+  auto it = this->retiredWorkers.begin();
+  while (it != this->retiredWorkers.end())
+  {
+    if ((*it)->isFinished())
+    {
+      (*it)->wait();
+      it = this->retiredWorkers.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+bool TaskScheduler::waitForTask(Worker *worker, QueuedTask &task)
+{
+  QMutexLocker locker(&this->mutex);
+  while (true)
+  {
+    if (this->takeTask(worker, task))
+    {
+      this->nrRunning++;
+      return true;
+    }
+    if (worker->retiring || this->quitting)
+      return false;
+    this->taskAvailable.wait(&this->mutex);
+  }
+}
+
+void TaskScheduler::taskFinished()
+{
+  QMutexLocker locker(&this->mutex);
+  this->nrRunning--;
+  if (this->nrRunning == 0 && this->nrQueued == 0)
+    this->allTasksDone.wakeAll();
+}
@@ -0,0 +1,151 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+/* A pool of worker threads that runs tasks by priority.
+ *
+ * Every worker has its own queue per priority. A worker always takes the task with the highest
+ * priority it can find: first from the front of its own queue, then from the back of the queue of
+ * another worker (work stealing). Tasks that are submitted from within a worker thread go into the
+ * queue of that worker, all others are distributed over the workers round robin.
+ *
+ * A number of workers is reserved for interactive tasks so that loading the frame the user wants to
+ * see never waits for background work. The other workers run tasks of all priorities.
+ *
+ * Each task belongs to a group (e.g. the playlist item it works on). All tasks of a group share a
+ * cancellation token. Every submitted task is invoked exactly once, even if it was canceled. The
+ * task has to check the token and skip its work if it was canceled. This way the submitter can rely
+ * on getting a completion for every task.
+ */
+class TaskScheduler
+{
+public:
+  enum class Priority
+  {
+    Interactive, // The user is waiting for the result
+    NextFrames,  // Frames that will be needed next (e.g. of the selected item)
+    Background   // Everything else
+  };
+
+  class CancellationToken
+  {
+  public:
+    CancellationToken() : canceled(std::make_shared<std::atomic_bool>(false)) {}
+    bool isCanceled() const { return this->canceled->load(); }
+
+  private:
+    friend class TaskScheduler;
+    void                              cancel() { this->canceled->store(true); }
+    std::shared_ptr<std::atomic_bool> canceled;
+  };
+
+  using Task = std::function<void(const CancellationToken &)>;
+
+  struct Status
+  {
+    int     nrThreads{};
+    int     nrRunning{};
+    int     nrQueued{};
+    int64_t nrStolen{};
+  };
+
+  TaskScheduler(int nrThreads = 0, int nrInteractiveThreads = 2);
+  ~TaskScheduler();
+
+  // Set the number of threads for non interactive tasks. Threads that are removed finish their
+  // current task first. Their queued tasks are passed on to the remaining threads.
+  void setNrThreads(int nrThreads);
+  int  getNrThreads() const;
+
+  // Submit a task. All tasks of the same group can be canceled with cancel(group). A task without a
+  // group (nullptr) can only be canceled with cancelAll().
+  void submit(Priority priority, const void *group, Task task);
+  // Cancel all tasks of the group that were submitted so far. Tasks submitted afterwards for the
+  // same group are not canceled.
+  void cancel(const void *group);
+  void cancelAll();
+
+  // Block until all submitted tasks were invoked
+  void waitForAll();
+
+  Status getStatus() const;
+
+private:
+  class Worker;
+
+  struct QueuedTask
+  {
+    Task              task;
+    CancellationToken token;
+    Priority          priority{Priority::Background};
+  };
+
+  bool canRun(const Worker *worker, Priority priority) const;
+  void enqueue(QueuedTask &&task);
+  bool takeTask(Worker *worker, QueuedTask &task);
+  void removeFinishedWorkers();
+
+  // Called by the workers
+  bool waitForTask(Worker *worker, QueuedTask &task);
+  void taskFinished();
+
+  mutable QMutex mutex;
+  QWaitCondition taskAvailable;
+  QWaitCondition allTasksDone;
+
+  // The interactive workers come first
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::unique_ptr<Worker>> retiredWorkers;
+  int                                  nrInteractiveThreads{};
+
+  std::map<const void *, CancellationToken> groupTokens;
+
+  unsigned nextWorker{0};
+  int      nrRunning{0};
+  int      nrQueued{0};
+  int64_t  nrStolen{0};
+  bool     quitting{false};
+
+  static thread_local Worker *currentWorker;
+};
@@ -32,8 +32,15 @@
 
 #include "decoderBase.h"
 
+#include <common/Functions.h>
+#include <common/Typedef.h>
+#include <video/BufferPool.h>
+
 #include <QDir>
 #include <QSettings>
+#include <QThread>
+
+#include <algorithm>
 
 namespace decoder
 {
@@ -97,6 +104,40 @@ stats::FrameTypeData decoderBase::getCurrentFrameStatsForType(int typeId) const
   return statisticsData->getFrameTypeData(typeId);
 }
 
+video::FrameBuffer decoderBase::allocateFrameBuffer(size_t nrBytes, unsigned char *&data) const
+{
+  auto block = video::getBufferPool().allocate(nrBytes);
+  data       = block.get();
+
+  // Describe the packed planes of the YUV format. If the planes do not add up to the size, the
+  // decoder writes something else and the buffer is treated as one block of data.
+  std::vector<video::FrameBuffer::Plane> planes;
+  const auto &pixFmt = this->formatYUV;
+  if (this->rawFormat == video::RawFormat::YUV && pixFmt.isPlanar() && !pixFmt.isUVInterleaved())
+  {
+    const auto nrBytesPerSample = pixFmt.getBitsPerSample() <= 8 ? 1u : 2u;
+    size_t     offset           = 0;
+    for (unsigned plane = 0; plane < pixFmt.getNrPlanes(); plane++)
+    {
+      const auto component =
+          (plane == 0) ? video::yuv::Component::Luma : video::yuv::Component::Chroma;
+      video::FrameBuffer::Plane p;
+      p.data      = data + offset;
+      p.lineBytes = this->frameSize.width / pixFmt.getSubsamplingHor(component) * nrBytesPerSample;
+      p.stride    = p.lineBytes;
+      p.nrLines   = this->frameSize.height / pixFmt.getSubsamplingVer(component);
+      offset += p.lineBytes * p.nrLines;
+      planes.push_back(p);
+    }
+    if (offset != nrBytes)
+      planes.clear();
+  }
+  if (planes.empty())
+    planes.push_back({data, nrBytes, nrBytes, 1});
+
+  return video::FrameBuffer(planes, block);
+}
+
 void decoderBaseSingleLib::loadDecoderLibrary(QString specificLibrary)
 {
   // Try to load the HM library from the current working directory
@@ -177,4 +218,42 @@ void decoderBaseSingleLib::loadDecoderLibrary(QString specificLibrary)
   this->resolveLibraryFunctionPointers();
 }
 
+int getNrCachingDecoders()
+{
+  QSettings settings;
+  settings.beginGroup("Decoders");
+  const auto nrCachingDecoders =
+      settings.value("NrCachingDecoders", std::min(int(functions::getOptimalThreadCount()), 4))
+          .toInt();
+  return clip(nrCachingDecoders, 1, 16);
+}
+
+int decoderBase::getNrDecoderThreads(const char *settingKey) const
+{
+  QSettings settings;
+  settings.beginGroup("Decoders");
+  const auto nrThreadsSetting = settings.value(settingKey, 0).toInt();
+  settings.endGroup();
+  if (nrThreadsSetting > 0)
+    return nrThreadsSetting;
+
+  const auto nrCachingDecoders = getNrCachingDecoders();
+
+  settings.beginGroup("VideoCache");
+  auto nrCachingThreads = 0;
+  if (settings.value("Enabled", true).toBool())
+  {
+    nrCachingThreads = int(functions::getOptimalThreadCount());
+    if (settings.value("SetNrThreads", false).toBool())
+      nrCachingThreads = std::max(settings.value("NrThreads", nrCachingThreads).toInt(), 1);
+  }
+  settings.endGroup();
+
+  // The interactive decoder and all caching decoders that can decode at the same time
+  const auto nrParallelDecoders = 1 + std::min(nrCachingDecoders, nrCachingThreads);
+  const auto nrThreads          = std::max(QThread::idealThreadCount() / nrParallelDecoders, 1);
+  DEBUG_DECODERBASE("decoderBase::getNrDecoderThreads %s: %d", settingKey, nrThreads);
+  return nrThreads;
+}
+
 } // namespace decoder
@@ -35,6 +35,7 @@
 #include <common/EnumMapper.h>
 #include <filesource/FileSourceAnnexBFile.h>
 #include <statistics/StatisticsData.h>
+#include <video/FrameBuffer.h>
 #include <video/videoHandlerRGB.h>
 #include <video/videoHandlerYUV.h>
 
@@ -77,6 +78,10 @@ const auto DecodersHEVC =
 const auto DecodersVVC = std::vector<DecoderEngine>({DecoderEngine::VVDec, DecoderEngine::VTM});
 const auto DecodersAV1 = std::vector<DecoderEngine>({DecoderEngine::FFMpeg, DecoderEngine::Dav1d});
 
+// The number of decoders that a compressed item uses for caching ("NrCachingDecoders" in the
+// "Decoders" settings group). The decoder threads are shared between these decoders.
+int getNrCachingDecoders();
+
 /* This class is the abstract base class for all decoders. All decoders work like this:
  * 1. Create an instance and configure it (if required)
  * 2. Push data to the decoder until it returns that it can not take any more data.
@@ -111,6 +116,13 @@ public:
   // is probably needed.
   virtual bool               decodeNextFrame() = 0;
   virtual QByteArray         getRawFrameData() = 0;
+  // Get the current frame without copying it (if possible). The frame buffer may point to the
+  // memory of the decoder. It stays valid after the decoder moved on to the next frame. The
+  // default implementation returns the packed data from getRawFrameData.
+  virtual video::FrameBuffer getFrameBuffer()
+  {
+    return video::FrameBuffer(this->getRawFrameData());
+  }
   video::RawFormat           getRawFormat() const { return this->rawFormat; }
   video::yuv::PixelFormatYUV getPixelFormatYUV() const { return this->formatYUV; }
   video::rgb::PixelFormatRGB getRGBPixelFormat() const { return this->formatRGB; }
@@ -172,6 +184,17 @@ protected:
 
   // If set, fill it (if possible). The playlistItem has ownership of this.
   stats::StatisticsData *statisticsData{};
+
+  // Decoders that copy the decoded picture copy it to memory from the buffer pool. Get a frame
+  // buffer with nrBytes of memory that the decoder writes the packed planes to (using data). The
+  // memory goes back to the pool when the frame buffer is not used anymore.
+  video::FrameBuffer allocateFrameBuffer(size_t nrBytes, unsigned char *&data) const;
+
+  // Get the number of threads that the decoder library may use internally. The value is read from
+  // the given key in the "Decoders" settings group. If it is 0 (automatic), the cores are shared
+  // between the interactive decoder and the caching decoders that may run in parallel (which is
+  // limited by the number of caching threads) so that they do not oversubscribe the CPU.
+  int getNrDecoderThreads(const char *settingKey) const;
 };
 
 // This abstract base class extends the decoderBase class by the ability to load one single library
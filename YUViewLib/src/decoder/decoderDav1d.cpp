@@ -110,8 +110,6 @@ dav1dFrameInfo::dav1dFrameInfo(Size frameSize, Dav1dFrameType frameType)
 
 decoderDav1d::decoderDav1d(int signalID, bool cachingDecoder) : decoderBaseSingleLib(cachingDecoder)
 {
-  currentOutputBuffer.clear();
-
   // Libde265 can only decoder HEVC in YUV format
   this->rawFormat = video::RawFormat::YUV;
 
@@ -197,6 +195,9 @@ void decoderDav1d::resolveLibraryFunctionPointers()
   if (!resolve(this->lib.dav1d_data_create, "dav1d_data_create"))
     return;
 
+  // Optional. Without it, the decoded pictures must be copied.
+  resolve(this->lib.dav1d_picture_unref, "dav1d_picture_unref", true);
+
   DEBUG_DAV1D("decoderDav1d::resolveLibraryFunctionPointers - decoding functions found");
 
   // This means that
@@ -239,6 +240,18 @@ void decoderDav1d::allocateNewDecoder()
 
   this->lib.dav1d_default_settings(&settings);
 
+  // Dav1d decodes tiles and frames in parallel. Tile threads only help if the stream uses tiles,
+  // so by default most threads decode frames in parallel.
+  const auto nrThreads = this->getNrDecoderThreads("dav1dThreads");
+  QSettings  threadSettings;
+  threadSettings.beginGroup("Decoders");
+  auto nrTileThreads = threadSettings.value("dav1dTileThreads", 0).toInt();
+  threadSettings.endGroup();
+  if (nrTileThreads <= 0)
+    nrTileThreads = std::min(nrThreads, 4);
+  settings.n_tile_threads  = clip(nrTileThreads, 1, 64);
+  settings.n_frame_threads = clip(nrThreads / settings.n_tile_threads, 1, 256);
+
   // Create new decoder object
   int err = this->lib.dav1d_open(&decoder, &settings);
   if (err != 0)
@@ -276,7 +289,7 @@ void decoderDav1d::allocateNewDecoder()
 
   // The decoder is ready to receive data
   decoderBase::resetDecoder();
-  currentOutputBuffer.clear();
+  this->currentFrameBuffer = {};
   decodedFrameWaiting = false;
   flushing            = false;
 }
@@ -302,6 +315,9 @@ bool decoderDav1d::decodeFrame()
   if (decoder == nullptr)
     return false;
 
+  // The reference to the last picture is released when it is not used anymore
+  this->curPictureRef.reset();
+  this->currentFrameBuffer = {};
   curPicture.clear();
 
   int res = this->lib.dav1d_get_picture(decoder, curPicture.getPicture());
@@ -338,7 +354,16 @@ bool decoderDav1d::decodeFrame()
     DEBUG_DAV1D("decoderDav1d::decodeFrame Picture decoded - switching to retrieve frame mode");
 
     decoderState = DecoderState::RetrieveFrames;
-    currentOutputBuffer.clear();
+
+    if (this->lib.dav1d_picture_unref)
+    {
+      auto unref          = this->lib.dav1d_picture_unref;
+      auto picture        = new Dav1dPicture(*curPicture.getPicture());
+      this->curPictureRef = std::shared_ptr<Dav1dPicture>(picture, [unref](Dav1dPicture *p) {
+        unref(p);
+        delete p;
+      });
+    }
     return true;
   }
   else if (res != -EAGAIN)
@@ -351,31 +376,46 @@ bool decoderDav1d::decodeFrame()
 }
 
 QByteArray decoderDav1d::getRawFrameData()
+{
+  return this->getFrameBuffer().toByteArray();
+}
+
+video::FrameBuffer decoderDav1d::getFrameBuffer()
 {
   auto s = curPicture.getFrameSize();
   if (s.width <= 0 || s.height <= 0)
   {
-    DEBUG_DAV1D("decoderDav1d::getRawFrameData: Current picture has invalid size.");
-    return QByteArray();
+    DEBUG_DAV1D("decoderDav1d::getFrameBuffer: Current picture has invalid size.");
+    return {};
   }
   if (decoderState != DecoderState::RetrieveFrames)
   {
-    DEBUG_DAV1D("decoderDav1d::getRawFrameData: Wrong decoder state.");
-    return QByteArray();
+    DEBUG_DAV1D("decoderDav1d::getFrameBuffer: Wrong decoder state.");
+    return {};
   }
 
-  if (currentOutputBuffer.isEmpty())
+  if (this->currentFrameBuffer.isNull())
   {
-    // Put image data into buffer
-    copyImgToByteArray(curPicture, currentOutputBuffer);
-    DEBUG_DAV1D("decoderDav1d::getRawFrameData copied frame to buffer");
+    // The prediction and the reconstruction before filtering are only exported by the analyzer
+    // interface. We don't know how long these buffers stay valid so they are always copied.
+    if (this->curPictureRef && decodeSignal == 0)
+    {
+      this->currentFrameBuffer =
+          video::FrameBuffer(this->getPlanes(curPicture), this->curPictureRef);
+      DEBUG_DAV1D("decoderDav1d::getFrameBuffer wrapped picture in frame buffer");
+    }
+    else
+    {
+      this->copyImgToFrameBuffer(curPicture, this->currentFrameBuffer);
+      DEBUG_DAV1D("decoderDav1d::getFrameBuffer copied frame to buffer");
+    }
 
     if (this->statisticsEnabled())
       // Get the statistics from the image and put them into the statistics cache
       this->cacheStatistics(curPicture);
   }
 
-  return currentOutputBuffer;
+  return this->currentFrameBuffer;
 }
 
 bool decoderDav1d::pushData(QByteArray &data)
@@ -469,36 +509,17 @@ bool decoderDav1d::pushData(QByteArray &data)
   return true;
 }
 
-#if SSE_CONVERSION
-void decoderDav1d::copyImgToByteArray(const Dav1dPictureWrapper &src, byteArrayAligned &dst)
-#else
-void decoderDav1d::copyImgToByteArray(const Dav1dPictureWrapper &src, QByteArray &dst)
-#endif
+std::vector<video::FrameBuffer::Plane>
+decoderDav1d::getPlanes(const Dav1dPictureWrapper &src) const
 {
   // How many image planes are there?
   int nrPlanes = (src.getSubsampling() == Subsampling::YUV_400) ? 1 : 3;
 
-  // At first get how many bytes we are going to write
   const auto nrBytesPerSample = (src.getBitDepth() > 8) ? 2 : 1;
   const auto framSize         = src.getFrameSize();
-  auto       nrBytes          = frameSize.width * frameSize.height * nrBytesPerSample;
   auto       layout           = src.getSubsampling();
-  if (layout == Subsampling::YUV_420)
-    nrBytes += (frameSize.width / 2) * (frameSize.height / 2) * 2 * nrBytesPerSample;
-  else if (layout == Subsampling::YUV_422)
-    nrBytes += (frameSize.width / 2) * frameSize.height * 2 * nrBytesPerSample;
-  else if (layout == Subsampling::YUV_444)
-    nrBytes += frameSize.width * frameSize.height * 2 * nrBytesPerSample;
-
-  DEBUG_DAV1D("decoderDav1d::copyImgToByteArray nrBytes %d", nrBytes);
-
-  // Is the output big enough?
-  if (dst.capacity() < int(nrBytes))
-    dst.resize(int(nrBytes));
 
-  uint8_t *dst_c = (uint8_t *)dst.data();
-
-  // We can now copy from src to dst
+  std::vector<video::FrameBuffer::Plane> planes;
   for (int c = 0; c < nrPlanes; c++)
   {
     auto width  = framSize.width;
@@ -510,25 +531,55 @@ void decoderDav1d::copyImgToByteArray(const Dav1dPictureWrapper &src, QByteArray
       if (layout == Subsampling::YUV_420)
         height /= 2;
     }
-    const size_t widthInBytes = width * nrBytesPerSample;
 
     uint8_t *img_c = nullptr;
     if (decodeSignal == 0)
-      img_c = curPicture.getData(c);
+      img_c = src.getData(c);
     else if (decodeSignal == 1)
-      img_c = curPicture.getDataPrediction(c);
+      img_c = src.getDataPrediction(c);
     else if (decodeSignal == 2)
-      img_c = curPicture.getDataReconstructionPreFiltering(c);
+      img_c = src.getDataReconstructionPreFiltering(c);
 
     if (img_c == nullptr)
-      return;
+      return {};
+
+    video::FrameBuffer::Plane plane;
+    plane.data      = img_c;
+    plane.stride    = size_t((c == 0) ? src.getStride(0) : src.getStride(1));
+    plane.lineBytes = width * nrBytesPerSample;
+    plane.nrLines   = height;
+    planes.push_back(plane);
+  }
+  return planes;
+}
+
+void decoderDav1d::copyImgToFrameBuffer(const Dav1dPictureWrapper &src, video::FrameBuffer &dst)
+{
+  // At first get how many bytes we are going to write
+  const auto nrBytesPerSample = (src.getBitDepth() > 8) ? 2 : 1;
+  auto       nrBytes          = frameSize.width * frameSize.height * nrBytesPerSample;
+  auto       layout           = src.getSubsampling();
+  if (layout == Subsampling::YUV_420)
+    nrBytes += (frameSize.width / 2) * (frameSize.height / 2) * 2 * nrBytesPerSample;
+  else if (layout == Subsampling::YUV_422)
+    nrBytes += (frameSize.width / 2) * frameSize.height * 2 * nrBytesPerSample;
+  else if (layout == Subsampling::YUV_444)
+    nrBytes += frameSize.width * frameSize.height * 2 * nrBytesPerSample;
+
+  DEBUG_DAV1D("decoderDav1d::copyImgToFrameBuffer nrBytes %d", nrBytes);
 
-    const int stride = (c == 0) ? curPicture.getStride(0) : curPicture.getStride(1);
-    for (size_t y = 0; y < height; y++)
+  uint8_t *dst_c = nullptr;
+  dst            = this->allocateFrameBuffer(size_t(nrBytes), dst_c);
+
+  // We can now copy from src to dst
+  for (const auto &plane : this->getPlanes(src))
+  {
+    auto img_c = plane.data;
+    for (unsigned y = 0; y < plane.nrLines; y++)
     {
-      memcpy(dst_c, img_c, widthInBytes);
-      img_c += stride;
-      dst_c += widthInBytes;
+      memcpy(dst_c, img_c, plane.lineBytes);
+      img_c += plane.stride;
+      dst_c += plane.lineBytes;
     }
   }
 }
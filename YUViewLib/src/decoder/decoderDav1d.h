@@ -56,6 +56,7 @@ struct LibraryFunctionsDav1d
   void (*dav1d_flush)(Dav1dContext *){};
 
   uint8_t *(*dav1d_data_create)(Dav1dData *data, size_t sz){};
+  void (*dav1d_picture_unref)(Dav1dPicture *p){};
 
   // The interface for the analizer. These might not be available in the library.
   void (*dav1d_default_analyzer_settings)(Dav1dAnalyzerFlags *s){};
@@ -123,9 +124,10 @@ public:
   void        setDecodeSignal(int signalID, bool &decoderResetNeeded) override;
 
   // Decoding / pushing data
-  bool       decodeNextFrame() override;
-  QByteArray getRawFrameData() override;
-  bool       pushData(QByteArray &data) override;
+  bool               decodeNextFrame() override;
+  QByteArray         getRawFrameData() override;
+  video::FrameBuffer getFrameBuffer() override;
+  bool               pushData(QByteArray &data) override;
 
   // Check if the given library file is an existing libde265 decoder that we can use.
   static bool checkLibraryFile(QString libFilePath, QString &error);
@@ -169,17 +171,18 @@ private:
 
   Dav1dPictureWrapper curPicture;
 
-  // We buffer the current image as a QByteArray so you can call getYUVFrameData as often as
-  // necessary without invoking the copy operation from the libde265 buffer to the QByteArray again.
-#if SSE_CONVERSION
-  byteArrayAligned currentOutputBuffer;
-  void             copyImgToByteArray(const Dav1dPictureWrapper &src, byteArrayAligned &dst);
-#else
-  QByteArray currentOutputBuffer;
-  void       copyImgToByteArray(
-            const Dav1dPictureWrapper &src,
-            QByteArray &               dst); // Copy the raw data from the Dav1dPicture source *src to the byte array
-#endif
+  // If the library can unreference pictures, we take the reference to the current picture. The
+  // frame buffer of the reconstruction points to the planes of the picture and keeps the reference
+  // alive as long as the frame buffer is used. This way, the picture does not have to be copied.
+  // Otherwise, the picture is copied to the frame buffer.
+  std::shared_ptr<Dav1dPicture> curPictureRef;
+  video::FrameBuffer            currentFrameBuffer;
+  // The planes of the selected signal (without padding) in the given picture
+  std::vector<video::FrameBuffer::Plane> getPlanes(const Dav1dPictureWrapper &src) const;
+
+  // Copy the raw data from the Dav1dPicture source to the frame buffer (using memory from the
+  // buffer pool). This is used if the picture can not be referenced.
+  void copyImgToFrameBuffer(const Dav1dPictureWrapper &src, video::FrameBuffer &dst);
 
   // Statistics
   void fillStatisticList(stats::StatisticsData &) const override;
@@ -148,12 +148,15 @@ bool decoderFFmpeg::decodeNextFrame()
   if (!this->decodeFrame())
     return false;
 
-  this->copyCurImageToBuffer();
-
   if (this->statisticsEnabled())
     // Get the statistics from the image and put them into the statistics cache
     this->cacheCurStatistics();
 
+  if (this->rawFormat == video::RawFormat::YUV)
+    this->wrapCurImageInFrameBuffer();
+  else
+    this->copyCurImageToBuffer();
+
   return true;
 }
 
@@ -167,12 +170,59 @@ QByteArray decoderFFmpeg::getRawFrameData()
 
   DEBUG_FFMPEG("decoderFFmpeg::getYUVFrameData Copy frame");
 
+  if (this->rawFormat == video::RawFormat::YUV && this->currentOutputBuffer.isEmpty())
+    this->currentOutputBuffer = this->currentFrameBuffer.toByteArray();
+
   if (this->currentOutputBuffer.isEmpty())
     DEBUG_FFMPEG("decoderFFmpeg::loadYUVFrameData empty buffer");
 
   return this->currentOutputBuffer;
 }
 
+video::FrameBuffer decoderFFmpeg::getFrameBuffer()
+{
+  if (this->decoderState != DecoderState::RetrieveFrames)
+  {
+    DEBUG_FFMPEG("decoderFFmpeg::getFrameBuffer: Wrong decoder state.");
+    return {};
+  }
+
+  if (this->rawFormat == video::RawFormat::YUV)
+    return this->currentFrameBuffer;
+  return video::FrameBuffer(this->currentOutputBuffer);
+}
+
+void decoderFFmpeg::wrapCurImageInFrameBuffer()
+{
+  if (!frame)
+    return;
+
+  const auto pixFmt           = this->getPixelFormatYUV();
+  const auto nrBytesPerSample = pixFmt.getBitsPerSample() <= 8 ? 1 : 2;
+
+  // The linesize of the source may be larger than the width of the frame. This may be because the
+  // frame buffer is (8) byte aligned. Also the internal decoded resolution may be larger than the
+  // output frame size. The frame buffer only points to the part of each line that we need.
+  std::vector<video::FrameBuffer::Plane> planes;
+  for (unsigned plane = 0; plane < pixFmt.getNrPlanes(); plane++)
+  {
+    const auto component =
+        (plane == 0) ? video::yuv::Component::Luma : video::yuv::Component::Chroma;
+    video::FrameBuffer::Plane p;
+    p.data      = frame.getData(plane);
+    p.stride    = size_t(frame.getLineSize(plane));
+    p.lineBytes = this->frameSize.width / pixFmt.getSubsamplingHor(component) * nrBytesPerSample;
+    p.nrLines   = this->frameSize.height / pixFmt.getSubsamplingVer(component);
+    planes.push_back(p);
+  }
+
+  auto frameFree = this->ff.lib.av_frame_free;
+  auto avFrame   = std::shared_ptr<AVFrame>(this->frame.takeFrame(this->ff),
+                                          [frameFree](AVFrame *f) { frameFree(&f); });
+  this->currentFrameBuffer = video::FrameBuffer(planes, avFrame);
+  this->currentOutputBuffer.clear();
+}
+
 void decoderFFmpeg::copyCurImageToBuffer()
 {
   if (!frame)
@@ -182,44 +232,7 @@ void decoderFFmpeg::copyCurImageToBuffer()
   // AVDictionaryWrapper dict = this->ff.get_metadata(frame);
   // QStringPairList values = this->ff.getDictionary_entries(dict, "", 0);
 
-  if (this->rawFormat == video::RawFormat::YUV)
-  {
-    // At first get how many bytes we are going to write
-    const auto pixFmt           = this->getPixelFormatYUV();
-    const auto nrBytesPerSample = pixFmt.getBitsPerSample() <= 8 ? 1 : 2;
-    const auto nrBytesY         = this->frameSize.width * this->frameSize.height * nrBytesPerSample;
-    const auto nrBytesC         = this->frameSize.width / pixFmt.getSubsamplingHor() *
-                          this->frameSize.height / pixFmt.getSubsamplingVer() * nrBytesPerSample;
-    const auto nrBytes = nrBytesY + 2 * nrBytesC;
-
-    // Is the output big enough?
-    if (auto c = functions::clipToUnsigned(this->currentOutputBuffer.capacity()); c < nrBytes)
-      this->currentOutputBuffer.resize(nrBytes);
-
-    // Copy line by line. The linesize of the source may be larger than the width of the frame.
-    // This may be because the frame buffer is (8) byte aligned. Also the internal decoded
-    // resolution may be larger than the output frame size.
-    for (unsigned plane = 0; plane < pixFmt.getNrPlanes(); plane++)
-    {
-      const auto component =
-          (plane == 0) ? video::yuv::Component::Luma : video::yuv::Component::Chroma;
-      auto       src         = frame.getData(plane);
-      const auto srcLinesize = frame.getLineSize(plane);
-      auto       dst         = this->currentOutputBuffer.data();
-      if (plane > 0)
-        dst += (nrBytesY + (plane - 1) * nrBytesC);
-      const auto dstLinesize =
-          this->frameSize.width / pixFmt.getSubsamplingHor(component) * nrBytesPerSample;
-      const auto height = this->frameSize.height / pixFmt.getSubsamplingVer(component);
-      for (unsigned y = 0; y < height; y++)
-      {
-        memcpy(dst, src, dstLinesize);
-        dst += dstLinesize;
-        src += srcLinesize;
-      }
-    }
-  }
-  else if (this->rawFormat == video::RawFormat::RGB)
+  if (this->rawFormat == video::RawFormat::RGB)
   {
     const auto pixFmt           = this->getRGBPixelFormat();
     const auto nrBytesPerSample = pixFmt.getBitsPerSample() <= 8 ? 1 : 2;
@@ -227,9 +240,12 @@ void decoderFFmpeg::copyCurImageToBuffer()
         this->frameSize.width * this->frameSize.height * nrBytesPerSample;
     const auto nrBytes = nrBytesPerComponent * pixFmt.nrChannels();
 
-    // Is the output big enough?
-    if (auto c = functions::clipToUnsigned(this->currentOutputBuffer.capacity()); c < nrBytes)
-      this->currentOutputBuffer.resize(nrBytes);
+    // Is the output big enough? If the last frame is still used by someone else (the video handler
+    // shares the buffer), writing to it would detach and copy the old frame first. Start a new
+    // buffer in this case.
+    if (auto c = functions::clipToUnsigned(this->currentOutputBuffer.capacity());
+        c < nrBytes || !this->currentOutputBuffer.isDetached())
+      this->currentOutputBuffer = QByteArray(int(nrBytes), Qt::Uninitialized);
 
     auto       dst  = this->currentOutputBuffer.data();
     const auto hDst = this->frameSize.height;
@@ -469,6 +485,16 @@ bool decoderFFmpeg::createDecoder(AVCodecIDWrapper codecID, AVCodecParametersWra
     return this->setErrorB(
         QStringLiteral("Could not request motion vector retrieval. Return code %1").arg(ret));
 
+  // Let the decoder use frame and slice threads. An explicit thread count is needed because
+  // the default of FFmpeg is one thread per core for each decoder instance.
+  const auto nrThreads = QString::number(this->getNrDecoderThreads("FFmpegThreads")).toStdString();
+  ret                  = this->ff.dictSet(opts, "threads", nrThreads.c_str(), 0);
+  if (ret >= 0)
+    ret = this->ff.dictSet(opts, "thread_type", "frame+slice", 0);
+  if (ret < 0)
+    return this->setErrorB(
+        QStringLiteral("Could not set the number of decoder threads. Return code %1").arg(ret));
+
   // Open codec
   ret = this->ff.avcodecOpen2(decCtx, videoCodec, opts);
   if (ret < 0)
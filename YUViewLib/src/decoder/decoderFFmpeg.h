@@ -54,8 +54,9 @@ public:
   void resetDecoder() override;
 
   // Decoding / pushing data
-  bool       decodeNextFrame() override;
-  QByteArray getRawFrameData() override;
+  bool               decodeNextFrame() override;
+  QByteArray         getRawFrameData() override;
+  video::FrameBuffer getFrameBuffer() override;
 
   // Push an AVPacket or raw data. When this returns false, pushing the given packet failed.
   // Probably the decoder switched to DecoderState::RetrieveFrames. Don't forget to push the given
@@ -90,7 +91,13 @@ protected:
 
   QByteArray currentOutputBuffer;
   void
-  copyCurImageToBuffer(); // Copy the raw data from the de265_image source *src to the byte array
+  copyCurImageToBuffer(); // Copy the raw RGB data from the frame to the byte array
+
+  // YUV frames are not copied. The decoded AVFrame is handed over to a frame buffer which points to
+  // the planes of the frame. The frame (and its buffers) are freed when the last user of the frame
+  // buffer is done with it. The packed currentOutputBuffer is only filled if it is requested.
+  video::FrameBuffer currentFrameBuffer;
+  void               wrapCurImageInFrameBuffer();
 
   // At the end of the file, when no more data is available, we will swith to flushing. After all
   // remaining frames were decoding, we will not request more data but switch to
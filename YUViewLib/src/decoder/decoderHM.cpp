@@ -339,7 +339,7 @@ bool decoderHM::pushData(QByteArray &data)
   {
     decodedFrameWaiting = true;
     decoderState        = DecoderState::RetrieveFrames;
-    currentOutputBuffer.clear();
+    currentOutputBuffer = {};
   }
 
   // If bNewPicture is true, the decoder noticed that a new picture starts with this
@@ -349,20 +349,25 @@ bool decoderHM::pushData(QByteArray &data)
 }
 
 QByteArray decoderHM::getRawFrameData()
+{
+  return this->getFrameBuffer().toByteArray();
+}
+
+video::FrameBuffer decoderHM::getFrameBuffer()
 {
   if (currentHMPic == nullptr)
-    return QByteArray();
+    return {};
   if (decoderState != DecoderState::RetrieveFrames)
   {
-    DEBUG_DECHM("decoderHM::getRawFrameData: Wrong decoder state.");
-    return QByteArray();
+    DEBUG_DECHM("decoderHM::getFrameBuffer: Wrong decoder state.");
+    return {};
   }
 
-  if (currentOutputBuffer.isEmpty())
+  if (currentOutputBuffer.isNull())
   {
     // Put image data into buffer
-    copyImgToByteArray(currentHMPic, currentOutputBuffer);
-    DEBUG_DECHM("decoderHM::getRawFrameData copied frame to buffer");
+    copyImgToFrameBuffer(currentHMPic, currentOutputBuffer);
+    DEBUG_DECHM("decoderHM::getFrameBuffer copied frame to buffer");
 
     if (this->statisticsEnabled())
       // Get the statistics from the image and put them into the statistics cache
@@ -372,11 +377,7 @@ QByteArray decoderHM::getRawFrameData()
   return currentOutputBuffer;
 }
 
-#if SSE_CONVERSION
-void decoderHM::copyImgToByteArray(libHMDec_picture *src, byteArrayAligned &dst)
-#else
-void decoderHM::copyImgToByteArray(libHMDec_picture *src, QByteArray &dst)
-#endif
+void decoderHM::copyImgToFrameBuffer(libHMDec_picture *src, video::FrameBuffer &dst)
 {
   // How many image planes are there?
   auto fmt      = this->lib.libHMDEC_get_chroma_format(src);
@@ -402,13 +403,12 @@ void decoderHM::copyImgToByteArray(libHMDec_picture *src, QByteArray &dst)
                                      this->lib.libHMDEC_get_picture_height(src, LIBHMDEC_CHROMA_V));
   // How many bytes do we need in the output buffer?
   int nrBytesOutput = (outSizeY + outSizeCb + outSizeCr) * (outputTwoByte ? 2 : 1);
-  DEBUG_DECHM("decoderHM::copyImgToByteArray nrBytesOutput %d", nrBytesOutput);
+  DEBUG_DECHM("decoderHM::copyImgToFrameBuffer nrBytesOutput %d", nrBytesOutput);
 
-  // Is the output big enough?
-  if (dst.capacity() < nrBytesOutput)
-    dst.resize(nrBytesOutput);
+  unsigned char *data = nullptr;
+  dst                 = this->allocateFrameBuffer(size_t(nrBytesOutput), data);
 
-  // The source (from HM) is always short (16bit). The destination is a QByteArray so
+  // The source (from HM) is always short (16bit). The destination is a byte buffer so
   // we have to cast it right.
   for (int c = 0; c < nrPlanes; c++)
   {
@@ -425,7 +425,7 @@ void decoderHM::copyImgToByteArray(libHMDec_picture *src, QByteArray &dst)
 
     if (outputTwoByte)
     {
-      unsigned short *restrict d = (unsigned short *)dst.data();
+      unsigned short *restrict d = (unsigned short *)data;
       if (c > 0)
         d += outSizeY;
       if (c == 2)
@@ -443,7 +443,7 @@ void decoderHM::copyImgToByteArray(libHMDec_picture *src, QByteArray &dst)
     }
     else
     {
-      unsigned char *restrict d = (unsigned char *)dst.data();
+      unsigned char *restrict d = data;
       if (c > 0)
         d += outSizeY;
       if (c == 2)
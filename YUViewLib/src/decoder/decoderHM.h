@@ -92,9 +92,10 @@ public:
   void resetDecoder() override;
 
   // Decoding / pushing data
-  bool       decodeNextFrame() override;
-  QByteArray getRawFrameData() override;
-  bool       pushData(QByteArray &data) override;
+  bool               decodeNextFrame() override;
+  QByteArray         getRawFrameData() override;
+  video::FrameBuffer getFrameBuffer() override;
+  bool               pushData(QByteArray &data) override;
 
   // Check if the given library file is an existing libde265 decoder that we can use.
   static bool checkLibraryFile(QString libFilePath, QString &error);
@@ -141,17 +142,11 @@ private:
   // Add the statistics supported by the HM decoder
   void fillStatisticList(stats::StatisticsData &statisticsData) const override;
 
-  // We buffer the current image as a QByteArray so you can call getYUVFrameData as often as
-  // necessary without invoking the copy operation from the hm image buffer to the QByteArray again.
-#if SSE_CONVERSION
-  byteArrayAligned currentOutputBuffer;
-  void             copyImgToByteArray(libHMDec_picture *src, byteArrayAligned &dst);
-#else
-  QByteArray currentOutputBuffer;
-  void       copyImgToByteArray(
-            libHMDec_picture *src,
-            QByteArray &      dst); // Copy the raw data from the de265_image source *src to the byte array
-#endif
+  // We buffer the current image so you can call getFrameBuffer as often as necessary without
+  // invoking the copy operation from the HM image buffer again. The memory is from the buffer pool.
+  video::FrameBuffer currentOutputBuffer;
+  // Copy the raw data from the libHMDec_picture source *src to the frame buffer
+  void copyImgToFrameBuffer(libHMDec_picture *src, video::FrameBuffer &dst);
 
   LibraryFunctionsHM lib;
 };
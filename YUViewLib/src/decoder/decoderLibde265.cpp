@@ -91,7 +91,7 @@ Subsampling convertFromInternalSubsampling(de265_chroma fmt)
 decoderLibde265::decoderLibde265(int signalID, bool cachingDecoder)
     : decoderBaseSingleLib(cachingDecoder)
 {
-  currentOutputBuffer.clear();
+  currentOutputBuffer = {};
 
   // Libde265 can only decoder HEVC in YUV format
   rawFormat = video::RawFormat::YUV;
@@ -297,14 +297,14 @@ void decoderLibde265::allocateNewDecoder()
   this->lib.de265_set_limit_TID(decoder, 100);
 
   // Set the number of decoder threads. Libde265 can use wavefronts to utilize these.
-  // TODO: We should add a setting for this maybe?
-  auto err = this->lib.de265_start_worker_threads(decoder, 8);
+  const auto nrThreads = this->getNrDecoderThreads("libde265Threads");
+  auto       err       = this->lib.de265_start_worker_threads(decoder, nrThreads);
   if (err != DE265_OK)
     return setError("Error starting libde265 worker threads (de265_start_worker_threads)");
 
   // The decoder is ready to receive data
   decoderBase::resetDecoder();
-  currentOutputBuffer.clear();
+  currentOutputBuffer = {};
   decodedFrameWaiting = false;
   flushing            = false;
 }
@@ -385,27 +385,32 @@ bool decoderLibde265::decodeFrame()
     DEBUG_LIBDE265("decoderLibde265::decodeFrame Picture decoded");
 
     decoderState = DecoderState::RetrieveFrames;
-    currentOutputBuffer.clear();
+    currentOutputBuffer = {};
     return true;
   }
   return false;
 }
 
 QByteArray decoderLibde265::getRawFrameData()
+{
+  return this->getFrameBuffer().toByteArray();
+}
+
+video::FrameBuffer decoderLibde265::getFrameBuffer()
 {
   if (curImage == nullptr)
-    return QByteArray();
+    return {};
   if (decoderState != DecoderState::RetrieveFrames)
   {
-    DEBUG_LIBDE265("decoderLibde265::getRawFrameData: Wrong decoder state.");
-    return QByteArray();
+    DEBUG_LIBDE265("decoderLibde265::getFrameBuffer: Wrong decoder state.");
+    return {};
   }
 
-  if (currentOutputBuffer.isEmpty())
+  if (currentOutputBuffer.isNull())
   {
     // Put image data into buffer
-    copyImgToByteArray(curImage, currentOutputBuffer);
-    DEBUG_LIBDE265("decoderLibde265::getRawFrameData copied frame to buffer");
+    copyImgToFrameBuffer(curImage, currentOutputBuffer);
+    DEBUG_LIBDE265("decoderLibde265::getFrameBuffer copied frame to buffer");
 
     if (this->statisticsEnabled())
       // Get the statistics from the image and put them into the statistics cache
@@ -468,11 +473,7 @@ bool decoderLibde265::pushData(QByteArray &data)
   return true;
 }
 
-#if SSE_CONVERSION
-void decoderLibde265::copyImgToByteArray(const de265_image *src, byteArrayAligned &dst)
-#else
-void decoderLibde265::copyImgToByteArray(const de265_image *src, QByteArray &dst)
-#endif
+void decoderLibde265::copyImgToFrameBuffer(const de265_image *src, video::FrameBuffer &dst)
 {
   // How many image planes are there?
   auto cMode    = this->lib.de265_get_chroma_format(src);
@@ -490,13 +491,10 @@ void decoderLibde265::copyImgToByteArray(const de265_image *src, QByteArray &dst
     nrBytes += width * height * nrBytesPerSample;
   }
 
-  DEBUG_LIBDE265("decoderLibde265::copyImgToByteArray nrBytes %d", nrBytes);
-
-  // Is the output big enough?
-  if (dst.capacity() < nrBytes)
-    dst.resize(nrBytes);
+  DEBUG_LIBDE265("decoderLibde265::copyImgToFrameBuffer nrBytes %d", nrBytes);
 
-  uint8_t *dst_c = (uint8_t *)dst.data();
+  uint8_t *dst_c = nullptr;
+  dst            = this->allocateFrameBuffer(size_t(nrBytes), dst_c);
 
   // We can now copy from src to dst
   for (int c = 0; c < nrPlanes; c++)
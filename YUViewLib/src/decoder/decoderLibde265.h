@@ -108,9 +108,10 @@ public:
   void setDecodeSignal(int signalID, bool &decoderResetNeeded) override;
 
   // Decoding / pushing data
-  bool       decodeNextFrame() override;
-  QByteArray getRawFrameData() override;
-  bool       pushData(QByteArray &data) override;
+  bool               decodeNextFrame() override;
+  QByteArray         getRawFrameData() override;
+  video::FrameBuffer getFrameBuffer() override;
+  bool               pushData(QByteArray &data) override;
 
   // Statistics
   void fillStatisticList(stats::StatisticsData &statisticsData) const override;
@@ -173,17 +174,11 @@ private:
                                         int            intraDir_infoUnit_size,
                                         int            widthInIntraDirUnits);
 
-  // We buffer the current image as a QByteArray so you can call getYUVFrameData as often as
-  // necessary without invoking the copy operation from the libde265 buffer to the QByteArray again.
-#if SSE_CONVERSION
-  byteArrayAligned currentOutputBuffer;
-  void             copyImgToByteArray(const de265_image *src, byteArrayAligned &dst);
-#else
-  QByteArray currentOutputBuffer;
-  void       copyImgToByteArray(
-            const de265_image *src,
-            QByteArray &       dst); // Copy the raw data from the de265_image source *src to the byte array
-#endif
+  // We buffer the current image so you can call getFrameBuffer as often as necessary without
+  // invoking the copy operation from the libde265 buffer again. The memory is from the buffer pool.
+  video::FrameBuffer currentOutputBuffer;
+  // Copy the raw data from the de265_image source *src to the frame buffer
+  void copyImgToFrameBuffer(const de265_image *src, video::FrameBuffer &dst);
 
   LibraryFunctionsDe265 lib;
 };
@@ -299,7 +299,7 @@ bool decoderVTM::getNextFrameFromDecoder()
 
   DEBUG_DECVTM("decoderVTM::getNextFrameFromDecoder got a valid frame wit POC %d",
                this->lib.libVTMDec_get_POC(currentVTMPic));
-  currentOutputBuffer.clear();
+  currentOutputBuffer = {};
   return true;
 }
 
@@ -333,7 +333,7 @@ bool decoderVTM::pushData(QByteArray &data)
   {
     decodedFrameWaiting = true;
     decoderState        = DecoderState::RetrieveFrames;
-    currentOutputBuffer.clear();
+    currentOutputBuffer = {};
   }
 
   // If bNewPicture is true, the decoder noticed that a new picture starts with this
@@ -343,20 +343,25 @@ bool decoderVTM::pushData(QByteArray &data)
 }
 
 QByteArray decoderVTM::getRawFrameData()
+{
+  return this->getFrameBuffer().toByteArray();
+}
+
+video::FrameBuffer decoderVTM::getFrameBuffer()
 {
   if (currentVTMPic == nullptr)
-    return QByteArray();
+    return {};
   if (decoderState != DecoderState::RetrieveFrames)
   {
-    DEBUG_DECVTM("decoderVTM::getRawFrameData: Wrong decoder state.");
-    return QByteArray();
+    DEBUG_DECVTM("decoderVTM::getFrameBuffer: Wrong decoder state.");
+    return {};
   }
 
-  if (currentOutputBuffer.isEmpty())
+  if (currentOutputBuffer.isNull())
   {
     // Put image data into buffer
-    copyImgToByteArray(currentVTMPic, currentOutputBuffer);
-    DEBUG_DECVTM("decoderVTM::getRawFrameData copied frame to buffer");
+    copyImgToFrameBuffer(currentVTMPic, currentOutputBuffer);
+    DEBUG_DECVTM("decoderVTM::getFrameBuffer copied frame to buffer");
 
     if (this->statisticsEnabled())
       // Get the statistics from the image and put them into the statistics cache
@@ -366,11 +371,7 @@ QByteArray decoderVTM::getRawFrameData()
   return currentOutputBuffer;
 }
 
-#if SSE_CONVERSION
-void decoderVTM::copyImgToByteArray(libVTMDec_picture *src, byteArrayAligned &dst)
-#else
-void decoderVTM::copyImgToByteArray(libVTMDec_picture *src, QByteArray &dst)
-#endif
+void decoderVTM::copyImgToFrameBuffer(libVTMDec_picture *src, video::FrameBuffer &dst)
 {
   // How many image planes are there?
   auto fmt      = this->lib.libVTMDec_get_chroma_format(src);
@@ -392,13 +393,12 @@ void decoderVTM::copyImgToByteArray(libVTMDec_picture *src, QByteArray &dst)
                          this->lib.libVTMDec_get_picture_height(src, LIBVTMDEC_CHROMA_V));
   // How many bytes do we need in the output buffer?
   int nrBytesOutput = (outSizeY + outSizeCb + outSizeCr) * (outputTwoByte ? 2 : 1);
-  DEBUG_DECVTM("decoderVTM::copyImgToByteArray nrBytesOutput %d", nrBytesOutput);
+  DEBUG_DECVTM("decoderVTM::copyImgToFrameBuffer nrBytesOutput %d", nrBytesOutput);
 
-  // Is the output big enough?
-  if (dst.capacity() < nrBytesOutput)
-    dst.resize(nrBytesOutput);
+  unsigned char *data = nullptr;
+  dst                 = this->allocateFrameBuffer(size_t(nrBytesOutput), data);
 
-  // The source (from VTM) is always short (16bit). The destination is a QByteArray so
+  // The source (from VTM) is always short (16bit). The destination is a byte buffer so
   // we have to cast it right.
   for (int c = 0; c < nrPlanes; c++)
   {
@@ -415,7 +415,7 @@ void decoderVTM::copyImgToByteArray(libVTMDec_picture *src, QByteArray &dst)
 
     if (outputTwoByte)
     {
-      unsigned short *restrict d = (unsigned short *)dst.data();
+      unsigned short *restrict d = (unsigned short *)data;
       if (c > 0)
         d += outSizeY;
       if (c == 2)
@@ -435,7 +435,7 @@ void decoderVTM::copyImgToByteArray(libVTMDec_picture *src, QByteArray &dst)
     {
       // Output is one byte per pixel but VTM internally always saves everything in two bytes per
       // pixel
-      unsigned char *restrict d = (unsigned char *)dst.data();
+      unsigned char *restrict d = data;
       if (c > 0)
         d += outSizeY;
       if (c == 2)
@@ -269,6 +269,15 @@ void decoderVVDec::allocateNewDecoder()
   this->lib.vvdec_params_default(&params);
 
   params.logLevel = VVDEC_INFO;
+  params.threads  = this->getNrDecoderThreads("vvdecThreads");
+
+  // The parser threads are left to VVDec (-1) unless set explicitly
+  QSettings settings;
+  settings.beginGroup("Decoders");
+  const auto nrParseThreads = settings.value("vvdecParseThreads", 0).toInt();
+  settings.endGroup();
+  if (nrParseThreads > 0)
+    params.parseThreads = nrParseThreads;
 
   this->decoder = this->lib.vvdec_decoder_open(&params);
   if (this->decoder == nullptr)
@@ -278,7 +287,7 @@ void decoderVVDec::allocateNewDecoder()
   }
 
   this->flushing = false;
-  this->currentOutputBuffer.clear();
+  this->currentOutputBuffer = {};
   this->decoderState                  = DecoderState::NeedsMoreData;
   this->currentFrameReadyForRetrieval = false;
   this->currentFrame                  = nullptr;
@@ -331,7 +340,7 @@ bool decoderVVDec::decodeNextFrame()
       return false;
     }
 
-    this->currentOutputBuffer.clear();
+    this->currentOutputBuffer = {};
     DEBUG_vvdec("decoderVVDec::decodeNextFrame Flushing - Invalidate buffer");
   }
   else
@@ -426,7 +435,7 @@ bool decoderVVDec::pushData(QByteArray &data)
     DEBUG_vvdec("decoderVVDec::pushData: Setting flushing mode");
     this->flushing     = true;
     this->decoderState = DecoderState::RetrieveFrames;
-    this->currentOutputBuffer.clear();
+    this->currentOutputBuffer = {};
     return true;
   }
   else
@@ -458,36 +467,41 @@ bool decoderVVDec::pushData(QByteArray &data)
   if (this->getNextFrameFromDecoder())
   {
     this->decoderState = DecoderState::RetrieveFrames;
-    this->currentOutputBuffer.clear();
+    this->currentOutputBuffer = {};
   }
 
   return true;
 }
 
 QByteArray decoderVVDec::getRawFrameData()
+{
+  return this->getFrameBuffer().toByteArray();
+}
+
+video::FrameBuffer decoderVVDec::getFrameBuffer()
 {
   if (this->decoderState != DecoderState::RetrieveFrames)
   {
-    DEBUG_vvdec("decoderVVDec::getRawFrameData: Wrong decoder state.");
+    DEBUG_vvdec("decoderVVDec::getFrameBuffer: Wrong decoder state.");
     return {};
   }
 
-  if (this->currentOutputBuffer.isEmpty())
+  if (this->currentOutputBuffer.isNull())
   {
     // Put image data into buffer
-    copyImgToByteArray(this->currentOutputBuffer);
-    DEBUG_vvdec("decoderVVDec::getRawFrameData copied frame to buffer");
+    copyImgToFrameBuffer(this->currentOutputBuffer);
+    DEBUG_vvdec("decoderVVDec::getFrameBuffer copied frame to buffer");
   }
 
   return currentOutputBuffer;
 }
 
-void decoderVVDec::copyImgToByteArray(QByteArray &dst)
+void decoderVVDec::copyImgToFrameBuffer(video::FrameBuffer &dst)
 {
   auto fmt = this->currentFrame->colorFormat;
   if (fmt == VVDEC_CF_INVALID)
   {
-    DEBUG_vvdec("decoderVVDec::copyImgToByteArray picture format is unknown");
+    DEBUG_vvdec("decoderVVDec::copyImgToFrameBuffer picture format is unknown");
     return;
   }
   const auto nrPlanes       = this->currentFrame->numPlanes;
@@ -499,11 +513,10 @@ void decoderVVDec::copyImgToByteArray(QByteArray &dst)
   auto outSizeChromaBytes = chromaSize.width * chromaSize.height * bytesPerSample;
   // How many bytes do we need in the output buffer?
   auto nrBytesOutput = (outSizeLumaBytes + outSizeChromaBytes * 2);
-  DEBUG_vvdec("decoderVVDec::copyImgToByteArray nrBytesOutput %d", nrBytesOutput);
+  DEBUG_vvdec("decoderVVDec::copyImgToFrameBuffer nrBytesOutput %d", nrBytesOutput);
 
-  // Is the output big enough?
-  if (dst.capacity() < int(nrBytesOutput))
-    dst.resize(int(nrBytesOutput));
+  unsigned char *data = nullptr;
+  dst                 = this->allocateFrameBuffer(size_t(nrBytesOutput), data);
 
   for (unsigned c = 0; c < nrPlanes; c++)
   {
@@ -514,11 +527,11 @@ void decoderVVDec::copyImgToByteArray(QByteArray &dst)
 
     if (component.ptr == nullptr)
     {
-      DEBUG_vvdec("decoderVVDec::copyImgToByteArray unable to get plane for component %d", c);
+      DEBUG_vvdec("decoderVVDec::copyImgToFrameBuffer unable to get plane for component %d", c);
       return;
     }
 
-    unsigned char *restrict d = (unsigned char *)dst.data();
+    unsigned char *restrict d = data;
     if (c > 0)
       d += outSizeLumaBytes;
     if (c == 2)
@@ -82,9 +82,10 @@ public:
   void resetDecoder() override;
 
   // Decoding / pushing data
-  bool       decodeNextFrame() override;
-  QByteArray getRawFrameData() override;
-  bool       pushData(QByteArray &data) override;
+  bool               decodeNextFrame() override;
+  QByteArray         getRawFrameData() override;
+  video::FrameBuffer getFrameBuffer() override;
+  bool               pushData(QByteArray &data) override;
 
   // Check if the given library file is an existing libde265 decoder that we can use.
   static bool checkLibraryFile(QString libFilePath, QString &error);
@@ -122,10 +123,11 @@ private:
   int  nrSignals{0};
   bool flushing{false};
 
-  // We buffer the current image as a QByteArray so you can call getYUVFrameData as often as
-  // necessary without invoking the copy operation from the hm image buffer to the QByteArray again.
-  QByteArray currentOutputBuffer;
-  void       copyImgToByteArray(QByteArray &dst);
+  // We buffer the current image so you can call getFrameBuffer as often as necessary without
+  // invoking the copy operation from the vvdec image buffer again. The memory is from the buffer
+  // pool.
+  video::FrameBuffer currentOutputBuffer;
+  void               copyImgToFrameBuffer(video::FrameBuffer &dst);
 
   bool currentFrameReadyForRetrieval{};
 
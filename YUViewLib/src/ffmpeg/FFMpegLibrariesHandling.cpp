@@ -3132,6 +3132,14 @@ void AVFrameWrapper::freeFrame(FFmpegVersionHandler &ff)
   frame = nullptr;
 }
 
+AVFrame *AVFrameWrapper::takeFrame(FFmpegVersionHandler &ff)
+{
+  auto takenFrame = this->frame;
+  this->frame     = nullptr;
+  this->allocateFrame(ff);
+  return takenFrame;
+}
+
 AVPacketWrapper::~AVPacketWrapper()
 {
 }
@@ -825,6 +825,9 @@ public:
   ~AVFrameWrapper() { assert(this->frame == nullptr); }
   void     allocateFrame(FFmpegVersionHandler &ff);
   void     freeFrame(FFmpegVersionHandler &ff);
+  // Hand the frame (and the references to its buffers) over to the caller and allocate a new frame.
+  // The caller must free the returned frame using av_frame_free.
+  AVFrame *takeFrame(FFmpegVersionHandler &ff);
   uint8_t *getData(int component)
   {
     update();
@@ -0,0 +1,296 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FileIndex.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+namespace
+{
+
+const auto IndexFileMagic  = QByteArrayLiteral("YUVIEWIDX");
+const auto IndexFileSuffix = QString(".index");
+// Increase this if the format of the index files changes. Older files are then parsed again.
+constexpr quint32 IndexFileVersion = 1;
+
+// The fingerprint contains a hash of this many bytes from the start and the end of the file
+constexpr qint64 FingerprintHashBytes = 64 * 1024;
+
+QMutex  indexDirectoryMutex;
+QString indexDirectory;
+
+enum FrameFlags : quint8
+{
+  RandomAccessPoint = 1,
+  HasFilePos        = 2
+};
+
+void writeByteVector(QDataStream &stream, const ByteVector &data)
+{
+  stream << quint32(data.size());
+  stream.writeRawData(reinterpret_cast<const char *>(data.data()), int(data.size()));
+}
+
+bool readByteVector(QDataStream &stream, ByteVector &data)
+{
+  quint32 size;
+  stream >> size;
+  if (stream.status() != QDataStream::Ok || size > quint32(stream.device()->bytesAvailable()))
+    return false;
+  data.resize(size);
+  return stream.readRawData(reinterpret_cast<char *>(data.data()), int(size)) == int(size);
+}
+
+QByteArray serializeIndex(const FileIndex &index)
+{
+  QByteArray  data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  stream.setVersion(QDataStream::Qt_5_6);
+
+  stream << quint32(index.frames.size());
+  for (const auto &frame : index.frames)
+  {
+    quint8 flags = 0;
+    if (frame.randomAccessPoint)
+      flags |= RandomAccessPoint;
+    if (frame.fileStartEndPos)
+      flags |= HasFilePos;
+    stream << qint64(frame.timestamp) << flags;
+    if (frame.fileStartEndPos)
+      stream << quint64(frame.fileStartEndPos->first) << quint64(frame.fileStartEndPos->second);
+  }
+
+  stream << quint32(index.parameterSets.size());
+  for (const auto &parameterSet : index.parameterSets)
+    writeByteVector(stream, parameterSet);
+
+  stream << quint32(index.seekPoints.size());
+  for (const auto &seekPoint : index.seekPoints)
+  {
+    stream << quint32(seekPoint.frameIndex) << bool(seekPoint.filePos)
+           << quint64(seekPoint.filePos.value_or(0));
+    stream << quint32(seekPoint.parameterSets.size());
+    for (auto parameterSet : seekPoint.parameterSets)
+      stream << quint32(parameterSet);
+  }
+
+  stream << index.properties;
+  return data;
+}
+
+bool deserializeIndex(const QByteArray &data, FileIndex &index)
+{
+  QDataStream stream(data);
+  stream.setVersion(QDataStream::Qt_5_6);
+
+  // Check the counts against the remaining bytes so that a corrupt file can not make us allocate
+  // huge amounts of memory.
+  auto isCountValid = [&stream](quint32 count, qint64 minBytesPerEntry) {
+    return stream.status() == QDataStream::Ok &&
+           qint64(count) * minBytesPerEntry <= stream.device()->bytesAvailable();
+  };
+
+  quint32 nrFrames;
+  stream >> nrFrames;
+  if (!isCountValid(nrFrames, 9))
+    return false;
+  index.frames.resize(nrFrames);
+  for (auto &frame : index.frames)
+  {
+    qint64 timestamp;
+    quint8 flags;
+    stream >> timestamp >> flags;
+    frame.timestamp         = timestamp;
+    frame.randomAccessPoint = (flags & RandomAccessPoint) != 0;
+    if (flags & HasFilePos)
+    {
+      quint64 start, end;
+      stream >> start >> end;
+      frame.fileStartEndPos = pairUint64(start, end);
+    }
+  }
+
+  quint32 nrParameterSets;
+  stream >> nrParameterSets;
+  if (!isCountValid(nrParameterSets, 4))
+    return false;
+  index.parameterSets.resize(nrParameterSets);
+  for (auto &parameterSet : index.parameterSets)
+    if (!readByteVector(stream, parameterSet))
+      return false;
+
+  quint32 nrSeekPoints;
+  stream >> nrSeekPoints;
+  if (!isCountValid(nrSeekPoints, 17))
+    return false;
+  index.seekPoints.resize(nrSeekPoints);
+  for (auto &seekPoint : index.seekPoints)
+  {
+    quint32 frameIndex, nrSeekParameterSets;
+    bool    hasFilePos;
+    quint64 filePos;
+    stream >> frameIndex >> hasFilePos >> filePos >> nrSeekParameterSets;
+    if (!isCountValid(nrSeekParameterSets, 4))
+      return false;
+    seekPoint.frameIndex = frameIndex;
+    if (hasFilePos)
+      seekPoint.filePos = filePos;
+    for (quint32 i = 0; i < nrSeekParameterSets; i++)
+    {
+      quint32 parameterSet;
+      stream >> parameterSet;
+      if (parameterSet >= nrParameterSets)
+        return false;
+      seekPoint.parameterSets.push_back(parameterSet);
+    }
+  }
+
+  stream >> index.properties;
+  return stream.status() == QDataStream::Ok;
+}
+
+} // namespace
+
+unsigned FileIndex::addParameterSet(const ByteVector &parameterSet)
+{
+  auto it = std::find(this->parameterSets.begin(), this->parameterSets.end(), parameterSet);
+  if (it != this->parameterSets.end())
+    return unsigned(std::distance(this->parameterSets.begin(), it));
+  this->parameterSets.push_back(parameterSet);
+  return unsigned(this->parameterSets.size() - 1);
+}
+
+std::optional<FileIndex> FileIndex::load(const QString &filePath, const QString &type)
+{
+  QFile indexFile(getIndexFilePath(filePath));
+  if (!indexFile.open(QIODevice::ReadOnly))
+    return {};
+
+  QDataStream stream(&indexFile);
+  stream.setVersion(QDataStream::Qt_5_6);
+
+  QByteArray magic, fingerprint, compressedData;
+  quint32    version;
+  QString    indexType;
+  stream >> magic >> version >> indexType >> fingerprint;
+  if (stream.status() != QDataStream::Ok || magic != IndexFileMagic ||
+      version != IndexFileVersion || indexType != type)
+    return {};
+  if (fingerprint != getFingerprint(filePath))
+    return {};
+
+  stream >> compressedData;
+  if (stream.status() != QDataStream::Ok)
+    return {};
+
+  FileIndex index;
+  if (!deserializeIndex(qUncompress(compressedData), index))
+    return {};
+  return index;
+}
+
+bool FileIndex::save(const QString &filePath, const QString &type) const
+{
+  const auto fingerprint = getFingerprint(filePath);
+  if (fingerprint.isEmpty())
+    return false;
+
+  const auto indexFilePath = getIndexFilePath(filePath);
+  if (!QDir().mkpath(QFileInfo(indexFilePath).absolutePath()))
+    return false;
+
+  // Never leave a partially written index behind
+  QSaveFile indexFile(indexFilePath);
+  if (!indexFile.open(QIODevice::WriteOnly))
+    return false;
+
+  QDataStream stream(&indexFile);
+  stream.setVersion(QDataStream::Qt_5_6);
+  stream << IndexFileMagic << IndexFileVersion << type << fingerprint;
+  stream << qCompress(serializeIndex(*this));
+  if (stream.status() != QDataStream::Ok)
+  {
+    indexFile.cancelWriting();
+    return false;
+  }
+  return indexFile.commit();
+}
+
+QString FileIndex::getIndexDirectory()
+{
+  QMutexLocker locker(&indexDirectoryMutex);
+  if (indexDirectory.isEmpty())
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/index";
+  return indexDirectory;
+}
+
+void FileIndex::setIndexDirectory(const QString &directory)
+{
+  QMutexLocker locker(&indexDirectoryMutex);
+  indexDirectory = directory;
+}
+
+QString FileIndex::getIndexFilePath(const QString &filePath)
+{
+  const auto absolutePath = QFileInfo(filePath).absoluteFilePath();
+  const auto hash = QCryptographicHash::hash(absolutePath.toUtf8(), QCryptographicHash::Sha1);
+  return getIndexDirectory() + "/" + QString::fromLatin1(hash.toHex()) + IndexFileSuffix;
+}
+
+QByteArray FileIndex::getFingerprint(const QString &filePath)
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly))
+    return {};
+
+  const auto fileSize     = file.size();
+  const auto lastModified = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(QByteArray::number(fileSize) + " " + QByteArray::number(lastModified));
+  hash.addData(file.read(FingerprintHashBytes));
+  if (fileSize > FingerprintHashBytes)
+  {
+    file.seek(std::max(fileSize - FingerprintHashBytes, FingerprintHashBytes));
+    hash.addData(file.read(FingerprintHashBytes));
+  }
+  return hash.result();
+}
@@ -0,0 +1,95 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVariantMap>
+
+#include <optional>
+#include <vector>
+
+#include <common/Typedef.h>
+
+/* The index of a compressed file. Opening a compressed file requires a scan of the whole file to
+ * find all frames and the positions where decoding can start. For large files this takes very long.
+ * So the results of the scan are saved in a compact binary index file in the cache directory and
+ * are reused the next time the file is opened.
+ * An index is only used if the fingerprint of the file (size, modification time and a hash of the
+ * first and last bytes) still matches and if it was written for the same type of source (e.g. an
+ * HEVC Annex B parser or ffmpeg).
+ */
+class FileIndex
+{
+public:
+  // All frames in coding order. For Annex B files the timestamp is the POC, for files that are
+  // read using ffmpeg it is the DTS.
+  struct Frame
+  {
+    int64_t                   timestamp{};
+    std::optional<pairUint64> fileStartEndPos;
+    bool                      randomAccessPoint{false};
+  };
+  std::vector<Frame> frames;
+
+  // The frames (in display order) where decoding can start. If decoding has to start with certain
+  // parameter sets, these are given as indices into the list of parameter sets.
+  struct SeekPoint
+  {
+    unsigned                frameIndex{};
+    std::optional<uint64_t> filePos;
+    std::vector<unsigned>   parameterSets;
+  };
+  std::vector<SeekPoint>  seekPoints;
+  std::vector<ByteVector> parameterSets;
+
+  // Add the parameter set to the list (if it is not in the list yet) and return its index
+  unsigned addParameterSet(const ByteVector &parameterSet);
+
+  // Other properties of the file (e.g. the frame size or the frame rate)
+  QVariantMap properties;
+
+  // Load the index of the given file. Returns nothing if there is no (valid) index for the file and
+  // the type or if the file was modified since the index was written.
+  static std::optional<FileIndex> load(const QString &filePath, const QString &type);
+  // Save the index of the given file. Existing indices of the file are replaced.
+  bool save(const QString &filePath, const QString &type) const;
+
+  // The directory where the index files are saved. By default, this is a subdirectory of the
+  // cache directory.
+  static QString getIndexDirectory();
+  static void    setIndexDirectory(const QString &directory);
+
+private:
+  static QString    getIndexFilePath(const QString &filePath);
+  static QByteArray getFingerprint(const QString &filePath);
+};
@@ -0,0 +1,215 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FileReadAhead.h"
+
+#include <QThread>
+
+#include <cstring>
+
+class FileReadAhead::IOThread : public QThread
+{
+public:
+  IOThread(FileReadAhead &readAhead) : readAhead(readAhead) {}
+
+protected:
+  void run() override { this->readAhead.runIOThread(); }
+
+private:
+  FileReadAhead &readAhead;
+};
+
+FileReadAhead::FileReadAhead(const QString &filePath, int nrBuffers)
+{
+  this->buffers.resize(size_t(std::max(nrBuffers, 1)));
+  this->file.setFileName(filePath);
+  if (!this->file.open(QIODevice::ReadOnly))
+    return;
+
+  this->ioThread.reset(new IOThread(*this));
+  this->ioThread->start(QThread::LowPriority);
+}
+
+FileReadAhead::~FileReadAhead()
+{
+  if (!this->ioThread)
+    return;
+  {
+    QMutexLocker locker(&this->mutex);
+    this->quit = true;
+    this->bufferStateChanged.wakeAll();
+  }
+  this->ioThread->wait();
+}
+
+void FileReadAhead::prefetch(int64_t pos, int64_t nrBytes)
+{
+  if (!this->isOk() || pos < 0 || nrBytes <= 0)
+    return;
+
+  QMutexLocker locker(&this->mutex);
+
+  Buffer *target = nullptr;
+  for (auto &buffer : this->buffers)
+  {
+    if (buffer.state != BufferState::Empty && buffer.pos == pos &&
+        buffer.nrBytesRequested >= nrBytes && !buffer.discard)
+    {
+      // Already requested
+      buffer.lastUsed = ++this->useCounter;
+      return;
+    }
+    // The buffer that the I/O thread is reading can not be replaced
+    if (buffer.state == BufferState::Loading)
+      continue;
+    if (target == nullptr || buffer.state == BufferState::Empty ||
+        (target->state != BufferState::Empty && buffer.lastUsed < target->lastUsed))
+      target = &buffer;
+  }
+  if (target == nullptr)
+    return;
+
+  target->pos              = pos;
+  target->nrBytesRequested = nrBytes;
+  target->nrBytesRead      = 0;
+  target->state            = BufferState::Requested;
+  target->discard          = false;
+  target->lastUsed         = ++this->useCounter;
+  target->requestNumber    = this->useCounter;
+  this->bufferStateChanged.wakeAll();
+}
+
+int64_t FileReadAhead::read(char *target, int64_t pos, int64_t nrBytes)
+{
+  if (!this->isOk() || pos < 0 || nrBytes <= 0)
+    return -1;
+
+  QMutexLocker locker(&this->mutex);
+
+  auto contains = [pos, nrBytes](const Buffer &buffer) {
+    return !buffer.discard && buffer.pos >= 0 && pos >= buffer.pos &&
+           pos + nrBytes <= buffer.pos + buffer.nrBytesRequested;
+  };
+
+  for (auto &buffer : this->buffers)
+  {
+    if (buffer.state == BufferState::Requested && contains(buffer))
+    {
+      // The I/O thread did not start reading yet. Reading it directly is faster than waiting.
+      buffer.state = BufferState::Empty;
+      break;
+    }
+    if (buffer.state == BufferState::Loading && contains(buffer))
+    {
+      this->statistics.nrWaits++;
+      while (buffer.state == BufferState::Loading)
+        this->bufferStateChanged.wait(&this->mutex);
+    }
+    if (buffer.state == BufferState::Ready && contains(buffer))
+    {
+      const auto offset      = pos - buffer.pos;
+      const auto nrBytesCopy = std::max(std::min(nrBytes, buffer.nrBytesRead - offset), int64_t(0));
+      if (nrBytesCopy > 0)
+        std::memcpy(target, buffer.data.constData() + offset, size_t(nrBytesCopy));
+      buffer.lastUsed = ++this->useCounter;
+      this->statistics.nrHits++;
+      return nrBytesCopy;
+    }
+  }
+
+  this->statistics.nrMisses++;
+  return -1;
+}
+
+void FileReadAhead::clear()
+{
+  QMutexLocker locker(&this->mutex);
+  for (auto &buffer : this->buffers)
+  {
+    if (buffer.state == BufferState::Loading)
+      buffer.discard = true;
+    else
+    {
+      buffer.state = BufferState::Empty;
+      buffer.pos   = -1;
+    }
+  }
+}
+
+FileReadAhead::Statistics FileReadAhead::getStatistics() const
+{
+  QMutexLocker locker(&this->mutex);
+  return this->statistics;
+}
+
+void FileReadAhead::runIOThread()
+{
+  QMutexLocker locker(&this->mutex);
+  while (!this->quit)
+  {
+    // Read the oldest request first
+    Buffer *next = nullptr;
+    for (auto &buffer : this->buffers)
+      if (buffer.state == BufferState::Requested &&
+          (next == nullptr || buffer.requestNumber < next->requestNumber))
+        next = &buffer;
+    if (next == nullptr)
+    {
+      this->bufferStateChanged.wait(&this->mutex);
+      continue;
+    }
+
+    // Nobody else accesses the data of a buffer while it is loading
+    next->state        = BufferState::Loading;
+    const auto pos     = next->pos;
+    const auto nrBytes = next->nrBytesRequested;
+    locker.unlock();
+
+    if (next->data.size() < nrBytes)
+      next->data.resize(int(nrBytes));
+    int64_t nrBytesRead = 0;
+    if (this->file.seek(pos))
+      nrBytesRead = std::max(this->file.read(next->data.data(), nrBytes), int64_t(0));
+
+    locker.relock();
+    next->nrBytesRead = nrBytesRead;
+    if (next->discard)
+    {
+      next->state   = BufferState::Empty;
+      next->pos     = -1;
+      next->discard = false;
+    }
+    else
+      next->state = BufferState::Ready;
+    this->bufferStateChanged.wakeAll();
+  }
+}
@@ -0,0 +1,113 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+#include <memory>
+#include <vector>
+
+/* Reads parts of a file in a background thread before they are needed. The ranges that are
+ * probably going to be read next (e.g. the next frames or the next part of a bitstream) are
+ * requested using prefetch. An I/O thread with its own file handle reads them into a ring of
+ * buffers. This way, reading from the disk runs in parallel to decoding and conversion.
+ */
+class FileReadAhead
+{
+public:
+  FileReadAhead(const QString &filePath, int nrBuffers = 4);
+  ~FileReadAhead();
+
+  bool isOk() const { return this->file.isOpen(); }
+
+  // Request that the given range is read in the background. If all buffers are used, the least
+  // recently used buffer is replaced.
+  void prefetch(int64_t pos, int64_t nrBytes);
+
+  // If the given range was prefetched, copy it to the target and return the number of bytes that
+  // were copied (less than nrBytes at the end of the file). If the I/O thread is currently reading
+  // the range, wait for it. Return -1 if the range was not prefetched. The caller must then read
+  // from the file itself.
+  int64_t read(char *target, int64_t pos, int64_t nrBytes);
+
+  // Drop all buffers (e.g. because the file changed)
+  void clear();
+
+  struct Statistics
+  {
+    int64_t nrHits{};
+    int64_t nrMisses{};
+    // Hits where the I/O thread was still reading the data
+    int64_t nrWaits{};
+  };
+  Statistics getStatistics() const;
+
+private:
+  class IOThread;
+  void runIOThread();
+
+  enum class BufferState
+  {
+    Empty,
+    Requested,
+    Loading,
+    Ready
+  };
+  struct Buffer
+  {
+    int64_t     pos{-1};
+    int64_t     nrBytesRequested{};
+    int64_t     nrBytesRead{};
+    QByteArray  data;
+    BufferState state{BufferState::Empty};
+    // The I/O thread drops the data after loading (the buffer was cleared while loading)
+    bool     discard{};
+    uint64_t lastUsed{};
+    uint64_t requestNumber{};
+  };
+  std::vector<Buffer> buffers;
+  uint64_t            useCounter{};
+
+  // The file is only accessed by the I/O thread
+  QFile file;
+
+  mutable QMutex            mutex;
+  QWaitCondition            bufferStateChanged;
+  bool                      quit{};
+  Statistics                statistics;
+  std::unique_ptr<IOThread> ioThread;
+};
@@ -42,6 +42,11 @@
 #ifdef Q_OS_WIN
 #include <windows.h>
 #endif
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #define FILESOURCE_DEBUG_SIMULATESLOWLOADING 0
 #if FILESOURCE_DEBUG_SIMULATESLOWLOADING && !NDEBUG
@@ -56,6 +61,15 @@ FileSource::FileSource()
           &FileSource::fileSystemWatcherFileChanged);
 }
 
+FileSource::~FileSource()
+{
+  // Buffers that reference the mapped memory must not be used anymore after this
+  if (this->mappedFile)
+    this->mappedFile->close();
+  for (auto &file : this->retiredMappedFiles)
+    file->close();
+}
+
 bool FileSource::openFile(const QString &filePath)
 {
   // Check if the file exists
@@ -79,9 +93,120 @@ bool FileSource::openFile(const QString &filePath)
   this->updateFileWatchSetting();
   this->fileChanged = false;
 
+  if (this->useMemoryMapping)
+    this->mapFile();
+  if (this->useReadAhead)
+    this->readAhead.reset(new FileReadAhead(filePath));
+
   return true;
 }
 
+void FileSource::enableReadAhead()
+{
+  this->useReadAhead = true;
+  if (this->isFileOpened && !this->readAhead)
+    this->readAhead.reset(new FileReadAhead(this->fullFilePath));
+}
+
+void FileSource::enableMemoryMapping()
+{
+  QSettings settings;
+  this->useMemoryMapping = settings.value("MemoryMapFiles", true).toBool();
+  if (this->useMemoryMapping && this->isFileOpened)
+    this->mapFile();
+}
+
+bool FileSource::isMemoryMapped() const
+{
+  QMutexLocker locker(&this->readMutex);
+  return this->mappedData != nullptr && !this->mappingStale;
+}
+
+void FileSource::mapFile()
+{
+  auto   file = std::make_unique<QFile>(this->fullFilePath);
+  auto   size = int64_t(this->fileInfo.size());
+  uchar *data = nullptr;
+  if (size > 0 && file->open(QIODevice::ReadOnly))
+    data = file->map(0, size);
+
+  QMutexLocker locker(&this->readMutex);
+  if (this->mappedFile)
+    this->retiredMappedFiles.push_back(std::move(this->mappedFile));
+  this->mappedData   = nullptr;
+  this->mappedSize   = 0;
+  this->mappingStale = false;
+  if (data == nullptr)
+    // Mapping failed (e.g. the address space is too small). Read the file normally.
+    return;
+
+  this->mappedFile = std::move(file);
+  this->mappedData = reinterpret_cast<const char *>(data);
+  this->mappedSize = size;
+}
+
+int64_t FileSource::readBytesZeroCopy(QByteArray &targetBuffer, int64_t startPos, int64_t nrBytes)
+{
+  {
+    QMutexLocker locker(&this->readMutex);
+    if (this->mappedData != nullptr && !this->mappingStale && startPos >= 0 && nrBytes >= 0 &&
+        startPos + nrBytes <= this->mappedSize)
+    {
+      targetBuffer = QByteArray::fromRawData(this->mappedData + startPos, int(nrBytes));
+      return nrBytes;
+    }
+  }
+
+  // If the buffer still references the mapped memory, it is detached (copied) before writing.
+  return this->readBytes(targetBuffer, startPos, nrBytes);
+}
+
+void FileSource::adviseReadAhead(int64_t startPos, int64_t nrBytes, bool forward)
+{
+  if (!this->isOk() || startPos < 0 || nrBytes <= 0)
+    return;
+
+#ifdef Q_OS_UNIX
+  QMutexLocker locker(&this->readMutex);
+  if (this->mappedData != nullptr && !this->mappingStale)
+  {
+    const auto pageSize  = int64_t(sysconf(_SC_PAGESIZE));
+    auto       mapAdress = const_cast<char *>(this->mappedData);
+    if (forward != this->lastReadAheadForward)
+    {
+      // When reading forward, the operating system can read ahead of the requested pages. When
+      // reading backwards, this would only read data that was already read.
+      madvise(mapAdress, size_t(this->mappedSize), forward ? MADV_SEQUENTIAL : MADV_RANDOM);
+      this->lastReadAheadForward = forward;
+    }
+
+    const auto endPos = std::min(startPos + nrBytes, this->mappedSize);
+    const auto begin  = (startPos / pageSize) * pageSize;
+    if (endPos > begin)
+      madvise(mapAdress + begin, size_t(endPos - begin), MADV_WILLNEED);
+    return;
+  }
+  locker.unlock();
+#else
+  Q_UNUSED(forward);
+  // The mapped pages are read directly
+  if (this->isMemoryMapped())
+    return;
+#endif
+
+  if (this->readAhead)
+  {
+    this->readAhead->prefetch(startPos, nrBytes);
+    return;
+  }
+
+#if defined(Q_OS_LINUX)
+  const auto handle = this->srcFile.handle();
+  if (handle >= 0)
+    posix_fadvise(handle, off_t(startPos), off_t(nrBytes), POSIX_FADV_WILLNEED);
+#endif
+}
+
 #if SSE_CONVERSION
 // Resize the target array if necessary and read the given number of bytes to the data array
 void FileSource::readBytes(byteArrayAligned &targetBuffer, int64_t startPos, int64_t nrBytes)
@@ -110,6 +235,13 @@ int64_t FileSource::readBytes(QByteArray &targetBuffer, int64_t startPos, int64_
   QThread::msleep(50);
 #endif
 
+  if (this->readAhead)
+  {
+    const auto nrBytesRead = this->readAhead->read(targetBuffer.data(), startPos, nrBytes);
+    if (nrBytesRead >= 0)
+      return nrBytesRead;
+  }
+
   // lock the seek and read function
   QMutexLocker locker(&this->readMutex);
   this->srcFile.seek(startPos);
@@ -42,6 +42,11 @@
 #include <common/EnumMapper.h>
 #include <common/FileInfo.h>
 #include <common/Typedef.h>
+#include <filesource/FileReadAhead.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
 
 enum class InputFormat
 {
@@ -68,6 +73,7 @@ class FileSource : public QObject
 
 public:
   FileSource();
+  ~FileSource();
 
   virtual bool openFile(const QString &filePath);
 
@@ -104,6 +110,24 @@ public:
   void readBytes(byteArrayAligned &data, int64_t startPos, int64_t nrBytes);
 #endif
 
+  // Map the file into memory when it is opened (if this is enabled in the settings). This also
+  // maps the file if it is already open.
+  void enableMemoryMapping();
+  bool isMemoryMapped() const;
+  // Like readBytes but if the file is mapped, no data is copied. The target buffer then references
+  // the mapped memory (see QByteArray::fromRawData). The mapped memory stays valid until the
+  // FileSource is destroyed (also if the file is reopened).
+  int64_t readBytesZeroCopy(QByteArray &targetBuffer, int64_t startPos, int64_t nrBytes);
+  // Tell the operating system that the given bytes are going to be read soon so that it can read
+  // them from disk in the background. forward indicates if the file is read in forward direction
+  // (in which case the operating system may also read ahead on its own). If the read-ahead thread
+  // is enabled and the file is not mapped, the bytes are read by the read-ahead thread.
+  void adviseReadAhead(int64_t startPos, int64_t nrBytes, bool forward);
+
+  // Create a read-ahead thread (see FileReadAhead) when the file is opened. readBytes takes the
+  // data from it if it was prefetched using adviseReadAhead.
+  void enableReadAhead();
+
   static QString getAbsPathFromAbsAndRel(const QString &currentPath,
                                          const QString &absolutePath,
                                          const QString &relativePath);
@@ -112,7 +136,15 @@ public:
   void clearFileCache();
 
 private slots:
-  void fileSystemWatcherFileChanged(const QString &) { fileChanged = true; }
+  void fileSystemWatcherFileChanged(const QString &)
+  {
+    fileChanged = true;
+    // Accessing the mapped memory may fail if the file was truncated. Read the file until it is
+    // reopened.
+    mappingStale = true;
+    if (readAhead)
+      readAhead->clear();
+  }
 
 protected:
   QString   fullFilePath{};
@@ -120,9 +152,24 @@ protected:
   QFile     srcFile;
   bool      isFileOpened{};
 
+  bool                           useReadAhead{};
+  std::unique_ptr<FileReadAhead> readAhead;
+
 private:
   QFileSystemWatcher fileWatcher{};
   bool               fileChanged{};
 
-  QMutex readMutex;
+  mutable QMutex readMutex;
+
+  // The file is mapped using a separate QFile because closing a QFile unmaps all of its
+  // mappings. When the file is reopened, the old mapping is kept because there may still be
+  // buffers that reference it.
+  void                                mapFile();
+  bool                                useMemoryMapping{};
+  std::unique_ptr<QFile>              mappedFile;
+  std::vector<std::unique_ptr<QFile>> retiredMappedFiles;
+  const char *                        mappedData{};
+  int64_t                             mappedSize{};
+  std::atomic_bool                    mappingStale{false};
+  bool                                lastReadAheadForward{true};
 };
@@ -32,6 +32,10 @@
 
 #include "FileSourceAnnexBFile.h"
 
+#include <common/StartCodeSearch.h>
+
+#include <algorithm>
+
 #define ANNEXBFILE_DEBUG_OUTPUT 0
 #if ANNEXBFILE_DEBUG_OUTPUT && !NDEBUG
 #include <QDebug>
@@ -41,11 +45,14 @@
 #endif
 
 const auto BUFFERSIZE = 500000;
-const auto STARTCODE = QByteArrayLiteral("\x00\x00\x01");
+// How many buffers after the current one are read in the background
+const auto NR_READ_AHEAD_BUFFERS = 2;
 
 FileSourceAnnexBFile::FileSourceAnnexBFile()
 {
   this->fileBuffer.resize(BUFFERSIZE);
+  // The next buffers are read in the background while the current one is parsed
+  this->enableReadAhead();
 }
 
 // Open the file and fill the read buffer. 
@@ -57,7 +64,9 @@ bool FileSourceAnnexBFile::openFile(const QString &fileName)
   FileSource::openFile(fileName);
 
   // Fill the buffer
-  this->fileBufferSize = srcFile.read(this->fileBuffer.data(), BUFFERSIZE);
+  this->bufferStartPosInFile = 0;
+  this->posInBuffer          = 0;
+  this->fileBufferSize       = this->readBuffer(0);
   if (this->fileBufferSize == 0)
     // The file is empty of there was an error reading from the file.
     return false;
@@ -74,14 +83,15 @@ bool FileSourceAnnexBFile::atEnd() const
 
 void FileSourceAnnexBFile::seekToFirstNAL()
 {
-  auto nextStartCodePos = this->fileBuffer.indexOf(STARTCODE);
+  auto nextStartCodePos =
+      functions::findStartCode(this->fileBuffer.constData(), int64_t(this->fileBufferSize));
   if (nextStartCodePos < 0)
     // The first buffer does not contain a start code. This is very unusual. Use the normal getNextNALUnit to seek
-    this->getNextNALUnit();
+    this->getNextNALUnitView();
   else
   {
     // For 0001 or 001 point to the first 0 byte
-    if (nextStartCodePos > 0 && this->fileBuffer.at(nextStartCodePos-1) ==(char)0)
+    if (nextStartCodePos > 0 && this->fileBuffer.at(int(nextStartCodePos - 1)) == (char)0)
       this->posInBuffer = nextStartCodePos - 1;
     else
       this->posInBuffer = nextStartCodePos;
@@ -96,93 +106,131 @@ QByteArray FileSourceAnnexBFile::getNextNALUnit(bool getLastDataAgain, pairUint6
   if (getLastDataAgain)
     return this->lastReturnArray;
 
-  this->lastReturnArray.clear();
-
+  const auto nalUnit = this->getNextNALUnitView();
+  this->lastReturnArray = QByteArray(nalUnit.data, int(nalUnit.size));
   if (startEndPosInFile)
-    startEndPosInFile->first = this->bufferStartPosInFile + uint64_t(this->posInBuffer);
+    *startEndPosInFile = nalUnit.startEndPosInFile;
+  return this->lastReturnArray;
+}
 
-  int nextStartCodePos = -1;
-  int searchOffset = 3;
-  bool startCodeFound = false;
-  while (!startCodeFound)
+FileSourceAnnexBFile::NALUnitView FileSourceAnnexBFile::getNextNALUnitView()
+{
+  NALUnitView nalUnit;
+  nalUnit.startEndPosInFile.first = this->bufferStartPosInFile + uint64_t(this->posInBuffer);
+  if (this->atEnd())
+    return nalUnit;
+
+  // Most NAL units lie completely within the buffer. These are returned without copying. Only if
+  // we have to load the next buffer, the NAL unit is assembled in the nalUnitBuffer.
+  this->nalUnitBuffer.clear();
+  bool spansBuffers = false;
+  if (this->posInBuffer < 0)
   {
-    if (this->posInBuffer < 0)
+    // Part of the start code was in the last buffer (see special boundary cases below). Add those
+    // parts.
+    this->nalUnitBuffer.insert(this->nalUnitBuffer.end(), size_t(-this->posInBuffer), char(0));
+    spansBuffers = true;
+  }
+
+  int64_t nextStartCodePos = -1;
+  int64_t searchOffset = 3;
+  bool endOfFile = false;
+  while (true)
+  {
+    const auto bufferSize       = int64_t(this->fileBufferSize);
+    const auto nalStartInBuffer = std::max(this->posInBuffer, int64_t(0));
+    const auto searchStart      = std::max(this->posInBuffer + searchOffset, int64_t(0));
+    nextStartCodePos =
+        functions::findStartCode(this->fileBuffer.constData(), bufferSize, searchStart);
+
+    if (nextStartCodePos >= 0)
     {
-      // Part of the start code was in the last buffer (see special boundary cases below). Add those parts.
-      const auto nrZeroBytesMissing = std::abs(this->posInBuffer);
-      this->lastReturnArray.append(nrZeroBytesMissing, char(0));
+      // Start code found. Check if the start code is 001 or 0001
+      if (nextStartCodePos > 0 && this->fileBuffer.at(int(nextStartCodePos - 1)) == (char)0)
+        nextStartCodePos--;
+      break;
     }
-    nextStartCodePos = this->fileBuffer.indexOf(STARTCODE, this->posInBuffer + searchOffset);
 
-    if (nextStartCodePos < 0 || (uint64_t)nextStartCodePos > this->fileBufferSize)
+    if (this->fileBufferSize < BUFFERSIZE)
     {
-      // No start code found ... append all data in the current buffer.
-      this->lastReturnArray += this->fileBuffer.mid(this->posInBuffer, this->fileBufferSize - this->posInBuffer);
-      DEBUG_ANNEXBFILE("FileSourceHEVCAnnexBFile::getNextNALUnit no start code found - ret size " << this->lastReturnArray.size());
+      // We are out of file and could not find a next position
+      nextStartCodePos = bufferSize;
+      endOfFile = true;
+      break;
+    }
 
-      if (this->fileBufferSize < BUFFERSIZE)
-      {
-        // We are out of file and could not find a next position
-        this->posInBuffer = BUFFERSIZE;
-        if (startEndPosInFile)
-          startEndPosInFile->second = this->bufferStartPosInFile + this->fileBufferSize - 1;
-        return this->lastReturnArray;
-      }
+    // No start code found ... keep all data in the current buffer.
+    this->nalUnitBuffer.insert(this->nalUnitBuffer.end(),
+                               this->fileBuffer.constData() + nalStartInBuffer,
+                               this->fileBuffer.constData() + bufferSize);
+    spansBuffers = true;
+    DEBUG_ANNEXBFILE("FileSourceAnnexBFile::getNextNALUnitView no start code found - size "
+                     << this->nalUnitBuffer.size());
 
-      // Before we load the next bytes: The start code might be located at the boundary to the next buffer
-      const auto lastByteZero0 = this->fileBuffer.at(this->fileBufferSize - 3) == (char)0;
-      const auto lastByteZero1 = this->fileBuffer.at(this->fileBufferSize - 2) == (char)0;
-      const auto lastByteZero2 = this->fileBuffer.at(this->fileBufferSize - 1) == (char)0;
+    // Before we load the next bytes: The start code might be located at the boundary to the next buffer
+    const auto lastByteZero0 = this->fileBuffer.at(this->fileBufferSize - 3) == (char)0;
+    const auto lastByteZero1 = this->fileBuffer.at(this->fileBufferSize - 2) == (char)0;
+    const auto lastByteZero2 = this->fileBuffer.at(this->fileBufferSize - 1) == (char)0;
 
-      // We have to continue searching - get the next buffer
-      updateBuffer();
-      
-      if (this->fileBufferSize > 2)
-      {
-        // Now look for the special boundary case:
-        if (this->fileBuffer.at(0) == (char)1 && lastByteZero2 && lastByteZero1)
-        {
-          // Found a start code - the 1 byte is here and the two (or three) 0 bytes were in the last buffer
-          startCodeFound = true;
-          nextStartCodePos = lastByteZero0 ? -3 : -2;
-          this->lastReturnArray.chop(lastByteZero0 ? 3 : 2);
-        }
-        else if (this->fileBuffer.at(0) == (char)0 && this->fileBuffer.at(1) == (char)1 && lastByteZero2)
-        {
-          // Found a start code - the 01 bytes are here and the one (or two) 0 bytes were in the last buffer
-          startCodeFound = true;
-          nextStartCodePos = lastByteZero1 ? -2 : -1;
-          this->lastReturnArray.chop(lastByteZero0 ? 1 : 1);
-        }
-        else if (this->fileBuffer.at(0) == (char)0 && this->fileBuffer.at(1) == (char)0 && this->fileBuffer.at(2) == (char)1)
-        {
-          // Found a start code - the 001 bytes are here. Check the last byte of the last buffer
-          startCodeFound = true;
-          nextStartCodePos = lastByteZero2 ? -1 : 0;
-          if (lastByteZero2)
-            this->lastReturnArray.chop(1);
-        }
-      }
+    // We have to continue searching - get the next buffer
+    updateBuffer();
 
-      searchOffset = 0;
-    }
-    else
+    if (this->fileBufferSize > 2)
     {
-      // Start code found. Check if the start code is 001 or 0001
-      startCodeFound = true;
-      if (this->fileBuffer.at(nextStartCodePos - 1) == (char)0)
-        nextStartCodePos--;
+      // Now look for the special boundary case. The zero bytes in the last buffer are not part of
+      // this NAL unit.
+      int64_t nrZeroBytesInLastBuffer = -1;
+      if (this->fileBuffer.at(0) == (char)1 && lastByteZero2 && lastByteZero1)
+        // Found a start code - the 1 byte is here and the two (or three) 0 bytes were in the last buffer
+        nrZeroBytesInLastBuffer = lastByteZero0 ? 3 : 2;
+      else if (this->fileBuffer.at(0) == (char)0 && this->fileBuffer.at(1) == (char)1 && lastByteZero2)
+        // Found a start code - the 01 bytes are here and the one (or two) 0 bytes were in the last buffer
+        nrZeroBytesInLastBuffer = lastByteZero1 ? 2 : 1;
+      else if (this->fileBuffer.at(0) == (char)0 && this->fileBuffer.at(1) == (char)0 && this->fileBuffer.at(2) == (char)1)
+        // Found a start code - the 001 bytes are here. Check the last byte of the last buffer
+        nrZeroBytesInLastBuffer = lastByteZero2 ? 1 : 0;
+
+      if (nrZeroBytesInLastBuffer >= 0)
+      {
+        this->nalUnitBuffer.resize(this->nalUnitBuffer.size() - size_t(nrZeroBytesInLastBuffer));
+        nextStartCodePos = -nrZeroBytesInLastBuffer;
+        break;
+      }
     }
+
+    searchOffset = 0;
   }
 
   // Position found
-  if (startEndPosInFile)
-    startEndPosInFile->second = this->bufferStartPosInFile + nextStartCodePos;
-  if (nextStartCodePos > int(this->posInBuffer))
-    this->lastReturnArray += this->fileBuffer.mid(this->posInBuffer, nextStartCodePos - this->posInBuffer);
-  this->posInBuffer = nextStartCodePos;
-  DEBUG_ANNEXBFILE("FileSourceAnnexBFile::getNextNALUnit start code found - ret size " << this->lastReturnArray.size());
-  return this->lastReturnArray;
+  const auto nalStartInBuffer = std::max(this->posInBuffer, int64_t(0));
+  if (spansBuffers)
+  {
+    if (nextStartCodePos > nalStartInBuffer)
+      this->nalUnitBuffer.insert(this->nalUnitBuffer.end(),
+                                 this->fileBuffer.constData() + nalStartInBuffer,
+                                 this->fileBuffer.constData() + nextStartCodePos);
+    nalUnit.data = this->nalUnitBuffer.data();
+    nalUnit.size = int64_t(this->nalUnitBuffer.size());
+  }
+  else
+  {
+    nalUnit.data = this->fileBuffer.constData() + this->posInBuffer;
+    nalUnit.size = nextStartCodePos - this->posInBuffer;
+  }
+
+  if (endOfFile)
+  {
+    nalUnit.startEndPosInFile.second = this->bufferStartPosInFile + this->fileBufferSize - 1;
+    this->posInBuffer = BUFFERSIZE;
+  }
+  else
+  {
+    nalUnit.startEndPosInFile.second = this->bufferStartPosInFile + nextStartCodePos;
+    this->posInBuffer = nextStartCodePos;
+  }
+  DEBUG_ANNEXBFILE("FileSourceAnnexBFile::getNextNALUnitView start code found - size "
+                   << nalUnit.size);
+  return nalUnit;
 }
 
 QByteArray FileSourceAnnexBFile::getFrameData(pairUint64 startEndFilePos)
@@ -201,22 +249,24 @@ QByteArray FileSourceAnnexBFile::getFrameData(pairUint64 startEndFilePos)
   // Retrieve NAL units (and repackage them) until we reached out end position
   while (end > this->bufferStartPosInFile + this->posInBuffer)
   {
-    auto nalData = getNextNALUnit();
+    const auto nalUnit = this->getNextNALUnitView();
+    if (nalUnit.size == 0)
+      break;
 
     int headerOffset = 0;
-    if (nalData.at(0) == (char)0 && nalData.at(1) == (char)0)
+    if (nalUnit.size > 3 && nalUnit.data[0] == (char)0 && nalUnit.data[1] == (char)0)
     {
-      if (nalData.at(2) == (char)0 && nalData.at(3) == (char)1)
+      if (nalUnit.data[2] == (char)0 && nalUnit.data[3] == (char)1)
         headerOffset = 4;
-      else if (nalData.at(2) == (char)1)
+      else if (nalUnit.data[2] == (char)1)
         headerOffset = 3;
     }
     assert(headerOffset > 0);
     if (headerOffset == 3)
       retArray.append((char)0);
 
-    DEBUG_ANNEXBFILE("FileSourceAnnexBFile::getFrameData Load NAL - size " << nalData.length());
-    retArray += nalData;
+    DEBUG_ANNEXBFILE("FileSourceAnnexBFile::getFrameData Load NAL - size " << nalUnit.size);
+    retArray.append(nalUnit.data, int(nalUnit.size));
   }
 
   return retArray;
@@ -227,36 +277,65 @@ bool FileSourceAnnexBFile::updateBuffer()
   // Save the position of the first byte in this new buffer
   this->bufferStartPosInFile += this->fileBufferSize;
 
-  this->fileBufferSize = srcFile.read(this->fileBuffer.data(), BUFFERSIZE);
+  this->fileBufferSize = this->readBuffer(this->bufferStartPosInFile);
   this->posInBuffer = 0;
 
   DEBUG_ANNEXBFILE("FileSourceAnnexBFile::updateBuffer this->fileBufferSize " << this->fileBufferSize);
   return (this->fileBufferSize > 0);
 }
 
+uint64_t FileSourceAnnexBFile::readBuffer(int64_t pos)
+{
+  int64_t nrBytesRead = -1;
+  if (this->readAhead)
+    nrBytesRead = this->readAhead->read(this->fileBuffer.data(), pos, BUFFERSIZE);
+  if (nrBytesRead < 0)
+  {
+    this->srcFile.seek(pos);
+    nrBytesRead = std::max(this->srcFile.read(this->fileBuffer.data(), BUFFERSIZE), int64_t(0));
+  }
+
+  // The file is usually read linearly. Read the next buffers in the background.
+  if (this->readAhead && nrBytesRead == BUFFERSIZE)
+    for (int i = 1; i <= NR_READ_AHEAD_BUFFERS; i++)
+      this->readAhead->prefetch(pos + i * BUFFERSIZE, BUFFERSIZE);
+
+  return uint64_t(nrBytesRead);
+}
+
 bool FileSourceAnnexBFile::seek(int64_t pos)
 {
   if (!isFileOpened)
     return false;
 
   DEBUG_ANNEXBFILE("FileSourceAnnexBFile::seek ot " << pos);
-  // Seek the file and update the buffer
-  srcFile.seek(pos);
-  this->fileBufferSize = srcFile.read(this->fileBuffer.data(), BUFFERSIZE);
-  if (this->fileBufferSize == 0)
-    // The file is empty of there was an error reading from the file.
-    return false;
-  this->bufferStartPosInFile = pos;
-  this->posInBuffer = 0;
+
+  // Frames are usually read one after the other (getFrameData). If the position is still in the
+  // current buffer, there is no need to read the file again.
+  const auto bufferStart = int64_t(this->bufferStartPosInFile);
+  const auto bufferEnd   = bufferStart + int64_t(this->fileBufferSize);
+  if (pos > 0 && pos >= bufferStart && pos + 4 <= bufferEnd)
+    this->posInBuffer = pos - bufferStart;
+  else
+  {
+    // Seek the file and update the buffer
+    this->fileBufferSize = this->readBuffer(pos);
+    if (this->fileBufferSize == 0)
+      // The file is empty of there was an error reading from the file.
+      return false;
+    this->bufferStartPosInFile = pos;
+    this->posInBuffer = 0;
+  }
 
   if (pos == 0)
     this->seekToFirstNAL();
   else
   {
     // Check if we are at a start code position (001 or 0001)
-    if (this->fileBuffer.at(0) == (char)0 && this->fileBuffer.at(1) == (char)0 && this->fileBuffer.at(2) == (char)0 && this->fileBuffer.at(3) == (char)1)
+    const auto p = this->posInBuffer;
+    if (this->fileBuffer.at(p) == (char)0 && this->fileBuffer.at(p + 1) == (char)0 && this->fileBuffer.at(p + 2) == (char)0 && this->fileBuffer.at(p + 3) == (char)1)
       return true;
-    if (this->fileBuffer.at(0) == (char)0 && this->fileBuffer.at(1) == (char)0 && this->fileBuffer.at(2) == (char)1)
+    if (this->fileBuffer.at(p) == (char)0 && this->fileBuffer.at(p + 1) == (char)0 && this->fileBuffer.at(p + 2) == (char)1)
       return true;
 
     DEBUG_ANNEXBFILE("FileSourceAnnexBFile::seek could not find start code at seek position");
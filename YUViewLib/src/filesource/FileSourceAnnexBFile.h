@@ -35,11 +35,13 @@
 #include <common/Typedef.h>
 #include <filesource/FileSource.h>
 
+#include <vector>
+
 /* This class is a normal FileSource for opening of raw AnnexBFiles.
  * Basically it understands that this is a binary file where each unit starts with a start code
  * (0x0000001)
- * TODO: The reading / parsing could be performed in a background thread in order to increase the
- * performance
+ * The next parts of the file are read in a background thread (see FileReadAhead) while the current
+ * part is parsed.
  */
 class FileSourceAnnexBFile : public FileSource
 {
@@ -66,6 +68,18 @@ public:
   // of the last byte
   QByteArray getNextNALUnit(bool getLastDataAgain = false, pairUint64 *startEndPosInFile = nullptr);
 
+  // A NAL unit (including the start code) that is not copied out of the file buffer. The data is
+  // only valid until the next NAL unit is requested or the file is seeked.
+  struct NALUnitView
+  {
+    const char *data{nullptr};
+    int64_t     size{0};
+    pairUint64  startEndPosInFile;
+  };
+  // Same as getNextNALUnit but without copying the data. Only NAL units that span two buffers have
+  // to be assembled in a separate buffer. The view is empty if the end of the file was reached.
+  NALUnitView getNextNALUnitView();
+
   // Get all bytes that are needed to decode the next frame (from the given start to the given end
   // position) The data will be returned in the ISO/IEC 14496-15 format (4 bytes size followed by
   // the payload).
@@ -90,12 +104,17 @@ protected:
 
   // load the next buffer
   bool updateBuffer();
+  // Read the buffer at the given position in the file (from the read-ahead buffers if possible).
+  // Return the number of bytes read.
+  uint64_t readBuffer(int64_t pos);
 
   // Seek to the first NAL header in the bitstream
   void seekToFirstNAL();
 
   // We will keep the last buffer in case the reader wants to get it again
   QByteArray lastReturnArray;
+  // NAL units that span two buffers are assembled in here
+  std::vector<char> nalUnitBuffer;
 
   uint64_t nrBytesBeforeFirstNAL{0};
 };
@@ -35,6 +35,7 @@
 #include <QProgressDialog>
 #include <QSettings>
 
+#include "filesource/FileIndex.h"
 #include "parser/AV1/obu_header.h"
 #include "parser/common/SubByteReaderLogging.h"
 
@@ -53,6 +54,9 @@ namespace
 
 auto startCode = QByteArrayLiteral("\x00\x00\x01");
 
+// The type of the file index (see FileIndex) that is saved after scanning a file
+const auto IndexType = QString("FFmpeg");
+
 }
 
 FileSourceFFmpegFile::FileSourceFFmpegFile()
@@ -362,7 +366,16 @@ bool FileSourceFFmpegFile::openFile(const QString &       filePath,
   }
   else if (parseFile)
   {
-    if (!this->scanBitstream(mainWindow))
+    // Scanning a large file takes long. If the file was scanned before, the results are loaded
+    // from the file index.
+    if (auto fileIndex = FileIndex::load(filePath, IndexType))
+    {
+      this->nrFrames = fileIndex->frames.size();
+      for (size_t i = 0; i < fileIndex->frames.size(); i++)
+        if (fileIndex->frames[i].randomAccessPoint)
+          this->keyFrameList.append(pictureIdx(i, fileIndex->frames[i].timestamp));
+    }
+    else if (!this->scanBitstream(mainWindow))
       return false;
 
     this->seekFileToBeginning();
@@ -405,6 +418,14 @@ std::pair<int64_t, size_t> FileSourceFFmpegFile::getClosestSeekableFrameBefore(i
   return {bestSeekDTS, seekToFrameIdx};
 }
 
+std::vector<int> FileSourceFFmpegFile::getKeyFrameIndices() const
+{
+  std::vector<int> keyFrames;
+  for (const auto &pic : this->keyFrameList)
+    keyFrames.push_back(int(pic.frame));
+  return keyFrames;
+}
+
 bool FileSourceFFmpegFile::scanBitstream(QWidget *mainWindow)
 {
   if (!this->isFileOpened)
@@ -425,6 +446,9 @@ bool FileSourceFFmpegFile::scanBitstream(QWidget *mainWindow)
     progress->setWindowModality(Qt::WindowModal);
   }
 
+  // The DTS and the key frame flag of every frame are saved in the file index
+  FileIndex fileIndex;
+
   this->nrFrames = 0;
   while (this->goToNextPacket(true))
   {
@@ -437,6 +461,11 @@ bool FileSourceFFmpegFile::scanBitstream(QWidget *mainWindow)
     if (this->currentPacket.getFlagKeyframe())
       this->keyFrameList.append(pictureIdx(this->nrFrames, this->currentPacket.getDTS()));
 
+    FileIndex::Frame indexFrame;
+    indexFrame.timestamp         = this->currentPacket.getDTS();
+    indexFrame.randomAccessPoint = this->currentPacket.getFlagKeyframe();
+    fileIndex.frames.push_back(indexFrame);
+
     if (progress && progress->wasCanceled())
       return false;
 
@@ -456,7 +485,9 @@ bool FileSourceFFmpegFile::scanBitstream(QWidget *mainWindow)
   DEBUG_FFMPEG("FileSourceFFmpegFile::scanBitstream: Scan done. Found %d frames and %d keyframes.",
                this->nrFrames,
                this->keyFrameList.length());
-  return !progress->wasCanceled();
+
+  fileIndex.save(this->fullFilePath, IndexType);
+  return true;
 }
 
 void FileSourceFFmpegFile::openFileAndFindVideoStream(QString fileName)
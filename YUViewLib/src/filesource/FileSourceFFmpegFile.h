@@ -117,6 +117,8 @@ public:
   // the given frameIdx where we can start decoding
   // Return: POC and frame index
   std::pair<int64_t, size_t> getClosestSeekableFrameBefore(int frameIdx) const;
+  // Get the frame indices of all key frames in ascending order
+  std::vector<int> getKeyFrameIndices() const;
 
   QStringList getFFmpegLoadingLog() const { return ff.getLog(); }
 
@@ -49,6 +49,12 @@
 namespace parser
 {
 
+size_t AnnexB::getNumberPOCs() const
+{
+  QMutexLocker locker(&this->frameListMutex);
+  return this->frameListCodingOrder.size();
+}
+
 QString AnnexB::getShortStreamDescription(int) const
 {
   QString info      = "Video";
@@ -62,9 +68,9 @@ bool AnnexB::addFrameToList(int                       poc,
                             std::optional<pairUint64> fileStartEndPos,
                             bool                      randomAccessPoint)
 {
-  for (const auto &f : this->frameListCodingOrder)
-    if (f.poc == poc)
-      return false;
+  QMutexLocker locker(&this->frameListMutex);
+  if (this->framePOCs.count(poc) > 0)
+    return false;
 
   if (pocOfFirstRandomAccessFrame == -1 && randomAccessPoint)
     pocOfFirstRandomAccessFrame = poc;
@@ -77,6 +83,7 @@ bool AnnexB::addFrameToList(int                       poc,
     newFrame.randomAccessPoint = randomAccessPoint;
     this->frameListCodingOrder.push_back(newFrame);
     this->frameListDisplayOder.clear();
+    this->framePOCs.insert(poc);
   }
   return true;
 }
@@ -102,6 +109,7 @@ void AnnexB::logNALSize(const ByteVector &        data,
 auto AnnexB::getClosestSeekPoint(FrameIndexDisplayOrder targetFrame,
                                  FrameIndexDisplayOrder currentFrame) -> SeekPointInfo
 {
+  QMutexLocker locker(&this->frameListMutex);
   if (targetFrame >= this->frameListCodingOrder.size())
     return {};
 
@@ -138,15 +146,30 @@ auto AnnexB::getClosestSeekPoint(FrameIndexDisplayOrder targetFrame,
   return seekPointInfo;
 }
 
+auto AnnexB::getRandomAccessPoints() -> vector<FrameIndexDisplayOrder>
+{
+  QMutexLocker locker(&this->frameListMutex);
+  this->updateFrameListDisplayOrder();
+
+  vector<FrameIndexDisplayOrder> randomAccessPoints;
+  for (size_t i = 0; i < this->frameListDisplayOder.size(); i++)
+    if (this->frameListDisplayOder[i].randomAccessPoint)
+      randomAccessPoints.push_back(FrameIndexDisplayOrder(i));
+  return randomAccessPoints;
+}
+
 std::optional<pairUint64> AnnexB::getFrameStartEndPos(FrameIndexCodingOrder idx)
 {
+  QMutexLocker locker(&this->frameListMutex);
   if (idx >= this->frameListCodingOrder.size())
     return {};
   this->updateFrameListDisplayOrder();
   return this->frameListCodingOrder[idx].fileStartEndPos;
 }
 
-bool AnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, QWidget *mainWindow)
+bool AnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file,
+                             QWidget *                             mainWindow,
+                             FramesParsedCallback                  framesParsed)
 {
   DEBUG_ANNEXB("AnnexB::parseAnnexBFile");
 
@@ -177,6 +200,11 @@ bool AnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, QWidget
   bool          abortParsing = false;
   QElapsedTimer signalEmitTimer;
   signalEmitTimer.start();
+  size_t        nrFramesSeen          = 0;
+  size_t        nrFinalFrames         = 0;
+  size_t        nrFinalFramesReported = 0;
+  QElapsedTimer framesParsedTimer;
+  framesParsedTimer.start();
   while (!file->atEnd() && !abortParsing)
   {
     // Update the progress dialog
@@ -186,8 +214,11 @@ bool AnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, QWidget
 
     try
     {
-      auto nalData = reader::SubByteReaderLogging::convertToByteVector(
-          file->getNextNALUnit(false, &nalStartEndPosFile));
+      // The NAL unit is not copied out of the file buffer. It is only copied once into the byte
+      // vector for the parser.
+      const auto nalUnit = file->getNextNALUnitView();
+      nalStartEndPosFile = nalUnit.startEndPosInFile;
+      ByteVector nalData(nalUnit.data, nalUnit.data + nalUnit.size);
       auto parsingResult =
           this->parseAndAddNALUnit(nalID, nalData, {}, nalStartEndPosFile, nullptr);
       if (!parsingResult.success)
@@ -213,6 +244,26 @@ bool AnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, QWidget
 
     nalID++;
 
+    if (framesParsed)
+    {
+      // A frame is added to the list when the next frame starts. If the new frame is a random
+      // access point, all frames before it are final.
+      const auto nrFrames = this->frameListCodingOrder.size();
+      if (nrFrames > nrFramesSeen && this->frameListCodingOrder.back().randomAccessPoint)
+        nrFinalFrames = nrFrames - 1;
+      nrFramesSeen = nrFrames;
+
+      // Report the first frames as soon as possible. After that, don't report too often.
+      if (nrFinalFrames > nrFinalFramesReported &&
+          (nrFinalFramesReported == 0 || framesParsedTimer.elapsed() > 500))
+      {
+        stream_info.nr_nal_units = nalID;
+        framesParsed(nrFinalFrames);
+        nrFinalFramesReported = nrFinalFrames;
+        framesParsedTimer.start();
+      }
+    }
+
     if (progressDialog)
     {
       // Updating the dialog (setValue) is quite slow. Only do this if the percent value changes.
@@ -263,6 +314,9 @@ bool AnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, QWidget
   emit streamInfoUpdated();
   emit backgroundParsingDone("");
 
+  if (framesParsed && !cancelBackgroundParser)
+    framesParsed(this->frameListCodingOrder.size());
+
   return !cancelBackgroundParser;
 }
 
@@ -273,6 +327,83 @@ bool AnnexB::runParsingOfFile(QString compressedFilePath)
   return parseAnnexBFile(file);
 }
 
+FileIndex AnnexB::createFileIndex()
+{
+  FileIndex index;
+  this->updateFileIndex(index, this->getNumberPOCs());
+  return index;
+}
+
+void AnnexB::updateFileIndex(FileIndex &index, size_t nrFrames)
+{
+  vector<FrameIndexDisplayOrder> seekFrames;
+  {
+    QMutexLocker locker(&this->frameListMutex);
+    nrFrames = std::min(nrFrames, this->frameListCodingOrder.size());
+    for (auto i = index.frames.size(); i < nrFrames; i++)
+    {
+      const auto &     frame = this->frameListCodingOrder[i];
+      FileIndex::Frame indexFrame;
+      indexFrame.timestamp         = frame.poc;
+      indexFrame.fileStartEndPos   = frame.fileStartEndPos;
+      indexFrame.randomAccessPoint = frame.randomAccessPoint;
+      index.frames.push_back(indexFrame);
+    }
+
+    // Decoding can start at all random access points. If there is no random access point before
+    // the target frame, getClosestSeekPoint returns the first frame in coding order. The final
+    // frames have the lowest POCs so they are also the first nrFrames frames in display order.
+    this->updateFrameListDisplayOrder();
+    for (size_t i = 0; i < nrFrames; i++)
+      if (this->frameListDisplayOder[i].randomAccessPoint)
+        seekFrames.push_back(FrameIndexDisplayOrder(i));
+    if (nrFrames > 0)
+    {
+      const auto firstFrame = this->frameListCodingOrder.front();
+      const auto it         = std::find(
+          this->frameListDisplayOder.begin(), this->frameListDisplayOder.end(), firstFrame);
+      const auto firstFrameIndex =
+          FrameIndexDisplayOrder(std::distance(this->frameListDisplayOder.begin(), it));
+      if (std::find(seekFrames.begin(), seekFrames.end(), firstFrameIndex) == seekFrames.end())
+      {
+        seekFrames.push_back(firstFrameIndex);
+        std::sort(seekFrames.begin(), seekFrames.end());
+      }
+    }
+  }
+
+  for (auto frameIndex : seekFrames)
+  {
+    // Seek points that are already in the index were added with the frames before
+    if (!index.seekPoints.empty() && frameIndex <= index.seekPoints.back().frameIndex)
+      continue;
+    auto seekData = this->getSeekData(int(frameIndex));
+    if (!seekData)
+      continue;
+    FileIndex::SeekPoint seekPoint;
+    seekPoint.frameIndex = frameIndex;
+    seekPoint.filePos    = seekData->filePos;
+    for (const auto &parameterSet : seekData->parameterSets)
+      seekPoint.parameterSets.push_back(index.addParameterSet(parameterSet));
+    index.seekPoints.push_back(seekPoint);
+  }
+
+  const auto frameSize    = this->getSequenceSizeSamples();
+  const auto profileLevel = this->getProfileLevel();
+  const auto aspectRatio  = this->getSampleAspectRatio();
+  const auto pixelFormat  = QString::fromStdString(this->getPixelFormat().getName());
+  index.properties[IndexProperty::FrameRate]   = this->getFramerate();
+  index.properties[IndexProperty::Width]       = frameSize.width;
+  index.properties[IndexProperty::Height]      = frameSize.height;
+  index.properties[IndexProperty::PixelFormat] = pixelFormat;
+  index.properties[IndexProperty::Extradata]   = this->getExtradata();
+  index.properties[IndexProperty::Profile]     = profileLevel.first;
+  index.properties[IndexProperty::Level]       = profileLevel.second;
+  index.properties[IndexProperty::AspectNum]   = aspectRatio.num;
+  index.properties[IndexProperty::AspectDen]   = aspectRatio.den;
+  index.properties[IndexProperty::NrNALUnits]  = this->stream_info.nr_nal_units;
+}
+
 QList<QTreeWidgetItem *> AnnexB::stream_info_type::getStreamInfo()
 {
   QList<QTreeWidgetItem *> infoList;
@@ -297,6 +428,7 @@ QList<QTreeWidgetItem *> AnnexB::stream_info_type::getStreamInfo()
 
 int AnnexB::getFramePOC(FrameIndexDisplayOrder frameIdx)
 {
+  QMutexLocker locker(&this->frameListMutex);
   this->updateFrameListDisplayOrder();
   return this->frameListDisplayOder[frameIdx].poc;
 }
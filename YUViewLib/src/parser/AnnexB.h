@@ -33,13 +33,16 @@
 #pragma once
 
 #include <QList>
+#include <QMutex>
 #include <QTreeWidgetItem>
 
+#include <functional>
 #include <optional>
 #include <set>
 
 #include "common/BitratePlotModel.h"
 #include "common/TreeItem.h"
+#include "filesource/FileIndex.h"
 #include "filesource/FileSourceAnnexBFile.h"
 #include "parser/Base.h"
 #include "video/videoHandlerYUV.h"
@@ -62,7 +65,7 @@ public:
   virtual ~AnnexB(){};
 
   // How many POC's have been found in the file
-  size_t getNumberPOCs() const { return this->frameListCodingOrder.size(); }
+  size_t getNumberPOCs() const;
 
   // Clear all knowledge about the bitstream.
   void clearData();
@@ -119,6 +122,8 @@ public:
   };
   auto getClosestSeekPoint(FrameIndexDisplayOrder targetFrame, FrameIndexDisplayOrder currentFrame)
       -> SeekPointInfo;
+  // Get the indices (in display order) of all random access points in ascending order
+  auto getRandomAccessPoints() -> vector<FrameIndexDisplayOrder>;
 
   // Get the parameters sets as extradata. The format of this depends on the underlying codec.
   virtual QByteArray getExtradata() = 0;
@@ -128,7 +133,23 @@ public:
 
   std::optional<pairUint64> getFrameStartEndPos(FrameIndexCodingOrder idx);
 
-  bool parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, QWidget *mainWindow = nullptr);
+  // While the file is parsed, this is called (from the parsing thread) whenever more frames are
+  // final. The first nrFrames frames in coding order will not change anymore and neither will
+  // their order in display order. This is every frame before the last random access point that
+  // was found. When the end of the file is reached, all frames are final.
+  using FramesParsedCallback = std::function<void(size_t nrFrames)>;
+
+  bool parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file,
+                       QWidget *                             mainWindow   = nullptr,
+                       FramesParsedCallback                  framesParsed = {});
+
+  // Get everything that is needed to decode the file (the frames, the seek points with their
+  // parameter sets and the format properties) as a file index. The AnnexBFromIndex parser can be
+  // created from this so that the file does not have to be parsed again.
+  FileIndex createFileIndex();
+  // Add the frames up to nrFrames (in coding order) and their seek points to the given index
+  // that was created from the first frames before. The format properties are updated.
+  void updateFileIndex(FileIndex &index, size_t nrFrames);
 
   // Called from the bitstream analyzer. This function can run in a background process.
   bool runParsingOfFile(QString compressedFilePath) override;
@@ -169,15 +190,37 @@ protected:
 
   int getFramePOC(FrameIndexDisplayOrder frameIdx);
 
+  // The frame lists can be accessed from multiple threads (the decoders read from it while more
+  // frames are added from the file index).
+  mutable QMutex frameListMutex;
+
+  // The names of the format properties in the file index (see createFileIndex)
+  struct IndexProperty
+  {
+    static constexpr auto FrameRate   = "frameRate";
+    static constexpr auto Width       = "width";
+    static constexpr auto Height      = "height";
+    static constexpr auto PixelFormat = "pixelFormat";
+    static constexpr auto Extradata   = "extradata";
+    static constexpr auto Profile     = "profile";
+    static constexpr auto Level       = "level";
+    static constexpr auto AspectNum   = "sampleAspectRatioNum";
+    static constexpr auto AspectDen   = "sampleAspectRatioDen";
+    static constexpr auto NrNALUnits  = "nrNALUnits";
+  };
+
 private:
   // A list of all frames in the sequence (in coding order) with POC and the file positions of all
   // slice NAL units associated with a frame. POC's don't have to be consecutive, so the only way to
   // know how many pictures are in a sequences is to keep a list of all POCs.
   vector<AnnexBFrame> frameListCodingOrder;
+  // The POCs of all frames in the list above for a fast check if a POC is already in the list
+  std::set<int> framePOCs;
   // The same list of frames but sorted in display order. Generated from the list above whenever
   // needed.
   vector<AnnexBFrame> frameListDisplayOder;
-  void                updateFrameListDisplayOrder();
+  // Must be called with the frameListMutex locked
+  void updateFrameListDisplayOrder();
 };
 
 } // namespace parser
\ No newline at end of file
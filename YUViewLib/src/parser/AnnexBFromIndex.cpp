@@ -0,0 +1,99 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut f�r Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AnnexBFromIndex.h"
+
+namespace parser
+{
+
+AnnexBFromIndex::AnnexBFromIndex(const FileIndex &index, QObject *parent) : AnnexB(parent)
+{
+  this->appendFromIndex(index);
+
+  const auto &properties = index.properties;
+  this->frameRate        = properties.value(IndexProperty::FrameRate).toDouble();
+  this->frameSize        = Size(properties.value(IndexProperty::Width).toUInt(),
+                         properties.value(IndexProperty::Height).toUInt());
+  this->extradata        = properties.value(IndexProperty::Extradata).toByteArray();
+
+  const auto pixelFormatName = properties.value(IndexProperty::PixelFormat).toString();
+  this->pixelFormat          = video::yuv::PixelFormatYUV(pixelFormatName.toStdString());
+
+  this->profileLevel.first    = properties.value(IndexProperty::Profile).toInt();
+  this->profileLevel.second   = properties.value(IndexProperty::Level).toInt();
+  this->sampleAspectRatio.num = properties.value(IndexProperty::AspectNum).toInt();
+  this->sampleAspectRatio.den = properties.value(IndexProperty::AspectDen).toInt();
+
+  this->stream_info.file_size    = 0;
+  this->stream_info.nr_nal_units = properties.value(IndexProperty::NrNALUnits).toUInt();
+  this->stream_info.nr_frames    = unsigned(this->getNumberPOCs());
+}
+
+void AnnexBFromIndex::appendFromIndex(const FileIndex &index)
+{
+  // The frames were added to the list in the same order when the file was parsed
+  for (auto i = this->nrIndexFrames; i < index.frames.size(); i++)
+  {
+    const auto &frame = index.frames[i];
+    this->addFrameToList(int(frame.timestamp), frame.fileStartEndPos, frame.randomAccessPoint);
+  }
+  this->nrIndexFrames = index.frames.size();
+
+  QMutexLocker locker(&this->frameListMutex);
+  for (auto i = this->nrIndexSeekPoints; i < index.seekPoints.size(); i++)
+  {
+    const auto &seekPoint = index.seekPoints[i];
+    SeekData    data;
+    data.filePos = seekPoint.filePos;
+    for (auto parameterSet : seekPoint.parameterSets)
+      data.parameterSets.push_back(index.parameterSets[parameterSet]);
+    this->seekData[seekPoint.frameIndex] = data;
+  }
+  this->nrIndexSeekPoints = index.seekPoints.size();
+}
+
+void AnnexBFromIndex::updateStreamInfo(bool parsing)
+{
+  this->stream_info.parsing   = parsing;
+  this->stream_info.nr_frames = unsigned(this->getNumberPOCs());
+}
+
+std::optional<AnnexB::SeekData> AnnexBFromIndex::getSeekData(int iFrameNr)
+{
+  QMutexLocker locker(&this->frameListMutex);
+  auto it = this->seekData.find(unsigned(iFrameNr));
+  if (it == this->seekData.end())
+    return {};
+  return it->second;
+}
+
+} // namespace parser
@@ -0,0 +1,96 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut f�r Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "AnnexB.h"
+
+#include <map>
+
+namespace parser
+{
+
+/* A parser that does not parse anything. All its data comes from the file index that was created
+ * (see AnnexB::createFileIndex) when the file was parsed the last time. It provides everything that
+ * is needed to decode the file without parsing it again.
+ * While a file is parsed in the background, more frames can be added from the growing index of
+ * the parser (see AnnexB::updateFileIndex).
+ */
+class AnnexBFromIndex : public AnnexB
+{
+  Q_OBJECT
+
+public:
+  AnnexBFromIndex(const FileIndex &index, QObject *parent = nullptr);
+  ~AnnexBFromIndex(){};
+
+  // Add the frames and seek points from the index that were not added yet. The index must be the
+  // same index (with more frames) that this parser was created from. This can be called while the
+  // decoders are using the parser.
+  void appendFromIndex(const FileIndex &index);
+  // Update the stream info while the index is growing. Only call this from the main thread.
+  void updateStreamInfo(bool parsing);
+
+  double                     getFramerate() const override { return this->frameRate; }
+  Size                       getSequenceSizeSamples() const override { return this->frameSize; }
+  video::yuv::PixelFormatYUV getPixelFormat() const override { return this->pixelFormat; }
+
+  std::optional<SeekData> getSeekData(int iFrameNr) override;
+  QByteArray              getExtradata() override { return this->extradata; }
+  IntPair                 getProfileLevel() override { return this->profileLevel; }
+  Ratio                   getSampleAspectRatio() override { return this->sampleAspectRatio; }
+
+  // There is nothing to parse
+  ParseResult parseAndAddNALUnit(int,
+                                 const ByteVector &,
+                                 std::optional<BitratePlotModel::BitrateEntry>,
+                                 std::optional<pairUint64>,
+                                 std::shared_ptr<TreeItem>) override
+  {
+    return {};
+  }
+
+private:
+  double                     frameRate{};
+  Size                       frameSize;
+  video::yuv::PixelFormatYUV pixelFormat;
+  QByteArray                 extradata;
+  IntPair                    profileLevel;
+  Ratio                      sampleAspectRatio;
+
+  std::map<unsigned, SeekData> seekData;
+  // How many frames and seek points of the index were added
+  size_t nrIndexFrames{};
+  size_t nrIndexSeekPoints{};
+};
+
+} // namespace parser
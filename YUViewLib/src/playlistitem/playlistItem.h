@@ -42,6 +42,8 @@
 #include <QObject>
 #include <QTreeWidgetItem>
 
+#include <functional>
+
 #include "ui_playlistItem.h"
 
 namespace video
@@ -212,19 +214,39 @@ public:
   // Is there a limit on the number of threads that can cache from this item at the same time? (-1 =
   // no limit)
   virtual int cachingThreadLimit() { return -1; }
+  // Get the frames (in ascending order) where decoding can start. Frames between these can only be
+  // decoded after decoding the frames before them. If the list is empty, all frames can be
+  // accessed directly.
+  virtual std::vector<int> getRandomAccessPoints() const { return {}; }
   // Tag the item as "to be deleted"
   void tagItemForDeletion() { itemTaggedForDeletion = true; }
   // Cache the given frame. This function is thread save. So multiple instances of this function can
   // run at the same time. In test mode, we don't check if the frame is already cached and don't
   // cache it. We just convert it and return.
-  virtual void cacheFrame(int, bool) {}
+  // Caching can be split into two stages: Loading the frame (e.g. decoding it) and converting it.
+  // If the item does this, the returned function converts the loaded frame and puts it into the
+  // cache. It is called from another thread while the next frame is loaded. If the returned
+  // function is empty, the frame is cached already.
+  virtual std::function<void()> cacheFrame(int, bool) { return {}; }
   // Get a list of all cached frames (just the frame indices)
   virtual QList<int> getCachedFrames() const { return QList<int>(); }
   virtual int        getNumberCachedFrames() const { return 0; }
   // How many bytes will caching one frame use (in bytes)?
   virtual unsigned int getCachingFrameSize() const { return 0; }
+  // How many bytes are used by the cached frames of this item?
+  virtual int64_t getCacheSizeInBytes() const
+  {
+    return int64_t(getNumberCachedFrames()) * getCachingFrameSize();
+  }
   // Remove the frame with the given index from the cache.
   virtual void removeFrameFromCache(int) {}
+  // Remove all frames which are not within the given range from the cache.
+  virtual void removeFramesOutsideOfRange(indexRange range)
+  {
+    for (auto frameIdx : getCachedFrames())
+      if (frameIdx < range.first || frameIdx > range.second)
+        removeFrameFromCache(frameIdx);
+  }
   virtual void removeAllFramesFromCache(){};
 
   // ----- Detection of source/file change events -----
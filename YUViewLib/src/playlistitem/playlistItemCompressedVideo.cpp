@@ -32,9 +32,12 @@
 
 #include "playlistItemCompressedVideo.h"
 
+#include <QElapsedTimer>
 #include <QInputDialog>
 #include <QPlainTextEdit>
+#include <QProgressDialog>
 #include <QThread>
+#include <QtConcurrent>
 
 #include <inttypes.h>
 
@@ -47,13 +50,16 @@
 #include <decoder/decoderLibde265.h>
 #include <decoder/decoderVTM.h>
 #include <decoder/decoderVVDec.h>
+#include <filesource/FileIndex.h>
 #include <parser/AVC/AnnexBAVC.h>
+#include <parser/AnnexBFromIndex.h>
 #include <parser/HEVC/AnnexBHEVC.h>
 #include <parser/VVC/AnnexBVVC.h>
 #include <parser/common/SubByteReaderLogging.h>
 #include <statistics/StatisticsDataPainting.h>
 #include <ui/mainwindow.h>
 #include <ui_playlistItemCompressedFile_logDialog.h>
+#include <video/DiskFrameCache.h>
 #include <video/videoHandlerRGB.h>
 #include <video/videoHandlerYUV.h>
 
@@ -116,6 +122,10 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   // An compressed file can be cached if nothing goes wrong
   cachingEnabled = true;
 
+  // How many decoders are used for caching? Each one can decode a different segment of the
+  // sequence in parallel.
+  const auto nrCachingDecoders = cachingEnabled ? decoder::getNrCachingDecoders() : 0;
+
   // Open the input file and get some properties (size, bit depth, subsampling) from the file
   if (input == InputFormat::Invalid)
   {
@@ -143,8 +153,12 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
     // Open file
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Open annexB file");
     inputFileAnnexBLoading.reset(new FileSourceAnnexBFile(compressedFilePath));
-    if (cachingEnabled)
-      inputFileAnnexBCaching.reset(new FileSourceAnnexBFile(compressedFilePath));
+    for (int i = 0; i < nrCachingDecoders; i++)
+    {
+      this->cachingDecoders.emplace_back(new CachingDecoder);
+      this->cachingDecoders.back()->inputFileAnnexB.reset(
+          new FileSourceAnnexBFile(compressedFilePath));
+    }
     // inputFormatType a parser
     if (this->inputFormat == InputFormat::AnnexBHEVC)
     {
@@ -167,9 +181,21 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
       codec = Codec::Other;
     }
 
-    DEBUG_COMPRESSED(
-        "playlistItemCompressedVideo::playlistItemCompressedVideo Start parsing of file");
-    inputFileAnnexBParser->parseAnnexBFile(inputFileAnnexBLoading, mainWindow);
+    // Parsing a large file takes long. If the file was parsed before, everything that we need is
+    // loaded from the file index.
+    const auto indexType = QString::fromStdString(InputFormatMapper.getName(this->inputFormat));
+    if (auto fileIndex = FileIndex::load(compressedFilePath, indexType))
+    {
+      DEBUG_COMPRESSED(
+          "playlistItemCompressedVideo::playlistItemCompressedVideo Load parsing results from index");
+      inputFileAnnexBParser.reset(new parser::AnnexBFromIndex(*fileIndex));
+    }
+    else
+    {
+      DEBUG_COMPRESSED(
+          "playlistItemCompressedVideo::playlistItemCompressedVideo Start parsing of file");
+      this->startBackgroundParsing(compressedFilePath, indexType, mainWindow);
+    }
 
     // Get the frame size and the pixel format
     frameSize = inputFileAnnexBParser->getSequenceSizeSamples();
@@ -183,6 +209,8 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo framerate "
                      << this->prop.frameRate);
     this->prop.startEndRange = indexRange(0, int(inputFileAnnexBParser->getNumberPOCs() - 1));
+    for (auto frameIdx : inputFileAnnexBParser->getRandomAccessPoints())
+      this->randomAccessPoints.push_back(int(frameIdx));
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo startEndRange (0,"
                      << inputFileAnnexBParser->getNumberPOCs() << ")");
     this->prop.sampleAspectRatio = inputFileAnnexBParser->getSampleAspectRatio();
@@ -223,6 +251,7 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo framerate "
                      << this->prop.frameRate);
     this->prop.startEndRange = inputFileFFmpegLoading->getDecodableFrameLimits();
+    this->randomAccessPoints = inputFileFFmpegLoading->getKeyFrameIndices();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo startEndRange ("
                      << this->prop.startEndRange.first << "x" << this->prop.startEndRange.second
                      << ")");
@@ -241,11 +270,13 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
     if (ffmpegCodec.isAV1())
       codec = Codec::AV1;
 
-    if (cachingEnabled)
+    // Open the file again for every caching decoder
+    for (int i = 0; i < nrCachingDecoders; i++)
     {
-      // Open the file again for caching
-      inputFileFFmpegCaching.reset(new FileSourceFFmpegFile());
-      if (!inputFileFFmpegCaching->openFile(
+      this->cachingDecoders.emplace_back(new CachingDecoder);
+      auto &inputFileFFmpeg = this->cachingDecoders.back()->inputFileFFmpeg;
+      inputFileFFmpeg.reset(new FileSourceFFmpegFile());
+      if (!inputFileFFmpeg->openFile(
               compressedFilePath, mainWindow, inputFileFFmpegLoading.data()))
       {
         setError("Error opening file a second time using libavcodec for caching.");
@@ -338,6 +369,7 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
     }
   }
 
+  this->statisticsData.updateSettings();
   this->statisticsUIHandler.setStatisticsData(&this->statisticsData);
 
   // Allocate the decoders
@@ -346,6 +378,7 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
                    << " decoder");
   if (!allocateDecoder(displayComponent))
     return;
+  this->updateDiskCacheSequenceKey();
 
   if (rawFormat == video::RawFormat::YUV)
   {
@@ -364,12 +397,12 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
     // No frames to decode
     return;
 
-  // Seek both decoders to the start of the bitstream (this will also push the parameter sets /
+  // Seek all decoders to the start of the bitstream (this will also push the parameter sets /
   // extradata to the decoder)
   DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Seek decoders to 0");
-  seekToPosition(0, 0, false);
-  if (cachingEnabled)
-    seekToPosition(0, 0, true);
+  this->seekToPosition(this->loadingContext, 0, 0);
+  for (auto &cachingDecoder : this->cachingDecoders)
+    this->seekToPosition(cachingDecoder->context, 0, 0);
 
   // Connect signals for requesting data and statistics
   connect(video.get(),
@@ -377,12 +410,148 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
           this,
           &playlistItemCompressedVideo::loadRawData,
           Qt::DirectConnection);
+  // Caching does not go through the shared raw data buffer of the video handler. Every caching
+  // thread decodes into its own buffer using one of the caching decoders.
+  if (!this->cachingDecoders.empty())
+    this->video->setCachingRawDataSource([this](int frameIndex, video::FrameBuffer &rawData) {
+      return this->decodeFrameForCaching(frameIndex, rawData);
+    });
   connect(&this->statisticsUIHandler,
           &stats::StatisticUIHandler::updateItem,
           this,
           &playlistItemCompressedVideo::updateStatSource);
 }
 
+playlistItemCompressedVideo::~playlistItemCompressedVideo()
+{
+  if (this->backgroundParserFuture.isRunning())
+  {
+    // The parser checks regularly if it should abort
+    this->backgroundParser->setAbortParsing();
+    this->backgroundParserFuture.waitForFinished();
+  }
+}
+
+void playlistItemCompressedVideo::startBackgroundParsing(const QString &filePath,
+                                                         const QString &indexType,
+                                                         QWidget *      mainWindow)
+{
+  this->backgroundParser.reset(this->inputFileAnnexBParser.take());
+  this->backgroundParserFile.reset(new FileSourceAnnexBFile(filePath));
+
+  // This is called from the background thread. The first time, the parser that the item uses is
+  // created. After that, the new frames are added to it.
+  auto framesParsed = [this](size_t nrFrames) {
+    this->backgroundParser->updateFileIndex(this->backgroundParserIndex, nrFrames);
+    QMutexLocker locker(&this->backgroundParserMutex);
+    if (this->backgroundParserIndexParser == nullptr)
+    {
+      this->backgroundParserIndexParser = new parser::AnnexBFromIndex(this->backgroundParserIndex);
+      this->backgroundParserFramesAvailable.wakeAll();
+    }
+    else
+      this->backgroundParserIndexParser->appendFromIndex(this->backgroundParserIndex);
+  };
+
+  this->backgroundParserFuture = QtConcurrent::run([this, filePath, indexType, framesParsed]() {
+    if (this->backgroundParser->parseAnnexBFile(this->backgroundParserFile, nullptr, framesParsed))
+      this->backgroundParserIndex.save(filePath, indexType);
+    QMutexLocker locker(&this->backgroundParserMutex);
+    this->backgroundParserDone = true;
+    this->backgroundParserFramesAvailable.wakeAll();
+  });
+
+  // Wait until the first frames are known. This is usually fast. If it is not (e.g. if there is
+  // only one random access point in the file), a progress dialog is shown after 1s.
+  QScopedPointer<QProgressDialog> progressDialog;
+  QElapsedTimer                   waitTimer;
+  waitTimer.start();
+  while (true)
+  {
+    {
+      QMutexLocker locker(&this->backgroundParserMutex);
+      if (this->backgroundParserIndexParser != nullptr || this->backgroundParserDone)
+        break;
+      this->backgroundParserFramesAvailable.wait(&this->backgroundParserMutex, 100);
+    }
+
+    if (mainWindow && waitTimer.elapsed() > 1000)
+    {
+      if (!progressDialog)
+      {
+        progressDialog.reset(
+            new QProgressDialog("Parsing AnnexB bitstream...", "Cancel", 0, 100, mainWindow));
+        progressDialog->setAutoClose(false);
+        progressDialog->setAutoReset(false);
+        progressDialog->setWindowModality(Qt::WindowModal);
+      }
+      progressDialog->setValue(this->backgroundParser->getParsingProgressPercent());
+      if (progressDialog->wasCanceled())
+        this->backgroundParser->setAbortParsing();
+    }
+  }
+
+  QMutexLocker locker(&this->backgroundParserMutex);
+  if (this->backgroundParserIndexParser == nullptr)
+  {
+    // Parsing was canceled before any frames were found
+    this->backgroundParserIndexParser = new parser::AnnexBFromIndex(this->backgroundParserIndex);
+  }
+  this->inputFileAnnexBParser.reset(this->backgroundParserIndexParser);
+  this->backgroundParserIndexParser->updateStreamInfo(!this->backgroundParserDone);
+  if (!this->backgroundParserDone)
+    this->backgroundParserTimer.start(500, this);
+}
+
+void playlistItemCompressedVideo::timerEvent(QTimerEvent *event)
+{
+  if (event->timerId() != this->backgroundParserTimer.timerId())
+    return playlistItemWithVideo::timerEvent(event);
+  this->updateFromBackgroundParser();
+}
+
+void playlistItemCompressedVideo::waitForBackgroundParsing()
+{
+  if (!this->backgroundParserTimer.isActive())
+    return;
+  this->backgroundParserFuture.waitForFinished();
+  this->updateFromBackgroundParser();
+}
+
+FileIndex playlistItemCompressedVideo::getFileIndex() const
+{
+  if (!this->inputFileAnnexBParser)
+    return {};
+  return this->inputFileAnnexBParser->createFileIndex();
+}
+
+void playlistItemCompressedVideo::updateFromBackgroundParser()
+{
+  bool parsing;
+  {
+    QMutexLocker locker(&this->backgroundParserMutex);
+    parsing = !this->backgroundParserDone;
+  }
+  if (!parsing)
+  {
+    this->backgroundParserTimer.stop();
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::updateFromBackgroundParser parsing done");
+  }
+  this->backgroundParserIndexParser->updateStreamInfo(parsing);
+
+  // Grow the frame range. The frames that were already known keep their index in display order.
+  const auto nrFrames = int(this->inputFileAnnexBParser->getNumberPOCs());
+  if (nrFrames - 1 == this->prop.startEndRange.second)
+    return;
+  this->prop.startEndRange = indexRange(0, nrFrames - 1);
+  this->randomAccessPoints.clear();
+  for (auto frameIdx : this->inputFileAnnexBParser->getRandomAccessPoints())
+    this->randomAccessPoints.push_back(int(frameIdx));
+  DEBUG_COMPRESSED("playlistItemCompressedVideo::updateFromBackgroundParser startEndRange (0,"
+                   << nrFrames << ")");
+  emit SignalItemChanged(false, RECACHE_NONE);
+}
+
 void playlistItemCompressedVideo::savePlaylist(QDomElement &root, const QDir &playlistDir) const
 {
   auto filename = this->properties().name;
@@ -551,9 +720,10 @@ ItemLoadingState playlistItemCompressedVideo::needsLoading(int frameIdx, bool lo
   if (unresolvableError || !decodingEnabled)
     return ItemLoadingState::LoadingNotNeeded;
 
-  auto videoState = video->needsLoading(frameIdx, loadRawData);
-  if (videoState == ItemLoadingState::LoadingNeeded && decodingNotPossibleAfter >= 0 &&
-      frameIdx >= decodingNotPossibleAfter && frameIdx >= currentFrameIdx[0])
+  auto      videoState       = video->needsLoading(frameIdx, loadRawData);
+  const int notPossibleAfter = this->loadingContext.decodingNotPossibleAfter;
+  if (videoState == ItemLoadingState::LoadingNeeded && notPossibleAfter >= 0 &&
+      frameIdx >= notPossibleAfter && frameIdx >= this->loadingContext.currentFrameIdx)
     // The decoder can not decode this frame.
     return ItemLoadingState::LoadingNotNeeded;
   if (videoState == ItemLoadingState::LoadingNeeded ||
@@ -567,8 +737,9 @@ void playlistItemCompressedVideo::drawItem(QPainter *painter,
                                            double    zoomFactor,
                                            bool      drawRawData)
 {
-  auto range = this->properties().startEndRange;
-  if (decodingNotPossibleAfter >= 0 && frameIdx >= decodingNotPossibleAfter)
+  auto      range            = this->properties().startEndRange;
+  const int notPossibleAfter = this->loadingContext.decodingNotPossibleAfter;
+  if (notPossibleAfter >= 0 && frameIdx >= notPossibleAfter)
   {
     infoText = "Decoding of the frame not possible:\n";
     infoText += "The frame could not be decoded. Possibly, the bitstream is corrupt or was cut at "
@@ -593,40 +764,106 @@ void playlistItemCompressedVideo::drawItem(QPainter *painter,
 
 void playlistItemCompressedVideo::loadRawData(int frameIdx, bool caching)
 {
-  if (caching && !cachingEnabled)
+  DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData " << frameIdx
+                                                               << (caching ? " caching" : ""));
+
+  video::FrameBuffer data;
+  if (caching)
+  {
+    // Usually, the video handler gets the data for caching from decodeFrameForCaching directly.
+    if (cachingEnabled && this->decodeFrameForCaching(frameIdx, data))
+    {
+      video->rawFrameBuffer     = data;
+      video->rawData_frameIndex = frameIdx;
+    }
     return;
-  if (!caching && loadingDecoder->state() == decoder::DecoderState::Error)
+  }
+
+  if (this->decodeFrame(this->loadingContext, frameIdx, data))
   {
-    if (frameIdx < currentFrameIdx[0])
+    video->rawFrameBuffer     = data;
+    video->rawData_frameIndex = frameIdx;
+  }
+  else if (this->loadingContext.decodingNotPossibleAfter >= 0 &&
+           frameIdx >= this->loadingContext.decodingNotPossibleAfter)
+  {
+    // The specified frame (which is thoretically in the bitstream) can not be decoded.
+    // Maybe the bitstream was cut at a position that it was not supposed to be cut at.
+    // Just set the frame number of the buffer to the current frame so that it will trigger a
+    // reload when the frame number changes.
+    video->rawData_frameIndex = frameIdx;
+  }
+  else if (loadingDecoder->state() == decoder::DecoderState::Error)
+  {
+    infoText = "There was an error in the decoder: \n";
+    infoText += loadingDecoder->decoderErrorString();
+    infoText += "\n";
+
+    decodingEnabled = false;
+  }
+}
+
+bool playlistItemCompressedVideo::decodeFrame(DecodingContext &   context,
+                                              int                frameIdx,
+                                              video::FrameBuffer &rawData)
+{
+  auto dec = context.decoder;
+  if (dec == nullptr)
+    return false;
+  if (dec->state() == decoder::DecoderState::Error)
+  {
+    if (!context.caching && frameIdx < context.currentFrameIdx)
     {
       // There was an error in the loading decoder but we will seek backwards so maybe this will
       // work again
     }
     else
-      return;
+      return false;
   }
-  if (caching && cachingDecoder->state() == decoder::DecoderState::Error)
-    return;
-
-  DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData " << frameIdx
-                                                               << (caching ? " caching" : ""));
 
   if (frameIdx > this->properties().startEndRange.second || frameIdx < 0)
   {
-    DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData Invalid frame index");
-    return;
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame Invalid frame index");
+    return false;
+  }
+
+  // The frame was the last one that this decoder output
+  if (frameIdx == context.rawDataFrameIdx)
+  {
+    rawData = context.rawData;
+    return true;
   }
 
-  // Get the right decoder
-  auto dec         = caching ? cachingDecoder.data() : loadingDecoder.data();
-  int  curFrameIdx = caching ? currentFrameIdx[1] : currentFrameIdx[0];
+  // Frames that were decoded before may be in the disk cache. The disk cache does not contain the
+  // statistics so it can only be used if no statistics are retrieved from the decoder.
+  auto &     diskFrameCache = video::getDiskFrameCache();
+  const auto useDiskCache   = diskFrameCache.isEnabled() && !dec->statisticsEnabled();
+  QString    diskCacheKey;
+  if (useDiskCache)
+  {
+    {
+      QMutexLocker locker(&this->cachingMutex);
+      diskCacheKey = this->diskCacheSequenceKey;
+    }
+    QByteArray diskCacheData;
+    if (!diskCacheKey.isEmpty() && diskFrameCache.loadFrame(diskCacheKey, frameIdx, diskCacheData))
+    {
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame loaded from disk cache");
+      rawData = video::FrameBuffer(diskCacheData);
+      return true;
+    }
+  }
 
   // Should we seek?
-  if (curFrameIdx == -1 || frameIdx < curFrameIdx ||
-      frameIdx > curFrameIdx + FORWARD_SEEK_THRESHOLD)
+  // If the decoder reached the end of the frames that were parsed so far, it was flushed. Seek to
+  // continue decoding when more frames were parsed in the meantime.
+  auto       curFrameIdx    = context.currentFrameIdx;
+  const auto decoderFlushed = dec->state() == decoder::DecoderState::EndOfBitstream;
+  if (curFrameIdx == -1 || frameIdx <= curFrameIdx ||
+      frameIdx > curFrameIdx + FORWARD_SEEK_THRESHOLD || decoderFlushed)
   {
     // Definitely seek when we have to go backwards
-    bool seek = curFrameIdx == -1 || (frameIdx < curFrameIdx);
+    bool seek = curFrameIdx == -1 || (frameIdx <= curFrameIdx) || decoderFlushed;
 
     // Get the closest possible seek position
     size_t  seekToFrame = 0;
@@ -641,12 +878,8 @@ void playlistItemCompressedVideo::loadRawData(int frameIdx, bool caching)
     }
     else
     {
-      if (caching)
-        std::tie(seekToDTS, seekToFrame) =
-            inputFileFFmpegCaching->getClosestSeekableFrameBefore(frameIdx);
-      else
-        std::tie(seekToDTS, seekToFrame) =
-            inputFileFFmpegLoading->getClosestSeekableFrameBefore(frameIdx);
+      std::tie(seekToDTS, seekToFrame) =
+          context.inputFileFFmpeg->getClosestSeekableFrameBefore(frameIdx);
 
       // The distance in the display order unfortunately does not tell us
       // too much about the number of frames that must be decoded to seek
@@ -658,43 +891,41 @@ void playlistItemCompressedVideo::loadRawData(int frameIdx, bool caching)
     if (seek)
     {
       // Seek and update the frame counters. The seekToPosition function will update the
-      // currentFrameIdx[] indices
-      this->readAnnexBFrameCounterCodingOrder = int(seekToFrame);
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData seeking to frame "
+      // currentFrameIdx of the context.
+      context.readAnnexBFrameCounterCodingOrder = int(seekToFrame);
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame seeking to frame "
                        << seekToFrame << " PTS " << seekToDTS << " AnnexBCnt "
-                       << readAnnexBFrameCounterCodingOrder);
-      this->seekToPosition(this->readAnnexBFrameCounterCodingOrder, seekToDTS, caching);
+                       << context.readAnnexBFrameCounterCodingOrder);
+      this->seekToPosition(context, context.readAnnexBFrameCounterCodingOrder, seekToDTS);
     }
   }
 
   // Decode until we get the right frame from the decoder
-  bool rightFrame = caching ? currentFrameIdx[1] == frameIdx : currentFrameIdx[0] == frameIdx;
+  bool rightFrame = false;
   while (!rightFrame)
   {
     while (dec->state() == decoder::DecoderState::NeedsMoreData)
     {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoder needs more data");
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame decoder needs more data");
       if (isInputFormatTypeFFmpeg(this->inputFormat) &&
           this->decoderEngine == DecoderEngine::FFMpeg)
       {
         // In this scenario, we can read and push AVPackets
         // from the FFmpeg file and pass them to the FFmpeg decoder directly.
-        auto pkt   = caching ? inputFileFFmpegCaching->getNextPacket(repushData)
-                             : inputFileFFmpegLoading->getNextPacket(repushData);
-        repushData = false;
+        auto pkt           = context.inputFileFFmpeg->getNextPacket(context.repushData);
+        context.repushData = false;
         if (pkt)
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived packet PTS "
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived packet PTS "
                            << pkt.getPTS());
         else
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived empty packet");
-        auto ffmpegDec = (caching ? dynamic_cast<decoder::decoderFFmpeg *>(cachingDecoder.data())
-                                  : dynamic_cast<decoder::decoderFFmpeg *>(loadingDecoder.data()));
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived empty packet");
+        auto ffmpegDec = dynamic_cast<decoder::decoderFFmpeg *>(dec);
         if (!ffmpegDec->pushAVPacket(pkt))
         {
           if (ffmpegDec->state() != decoder::DecoderState::RetrieveFrames)
             // The decoder did not switch to decoding frame mode. Error.
-            return;
-          repushData = true;
+            return false;
+          context.repushData = true;
         }
       }
       else if (isInputFormatTypeAnnexB(this->inputFormat) &&
@@ -702,37 +933,34 @@ void playlistItemCompressedVideo::loadRawData(int frameIdx, bool caching)
       {
         // We are reading from a raw annexB file and use ffmpeg for decoding
         QByteArray data;
-        if (readAnnexBFrameCounterCodingOrder >= 0 &&
-            unsigned(readAnnexBFrameCounterCodingOrder) >= inputFileAnnexBParser->getNumberPOCs())
+        auto &     frameCounter = context.readAnnexBFrameCounterCodingOrder;
+        if (frameCounter >= 0 && unsigned(frameCounter) >= inputFileAnnexBParser->getNumberPOCs())
         {
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData EOF");
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame EOF");
         }
         else
         {
           // Get the data of the next frame (which might be multiple NAL units)
-          auto frameStartEndFilePos =
-              inputFileAnnexBParser->getFrameStartEndPos(readAnnexBFrameCounterCodingOrder);
+          auto frameStartEndFilePos = inputFileAnnexBParser->getFrameStartEndPos(frameCounter);
           Q_ASSERT_X(frameStartEndFilePos,
-                     "playlistItemCompressedVideo::loadRawData",
+                     "playlistItemCompressedVideo::decodeFrame",
                      "frameStartEndFilePos could not be retrieved. This should always work for a "
                      "raw AnnexB file.");
 
-          data = caching ? inputFileAnnexBCaching->getFrameData(*frameStartEndFilePos)
-                         : inputFileAnnexBLoading->getFrameData(*frameStartEndFilePos);
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived frame data from file "
+          data = context.inputFileAnnexB->getFrameData(*frameStartEndFilePos);
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived frame data from file "
                            "- AnnexBCnt "
-                           << readAnnexBFrameCounterCodingOrder << " startEnd "
-                           << frameStartEndFilePos->first << "-" << frameStartEndFilePos->second
-                           << " - size " << data.size());
+                           << frameCounter << " startEnd " << frameStartEndFilePos->first << "-"
+                           << frameStartEndFilePos->second << " - size " << data.size());
         }
 
         if (!dec->pushData(data))
         {
           if (dec->state() != decoder::DecoderState::RetrieveFrames)
           {
-            DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData The decoder did not switch "
+            DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame The decoder did not switch "
                              "to decoding frame mode. Error.");
-            decodingNotPossibleAfter = frameIdx;
+            context.decodingNotPossibleAfter = frameIdx;
             break;
           }
           // Pushing the data failed because the ffmpeg decoder wants us to read frames first.
@@ -740,28 +968,26 @@ void playlistItemCompressedVideo::loadRawData(int frameIdx, bool caching)
           // again.
         }
         else
-          readAnnexBFrameCounterCodingOrder++;
+          frameCounter++;
       }
       else if (isInputFormatTypeAnnexB(this->inputFormat) &&
                this->decoderEngine != DecoderEngine::FFMpeg)
       {
-        auto data = caching ? inputFileAnnexBCaching->getNextNALUnit(repushData)
-                            : inputFileAnnexBLoading->getNextNALUnit(repushData);
+        auto data = context.inputFileAnnexB->getNextNALUnit(context.repushData);
         DEBUG_COMPRESSED(
-            "playlistItemCompressedVideo::loadRawData retrived nal unit from file - size "
+            "playlistItemCompressedVideo::decodeFrame retrived nal unit from file - size "
             << data.size());
-        repushData = !dec->pushData(data);
+        context.repushData = !dec->pushData(data);
       }
       else if (isInputFormatTypeFFmpeg(this->inputFormat) &&
                this->decoderEngine != DecoderEngine::FFMpeg)
       {
         // Get the next unit (NAL or OBU) form ffmepg and push it to the decoder
-        auto data = caching ? inputFileFFmpegCaching->getNextUnit(repushData)
-                            : inputFileFFmpegLoading->getNextUnit(repushData);
+        auto data = context.inputFileFFmpeg->getNextUnit(context.repushData);
         DEBUG_COMPRESSED(
-            "playlistItemCompressedVideo::loadRawData retrived nal unit from file - size "
+            "playlistItemCompressedVideo::decodeFrame retrived nal unit from file - size "
             << data.size());
-        repushData = !dec->pushData(data);
+        context.repushData = !dec->pushData(data);
       }
       else
         assert(false);
@@ -769,22 +995,34 @@ void playlistItemCompressedVideo::loadRawData(int frameIdx, bool caching)
 
     if (dec->state() == decoder::DecoderState::RetrieveFrames)
     {
+      if (dec->statisticsEnabled())
+        // Only keep the statistics of the frame that is decoded next
+        context.statisticsData.clear();
       if (dec->decodeNextFrame())
       {
-        if (caching)
-          currentFrameIdx[1]++;
-        else
-          currentFrameIdx[0]++;
-
-        DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoded frame "
-                         << (caching ? currentFrameIdx[1] : currentFrameIdx[0]));
-        rightFrame = caching ? currentFrameIdx[1] == frameIdx : currentFrameIdx[0] == frameIdx;
+        context.currentFrameIdx++;
+        DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame decoded frame "
+                         << context.currentFrameIdx);
+        rightFrame = context.currentFrameIdx == frameIdx;
         if (rightFrame)
         {
+          // The frame buffer may point to the buffers of the decoder without copying the frame
+          rawData                 = dec->getFrameBuffer();
+          context.rawData         = rawData;
+          context.rawDataFrameIdx = frameIdx;
           if (dec->statisticsEnabled())
-            this->statisticsData.setFrameIndex(frameIdx);
-          video->rawData            = dec->getRawFrameData();
-          video->rawData_frameIndex = frameIdx;
+          {
+            // Some decoders only retrieve the statistics together with the frame buffer. The
+            // statistics of frames that are decoded for caching go to the frame cache.
+            if (!context.caching)
+              this->statisticsData.setFrameIndex(frameIdx);
+            this->statisticsData.cacheFrame(frameIdx, context.statisticsData.takeFrameData());
+          }
+          if (useDiskCache && !diskCacheKey.isEmpty())
+          {
+            const auto elementSize = (dec->getPixelFormatYUV().getBitsPerSample() > 8) ? 2u : 1u;
+            diskFrameCache.saveFrame(diskCacheKey, frameIdx, rawData.toByteArray(), elementSize);
+          }
         }
       }
     }
@@ -792,42 +1030,124 @@ void playlistItemCompressedVideo::loadRawData(int frameIdx, bool caching)
     if (dec->state() != decoder::DecoderState::NeedsMoreData &&
         dec->state() != decoder::DecoderState::RetrieveFrames)
     {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoder neither needs more data "
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame decoder neither needs more data "
                        "nor can decode frames");
-      decodingNotPossibleAfter = frameIdx;
+      context.decodingNotPossibleAfter = frameIdx;
       break;
     }
   }
 
-  if (decodingNotPossibleAfter >= 0 && frameIdx >= decodingNotPossibleAfter)
+  if (context.decodingNotPossibleAfter >= 0 && frameIdx >= context.decodingNotPossibleAfter)
   {
     // The specified frame (which is thoretically in the bitstream) can not be decoded.
-    // Maybe the bitstream was cut at a position that it was not supposed to be cut at.
-    if (caching)
-      currentFrameIdx[1] = frameIdx;
-    else
-      currentFrameIdx[0] = frameIdx;
-    // Just set the frame number of the buffer to the current frame so that it will trigger a
-    // reload when the frame number changes.
-    video->rawData_frameIndex = frameIdx;
+    context.currentFrameIdx = frameIdx;
+    return false;
   }
-  else if (loadingDecoder->state() == decoder::DecoderState::Error)
+  return rightFrame;
+}
+
+bool playlistItemCompressedVideo::decodeFrameForCaching(int frameIdx, video::FrameBuffer &rawData)
+{
+  auto cachingDecoder = this->acquireCachingDecoder(frameIdx);
+  if (cachingDecoder == nullptr)
+    return false;
+
+  DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrameForCaching " << frameIdx);
+  const auto success = this->decodeFrame(cachingDecoder->context, frameIdx, rawData);
+  this->releaseCachingDecoder(cachingDecoder);
+  return success;
+}
+
+playlistItemCompressedVideo::CachingDecoder *
+playlistItemCompressedVideo::acquireCachingDecoder(int frameIdx)
+{
+  QMutexLocker locker(&this->cachingMutex);
+  if (this->cachingDecoders.empty())
+    return nullptr;
+
+  // The video cache will usually not start more caching threads than there are decoders. But in
+  // the caching test (or if the decoders are reallocated) we may have to wait.
+  while (true)
   {
-    infoText = "There was an error in the decoder: \n";
-    infoText += loadingDecoder->decoderErrorString();
-    infoText += "\n";
+    CachingDecoder *selected = nullptr;
+    for (auto &cachingDecoder : this->cachingDecoders)
+    {
+      if (cachingDecoder->inUse || !cachingDecoder->context.decoder)
+        continue;
+
+      // A decoder that can just continue decoding is the best choice. Otherwise, take the decoder
+      // that was not used for the longest time.
+      const auto curFrameIdx = cachingDecoder->context.currentFrameIdx;
+      if (curFrameIdx >= 0 && frameIdx >= curFrameIdx &&
+          frameIdx <= curFrameIdx + FORWARD_SEEK_THRESHOLD)
+      {
+        selected = cachingDecoder.get();
+        break;
+      }
+      if (selected == nullptr || cachingDecoder->lastUsed < selected->lastUsed)
+        selected = cachingDecoder.get();
+    }
 
-    decodingEnabled = false;
+    if (selected != nullptr)
+    {
+      selected->inUse    = true;
+      selected->lastUsed = ++this->cachingDecoderUseCounter;
+      return selected;
+    }
+    this->cachingDecoderReleased.wait(&this->cachingMutex);
+  }
+}
+
+void playlistItemCompressedVideo::releaseCachingDecoder(CachingDecoder *cachingDecoder)
+{
+  QMutexLocker locker(&this->cachingMutex);
+  cachingDecoder->inUse = false;
+  this->cachingDecoderReleased.wakeAll();
+}
+
+void playlistItemCompressedVideo::forEachCachingDecoder(
+    std::function<void(CachingDecoder &cachingDecoder)> function)
+{
+  // The caching decoders must not be changed while a caching thread is using them
+  QMutexLocker locker(&this->cachingMutex);
+  auto isInUse = [](const std::unique_ptr<CachingDecoder> &d) { return d->inUse; };
+  while (std::any_of(this->cachingDecoders.begin(), this->cachingDecoders.end(), isInUse))
+    this->cachingDecoderReleased.wait(&this->cachingMutex);
+
+  for (auto &cachingDecoder : this->cachingDecoders)
+    function(*cachingDecoder);
+}
+
+void playlistItemCompressedVideo::updateDiskCacheSequenceKey()
+{
+  QString key;
+  if (this->loadingDecoder)
+  {
+    QStringList decodeSettings;
+    decodeSettings << QString::fromStdString(InputFormatMapper.getName(this->inputFormat));
+    decodeSettings << QString::fromStdString(DecoderEngineMapper.getName(this->decoderEngine));
+    decodeSettings << QString::number(this->loadingDecoder->getDecodeSignal());
+    decodeSettings << this->video->getFormatAsString();
+    key = video::DiskFrameCache::getSequenceKey(this->properties().name, decodeSettings);
   }
+
+  QMutexLocker locker(&this->cachingMutex);
+  this->diskCacheSequenceKey = key;
 }
 
-void playlistItemCompressedVideo::seekToPosition(int seekToFrame, int64_t seekToDTS, bool caching)
+void playlistItemCompressedVideo::seekToPosition(DecodingContext &context,
+                                                 int              seekToFrame,
+                                                 int64_t          seekToDTS)
 {
   // Do the seek
-  auto dec = caching ? cachingDecoder.data() : loadingDecoder.data();
+  auto dec = context.decoder;
+  if (dec == nullptr)
+    return;
   dec->resetDecoder();
-  repushData               = false;
-  decodingNotPossibleAfter = -1;
+  context.repushData               = false;
+  context.rawDataFrameIdx          = -1;
+  context.rawData                  = {};
+  context.decodingNotPossibleAfter = -1;
 
   // Retrieval of the raw metadata is only required if the the reader or the decoder is not ffmpeg
   const bool bothFFmpeg =
@@ -856,22 +1176,15 @@ void playlistItemCompressedVideo::seekToPosition(int seekToFrame, int64_t seekTo
     }
     DEBUG_COMPRESSED("playlistItemCompressedVideo::seekToPosition seeking annexB file to filePos "
                      << filePos);
-    if (caching)
-      inputFileAnnexBCaching->seek(filePos);
-    else
-      inputFileAnnexBLoading->seek(filePos);
+    context.inputFileAnnexB->seek(filePos);
   }
   else
   {
     if (!bothFFmpeg)
-      parametersets = caching ? inputFileFFmpegCaching->getParameterSets()
-                              : inputFileFFmpegLoading->getParameterSets();
+      parametersets = context.inputFileFFmpeg->getParameterSets();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::seekToPosition seeking ffmpeg file to pts "
                      << seekToDTS);
-    if (caching)
-      inputFileFFmpegCaching->seekToDTS(seekToDTS);
-    else
-      inputFileFFmpegLoading->seekToDTS(seekToDTS);
+    context.inputFileFFmpeg->seekToDTS(seekToDTS);
   }
 
   // In case of using ffmpeg for decoding, we don't need to push the parameter sets (the
@@ -889,10 +1202,7 @@ void playlistItemCompressedVideo::seekToPosition(int seekToFrame, int64_t seekTo
         return;
       }
   }
-  if (caching)
-    currentFrameIdx[1] = seekToFrame - 1;
-  else
-    currentFrameIdx[0] = seekToFrame - 1;
+  context.currentFrameIdx = seekToFrame - 1;
 }
 
 void playlistItemCompressedVideo::createPropertiesWidget()
@@ -953,116 +1263,85 @@ bool playlistItemCompressedVideo::allocateDecoder(int displayComponent)
 {
   // Reset (existing) decoders
   loadingDecoder.reset();
-  cachingDecoder.reset();
-
-  if (this->decoderEngine == DecoderEngine::Libde265)
-  {
-    DEBUG_COMPRESSED(
-        "playlistItemCompressedVideo::allocateDecoder Initializing interactive libde265 decoder");
-    loadingDecoder.reset(new decoder::decoderLibde265(displayComponent));
-    if (cachingEnabled)
-    {
-      DEBUG_COMPRESSED(
-          "playlistItemCompressedVideo::allocateDecoder Initializing caching libde265 decoder");
-      cachingDecoder.reset(new decoder::decoderLibde265(displayComponent, true));
-    }
-  }
-  else if (this->decoderEngine == DecoderEngine::HM)
-  {
-    DEBUG_COMPRESSED(
-        "playlistItemCompressedVideo::allocateDecoder Initializing interactive HM decoder");
-    loadingDecoder.reset(new decoder::decoderHM(displayComponent));
-    if (cachingEnabled)
+  this->forEachCachingDecoder([](CachingDecoder &cachingDecoder) {
+    cachingDecoder.decoder.reset();
+    cachingDecoder.context.decoder = nullptr;
+  });
+
+  // Create a decoder for loading (or caching if a caching file source is given)
+  auto createDecoder = [this, displayComponent](
+                           FileSourceFFmpegFile *cachingFileFFmpeg,
+                           bool                  caching) -> decoder::decoderBase * {
+    if (this->decoderEngine == DecoderEngine::Libde265)
+      return new decoder::decoderLibde265(displayComponent, caching);
+    if (this->decoderEngine == DecoderEngine::HM)
+      return new decoder::decoderHM(displayComponent, caching);
+    if (this->decoderEngine == DecoderEngine::VTM)
+      return new decoder::decoderVTM(displayComponent, caching);
+    if (this->decoderEngine == DecoderEngine::VVDec)
+      return new decoder::decoderVVDec(displayComponent, caching);
+    if (this->decoderEngine == DecoderEngine::Dav1d)
+      return new decoder::decoderDav1d(displayComponent, caching);
+    if (this->decoderEngine == DecoderEngine::FFMpeg)
     {
-      DEBUG_COMPRESSED(
-          "playlistItemCompressedVideo::allocateDecoder caching interactive HM decoder");
-      cachingDecoder.reset(new decoder::decoderHM(displayComponent, true));
-    }
-  }
-  else if (this->decoderEngine == DecoderEngine::VTM)
-  {
-    DEBUG_COMPRESSED(
-        "playlistItemCompressedVideo::allocateDecoder Initializing interactive VTM decoder");
-    loadingDecoder.reset(new decoder::decoderVTM(displayComponent));
-    if (cachingEnabled)
-    {
-      DEBUG_COMPRESSED(
-          "playlistItemCompressedVideo::allocateDecoder caching interactive VTM decoder");
-      cachingDecoder.reset(new decoder::decoderVTM(displayComponent, true));
-    }
-  }
-  else if (this->decoderEngine == DecoderEngine::VVDec)
-  {
-    DEBUG_COMPRESSED(
-        "playlistItemCompressedVideo::allocateDecoder Initializing interactive VVDec decoder");
-    loadingDecoder.reset(new decoder::decoderVVDec(displayComponent));
-    if (cachingEnabled)
-    {
-      DEBUG_COMPRESSED(
-          "playlistItemCompressedVideo::allocateDecoder caching interactive VVDec decoder");
-      cachingDecoder.reset(new decoder::decoderVVDec(displayComponent, true));
-    }
-  }
-  else if (this->decoderEngine == DecoderEngine::Dav1d)
-  {
-    DEBUG_COMPRESSED(
-        "playlistItemCompressedVideo::allocateDecoder Initializing interactive dav1d decoder");
-    loadingDecoder.reset(new decoder::decoderDav1d(displayComponent));
-    if (cachingEnabled)
-    {
-      DEBUG_COMPRESSED(
-          "playlistItemCompressedVideo::allocateDecoder caching interactive dav1d decoder");
-      cachingDecoder.reset(new decoder::decoderDav1d(displayComponent, true));
-    }
-  }
-  else if (this->decoderEngine == DecoderEngine::FFMpeg)
-  {
-    if (isInputFormatTypeAnnexB(this->inputFormat))
-    {
-      auto frameSize    = inputFileAnnexBParser->getSequenceSizeSamples();
-      auto extradata    = inputFileAnnexBParser->getExtradata();
-      auto fmt          = inputFileAnnexBParser->getPixelFormat();
-      auto profileLevel = inputFileAnnexBParser->getProfileLevel();
-      auto ratio        = inputFileAnnexBParser->getSampleAspectRatio();
-
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive "
-                       "ffmpeg decoder from raw anexB stream. frameSize "
-                       << frameSize.width << "x" << frameSize.height << " extradata length "
-                       << extradata.length() << " PixelFormatYUV "
-                       << QString::fromStdString(fmt.getName()) << " profile/level "
-                       << profileLevel.first << "/" << profileLevel.second << ", aspect raio "
-                       << ratio.num << "/" << ratio.den);
-      loadingDecoder.reset(
-          new decoder::decoderFFmpeg(ffmpegCodec, frameSize, extradata, fmt, profileLevel, ratio));
-      if (cachingEnabled)
+      if (isInputFormatTypeAnnexB(this->inputFormat))
       {
-        DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing caching ffmpeg "
-                         "decoder from raw anexB stream. Same settings.");
-        cachingDecoder.reset(new decoder::decoderFFmpeg(
-            ffmpegCodec, frameSize, extradata, fmt, profileLevel, ratio, true));
+        auto frameSize    = inputFileAnnexBParser->getSequenceSizeSamples();
+        auto extradata    = inputFileAnnexBParser->getExtradata();
+        auto fmt          = inputFileAnnexBParser->getPixelFormat();
+        auto profileLevel = inputFileAnnexBParser->getProfileLevel();
+        auto ratio        = inputFileAnnexBParser->getSampleAspectRatio();
+
+        DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing "
+                         "ffmpeg decoder from raw anexB stream. frameSize "
+                         << frameSize.width << "x" << frameSize.height << " extradata length "
+                         << extradata.length() << " PixelFormatYUV "
+                         << QString::fromStdString(fmt.getName()) << " profile/level "
+                         << profileLevel.first << "/" << profileLevel.second << ", aspect raio "
+                         << ratio.num << "/" << ratio.den);
+        return new decoder::decoderFFmpeg(
+            ffmpegCodec, frameSize, extradata, fmt, profileLevel, ratio, caching);
       }
-    }
-    else
-    {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive "
+
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing "
                        "ffmpeg decoder using ffmpeg as parser");
-      loadingDecoder.reset(new decoder::decoderFFmpeg(inputFileFFmpegLoading->getVideoCodecPar()));
-      if (cachingEnabled)
-      {
-        DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing caching ffmpeg "
-                         "decoder using ffmpeg as parser");
-        cachingDecoder.reset(
-            new decoder::decoderFFmpeg(inputFileFFmpegCaching->getVideoCodecPar()));
-      }
+      auto inputFile = caching ? cachingFileFFmpeg : inputFileFFmpegLoading.data();
+      return new decoder::decoderFFmpeg(inputFile->getVideoCodecPar());
     }
-  }
-  else
+    return nullptr;
+  };
+
+  DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive "
+                   << QString::fromStdString(DecoderEngineMapper.getName(this->decoderEngine))
+                   << " decoder");
+  loadingDecoder.reset(createDecoder(nullptr, false));
+  if (!loadingDecoder)
   {
     infoText        = "No valid decoder was selected.";
     decodingEnabled = false;
     return false;
   }
 
+  this->loadingContext.decoder         = loadingDecoder.data();
+  this->loadingContext.inputFileAnnexB = inputFileAnnexBLoading.data();
+  this->loadingContext.inputFileFFmpeg = inputFileFFmpegLoading.data();
+
+  if (cachingEnabled)
+  {
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing "
+                     << this->cachingDecoders.size() << " caching decoders");
+    this->forEachCachingDecoder([&createDecoder](CachingDecoder &cachingDecoder) {
+      cachingDecoder.decoder.reset(createDecoder(cachingDecoder.inputFileFFmpeg.get(), true));
+      auto &context                    = cachingDecoder.context;
+      context.decoder                  = cachingDecoder.decoder.get();
+      context.inputFileAnnexB          = cachingDecoder.inputFileAnnexB.get();
+      context.inputFileFFmpeg          = cachingDecoder.inputFileFFmpeg.get();
+      context.caching                  = true;
+      context.currentFrameIdx          = -1;
+      context.decodingNotPossibleAfter = -1;
+    });
+  }
+
   decodingEnabled = loadingDecoder->state() != decoder::DecoderState::Error;
   if (!decodingEnabled)
   {
@@ -1095,18 +1374,33 @@ void playlistItemCompressedVideo::loadStatistics(int frameIdx)
     // We have to enable collecting of statistics in the decoder. By default (for speed reasons)
     // this is off. Enabeling works like this: Enable collection, reset the decoder and decode the
     // current frame again. Statisitcs are always retrieved for the loading decoder.
-    loadingDecoder->enableStatisticsRetrieval(&this->statisticsData);
+    loadingDecoder->enableStatisticsRetrieval(&this->loadingContext.statisticsData);
     DEBUG_COMPRESSED("playlistItemCompressedVideo::loadStatistics Enable loading of stats frame "
                      << frameIdx);
 
+    // The caching decoders also retrieve statistics from now on. These fill the frame cache of
+    // the statistics so that they don't have to be decoded again while playing.
+    this->forEachCachingDecoder([](CachingDecoder &cachingDecoder) {
+      if (cachingDecoder.decoder)
+        cachingDecoder.decoder->enableStatisticsRetrieval(&cachingDecoder.context.statisticsData);
+    });
+
     // Reload the current frame (force a seek and decode operation)
-    int frameToLoad    = currentFrameIdx[0];
-    currentFrameIdx[0] = -1;
+    int frameToLoad                      = this->loadingContext.currentFrameIdx;
+    this->loadingContext.currentFrameIdx = -1;
+    this->loadingContext.rawDataFrameIdx = -1;
     this->loadRawData(frameToLoad, false);
 
     // The statistics should now be loaded
   }
-  else if (frameIdx != currentFrameIdx[0])
+  else if (this->statisticsData.isFrameCached(frameIdx))
+  {
+    // The statistics of the frame were decoded before (e.g. by a caching decoder)
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::loadStatistics Take stats of frame "
+                     << frameIdx << " from the cache");
+    this->statisticsData.setFrameIndex(frameIdx);
+  }
+  else if (frameIdx != this->loadingContext.currentFrameIdx)
   {
     // If the requested frame is not currently decoded, decode it.
     // This can happen if the picture was gotten from the cache.
@@ -1203,20 +1497,22 @@ void playlistItemCompressedVideo::reloadItemSource()
   // decode the frame again.
   video->invalidateAllBuffers();
 
+  // The file may have changed on disk
+  this->updateDiskCacheSequenceKey();
+
   // Load frame 0. This will decode the first frame in the sequence and set the
   // correct frame size/YUV format.
   loadRawData(0, false);
 }
 
-void playlistItemCompressedVideo::cacheFrame(int frameIdx, bool testMode)
+std::function<void()> playlistItemCompressedVideo::cacheFrame(int frameIdx, bool testMode)
 {
   if (!cachingEnabled)
-    return;
+    return {};
 
-  // Cache a certain frame. This is always called in a separate thread.
-  cachingMutex.lock();
-  video->cacheFrame(frameIdx, testMode);
-  cachingMutex.unlock();
+  // Cache a certain frame. This is always called in a separate thread. The video handler gets the
+  // raw data from decodeFrameForCaching which selects one of the caching decoders.
+  return video->cacheFrame(frameIdx, testMode);
 }
 
 void playlistItemCompressedVideo::loadFrame(int  frameIdx,
@@ -1275,19 +1571,23 @@ void playlistItemCompressedVideo::displaySignalComboBoxChanged(int idx)
 {
   if (loadingDecoder && idx != loadingDecoder->getDecodeSignal())
   {
-    bool resetDecoder = false;
-    loadingDecoder->setDecodeSignal(idx, resetDecoder);
-    cachingDecoder->setDecodeSignal(idx, resetDecoder);
-
-    if (resetDecoder)
-    {
-      loadingDecoder->resetDecoder();
-      cachingDecoder->resetDecoder();
-
-      // Reset the decoded frame indices so that decoding of the current frame is triggered
-      currentFrameIdx[0] = -1;
-      currentFrameIdx[1] = -1;
-    }
+    auto setDecodeSignal = [idx](DecodingContext &context) {
+      bool resetDecoder = false;
+      context.decoder->setDecodeSignal(idx, resetDecoder);
+      if (resetDecoder)
+      {
+        context.decoder->resetDecoder();
+        // Reset the decoded frame index so that decoding of the current frame is triggered
+        context.currentFrameIdx = -1;
+      }
+      // The raw data of the last decoded frame is of the old signal
+      context.rawDataFrameIdx = -1;
+    };
+    setDecodeSignal(this->loadingContext);
+    this->forEachCachingDecoder([&setDecodeSignal](CachingDecoder &cachingDecoder) {
+      setDecodeSignal(cachingDecoder.context);
+    });
+    this->updateDiskCacheSequenceKey();
 
     // A different display signal was chosen. Invalidate the cache and signal that we will need a
     // redraw.
@@ -1307,6 +1607,7 @@ void playlistItemCompressedVideo::decoderComboxBoxChanged(int idx)
     // Allocate a new decoder of the new type
     this->decoderEngine = e;
     this->allocateDecoder();
+    this->updateDiskCacheSequenceKey();
 
     // A different display signal was chosen. Invalidate the cache and signal that we will need a
     // redraw.
@@ -1315,11 +1616,11 @@ void playlistItemCompressedVideo::decoderComboxBoxChanged(int idx)
       yuvVideo->showPixelValuesAsDiff = loadingDecoder->isSignalDifference(idx);
     yuvVideo->invalidateAllBuffers();
 
-    // Reset the decoded frame indices so that decoding of the current frame is triggered
-    currentFrameIdx[0] = -1;
-    currentFrameIdx[1] = -1;
-
-    this->decodingNotPossibleAfter = -1;
+    // Reset the decoded frame indices so that decoding of the current frame is triggered. The
+    // decoders were reallocated so no raw data is kept.
+    this->loadingContext.currentFrameIdx          = -1;
+    this->loadingContext.rawDataFrameIdx          = -1;
+    this->loadingContext.decodingNotPossibleAfter = -1;
 
     // Update the list of display signals
     if (loadingDecoder)
@@ -32,10 +32,19 @@
 
 #pragma once
 
+#include <QBasicTimer>
+#include <QFuture>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
 #include <common/Typedef.h>
 #include <decoder/decoderBase.h>
 #include <filesource/FileSourceFFmpegFile.h>
 #include <parser/AnnexB.h>
+#include <parser/AnnexBFromIndex.h>
 #include <statistics/StatisticUIHandler.h>
 #include <statistics/StatisticsData.h>
 #include <ui_playlistItemCompressedFile.h>
@@ -62,6 +71,7 @@ public:
                               int                    displayComponent = 0,
                               InputFormat            input            = InputFormat::Invalid,
                               decoder::DecoderEngine decoder = decoder::DecoderEngine::Invalid);
+  virtual ~playlistItemCompressedVideo();
 
   // Save the compressed file element to the given XML structure.
   virtual void savePlaylist(QDomElement &root, const QDir &playlistDir) const override;
@@ -93,7 +103,10 @@ public:
   }
   virtual void reloadItemSource() override;
   virtual void updateSettings() override
-  { /* TODO loadingDecoder->updateFileWatchSetting(); statSource.updateSettings(); */
+  {
+    /* TODO loadingDecoder->updateFileWatchSetting(); statSource.updateSettings(); */
+    playlistItemWithVideo::updateSettings();
+    this->statisticsData.updateSettings();
   }
 
   // Do we need to load the given frame first?
@@ -105,26 +118,92 @@ public:
   virtual bool isLoading() const override { return isFrameLoading; }
   virtual bool isLoadingDoubleBuffer() const override { return isFrameLoadingDoubleBuffer; }
 
-  // Cache the frame with the given index.
-  // For all compressed items, a mutex must be locked when caching a frame (only one frame can be
-  // cached at a time because we only have one decoder).
-  void cacheFrame(int idx, bool testMode) override;
+  // Cache the frame with the given index. Each caching thread uses one of the caching decoders. The
+  // decoder is free again when the frame was decoded. The conversion of the frame is returned.
+  std::function<void()> cacheFrame(int idx, bool testMode) override;
+
+  // Every caching decoder can decode one segment (starting at a random access point) of the
+  // sequence. More caching threads would only have to wait for a decoder.
+  virtual int cachingThreadLimit() override
+  {
+    return std::max(int(this->cachingDecoders.size()), 1);
+  }
 
-  // We only have one caching decoder so it is better if only one thread caches frames from this
-  // item. This way, the frames will always be cached in the right order and no unnecessary decoding
-  // is performed.
-  virtual int cachingThreadLimit() override { return 1; }
+  virtual std::vector<int> getRandomAccessPoints() const override
+  {
+    return this->randomAccessPoints;
+  }
 
   InputFormat getInputFormat() const { return this->inputFormat; }
 
+  // If the file is still parsed in the background, wait until parsing is done and all frames are
+  // known. Usually, the frame range grows while the file is parsed.
+  void waitForBackgroundParsing();
+  // Get the frames (in coding order with their position in the file) of a raw Annex B file. For
+  // files that are read using ffmpeg, the index is empty.
+  FileIndex getFileIndex() const;
+
 protected:
   virtual void createPropertiesWidget() override;
 
-  // We allocate two decoder: One for loading images in the foreground and one for caching in the
-  // background. This is better if random access and linear decoding (caching) is performed at the
-  // same time.
+  // We allocate one decoder for loading images in the foreground and one or more decoders for
+  // caching in the background. This is better if random access and linear decoding (caching) is
+  // performed at the same time.
   QScopedPointer<decoder::decoderBase> loadingDecoder;
-  QScopedPointer<decoder::decoderBase> cachingDecoder;
+
+  // The state of one decoder and the file that it reads from. The loading decoder and every caching
+  // decoder have their own.
+  struct DecodingContext
+  {
+    decoder::decoderBase *decoder{};
+    FileSourceAnnexBFile *inputFileAnnexB{};
+    FileSourceFFmpegFile *inputFileFFmpeg{};
+    bool                  caching{};
+    // The index of the last frame that the decoder output
+    int currentFrameIdx{-1};
+    // When reading annex B data using the FileSourceAnnexBFile::getFrameData function, we need to
+    // count how many frames we already read.
+    int readAnnexBFrameCounterCodingOrder{-1};
+    // For certain decoders (FFmpeg or HM), pushing data may fail. The decoder may or may not
+    // switch to retrieveing mode. In this case, we must re-push the packet for which pushing
+    // failed.
+    bool repushData{};
+    // The raw data of the last frame that was output by the decoder
+    video::FrameBuffer rawData;
+    int                rawDataFrameIdx{-1};
+    // The decoder writes the statistics of the frame that it decodes here. For the requested
+    // frame, they are moved to the statisticsData (the current frame or its frame cache).
+    stats::StatisticsData statisticsData;
+    // If the bitstream is invalid (for example it was cut at a position that it should not be cut
+    // at), the decoder might be unable to decode some of the frames at the end of the sequence.
+    // Only the thread that uses the context sets it. The value of the loading context is also
+    // read by the GUI thread.
+    std::atomic_int decodingNotPossibleAfter{-1};
+  };
+  DecodingContext loadingContext;
+
+  // The caching decoders. Each caching thread takes a decoder that is not in use. It prefers the
+  // decoder that can continue decoding without seeking.
+  struct CachingDecoder
+  {
+    std::unique_ptr<decoder::decoderBase> decoder;
+    std::unique_ptr<FileSourceAnnexBFile> inputFileAnnexB;
+    std::unique_ptr<FileSourceFFmpegFile> inputFileFFmpeg;
+    DecodingContext                       context;
+    bool                                  inUse{};
+    int64_t                               lastUsed{};
+  };
+  std::vector<std::unique_ptr<CachingDecoder>> cachingDecoders;
+  int64_t                                      cachingDecoderUseCounter{0};
+
+  // Get a caching decoder for decoding the given frame. Wait if all decoders are in use.
+  CachingDecoder *acquireCachingDecoder(int frameIdx);
+  void            releaseCachingDecoder(CachingDecoder *cachingDecoder);
+  // Wait until no caching decoder is in use and call the function for each of them
+  void forEachCachingDecoder(std::function<void(CachingDecoder &cachingDecoder)> function);
+  // Decode the given frame with one of the caching decoders. This is the raw data source that the
+  // videoHandler uses for caching.
+  bool decodeFrameForCaching(int frameIdx, video::FrameBuffer &rawData);
 
   // When opening the file, we will fill this list with the possible decoders
   std::vector<decoder::DecoderEngine> possibleDecoders;
@@ -134,15 +213,32 @@ protected:
   bool allocateDecoder(int displayComponent = 0);
 
   // In order to parse raw annexB files, we need a file reader (that can read NAL units)
-  // and a parser that can understand what the NAL units mean. We open the file source twice (once
-  // for interactive loading, once for the background caching). The parser is only needed once and
-  // can be used for both loading and caching tasks.
+  // and a parser that can understand what the NAL units mean. We open the file source once for
+  // interactive loading and once for every caching decoder. The parser is only needed once and can
+  // be used for both loading and caching tasks.
   QScopedPointer<FileSourceAnnexBFile> inputFileAnnexBLoading;
-  QScopedPointer<FileSourceAnnexBFile> inputFileAnnexBCaching;
   QScopedPointer<parser::AnnexB>       inputFileAnnexBParser;
-  // When reading annex B data using the FileSourceAnnexBFile::getFrameData function, we need to
-  // count how many frames we already read.
-  int readAnnexBFrameCounterCodingOrder{-1};
+
+  // If there is no file index for the file yet, the file is parsed in the background. The parser
+  // adds the frames that are final to a file index and the inputFileAnnexBParser is created from
+  // this index as soon as the first frames are known. More frames are added to it while the rest of
+  // the file is parsed so that decoding can start before the whole file was parsed.
+  std::unique_ptr<parser::AnnexB>      backgroundParser;
+  QScopedPointer<FileSourceAnnexBFile> backgroundParserFile;
+  FileIndex                            backgroundParserIndex;
+  QFuture<void>                        backgroundParserFuture;
+  parser::AnnexBFromIndex *            backgroundParserIndexParser{};
+  bool                                 backgroundParserDone{};
+  QMutex                               backgroundParserMutex;
+  QWaitCondition                       backgroundParserFramesAvailable;
+  // Start parsing and wait until the first frames are known (or parsing is done)
+  void startBackgroundParsing(const QString &filePath, const QString &indexType, QWidget *mainWindow);
+
+  // While the file is parsed in the background, this timer is used to regularly update the frame
+  // range from the frames that were parsed so far.
+  QBasicTimer  backgroundParserTimer;
+  virtual void timerEvent(QTimerEvent *event) override;
+  void         updateFromBackgroundParser();
 
   // Which type is the input?
   InputFormat      inputFormat;
@@ -151,16 +247,15 @@ protected:
   // For FFMpeg files we don't need a reader to parse them. But if the container contains a
   // supported format, we can read the NAL units from the compressed file.
   QScopedPointer<FileSourceFFmpegFile> inputFileFFmpegLoading;
-  QScopedPointer<FileSourceFFmpegFile> inputFileFFmpegCaching;
 
   // Is the loadFrame function currently loading?
   bool isFrameLoading{};
   bool isFrameLoadingDoubleBuffer{};
 
-  // Only cache one frame at a time. Caching should also always be done in display order of the
-  // frames.
-  // TODO: Could we somehow make shure that caching is always performed in display order?
-  QMutex cachingMutex;
+  // Protects the selection of the caching decoders and the disk cache sequence key. A caching
+  // thread waits for a free decoder if all are in use.
+  QMutex         cachingMutex;
+  QWaitCondition cachingDecoderReleased;
 
   stats::StatisticUIHandler statisticsUIHandler;
   stats::StatisticsData     statisticsData;
@@ -170,16 +265,22 @@ protected:
 
   SafeUi<Ui::playlistItemCompressedFile_Widget> ui;
 
-  // The current frame index of the decoders (interactive/caching)
-  int currentFrameIdx[2]{-1, -1};
+  // The frames where decoding can start (in display order). This is set when the file is opened.
+  std::vector<int> randomAccessPoints;
 
   // Seek the input file to the given position, reset the decoder and prepare it to start decoding
   // from the given position.
-  void seekToPosition(int seekToFrame, int64_t seekToDTS, bool caching);
+  void seekToPosition(DecodingContext &context, int seekToFrame, int64_t seekToDTS);
+
+  // Decode the given frame using the decoder of the given context. Return false if the frame could
+  // not be decoded.
+  bool decodeFrame(DecodingContext &context, int frameIdx, video::FrameBuffer &rawData);
 
-  // For certain decoders (FFmpeg or HM), pushing data may fail. The decoder may or may not switch
-  // to retrieveing mode. In this case, we must re-push the packet for which pushing failed.
-  bool repushData{};
+  // The key of the decoded frames in the disk frame cache. The key contains all settings that
+  // have an influence on the decoded raw data. It is calculated when the file is opened and must be
+  // updated when the file is reloaded or the decoder settings change.
+  QString diskCacheSequenceKey;
+  void    updateDiskCacheSequenceKey();
 
   // Besides the normal stats (error / no error) this item might be able to parse the file but not
   // to decode it.
@@ -190,10 +291,6 @@ protected:
   }
   bool decodingEnabled{};
 
-  // If the bitstream is invalid (for example it was cut at a position that it should not be cut
-  // at), we might be unable to decode some of the frames at the end of the sequence.
-  int decodingNotPossibleAfter{-1};
-
 private slots:
   // Load the raw (YUV or RGN) data for the given frame index from file. This slot is called by the
   // videoHandler if the frame that is requested to be drawn has not been loaded yet.
@@ -36,6 +36,8 @@
 #include <QUrl>
 #include <QVBoxLayout>
 
+#include <cstdlib>
+
 #include <common/Functions.h>
 #include <common/FunctionsGui.h>
 #include <handler/ItemMemoryHandler.h>
@@ -48,6 +50,11 @@
 #define DEBUG_RAWFILE(fmt, ...) ((void)0)
 #endif
 
+// If frames are loaded with a step of at most MAX_READ_AHEAD_STEP frames (in any direction), the
+// next NR_READ_AHEAD_FRAMES frames in that direction are read from disk in the background.
+#define MAX_READ_AHEAD_STEP 8
+#define NR_READ_AHEAD_FRAMES 2
+
 playlistItemRawFile::playlistItemRawFile(const QString &rawFilePath,
                                          const QSize    qFrameSize,
                                          const QString &sourcePixelFormat,
@@ -60,6 +67,8 @@ playlistItemRawFile::playlistItemRawFile(const QString &rawFilePath,
   this->prop.isFileSource          = true;
   this->prop.propertiesWidgetTitle = "Raw File Properties";
 
+  this->dataSource.enableMemoryMapping();
+  this->dataSource.enableReadAhead();
   this->dataSource.openFile(rawFilePath);
 
   if (!this->dataSource.isOk())
@@ -132,6 +141,15 @@ playlistItemRawFile::playlistItemRawFile(const QString &rawFilePath,
           this,
           &playlistItemRawFile::loadRawData,
           Qt::DirectConnection);
+  // The caching threads can read frames in parallel. If the file is memory mapped, no data is
+  // copied at all.
+  this->video->setCachingRawDataSource([this](int frameIdx, video::FrameBuffer &rawData) {
+    QByteArray frameData;
+    if (!this->readFrame(frameIdx, frameData))
+      return false;
+    rawData = video::FrameBuffer(frameData);
+    return true;
+  });
 
   // Connect the basic signals from the video
   playlistItemWithVideo::connectVideo();
@@ -475,25 +493,53 @@ playlistItemRawFile *playlistItemRawFile::newplaylistItemRawFile(const YUViewDom
   return newFile;
 }
 
-void playlistItemRawFile::loadRawData(int frameIdx)
+int64_t playlistItemRawFile::getFrameFilePos(int frameIdx) const
+{
+  if (this->isY4MFile)
+  {
+    if (frameIdx < 0 || frameIdx >= this->y4mFrameIndices.count())
+      return -1;
+    return int64_t(this->y4mFrameIndices.at(frameIdx));
+  }
+  return frameIdx * this->video->getBytesPerFrame();
+}
+
+bool playlistItemRawFile::readFrame(int frameIdx, QByteArray &rawData)
 {
   if (!this->video->isFormatValid())
-    return;
+    return false;
 
-  auto nrBytes = this->video->getBytesPerFrame();
+  const auto nrBytes      = this->video->getBytesPerFrame();
+  const auto fileStartPos = this->getFrameFilePos(frameIdx);
+  if (fileStartPos < 0)
+    return false;
 
-  // Load the raw data for the given frameIdx from file and set it in the video
-  int64_t fileStartPos;
-  if (this->isY4MFile)
-    fileStartPos = this->y4mFrameIndices.at(frameIdx);
-  else
-    fileStartPos = frameIdx * nrBytes;
+  DEBUG_RAWFILE("playlistItemRawFile::readFrame frame %d bytes %d", frameIdx, int(nrBytes));
+  return this->dataSource.readBytesZeroCopy(rawData, fileStartPos, nrBytes) >= nrBytes;
+}
 
-  DEBUG_RAWFILE("playlistItemRawFile::loadRawData frame %d bytes %d", frameIdx, int(nrBytes));
-  if (this->dataSource.readBytes(this->video->rawData, fileStartPos, nrBytes) < nrBytes)
+void playlistItemRawFile::loadRawData(int frameIdx)
+{
+  // Load the raw data for the given frameIdx from file and set it in the video
+  if (!this->readFrame(frameIdx, this->video->rawData))
     return; // Error
   this->video->rawData_frameIndex = frameIdx;
 
+  // Frames are usually loaded one after the other in a certain direction and with a certain
+  // step (playback). Let the operating system read the next frames in the background.
+  const auto step = frameIdx - this->lastLoadedFrameIdx;
+  this->lastLoadedFrameIdx = frameIdx;
+  if (step != 0 && std::abs(step) <= MAX_READ_AHEAD_STEP)
+  {
+    const auto nrBytes = this->video->getBytesPerFrame();
+    for (int i = 1; i <= NR_READ_AHEAD_FRAMES; i++)
+    {
+      const auto nextFrameFilePos = this->getFrameFilePos(frameIdx + i * step);
+      if (nextFrameFilePos >= 0)
+        this->dataSource.adviseReadAhead(nextFrameFilePos, nrBytes, step > 0);
+    }
+  }
+
   DEBUG_RAWFILE("playlistItemRawFile::loadRawData %d Done", frameIdx);
 }
 
@@ -76,14 +76,18 @@ public:
   // ----- Detection of source/file change events -----
   virtual bool isSourceChanged() override { return this->dataSource.getAndResetFileChangedFlag(); }
   virtual void reloadItemSource() override;
-  virtual void updateSettings() override { this->dataSource.updateFileWatchSetting(); }
+  virtual void updateSettings() override
+  {
+    this->dataSource.updateFileWatchSetting();
+    playlistItemWithVideo::updateSettings();
+  }
 
   // Cache the given frame
-  virtual void cacheFrame(int idx, bool testMode) override
+  virtual std::function<void()> cacheFrame(int idx, bool testMode) override
   {
     if (testMode)
       dataSource.clearFileCache();
-    playlistItemWithVideo::cacheFrame(idx, testMode);
+    return playlistItemWithVideo::cacheFrame(idx, testMode);
   }
 
 private slots:
@@ -107,6 +111,15 @@ private:
 
   FileSource dataSource;
 
+  // Get the position of the given frame in the file (-1 if the frame does not exist)
+  int64_t getFrameFilePos(int frameIdx) const;
+  // Read the raw data of the frame from the file. If the file is memory mapped, the data is not
+  // copied.
+  bool readFrame(int frameIdx, QByteArray &rawData);
+  // The last frame loaded by loadRawData. Used to find out in which direction and with which step
+  // the frames are loaded.
+  int lastLoadedFrameIdx{-1};
+
   void updateStartEndRange() override;
 
   // A y4m file is a raw YUV file but it adds a header (which has information about the YUV format)
@@ -42,6 +42,7 @@
 #include <common/YUViewDomElement.h>
 #include <common/FunctionsGui.h>
 #include <statistics/StatisticsDataPainting.h>
+#include <statistics/StatisticsFileBinary.h>
 #include <statistics/StatisticsFileCSV.h>
 #include <statistics/StatisticsFileVTMBMS.h>
 
@@ -57,6 +58,10 @@
 // idea anyways)
 #define STAT_PARSING_BUFFER_SIZE 1048576
 
+// The number of frames after the current playback position that are prefetched during playback.
+// Prefetching stops earlier if the statistics frame cache is full.
+#define STAT_PREFETCH_FRAMES 16
+
 playlistItemStatisticsFile::playlistItemStatisticsFile(const QString &itemNameOrFileName,
                                                        OpenMode       openMode)
     : playlistItem(itemNameOrFileName, Type::Indexed), openMode(openMode)
@@ -72,6 +77,7 @@ playlistItemStatisticsFile::playlistItemStatisticsFile(const QString &itemNameOr
   // Set statistics icon
   setIcon(0, functionsGui::convertIcon(":img_stats.png"));
 
+  this->statisticsData.updateSettings();
   this->openStatisticsFile();
   this->statisticsUIHandler.setStatisticsData(&this->statisticsData);
 
@@ -82,6 +88,7 @@ playlistItemStatisticsFile::playlistItemStatisticsFile(const QString &itemNameOr
 
 playlistItemStatisticsFile::~playlistItemStatisticsFile()
 {
+  this->stopPrefetching();
   if (this->backgroundParserFuture.isRunning())
   {
     // signal to background thread that we want to cancel the processing
@@ -126,6 +133,7 @@ playlistItemStatisticsFile *playlistItemStatisticsFile::newplaylistItemStatistic
 
 void playlistItemStatisticsFile::reloadItemSource()
 {
+  this->stopPrefetching();
   this->currentDrawnFrameIdx = -1;
 
   this->statisticsData.clear();
@@ -179,7 +187,7 @@ QSize playlistItemStatisticsFile::getSize() const
   return QSize(s.width, s.height);
 }
 
-void playlistItemStatisticsFile::loadFrame(int frameIdx, bool, bool, bool emitSignals)
+void playlistItemStatisticsFile::loadFrame(int frameIdx, bool playback, bool, bool emitSignals)
 {
   DEBUG_STAT("playlistItemStatisticsFile::loadFrame frameIdx %d", frameIdx);
 
@@ -187,14 +195,25 @@ void playlistItemStatisticsFile::loadFrame(int frameIdx, bool, bool, bool emitSi
   {
     this->isStatisticsLoading = true;
     {
+      // Types of the frame that were prefetched (or loaded before) are taken from the cache
+      this->statisticsData.setFrameIndex(frameIdx);
       auto typesToLoad = this->statisticsData.getTypesThatNeedLoading(frameIdx);
-      for (auto typeID : typesToLoad)
-        this->file->loadStatisticData(this->statisticsData, frameIdx, typeID);
+      if (!typesToLoad.empty())
+      {
+        QMutexLocker locker(&this->fileMutex);
+        for (auto typeID : typesToLoad)
+          // Some files (e.g. CSV files sorted by POC) load all types of a frame at once
+          if (!this->statisticsData.hasDataForTypeID(typeID))
+            this->file->loadStatisticData(this->statisticsData, frameIdx, typeID);
+      }
     }
     this->isStatisticsLoading = false;
     if (emitSignals)
       emit SignalItemChanged(true, RECACHE_NONE);
   }
+
+  if (playback)
+    this->startPrefetching(frameIdx);
 }
 
 ValuePairListSets playlistItemStatisticsFile::getPixelValues(const QPoint &pixelPos, int frameIdx)
@@ -211,6 +230,7 @@ bool playlistItemStatisticsFile::isSourceChanged()
 void playlistItemStatisticsFile::updateSettings()
 {
   this->statisticsUIHandler.updateSettings();
+  this->statisticsData.updateSettings();
   if (this->file)
     this->file->updateSettings();
 }
@@ -220,12 +240,16 @@ void playlistItemStatisticsFile::getSupportedFileExtensions(QStringList &allExte
 {
   allExtensions.append("vtmbmsstats");
   allExtensions.append("csv");
+  allExtensions.append("yuvstats");
   filters.append("Statistics File (*.vtmbmsstats)");
   filters.append("Statistics File (*.csv)");
+  filters.append("Binary Statistics File (*.yuvstats)");
 }
 
 void playlistItemStatisticsFile::onPOCTypeParsed(int poc, int typeID)
 {
+  // Data of the POC that was cached while parsing may be incomplete
+  this->statisticsData.eraseCachedFrame(poc);
   if (poc == this->currentDrawnFrameIdx && this->statisticsData.hasDataForTypeID(typeID))
   {
     this->statisticsData.eraseDataForTypeID(typeID);
@@ -235,6 +259,7 @@ void playlistItemStatisticsFile::onPOCTypeParsed(int poc, int typeID)
 
 void playlistItemStatisticsFile::onPOCParsed(int poc)
 {
+  this->statisticsData.eraseCachedFrame(poc);
   if (poc == this->currentDrawnFrameIdx)
     emit SignalItemChanged(true, RECACHE_NONE);
 
@@ -272,6 +297,7 @@ void playlistItemStatisticsFile::openStatisticsFile()
     this->breakBackgroundAtomic.store(true);
     this->backgroundParserFuture.waitForFinished();
   }
+  this->stopPrefetching();
 
   auto suffix = QFileInfo(this->prop.name).suffix();
   if (this->openMode == OpenMode::CSVFile ||
@@ -280,6 +306,8 @@ void playlistItemStatisticsFile::openStatisticsFile()
   else if (this->openMode == OpenMode::VTMBMSFile ||
            (this->openMode == OpenMode::Extension && suffix == "vtmbmsstats"))
     this->file.reset(new stats::StatisticsFileVTMBMS(this->prop.name, this->statisticsData));
+  else if (this->openMode == OpenMode::Extension && suffix == "yuvstats")
+    this->file.reset(new stats::StatisticsFileBinary(this->prop.name, this->statisticsData));
   else
     assert(false);
 
@@ -321,3 +349,73 @@ void playlistItemStatisticsFile::timerEvent(QTimerEvent *event)
     this->prop.startEndRange = indexRange(0, this->file->getMaxPoc());
   emit SignalItemChanged(false, RECACHE_NONE);
 }
+
+void playlistItemStatisticsFile::startPrefetching(int frameIdx)
+{
+  QMutexLocker locker(&this->prefetchMutex);
+
+  // The positions of the frames in the file are only complete once the background parser is done
+  if (!this->file || this->backgroundParserFuture.isRunning() ||
+      this->statisticsData.getCacheSizeLimit() == 0)
+    return;
+
+  this->prefetchFrameIdx.store(frameIdx);
+  if (!this->prefetchFuture.isRunning())
+  {
+    DEBUG_STAT("playlistItemStatisticsFile::startPrefetching frameIdx %d", frameIdx);
+    this->breakPrefetchAtomic.store(false);
+    // The types are copied here so that the prefetching thread does not need the lock. Otherwise,
+    // stopPrefetching could wait for a thread that waits for the lock.
+    auto types           = this->statisticsData.getStatisticsTypes();
+    this->prefetchFuture = QtConcurrent::run([this, types]() { this->prefetchFrames(types); });
+  }
+}
+
+void playlistItemStatisticsFile::stopPrefetching()
+{
+  QMutexLocker locker(&this->prefetchMutex);
+  if (this->prefetchFuture.isRunning())
+  {
+    this->breakPrefetchAtomic.store(true);
+    this->prefetchFuture.waitForFinished();
+  }
+}
+
+void playlistItemStatisticsFile::prefetchFrames(const stats::StatisticsTypesVec &types)
+{
+  // The frames are loaded into a separate data object (so that the current frame is not touched)
+  // and then moved to the frame cache.
+  stats::StatisticsData prefetchData;
+  prefetchData.setFrameSize(this->statisticsData.getFrameSize());
+  for (const auto &type : types)
+    prefetchData.addStatType(type);
+
+  auto startFrameIdx = -1;
+  while (!this->breakPrefetchAtomic.load() && startFrameIdx != this->prefetchFrameIdx.load())
+  {
+    // Start again if the playback position moved on
+    startFrameIdx = this->prefetchFrameIdx.load();
+    for (int i = 1; i <= STAT_PREFETCH_FRAMES; i++)
+    {
+      const auto frameIdx = startFrameIdx + i;
+      if (this->breakPrefetchAtomic.load() || frameIdx > this->file->getMaxPoc())
+        break;
+
+      const auto typesToLoad = this->statisticsData.getTypesThatNeedLoading(frameIdx);
+      if (typesToLoad.empty())
+        continue;
+
+      {
+        QMutexLocker locker(&this->fileMutex);
+        for (auto typeID : typesToLoad)
+          if (!prefetchData.hasDataForTypeID(typeID))
+            this->file->loadStatisticData(prefetchData, frameIdx, typeID);
+      }
+
+      DEBUG_STAT("playlistItemStatisticsFile::prefetchFrames prefetched frame %d", frameIdx);
+      if (!this->statisticsData.cacheFrame(frameIdx, prefetchData.takeFrameData()))
+        // The cache is full of frames that are closer to the playback position
+        break;
+    }
+  }
+}
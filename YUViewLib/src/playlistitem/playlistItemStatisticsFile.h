@@ -34,6 +34,8 @@
 
 #include <QBasicTimer>
 #include <QFuture>
+#include <QMutex>
+#include <atomic>
 #include <memory>
 
 #include "playlistItem.h"
@@ -78,7 +80,7 @@ public:
   virtual ItemLoadingState needsLoading(int frameIdx, bool loadRawdata) override;
 
   // Load the statistics for the given frame. Emit SignalItemChanged(true,false) when done. Always
-  // called from a thread.
+  // called from a thread. During playback, the following frames are prefetched in the background.
   virtual void
   loadFrame(int frameIdx, bool playback, bool loadRawdata, bool emitSignals = true) override;
   // Are statistics currently being loaded?
@@ -122,6 +124,20 @@ protected:
   QFuture<void>    backgroundParserFuture;
   std::atomic_bool breakBackgroundAtomic;
 
+  // The file can only be read by one thread at a time (loading or prefetching)
+  QMutex fileMutex;
+
+  // While playing, the statistics of the frames after the current playback position are loaded in
+  // the background and put into the frame cache of the statisticsData. Prefetching is started by
+  // the loading thread and stopped by the GUI thread. The prefetchMutex protects the future.
+  void             startPrefetching(int frameIdx);
+  void             stopPrefetching();
+  void             prefetchFrames(const stats::StatisticsTypesVec &types);
+  QMutex           prefetchMutex;
+  QFuture<void>    prefetchFuture;
+  std::atomic_bool breakPrefetchAtomic{};
+  std::atomic_int  prefetchFrameIdx{-1};
+
   // A timer is used to frequently update the status of the background process (every second)
   QBasicTimer timer;
   virtual void
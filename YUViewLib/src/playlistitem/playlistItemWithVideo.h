@@ -65,11 +65,11 @@ public:
 
   // -- Caching
   // Cache the given frame
-  virtual void cacheFrame(int frameIdx, bool testMode) override
+  virtual std::function<void()> cacheFrame(int frameIdx, bool testMode) override
   {
     if (!cachingEnabled || unresolvableError)
-      return;
-    video->cacheFrame(frameIdx, testMode);
+      return {};
+    return video->cacheFrame(frameIdx, testMode);
   }
   // Get a list of all cached frames (just the frame indices)
   virtual QList<int> getCachedFrames() const override;
@@ -82,17 +82,32 @@ public:
   {
     return unresolvableError ? 0 : video->getCachingFrameSize();
   }
+  virtual int64_t getCacheSizeInBytes() const override
+  {
+    return unresolvableError ? 0 : video->getCacheSizeInBytes();
+  }
   // Remove the given frame from the cache
   virtual void removeFrameFromCache(int frameIdx) override
   {
     if (video)
       video->removeFrameFromCache(frameIdx);
   }
+  virtual void removeFramesOutsideOfRange(indexRange range) override
+  {
+    if (video)
+      video->removeFramesOutsideOfRange(range);
+  }
   virtual void removeAllFramesFromCache() override
   {
     if (video)
       video->removeAllFrameFromCache();
   }
+  // The caching mode of the video handler depends on the settings
+  virtual void updateSettings() override
+  {
+    if (video)
+      video->updateSettings();
+  }
   // This item is cachable, if caching is enabled and if the raw format is valid (can be cached).
   virtual bool isCachable() const override
   {
@@ -108,6 +123,10 @@ public:
   virtual bool isLoading() const override { return isFrameLoading; }
   virtual bool isLoadingDoubleBuffer() const override { return isFrameLoadingDoubleBuffer; }
 
+  // Did an unresolvable error occur (e.g. opening the file failed)? The reason is in the info text.
+  bool    isError() const { return this->unresolvableError; }
+  QString getErrorText() const { return this->infoText; }
+
 private slots:
   void slotVideoHandlerChanged(bool redrawNeeded, recacheIndicator recache);
 
@@ -32,38 +32,103 @@
 
 #include "FrameTypeData.h"
 
+#include <algorithm>
+
 namespace stats
 {
 
+namespace
+{
+
+template <typename T> size_t getVectorMemorySize(const std::vector<T> &vector)
+{
+  return vector.capacity() * sizeof(T);
+}
+
+} // namespace
+
+void BlockArray::addBlock(unsigned short x, unsigned short y, unsigned short w, unsigned short h)
+{
+  this->posX.push_back(x);
+  this->posY.push_back(y);
+  this->width.push_back(w);
+  this->height.push_back(h);
+}
+
+size_t BlockArray::getMemorySize() const
+{
+  return getVectorMemorySize(this->posX) + getVectorMemorySize(this->posY) +
+         getVectorMemorySize(this->width) + getVectorMemorySize(this->height);
+}
+
+size_t ValueBlocks::getMemorySize() const
+{
+  return BlockArray::getMemorySize() + getVectorMemorySize(this->value);
+}
+
+int VectorBlocks::getLineIndex(size_t i) const
+{
+  auto it = std::lower_bound(this->lineIndices.begin(), this->lineIndices.end(), uint32_t(i));
+  if (it == this->lineIndices.end() || *it != i)
+    return -1;
+  return int(it - this->lineIndices.begin());
+}
+
+size_t VectorBlocks::getMemorySize() const
+{
+  return BlockArray::getMemorySize() + getVectorMemorySize(this->pointX) +
+         getVectorMemorySize(this->pointY) + getVectorMemorySize(this->lineIndices) +
+         getVectorMemorySize(this->lineEndX) + getVectorMemorySize(this->lineEndY);
+}
+
+size_t AffineTFBlocks::getMemorySize() const
+{
+  auto size = BlockArray::getMemorySize();
+  for (unsigned i = 0; i < 3; i++)
+    size += getVectorMemorySize(this->pointX[i]) + getVectorMemorySize(this->pointY[i]);
+  return size;
+}
+
+void PolygonArray::addPolygon(const Polygon &points)
+{
+  this->corners.insert(this->corners.end(), points.begin(), points.end());
+  this->cornerOffsets.push_back(uint32_t(this->corners.size()));
+}
+
+size_t PolygonArray::getMemorySize() const
+{
+  return getVectorMemorySize(this->corners) + getVectorMemorySize(this->cornerOffsets);
+}
+
+size_t PolygonValues::getMemorySize() const
+{
+  return PolygonArray::getMemorySize() + getVectorMemorySize(this->value);
+}
+
+size_t PolygonVectors::getMemorySize() const
+{
+  return PolygonArray::getMemorySize() + getVectorMemorySize(this->pointX) +
+         getVectorMemorySize(this->pointY);
+}
+
 void FrameTypeData::addBlockValue(
     unsigned short x, unsigned short y, unsigned short w, unsigned short h, int val)
 {
-  StatsItemValue value;
-  value.pos[0]  = x;
-  value.pos[1]  = y;
-  value.size[0] = w;
-  value.size[1] = h;
-  value.value   = val;
+  this->valueData.addBlock(x, y, w, h);
+  this->valueData.value.push_back(val);
 
   // Always keep the biggest block size updated.
   unsigned int wh = w * h;
   if (wh > maxBlockSize)
     maxBlockSize = wh;
-
-  valueData.push_back(value);
 }
 
 void FrameTypeData::addBlockVector(
     unsigned short x, unsigned short y, unsigned short w, unsigned short h, int vecX, int vecY)
 {
-  StatsItemVector vec;
-  vec.pos[0]   = x;
-  vec.pos[1]   = y;
-  vec.size[0]  = w;
-  vec.size[1]  = h;
-  vec.point[0] = Point(vecX, vecY);
-  vec.isLine   = false;
-  vectorData.push_back(vec);
+  this->vectorData.addBlock(x, y, w, h);
+  this->vectorData.pointX.push_back(vecX);
+  this->vectorData.pointY.push_back(vecY);
 }
 
 void FrameTypeData::addBlockAffineTF(unsigned short x,
@@ -77,15 +142,13 @@ void FrameTypeData::addBlockAffineTF(unsigned short x,
                                      int            vecX2,
                                      int            vecY2)
 {
-  StatsItemAffineTF affineTF;
-  affineTF.pos[0]   = x;
-  affineTF.pos[1]   = y;
-  affineTF.size[0]  = w;
-  affineTF.size[1]  = h;
-  affineTF.point[0] = Point(vecX0, vecY0);
-  affineTF.point[1] = Point(vecX1, vecY1);
-  affineTF.point[2] = Point(vecX2, vecY2);
-  affineTFData.push_back(affineTF);
+  this->affineTFData.addBlock(x, y, w, h);
+  this->affineTFData.pointX[0].push_back(vecX0);
+  this->affineTFData.pointY[0].push_back(vecY0);
+  this->affineTFData.pointX[1].push_back(vecX1);
+  this->affineTFData.pointY[1].push_back(vecY1);
+  this->affineTFData.pointX[2].push_back(vecX2);
+  this->affineTFData.pointY[2].push_back(vecY2);
 }
 
 void FrameTypeData::addLine(unsigned short x,
@@ -97,38 +160,38 @@ void FrameTypeData::addLine(unsigned short x,
                             int            x2,
                             int            y2)
 {
-  StatsItemVector vec;
-  vec.pos[0]   = x;
-  vec.pos[1]   = y;
-  vec.size[0]  = w;
-  vec.size[1]  = h;
-  vec.point[0] = Point(x1, y1);
-  vec.point[1] = Point(x2, y2);
-  vec.isLine   = true;
-  vectorData.push_back(vec);
+  this->vectorData.lineIndices.push_back(uint32_t(this->vectorData.size()));
+  this->vectorData.addBlock(x, y, w, h);
+  this->vectorData.pointX.push_back(x1);
+  this->vectorData.pointY.push_back(y1);
+  this->vectorData.lineEndX.push_back(x2);
+  this->vectorData.lineEndY.push_back(y2);
 }
 
 void FrameTypeData::addPolygonValue(const Polygon &points, int val)
 {
-  StatsItemPolygonValue value;
-  value.corners = points;
-  value.value   = val;
+  this->polygonValueData.addPolygon(points);
+  this->polygonValueData.value.push_back(val);
 
   // todo: how to do this nicely?
   //  // Always keep the biggest block size updated.
   //  unsigned int wh = w*h;
   //  if (wh > maxBlockSize)
   //    maxBlockSize = wh;
-
-  polygonValueData.push_back(value);
 }
 
 void FrameTypeData::addPolygonVector(const Polygon &points, int vecX, int vecY)
 {
-  StatsItemPolygonVector vec;
-  vec.corners = points;
-  vec.point   = Point(vecX, vecY);
-  polygonVectorData.push_back(vec);
+  this->polygonVectorData.addPolygon(points);
+  this->polygonVectorData.pointX.push_back(vecX);
+  this->polygonVectorData.pointY.push_back(vecY);
+}
+
+size_t FrameTypeData::getMemorySize() const
+{
+  return sizeof(FrameTypeData) + this->valueData.getMemorySize() +
+         this->vectorData.getMemorySize() + this->affineTFData.getMemorySize() +
+         this->polygonValueData.getMemorySize() + this->polygonVectorData.getMemorySize();
 }
 
 } // namespace stats
@@ -66,51 +66,100 @@ struct Line
 
 using Polygon = std::vector<Point>;
 
-struct StatsItemValue
+// The statistics are stored as a structure of arrays. Every component (e.g. the x position of all
+// blocks) is kept in its own array. This avoids padding and per item allocations and loops over
+// a component (like the visibility check when painting) can be vectorized.
+
+// The positions and sizes of a list of blocks (max 65535)
+struct BlockArray
 {
-  // The position and size of the item. (max 65535)
-  unsigned short pos[2];
-  unsigned short size[2];
+  std::vector<uint16_t> posX;
+  std::vector<uint16_t> posY;
+  std::vector<uint16_t> width;
+  std::vector<uint16_t> height;
+
+  size_t size() const { return this->posX.size(); }
+  bool   empty() const { return this->posX.empty(); }
+  QRect  getRect(size_t i) const
+  {
+    return QRect(this->posX[i], this->posY[i], this->width[i], this->height[i]);
+  }
+
+  void   addBlock(unsigned short x, unsigned short y, unsigned short w, unsigned short h);
+  size_t getMemorySize() const;
+};
+
+struct ValueBlocks : BlockArray
+{
+  std::vector<int32_t> value;
+
+  size_t getMemorySize() const;
+};
 
-  // The actual value
-  int value;
+// A vector per block. Lines are specified by two points. Most blocks are plain vectors so the
+// second point is only stored for the lines: lineIndices holds the (ascending) indices of the
+// blocks which are lines and lineEndX/lineEndY the second point of each line.
+struct VectorBlocks : BlockArray
+{
+  std::vector<int32_t>  pointX;
+  std::vector<int32_t>  pointY;
+  std::vector<uint32_t> lineIndices;
+  std::vector<int32_t>  lineEndX;
+  std::vector<int32_t>  lineEndY;
+
+  Point getPoint(size_t i) const { return Point(this->pointX[i], this->pointY[i]); }
+  // The position of block i in the line arrays or -1 if the block is not a line
+  int    getLineIndex(size_t i) const;
+  size_t getMemorySize() const;
 };
 
-struct StatsItemVector
+// Three vectors per block
+struct AffineTFBlocks : BlockArray
 {
-  // The position and size of the item. (max 65535)
-  unsigned short pos[2];
-  unsigned short size[2];
+  std::array<std::vector<int32_t>, 3> pointX;
+  std::array<std::vector<int32_t>, 3> pointY;
+
+  Point getPoint(size_t i, unsigned point) const
+  {
+    return Point(this->pointX[point][i], this->pointY[point][i]);
+  }
 
-  bool  isLine; // the vector is specified by two points
-  Point point[2];
+  size_t getMemorySize() const;
 };
 
-struct StatsItemAffineTF
+// The corners of all polygons are stored in one array. The corners of polygon i are the
+// corners from cornerOffsets[i] up to (excluding) cornerOffsets[i + 1].
+struct PolygonArray
 {
-  // The position and size of the item. (max 65535)
-  unsigned short pos[2];
-  unsigned short size[2];
+  std::vector<Point>    corners;
+  std::vector<uint32_t> cornerOffsets{0};
 
-  // the vector is specified by two points
-  Point point[3];
+  size_t       size() const { return this->cornerOffsets.size() - 1; }
+  bool         empty() const { return this->size() == 0; }
+  const Point *getCorners(size_t i) const { return this->corners.data() + this->cornerOffsets[i]; }
+  unsigned     getNrCorners(size_t i) const
+  {
+    return this->cornerOffsets[i + 1] - this->cornerOffsets[i];
+  }
+
+  void   addPolygon(const Polygon &points);
+  size_t getMemorySize() const;
 };
 
-struct StatsItemPolygonValue
+struct PolygonValues : PolygonArray
 {
-  // The position and size of the item.
-  Polygon corners;
+  std::vector<int32_t> value;
 
-  // The actual value
-  int value;
+  size_t getMemorySize() const;
 };
 
-struct StatsItemPolygonVector
+struct PolygonVectors : PolygonArray
 {
-  // The position and size of the item.
-  Polygon corners;
+  std::vector<int32_t> pointX;
+  std::vector<int32_t> pointY;
 
-  Point point;
+  Point  getPoint(size_t i) const { return Point(this->pointX[i], this->pointY[i]); }
+  size_t getMemorySize() const;
 };
 
 // A collection of statistics data (value and vector) for a certain context (for example for a
@@ -144,11 +193,14 @@ public:
   void addPolygonVector(const Polygon &points, int vecX, int vecY);
   void addPolygonValue(const Polygon &points, int val);
 
-  std::vector<StatsItemValue>         valueData;
-  std::vector<StatsItemVector>        vectorData;
-  std::vector<StatsItemAffineTF>      affineTFData;
-  std::vector<StatsItemPolygonValue>  polygonValueData;
-  std::vector<StatsItemPolygonVector> polygonVectorData;
+  // The approximate amount of memory that the data of this frame and type occupies
+  size_t getMemorySize() const;
+
+  ValueBlocks    valueData;
+  VectorBlocks   vectorData;
+  AffineTFBlocks affineTFData;
+  PolygonValues  polygonValueData;
+  PolygonVectors polygonVectorData;
 
   // What is the size (area) of the biggest block)? This is needed for scaling the blocks according
   // to their size.
@@ -34,6 +34,10 @@
 
 #include <common/Functions.h>
 
+#include <QSettings>
+#include <algorithm>
+#include <climits>
+
 // Activate this if you want to know when what is loaded.
 #define STATISTICS_DEBUG_LOADING 0
 #if STATISTICS_DEBUG_LOADING && !NDEBUG
@@ -46,6 +50,47 @@
 namespace stats
 {
 
+namespace
+{
+
+size_t getMemorySize(const FrameTypeDataMap &frameData)
+{
+  size_t size = 0;
+  for (const auto &typeData : frameData)
+    size += typeData.second.getMemorySize();
+  return size;
+}
+
+// The order in which cached frames are dropped. Frames behind the current frame will not be needed
+// during playback and are dropped first. Of the frames ahead, the furthest one is dropped first.
+int64_t getDropPriority(int frameIndex, int currentFrameIndex)
+{
+  if (frameIndex < currentFrameIndex)
+    return int64_t(INT_MAX) + currentFrameIndex - frameIndex;
+  return frameIndex - currentFrameIndex;
+}
+
+// Get the indices of all blocks that contain the given position. The check is done for all blocks
+// in one loop over the position and size arrays which the compiler can vectorize.
+std::vector<size_t> getBlocksAt(const BlockArray &blocks, const QPoint &pos)
+{
+  const auto           nrBlocks = blocks.size();
+  const auto           x        = pos.x();
+  const auto           y        = pos.y();
+  std::vector<uint8_t> contains(nrBlocks);
+  for (size_t i = 0; i < nrBlocks; i++)
+    contains[i] = (x >= blocks.posX[i]) & (x < blocks.posX[i] + blocks.width[i]) &
+                  (y >= blocks.posY[i]) & (y < blocks.posY[i] + blocks.height[i]);
+
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < nrBlocks; i++)
+    if (contains[i])
+      indices.push_back(i);
+  return indices;
+}
+
+} // namespace
+
 // code for checking if a point is inside a polygon. adapted from
 // https://stackoverflow.com/questions/217578/how-can-i-determine-whether-a-2d-point-is-within-a-polygon
 bool doesLineIntersectWithHorizontalLine(const Line side, const Point pt)
@@ -98,17 +143,16 @@ bool doesLineIntersectWithHorizontalLine(const Line side, const Point pt)
   return doLinesIntersect;
 }
 
-bool polygonContainsPoint(const stats::Polygon &polygon, const Point &pt)
+bool polygonContainsPoint(const Point *corners, unsigned nrCorners, const Point &pt)
 {
-  if (polygon.empty())
+  if (nrCorners == 0)
     return false;
 
-  unsigned numPts = polygon.size();
   // Test the ray against all sides
   unsigned intersections = 0;
-  for (unsigned i = 0; i < numPts - 1; i++)
+  for (unsigned i = 0; i < nrCorners - 1; i++)
   {
-    Line side = Line(polygon.at(i), polygon.at(i + 1));
+    Line side = Line(corners[i], corners[i + 1]);
     // Test if current side intersects with ray.
     if (doesLineIntersectWithHorizontalLine(side, pt))
     {
@@ -116,9 +160,9 @@ bool polygonContainsPoint(const stats::Polygon &polygon, const Point &pt)
     }
   }
   // close polygon
-  if (polygon.front() != polygon.back())
+  if (corners[0] != corners[nrCorners - 1])
   {
-    Line side = Line(polygon.front(), polygon.back());
+    Line side = Line(corners[0], corners[nrCorners - 1]);
     // Test if current side intersects with ray.
     if (doesLineIntersectWithHorizontalLine(side, pt))
     {
@@ -182,11 +226,19 @@ ItemLoadingState StatisticsData::needsLoading(int frameIndex) const
 
 std::vector<int> StatisticsData::getTypesThatNeedLoading(int frameIndex) const
 {
+  std::unique_lock<std::mutex> lock(this->accessMutex);
+
+  // Types that are in the cache for the frame do not have to be loaded again
+  const FrameTypeDataMap *loadedData = nullptr;
+  if (this->frameIdx == frameIndex)
+    loadedData = &this->frameCache;
+  else if (this->otherFramesCache.count(frameIndex) > 0)
+    loadedData = &this->otherFramesCache.at(frameIndex).data;
+
   std::vector<int> typesToLoad;
-  auto             loadAll = this->frameIdx != frameIndex;
   for (const auto &statsType : this->statsTypes)
   {
-    if (statsType.render && (loadAll || this->frameCache.count(statsType.typeID) == 0))
+    if (statsType.render && (!loadedData || loadedData->count(statsType.typeID) == 0))
       typesToLoad.push_back(statsType.typeID);
   }
 
@@ -213,91 +265,89 @@ QStringPairList StatisticsData::getValuesAt(const QPoint &pos) const
       // no active statistics data
       continue;
 
+    const auto &typeData = this->frameCache.at(it->typeID);
+
     // Get all value data entries
-    bool foundStats = false;
-    for (const auto &valueItem : this->frameCache.at(it->typeID).valueData)
+    bool        foundStats = false;
+    const auto &values     = typeData.valueData;
+    for (auto i : getBlocksAt(values, pos))
     {
-      auto rect = QRect(valueItem.pos[0], valueItem.pos[1], valueItem.size[0], valueItem.size[1]);
-      if (rect.contains(pos))
-      {
-        int  value  = valueItem.value;
-        auto valTxt = it->getValueTxt(value);
-        if (valTxt.isEmpty() && it->scaleValueToBlockSize)
-          valTxt = QString("%1").arg(float(value) / (valueItem.size[0] * valueItem.size[1]));
+      int  value  = values.value[i];
+      auto valTxt = it->getValueTxt(value);
+      if (valTxt.isEmpty() && it->scaleValueToBlockSize)
+        valTxt = QString("%1").arg(float(value) / (values.width[i] * values.height[i]));
 
-        valueList.append(QStringPair(it->typeName, valTxt));
-        foundStats = true;
-      }
+      valueList.append(QStringPair(it->typeName, valTxt));
+      foundStats = true;
     }
 
-    for (const auto &vectorItem : this->frameCache.at(it->typeID).vectorData)
+    const auto &vectors = typeData.vectorData;
+    for (auto i : getBlocksAt(vectors, pos))
     {
-      auto rect =
-          QRect(vectorItem.pos[0], vectorItem.pos[1], vectorItem.size[0], vectorItem.size[1]);
-      if (rect.contains(pos))
+      float      vectorValue1, vectorValue2;
+      const auto line = vectors.getLineIndex(i);
+      if (line >= 0)
       {
-        float vectorValue1, vectorValue2;
-        if (vectorItem.isLine)
-        {
-          vectorValue1 = float(vectorItem.point[1].x - vectorItem.point[0].x) / it->vectorScale;
-          vectorValue2 = float(vectorItem.point[1].y - vectorItem.point[0].y) / it->vectorScale;
-        }
-        else
-        {
-          vectorValue1 = float(vectorItem.point[0].x / it->vectorScale);
-          vectorValue2 = float(vectorItem.point[0].y / it->vectorScale);
-        }
-        valueList.append(
-            QStringPair(QString("%1[x]").arg(it->typeName), QString::number(vectorValue1)));
-        valueList.append(
-            QStringPair(QString("%1[y]").arg(it->typeName), QString::number(vectorValue2)));
-        foundStats = true;
+        vectorValue1 = float(vectors.lineEndX[line] - vectors.pointX[i]) / it->vectorScale;
+        vectorValue2 = float(vectors.lineEndY[line] - vectors.pointY[i]) / it->vectorScale;
+      }
+      else
+      {
+        vectorValue1 = float(vectors.pointX[i] / it->vectorScale);
+        vectorValue2 = float(vectors.pointY[i] / it->vectorScale);
       }
+      valueList.append(
+          QStringPair(QString("%1[x]").arg(it->typeName), QString::number(vectorValue1)));
+      valueList.append(
+          QStringPair(QString("%1[y]").arg(it->typeName), QString::number(vectorValue2)));
+      foundStats = true;
     }
 
-    for (const auto &affineTFItem : this->frameCache.at(it->typeID).affineTFData)
+    const auto &affineTFs = typeData.affineTFData;
+    for (auto i : getBlocksAt(affineTFs, pos))
     {
-      const auto rect = QRect(
-          affineTFItem.pos[0], affineTFItem.pos[1], affineTFItem.size[0], affineTFItem.size[1]);
-      if (rect.contains(pos))
+      for (unsigned p = 0; p < 3; p++)
       {
-        for (unsigned i = 0; i < 3; i++)
-        {
-          auto xScaled = float(affineTFItem.point[i].x / it->vectorScale);
-          auto yScaled = float(affineTFItem.point[i].y / it->vectorScale);
-          valueList.append(
-              QStringPair(QString("%1_%2[x]").arg(it->typeName).arg(i), QString::number(xScaled)));
-          valueList.append(
-              QStringPair(QString("%1_%2[y]").arg(it->typeName).arg(i), QString::number(yScaled)));
-        }
-        foundStats = true;
+        auto xScaled = float(affineTFs.pointX[p][i] / it->vectorScale);
+        auto yScaled = float(affineTFs.pointY[p][i] / it->vectorScale);
+        valueList.append(
+            QStringPair(QString("%1_%2[x]").arg(it->typeName).arg(p), QString::number(xScaled)));
+        valueList.append(
+            QStringPair(QString("%1_%2[y]").arg(it->typeName).arg(p), QString::number(yScaled)));
       }
+      foundStats = true;
     }
 
-    for (const auto &valueItem : this->frameCache.at(it->typeID).polygonValueData)
+    const auto &polygonValues = typeData.polygonValueData;
+    for (size_t i = 0; i < polygonValues.size(); i++)
     {
-      if (valueItem.corners.size() < 3)
+      const auto nrCorners = polygonValues.getNrCorners(i);
+      if (nrCorners < 3)
         continue; // need at least triangle -- or more corners
-      if (stats::polygonContainsPoint(valueItem.corners, Point(pos.x(), pos.y())))
+      if (stats::polygonContainsPoint(
+              polygonValues.getCorners(i), nrCorners, Point(pos.x(), pos.y())))
       {
-        int  value  = valueItem.value;
+        int  value  = polygonValues.value[i];
         auto valTxt = it->getValueTxt(value);
         valueList.append(QStringPair(it->typeName, valTxt));
         foundStats = true;
       }
     }
 
-    for (const auto &polygonVectorItem : this->frameCache.at(it->typeID).polygonVectorData)
+    const auto &polygonVectors = typeData.polygonVectorData;
+    for (size_t i = 0; i < polygonVectors.size(); i++)
     {
-      if (polygonVectorItem.corners.size() < 3)
+      const auto nrCorners = polygonVectors.getNrCorners(i);
+      if (nrCorners < 3)
         continue; // need at least triangle -- or more corners
-      if (stats::polygonContainsPoint(polygonVectorItem.corners, Point(pos.x(), pos.y())))
+      if (stats::polygonContainsPoint(
+              polygonVectors.getCorners(i), nrCorners, Point(pos.x(), pos.y())))
       {
         if (it->renderVectorData)
         {
           // The length of the vector
-          auto xScaled = (float)polygonVectorItem.point.x / it->vectorScale;
-          auto yScaled = (float)polygonVectorItem.point.y / it->vectorScale;
+          auto xScaled = (float)polygonVectors.pointX[i] / it->vectorScale;
+          auto yScaled = (float)polygonVectors.pointY[i] / it->vectorScale;
           valueList.append(
               QStringPair(QString("%1[x]").arg(it->typeName), QString::number(xScaled)));
           valueList.append(
@@ -316,7 +366,10 @@ QStringPairList StatisticsData::getValuesAt(const QPoint &pos) const
 
 void StatisticsData::clear()
 {
+  std::unique_lock<std::mutex> lock(this->accessMutex);
   this->frameCache.clear();
+  this->otherFramesCache.clear();
+  this->cacheSize = 0;
   this->frameIdx  = -1;
   this->frameSize = {};
   this->statsTypes.clear();
@@ -329,11 +382,130 @@ void StatisticsData::setFrameIndex(int frameIndex)
   {
     DEBUG_STATDATA("StatisticsData::getTypesThatNeedLoading New frame index set "
                    << this->frameIdx << "->" << frameIndex);
+    const auto previousFrameIdx = this->frameIdx;
+    auto       previousData     = std::move(this->frameCache);
     this->frameCache.clear();
     this->frameIdx = frameIndex;
+
+    auto cachedFrame = this->otherFramesCache.find(frameIndex);
+    if (cachedFrame != this->otherFramesCache.end())
+    {
+      DEBUG_STATDATA("StatisticsData::setFrameIndex Frame " << frameIndex << " taken from cache");
+      this->frameCache = std::move(cachedFrame->second.data);
+      this->cacheSize -= cachedFrame->second.memorySize;
+      this->otherFramesCache.erase(cachedFrame);
+    }
+
+    if (previousFrameIdx >= 0 && frameIndex >= 0)
+      this->addToCache(previousFrameIdx, std::move(previousData));
+  }
+}
+
+bool StatisticsData::cacheFrame(int frameIndex, FrameTypeDataMap &&frameData)
+{
+  std::unique_lock<std::mutex> lock(this->accessMutex);
+  if (frameIndex == this->frameIdx)
+  {
+    for (auto &typeData : frameData)
+      this->frameCache[typeData.first] = std::move(typeData.second);
+    return true;
+  }
+  return this->addToCache(frameIndex, std::move(frameData));
+}
+
+bool StatisticsData::isFrameCached(int frameIndex) const
+{
+  std::unique_lock<std::mutex> lock(this->accessMutex);
+  return this->otherFramesCache.count(frameIndex) > 0;
+}
+
+void StatisticsData::eraseCachedFrame(int frameIndex)
+{
+  std::unique_lock<std::mutex> lock(this->accessMutex);
+  auto                         cachedFrame = this->otherFramesCache.find(frameIndex);
+  if (cachedFrame != this->otherFramesCache.end())
+  {
+    this->cacheSize -= cachedFrame->second.memorySize;
+    this->otherFramesCache.erase(cachedFrame);
+  }
+}
+
+size_t StatisticsData::getCacheSize() const
+{
+  std::unique_lock<std::mutex> lock(this->accessMutex);
+  return this->cacheSize;
+}
+
+void StatisticsData::setCacheSizeLimit(size_t sizeInBytes)
+{
+  std::unique_lock<std::mutex> lock(this->accessMutex);
+  this->cacheSizeLimit = sizeInBytes;
+  while (this->cacheSize > this->cacheSizeLimit)
+  {
+    auto dropFrame = this->getFrameToDrop();
+    this->cacheSize -= dropFrame->second.memorySize;
+    this->otherFramesCache.erase(dropFrame);
   }
 }
 
+// Move the data of the current frame out. The frame index is reset. This is used for filling a
+// temporary StatisticsData object that is then added to the cache of another one.
+FrameTypeDataMap StatisticsData::takeFrameData()
+{
+  std::unique_lock<std::mutex> lock(this->accessMutex);
+  auto                         frameData = std::move(this->frameCache);
+  this->frameCache.clear();
+  this->frameIdx = -1;
+  return frameData;
+}
+
+void StatisticsData::updateSettings()
+{
+  QSettings settings;
+  settings.beginGroup("VideoCache");
+  const auto cacheSizeMB =
+      settings.value("StatisticsCacheMB", STATISTICS_CACHE_DEFAULT_SIZE_MB).toUInt();
+  settings.endGroup();
+  this->setCacheSizeLimit(size_t(cacheSizeMB) * 1000 * 1000);
+}
+
+// Add the frame to the cache. The accessMutex must be locked.
+bool StatisticsData::addToCache(int frameIndex, FrameTypeDataMap &&frameData)
+{
+  auto existingFrame = this->otherFramesCache.find(frameIndex);
+  if (existingFrame != this->otherFramesCache.end())
+  {
+    // Merge with the types that are already cached for the frame
+    for (auto &typeData : existingFrame->second.data)
+      frameData.emplace(typeData.first, std::move(typeData.second));
+    this->cacheSize -= existingFrame->second.memorySize;
+    this->otherFramesCache.erase(existingFrame);
+  }
+
+  if (frameData.empty())
+    return false;
+
+  const auto memorySize = getMemorySize(frameData);
+  const auto priority   = getDropPriority(frameIndex, this->frameIdx);
+  while (this->cacheSize + memorySize > this->cacheSizeLimit)
+  {
+    auto dropFrame = this->getFrameToDrop();
+    if (dropFrame == this->otherFramesCache.end() ||
+        getDropPriority(dropFrame->first, this->frameIdx) <= priority)
+    {
+      DEBUG_STATDATA("StatisticsData::addToCache Cache full. Frame " << frameIndex
+                                                                     << " not cached");
+      return false;
+    }
+    this->cacheSize -= dropFrame->second.memorySize;
+    this->otherFramesCache.erase(dropFrame);
+  }
+
+  this->otherFramesCache[frameIndex] = {std::move(frameData), memorySize};
+  this->cacheSize += memorySize;
+  return true;
+}
+
 void StatisticsData::addStatType(const StatisticsType &type)
 {
   if (type.typeID == -1)
@@ -369,4 +541,16 @@ void StatisticsData::loadPlaylist(const YUViewDomElement &root)
     type.loadPlaylist(root);
 }
 
+// Get the cached frame that is dropped first. The accessMutex must be locked.
+std::map<int, StatisticsData::CachedFrame>::iterator StatisticsData::getFrameToDrop()
+{
+  const auto currentFrameIdx = this->frameIdx;
+  return std::max_element(this->otherFramesCache.begin(),
+                          this->otherFramesCache.end(),
+                          [currentFrameIdx](const auto &a, const auto &b) {
+                            return getDropPriority(a.first, currentFrameIdx) <
+                                   getDropPriority(b.first, currentFrameIdx);
+                          });
+}
+
 } // namespace stats
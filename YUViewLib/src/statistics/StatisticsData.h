@@ -43,6 +43,11 @@ namespace stats
 {
 
 using StatisticsTypesVec = std::vector<StatisticsType>;
+// The statistics of one frame [statsTypeID]
+using FrameTypeDataMap = std::map<int, FrameTypeData>;
+
+// The default limit for the statistics of other frames that are kept in memory
+constexpr unsigned STATISTICS_CACHE_DEFAULT_SIZE_MB = 256;
 
 class StatisticsData
 {
@@ -61,9 +66,26 @@ public:
 
   void clear();
   void setFrameSize(Size size) { this->frameSize = size; }
+  // Switch to the given frame. The data of the previous frame is moved to the frame cache and the
+  // data of the new frame is taken from there if it was cached. Setting -1 discards the data of
+  // the current frame.
   void setFrameIndex(int frameIndex);
   void addStatType(const StatisticsType &type);
 
+  // The frame cache keeps the statistics of frames other than the current one (e.g. prefetched
+  // frames or frames from a caching decoder). Its size is limited. Frames behind the current frame
+  // are dropped first, then the frames that are furthest ahead. If the given frame would be the
+  // first one to be dropped, it is not added and false is returned. Data for the current frame is
+  // merged into it directly.
+  bool             cacheFrame(int frameIndex, FrameTypeDataMap &&frameData);
+  bool             isFrameCached(int frameIndex) const;
+  void             eraseCachedFrame(int frameIndex);
+  size_t           getCacheSize() const;
+  size_t           getCacheSizeLimit() const { return this->cacheSizeLimit; }
+  void             setCacheSizeLimit(size_t sizeInBytes);
+  FrameTypeDataMap takeFrameData();
+  void             updateSettings();
+
   void savePlaylist(YUViewDomElement &root) const;
   void loadPlaylist(const YUViewDomElement &root);
 
@@ -74,8 +96,21 @@ public:
 
 private:
   // cache of the statistics for the current POC [statsTypeID]
-  std::map<int, FrameTypeData> frameCache;
-  int                          frameIdx{-1};
+  FrameTypeDataMap frameCache;
+  int              frameIdx{-1};
+
+  struct CachedFrame
+  {
+    FrameTypeDataMap data;
+    size_t           memorySize{};
+  };
+  // cache of the statistics of other POCs [POC]
+  std::map<int, CachedFrame> otherFramesCache;
+  size_t                     cacheSize{};
+  size_t                     cacheSizeLimit{size_t(STATISTICS_CACHE_DEFAULT_SIZE_MB) * 1000 * 1000};
+
+  bool                                 addToCache(int frameIndex, FrameTypeDataMap &&frameData);
+  std::map<int, CachedFrame>::iterator getFrameToDrop();
 
   Size frameSize;
 
@@ -52,17 +52,37 @@ namespace
 #define DEBUG_PAINT(fmt, ...) ((void)0)
 #endif
 
-QPolygon convertToQPolygon(const stats::Polygon &poly)
+QPolygon convertToQPolygon(const stats::Point *corners, unsigned nrCorners)
 {
-  if (poly.empty())
-    return QPolygon();
-
-  auto qPoly = QPolygon(poly.size());
-  for (int i = 0; i < int(poly.size()); i++)
-    qPoly.setPoint(i, QPoint(poly[i].x, poly[i].y));
+  auto qPoly = QPolygon(int(nrCorners));
+  for (int i = 0; i < int(nrCorners); i++)
+    qPoly.setPoint(i, QPoint(corners[i].x, corners[i].y));
   return qPoly;
 }
 
+// Get the indices of all blocks which are (at least partly) visible in the given area. The check is
+// done for all blocks in one loop over the position and size arrays so that it can be vectorized.
+std::vector<size_t> getVisibleBlocks(
+    const stats::BlockArray &blocks, double zoomFactor, int xMin, int xMax, int yMin, int yMax)
+{
+  const auto           nrBlocks = blocks.size();
+  std::vector<uint8_t> visible(nrBlocks);
+  for (size_t i = 0; i < nrBlocks; i++)
+  {
+    const int left   = blocks.posX[i] * zoomFactor;
+    const int top    = blocks.posY[i] * zoomFactor;
+    const int right  = left + int(blocks.width[i] * zoomFactor) - 1;
+    const int bottom = top + int(blocks.height[i] * zoomFactor) - 1;
+    visible[i]       = (left <= xMax) & (right >= xMin) & (top <= yMax) & (bottom >= yMin);
+  }
+
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < nrBlocks; i++)
+    if (visible[i])
+      indices.push_back(i);
+  return indices;
+}
+
 QPoint getPolygonCenter(const QPolygon &polygon)
 {
   auto p = QPoint(0, 0);
@@ -319,29 +339,24 @@ void stats::paintStatisticsData(QPainter *             painter,
     if (!it->render || !statisticsData.hasDataForTypeID(it->typeID))
       continue;
 
-    for (const auto &valueItem : statisticsData[it->typeID].valueData)
+    // Only the statistics items that are visible are drawn
+    const auto &valueData = statisticsData[it->typeID].valueData;
+    for (auto i : getVisibleBlocks(valueData, zoomFactor, xMin, xMax, yMin, yMax))
     {
       // Calculate the size and position of the rectangle to draw (zoomed in)
-      auto rect = QRect(valueItem.pos[0], valueItem.pos[1], valueItem.size[0], valueItem.size[1]);
+      auto rect        = valueData.getRect(i);
       auto displayRect = QRect(rect.left() * zoomFactor,
                                rect.top() * zoomFactor,
                                rect.width() * zoomFactor,
                                rect.height() * zoomFactor);
 
-      // Check if the rectangle of the statistics item is even visible
-      bool rectVisible = (!(displayRect.left() > xMax || displayRect.right() < xMin ||
-                            displayRect.top() > yMax || displayRect.bottom() < yMin));
-      if (!rectVisible)
-        continue;
-
-      int value = valueItem.value; // This value determines the color for this item
+      int value = valueData.value[i]; // This value determines the color for this item
       if (it->renderValueData)
       {
         // Get the right color for the item and draw it.
         Color rectColor;
         if (it->scaleValueToBlockSize)
-          rectColor =
-              it->colorMapper.getColor(float(value) / (valueItem.size[0] * valueItem.size[1]));
+          rectColor = it->colorMapper.getColor(float(value) / (rect.width() * rect.height()));
         else
           rectColor = it->colorMapper.getColor(value);
         rectColor.setAlpha(rectColor.alpha() * ((float)it->alphaFactor / 100.0));
@@ -374,7 +389,7 @@ void stats::paintStatisticsData(QPainter *             painter,
       {
         auto valTxt = it->getValueTxt(value);
         if (valTxt.isEmpty() && it->scaleValueToBlockSize)
-          valTxt = QString("%1").arg(float(value) / (valueItem.size[0] * valueItem.size[1]));
+          valTxt = QString("%1").arg(float(value) / (rect.width() * rect.height()));
 
         auto typeTxt = it->typeName;
         auto statTxt = moreThanOneBlockStatRendered ? typeTxt + ":" + valTxt : valTxt;
@@ -406,10 +421,14 @@ void stats::paintStatisticsData(QPainter *             painter,
       continue;
 
     // Go through all the value data
-    for (const auto &valueItem : statisticsData[it->typeID].polygonValueData)
+    const auto &polygonValueData = statisticsData[it->typeID].polygonValueData;
+    for (size_t i = 0; i < polygonValueData.size(); i++)
     {
+      const auto corners   = polygonValueData.getCorners(i);
+      const auto nrCorners = polygonValueData.getNrCorners(i);
+
       // Calculate the size and position of the rectangle to draw (zoomed in)
-      auto valuePoly           = convertToQPolygon(valueItem.corners);
+      auto valuePoly           = convertToQPolygon(corners, nrCorners);
       auto boundingRect        = valuePoly.boundingRect();
       auto trans               = QTransform().scale(zoomFactor, zoomFactor);
       auto displayPolygon      = trans.map(valuePoly);
@@ -421,7 +440,7 @@ void stats::paintStatisticsData(QPainter *             painter,
 
       if (isVisible)
       {
-        int value = valueItem.value; // This value determines the color for this item
+        int value = polygonValueData.value[i]; // This value determines the color for this item
         if (it->renderValueData)
         {
           // Get the right color for the item and draw it.
@@ -505,12 +524,18 @@ void stats::paintStatisticsData(QPainter *             painter,
       // This statistics type is not rendered or could not be loaded.
       continue;
 
-    // Go through all the vector data
-    for (const auto &vectorItem : statisticsData[it->typeID].vectorData)
+    // Go through all the vector data. The line indices are ascending so the next line is tracked
+    // while iterating.
+    const auto &vectorData = statisticsData[it->typeID].vectorData;
+    size_t      nextLine   = 0;
+    for (size_t i = 0; i < vectorData.size(); i++)
     {
+      const bool isLine =
+          nextLine < vectorData.lineIndices.size() && vectorData.lineIndices[nextLine] == i;
+      const auto line = isLine ? nextLine++ : 0;
+
       // Calculate the size and position of the rectangle to draw (zoomed in)
-      const auto rect =
-          QRect(vectorItem.pos[0], vectorItem.pos[1], vectorItem.size[0], vectorItem.size[1]);
+      const auto rect        = vectorData.getRect(i);
       const auto displayRect = QRect(rect.left() * zoomFactor,
                                      rect.top() * zoomFactor,
                                      rect.width() * zoomFactor,
@@ -521,12 +546,12 @@ void stats::paintStatisticsData(QPainter *             painter,
         // Calculate the start and end point of the arrow. The vector starts at center of the block.
         int   x1, y1, x2, y2;
         float vx, vy;
-        if (vectorItem.isLine)
+        if (isLine)
         {
-          x1 = displayRect.left() + zoomFactor * vectorItem.point[0].x;
-          y1 = displayRect.top() + zoomFactor * vectorItem.point[0].y;
-          x2 = displayRect.left() + zoomFactor * vectorItem.point[1].x;
-          y2 = displayRect.top() + zoomFactor * vectorItem.point[1].y;
+          x1 = displayRect.left() + zoomFactor * vectorData.pointX[i];
+          y1 = displayRect.top() + zoomFactor * vectorData.pointY[i];
+          x2 = displayRect.left() + zoomFactor * vectorData.lineEndX[line];
+          y2 = displayRect.top() + zoomFactor * vectorData.lineEndY[line];
           vx = (float)(x2 - x1) / it->vectorScale;
           vy = (float)(y2 - y1) / it->vectorScale;
         }
@@ -536,8 +561,8 @@ void stats::paintStatisticsData(QPainter *             painter,
           y1 = displayRect.top() + displayRect.height() / 2;
 
           // The length of the vector
-          vx = (float)vectorItem.point[0].x / it->vectorScale;
-          vy = (float)vectorItem.point[0].y / it->vectorScale;
+          vx = (float)vectorData.pointX[i] / it->vectorScale;
+          vy = (float)vectorData.pointY[i] / it->vectorScale;
 
           // The end point of the vector
           x2 = x1 + zoomFactor * vx;
@@ -625,7 +650,7 @@ void stats::paintStatisticsData(QPainter *             painter,
 
             if (zoomFactor >= STATISTICS_DRAW_VALUES_ZOOM && it->renderVectorDataValues)
             {
-              if (vectorItem.isLine)
+              if (isLine)
               {
                 // if we just draw a line, we want to simply see the coordinate pairs
                 auto txt1 = QString("(%1, %2)").arg(x1 / zoomFactor).arg(y1 / zoomFactor);
@@ -712,20 +737,15 @@ void stats::paintStatisticsData(QPainter *             painter,
     }
 
     // Go through all the affine transform data
-    for (const auto &affineTFItem : statisticsData[it->typeID].affineTFData)
+    const auto &affineTFData = statisticsData[it->typeID].affineTFData;
+    for (auto i : getVisibleBlocks(affineTFData, zoomFactor, xMin, xMax, yMin, yMax))
     {
       // Calculate the size and position of the rectangle to draw (zoomed in)
-      const auto rect = QRect(
-          affineTFItem.pos[0], affineTFItem.pos[1], affineTFItem.size[0], affineTFItem.size[1]);
+      const auto rect        = affineTFData.getRect(i);
       const auto displayRect = QRect(rect.left() * zoomFactor,
                                      rect.top() * zoomFactor,
                                      rect.width() * zoomFactor,
                                      rect.height() * zoomFactor);
-      // Check if the rectangle of the statistics item is even visible
-      const bool rectVisible = (!(displayRect.left() > xMax || displayRect.right() < xMin ||
-                                  displayRect.top() > yMax || displayRect.bottom() < yMin));
-      if (!rectVisible)
-        continue;
 
       if (it->renderVectorData)
       {
@@ -743,12 +763,12 @@ void stats::paintStatisticsData(QPainter *             painter,
         yLBstart = displayRect.bottom();
 
         // The length of the vectors
-        vxLT = (float)affineTFItem.point[0].x / it->vectorScale;
-        vyLT = (float)affineTFItem.point[0].y / it->vectorScale;
-        vxRT = (float)affineTFItem.point[1].x / it->vectorScale;
-        vyRT = (float)affineTFItem.point[1].y / it->vectorScale;
-        vxLB = (float)affineTFItem.point[2].x / it->vectorScale;
-        vyLB = (float)affineTFItem.point[2].y / it->vectorScale;
+        vxLT = (float)affineTFData.pointX[0][i] / it->vectorScale;
+        vyLT = (float)affineTFData.pointY[0][i] / it->vectorScale;
+        vxRT = (float)affineTFData.pointX[1][i] / it->vectorScale;
+        vyRT = (float)affineTFData.pointY[1][i] / it->vectorScale;
+        vxLB = (float)affineTFData.pointX[2][i] / it->vectorScale;
+        vyLB = (float)affineTFData.pointY[2][i] / it->vectorScale;
 
         // The end point of the vectors
         xLTend = xLTstart + zoomFactor * vxLT;
@@ -825,13 +845,15 @@ void stats::paintStatisticsData(QPainter *             painter,
       continue;
 
     // Go through all the vector data
-    for (const auto &vectorItem : statisticsData[it->typeID].polygonVectorData)
+    const auto &polygonVectorData = statisticsData[it->typeID].polygonVectorData;
+    for (size_t i = 0; i < polygonVectorData.size(); i++)
     {
-      if (vectorItem.corners.size() < 3)
+      const auto nrCorners = polygonVectorData.getNrCorners(i);
+      if (nrCorners < 3)
         continue; // need at least triangle -- or more corners
 
       // Calculate the size and position of the rectangle to draw (zoomed in)
-      auto vectorPoly          = convertToQPolygon(vectorItem.corners);
+      auto vectorPoly = convertToQPolygon(polygonVectorData.getCorners(i), nrCorners);
       auto trans               = QTransform().scale(zoomFactor, zoomFactor);
       auto displayPolygon      = trans.map(vectorPoly);
       auto displayBoundingRect = displayPolygon.boundingRect();
@@ -859,8 +881,8 @@ void stats::paintStatisticsData(QPainter *             painter,
         center_y /= displayPolygon.size();
 
         // The length of the vector
-        vx = (float)vectorItem.point.x / it->vectorScale;
-        vy = (float)vectorItem.point.y / it->vectorScale;
+        vx = (float)polygonVectorData.pointX[i] / it->vectorScale;
+        vy = (float)polygonVectorData.pointY[i] / it->vectorScale;
 
         // The end point of the vector
         head_x = center_x + zoomFactor * vx;
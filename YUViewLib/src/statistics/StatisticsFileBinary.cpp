@@ -0,0 +1,653 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StatisticsFileBinary.h"
+
+#include <QFile>
+#include <QSysInfo>
+#include <QtEndian>
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace stats
+{
+
+namespace
+{
+
+constexpr char     MAGIC[8]         = {'Y', 'U', 'V', 'S', 'T', 'A', 'T', 'S'};
+constexpr uint32_t FORMAT_VERSION   = 2;
+constexpr int64_t  HEADER_SIZE      = 56;
+constexpr int64_t  INDEX_ENTRY_SIZE = 48;
+
+// The polygon corners are stored as pairs of x/y values so that they can be copied directly on
+// little endian machines.
+static_assert(sizeof(Point) == 8 && offsetof(Point, y) == 4, "Unexpected layout of Point");
+
+// The flags of a type in the order of their bits
+const std::vector<bool StatisticsType::*> TypeFlags = {&StatisticsType::render,
+                                                      &StatisticsType::hasValueData,
+                                                      &StatisticsType::renderValueData,
+                                                      &StatisticsType::scaleValueToBlockSize,
+                                                      &StatisticsType::hasVectorData,
+                                                      &StatisticsType::hasAffineTFData,
+                                                      &StatisticsType::renderVectorData,
+                                                      &StatisticsType::renderVectorDataValues,
+                                                      &StatisticsType::scaleVectorToZoom,
+                                                      &StatisticsType::mapVectorToColor,
+                                                      &StatisticsType::renderGrid,
+                                                      &StatisticsType::scaleGridToZoom,
+                                                      &StatisticsType::isPolygon};
+
+// Read little endian values from a buffer. Reading past the end of the buffer throws.
+class ByteReader
+{
+public:
+  ByteReader(const QByteArray &data) : data(data) {}
+
+  template <typename T> T read()
+  {
+    return qFromLittleEndian<T>(reinterpret_cast<const uchar *>(this->take(sizeof(T))));
+  }
+  double readDouble()
+  {
+    auto   bits = this->read<quint64>();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+  QString readString()
+  {
+    auto length = this->read<quint32>();
+    return QString::fromUtf8(this->take(length), int(length));
+  }
+  Color readColor()
+  {
+    auto r = this->read<quint8>();
+    auto g = this->read<quint8>();
+    auto b = this->read<quint8>();
+    auto a = this->read<quint8>();
+    return Color(r, g, b, a);
+  }
+  LineDrawStyle readLineDrawStyle()
+  {
+    LineDrawStyle style;
+    style.color   = this->readColor();
+    style.width   = this->readDouble();
+    style.pattern = Pattern(this->read<quint8>());
+    return style;
+  }
+  Point readPoint()
+  {
+    auto x = this->read<qint32>();
+    auto y = this->read<qint32>();
+    return Point(x, y);
+  }
+  // Read count values into the array. No conversion is needed on little endian machines so the
+  // values are copied at once.
+  template <typename T> void readArray(std::vector<T> &values, uint32_t count)
+  {
+    auto source = this->take(int64_t(count) * int64_t(sizeof(T)));
+    values.resize(count);
+    if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+    {
+      if (count > 0)
+        std::memcpy(values.data(), source, count * sizeof(T));
+      return;
+    }
+    for (uint32_t i = 0; i < count; i++)
+      values[i] = qFromLittleEndian<T>(reinterpret_cast<const uchar *>(source + i * sizeof(T)));
+  }
+  void readPoints(std::vector<Point> &points, uint32_t count)
+  {
+    if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+    {
+      auto source = this->take(int64_t(count) * int64_t(sizeof(Point)));
+      points.resize(count);
+      if (count > 0)
+        std::memcpy(points.data(), source, count * sizeof(Point));
+      return;
+    }
+    this->require(int64_t(count) * int64_t(sizeof(Point)));
+    points.resize(count);
+    for (auto &point : points)
+      point = this->readPoint();
+  }
+
+  // Throw if there are less than nrBytes left
+  void require(int64_t nrBytes) const
+  {
+    if (nrBytes < 0 || this->pos + nrBytes > this->data.size())
+      throw "Unexpected end of data";
+  }
+  // Return a pointer to the next nrBytes and skip them
+  const char *take(int64_t nrBytes)
+  {
+    this->require(nrBytes);
+    auto ptr = this->data.constData() + this->pos;
+    this->pos += nrBytes;
+    return ptr;
+  }
+
+private:
+  const QByteArray &data;
+  int64_t           pos{};
+};
+
+// Append little endian values to a buffer
+class ByteWriter
+{
+public:
+  template <typename T> void write(T value)
+  {
+    char buffer[sizeof(T)];
+    qToLittleEndian(value, buffer);
+    this->data.append(buffer, int(sizeof(T)));
+  }
+  void writeDouble(double value)
+  {
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    this->write(bits);
+  }
+  void writeString(const QString &string)
+  {
+    auto utf8 = string.toUtf8();
+    this->write(quint32(utf8.size()));
+    this->data.append(utf8);
+  }
+  void writeColor(const Color &color)
+  {
+    this->write(quint8(color.R()));
+    this->write(quint8(color.G()));
+    this->write(quint8(color.B()));
+    this->write(quint8(color.A()));
+  }
+  void writeLineDrawStyle(const LineDrawStyle &style)
+  {
+    this->writeColor(style.color);
+    this->writeDouble(style.width);
+    this->write(quint8(style.pattern));
+  }
+  void writePoint(const Point &point)
+  {
+    this->write(qint32(point.x));
+    this->write(qint32(point.y));
+  }
+  template <typename T> void writeArray(const std::vector<T> &values)
+  {
+    for (auto value : values)
+      this->write(value);
+  }
+  void writePoints(const std::vector<Point> &points)
+  {
+    for (const auto &point : points)
+      this->writePoint(point);
+  }
+
+  QByteArray data;
+};
+
+StatisticsType readType(ByteReader &reader)
+{
+  StatisticsType type(reader.read<qint32>());
+  type.typeName    = reader.readString();
+  type.description = reader.readString();
+
+  auto flags = reader.read<quint32>();
+  for (unsigned i = 0; i < TypeFlags.size(); i++)
+    type.*TypeFlags[i] = (flags & (1u << i)) != 0;
+  type.alphaFactor = reader.read<qint32>();
+
+  auto &mapper         = type.colorMapper;
+  mapper.mappingType   = ColorMapper::MappingType(reader.read<quint8>());
+  mapper.rangeMin      = reader.read<qint32>();
+  mapper.rangeMax      = reader.read<qint32>();
+  mapper.minColor      = reader.readColor();
+  mapper.maxColor      = reader.readColor();
+  mapper.colorMapOther = reader.readColor();
+  mapper.complexType   = reader.readString();
+  auto nrColors        = reader.read<quint32>();
+  for (unsigned i = 0; i < nrColors; i++)
+  {
+    auto value             = reader.read<qint32>();
+    mapper.colorMap[value] = reader.readColor();
+  }
+
+  type.vectorStyle = reader.readLineDrawStyle();
+  type.vectorScale = reader.read<qint32>();
+  type.arrowHead   = StatisticsType::ArrowHead(reader.read<quint8>());
+  type.gridStyle   = reader.readLineDrawStyle();
+
+  std::map<int, QString> valueMap;
+  auto                   nrValues = reader.read<quint32>();
+  for (unsigned i = 0; i < nrValues; i++)
+  {
+    auto value      = reader.read<qint32>();
+    valueMap[value] = reader.readString();
+  }
+  type.setValueMap(valueMap);
+  return type;
+}
+
+void writeType(ByteWriter &writer, const StatisticsType &type)
+{
+  writer.write(qint32(type.typeID));
+  writer.writeString(type.typeName);
+  writer.writeString(type.description);
+
+  quint32 flags = 0;
+  for (unsigned i = 0; i < TypeFlags.size(); i++)
+    if (type.*TypeFlags[i])
+      flags |= (1u << i);
+  writer.write(flags);
+  writer.write(qint32(type.alphaFactor));
+
+  const auto &mapper = type.colorMapper;
+  writer.write(quint8(ColorMapper::mappingTypeToUInt(mapper.mappingType)));
+  writer.write(qint32(mapper.rangeMin));
+  writer.write(qint32(mapper.rangeMax));
+  writer.writeColor(mapper.minColor);
+  writer.writeColor(mapper.maxColor);
+  writer.writeColor(mapper.colorMapOther);
+  writer.writeString(mapper.complexType);
+  writer.write(quint32(mapper.colorMap.size()));
+  for (const auto &[value, color] : mapper.colorMap)
+  {
+    writer.write(qint32(value));
+    writer.writeColor(color);
+  }
+
+  writer.writeLineDrawStyle(type.vectorStyle);
+  writer.write(qint32(type.vectorScale));
+  writer.write(quint8(type.arrowHead));
+  writer.writeLineDrawStyle(type.gridStyle);
+
+  const auto &valueMap = type.getValueMap();
+  writer.write(quint32(valueMap.size()));
+  for (const auto &[value, text] : valueMap)
+  {
+    writer.write(qint32(value));
+    writer.writeString(text);
+  }
+}
+
+// The records of a POC/type are stored column by column in the order of the arrays in
+// FrameTypeData. So every column can be copied into its array at once.
+void readBlocks(ByteReader &reader, uint32_t count, BlockArray &blocks)
+{
+  reader.readArray(blocks.posX, count);
+  reader.readArray(blocks.posY, count);
+  reader.readArray(blocks.width, count);
+  reader.readArray(blocks.height, count);
+}
+
+void writeBlocks(ByteWriter &writer, const BlockArray &blocks)
+{
+  writer.writeArray(blocks.posX);
+  writer.writeArray(blocks.posY);
+  writer.writeArray(blocks.width);
+  writer.writeArray(blocks.height);
+}
+
+// Polygons are stored as the number of corners of every polygon followed by all corners
+void readPolygons(ByteReader &reader, uint32_t count, PolygonArray &polygons)
+{
+  std::vector<uint32_t> nrCorners;
+  reader.readArray(nrCorners, count);
+
+  polygons.cornerOffsets.resize(size_t(count) + 1);
+  uint64_t offset = 0;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    offset += nrCorners[i];
+    if (offset > std::numeric_limits<uint32_t>::max())
+      throw "Invalid number of polygon corners";
+    polygons.cornerOffsets[i + 1] = uint32_t(offset);
+  }
+  reader.readPoints(polygons.corners, uint32_t(offset));
+}
+
+void writePolygons(ByteWriter &writer, const PolygonArray &polygons)
+{
+  for (size_t i = 0; i < polygons.size(); i++)
+    writer.write(quint32(polygons.getNrCorners(i)));
+  writer.writePoints(polygons.corners);
+}
+
+void readRecords(ByteReader &reader, const uint32_t (&counts)[5], FrameTypeData &data)
+{
+  readBlocks(reader, counts[0], data.valueData);
+  reader.readArray(data.valueData.value, counts[0]);
+
+  auto &vectors = data.vectorData;
+  readBlocks(reader, counts[1], vectors);
+  reader.readArray(vectors.pointX, counts[1]);
+  reader.readArray(vectors.pointY, counts[1]);
+  const auto nrLines = reader.read<quint32>();
+  reader.readArray(vectors.lineIndices, nrLines);
+  for (uint32_t i = 0; i < nrLines; i++)
+    if (vectors.lineIndices[i] >= counts[1] ||
+        (i > 0 && vectors.lineIndices[i] <= vectors.lineIndices[i - 1]))
+      throw "Invalid line index";
+  reader.readArray(vectors.lineEndX, nrLines);
+  reader.readArray(vectors.lineEndY, nrLines);
+
+  readBlocks(reader, counts[2], data.affineTFData);
+  for (unsigned p = 0; p < 3; p++)
+  {
+    reader.readArray(data.affineTFData.pointX[p], counts[2]);
+    reader.readArray(data.affineTFData.pointY[p], counts[2]);
+  }
+
+  readPolygons(reader, counts[3], data.polygonValueData);
+  reader.readArray(data.polygonValueData.value, counts[3]);
+
+  readPolygons(reader, counts[4], data.polygonVectorData);
+  reader.readArray(data.polygonVectorData.pointX, counts[4]);
+  reader.readArray(data.polygonVectorData.pointY, counts[4]);
+}
+
+void writeRecords(ByteWriter &writer, const FrameTypeData &data)
+{
+  writeBlocks(writer, data.valueData);
+  writer.writeArray(data.valueData.value);
+
+  const auto &vectors = data.vectorData;
+  writeBlocks(writer, vectors);
+  writer.writeArray(vectors.pointX);
+  writer.writeArray(vectors.pointY);
+  writer.write(quint32(vectors.lineIndices.size()));
+  writer.writeArray(vectors.lineIndices);
+  writer.writeArray(vectors.lineEndX);
+  writer.writeArray(vectors.lineEndY);
+
+  writeBlocks(writer, data.affineTFData);
+  for (unsigned p = 0; p < 3; p++)
+  {
+    writer.writeArray(data.affineTFData.pointX[p]);
+    writer.writeArray(data.affineTFData.pointY[p]);
+  }
+
+  writePolygons(writer, data.polygonValueData);
+  writer.writeArray(data.polygonValueData.value);
+
+  writePolygons(writer, data.polygonVectorData);
+  writer.writeArray(data.polygonVectorData.pointX);
+  writer.writeArray(data.polygonVectorData.pointY);
+}
+
+} // namespace
+
+StatisticsFileBinary::StatisticsFileBinary(const QString &filename, StatisticsData &statisticsData)
+    : StatisticsFileBase(filename)
+{
+  this->file.enableMemoryMapping();
+  this->readHeaderFromFile(statisticsData);
+}
+
+void StatisticsFileBinary::readFrameAndTypePositionsFromFile(std::atomic_bool &)
+{
+  // All positions are known from the index
+  this->parsingProgress = 100.0;
+}
+
+void StatisticsFileBinary::loadStatisticData(StatisticsData &statisticsData, int poc, int typeID)
+{
+  if (!this->file.isOk())
+    return;
+
+  try
+  {
+    statisticsData.setFrameIndex(poc);
+
+    if (this->pocTypeIndex.count(poc) == 0 || this->pocTypeIndex[poc].count(typeID) == 0)
+    {
+      // There are no statistics in the file for the given frame and index.
+      std::unique_lock<std::mutex> lock(statisticsData.accessMutex);
+      statisticsData[typeID] = {};
+      return;
+    }
+
+    const auto &entry = this->pocTypeIndex[poc][typeID];
+
+    // If the file is mapped, the data is not copied
+    QByteArray buffer;
+    if (this->file.readBytesZeroCopy(buffer, entry.offset, entry.size) != entry.size)
+      throw "Error reading the data from file";
+
+    FrameTypeData data;
+    ByteReader    reader(buffer);
+    readRecords(reader,
+                {entry.nrValues,
+                 entry.nrVectors,
+                 entry.nrAffineTFs,
+                 entry.nrPolygonValues,
+                 entry.nrPolygonVectors},
+                data);
+    data.maxBlockSize = entry.maxBlockSize;
+
+    std::unique_lock<std::mutex> lock(statisticsData.accessMutex);
+    statisticsData[typeID] = std::move(data);
+  }
+  catch (const char *str)
+  {
+    std::cerr << "Error while loading: " << str << '\n';
+    this->errorMessage = QString("Error while loading statistics data: ") + QString(str);
+    this->error        = true;
+  }
+  catch (const std::exception &ex)
+  {
+    std::cerr << "Error while loading: " << ex.what() << '\n';
+    this->errorMessage = QString("Error while loading statistics data: ") + QString(ex.what());
+    this->error        = true;
+  }
+}
+
+void StatisticsFileBinary::readHeaderFromFile(StatisticsData &statisticsData)
+{
+  if (!this->file.isOk())
+    return;
+
+  try
+  {
+    const auto fileSize = this->file.getFileSize();
+
+    QByteArray header;
+    if (this->file.readBytes(header, 0, HEADER_SIZE) != HEADER_SIZE)
+      throw "The file is too small";
+    ByteReader headerReader(header);
+    if (std::memcmp(headerReader.take(sizeof(MAGIC)), MAGIC, sizeof(MAGIC)) != 0)
+      throw "The file is not a binary statistics file";
+    if (headerReader.read<quint32>() != FORMAT_VERSION)
+      throw "The version of the file is not supported";
+    auto width          = headerReader.read<quint32>();
+    auto height         = headerReader.read<quint32>();
+    auto nrTypes        = headerReader.read<quint32>();
+    this->framerate     = headerReader.readDouble();
+    auto recordsOffset  = int64_t(headerReader.read<quint64>());
+    auto indexOffset    = int64_t(headerReader.read<quint64>());
+    auto nrIndexEntries = headerReader.read<quint32>();
+    this->maxPOC        = headerReader.read<qint32>();
+    if (recordsOffset < HEADER_SIZE || indexOffset < recordsOffset || indexOffset > fileSize)
+      throw "Invalid offsets in the header";
+
+    statisticsData.clear();
+    statisticsData.setFrameSize(Size(width, height));
+
+    QByteArray types;
+    if (this->file.readBytes(types, HEADER_SIZE, recordsOffset - HEADER_SIZE) !=
+        recordsOffset - HEADER_SIZE)
+      throw "Error reading the types";
+    ByteReader typeReader(types);
+    for (unsigned i = 0; i < nrTypes; i++)
+    {
+      auto type = readType(typeReader);
+      type.setInitialState();
+      statisticsData.addStatType(type);
+    }
+
+    // The index must fit into the file. This also prevents huge allocations for corrupt files.
+    const auto indexSize = int64_t(nrIndexEntries) * INDEX_ENTRY_SIZE;
+    if (indexOffset + indexSize > fileSize)
+      throw "The index exceeds the file size";
+    QByteArray index;
+    if (this->file.readBytes(index, indexOffset, indexSize) != indexSize)
+      throw "Error reading the index";
+    ByteReader indexReader(index);
+    for (unsigned i = 0; i < nrIndexEntries; i++)
+    {
+      auto       poc    = indexReader.read<qint32>();
+      auto       typeID = indexReader.read<qint32>();
+      IndexEntry entry;
+      entry.offset           = int64_t(indexReader.read<quint64>());
+      entry.size             = int64_t(indexReader.read<quint64>());
+      entry.nrValues         = indexReader.read<quint32>();
+      entry.nrVectors        = indexReader.read<quint32>();
+      entry.nrAffineTFs      = indexReader.read<quint32>();
+      entry.nrPolygonValues  = indexReader.read<quint32>();
+      entry.nrPolygonVectors = indexReader.read<quint32>();
+      entry.maxBlockSize     = indexReader.read<quint32>();
+      if (entry.offset < recordsOffset || entry.offset > indexOffset || entry.size < 0 ||
+          entry.size > indexOffset - entry.offset)
+        throw "Invalid entry in the index";
+      this->pocTypeIndex[poc][typeID] = entry;
+    }
+
+    this->fileSortedByPOC = true;
+    this->parsingProgress = 100.0;
+  }
+  catch (const char *str)
+  {
+    std::cerr << "Error while parsing the header: " << str << '\n';
+    this->errorMessage = QString("Error while parsing the header: ") + QString(str);
+    this->error        = true;
+  }
+  catch (const std::exception &ex)
+  {
+    std::cerr << "Error while parsing the header: " << ex.what() << '\n';
+    this->errorMessage = QString("Error while parsing the header: ") + QString(ex.what());
+    this->error        = true;
+  }
+}
+
+bool StatisticsFileBinary::convertFile(StatisticsFileBase &source,
+                                       StatisticsData &    statisticsData,
+                                       const QString &     filename,
+                                       QString &           errorMessage)
+{
+  QFile file(filename);
+  if (!file.open(QIODevice::WriteOnly))
+  {
+    errorMessage = "Error opening the file " + filename;
+    return false;
+  }
+  auto writeData = [&file](const QByteArray &data) { return file.write(data) == data.size(); };
+
+  const auto &types = statisticsData.getStatisticsTypes();
+  ByteWriter  typeWriter;
+  for (const auto &type : types)
+    writeType(typeWriter, type);
+
+  // The header is written again when the position of the index is known
+  const auto recordsOffset = HEADER_SIZE + typeWriter.data.size();
+  auto       ok = writeData(QByteArray(int(HEADER_SIZE), char(0))) && writeData(typeWriter.data);
+
+  ByteWriter indexWriter;
+  quint32    nrIndexEntries = 0;
+  auto       offset         = recordsOffset;
+  for (int poc = 0; ok && poc <= source.getMaxPoc(); poc++)
+  {
+    // Loading one type may also load the other types of the POC (interleaved CSV files). So the
+    // cache is cleared once per POC and only the types that are not in it yet are loaded.
+    statisticsData.setFrameIndex(-1);
+    for (const auto &type : types)
+      if (!statisticsData.hasDataForTypeID(type.typeID))
+        source.loadStatisticData(statisticsData, poc, type.typeID);
+    if (!source)
+    {
+      errorMessage = QString("Error loading the statistics of frame %1").arg(poc);
+      return false;
+    }
+
+    for (const auto &type : types)
+    {
+      const auto &data = statisticsData[type.typeID];
+      if (data.valueData.empty() && data.vectorData.empty() && data.affineTFData.empty() &&
+          data.polygonValueData.empty() && data.polygonVectorData.empty())
+        continue;
+
+      ByteWriter records;
+      writeRecords(records, data);
+      ok &= writeData(records.data);
+
+      indexWriter.write(qint32(poc));
+      indexWriter.write(qint32(type.typeID));
+      indexWriter.write(quint64(offset));
+      indexWriter.write(quint64(records.data.size()));
+      indexWriter.write(quint32(data.valueData.size()));
+      indexWriter.write(quint32(data.vectorData.size()));
+      indexWriter.write(quint32(data.affineTFData.size()));
+      indexWriter.write(quint32(data.polygonValueData.size()));
+      indexWriter.write(quint32(data.polygonVectorData.size()));
+      indexWriter.write(quint32(data.maxBlockSize));
+      offset += records.data.size();
+      nrIndexEntries++;
+    }
+  }
+  statisticsData.setFrameIndex(-1);
+
+  ByteWriter header;
+  header.data.append(MAGIC, int(sizeof(MAGIC)));
+  header.write(FORMAT_VERSION);
+  header.write(quint32(statisticsData.getFrameSize().width));
+  header.write(quint32(statisticsData.getFrameSize().height));
+  header.write(quint32(types.size()));
+  header.writeDouble(source.getFramerate());
+  header.write(quint64(recordsOffset));
+  header.write(quint64(offset));
+  header.write(nrIndexEntries);
+  header.write(qint32(source.getMaxPoc()));
+
+  ok = ok && writeData(indexWriter.data) && file.seek(0) && writeData(header.data);
+  if (!ok)
+  {
+    errorMessage = "Error writing the file " + filename;
+    return false;
+  }
+  return true;
+}
+
+} // namespace stats
@@ -0,0 +1,103 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "StatisticsFileBase.h"
+
+namespace stats
+{
+
+/* A compact binary statistics format (*.yuvstats). The file starts with a header and the
+ * definitions of all statistics types. The data of every POC/type is stored as packed columns and
+ * an index at the end of the file contains the position of the data of every POC/type. So there is
+ * no need to scan the file in the background and the data can be copied from the (memory mapped)
+ * file without parsing any text. All values are little endian. The layout is:
+ *
+ * Header: "YUVSTATS", version, width, height, number of types, framerate, offset of the records,
+ *         offset of the index, number of index entries, maximum POC
+ * Types:  ID, name, description, flags and the colors/styles of every type
+ * Data:   The arrays of FrameTypeData one after another (value, vector and affine blocks, polygon
+ *         values and polygon vectors). Polygons store the number of corners of every polygon
+ *         followed by all corners. The line arrays of the vectors are preceded by the number of
+ *         lines. So every array can be copied from the file at once.
+ * Index:  POC, type, offset, size and the number of records of every POC/type
+ *
+ * Files can be converted from any other statistics file using convertFile().
+ */
+class StatisticsFileBinary : public StatisticsFileBase
+{
+public:
+  StatisticsFileBinary(const QString &filename, StatisticsData &statisticsData);
+  virtual ~StatisticsFileBinary() = default;
+
+  double getFramerate() const override { return this->framerate; }
+
+  // The index is read in the constructor so there is nothing to do here.
+  void readFrameAndTypePositionsFromFile(std::atomic_bool &breakFunction) override;
+
+  // Copy the records of "poc/type" from file and put them into the statisticsData.
+  void loadStatisticData(StatisticsData &statisticsData, int poc, int typeID) override;
+
+  // Write all POCs and types of the source file to a binary statistics file. The statisticsData
+  // must be the one that the source was created with and the positions in the source file must
+  // already be parsed (readFrameAndTypePositionsFromFile). Returns false and sets the
+  // errorMessage on failure.
+  static bool convertFile(StatisticsFileBase &source,
+                          StatisticsData &    statisticsData,
+                          const QString &     filename,
+                          QString &           errorMessage);
+
+private:
+  //! Read the header, the types and the index
+  void readHeaderFromFile(StatisticsData &statisticsData);
+
+  struct IndexEntry
+  {
+    int64_t  offset{};
+    int64_t  size{};
+    uint32_t nrValues{};
+    uint32_t nrVectors{};
+    uint32_t nrAffineTFs{};
+    uint32_t nrPolygonValues{};
+    uint32_t nrPolygonVectors{};
+    unsigned maxBlockSize{};
+  };
+
+  double framerate{-1};
+
+  // The index entries pocTypeIndex[poc][typeID]
+  using TypeIndexMap = std::map<int, IndexEntry>;
+  std::map<int, TypeIndexMap> pocTypeIndex;
+};
+
+} // namespace stats
@@ -32,7 +32,14 @@
 
 #include "StatisticsFileCSV.h"
 
+#include <QFileInfo>
 #include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <climits>
+#include <cstring>
+#include <functional>
 #include <iostream>
 
 namespace stats
@@ -47,6 +54,9 @@ namespace
 constexpr unsigned STAT_PARSING_BUFFER_SIZE = 1048576u;
 constexpr unsigned STAT_MAX_STRING_SIZE     = 1u << 28;
 
+// The file is scanned in chunks of this size in parallel
+constexpr int64_t STAT_PARSING_CHUNK_SIZE = 16 * 1024 * 1024;
+
 QStringList parseCSVLine(const QString &srcLine, char delimiter)
 {
   // first, trim newline and white spaces from both ends of line
@@ -55,6 +65,171 @@ QStringList parseCSVLine(const QString &srcLine, char delimiter)
   return line.split(delimiter);
 }
 
+// Get the POC (first column) and the type (sixth column) of a line without converting the whole
+// line. Like parseCSVLine, spaces are ignored and a column that is not a number is read as 0.
+// Returns false for empty lines, header lines (starting with %) and lines with less than six
+// columns.
+bool parsePOCAndType(const char *begin, const char *end, int &poc, int &typeID)
+{
+  unsigned column   = 0;
+  int64_t  value    = 0;
+  bool     isNumber = true;
+  bool     isEmpty  = true;
+  bool     negative = false;
+  for (auto c = begin;; c++)
+  {
+    if (c == end || *c == ';')
+    {
+      const auto columnValue = (isNumber && !isEmpty) ? int(negative ? -value : value) : 0;
+      if (column == 0)
+      {
+        if (isEmpty)
+          return false;
+        poc = columnValue;
+      }
+      else if (column == 5)
+      {
+        typeID = columnValue;
+        return true;
+      }
+      if (c == end)
+        return false;
+
+      column++;
+      value    = 0;
+      isNumber = true;
+      isEmpty  = true;
+      negative = false;
+    }
+    else if (*c != ' ' && *c != '\t' && *c != '\r')
+    {
+      if (column == 0 && isEmpty && *c == '%')
+        return false;
+      if (*c == '-' && isEmpty)
+        negative = true;
+      else if (*c >= '0' && *c <= '9' && value <= INT_MAX)
+        value = value * 10 + (*c - '0');
+      else
+        isNumber = false;
+      isEmpty = false;
+    }
+  }
+}
+
+// The position in the file where the lines of a new POC/type start
+struct POCTypeStart
+{
+  int      poc{};
+  int      typeID{};
+  uint64_t filePos{};
+};
+
+struct ChunkScanResult
+{
+  std::vector<POCTypeStart> starts;
+  bool                      readError{};
+};
+
+// Scan the lines that start in the range [chunkStart, chunkEnd) of the file and get the positions
+// where the POC or the type changes. A line that starts in the range is read to its end even if
+// it continues after chunkEnd.
+ChunkScanResult scanChunk(const QString &               filename,
+                          int64_t                       chunkStart,
+                          int64_t                       chunkEnd,
+                          const std::function<bool()> &isAborted)
+{
+  ChunkScanResult result;
+
+  // Every chunk is read with its own file so that the chunks can be read in parallel
+  QFile inputFile(filename);
+  if (!inputFile.open(QIODevice::ReadOnly))
+  {
+    result.readError = true;
+    return result;
+  }
+
+  // If the chunk does not start at the beginning of a line, the partial line belongs to the
+  // previous chunk. Start reading one byte early to see if the chunk starts with a new line.
+  auto skipLine       = chunkStart > 0;
+  auto bufferStartPos = skipLine ? chunkStart - 1 : int64_t(0);
+  auto lineStartPos   = chunkStart;
+
+  int  lastPOC  = INT_INVALID;
+  int  lastType = INT_INVALID;
+  bool first    = true;
+
+  auto parseLine = [&](const char *begin, const char *end) {
+    int poc, typeID;
+    if (!parsePOCAndType(begin, end, poc, typeID))
+      return;
+    if (first || poc != lastPOC || typeID != lastType)
+      result.starts.push_back({poc, typeID, uint64_t(lineStartPos)});
+    first    = false;
+    lastPOC  = poc;
+    lastType = typeID;
+  };
+
+  QByteArray inputBuffer(int(STAT_PARSING_BUFFER_SIZE), 0);
+  QByteArray lineBuffer;
+  while (!isAborted())
+  {
+    if (!inputFile.seek(bufferStartPos))
+    {
+      result.readError = true;
+      return result;
+    }
+    const auto bufferSize = inputFile.read(inputBuffer.data(), STAT_PARSING_BUFFER_SIZE);
+    if (bufferSize < 0)
+    {
+      result.readError = true;
+      return result;
+    }
+
+    const auto bufferStart = inputBuffer.constData();
+    const auto bufferEnd   = bufferStart + bufferSize;
+    auto       lineStart   = bufferStart;
+    while (auto newline =
+               static_cast<const char *>(std::memchr(lineStart, '\n', bufferEnd - lineStart)))
+    {
+      if (!skipLine)
+      {
+        if (lineStartPos >= chunkEnd)
+          return result;
+        if (lineBuffer.isEmpty())
+          parseLine(lineStart, newline);
+        else
+        {
+          // The line started in the previous buffer
+          lineBuffer.append(lineStart, int(newline - lineStart));
+          parseLine(lineBuffer.constData(), lineBuffer.constData() + lineBuffer.size());
+          lineBuffer.clear();
+        }
+      }
+      skipLine     = false;
+      lineStart    = newline + 1;
+      lineStartPos = bufferStartPos + (lineStart - bufferStart);
+    }
+
+    if (bufferSize < STAT_PARSING_BUFFER_SIZE)
+    {
+      // The file is at the end. The last line may have no newline at the end.
+      lineBuffer.append(lineStart, int(bufferEnd - lineStart));
+      if (!skipLine && lineStartPos < chunkEnd && !lineBuffer.isEmpty())
+        parseLine(lineBuffer.constData(), lineBuffer.constData() + lineBuffer.size());
+      return result;
+    }
+
+    // a corrupted file may contain an arbitrary amount of non-\n symbols
+    // prevent lineBuffer overflow by dumping it for such cases
+    if (unsigned(lineBuffer.size()) > STAT_MAX_STRING_SIZE)
+      lineBuffer.clear();
+    if (!skipLine)
+      lineBuffer.append(lineStart, int(bufferEnd - lineStart));
+    bufferStartPos += bufferSize;
+  }
+  return result;
+}
+
 } // namespace
 
 StatisticsFileCSV::StatisticsFileCSV(const QString &filename, StatisticsData &statisticsData)
@@ -68,6 +243,10 @@ StatisticsFileCSV::StatisticsFileCSV(const QString &filename, StatisticsData &st
  * we can directly jump there and parse the actual information. This way we don't have to
  * scan the whole file which can get very slow for large files.
  *
+ * The file is split into chunks that are scanned in parallel. The positions found in the chunks
+ * are merged in file order so that the sorting of the file can be checked like in a sequential
+ * scan and the readPOCType signals are emitted while the later chunks are still scanned.
+ *
  * This function might emit the objectInformationChanged() signal if something went wrong,
  * setting the error message, or if parsing finished successfully.
  */
@@ -75,142 +254,50 @@ void StatisticsFileCSV::readFrameAndTypePositionsFromFile(std::atomic_bool &brea
 {
   try
   {
-    // Open the file (again). Since this is a background process, we open the file again to
-    // not disturb any reading from not background code.
-    FileSource inputFile;
-    if (!inputFile.openFile(this->file.getAbsoluteFilePath()))
-      return;
+    const auto filename = this->file.getAbsoluteFilePath();
+    const auto fileSize = int64_t(QFileInfo(filename).size());
 
-    // We perform reading using an input buffer
-    QByteArray inputBuffer;
-    bool       fileAtEnd      = false;
-    uint64_t   bufferStartPos = 0;
+    this->parsingProgress = 0;
 
-    QString  lineBuffer;
-    uint64_t lineBufferStartPos = 0;
-    int      lastPOC            = INT_INVALID;
-    int      lastType           = INT_INVALID;
-    bool     sortingFixed       = false;
+    // The pool waits for all chunks when it is destroyed. So everything that the chunks access
+    // must be declared before it.
+    std::atomic_bool abortScan{false};
+    auto             isAborted = [&]() {
+      return abortScan.load() || breakFunction.load() || this->abortParsingDestroy;
+    };
+    QThreadPool pool;
 
-    this->parsingProgress = 0;
+    std::vector<QFuture<ChunkScanResult>> chunkResults;
+    for (int64_t chunkStart = 0; chunkStart < fileSize; chunkStart += STAT_PARSING_CHUNK_SIZE)
+    {
+      const auto chunkEnd = std::min(chunkStart + STAT_PARSING_CHUNK_SIZE, fileSize);
+      chunkResults.push_back(QtConcurrent::run(
+          &pool, [=]() { return scanChunk(filename, chunkStart, chunkEnd, isAborted); }));
+    }
 
-    while (!fileAtEnd && !breakFunction.load() && !this->abortParsingDestroy)
+    try
     {
-      // Fill the buffer
-      auto bufferSize = inputFile.readBytes(inputBuffer, bufferStartPos, STAT_PARSING_BUFFER_SIZE);
-      if (bufferSize < 0)
-        return; // Error reading bytes from file
-      if (bufferSize < STAT_PARSING_BUFFER_SIZE)
-        // Less bytes than the maximum buffer size were read. The file is at the end.
-        // This is the last run of the loop.
-        fileAtEnd = true;
-      // a corrupted file may contain an arbitrary amount of non-\n symbols
-      // prevent lineBuffer overflow by dumping it for such cases
-      if (unsigned(lineBuffer.size()) > STAT_MAX_STRING_SIZE)
-        lineBuffer.clear(); // prevent an overflow here
-      for (size_t i = 0; i < size_t(bufferSize); i++)
+      SortingState state;
+      for (size_t i = 0; i < chunkResults.size(); i++)
       {
-        // Search for '\n' newline characters
-        if (inputBuffer.at(int(i)) == 10)
-        {
-          // We found a newline character
-          if (lineBuffer.size() > 0)
-          {
-            // Parse the previous line
-            // get components of this line
-            auto rowItemList = parseCSVLine(lineBuffer, ';');
-
-            // ignore empty entries and headers
-            if (!rowItemList[0].isEmpty() && rowItemList[0][0] != '%')
-            {
-              // check for POC/type information
-              auto poc    = rowItemList[0].toInt();
-              auto typeID = rowItemList[5].toInt();
-
-              if (lastType == -1 && lastPOC == -1)
-              {
-                // First POC/type line
-                this->pocTypeFileposMap[poc][typeID] = lineBufferStartPos;
-                emit readPOCType(poc, typeID);
-
-                lastType = typeID;
-                lastPOC  = poc;
-
-                // update number of frames
-                if (poc > this->maxPOC)
-                  this->maxPOC = poc;
-              }
-              else if (typeID != lastType && poc == lastPOC)
-              {
-                // we found a new type but the POC stayed the same.
-                // This seems to be an interleaved file
-                // Check if we already collected a start position for this type
-                if (!sortingFixed)
-                {
-                  // we only check the first occurence of this, in a non-interleaved file
-                  // the above condition can be met and will reset fileSortedByPOC
-
-                  this->fileSortedByPOC = true;
-                  sortingFixed          = true;
-                }
-                lastType = typeID;
-                if (this->pocTypeFileposMap[poc].count(typeID) == 0)
-                {
-                  this->pocTypeFileposMap[poc][typeID] = lineBufferStartPos;
-                  emit readPOCType(poc, typeID);
-                }
-              }
-              else if (poc != lastPOC)
-              {
-                // this is apparently not sorted by POCs and we will not check it further
-                if (!sortingFixed)
-                  sortingFixed = true;
-
-                // We found a new POC
-                if (this->fileSortedByPOC)
-                {
-                  // There must not be a start position for any type with this POC already.
-                  if (this->pocTypeFileposMap.count(poc) > 0)
-                    throw "The data for each POC must be continuous in an interleaved statistics "
-                          "file";
-                }
-                else
-                {
-                  // There must not be a start position for this POC/type already.
-                  if (this->pocTypeFileposMap.count(poc) > 0 &&
-                      this->pocTypeFileposMap[poc].count(typeID) > 0)
-                    throw "The data for each typeID must be continuous in an non interleaved "
-                          "statistics file";
-                }
-
-                lastPOC  = poc;
-                lastType = typeID;
-
-                this->pocTypeFileposMap[poc][typeID] = lineBufferStartPos;
-                emit readPOCType(poc, typeID);
-
-                // update number of frames
-                if (poc > this->maxPOC)
-                  this->maxPOC = poc;
-
-                // Update percent of file parsed
-                this->parsingProgress =
-                    ((double)lineBufferStartPos * 100 / (double)inputFile.getFileSize());
-              }
-            }
-          }
+        const auto result = chunkResults[i].result();
+        if (isAborted())
+          return;
+        if (result.readError)
+          throw "Error reading bytes from file";
 
-          lineBuffer.clear();
-          lineBufferStartPos = bufferStartPos + i + 1;
-        }
-        else
-        {
-          // No newline character found
-          lineBuffer.append(inputBuffer.at(int(i)));
-        }
-      }
+        for (const auto &start : result.starts)
+          this->addPOCTypeStart(state, start.poc, start.typeID, start.filePos);
 
-      bufferStartPos += bufferSize;
+        // Update percent of file parsed
+        this->parsingProgress = double(i + 1) * 100 / double(chunkResults.size());
+      }
+    }
+    catch (...)
+    {
+      // Don't let the pool wait for the remaining chunks
+      abortScan.store(true);
+      throw;
     }
 
     this->parsingProgress = 100.0;
@@ -229,6 +316,74 @@ void StatisticsFileCSV::readFrameAndTypePositionsFromFile(std::atomic_bool &brea
   }
 }
 
+void StatisticsFileCSV::addPOCTypeStart(SortingState &state, int poc, int typeID, uint64_t filePos)
+{
+  if (state.lastType == -1 && state.lastPOC == -1)
+  {
+    // First POC/type line
+    this->pocTypeFileposMap[poc][typeID] = filePos;
+    emit readPOCType(poc, typeID);
+
+    state.lastType = typeID;
+    state.lastPOC  = poc;
+
+    // update number of frames
+    if (poc > this->maxPOC)
+      this->maxPOC = poc;
+  }
+  else if (typeID != state.lastType && poc == state.lastPOC)
+  {
+    // we found a new type but the POC stayed the same.
+    // This seems to be an interleaved file
+    // Check if we already collected a start position for this type
+    if (!state.sortingFixed)
+    {
+      // we only check the first occurence of this, in a non-interleaved file
+      // the above condition can be met and will reset fileSortedByPOC
+
+      this->fileSortedByPOC = true;
+      state.sortingFixed    = true;
+    }
+    state.lastType = typeID;
+    if (this->pocTypeFileposMap[poc].count(typeID) == 0)
+    {
+      this->pocTypeFileposMap[poc][typeID] = filePos;
+      emit readPOCType(poc, typeID);
+    }
+  }
+  else if (poc != state.lastPOC)
+  {
+    // this is apparently not sorted by POCs and we will not check it further
+    if (!state.sortingFixed)
+      state.sortingFixed = true;
+
+    // We found a new POC
+    if (this->fileSortedByPOC)
+    {
+      // There must not be a start position for any type with this POC already.
+      if (this->pocTypeFileposMap.count(poc) > 0)
+        throw "The data for each POC must be continuous in an interleaved statistics file";
+    }
+    else
+    {
+      // There must not be a start position for this POC/type already.
+      if (this->pocTypeFileposMap.count(poc) > 0 &&
+          this->pocTypeFileposMap[poc].count(typeID) > 0)
+        throw "The data for each typeID must be continuous in an non interleaved statistics file";
+    }
+
+    state.lastPOC  = poc;
+    state.lastType = typeID;
+
+    this->pocTypeFileposMap[poc][typeID] = filePos;
+    emit readPOCType(poc, typeID);
+
+    // update number of frames
+    if (poc > this->maxPOC)
+      this->maxPOC = poc;
+  }
+}
+
 void StatisticsFileCSV::loadStatisticData(StatisticsData &statisticsData, int poc, int typeID)
 {
   if (!this->file.isOk())
@@ -262,6 +417,9 @@ void StatisticsFileCSV::loadStatisticData(StatisticsData &statisticsData, int po
     QTextStream in(this->file.getQFile());
     in.seek(startPos);
 
+    // Parse into a separate map. In files sorted by POC, all types of the POC are read at once.
+    // Types that are already loaded for the POC (e.g. from the frame cache) are not touched.
+    FrameTypeDataMap frameData;
     while (!in.atEnd())
     {
       // read one line
@@ -320,13 +478,19 @@ void StatisticsFileCSV::loadStatisticData(StatisticsData &statisticsData, int po
       Q_ASSERT_X(statIt != statTypes.end(), Q_FUNC_INFO, "Stat type not found.");
 
       if (vectorData && statIt->hasVectorData)
-        statisticsData[type].addBlockVector(posX, posY, width, height, values[0], values[1]);
+        frameData[type].addBlockVector(posX, posY, width, height, values[0], values[1]);
       else if (lineData && statIt->hasVectorData)
-        statisticsData[type].addLine(
+        frameData[type].addLine(
             posX, posY, width, height, values[0], values[1], values[2], values[3]);
       else
-        statisticsData[type].addBlockValue(posX, posY, width, height, values[0]);
+        frameData[type].addBlockValue(posX, posY, width, height, values[0]);
     }
+
+    std::unique_lock<std::mutex> lock(statisticsData.accessMutex);
+    statisticsData[typeID] = std::move(frameData[typeID]);
+    for (auto &typeData : frameData)
+      if (!statisticsData.hasDataForTypeID(typeData.first))
+        statisticsData[typeData.first] = std::move(typeData.second);
   }
   catch (const char *str)
   {
@@ -61,6 +61,17 @@ protected:
   //! Scan the header: What types are saved in this file?
   void readHeaderFromFile(StatisticsData &statisticsData);
 
+  // The state of the sequential check of the sorting of the file
+  struct SortingState
+  {
+    int  lastPOC{INT_INVALID};
+    int  lastType{INT_INVALID};
+    bool sortingFixed{};
+  };
+  // Add the position where the lines of a new POC/type start. The positions must be added in file
+  // order. Throws if the data of a POC/type is not continuous.
+  void addPOCTypeStart(SortingState &state, int poc, int typeID, uint64_t filePos);
+
   double framerate{-1};
 
   // File positions pocTypeFileposMap[poc][typeID]
@@ -33,22 +33,259 @@
 #include "StatisticsFileVTMBMS.h"
 
 #include <QRegularExpression>
-#include <QTextStream>
 
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <iostream>
 
 namespace stats
 {
 
-// The internal buffer for parsing the starting positions. The buffer must not be larger than 2GB
-// so that we can address all the positions in it with int (using such a large buffer is not a good
+// The size of the blocks in which the file is read. The buffer must not be larger than 2GB so
+// that we can address all the positions in it with int (using such a large buffer is not a good
 // idea anyways)
 constexpr unsigned STAT_PARSING_BUFFER_SIZE = 1048576u;
 constexpr unsigned STAT_MAX_STRING_SIZE     = 1u << 28;
 
+namespace
+{
+
+// A minimal parser for the text of one line. It works directly on the bytes of the file so that
+// no QString or regular expression is needed.
+class LineParser
+{
+public:
+  LineParser(const char *begin, const char *end) : pos(begin), end(end) {}
+
+  void skipSpaces()
+  {
+    while (this->pos < this->end && (*this->pos == ' ' || *this->pos == '\t' || *this->pos == '\r'))
+      this->pos++;
+  }
+
+  // Skip spaces and the given character/text. Return false if it does not follow.
+  bool expect(char c)
+  {
+    this->skipSpaces();
+    if (this->pos == this->end || *this->pos != c)
+      return false;
+    this->pos++;
+    return true;
+  }
+  bool expect(const char *text)
+  {
+    this->skipSpaces();
+    const auto length = size_t(std::strlen(text));
+    if (size_t(this->end - this->pos) < length || std::memcmp(this->pos, text, length) != 0)
+      return false;
+    this->pos += length;
+    return true;
+  }
+
+  // Search for the given text and skip everything up to and including it. Return false if the
+  // text is not found.
+  bool skipTo(const char *text)
+  {
+    const auto length = size_t(std::strlen(text));
+    const auto found  = std::search(this->pos, this->end, text, text + length);
+    if (found == this->end)
+      return false;
+    this->pos = found + length;
+    return true;
+  }
+
+  // Skip spaces and return true if the next character is c (without skipping it)
+  bool peek(char c)
+  {
+    this->skipSpaces();
+    return this->pos < this->end && *this->pos == c;
+  }
+
+  // Skip spaces and read a decimal number with an optional minus sign
+  bool readInt(int &value)
+  {
+    this->skipSpaces();
+    const auto negative = this->pos < this->end && *this->pos == '-';
+    if (negative)
+      this->pos++;
+    const auto digitsStart = this->pos;
+    int64_t    result      = 0;
+    while (this->pos < this->end && *this->pos >= '0' && *this->pos <= '9')
+    {
+      result = result * 10 + (*this->pos - '0');
+      if (result > INT_MAX)
+        return false;
+      this->pos++;
+    }
+    if (this->pos == digitsStart)
+      return false;
+    value = int(negative ? -result : result);
+    return true;
+  }
+
+  // Skip spaces and read a name up to the next space or '='
+  bool readName(const char *&nameBegin, const char *&nameEnd)
+  {
+    this->skipSpaces();
+    nameBegin = this->pos;
+    while (this->pos < this->end && *this->pos != '=' && *this->pos != ' ')
+      this->pos++;
+    nameEnd = this->pos;
+    return nameEnd != nameBegin;
+  }
+
+private:
+  const char *pos;
+  const char *end;
+};
+
+// The content of one BlockStat line after the POC
+struct BlockStatLine
+{
+  bool     isPolygon{};
+  int      x{};
+  int      y{};
+  unsigned width{};
+  unsigned height{};
+  Polygon  corners;
+
+  const char *nameBegin{};
+  const char *nameEnd{};
+
+  // The value is either a single scalar or a list of values in braces
+  bool isVector{};
+  int  values[6]{};
+  int  nrValues{};
+};
+
+// Parse the start of a line. There may be other text (like a log prefix) before the BlockStat:
+// BlockStat: POC 1
+bool parsePOC(LineParser &parser, int &poc)
+{
+  return parser.skipTo("BlockStat:") && parser.expect("POC") && parser.readInt(poc);
+}
+
+// Parse the rest of the line after the POC. For blocks and polygons with scalar or vector values:
+// @( 112,  88) [ 8x 8] PredMode=0
+// @( 120,  80) [ 8x 8] MVL0={ -24,  -2}
+// @( 192,  96) [64x32] AffineMVL0={-324,-116,-276,-116,-324, -92}
+// @( 192,  96) [64x32] Line={0,0,31,31}
+// @[(505, 384)--(511, 384)--(511, 415)--] GeoPUInterIntraFlag=0
+// @[(416, 448)--(447, 448)--(447, 478)--(416, 463)--] GeoMVL0={ 291, 233}
+bool parseBlockStat(LineParser &parser, BlockStatLine &line)
+{
+  if (!parser.expect('@'))
+    return false;
+
+  line.isPolygon = parser.expect('[');
+  if (line.isPolygon)
+  {
+    line.corners.clear();
+    while (parser.expect('('))
+    {
+      Point corner;
+      if (!parser.readInt(corner.x) || !parser.expect(',') || !parser.readInt(corner.y) ||
+          !parser.expect(')') || !parser.expect("--"))
+        return false;
+      line.corners.push_back(corner);
+    }
+    if (!parser.expect(']'))
+      return false;
+  }
+  else
+  {
+    int width, height;
+    if (!parser.expect('(') || !parser.readInt(line.x) || !parser.expect(',') ||
+        !parser.readInt(line.y) || !parser.expect(')') || !parser.expect('[') ||
+        !parser.readInt(width) || !parser.expect('x') || !parser.readInt(height) ||
+        !parser.expect(']') || line.x < 0 || line.y < 0 || width < 0 || height < 0)
+      return false;
+    line.width  = unsigned(width);
+    line.height = unsigned(height);
+  }
+
+  if (!parser.readName(line.nameBegin, line.nameEnd) || !parser.expect('='))
+    return false;
+
+  line.nrValues = 0;
+  line.isVector = parser.expect('{');
+  if (!line.isVector)
+  {
+    line.nrValues = 1;
+    return parser.readInt(line.values[0]);
+  }
+  do
+  {
+    if (line.nrValues == 6 || !parser.readInt(line.values[line.nrValues]))
+      return false;
+    line.nrValues++;
+  } while (parser.expect(','));
+  return parser.expect('}');
+}
+
+// Call the function for every line of the file starting at startPos with the start and end of
+// the line and the position of the line in the file. The file is read in blocks (without copying
+// if the file is mapped). Stop if the function returns false.
+template <typename Function>
+void forEachLine(FileSource &file, int64_t startPos, Function function)
+{
+  const auto fileSize = file.getFileSize();
+
+  QByteArray buffer;
+  QByteArray lineBuffer;
+  auto       bufferStartPos = startPos;
+  auto       lineStartPos   = startPos;
+  while (bufferStartPos < fileSize)
+  {
+    const auto blockSize  = std::min(int64_t(STAT_PARSING_BUFFER_SIZE), fileSize - bufferStartPos);
+    const auto bufferSize = file.readBytesZeroCopy(buffer, bufferStartPos, blockSize);
+    if (bufferSize <= 0)
+      throw "Error reading bytes";
+
+    const auto bufferStart = buffer.constData();
+    const auto bufferEnd   = bufferStart + bufferSize;
+    auto       lineStart   = bufferStart;
+    while (auto newline =
+               static_cast<const char *>(std::memchr(lineStart, '\n', bufferEnd - lineStart)))
+    {
+      auto goOn = true;
+      if (lineBuffer.isEmpty())
+        goOn = function(lineStart, newline, lineStartPos);
+      else
+      {
+        // The line started in the previous block
+        lineBuffer.append(lineStart, int(newline - lineStart));
+        goOn = function(
+            lineBuffer.constData(), lineBuffer.constData() + lineBuffer.size(), lineStartPos);
+        lineBuffer.clear();
+      }
+      if (!goOn)
+        return;
+
+      lineStart    = newline + 1;
+      lineStartPos = bufferStartPos + (lineStart - bufferStart);
+    }
+
+    // a corrupted file may contain an arbitrary amount of non-\n symbols
+    // prevent lineBuffer overflow by dumping it for such cases
+    if (unsigned(lineBuffer.size()) > STAT_MAX_STRING_SIZE)
+      lineBuffer.clear();
+    lineBuffer.append(lineStart, int(bufferEnd - lineStart));
+    bufferStartPos += bufferSize;
+  }
+
+  // The last line has no newline at the end
+  if (!lineBuffer.isEmpty())
+    function(lineBuffer.constData(), lineBuffer.constData() + lineBuffer.size(), lineStartPos);
+}
+
+} // namespace
+
 StatisticsFileVTMBMS::StatisticsFileVTMBMS(const QString &filename, StatisticsData &statisticsData)
     : StatisticsFileBase(filename)
 {
+  this->file.enableMemoryMapping();
   this->readHeaderFromFile(statisticsData);
 }
 
@@ -69,97 +306,33 @@ void StatisticsFileVTMBMS::readFrameAndTypePositionsFromFile(std::atomic_bool &b
     FileSource inputFile;
     if (!inputFile.openFile(this->file.getAbsoluteFilePath()))
       return;
-
-    // We perform reading using an input buffer
-    QByteArray inputBuffer;
-    bool       fileAtEnd      = false;
-    uint64_t   bufferStartPos = 0;
-
-    QString  lineBuffer;
-    uint64_t lineBufferStartPos = 0;
-    int      lastPOC            = INT_INVALID;
-    bool     sortingFixed       = false;
-
-    while (!fileAtEnd && !breakFunction.load() && !this->abortParsingDestroy)
-    {
-      // Fill the buffer
-      auto bufferSize = inputFile.readBytes(inputBuffer, bufferStartPos, STAT_PARSING_BUFFER_SIZE);
-      if (bufferSize < 0)
-        throw "Error reading bytes";
-      if (bufferSize < STAT_PARSING_BUFFER_SIZE)
-        // Less bytes than the maximum buffer size were read. The file is at the end.
-        // This is the last run of the loop.
-        fileAtEnd = true;
-      // a corrupted file may contain an arbitrary amount of non-\n symbols
-      // prevent lineBuffer overflow by dumping it for such cases
-      if (unsigned(lineBuffer.size()) > STAT_MAX_STRING_SIZE)
-        lineBuffer.clear(); // prevent an overflow here
-      for (size_t i = 0; i < size_t(bufferSize); i++)
-      {
-        // Search for '\n' newline characters
-        if (inputBuffer.at(int(i)) == 10)
-        {
-          // We found a newline character
-          if (lineBuffer.size() > 0)
-          {
-            // Parse the previous line
-            // get components of this line
-            // get poc using regular expression
-            // need to match this:
-            // BlockStat: POC 1 @( 120,  80) [ 8x 8] MVL0={ -24,  -2}
-            // BlockStat: POC 1 @( 112,  88) [ 8x 8] PredMode=0
-            QRegularExpression pocRegex("BlockStat: POC ([0-9]+)");
-            auto               match = pocRegex.match(lineBuffer);
-            // ignore not matching lines
-            if (match.hasMatch())
-            {
-              auto poc = match.captured(1).toInt();
-
-              if (lastPOC == -1)
-              {
-                // First POC
-                this->pocStartList[poc] = lineBufferStartPos;
-                emit readPOC(poc);
-
-                lastPOC = poc;
-
-                // update number of frames
-                if (poc > this->maxPOC)
-                  this->maxPOC = poc;
-              }
-              else if (poc != lastPOC)
-              {
-                // this is apparently not sorted by POCs and we will not check it further
-                if (!sortingFixed)
-                  sortingFixed = true;
-
-                lastPOC                 = poc;
-                this->pocStartList[poc] = lineBufferStartPos;
-                emit readPOC(poc);
-
-                // update number of frames
-                if (poc > this->maxPOC)
-                  this->maxPOC = poc;
-
-                // Update percent of file parsed
-                this->parsingProgress =
-                    ((double)lineBufferStartPos * 100 / (double)inputFile.getFileSize());
-              }
-            }
-          }
-
-          lineBuffer.clear();
-          lineBufferStartPos = bufferStartPos + i + 1;
-        }
-        else
-        {
-          // No newline character found
-          lineBuffer.append(inputBuffer.at(int(i)));
-        }
-      }
-
-      bufferStartPos += bufferSize;
-    }
+    inputFile.enableMemoryMapping();
+
+    const auto fileSize = double(inputFile.getFileSize());
+    auto       lastPOC  = INT_INVALID;
+    forEachLine(inputFile, 0, [&](const char *begin, const char *end, int64_t lineStartPos) {
+      if (breakFunction.load() || this->abortParsingDestroy)
+        return false;
+
+      // Only the POC at the start of the line is parsed. Ignore not matching lines.
+      LineParser parser(begin, end);
+      int        poc;
+      if (!parsePOC(parser, poc) || poc == lastPOC)
+        return true;
+
+      // A new POC starts here. If the file is not sorted by POC, the last start is used.
+      this->pocStartList[poc] = lineStartPos;
+      emit readPOC(poc);
+      lastPOC = poc;
+
+      // update number of frames
+      if (poc > this->maxPOC)
+        this->maxPOC = poc;
+
+      // Update percent of file parsed
+      this->parsingProgress = double(lineStartPos) * 100 / fileSize;
+      return true;
+    });
 
     // Parsing complete
     this->parsingProgress = 100.0;
@@ -200,202 +373,87 @@ void StatisticsFileVTMBMS::loadStatisticData(StatisticsData &statisticsData, int
       return;
     }
 
-    auto startPos = this->pocStartList[poc];
-
-    QTextStream in(this->file.getQFile());
-    in.seek(startPos);
-
-    QRegularExpression pocRegex("BlockStat: POC ([0-9]+)");
-
-    // prepare regex for selected type
     auto &statTypes = statisticsData.getStatisticsTypes();
     auto  statIt    = std::find_if(statTypes.begin(), statTypes.end(), [typeID](StatisticsType &t) {
       return t.typeID == typeID;
     });
     Q_ASSERT_X(statIt != statTypes.end(), Q_FUNC_INFO, "Stat type not found.");
-    QRegularExpression typeRegex(" " + statIt->typeName + "="); // for catching lines of the type
-
-    // for extracting scalar value statistics, need to match:
-    // BlockStat: POC 1 @( 112,  88) [ 8x 8] PredMode=0
-    QRegularExpression scalarRegex(
-        "POC ([0-9]+) @\\( *([0-9]+), *([0-9]+)\\) *\\[ *([0-9]+)x *([0-9]+)\\] *\\w+=([0-9\\-]+)");
-    // for extracting vector value statistics, need to match:
-    // BlockStat: POC 1 @( 120,  80) [ 8x 8] MVL0={ -24,  -2}
-    QRegularExpression vectorRegex("POC ([0-9]+) @\\( *([0-9]+), *([0-9]+)\\) *\\[ *([0-9]+)x "
-                                   "*([0-9]+)\\] *\\w+={ *([0-9\\-]+), *([0-9\\-]+)}");
-    // for extracting affine transform value statistics, need to match:
-    // BlockStat: POC 2 @( 192,  96) [64x32] AffineMVL0={-324,-116,-276,-116,-324, -92}
-    QRegularExpression affineTFRegex(
-        "POC ([0-9]+) @\\( *([0-9]+), *([0-9]+)\\) *\\[ *([0-9]+)x *([0-9]+)\\] *\\w+={ "
-        "*([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+)}");
-    // for extracting scalar polygon  statistics, need to match:
-    // BlockStat: POC 2 @[(505, 384)--(511, 384)--(511, 415)--] GeoPUInterIntraFlag=0
-    // BlockStat: POC 2 @[(416, 448)--(447, 448)--(447, 478)--(416, 463)--] GeoPUInterIntraFlag=0
-    // will capture 3-5 points. other polygons are not supported
-    QRegularExpression scalarPolygonRegex(
-        "POC ([0-9]+) @\\[((?:\\( *[0-9]+, *[0-9]+\\)--){3,5})\\] *\\w+=([0-9\\-]+)");
-    // for extracting vector polygon statistics:
-    QRegularExpression vectorPolygonRegex(
-        "POC ([0-9]+) @\\[((?:\\( *[0-9]+, *[0-9]+\\)--){3,5})\\] *\\w+={ *([0-9\\-]+), "
-        "*([0-9\\-]+)}");
-    // for extracting the partitioning line, we extract
-    // BlockStat: POC 2 @( 192,  96) [64x32] Line={0,0,31,31}
-    QRegularExpression lineRegex(
-        "POC ([0-9]+) @\\( *([0-9]+), *([0-9]+)\\) *\\[ *([0-9]+)x *([0-9]+)\\] *\\w+={ "
-        "*([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+)}");
-
-    while (!in.atEnd())
-    {
-      // read one line
-      auto aLine    = in.readLine();
-      auto pocMatch = pocRegex.match(aLine);
+    const auto typeName  = statIt->typeName.toUtf8();
+    const auto frameSize = statisticsData.getFrameSize();
+
+    FrameTypeData data;
+    BlockStatLine line;
+    auto          parseLine = [&](const char *begin, const char *end, int64_t) {
       // ignore not matching lines
-      if (pocMatch.hasMatch())
+      LineParser parser(begin, end);
+      int        pocRow;
+      if (!parsePOC(parser, pocRow))
+        return true;
+      // if there is a new POC, we are done here!
+      if (pocRow != poc)
+        return false;
+
+      auto valid = parseBlockStat(parser, line);
+
+      // filter lines of different types
+      if (valid && (line.nameEnd - line.nameBegin != typeName.size() ||
+                    std::memcmp(line.nameBegin, typeName.constData(), typeName.size()) != 0))
+        return true;
+
+      if (valid && !line.isPolygon)
       {
-        auto pocRow = pocMatch.captured(1).toInt();
-        if (poc != pocRow)
-          break;
-
-        // filter lines of different types
-        auto typeMatch = typeRegex.match(aLine);
-        if (typeMatch.hasMatch())
+        // Check if block is within the image range
+        if (this->blockOutsideOfFramePOC == -1 &&
+            (line.x + int(line.width) > int(frameSize.width) ||
+             line.y + int(line.height) > int(frameSize.height)))
+          // Block not in image. Warn about this.
+          this->blockOutsideOfFramePOC = poc;
+
+        const auto &v = line.values;
+        if (statIt->hasValueData)
         {
-          int      posX, posY, scalar, vecX, vecY;
-          unsigned width, height;
-
-          QRegularExpressionMatch statisitcMatch;
-          // extract statistics info
-          // try block types
-          if (statIt->isPolygon == false)
-          {
-            if (statIt->hasValueData)
-              statisitcMatch = scalarRegex.match(aLine);
-            else if (statIt->hasVectorData)
-            {
-              statisitcMatch = vectorRegex.match(aLine);
-              if (!statisitcMatch.hasMatch())
-                statisitcMatch = lineRegex.match(aLine);
-            }
-            else if (statIt->hasAffineTFData)
-              statisitcMatch = affineTFRegex.match(aLine);
-          }
-          else
-          // try polygons
-          {
-            if (statIt->hasValueData)
-              statisitcMatch = scalarPolygonRegex.match(aLine);
-            else if (statIt->hasVectorData)
-              statisitcMatch = vectorPolygonRegex.match(aLine);
-          }
-          if (!statisitcMatch.hasMatch())
-          {
-            this->errorMessage = QString("Error while parsing statistic: ") + QString(aLine);
-            continue;
-          }
-
-          // useful for debugging:
-          //        QStringList all_captured = statisitcMatch.capturedTexts();
-
-          pocRow = statisitcMatch.captured(1).toInt();
-          width  = statisitcMatch.captured(4).toUInt();
-          height = statisitcMatch.captured(5).toUInt();
-          // if there is a new POC, we are done here!
-          if (poc != pocRow)
-            break;
-
-          // process block statistics
-          if (statIt->isPolygon == false)
-          {
-            posX = statisitcMatch.captured(2).toInt();
-            posY = statisitcMatch.captured(3).toInt();
-
-            // Check if block is within the image range
-            if (blockOutsideOfFramePOC == -1 &&
-                (posX + int(width) > int(statisticsData.getFrameSize().width) ||
-                 posY + int(height) > int(statisticsData.getFrameSize().height)))
-              // Block not in image. Warn about this.
-              blockOutsideOfFramePOC = poc;
-
-            if (statIt->hasVectorData)
-            {
-              vecX = statisitcMatch.captured(6).toInt();
-              vecY = statisitcMatch.captured(7).toInt();
-              if (statisitcMatch.lastCapturedIndex() > 7)
-              {
-                auto vecX1 = statisitcMatch.captured(8).toInt();
-                auto vecY1 = statisitcMatch.captured(9).toInt();
-                statisticsData[typeID].addLine(posX, posY, width, height, vecX, vecY, vecX1, vecY1);
-              }
-              else
-              {
-                statisticsData[typeID].addBlockVector(posX, posY, width, height, vecX, vecY);
-              }
-            }
-            else if (statIt->hasAffineTFData)
-            {
-              auto vecX0 = statisitcMatch.captured(6).toInt();
-              auto vecY0 = statisitcMatch.captured(7).toInt();
-              auto vecX1 = statisitcMatch.captured(8).toInt();
-              auto vecY1 = statisitcMatch.captured(9).toInt();
-              auto vecX2 = statisitcMatch.captured(10).toInt();
-              auto vecY2 = statisitcMatch.captured(11).toInt();
-              statisticsData[typeID].addBlockAffineTF(
-                  posX, posY, width, height, vecX0, vecY0, vecX1, vecY1, vecX2, vecY2);
-            }
-            else
-            {
-              scalar = statisitcMatch.captured(6).toInt();
-              statisticsData[typeID].addBlockValue(posX, posY, width, height, scalar);
-            }
-          }
-          else
-          // process polygon statistics
-          {
-            auto               corners    = statisitcMatch.captured(2);
-            auto               cornerList = corners.split("--");
-            QRegularExpression cornerRegex("\\( *([0-9]+), *([0-9]+)\\)");
-            stats::Polygon     points;
-            for (const auto &corner : cornerList)
-            {
-              auto cornerMatch = cornerRegex.match(corner);
-              if (cornerMatch.hasMatch())
-              {
-                auto x = cornerMatch.captured(1).toInt();
-                auto y = cornerMatch.captured(2).toInt();
-                points.push_back({x, y});
-
-                // Check if polygon is within the image range
-                if (this->blockOutsideOfFramePOC == -1 &&
-                    (x + width > statisticsData.getFrameSize().width ||
-                     y + height > statisticsData.getFrameSize().height))
-                  // Block not in image. Warn about this.
-                  this->blockOutsideOfFramePOC = poc;
-              }
-            }
-
-            if (statIt->hasVectorData)
-            {
-              vecX = statisitcMatch.captured(3).toInt();
-              vecY = statisitcMatch.captured(4).toInt();
-              statisticsData[typeID].addPolygonVector(points, vecX, vecY);
-            }
-            else if (statIt->hasValueData)
-            {
-              scalar = statisitcMatch.captured(3).toInt();
-              statisticsData[typeID].addPolygonValue(points, scalar);
-            }
-          }
+          valid = !line.isVector;
+          if (valid)
+            data.addBlockValue(line.x, line.y, line.width, line.height, v[0]);
         }
+        else if (statIt->hasVectorData && line.isVector && line.nrValues == 2)
+          data.addBlockVector(line.x, line.y, line.width, line.height, v[0], v[1]);
+        else if (statIt->hasVectorData && line.isVector && line.nrValues == 4)
+          data.addLine(line.x, line.y, line.width, line.height, v[0], v[1], v[2], v[3]);
+        else if (statIt->hasAffineTFData && line.isVector && line.nrValues == 6)
+          data.addBlockAffineTF(
+              line.x, line.y, line.width, line.height, v[0], v[1], v[2], v[3], v[4], v[5]);
+        else
+          valid = false;
+      }
+      else if (valid)
+      {
+        // Polygons with 3 to 5 corners are supported
+        valid = line.corners.size() >= 3 && line.corners.size() <= 5;
+
+        // Check if polygon is within the image range
+        for (const auto &corner : line.corners)
+          if (this->blockOutsideOfFramePOC == -1 &&
+              (corner.x > int(frameSize.width) || corner.y > int(frameSize.height)))
+            // Block not in image. Warn about this.
+            this->blockOutsideOfFramePOC = poc;
+
+        if (valid && statIt->hasVectorData && line.isVector && line.nrValues == 2)
+          data.addPolygonVector(line.corners, line.values[0], line.values[1]);
+        else if (valid && statIt->hasValueData && !line.isVector)
+          data.addPolygonValue(line.corners, line.values[0]);
+        else
+          valid = false;
       }
-    }
 
-    if (!statisticsData.hasDataForTypeID(typeID))
-    {
-      // There are no statistics in the file for the given frame and index.
-      statisticsData[typeID] = {};
-      return;
-    }
+      if (!valid)
+        this->errorMessage = QString("Error while parsing statistic: ") +
+                             QString::fromUtf8(begin, int(end - begin));
+      return true;
+    };
+    forEachLine(this->file, this->pocStartList[poc], parseLine);
 
+    statisticsData[typeID] = std::move(data);
   } // try
   catch (const char *str)
   {
@@ -106,6 +106,10 @@ public:
   void    setMappingValues(std::vector<QString> values);
   QString getMappedValue(int typeID) const;
 
+  // Access the whole map of values to text (e.g. to write it to a file)
+  const std::map<int, QString> &getValueMap() const { return this->valMap; }
+  void setValueMap(const std::map<int, QString> &valueMap) { this->valMap = valueMap; }
+
   // Is this statistics type rendered and what is the alpha value?
   // These are corresponding to the controls in the properties panel
   bool render{};
@@ -32,6 +32,7 @@
 
 #include "YUViewApplication.h"
 
+#include <batch/BatchProcessor.h>
 #include <common/Typedef.h>
 #include <handler/SingleInstanceHandler.h>
 #include <ui/mainwindow.h>
@@ -63,6 +64,15 @@ YUViewApplication::YUViewApplication(int argc, char *argv[]) : QApplication(argc
   QStringList args = arguments();
   DEBUG_APP("YUViewApplication args" << args);
 
+  if (args.size() > 1 && args[1] == BatchProcessor::BatchArgument)
+  {
+    // Process the given files without showing a window
+    DEBUG_APP("YUViewApplication batch mode");
+    BatchProcessor batchProcessor;
+    returnCode = batchProcessor.run(args.mid(2));
+    return;
+  }
+
   QScopedPointer<singleInstanceHandler> instance;
   if (WIN_LINUX_SINGLE_INSTANCE && (is_Q_OS_WIN || is_Q_OS_LINUX))
   {
@@ -225,7 +225,11 @@ void PlaybackController::nextFrame()
   // Abort playback (if running) and go to the next frame (if possible).
   pausePlayback();
   if (currentFrameIdx < frameSlider->maximum())
+  {
+    const auto previousFrameIdx = currentFrameIdx;
     setCurrentFrame(currentFrameIdx + 1);
+    updateFrameAccessPattern(previousFrameIdx);
+  }
 }
 
 void PlaybackController::previousFrame()
@@ -233,14 +237,20 @@ void PlaybackController::previousFrame()
   // Abort playback (if running) and go to the previous frame (if possible).
   pausePlayback();
   if (currentFrameIdx != frameSlider->minimum())
+  {
+    const auto previousFrameIdx = currentFrameIdx;
     setCurrentFrame(currentFrameIdx - 1);
+    updateFrameAccessPattern(previousFrameIdx);
+  }
 }
 
 void PlaybackController::on_frameSlider_valueChanged(int value)
 {
   // Stop playback (if running) and go to the new frame.
   pausePlayback();
+  const auto previousFrameIdx = currentFrameIdx;
   setCurrentFrame(value);
+  updateFrameAccessPattern(previousFrameIdx);
 }
 
 /** Toggle the repeat mode (loop through the list)
@@ -445,6 +455,8 @@ void PlaybackController::updateFrameRange()
     range =
         indexRange(std::min(range1.first, range2.first), std::max(range1.second, range2.second));
   }
+  const auto rangeChanged =
+      range.first != frameSlider->minimum() || range.second != frameSlider->maximum();
   enableControls(true);
   frameSlider->setEnabled(range != indexRange(-1, -1)); // Disable slider if range == (-1,-1)
   frameSlider->setMaximum(range.second);
@@ -455,6 +467,9 @@ void PlaybackController::updateFrameRange()
   DEBUG_PLAYBACK("PlaybackController::updateFrameRange - new range %d-%d",
                  frameSlider->minimum(),
                  frameSlider->maximum());
+
+  if (rangeChanged)
+    emit signalFrameRangeChanged();
 }
 
 void PlaybackController::enableControls(bool enable)
@@ -492,6 +507,38 @@ int PlaybackController::getNextFrameIndex()
   return currentFrameIdx + 1;
 }
 
+video::FrameAccessPattern PlaybackController::getFrameAccessPattern() const
+{
+  video::FrameAccessPattern pattern;
+  pattern.currentFrame = currentFrameIdx;
+  if (playing())
+  {
+    pattern.step = 1;
+    pattern.loop = (repeatMode == RepeatModeOne);
+  }
+  else
+    pattern.step = frameStep;
+  return pattern;
+}
+
+void PlaybackController::updateFrameAccessPattern(int previousFrame)
+{
+  if (previousFrame == -1 || currentFrameIdx == -1 || previousFrame == currentFrameIdx)
+    return;
+
+  const auto step           = currentFrameIdx - previousFrame;
+  const auto followsPattern = (step == frameStep);
+  if (step == lastFrameStep)
+    frameStep = step;
+  lastFrameStep = step;
+
+  if (!followsPattern)
+  {
+    DEBUG_PLAYBACK("PlaybackController::updateFrameAccessPattern step %d", frameStep);
+    emit(signalFrameAccessPatternChanged());
+  }
+}
+
 void PlaybackController::timerEvent(QTimerEvent *event)
 {
   if (event && event->timerId() != timer.timerId())
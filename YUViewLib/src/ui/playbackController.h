@@ -33,6 +33,7 @@
 #pragma once
 
 #include <common/Typedef.h>
+#include <video/FramePrefetch.h>
 
 #include "views/splitViewWidget.h"
 #include "widgets/PlaylistTreeWidget.h"
@@ -82,6 +83,10 @@ public:
   // -1: The next frame is the first fame of the next item.
   int getNextFrameIndex();
 
+  // How are the frames of the current item requested (direction and step size)? The video cache
+  // uses this to prefetch the frames that will be requested next.
+  video::FrameAccessPattern getFrameAccessPattern() const;
+
 public slots:
   // Slots for the play/stop/toggleRepera buttons (these are automatically connected by the UI file
   // (connectSlotsByName))
@@ -120,6 +125,13 @@ signals:
   // The playback is now going to start
   void signalPlaybackStarting();
 
+  // The user jumped to a frame that does not follow the current access pattern or the pattern
+  // changed (e.g. the user started stepping backwards).
+  void signalFrameAccessPatternChanged();
+
+  // The frame range of the selected item(s) changed (e.g. more frames of a file were parsed)
+  void signalFrameRangeChanged();
+
 public slots:
   // The video cache calls this if caching of the item is finished
   void itemCachingFinished(playlistItem *item);
@@ -142,6 +154,12 @@ private:
   int currentFrameIdx;
   int lastValidFrameIdx;
 
+  // The step between the frames that the user navigated to. A step is only used for prefetching
+  // once it was seen twice in a row, so that a single jump with the slider does not change it.
+  int  frameStep{1};
+  int  lastFrameStep{1};
+  void updateFrameAccessPattern(int previousFrame);
+
   // Start the time if not running or update the timer interval. This is called when we jump to the
   // next item, when the user presses play or when the rate of the current item changes.
   void startOrUpdateTimer();
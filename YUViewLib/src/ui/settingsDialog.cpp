@@ -40,6 +40,7 @@
 #include <decoder/decoderVTM.h>
 #include <decoder/decoderVVDec.h>
 #include <ffmpeg/FFMpegLibrariesHandling.h>
+#include <statistics/StatisticsData.h>
 
 #include <QColorDialog>
 #include <QFileDialog>
@@ -62,6 +63,7 @@ SettingsDialog::SettingsDialog(QWidget *parent) : QDialog(parent)
 
   // "Generals" tab
   ui.checkBoxWatchFiles->setChecked(settings.value("WatchFiles", true).toBool());
+  ui.checkBoxMemoryMapFiles->setChecked(settings.value("MemoryMapFiles", true).toBool());
   ui.checkBoxAskToSave->setChecked(settings.value("AskToSaveOnExit", true).toBool());
   ui.checkBoxContinuePlaybackNewSelection->setChecked(
       settings.value("ContinuePlaybackOnSequenceSelection", false).toBool());
@@ -124,6 +126,14 @@ SettingsDialog::SettingsDialog(QWidget *parent) : QDialog(parent)
   else
     ui.spinBoxNrThreads->setValue(functions::getOptimalThreadCount());
   ui.spinBoxNrThreads->setEnabled(ui.checkBoxNrThreads->isChecked());
+  ui.checkBoxCacheRawData->setChecked(settings.value("CacheRawData", false).toBool());
+  ui.spinBoxCompressedCacheMB->setValue(settings.value("CompressedCacheMB", 0).toInt());
+  const bool diskCache = settings.value("DiskCacheEnabled", false).toBool();
+  ui.checkBoxDiskCache->setChecked(diskCache);
+  ui.spinBoxDiskCacheMB->setValue(settings.value("DiskCacheMB", 10000).toInt());
+  ui.spinBoxDiskCacheMB->setEnabled(diskCache);
+  ui.spinBoxStatisticsCacheMB->setValue(
+      settings.value("StatisticsCacheMB", stats::STATISTICS_CACHE_DEFAULT_SIZE_MB).toInt());
   // Playback
   ui.checkBoxPausPlaybackForCaching->setChecked(
       settings.value("PlaybackPauseCaching", true).toBool());
@@ -160,6 +170,13 @@ SettingsDialog::SettingsDialog(QWidget *parent) : QDialog(parent)
   ui.lineEditAVCodec->setText(settings.value("FFmpeg.avcodec", "").toString());
   ui.lineEditAVUtil->setText(settings.value("FFmpeg.avutil", "").toString());
   ui.lineEditSWResample->setText(settings.value("FFmpeg.swresample", "").toString());
+  // Decoder threads (0 is automatic)
+  ui.spinBoxThreadsLibde265->setValue(settings.value("libde265Threads", 0).toInt());
+  ui.spinBoxThreadsDav1d->setValue(settings.value("dav1dThreads", 0).toInt());
+  ui.spinBoxThreadsDav1dTile->setValue(settings.value("dav1dTileThreads", 0).toInt());
+  ui.spinBoxThreadsVVDec->setValue(settings.value("vvdecThreads", 0).toInt());
+  ui.spinBoxThreadsVVDecParse->setValue(settings.value("vvdecParseThreads", 0).toInt());
+  ui.spinBoxThreadsFFmpeg->setValue(settings.value("FFmpegThreads", 0).toInt());
   settings.endGroup();
 }
 
@@ -196,6 +213,11 @@ void SettingsDialog::on_checkBoxEnablePlaybackCaching_stateChanged(int state)
   ui.spinBoxThreadLimit->setEnabled(state != Qt::Unchecked);
 }
 
+void SettingsDialog::on_checkBoxDiskCache_stateChanged(int state)
+{
+  ui.spinBoxDiskCacheMB->setEnabled(state != Qt::Unchecked);
+}
+
 void SettingsDialog::on_pushButtonEditViewBackgroundColor_clicked()
 {
   QColor currentColor = ui.viewBackgroundColor->getPlainColor();
@@ -426,6 +448,7 @@ void SettingsDialog::on_pushButtonSave_clicked()
 
   // "General" tab
   settings.setValue("WatchFiles", ui.checkBoxWatchFiles->isChecked());
+  settings.setValue("MemoryMapFiles", ui.checkBoxMemoryMapFiles->isChecked());
   settings.setValue("AskToSaveOnExit", ui.checkBoxAskToSave->isChecked());
   settings.setValue("ContinuePlaybackOnSequenceSelection",
                     ui.checkBoxContinuePlaybackNewSelection->isChecked());
@@ -460,6 +483,11 @@ void SettingsDialog::on_pushButtonSave_clicked()
   settings.setValue("ThresholdValueMB", getCacheSizeInMB());
   settings.setValue("SetNrThreads", ui.checkBoxNrThreads->isChecked());
   settings.setValue("NrThreads", ui.spinBoxNrThreads->value());
+  settings.setValue("CacheRawData", ui.checkBoxCacheRawData->isChecked());
+  settings.setValue("CompressedCacheMB", ui.spinBoxCompressedCacheMB->value());
+  settings.setValue("DiskCacheEnabled", ui.checkBoxDiskCache->isChecked());
+  settings.setValue("DiskCacheMB", ui.spinBoxDiskCacheMB->value());
+  settings.setValue("StatisticsCacheMB", ui.spinBoxStatisticsCacheMB->value());
   settings.setValue("PlaybackPauseCaching", ui.checkBoxPausPlaybackForCaching->isChecked());
   settings.setValue("PlaybackCachingEnabled", ui.checkBoxEnablePlaybackCaching->isChecked());
   settings.setValue("PlaybackCachingThreadLimit", ui.spinBoxThreadLimit->value());
@@ -482,6 +510,13 @@ void SettingsDialog::on_pushButtonSave_clicked()
   settings.setValue("FFmpeg.avcodec", ui.lineEditAVCodec->text());
   settings.setValue("FFmpeg.avutil", ui.lineEditAVUtil->text());
   settings.setValue("FFmpeg.swresample", ui.lineEditSWResample->text());
+  // Decoder threads
+  settings.setValue("libde265Threads", ui.spinBoxThreadsLibde265->value());
+  settings.setValue("dav1dThreads", ui.spinBoxThreadsDav1d->value());
+  settings.setValue("dav1dTileThreads", ui.spinBoxThreadsDav1dTile->value());
+  settings.setValue("vvdecThreads", ui.spinBoxThreadsVVDec->value());
+  settings.setValue("vvdecParseThreads", ui.spinBoxThreadsVVDecParse->value());
+  settings.setValue("FFmpegThreads", ui.spinBoxThreadsFFmpeg->value());
   settings.endGroup();
 
   accept();
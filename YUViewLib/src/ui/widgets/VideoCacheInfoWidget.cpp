@@ -112,12 +112,10 @@ void VideoCacheStatusWidget::updateStatus(PlaylistTreeWidget *playlist, unsigned
   {
     playlistItem *item          = allItems.at(i);
     int           nrFrames      = item->getNumberCachedFrames();
-    unsigned int  frameSize     = item->getCachingFrameSize();
-    int64_t       itemCacheSize = nrFrames * frameSize;
-    DEBUG_CACHINGINFO("VideoCacheStatusWidget::updateStatus Item %d frames %d * size %d = %d",
+    int64_t       itemCacheSize = item->getCacheSizeInBytes();
+    DEBUG_CACHINGINFO("VideoCacheStatusWidget::updateStatus Item %d frames %d size %d",
                       i,
                       nrFrames,
-                      frameSize,
                       (int)itemCacheSize);
 
     float endVal = (float)(cacheLevel + itemCacheSize) / cacheLevelMax;
@@ -0,0 +1,230 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "BufferPool.h"
+
+#include <new>
+
+namespace video
+{
+
+namespace
+{
+
+// Every block starts with a header (of Alignment bytes so that the data stays aligned) which holds
+// the size class of the block and the pool that it belongs to.
+struct BlockHeader
+{
+  size_t      sizeClass{};
+  BufferPool *pool{};
+};
+constexpr size_t HeaderSize = BufferPool::Alignment;
+static_assert(sizeof(BlockHeader) <= HeaderSize, "The block header does not fit");
+
+BlockHeader &getHeader(void *data)
+{
+  return *reinterpret_cast<BlockHeader *>(static_cast<unsigned char *>(data) - HeaderSize);
+}
+
+void *newBlock(size_t sizeClass, BufferPool *pool)
+{
+  auto base = static_cast<unsigned char *>(
+      ::operator new(sizeClass + HeaderSize, std::align_val_t(BufferPool::Alignment)));
+  auto data = base + HeaderSize;
+  new (base) BlockHeader({sizeClass, pool});
+  return data;
+}
+
+void deleteBlock(void *data)
+{
+  ::operator delete(static_cast<unsigned char *>(data) - HeaderSize,
+                    std::align_val_t(BufferPool::Alignment));
+}
+
+} // namespace
+
+BufferPool::~BufferPool()
+{
+  this->clear();
+}
+
+std::shared_ptr<unsigned char> BufferPool::allocate(size_t size)
+{
+  auto data = static_cast<unsigned char *>(this->allocateBlock(size));
+  return std::shared_ptr<unsigned char>(data, &BufferPool::releaseBlockOfPool);
+}
+
+QImage BufferPool::allocateImage(const QSize &size, QImage::Format format)
+{
+  if (size.isEmpty())
+    return QImage(size, format);
+
+  // QImage requires every line to start at a 32 bit boundary
+  const auto depth        = QImage::toPixelFormat(format).bitsPerPixel();
+  const auto bytesPerLine = ((size.width() * int(depth) + 31) >> 5) << 2;
+  auto       data         = this->allocateBlock(size_t(bytesPerLine) * size_t(size.height()));
+  return QImage(static_cast<uchar *>(data),
+                size.width(),
+                size.height(),
+                bytesPerLine,
+                format,
+                &BufferPool::releaseBlockOfPool,
+                data);
+}
+
+void BufferPool::setMaxFreeSize(int64_t maxFreeSizeInBytes)
+{
+  QMutexLocker locker(&this->accessMutex);
+  this->maxFreeSize = maxFreeSizeInBytes;
+  this->freeBlocksAboveMaxSize();
+}
+
+void BufferPool::clear()
+{
+  QMutexLocker locker(&this->accessMutex);
+  for (auto &sizeClassBlocks : this->freeBlocks)
+  {
+    for (auto data : sizeClassBlocks.second)
+      deleteBlock(data);
+    this->status.nrFreed += int64_t(sizeClassBlocks.second.size());
+  }
+  this->freeBlocks.clear();
+  this->status.freeSize = 0;
+}
+
+size_t BufferPool::getSizeClass(size_t size)
+{
+  if (size < MinPooledSize)
+    return (size + Alignment - 1) & ~(Alignment - 1);
+
+  auto powerOfTwo = MinPooledSize;
+  while (powerOfTwo <= size / 2)
+    powerOfTwo *= 2;
+  const auto step = powerOfTwo / 4;
+  return (size + step - 1) / step * step;
+}
+
+BufferPool::Status BufferPool::getStatus() const
+{
+  QMutexLocker locker(&this->accessMutex);
+  return this->status;
+}
+
+void *BufferPool::allocateBlock(size_t size)
+{
+  const auto sizeClass = getSizeClass(size);
+  if (sizeClass < MinPooledSize)
+    return newBlock(sizeClass, this);
+
+  {
+    QMutexLocker locker(&this->accessMutex);
+    this->status.nrAllocations++;
+    this->status.usedSize += int64_t(sizeClass);
+
+    auto it = this->freeBlocks.find(sizeClass);
+    if (it != this->freeBlocks.end() && !it->second.empty())
+    {
+      auto data = it->second.back();
+      it->second.pop_back();
+      this->status.nrReused++;
+      this->status.freeSize -= int64_t(sizeClass);
+      return data;
+    }
+
+    const auto totalSize = this->status.usedSize + this->status.freeSize;
+    if (totalSize > this->status.peakSize)
+      this->status.peakSize = totalSize;
+  }
+
+  // Allocate outside of the lock. Other threads can get blocks from the pool in the meantime.
+  return newBlock(sizeClass, this);
+}
+
+void BufferPool::releaseBlock(void *data)
+{
+  if (data == nullptr)
+    return;
+
+  const auto sizeClass = getHeader(data).sizeClass;
+  if (sizeClass < MinPooledSize)
+  {
+    deleteBlock(data);
+    return;
+  }
+
+  {
+    QMutexLocker locker(&this->accessMutex);
+    this->status.usedSize -= int64_t(sizeClass);
+    if (this->status.freeSize + int64_t(sizeClass) <= this->maxFreeSize)
+    {
+      this->freeBlocks[sizeClass].push_back(data);
+      this->status.freeSize += int64_t(sizeClass);
+      return;
+    }
+    this->status.nrFreed++;
+  }
+
+  deleteBlock(data);
+}
+
+void BufferPool::releaseBlockOfPool(void *data)
+{
+  if (data != nullptr)
+    getHeader(data).pool->releaseBlock(data);
+}
+
+void BufferPool::freeBlocksAboveMaxSize()
+{
+  // Free the largest blocks first. They are the most expensive ones to keep around.
+  for (auto it = this->freeBlocks.rbegin();
+       it != this->freeBlocks.rend() && this->status.freeSize > this->maxFreeSize;
+       it++)
+  {
+    auto &blocks = it->second;
+    while (!blocks.empty() && this->status.freeSize > this->maxFreeSize)
+    {
+      deleteBlock(blocks.back());
+      blocks.pop_back();
+      this->status.freeSize -= int64_t(it->first);
+      this->status.nrFreed++;
+    }
+  }
+}
+
+BufferPool &getBufferPool()
+{
+  static auto pool = new BufferPool();
+  return *pool;
+}
+
+} // namespace video
@@ -0,0 +1,109 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QImage>
+#include <QMutex>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace video
+{
+
+/* A pool of large memory blocks for decoded and converted frames. Every decoded frame and every
+ * converted image has the same size as the previous one. Instead of returning the memory to the
+ * system when a frame is released and allocating it again for the next frame, released blocks are
+ * kept in free lists and handed out again. The block sizes are rounded up to size classes (four per
+ * power of two) so that slightly different sizes (e.g. frames of different formats) share blocks.
+ * Small requests are not worth pooling and are allocated directly. All blocks are aligned to
+ * Alignment bytes. All functions are thread safe.
+ */
+class BufferPool
+{
+public:
+  static constexpr size_t Alignment     = 64;
+  static constexpr size_t MinPooledSize = 64 * 1024;
+
+  BufferPool() = default;
+  // All blocks of the pool must have been released before the pool is destroyed
+  ~BufferPool();
+
+  // Get a block of at least the given size. The block goes back to the pool when the last copy of
+  // the pointer is released.
+  std::shared_ptr<unsigned char> allocate(size_t size);
+  // Get an image that uses a block from the pool for its pixels. The block goes back to the pool
+  // when the last (shallow) copy of the image is destroyed.
+  QImage allocateImage(const QSize &size, QImage::Format format);
+
+  // Set the maximum number of bytes in the free lists. Blocks that are released while the free
+  // lists are full are freed. Lowering the size frees blocks right away.
+  void setMaxFreeSize(int64_t maxFreeSizeInBytes);
+  // Free all blocks that are currently not in use
+  void clear();
+
+  // The size of the blocks that are used for the given size
+  static size_t getSizeClass(size_t size);
+
+  struct Status
+  {
+    int64_t nrAllocations{}; //< All requests for pooled blocks
+    int64_t nrReused{};      //< Requests that were served from the free lists
+    int64_t nrFreed{};       //< Released blocks that did not fit into the free lists anymore
+    int64_t usedSize{};      //< Bytes in blocks that are currently in use
+    int64_t freeSize{};      //< Bytes in the free lists
+    int64_t peakSize{};      //< Maximum of used and free bytes so far
+  };
+  Status getStatus() const;
+
+private:
+  void *      allocateBlock(size_t size);
+  void        releaseBlock(void *data);
+  // Give the block back to the pool that it was allocated from
+  static void releaseBlockOfPool(void *data);
+  void        freeBlocksAboveMaxSize();
+
+  mutable QMutex                        accessMutex;
+  std::map<size_t, std::vector<void *>> freeBlocks;
+  int64_t                               maxFreeSize{256 * 1024 * 1024};
+  Status                                status;
+};
+
+// The buffer pool that is used by all decoders and video handlers. The pool is never destroyed so
+// that blocks can be released safely at any time (e.g. by static caches on exit).
+BufferPool &getBufferPool();
+
+} // namespace video
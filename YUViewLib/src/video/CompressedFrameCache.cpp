@@ -0,0 +1,477 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompressedFrameCache.h"
+
+#include <common/Functions.h>
+
+#include <cstring>
+#include <limits>
+#include <QtConcurrent>
+
+namespace video
+{
+
+namespace
+{
+
+// The compressed format is: 1 byte element size, 4 bytes uncompressed size (little endian) and a
+// sequence of LZ4 like blocks. Each block consists of a token (upper 4 bit: number of literals,
+// lower 4 bit: match length - MinMatch), the literals, a 2 byte offset and the match length. The
+// last block only contains literals.
+constexpr size_t   HeaderSize   = 5;
+constexpr size_t   MinMatch     = 4;
+constexpr size_t   LastLiterals = 5;
+constexpr size_t   MaxOffset    = 65535;
+constexpr unsigned HashBits     = 14;
+// If no match is found for a while, the search step is increased (1 + literals >> SkipShift)
+constexpr unsigned SkipShift = 6;
+
+// The maximum size of the uncompressed data that waits for the compression threads. When a lot of
+// frames are evicted from the frame cache at once, they are queued. Only if even more data arrives,
+// frames are dropped.
+constexpr int64_t MaxPendingSize = int64_t(512) * 1024 * 1024;
+
+inline uint32_t read32(const unsigned char *src)
+{
+  uint32_t value;
+  std::memcpy(&value, src, 4);
+  return value;
+}
+
+inline uint64_t read64(const unsigned char *src)
+{
+  uint64_t value;
+  std::memcpy(&value, src, 8);
+  return value;
+}
+
+inline unsigned char *writeLengthExtension(unsigned char *dst, size_t length)
+{
+  while (length >= 255)
+  {
+    *dst++ = 255;
+    length -= 255;
+  }
+  *dst++ = (unsigned char)length;
+  return dst;
+}
+
+inline bool readLengthExtension(const unsigned char *&src, const unsigned char *end, size_t &length)
+{
+  unsigned char value;
+  do
+  {
+    if (src >= end)
+      return false;
+    value = *src++;
+    length += value;
+  } while (value == 255);
+  return true;
+}
+
+// Write one block. If matchLength is 0, this is the last block which only contains literals.
+unsigned char *writeBlock(unsigned char *      dst,
+                          const unsigned char *literals,
+                          const size_t         nrLiterals,
+                          const size_t         offset,
+                          const size_t         matchLength)
+{
+  auto token = dst++;
+  *token     = (unsigned char)(std::min(nrLiterals, size_t(15)) << 4);
+  if (nrLiterals >= 15)
+    dst = writeLengthExtension(dst, nrLiterals - 15);
+  std::memcpy(dst, literals, nrLiterals);
+  dst += nrLiterals;
+
+  if (matchLength == 0)
+    return dst;
+
+  *dst++                 = (unsigned char)(offset & 0xff);
+  *dst++                 = (unsigned char)(offset >> 8);
+  const auto matchCode   = matchLength - MinMatch;
+  *token                |= (unsigned char)std::min(matchCode, size_t(15));
+  if (matchCode >= 15)
+    dst = writeLengthExtension(dst, matchCode - 15);
+  return dst;
+}
+
+size_t compressLZ(const unsigned char *src, const size_t size, unsigned char *dst)
+{
+  const auto dstStart = dst;
+  size_t     anchor   = 0;
+
+  if (size >= MinMatch + LastLiterals)
+  {
+    // Positions are saved + 1 so that 0 marks an empty entry
+    std::vector<uint32_t> hashTable(size_t(1) << HashBits, 0);
+    const auto            matchLimit = size - LastLiterals;
+
+    size_t pos = 0;
+    while (pos + MinMatch <= matchLimit)
+    {
+      const auto sequence  = read32(src + pos);
+      const auto hash      = (sequence * 2654435761u) >> (32 - HashBits);
+      const auto candidate = size_t(hashTable[hash]);
+      hashTable[hash]      = uint32_t(pos + 1);
+
+      if (candidate == 0 || pos - (candidate - 1) > MaxOffset ||
+          read32(src + candidate - 1) != sequence)
+      {
+        pos += 1 + ((pos - anchor) >> SkipShift);
+        continue;
+      }
+
+      const auto matchPos = candidate - 1;
+      auto       length   = MinMatch;
+      while (pos + length + 8 <= matchLimit &&
+             read64(src + matchPos + length) == read64(src + pos + length))
+        length += 8;
+      while (pos + length < matchLimit && src[matchPos + length] == src[pos + length])
+        length++;
+
+      dst    = writeBlock(dst, src + anchor, pos - anchor, pos - matchPos, length);
+      pos    = pos + length;
+      anchor = pos;
+    }
+  }
+
+  dst = writeBlock(dst, src + anchor, size - anchor, 0, 0);
+  return size_t(dst - dstStart);
+}
+
+bool decompressLZ(const unsigned char *src,
+                  const size_t         srcSize,
+                  unsigned char *      dst,
+                  const size_t         dstSize)
+{
+  const auto srcEnd   = src + srcSize;
+  const auto dstStart = dst;
+  const auto dstEnd   = dst + dstSize;
+
+  while (true)
+  {
+    if (src >= srcEnd)
+      return false;
+    const auto token = *src++;
+
+    size_t nrLiterals = token >> 4;
+    if (nrLiterals == 15 && !readLengthExtension(src, srcEnd, nrLiterals))
+      return false;
+    if (nrLiterals > size_t(srcEnd - src) || nrLiterals > size_t(dstEnd - dst))
+      return false;
+    std::memcpy(dst, src, nrLiterals);
+    src += nrLiterals;
+    dst += nrLiterals;
+
+    if (src == srcEnd)
+      // This was the last block
+      break;
+
+    if (srcEnd - src < 2)
+      return false;
+    const auto offset = size_t(src[0]) | (size_t(src[1]) << 8);
+    src += 2;
+    if (offset == 0 || offset > size_t(dst - dstStart))
+      return false;
+
+    size_t matchLength = token & 15;
+    if (matchLength == 15 && !readLengthExtension(src, srcEnd, matchLength))
+      return false;
+    matchLength += MinMatch;
+    if (matchLength > size_t(dstEnd - dst))
+      return false;
+
+    // The match may overlap with the output that is written
+    const auto match = dst - offset;
+    if (offset == 1)
+      std::memset(dst, *match, matchLength);
+    else if (offset >= 8)
+    {
+      size_t i = 0;
+      for (; i + 8 <= matchLength; i += 8)
+        std::memcpy(dst + i, match + i, 8);
+      for (; i < matchLength; i++)
+        dst[i] = match[i];
+    }
+    else
+    {
+      for (size_t i = 0; i < matchLength; i++)
+        dst[i] = match[i];
+    }
+    dst += matchLength;
+  }
+
+  return dst == dstEnd;
+}
+
+} // namespace
+
+QByteArray compressFrameData(const QByteArray &data, unsigned elementSize)
+{
+  const auto size = size_t(data.size());
+  if (size > std::numeric_limits<uint32_t>::max())
+    return {};
+  if (elementSize != 2)
+    elementSize = 1;
+
+  auto src = (const unsigned char *)data.constData();
+
+  // Separate the low and high bytes of the samples
+  QByteArray shuffled;
+  if (elementSize == 2)
+  {
+    shuffled.resize(data.size());
+    auto       dst        = (unsigned char *)shuffled.data();
+    const auto nrElements = size / 2;
+    for (size_t i = 0; i < nrElements; i++)
+    {
+      dst[i]              = src[i * 2];
+      dst[nrElements + i] = src[i * 2 + 1];
+    }
+    if (size % 2 == 1)
+      dst[size - 1] = src[size - 1];
+    src = (const unsigned char *)shuffled.constData();
+  }
+
+  // The worst case is that all data is written as literals
+  QByteArray compressed;
+  compressed.resize(int(HeaderSize + size + size / 255 + 16));
+  auto dst = (unsigned char *)compressed.data();
+  dst[0]   = (unsigned char)elementSize;
+  for (unsigned i = 0; i < 4; i++)
+    dst[1 + i] = (unsigned char)(size >> (i * 8));
+
+  const auto compressedSize = compressLZ(src, size, dst + HeaderSize);
+  compressed.resize(int(HeaderSize + compressedSize));
+  return compressed;
+}
+
+bool decompressFrameData(const QByteArray &compressedData, QByteArray &data)
+{
+  if (size_t(compressedData.size()) < HeaderSize)
+    return false;
+
+  auto       src         = (const unsigned char *)compressedData.constData();
+  const auto elementSize = src[0];
+  size_t     size        = 0;
+  for (unsigned i = 0; i < 4; i++)
+    size |= size_t(src[1 + i]) << (i * 8);
+  if ((elementSize != 1 && elementSize != 2) || size > size_t(std::numeric_limits<int>::max()))
+    return false;
+  // Each byte of the compressed data can expand to at most 255 bytes. Check this before allocating
+  // the output so that a corrupt header can not trigger a huge allocation.
+  const auto dataSize = size_t(compressedData.size()) - HeaderSize;
+  if (size > dataSize * 255 + MinMatch)
+    return false;
+
+  QByteArray decompressed;
+  decompressed.resize(int(size));
+  if (!decompressLZ(src + HeaderSize, dataSize, (unsigned char *)decompressed.data(), size))
+    return false;
+
+  if (elementSize == 1)
+  {
+    data = decompressed;
+    return true;
+  }
+
+  data.resize(int(size));
+  auto       shuffled   = (const unsigned char *)decompressed.constData();
+  auto       dst        = (unsigned char *)data.data();
+  const auto nrElements = size / 2;
+  for (size_t i = 0; i < nrElements; i++)
+  {
+    dst[i * 2]     = shuffled[i];
+    dst[i * 2 + 1] = shuffled[nrElements + i];
+  }
+  if (size % 2 == 1)
+    dst[size - 1] = shuffled[size - 1];
+  return true;
+}
+
+CompressedFrameCache::CompressedFrameCache()
+{
+  // The compression runs in the background. Two threads are enough to keep up with the decoders.
+  this->compressionPool.setMaxThreadCount(2);
+}
+
+void CompressedFrameCache::setMaxSize(int64_t maxSizeInBytes)
+{
+  QMutexLocker lock(&this->accessMutex);
+  this->maxSize = std::max(maxSizeInBytes, int64_t(0));
+  while (this->status.compressedSize > this->maxSize && !this->lruList.empty())
+    this->removeLeastRecentlyUsed();
+}
+
+bool CompressedFrameCache::isEnabled() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->maxSize > 0;
+}
+
+void CompressedFrameCache::insert(const void *      owner,
+                                  int               frameIndex,
+                                  const QByteArray &data,
+                                  unsigned          elementSize)
+{
+  QMutexLocker lock(&this->accessMutex);
+
+  const Key key(std::uintptr_t(owner), frameIndex);
+  if (this->maxSize <= 0 || data.isEmpty() || this->entries.count(key) > 0 ||
+      this->pendingFrames.count(key) > 0)
+    return;
+  if (this->pendingSize + data.size() > MaxPendingSize)
+  {
+    this->status.nrDroppedFrames++;
+    return;
+  }
+
+  this->pendingFrames.insert(key);
+  this->pendingSize += data.size();
+  const auto generation = this->getGeneration(key.first);
+  lock.unlock();
+
+  // The data may reference a memory mapped file which is unmapped when the owner is destroyed.
+  // The owner does not wait for the compression so the job needs its own copy.
+  auto compress = [this, key, data = functions::toOwnedByteArray(data), elementSize, generation]() {
+    const auto compressedData = compressFrameData(data, elementSize);
+
+    QMutexLocker lock(&this->accessMutex);
+    this->pendingFrames.erase(key);
+    this->pendingSize -= data.size();
+    if (this->getGeneration(key.first) == generation && !compressedData.isEmpty())
+      this->addCompressedFrame(key, compressedData, data.size());
+    if (!this->hasPendingFrames(key.first))
+      this->ownerGeneration.erase(key.first);
+  };
+  QtConcurrent::run(&this->compressionPool, compress);
+}
+
+bool CompressedFrameCache::get(const void *owner, int frameIndex, QByteArray &data)
+{
+  QMutexLocker lock(&this->accessMutex);
+
+  auto entry = this->entries.find(Key(std::uintptr_t(owner), frameIndex));
+  if (entry == this->entries.end())
+    return false;
+
+  // Mark as most recently used
+  this->lruList.splice(this->lruList.end(), this->lruList, entry->second.lruPosition);
+  const auto compressedData = entry->second.compressedData;
+  lock.unlock();
+
+  return decompressFrameData(compressedData, data);
+}
+
+void CompressedFrameCache::remove(const void *owner)
+{
+  QMutexLocker lock(&this->accessMutex);
+
+  const auto ownerKey = std::uintptr_t(owner);
+  if (this->hasPendingFrames(ownerKey))
+    this->ownerGeneration[ownerKey]++;
+  else
+    this->ownerGeneration.erase(ownerKey);
+
+  auto it = this->entries.lower_bound(Key(ownerKey, std::numeric_limits<int>::min()));
+  while (it != this->entries.end() && it->first.first == ownerKey)
+  {
+    this->status.nrFrames--;
+    this->status.compressedSize -= it->second.compressedData.size();
+    this->status.uncompressedSize -= it->second.uncompressedSize;
+    this->lruList.erase(it->second.lruPosition);
+    it = this->entries.erase(it);
+  }
+}
+
+unsigned CompressedFrameCache::getGeneration(std::uintptr_t owner) const
+{
+  auto it = this->ownerGeneration.find(owner);
+  return it == this->ownerGeneration.end() ? 0 : it->second;
+}
+
+bool CompressedFrameCache::hasPendingFrames(std::uintptr_t owner) const
+{
+  auto it = this->pendingFrames.lower_bound(Key(owner, std::numeric_limits<int>::min()));
+  return it != this->pendingFrames.end() && it->first == owner;
+}
+
+void CompressedFrameCache::waitForPendingFrames()
+{
+  this->compressionPool.waitForDone();
+}
+
+CompressedFrameCache::Status CompressedFrameCache::getStatus() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->status;
+}
+
+void CompressedFrameCache::addCompressedFrame(const Key &       key,
+                                              const QByteArray &compressedData,
+                                              int               uncompressedSize)
+{
+  if (compressedData.size() > this->maxSize || this->entries.count(key) > 0)
+    return;
+
+  this->lruList.push_back(key);
+  auto &entry            = this->entries[key];
+  entry.compressedData   = compressedData;
+  entry.uncompressedSize = uncompressedSize;
+  entry.lruPosition      = std::prev(this->lruList.end());
+
+  this->status.nrFrames++;
+  this->status.compressedSize += compressedData.size();
+  this->status.uncompressedSize += uncompressedSize;
+
+  while (this->status.compressedSize > this->maxSize && !this->lruList.empty())
+    this->removeLeastRecentlyUsed();
+}
+
+void CompressedFrameCache::removeLeastRecentlyUsed()
+{
+  auto entry = this->entries.find(this->lruList.front());
+  this->status.nrFrames--;
+  this->status.compressedSize -= entry->second.compressedData.size();
+  this->status.uncompressedSize -= entry->second.uncompressedSize;
+  this->entries.erase(entry);
+  this->lruList.pop_front();
+}
+
+CompressedFrameCache &getCompressedFrameCache()
+{
+  static CompressedFrameCache compressedFrameCache;
+  return compressedFrameCache;
+}
+
+} // namespace video
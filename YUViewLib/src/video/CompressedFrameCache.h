@@ -0,0 +1,126 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QThreadPool>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <set>
+
+namespace video
+{
+
+// Lossless compression of raw frame data with a fast LZ77 codec (similar to the LZ4 block format).
+// If elementSize is 2, the low and high bytes of the (16 bit) samples are separated before
+// compression. For bit depths up to 10 bit, the high bytes then compress very well.
+QByteArray compressFrameData(const QByteArray &data, unsigned elementSize);
+// Decompress the data. Returns false if the data is corrupt.
+bool decompressFrameData(const QByteArray &compressedData, QByteArray &data);
+
+/* A second cache tier which holds raw frame data losslessly compressed in memory. The tier is
+ * shared by all video handlers. Each handler uses its own pointer as the owner of the entries.
+ * Frames are compressed asynchronously in a low priority thread pool and the least recently used
+ * frames are dropped if the compressed data exceeds the maximum size. All functions are thread
+ * safe.
+ */
+class CompressedFrameCache
+{
+public:
+  CompressedFrameCache();
+
+  // Set the maximum size of the compressed data in bytes. 0 disables the cache.
+  void setMaxSize(int64_t maxSizeInBytes);
+  bool isEnabled() const;
+
+  // Compress the given data in the background and add it to the cache (if not already in there).
+  // The frame is dropped if too much data is already waiting for the compression.
+  void insert(const void *owner, int frameIndex, const QByteArray &data, unsigned elementSize);
+  // Decompress the frame from the cache into data. Returns false if the frame is not cached.
+  bool get(const void *owner, int frameIndex, QByteArray &data);
+  // Remove all frames of the owner. Frames of the owner that are currently being compressed will
+  // not be added anymore.
+  void remove(const void *owner);
+  // Block until all frames that are currently being compressed were added to the cache
+  void waitForPendingFrames();
+
+  struct Status
+  {
+    int     nrFrames{};
+    int64_t compressedSize{};
+    int64_t uncompressedSize{};
+    // The number of inserted frames that were dropped because too much data was pending
+    int nrDroppedFrames{};
+  };
+  Status getStatus() const;
+
+private:
+  using Key = std::pair<std::uintptr_t, int>;
+  struct Entry
+  {
+    QByteArray               compressedData;
+    int                      uncompressedSize{};
+    std::list<Key>::iterator lruPosition;
+  };
+
+  void     addCompressedFrame(const Key &       key,
+                              const QByteArray &compressedData,
+                              int               uncompressedSize);
+  void     removeLeastRecentlyUsed();
+  unsigned getGeneration(std::uintptr_t owner) const;
+  bool     hasPendingFrames(std::uintptr_t owner) const;
+
+  mutable QMutex       accessMutex;
+  std::map<Key, Entry> entries;
+  // The front is the least recently used frame
+  std::list<Key> lruList;
+  std::set<Key>  pendingFrames;
+  int64_t        pendingSize{};
+  // Incremented in remove(owner). Frames that were compressed for an older generation are dropped.
+  // Only owners that were removed while frames were pending are in here (a missing owner is
+  // generation 0). The entry is erased when the last pending frame of the owner is done.
+  std::map<std::uintptr_t, unsigned> ownerGeneration;
+  int64_t                            maxSize{};
+  Status                             status;
+
+  // Declared last so that it is destroyed first. This waits for all running compression jobs.
+  QThreadPool compressionPool;
+};
+
+// The compressed frame cache that is used by all video handlers
+CompressedFrameCache &getCompressedFrameCache();
+
+} // namespace video
@@ -0,0 +1,821 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ConversionYUV.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#if YUVIEW_ARCH_X86
+#include <immintrin.h>
+#endif
+#if YUVIEW_ARCH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace video::yuv
+{
+
+using functions::SIMDInstructionSet;
+
+namespace
+{
+
+inline int clipTo8Bit(int val)
+{
+  return (val < 0) ? 0 : (val > 255) ? 255 : val;
+}
+
+/* Apply the given transformation to the YUV sample. If invert is true, the sample is inverted at
+ * the value defined by offset. If the scale is greater one, the values will be amplified relative
+ * to the offset value. The output is clamped to (0...clipMax).
+ */
+inline int transformYUV(const MathParameters &math, const int value, const int clipMax)
+{
+  int newValue = value;
+  if (math.invert)
+    newValue = -(newValue - math.offset) * math.scale + math.offset;
+  else
+    newValue = (newValue - math.offset) * math.scale + math.offset;
+  return (newValue < 0) ? 0 : (newValue > clipMax) ? clipMax : newValue;
+}
+
+inline bool isHostLittleEndian()
+{
+  const uint16_t value = 1;
+  unsigned char  firstByte;
+  std::memcpy(&firstByte, &value, 1);
+  return firstByte == 1;
+}
+
+// Read n values from src (skipping valueSkip - 1 values after each value) and apply the YUV math.
+void readLine(const unsigned char * src,
+              const unsigned        n,
+              const int             valueSkip,
+              const unsigned        bitsPerSample,
+              const bool            bigEndian,
+              const MathParameters &math,
+              uint16_t *            dst)
+{
+  // The loops for valueSkip 1 are kept separate so that the compiler can vectorize them
+  if (bitsPerSample > 8 && valueSkip == 1)
+  {
+    if (bigEndian == !isHostLittleEndian())
+      std::memcpy(dst, src, n * 2);
+    else if (bigEndian)
+      for (unsigned i = 0; i < n; i++)
+        dst[i] = uint16_t(src[i * 2] << 8 | src[i * 2 + 1]);
+    else
+      for (unsigned i = 0; i < n; i++)
+        dst[i] = uint16_t(src[i * 2] | src[i * 2 + 1] << 8);
+  }
+  else if (bitsPerSample > 8)
+  {
+    const auto step = 2 * valueSkip;
+    if (bigEndian)
+      for (unsigned i = 0; i < n; i++)
+        dst[i] = uint16_t(src[i * step] << 8 | src[i * step + 1]);
+    else
+      for (unsigned i = 0; i < n; i++)
+        dst[i] = uint16_t(src[i * step] | src[i * step + 1] << 8);
+  }
+  else if (valueSkip == 1)
+  {
+    for (unsigned i = 0; i < n; i++)
+      dst[i] = src[i];
+  }
+  else
+  {
+    for (unsigned i = 0; i < n; i++)
+      dst[i] = src[i * valueSkip];
+  }
+
+  if (math.mathRequired())
+  {
+    const auto inMax = (1 << bitsPerSample) - 1;
+    for (unsigned i = 0; i < n; i++)
+      dst[i] = uint16_t(transformYUV(math, dst[i], inMax));
+  }
+}
+
+inline int interpolateUVSample(const ChromaInterpolation mode, const int sample1, const int sample2)
+{
+  if (mode == ChromaInterpolation::Bilinear)
+    // Interpolate linearly between sample1 and sample2
+    return ((sample1 + sample2) + 1) >> 1;
+  return sample1; // Sample and hold
+}
+
+inline int interpolateUVSampleQ(const ChromaInterpolation mode,
+                                const int                 sample1,
+                                const int                 sample2,
+                                const int                 quarterPos)
+{
+  if (mode == ChromaInterpolation::Bilinear)
+  {
+    // Interpolate linearly between sample1 and sample2
+    if (quarterPos == 1)
+      return ((sample1 * 3 + sample2) + 1) >> 2;
+    if (quarterPos == 2)
+      return ((sample1 + sample2) + 1) >> 1;
+    if (quarterPos == 3)
+      return ((sample1 + sample2 * 3) + 1) >> 2;
+  }
+  return sample1; // Sample and hold
+}
+
+inline int interpolateUVSample2D(const ChromaInterpolation mode,
+                                 const int                 sample1,
+                                 const int                 sample2,
+                                 const int                 sample3,
+                                 const int                 sample4)
+{
+  if (mode == ChromaInterpolation::Bilinear)
+    // Interpolate linearly between sample1 - sample 4
+    return ((sample1 + sample2 + sample3 + sample4) + 2) >> 2;
+  return sample1; // Sample and hold
+}
+
+// Up-sample one line of nc chroma values horizontally by the given factor (1, 2 or 4). At the
+// right border, there is no next value so the last value is repeated.
+void upsampleLineHorizontal(const uint16_t *          src,
+                            const unsigned            nc,
+                            const int                 factor,
+                            const ChromaInterpolation mode,
+                            uint16_t *                dst)
+{
+  if (factor == 1 || nc == 0)
+  {
+    std::copy(src, src + nc, dst);
+    return;
+  }
+
+  if (mode != ChromaInterpolation::Bilinear)
+  {
+    // Sample and hold
+    if (factor == 2)
+      for (unsigned i = 0; i < nc; i++)
+        dst[i * 2] = dst[i * 2 + 1] = src[i];
+    else
+      for (unsigned i = 0; i < nc; i++)
+        dst[i * 4] = dst[i * 4 + 1] = dst[i * 4 + 2] = dst[i * 4 + 3] = src[i];
+    return;
+  }
+
+  for (unsigned i = 0; i + 1 < nc; i++)
+  {
+    const auto cur  = src[i];
+    const auto next = src[i + 1];
+    if (factor == 2)
+    {
+      dst[i * 2]     = cur;
+      dst[i * 2 + 1] = uint16_t((cur + next + 1) >> 1);
+    }
+    else
+    {
+      dst[i * 4]     = cur;
+      dst[i * 4 + 1] = uint16_t((cur * 3 + next + 1) >> 2);
+      dst[i * 4 + 2] = uint16_t((cur + next + 1) >> 1);
+      dst[i * 4 + 3] = uint16_t((cur + next * 3 + 1) >> 2);
+    }
+  }
+  for (int q = 0; q < factor; q++)
+    dst[(nc - 1) * factor + q] = src[nc - 1];
+}
+
+// The odd luma lines of 4:2:0 lie between two chroma lines. The even positions are interpolated
+// vertically, the odd positions from the 4 surrounding chroma values.
+void upsampleLine420Between(const uint16_t *          src,
+                            const uint16_t *          srcNextLine,
+                            const unsigned            nc,
+                            const ChromaInterpolation mode,
+                            uint16_t *                dst)
+{
+  for (unsigned i = 0; i < nc; i++)
+  {
+    const auto vertical = interpolateUVSample(mode, src[i], srcNextLine[i]);
+    dst[i * 2]          = vertical;
+    dst[i * 2 + 1] =
+        (i + 1 < nc)
+            ? interpolateUVSample2D(mode, src[i], src[i + 1], srcNextLine[i], srcNextLine[i + 1])
+            : vertical;
+  }
+}
+
+// Interpolate between the previous and the current chroma sample at the position that is offset8
+// eighths of a sample before the current sample.
+inline int interpolateUV8Pos(const int prev, const int cur, const int offset8)
+{
+  return (prev * offset8 + cur * (8 - offset8) + 4) >> 3;
+}
+
+// The chroma offset of the format in eighths of a chroma sample
+Offset getChromaOffset8(const PixelFormatYUV &format)
+{
+  const auto subsampling = format.getSubsampling();
+  const auto toEighths   = [subsampling](const bool horizontal, const int offset) {
+    const auto possibleValues = getMaxPossibleChromaOffsetValues(horizontal, subsampling);
+    const auto offset8        = (possibleValues == 1)   ? offset * 4
+                                : (possibleValues == 3) ? offset * 2
+                                                        : offset;
+    return std::clamp(offset8, 0, 8);
+  };
+  return Offset(toEighths(true, format.getChromaOffset().x),
+                toEighths(false, format.getChromaOffset().y));
+}
+
+// The chroma values of one chroma line (after YUV math). To avoid reading the same chroma line for
+// multiple luma lines, the last two read lines are kept.
+// If there is a chroma offset, the chroma values are re-sampled (before the YUV math) so that
+// they are aligned with the luma samples. The first chroma value of each line and the first
+// chroma line have no previous value and are not changed.
+class ChromaLineCache
+{
+public:
+  struct Line
+  {
+    int                   index{-1};
+    std::vector<uint16_t> u;
+    std::vector<uint16_t> v;
+  };
+
+  ChromaLineCache(const PlanarYUVSource &source,
+                  const unsigned         width,
+                  const unsigned         bitsPerSample,
+                  const bool             bigEndian,
+                  const MathParameters & math,
+                  const Offset           chromaOffset8)
+      : source(source), width(width), bitsPerSample(bitsPerSample), bigEndian(bigEndian),
+        math(math), chromaOffset8(chromaOffset8)
+  {
+    for (auto &line : this->lines)
+    {
+      line.u.resize(width);
+      line.v.resize(width);
+    }
+    if (chromaOffset8.y != 0)
+    {
+      this->previousLine.u.resize(width);
+      this->previousLine.v.resize(width);
+    }
+  }
+
+  // Get the given chroma line. The line keepIndex is not replaced if the line has to be read.
+  const Line &get(const int index, const int keepIndex = -1)
+  {
+    for (auto &line : this->lines)
+      if (line.index == index)
+        return line;
+
+    auto &line = (this->lines[0].index == keepIndex) ? this->lines[1] : this->lines[0];
+    this->readRawLine(index, line);
+
+    if (this->chromaOffset8.y != 0 && index > 0)
+    {
+      this->readRawLine(index - 1, this->previousLine);
+      for (unsigned x = 0; x < this->width; x++)
+      {
+        line.u[x] = uint16_t(
+            interpolateUV8Pos(this->previousLine.u[x], line.u[x], this->chromaOffset8.y));
+        line.v[x] = uint16_t(
+            interpolateUV8Pos(this->previousLine.v[x], line.v[x], this->chromaOffset8.y));
+      }
+    }
+
+    if (this->math.mathRequired())
+    {
+      const auto inMax = (1 << this->bitsPerSample) - 1;
+      for (unsigned x = 0; x < this->width; x++)
+      {
+        line.u[x] = uint16_t(transformYUV(this->math, line.u[x], inMax));
+        line.v[x] = uint16_t(transformYUV(this->math, line.v[x], inMax));
+      }
+    }
+
+    line.index = index;
+    return line;
+  }
+
+private:
+  // Read the line without YUV math and apply the horizontal chroma offset re-sampling
+  void readRawLine(const int index, Line &line) const
+  {
+    const auto bytesPerValue = (this->bitsPerSample > 8) ? 2 : 1;
+    const auto stride = (this->source.strideC > 0)
+                            ? this->source.strideC
+                            : size_t(this->width) * this->source.chromaValueSkip * bytesPerValue;
+    const auto offset = size_t(index) * stride;
+    readLine(this->source.u + offset,
+             this->width,
+             this->source.chromaValueSkip,
+             this->bitsPerSample,
+             this->bigEndian,
+             {},
+             line.u.data());
+    readLine(this->source.v + offset,
+             this->width,
+             this->source.chromaValueSkip,
+             this->bitsPerSample,
+             this->bigEndian,
+             {},
+             line.v.data());
+
+    if (this->chromaOffset8.x != 0 && this->width > 0)
+    {
+      // Go backwards so that the previous value is still the original one
+      for (unsigned x = this->width - 1; x > 0; x--)
+      {
+        line.u[x] = uint16_t(interpolateUV8Pos(line.u[x - 1], line.u[x], this->chromaOffset8.x));
+        line.v[x] = uint16_t(interpolateUV8Pos(line.v[x - 1], line.v[x], this->chromaOffset8.x));
+      }
+    }
+  }
+
+  const PlanarYUVSource source;
+  const unsigned        width;
+  const unsigned        bitsPerSample;
+  const bool            bigEndian;
+  const MathParameters  math;
+  const Offset          chromaOffset8;
+  Line                  lines[2];
+  Line                  previousLine;
+};
+
+void convertRowScalar(const uint16_t *               y,
+                      const uint16_t *               u,
+                      const uint16_t *               v,
+                      unsigned char *                dst,
+                      const unsigned                 n,
+                      const RowConversionParameters &p)
+{
+  // Local copies. Otherwise, the compiler must assume that writing to dst changes p.
+  const int c0 = p.RGBConv[0], c1 = p.RGBConv[1], c2 = p.RGBConv[2], c3 = p.RGBConv[3],
+            c4 = p.RGBConv[4];
+  const int preShift = p.preShift, yOffset = p.yOffset, cZero = p.cZero, shift = p.shift;
+
+  for (unsigned i = 0; i < n; i++)
+  {
+    const int Y_tmp = ((int(y[i]) >> preShift) - yOffset) * c0;
+    const int U_tmp = (int(u[i]) >> preShift) - cZero;
+    const int V_tmp = (int(v[i]) >> preShift) - cZero;
+
+    const int R_tmp = (Y_tmp + V_tmp * c1) >> shift;
+    const int G_tmp = (Y_tmp + U_tmp * c2 + V_tmp * c3) >> shift;
+    const int B_tmp = (Y_tmp + U_tmp * c4) >> shift;
+
+    dst[i * 4]     = (unsigned char)clipTo8Bit(B_tmp);
+    dst[i * 4 + 1] = (unsigned char)clipTo8Bit(G_tmp);
+    dst[i * 4 + 2] = (unsigned char)clipTo8Bit(R_tmp);
+    dst[i * 4 + 3] = 255;
+  }
+}
+
+#if YUVIEW_ARCH_X86
+
+// The SIMD kernels perform exactly the same 32 bit integer operations as the scalar kernel. The
+// clipping to 8 bit is done by the saturating packs (32 -> 16 -> 8 bit).
+
+// Load 4 values, apply the pre shift and subtract the offset
+YUVIEW_TARGET_SSE4_1 inline __m128i
+loadValuesSSE4_1(const uint16_t *src, const __m128i preShift, const __m128i offset)
+{
+  const auto values = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)src));
+  return _mm_sub_epi32(_mm_sra_epi32(values, preShift), offset);
+}
+
+YUVIEW_TARGET_SSE4_1 void convertRowSSE4_1(const uint16_t *               y,
+                                           const uint16_t *               u,
+                                           const uint16_t *               v,
+                                           unsigned char *                dst,
+                                           const unsigned                 n,
+                                           const RowConversionParameters &p)
+{
+  const auto c0       = _mm_set1_epi32(p.RGBConv[0]);
+  const auto c1       = _mm_set1_epi32(p.RGBConv[1]);
+  const auto c2       = _mm_set1_epi32(p.RGBConv[2]);
+  const auto c3       = _mm_set1_epi32(p.RGBConv[3]);
+  const auto c4       = _mm_set1_epi32(p.RGBConv[4]);
+  const auto yOffset  = _mm_set1_epi32(p.yOffset);
+  const auto cZero    = _mm_set1_epi32(p.cZero);
+  const auto preShift = _mm_cvtsi32_si128(p.preShift);
+  const auto shift    = _mm_cvtsi32_si128(p.shift);
+  const auto alpha    = _mm_set1_epi16(255);
+
+  unsigned i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m128i r[2], g[2], b[2];
+    for (unsigned k = 0; k < 2; k++)
+    {
+      const auto offset = i + k * 4;
+      const auto Y      = loadValuesSSE4_1(y + offset, preShift, yOffset);
+      const auto U      = loadValuesSSE4_1(u + offset, preShift, cZero);
+      const auto V      = loadValuesSSE4_1(v + offset, preShift, cZero);
+
+      const auto Y_tmp = _mm_mullo_epi32(Y, c0);
+      r[k] = _mm_sra_epi32(_mm_add_epi32(Y_tmp, _mm_mullo_epi32(V, c1)), shift);
+      g[k] = _mm_sra_epi32(
+          _mm_add_epi32(_mm_add_epi32(Y_tmp, _mm_mullo_epi32(U, c2)), _mm_mullo_epi32(V, c3)),
+          shift);
+      b[k] = _mm_sra_epi32(_mm_add_epi32(Y_tmp, _mm_mullo_epi32(U, c4)), shift);
+    }
+
+    // [B0..B7 R0..R7] and [G0..G7 A0..A7] -> interleave to BGRA
+    const auto BR = _mm_packus_epi16(_mm_packs_epi32(b[0], b[1]), _mm_packs_epi32(r[0], r[1]));
+    const auto GA = _mm_packus_epi16(_mm_packs_epi32(g[0], g[1]), alpha);
+    const auto BG = _mm_unpacklo_epi8(BR, GA);
+    const auto RA = _mm_unpackhi_epi8(BR, GA);
+    _mm_storeu_si128((__m128i *)(dst + i * 4), _mm_unpacklo_epi16(BG, RA));
+    _mm_storeu_si128((__m128i *)(dst + i * 4 + 16), _mm_unpackhi_epi16(BG, RA));
+  }
+
+  convertRowScalar(y + i, u + i, v + i, dst + i * 4, n - i, p);
+}
+
+// Load 8 values, apply the pre shift and subtract the offset
+YUVIEW_TARGET_AVX2 inline __m256i
+loadValuesAVX2(const uint16_t *src, const __m128i preShift, const __m256i offset)
+{
+  const auto values = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)src));
+  return _mm256_sub_epi32(_mm256_sra_epi32(values, preShift), offset);
+}
+
+// The 256 bit packs work per 128 bit lane. This restores the order after packing 32 -> 16 bit.
+YUVIEW_TARGET_AVX2 inline __m256i packInOrder(const __m256i a, const __m256i b)
+{
+  return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+}
+
+YUVIEW_TARGET_AVX2 void convertRowAVX2(const uint16_t *               y,
+                                       const uint16_t *               u,
+                                       const uint16_t *               v,
+                                       unsigned char *                dst,
+                                       const unsigned                 n,
+                                       const RowConversionParameters &p)
+{
+  const auto c0       = _mm256_set1_epi32(p.RGBConv[0]);
+  const auto c1       = _mm256_set1_epi32(p.RGBConv[1]);
+  const auto c2       = _mm256_set1_epi32(p.RGBConv[2]);
+  const auto c3       = _mm256_set1_epi32(p.RGBConv[3]);
+  const auto c4       = _mm256_set1_epi32(p.RGBConv[4]);
+  const auto yOffset  = _mm256_set1_epi32(p.yOffset);
+  const auto cZero    = _mm256_set1_epi32(p.cZero);
+  const auto preShift = _mm_cvtsi32_si128(p.preShift);
+  const auto shift    = _mm_cvtsi32_si128(p.shift);
+  const auto alpha    = _mm256_set1_epi16(255);
+
+  unsigned i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    __m256i r[2], g[2], b[2];
+    for (unsigned k = 0; k < 2; k++)
+    {
+      const auto offset = i + k * 8;
+      const auto Y      = loadValuesAVX2(y + offset, preShift, yOffset);
+      const auto U      = loadValuesAVX2(u + offset, preShift, cZero);
+      const auto V      = loadValuesAVX2(v + offset, preShift, cZero);
+
+      const auto Y_tmp = _mm256_mullo_epi32(Y, c0);
+      r[k] = _mm256_sra_epi32(_mm256_add_epi32(Y_tmp, _mm256_mullo_epi32(V, c1)), shift);
+      g[k] = _mm256_sra_epi32(_mm256_add_epi32(_mm256_add_epi32(Y_tmp, _mm256_mullo_epi32(U, c2)),
+                                               _mm256_mullo_epi32(V, c3)),
+                              shift);
+      b[k] = _mm256_sra_epi32(_mm256_add_epi32(Y_tmp, _mm256_mullo_epi32(U, c4)), shift);
+    }
+
+    // Per lane: [B0..B7 R0..R7 | B8..B15 R8..R15] and [G0..G7 A0..A7 | G8..G15 A8..A15]
+    const auto BR = _mm256_packus_epi16(packInOrder(b[0], b[1]), packInOrder(r[0], r[1]));
+    const auto GA = _mm256_packus_epi16(packInOrder(g[0], g[1]), alpha);
+    const auto BG = _mm256_unpacklo_epi8(BR, GA);
+    const auto RA = _mm256_unpackhi_epi8(BR, GA);
+    // Pixels [0..3 | 8..11] and [4..7 | 12..15]
+    const auto lo = _mm256_unpacklo_epi16(BG, RA);
+    const auto hi = _mm256_unpackhi_epi16(BG, RA);
+    _mm256_storeu_si256((__m256i *)(dst + i * 4), _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256((__m256i *)(dst + i * 4 + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+  }
+
+  convertRowSSE4_1(y + i, u + i, v + i, dst + i * 4, n - i, p);
+}
+
+#endif // YUVIEW_ARCH_X86
+
+#if YUVIEW_ARCH_NEON
+
+// Load 4 values, apply the pre shift (negative shift = shift right) and subtract the offset
+inline int32x4_t
+loadValuesNEON(const uint16_t *src, const int32x4_t preShift, const int32x4_t offset)
+{
+  const auto values = vreinterpretq_s32_u32(vmovl_u16(vld1_u16(src)));
+  return vsubq_s32(vshlq_s32(values, preShift), offset);
+}
+
+void convertRowNEON(const uint16_t *               y,
+                    const uint16_t *               u,
+                    const uint16_t *               v,
+                    unsigned char *                dst,
+                    const unsigned                 n,
+                    const RowConversionParameters &p)
+{
+  const auto c0       = vdupq_n_s32(p.RGBConv[0]);
+  const auto c1       = vdupq_n_s32(p.RGBConv[1]);
+  const auto c2       = vdupq_n_s32(p.RGBConv[2]);
+  const auto c3       = vdupq_n_s32(p.RGBConv[3]);
+  const auto c4       = vdupq_n_s32(p.RGBConv[4]);
+  const auto yOffset  = vdupq_n_s32(p.yOffset);
+  const auto cZero    = vdupq_n_s32(p.cZero);
+  // A shift left by a negative value is an arithmetic right shift
+  const auto preShift = vdupq_n_s32(-p.preShift);
+  const auto shift    = vdupq_n_s32(-p.shift);
+
+  unsigned i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    int32x4_t r[2], g[2], b[2];
+    for (unsigned k = 0; k < 2; k++)
+    {
+      const auto offset = i + k * 4;
+      const auto Y      = loadValuesNEON(y + offset, preShift, yOffset);
+      const auto U      = loadValuesNEON(u + offset, preShift, cZero);
+      const auto V      = loadValuesNEON(v + offset, preShift, cZero);
+
+      const auto Y_tmp = vmulq_s32(Y, c0);
+      r[k]             = vshlq_s32(vaddq_s32(Y_tmp, vmulq_s32(V, c1)), shift);
+      g[k] = vshlq_s32(vaddq_s32(vaddq_s32(Y_tmp, vmulq_s32(U, c2)), vmulq_s32(V, c3)), shift);
+      b[k] = vshlq_s32(vaddq_s32(Y_tmp, vmulq_s32(U, c4)), shift);
+    }
+
+    uint8x8x4_t bgra;
+    bgra.val[0] = vqmovun_s16(vcombine_s16(vqmovn_s32(b[0]), vqmovn_s32(b[1])));
+    bgra.val[1] = vqmovun_s16(vcombine_s16(vqmovn_s32(g[0]), vqmovn_s32(g[1])));
+    bgra.val[2] = vqmovun_s16(vcombine_s16(vqmovn_s32(r[0]), vqmovn_s32(r[1])));
+    bgra.val[3] = vdup_n_u8(255);
+    vst4_u8(dst + i * 4, bgra);
+  }
+
+  convertRowScalar(y + i, u + i, v + i, dst + i * 4, n - i, p);
+}
+
+#endif // YUVIEW_ARCH_NEON
+
+} // namespace
+
+RowConversionParameters::RowConversionParameters(ColorConversion colorConversion,
+                                                 unsigned        bitsPerSample)
+{
+  getColorConversionCoefficients(colorConversion, this->RGBConv);
+  const bool fullRange = (colorConversion == ColorConversion::BT709_FullRange ||
+                          colorConversion == ColorConversion::BT601_FullRange ||
+                          colorConversion == ColorConversion::BT2020_FullRange);
+
+  // The bit depth of an int (32) is not enough to perform a YUV -> RGB conversion for a bit depth
+  // > 14 bits. We are clipping the result to 8 bit anyways so we drop the lowest 2 bits.
+  this->preShift         = (bitsPerSample > 14) ? 2 : 0;
+  const int effectiveBps = int(bitsPerSample) - this->preShift;
+  this->yOffset          = fullRange ? 0 : (16 << (effectiveBps - 8));
+  this->cZero            = 128 << (effectiveBps - 8);
+  this->shift            = 16 + effectiveBps - 8;
+}
+
+void convertRowYUVToBGRA(const uint16_t *               y,
+                         const uint16_t *               u,
+                         const uint16_t *               v,
+                         unsigned char *                dst,
+                         const unsigned                 n,
+                         const RowConversionParameters &parameters,
+                         const SIMDInstructionSet       instructionSet)
+{
+#if YUVIEW_ARCH_X86
+  if (instructionSet == SIMDInstructionSet::AVX2)
+    return convertRowAVX2(y, u, v, dst, n, parameters);
+  if (instructionSet == SIMDInstructionSet::SSE4_1)
+    return convertRowSSE4_1(y, u, v, dst, n, parameters);
+#endif
+#if YUVIEW_ARCH_NEON
+  if (instructionSet == SIMDInstructionSet::NEON)
+    return convertRowNEON(y, u, v, dst, n, parameters);
+#endif
+  convertRowScalar(y, u, v, dst, n, parameters);
+}
+
+bool convertPlanarYUVToBGRA(const PlanarYUVSource &   source,
+                            const PixelFormatYUV &    format,
+                            const Size &              frameSize,
+                            const ConversionSettings &settings,
+                            unsigned char *           dst,
+                            unsigned                  lineBegin,
+                            unsigned                  lineEnd,
+                            const SIMDInstructionSet  instructionSet)
+{
+  const auto subsampling = format.getSubsampling();
+  if (subsampling == Subsampling::YUV_400 || subsampling == Subsampling::UNKNOWN)
+    return false;
+
+  const auto w = frameSize.width;
+  const auto h = frameSize.height;
+  lineEnd      = std::min(lineEnd, h);
+  if (lineBegin >= lineEnd)
+    return true;
+
+  const auto subsamplingHor = format.getSubsamplingHor();
+  const auto subsamplingVer = format.getSubsamplingVer();
+  const auto widthChroma    = w / subsamplingHor;
+  const auto heightChroma   = h / subsamplingVer;
+  const auto bps            = format.getBitsPerSample();
+  const auto bigEndian      = format.isBigEndian();
+  const auto bytesPerValue  = (bps > 8) ? 2 : 1;
+  const auto interpolation  = settings.chromaInterpolation;
+  const auto strideY        = (source.strideY > 0) ? source.strideY : size_t(w) * bytesPerValue;
+
+  const RowConversionParameters parameters(settings.colorConversion, bps);
+
+  // The chroma offset is only taken into account when interpolating
+  const auto chromaOffset8 = (interpolation == ChromaInterpolation::NearestNeighbor)
+                                 ? Offset()
+                                 : getChromaOffset8(format);
+
+  std::vector<uint16_t> lineY(w), lineU(w), lineV(w);
+  std::vector<uint16_t> tmpU(widthChroma), tmpV(widthChroma);
+  ChromaLineCache       chroma(source, widthChroma, bps, bigEndian, settings.mathC, chromaOffset8);
+
+  for (unsigned line = lineBegin; line < lineEnd; line++)
+  {
+    readLine(source.y + size_t(line) * strideY,
+             w,
+             1,
+             bps,
+             bigEndian,
+             settings.mathY,
+             lineY.data());
+
+    if (subsampling == Subsampling::YUV_444 || subsampling == Subsampling::YUV_422 ||
+        subsampling == Subsampling::YUV_411)
+    {
+      const auto &c = chroma.get(line);
+      upsampleLineHorizontal(c.u.data(), widthChroma, subsamplingHor, interpolation, lineU.data());
+      upsampleLineHorizontal(c.v.data(), widthChroma, subsamplingHor, interpolation, lineV.data());
+    }
+    else if (subsampling == Subsampling::YUV_420 || subsampling == Subsampling::YUV_440)
+    {
+      // Even luma lines are co-located with a chroma line. Odd lines are interpolated between the
+      // two neighboring chroma lines (except for the last line where there is no next line).
+      const int   chromaLine = line / 2;
+      const auto &c          = chroma.get(chromaLine);
+      const bool  between    = (line % 2 == 1 && unsigned(chromaLine) + 1 < heightChroma);
+      if (!between)
+      {
+        upsampleLineHorizontal(
+            c.u.data(), widthChroma, subsamplingHor, interpolation, lineU.data());
+        upsampleLineHorizontal(
+            c.v.data(), widthChroma, subsamplingHor, interpolation, lineV.data());
+      }
+      else
+      {
+        const auto &cNext = chroma.get(chromaLine + 1, chromaLine);
+        if (subsampling == Subsampling::YUV_420)
+        {
+          upsampleLine420Between(
+              c.u.data(), cNext.u.data(), widthChroma, interpolation, lineU.data());
+          upsampleLine420Between(
+              c.v.data(), cNext.v.data(), widthChroma, interpolation, lineV.data());
+        }
+        else
+        {
+          for (unsigned x = 0; x < w; x++)
+          {
+            lineU[x] = interpolateUVSample(interpolation, c.u[x], cNext.u[x]);
+            lineV[x] = interpolateUVSample(interpolation, c.v[x], cNext.v[x]);
+          }
+        }
+      }
+    }
+    else if (subsampling == Subsampling::YUV_410)
+    {
+      // Interpolate vertically at the quarter position first, then horizontally.
+      const int   chromaLine = line / 4;
+      const int   quarterPos = line % 4;
+      const auto &c          = chroma.get(chromaLine);
+      const auto &cNext =
+          (unsigned(chromaLine) + 1 < heightChroma) ? chroma.get(chromaLine + 1, chromaLine) : c;
+      for (unsigned x = 0; x < widthChroma; x++)
+      {
+        tmpU[x] = interpolateUVSampleQ(interpolation, c.u[x], cNext.u[x], quarterPos);
+        tmpV[x] = interpolateUVSampleQ(interpolation, c.v[x], cNext.v[x], quarterPos);
+      }
+      upsampleLineHorizontal(tmpU.data(), widthChroma, 4, interpolation, lineU.data());
+      upsampleLineHorizontal(tmpV.data(), widthChroma, 4, interpolation, lineV.data());
+    }
+    else
+      return false;
+
+    convertRowYUVToBGRA(lineY.data(),
+                        lineU.data(),
+                        lineV.data(),
+                        dst + size_t(line) * w * 4,
+                        w,
+                        parameters,
+                        instructionSet);
+  }
+
+  return true;
+}
+
+bool convertPlanarYUVToBGRA(const PlanarYUVSource &   source,
+                            const PixelFormatYUV &    format,
+                            const Size &              frameSize,
+                            const ConversionSettings &settings,
+                            unsigned char *           dst,
+                            unsigned                  lineBegin,
+                            unsigned                  lineEnd)
+{
+  return convertPlanarYUVToBGRA(source,
+                                format,
+                                frameSize,
+                                settings,
+                                dst,
+                                lineBegin,
+                                lineEnd,
+                                functions::getSIMDInstructionSet());
+}
+
+bool convertPlanarYUVToBGRAParallel(const PlanarYUVSource &   source,
+                                    const PixelFormatYUV &    format,
+                                    const Size &              frameSize,
+                                    const ConversionSettings &settings,
+                                    unsigned char *           dst)
+{
+  struct Stripe
+  {
+    unsigned lineBegin;
+    unsigned lineEnd;
+  };
+
+  // Only use the threads of the pool that are currently idle. The calling thread works on the
+  // stripes as well, so with a busy pool this falls back to a plain conversion in this thread.
+  const auto pool        = QThreadPool::globalInstance();
+  const auto idleThreads = std::max(pool->maxThreadCount() - pool->activeThreadCount(), 0);
+  const auto nrStripesMax =
+      std::min(unsigned(idleThreads) + 1, frameSize.height / MinLinesPerStripe);
+  if (nrStripesMax <= 1)
+    return convertPlanarYUVToBGRA(source, format, frameSize, settings, dst, 0, frameSize.height);
+
+  // Every output line only depends on the source planes so the stripe borders need no special
+  // handling. Aligning them to 4 lines (the maximum vertical subsampling) only keeps the chroma
+  // lines of one stripe from being read (and up-sampled) by two threads.
+  const auto linesPerStripe = ((frameSize.height + nrStripesMax - 1) / nrStripesMax + 3) & ~3u;
+  std::vector<Stripe> stripes;
+  for (unsigned line = 0; line < frameSize.height; line += linesPerStripe)
+    stripes.push_back({line, std::min(line + linesPerStripe, frameSize.height)});
+
+  const auto        instructionSet = functions::getSIMDInstructionSet();
+  std::atomic<bool> allOK{true};
+  QtConcurrent::blockingMap(stripes, [&](const Stripe &stripe) {
+    if (!convertPlanarYUVToBGRA(source,
+                                format,
+                                frameSize,
+                                settings,
+                                dst,
+                                stripe.lineBegin,
+                                stripe.lineEnd,
+                                instructionSet))
+      allOK = false;
+  });
+
+  return allOK;
+}
+
+} // namespace video::yuv
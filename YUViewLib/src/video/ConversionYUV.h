@@ -0,0 +1,126 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <common/CPUFeatures.h>
+#include <common/Typedef.h>
+
+#include "PixelFormatYUV.h"
+
+namespace video::yuv
+{
+
+// All settings (apart from the pixel format) that influence the conversion from YUV to RGB.
+struct ConversionSettings
+{
+  ChromaInterpolation chromaInterpolation{ChromaInterpolation::NearestNeighbor};
+  ColorConversion     colorConversion{ColorConversion::BT709_LimitedRange};
+  MathParameters      mathY;
+  MathParameters      mathC;
+};
+
+// Pointers to the Y, U and V plane of a planar YUV frame. If the chroma components are
+// interleaved, u and v point to the first U and V value and chromaValueSkip is the distance
+// (in values) between two U (or V) values. The planes may have a stride (in bytes) that is larger
+// than one line (e.g. when pointing to the buffers of a decoder). A stride of 0 means that the
+// lines of the plane directly follow each other.
+struct PlanarYUVSource
+{
+  const unsigned char *y{};
+  const unsigned char *u{};
+  const unsigned char *v{};
+  int                  chromaValueSkip{1};
+  size_t               strideY{};
+  size_t               strideC{};
+};
+
+// The fixed point parameters for converting one line of YUV values to RGB. The values are
+// first shifted right by preShift (for bit depths above 14 bit the 32 bit integers are not
+// sufficient otherwise), then the offsets are removed and the RGBConv matrix is applied. The
+// result is shifted right by shift and clipped to 8 bit.
+struct RowConversionParameters
+{
+  RowConversionParameters() = default;
+  RowConversionParameters(ColorConversion colorConversion, unsigned bitsPerSample);
+
+  int RGBConv[5]{};
+  int preShift{};
+  int yOffset{};
+  int cZero{};
+  int shift{};
+};
+
+// Convert n YUV values (one per pixel, chroma already up-sampled) to BGRA (alpha is set to 255).
+// The kernel for the given instruction set is used. All kernels are bit exact.
+void convertRowYUVToBGRA(const uint16_t *               y,
+                         const uint16_t *               u,
+                         const uint16_t *               v,
+                         unsigned char *                dst,
+                         unsigned                       n,
+                         const RowConversionParameters &parameters,
+                         functions::SIMDInstructionSet  instructionSet);
+
+// Convert the luma lines [lineBegin, lineEnd) of a planar YUV frame to BGRA with 4 bytes per
+// pixel. dst points to the beginning of the output frame (not to lineBegin). Every output line
+// only depends on the source planes, so the lines can be converted in any order. All
+// subsamplings except 4:0:0 are supported. Unless the chroma interpolation is nearest neighbor,
+// the chroma samples are re-sampled according to the chroma offset of the format. The active SIMD
+// instruction set (functions::getSIMDInstructionSet) is used unless another one is given.
+bool convertPlanarYUVToBGRA(const PlanarYUVSource &       source,
+                            const PixelFormatYUV &        format,
+                            const Size &                  frameSize,
+                            const ConversionSettings &    settings,
+                            unsigned char *               dst,
+                            unsigned                      lineBegin,
+                            unsigned                      lineEnd,
+                            functions::SIMDInstructionSet instructionSet);
+bool convertPlanarYUVToBGRA(const PlanarYUVSource &   source,
+                            const PixelFormatYUV &    format,
+                            const Size &              frameSize,
+                            const ConversionSettings &settings,
+                            unsigned char *           dst,
+                            unsigned                  lineBegin,
+                            unsigned                  lineEnd);
+
+// Frames are only split into stripes with at least this many lines.
+constexpr unsigned MinLinesPerStripe = 32;
+
+// Convert the whole frame. The frame is split into horizontal stripes which are converted in
+// parallel on the global QThreadPool.
+bool convertPlanarYUVToBGRAParallel(const PlanarYUVSource &   source,
+                                    const PixelFormatYUV &    format,
+                                    const Size &              frameSize,
+                                    const ConversionSettings &settings,
+                                    unsigned char *           dst);
+
+} // namespace video::yuv
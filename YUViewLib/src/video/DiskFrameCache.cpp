@@ -0,0 +1,274 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiskFrameCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <vector>
+
+#include <video/CompressedFrameCache.h>
+
+namespace video
+{
+
+namespace
+{
+
+const auto FrameFileSuffix = QString(".frame");
+// This file is rewritten whenever a sequence is used. Its modification time is used to find the
+// least recently used sequences.
+const auto LastUsedFileName = QString("lastUsed");
+
+// The cache is pruned after 1/PruneFraction of the maximum size was written
+constexpr int64_t PruneFraction = 20;
+
+bool isCacheFile(const QFileInfo &file)
+{
+  return file.fileName().endsWith(FrameFileSuffix) || file.fileName() == LastUsedFileName;
+}
+
+void markSequenceUsed(const QString &sequencePath)
+{
+  QFile lastUsedFile(sequencePath + "/" + LastUsedFileName);
+  if (lastUsedFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    lastUsedFile.write(QDateTime::currentDateTime().toString(Qt::ISODate).toLatin1());
+}
+
+} // namespace
+
+void DiskFrameCache::setCacheDirectory(const QString &directory, int64_t maxSizeInBytes)
+{
+  {
+    QMutexLocker lock(&this->accessMutex);
+    maxSizeInBytes = std::max(maxSizeInBytes, int64_t(0));
+    if (directory == this->cacheDirectory && maxSizeInBytes == this->maxSize)
+      return;
+    this->cacheDirectory = directory;
+    this->maxSize        = maxSizeInBytes;
+  }
+  this->prune();
+}
+
+bool DiskFrameCache::isEnabled() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return !this->cacheDirectory.isEmpty() && this->maxSize > 0;
+}
+
+QString DiskFrameCache::getSequenceKey(const QString &    sourceFilePath,
+                                       const QStringList &decodeSettings)
+{
+  const QFileInfo sourceFile(sourceFilePath);
+
+  QStringList keyValues;
+  keyValues << sourceFile.absoluteFilePath();
+  keyValues << QString::number(sourceFile.size());
+  keyValues << QString::number(sourceFile.lastModified().toMSecsSinceEpoch());
+  keyValues << decodeSettings;
+
+  const auto hash =
+      QCryptographicHash::hash(keyValues.join("\n").toUtf8(), QCryptographicHash::Sha1);
+  return QString::fromLatin1(hash.toHex());
+}
+
+bool DiskFrameCache::loadFrame(const QString &sequenceKey, int frameIndex, QByteArray &data)
+{
+  if (!this->isEnabled())
+    return false;
+
+  QFile file(this->getFramePath(sequenceKey, frameIndex));
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  // Decompress directly from the memory mapped file
+  const auto fileSize = file.size();
+  auto       fileData = file.map(0, fileSize);
+  if (fileData == nullptr)
+    return false;
+  const auto compressedData = QByteArray::fromRawData((const char *)fileData, int(fileSize));
+  const auto success        = decompressFrameData(compressedData, data);
+  file.unmap(fileData);
+
+  if (!success)
+  {
+    // The file is corrupt (e.g. the disk was full when writing it)
+    file.remove();
+    return false;
+  }
+
+  if (this->markUsed(sequenceKey))
+    markSequenceUsed(QFileInfo(file).absolutePath());
+  return true;
+}
+
+void DiskFrameCache::saveFrame(const QString &   sequenceKey,
+                               int               frameIndex,
+                               const QByteArray &data,
+                               unsigned          elementSize)
+{
+  if (!this->isEnabled() || data.isEmpty())
+    return;
+
+  const auto framePath    = this->getFramePath(sequenceKey, frameIndex);
+  const auto sequencePath = QFileInfo(framePath).absolutePath();
+  if (!QDir().mkpath(sequencePath))
+    return;
+
+  const auto compressedData = compressFrameData(data, elementSize);
+  if (compressedData.isEmpty())
+    return;
+
+  // Write to a temporary file first so that no partially written frames are loaded
+  QSaveFile file(framePath);
+  if (!file.open(QIODevice::WriteOnly) || file.write(compressedData) != compressedData.size() ||
+      !file.commit())
+    return;
+
+  if (this->markUsed(sequenceKey))
+    markSequenceUsed(sequencePath);
+
+  bool pruneNeeded;
+  {
+    QMutexLocker lock(&this->accessMutex);
+    this->bytesWrittenSincePrune += compressedData.size();
+    pruneNeeded = !this->pruneRunning &&
+                  this->bytesWrittenSincePrune > this->maxSize / PruneFraction;
+  }
+
+  if (pruneNeeded)
+    this->prune();
+}
+
+bool DiskFrameCache::isInCache(const QString &sequenceKey, int frameIndex) const
+{
+  if (!this->isEnabled())
+    return false;
+  return QFile::exists(this->getFramePath(sequenceKey, frameIndex));
+}
+
+void DiskFrameCache::prune()
+{
+  // Scanning and deleting files can take a while. Only take a snapshot of the settings under the
+  // lock so that loading and saving frames is not blocked. Only one thread prunes at a time.
+  QString cacheDirectory;
+  int64_t maxSize;
+  {
+    QMutexLocker lock(&this->accessMutex);
+    if (this->pruneRunning || this->cacheDirectory.isEmpty() || this->maxSize <= 0)
+      return;
+    this->pruneRunning           = true;
+    this->bytesWrittenSincePrune = 0;
+    cacheDirectory               = this->cacheDirectory;
+    maxSize                      = this->maxSize;
+  }
+
+  struct Sequence
+  {
+    QString   path;
+    int64_t   size{};
+    QDateTime lastUsed;
+  };
+  std::vector<Sequence> sequences;
+  int64_t               totalSize = 0;
+
+  QDir cacheDir(cacheDirectory);
+  for (const auto &sequenceDir : cacheDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+  {
+    Sequence sequence;
+    sequence.path     = sequenceDir.absoluteFilePath();
+    sequence.lastUsed = sequenceDir.lastModified();
+    for (const auto &file : QDir(sequence.path).entryInfoList(QDir::Files))
+    {
+      if (!isCacheFile(file))
+        continue;
+      sequence.size += file.size();
+      sequence.lastUsed = std::max(sequence.lastUsed, file.lastModified());
+    }
+    totalSize += sequence.size;
+    sequences.push_back(sequence);
+  }
+
+  std::sort(sequences.begin(), sequences.end(), [](const Sequence &s1, const Sequence &s2) {
+    return s1.lastUsed < s2.lastUsed;
+  });
+
+  QStringList removedSequences;
+  for (const auto &sequence : sequences)
+  {
+    if (totalSize <= maxSize)
+      break;
+
+    // Only delete the files that we created. The directory may be an arbitrary user directory.
+    QDir sequenceDir(sequence.path);
+    for (const auto &file : sequenceDir.entryInfoList(QDir::Files))
+      if (isCacheFile(file))
+        QFile::remove(file.absoluteFilePath());
+    cacheDir.rmdir(sequence.path);
+    removedSequences.append(sequenceDir.dirName());
+    totalSize -= sequence.size;
+  }
+
+  QMutexLocker lock(&this->accessMutex);
+  for (const auto &sequenceKey : removedSequences)
+    this->usedSequences.remove(sequenceKey);
+  this->pruneRunning = false;
+}
+
+bool DiskFrameCache::markUsed(const QString &sequenceKey)
+{
+  QMutexLocker lock(&this->accessMutex);
+  if (this->usedSequences.contains(sequenceKey))
+    return false;
+  this->usedSequences.insert(sequenceKey);
+  return true;
+}
+
+QString DiskFrameCache::getFramePath(const QString &sequenceKey, int frameIndex) const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->cacheDirectory + "/" + sequenceKey + "/" + QString::number(frameIndex) +
+         FrameFileSuffix;
+}
+
+DiskFrameCache &getDiskFrameCache()
+{
+  static DiskFrameCache diskFrameCache;
+  return diskFrameCache;
+}
+
+} // namespace video
@@ -0,0 +1,97 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+
+namespace video
+{
+
+/* A persistent cache for decoded frames on disk. Decoding with a reference decoder can be very
+ * slow, so the decoded raw frames are saved (losslessly compressed) in a cache directory and can be
+ * loaded from there the next time the same file is opened with the same settings.
+ * Each sequence is saved in its own subdirectory which is named by the sequence key. If the cache
+ * exceeds the maximum size, the least recently used sequences are deleted. All functions are
+ * thread safe.
+ */
+class DiskFrameCache
+{
+public:
+  DiskFrameCache() = default;
+
+  // Set the cache directory and the maximum size in bytes. An empty directory or a maximum size of
+  // 0 disables the cache.
+  void setCacheDirectory(const QString &directory, int64_t maxSizeInBytes);
+  bool isEnabled() const;
+
+  // Get the key for the frames of the given source file. The decode settings are all settings
+  // that influence the decoded data (e.g. the decoder, the decode signal and the pixel format).
+  // The file size and modification time are part of the key so a modified file is decoded again.
+  static QString getSequenceKey(const QString &sourceFilePath, const QStringList &decodeSettings);
+
+  // Load the frame from the cache. Returns false if the frame is not in the cache.
+  bool loadFrame(const QString &sequenceKey, int frameIndex, QByteArray &data);
+  // Save the frame to the cache. The elementSize is passed on to compressFrameData.
+  void saveFrame(const QString &   sequenceKey,
+                 int               frameIndex,
+                 const QByteArray &data,
+                 unsigned          elementSize);
+  bool isInCache(const QString &sequenceKey, int frameIndex) const;
+
+  // Delete the least recently used sequences until the cache is below the maximum size. The files
+  // are scanned and deleted without holding the lock. If another thread is pruning already, this
+  // returns immediately.
+  void prune();
+
+private:
+  QString getFramePath(const QString &sequenceKey, int frameIndex) const;
+  // Add the sequence to the used sequences. Returns true if it was not marked as used before (and
+  // its last used file must be written).
+  bool markUsed(const QString &sequenceKey);
+
+  mutable QMutex accessMutex;
+  QString        cacheDirectory;
+  int64_t        maxSize{};
+  int64_t        bytesWrittenSincePrune{};
+  bool           pruneRunning{};
+  // The sequences that were marked as used in this session
+  QSet<QString>  usedSequences;
+};
+
+// The disk frame cache that is used by all playlist items
+DiskFrameCache &getDiskFrameCache();
+
+} // namespace video
@@ -0,0 +1,83 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+
+#include <memory>
+#include <vector>
+
+namespace video
+{
+
+/* The raw data of one frame as it is handed from a decoder (or file) to a video handler. A frame
+ * buffer either holds packed data (all planes directly after each other without any padding) in a
+ * QByteArray or it points to the planes of a frame that is owned by somebody else, e.g. a frame
+ * from the buffer pool of a decoder. These planes can have a stride that is larger than a line.
+ * Copies of a frame buffer share the data. The owner of the planes is released when the last copy
+ * is destroyed. The data is only copied if packed data is requested for strided planes.
+ */
+class FrameBuffer
+{
+public:
+  struct Plane
+  {
+    const unsigned char *data{};
+    size_t               stride{};    //< The distance in bytes from one line to the next
+    size_t               lineBytes{}; //< The number of bytes in one line (without padding)
+    unsigned             nrLines{};
+  };
+
+  FrameBuffer() = default;
+  FrameBuffer(const QByteArray &packedData);
+  // Point to the given planes. The owner is kept alive as long as the frame buffer is used.
+  FrameBuffer(const std::vector<Plane> &planes, std::shared_ptr<const void> owner);
+
+  bool isNull() const;
+  // Packed data can be used as a QByteArray without copying it
+  bool isPacked() const { return this->planes.empty(); }
+
+  const std::vector<Plane> &getPlanes() const { return this->planes; }
+  // The size of the packed data
+  size_t getSize() const;
+
+  // Get the packed data. If the data is not packed, the planes are copied line by line.
+  QByteArray toByteArray() const;
+
+private:
+  QByteArray                  packedData;
+  std::vector<Plane>          planes;
+  std::shared_ptr<const void> owner;
+};
+
+} // namespace video
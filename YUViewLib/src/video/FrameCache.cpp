@@ -0,0 +1,256 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameCache.h"
+
+#include <common/Functions.h>
+
+#include <vector>
+
+namespace video
+{
+
+namespace
+{
+
+int64_t getImageSize(const QImage &image)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
+  return int64_t(image.byteCount());
+#else
+  return int64_t(image.sizeInBytes());
+#endif
+}
+
+} // namespace
+
+void FrameCache::setMaxSize(int64_t maxSizeInBytes)
+{
+  QMutexLocker lock(&this->accessMutex);
+  this->maxSize = maxSizeInBytes;
+}
+
+void FrameCache::insertImage(const void *owner, int frameIndex, const QImage &image)
+{
+  this->insert(Key(std::uintptr_t(owner), frameIndex), image, {}, getImageSize(image));
+}
+
+void FrameCache::insertRawData(const void *owner, int frameIndex, const QByteArray &rawData)
+{
+  // The cache outlives the source of the data. So it must not reference a memory mapped file.
+  const auto key = Key(std::uintptr_t(owner), frameIndex);
+  this->insert(key, {}, functions::toOwnedByteArray(rawData), int64_t(rawData.size()));
+}
+
+void FrameCache::insert(const Key &       key,
+                        const QImage &    image,
+                        const QByteArray &rawData,
+                        int64_t           size)
+{
+  QMutexLocker lock(&this->accessMutex);
+
+  auto existing = this->entries.find(key);
+  if (existing != this->entries.end())
+    this->removeEntry(existing, false);
+
+  Entry entry;
+  entry.image       = image;
+  entry.rawData     = rawData;
+  entry.size        = size;
+  entry.lruPosition = this->lruList.insert(this->lruList.end(), key);
+  this->entries.emplace(key, std::move(entry));
+
+  auto &ownerFrames = this->owners[key.first];
+  ownerFrames.frames.insert(key.second);
+  ownerFrames.size += size;
+  this->status.nrFrames++;
+  this->status.size += size;
+
+  // Never drop the frame that was just added
+  while (this->maxSize > 0 && this->status.size > this->maxSize && this->lruList.size() > 1)
+    this->removeEntry(this->entries.find(this->lruList.front()), true);
+}
+
+bool FrameCache::getEntry(const void *owner, int frameIndex, bool image, Entry &entry)
+{
+  QMutexLocker lock(&this->accessMutex);
+
+  auto it = this->entries.find(Key(std::uintptr_t(owner), frameIndex));
+  if (it == this->entries.end() || it->second.image.isNull() == image)
+  {
+    this->status.misses++;
+    return false;
+  }
+
+  this->lruList.splice(this->lruList.end(), this->lruList, it->second.lruPosition);
+  this->status.hits++;
+  entry.image   = it->second.image;
+  entry.rawData = it->second.rawData;
+  return true;
+}
+
+bool FrameCache::getImage(const void *owner, int frameIndex, QImage &image)
+{
+  Entry entry;
+  if (!this->getEntry(owner, frameIndex, true, entry))
+    return false;
+  image = entry.image;
+  return true;
+}
+
+bool FrameCache::getRawData(const void *owner, int frameIndex, QByteArray &rawData)
+{
+  Entry entry;
+  if (!this->getEntry(owner, frameIndex, false, entry))
+    return false;
+  rawData = entry.rawData;
+  return true;
+}
+
+bool FrameCache::contains(const void *owner, int frameIndex) const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->entries.count(Key(std::uintptr_t(owner), frameIndex)) > 0;
+}
+
+bool FrameCache::containsImage(const void *owner, int frameIndex) const
+{
+  QMutexLocker lock(&this->accessMutex);
+  auto         it = this->entries.find(Key(std::uintptr_t(owner), frameIndex));
+  return it != this->entries.end() && !it->second.image.isNull();
+}
+
+QByteArray FrameCache::remove(const void *owner, int frameIndex)
+{
+  QMutexLocker lock(&this->accessMutex);
+
+  auto it = this->entries.find(Key(std::uintptr_t(owner), frameIndex));
+  if (it == this->entries.end())
+    return {};
+
+  auto rawData = it->second.rawData;
+  this->removeEntry(it, true);
+  return rawData;
+}
+
+void FrameCache::removeOutsideOfRange(const void *owner, int first, int last)
+{
+  QMutexLocker lock(&this->accessMutex);
+
+  auto ownerIt = this->owners.find(std::uintptr_t(owner));
+  if (ownerIt == this->owners.end())
+    return;
+
+  // Collect the frames first. removeEntry may erase the owner (and its frame set).
+  std::vector<int> framesToRemove;
+  const auto &     frames = ownerIt->second.frames;
+  for (auto it = frames.begin(); it != frames.lower_bound(first); it++)
+    framesToRemove.push_back(*it);
+  for (auto it = frames.upper_bound(last); it != frames.end(); it++)
+    framesToRemove.push_back(*it);
+
+  for (auto frameIndex : framesToRemove)
+    this->removeEntry(this->entries.find(Key(std::uintptr_t(owner), frameIndex)), true);
+}
+
+void FrameCache::removeAll(const void *owner)
+{
+  QMutexLocker lock(&this->accessMutex);
+
+  auto ownerIt = this->owners.find(std::uintptr_t(owner));
+  if (ownerIt == this->owners.end())
+    return;
+
+  const auto frames = ownerIt->second.frames;
+  for (auto frameIndex : frames)
+    this->removeEntry(this->entries.find(Key(std::uintptr_t(owner), frameIndex)), false);
+}
+
+void FrameCache::removeEntry(EntryMap::iterator entry, bool countEviction)
+{
+  const auto key  = entry->first;
+  const auto size = entry->second.size;
+
+  this->lruList.erase(entry->second.lruPosition);
+  this->entries.erase(entry);
+
+  auto ownerIt = this->owners.find(key.first);
+  ownerIt->second.frames.erase(key.second);
+  ownerIt->second.size -= size;
+  if (ownerIt->second.frames.empty())
+    this->owners.erase(ownerIt);
+
+  this->status.nrFrames--;
+  this->status.size -= size;
+  if (countEviction)
+    this->status.evictions++;
+}
+
+QList<int> FrameCache::getFrames(const void *owner) const
+{
+  QMutexLocker lock(&this->accessMutex);
+
+  QList<int> frames;
+  auto       ownerIt = this->owners.find(std::uintptr_t(owner));
+  if (ownerIt != this->owners.end())
+    for (auto frameIndex : ownerIt->second.frames)
+      frames.append(frameIndex);
+  return frames;
+}
+
+int FrameCache::getNrFrames(const void *owner) const
+{
+  QMutexLocker lock(&this->accessMutex);
+  auto         ownerIt = this->owners.find(std::uintptr_t(owner));
+  return ownerIt == this->owners.end() ? 0 : int(ownerIt->second.frames.size());
+}
+
+int64_t FrameCache::getSize(const void *owner) const
+{
+  QMutexLocker lock(&this->accessMutex);
+  auto         ownerIt = this->owners.find(std::uintptr_t(owner));
+  return ownerIt == this->owners.end() ? 0 : ownerIt->second.size;
+}
+
+FrameCache::Status FrameCache::getStatus() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->status;
+}
+
+FrameCache &getFrameCache()
+{
+  static FrameCache frameCache;
+  return frameCache;
+}
+
+} // namespace video
@@ -0,0 +1,137 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+
+#include <cstdint>
+#include <list>
+#include <set>
+#include <unordered_map>
+
+namespace video
+{
+
+/* The cache for the frames of all video handlers. Each handler uses its own pointer as the owner
+ * of its frames. A frame is either cached as a converted image or as raw data.
+ * The frames are indexed in a hash table and kept in a least recently used list. The exact number
+ * of bytes used by each owner and by the whole cache is accounted for so that the caching logic
+ * does not have to iterate over all cached frames. The VideoCache decides which frames to remove
+ * but if the maximum size is exceeded anyways (e.g. the size of a frame was estimated
+ * incorrectly), the least recently used frames are dropped. All functions are thread safe.
+ */
+class FrameCache
+{
+public:
+  FrameCache() = default;
+
+  // Set the maximum size in bytes. 0 means no limit.
+  void setMaxSize(int64_t maxSizeInBytes);
+
+  // Add the frame to the cache. An existing entry for the frame is replaced.
+  void insertImage(const void *owner, int frameIndex, const QImage &image);
+  void insertRawData(const void *owner, int frameIndex, const QByteArray &rawData);
+
+  // Get the frame from the cache and mark it as recently used. These are counted as hits/misses.
+  bool getImage(const void *owner, int frameIndex, QImage &image);
+  bool getRawData(const void *owner, int frameIndex, QByteArray &rawData);
+
+  bool contains(const void *owner, int frameIndex) const;
+  bool containsImage(const void *owner, int frameIndex) const;
+
+  // Remove the frame from the cache. If raw data was cached for the frame, it is returned.
+  QByteArray remove(const void *owner, int frameIndex);
+  // Remove all frames of the owner that are outside of the given range (first to last)
+  void removeOutsideOfRange(const void *owner, int first, int last);
+  void removeAll(const void *owner);
+
+  // Get the cached frames of the owner in ascending order
+  QList<int> getFrames(const void *owner) const;
+  int        getNrFrames(const void *owner) const;
+  int64_t    getSize(const void *owner) const;
+
+  struct Status
+  {
+    int     nrFrames{};
+    int64_t size{};
+    int64_t hits{};
+    int64_t misses{};
+    int64_t evictions{};
+  };
+  Status getStatus() const;
+
+private:
+  using Key = std::pair<std::uintptr_t, int>;
+  struct KeyHash
+  {
+    std::size_t operator()(const Key &key) const
+    {
+      return std::hash<std::uintptr_t>()(key.first) ^ (std::size_t(key.second) * 2654435761u);
+    }
+  };
+  struct Entry
+  {
+    QImage                   image;
+    QByteArray               rawData;
+    int64_t                  size{};
+    std::list<Key>::iterator lruPosition;
+  };
+  struct OwnerFrames
+  {
+    std::set<int> frames;
+    int64_t       size{};
+  };
+  using EntryMap = std::unordered_map<Key, Entry, KeyHash>;
+
+  void insert(const Key &key, const QImage &image, const QByteArray &rawData, int64_t size);
+  // Remove the entry. Evictions are counted in the status.
+  void removeEntry(EntryMap::iterator entry, bool countEviction);
+  // Get the image (or the raw data) of the frame. Frames of the other type count as misses.
+  bool getEntry(const void *owner, int frameIndex, bool image, Entry &entry);
+
+  mutable QMutex accessMutex;
+  EntryMap       entries;
+  // The front is the least recently used frame
+  std::list<Key>                                  lruList;
+  std::unordered_map<std::uintptr_t, OwnerFrames> owners;
+  int64_t                                         maxSize{};
+  Status                                          status;
+};
+
+// The frame cache that is used by all video handlers
+FrameCache &getFrameCache();
+
+} // namespace video
@@ -0,0 +1,247 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FrameMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace video
+{
+
+namespace
+{
+
+// One plane of samples in memory
+struct PlaneView
+{
+  const unsigned char *data{};
+  size_t               stride{};
+  unsigned             width{};
+  unsigned             height{};
+};
+
+class SampleReader
+{
+public:
+  SampleReader(const PlaneView &plane, unsigned bitsPerSample, bool bigEndian)
+      : plane(plane), twoBytes(bitsPerSample > 8), bigEndian(bigEndian)
+  {
+  }
+
+  int get(unsigned x, unsigned y) const
+  {
+    const auto line = this->plane.data + y * this->plane.stride;
+    if (!this->twoBytes)
+      return line[x];
+    const auto p = line + 2 * x;
+    return this->bigEndian ? (p[0] << 8) | p[1] : (p[1] << 8) | p[0];
+  }
+
+private:
+  PlaneView plane;
+  bool      twoBytes;
+  bool      bigEndian;
+};
+
+// Get the Y, U and V planes of the frame (in this order). The data of a packed frame buffer is put
+// into packedData so that it stays valid while the planes are used.
+std::optional<std::vector<PlaneView>> getComponentPlanes(const FrameBuffer &        frame,
+                                                         const yuv::PixelFormatYUV &format,
+                                                         const Size &               frameSize,
+                                                         QByteArray &               packedData)
+{
+  if (!format.isValid() || format.getPredefinedFormat() || !format.isPlanar() ||
+      format.isUVInterleaved())
+    return {};
+
+  const auto nrComponents     = (format.getSubsampling() == yuv::Subsampling::YUV_400) ? 1u : 3u;
+  const auto nrBytesPerSample = format.getBitsPerSample() <= 8 ? 1u : 2u;
+
+  std::vector<PlaneView> planes;
+  for (unsigned i = 0; i < nrComponents; i++)
+  {
+    const auto component = (i == 0) ? yuv::Component::Luma : yuv::Component::Chroma;
+    PlaneView  plane;
+    plane.width  = frameSize.width / format.getSubsamplingHor(component);
+    plane.height = frameSize.height / format.getSubsamplingVer(component);
+    plane.stride = plane.width * nrBytesPerSample;
+    planes.push_back(plane);
+  }
+
+  const auto &framePlanes = frame.getPlanes();
+  if (!frame.isPacked() && framePlanes.size() >= nrComponents)
+  {
+    for (unsigned i = 0; i < nrComponents; i++)
+    {
+      if (framePlanes[i].lineBytes != planes[i].stride ||
+          framePlanes[i].nrLines != planes[i].height)
+        return {};
+      planes[i].data   = framePlanes[i].data;
+      planes[i].stride = framePlanes[i].stride;
+    }
+  }
+  else
+  {
+    packedData = frame.toByteArray();
+    if (packedData.size() < format.bytesPerFrame(frameSize))
+      return {};
+    auto data = reinterpret_cast<const unsigned char *>(packedData.constData());
+    for (auto &plane : planes)
+    {
+      plane.data = data;
+      data += plane.stride * plane.height;
+    }
+  }
+
+  const auto planeOrder = format.getPlaneOrder();
+  if (nrComponents == 3 &&
+      (planeOrder == yuv::PlaneOrder::YVU || planeOrder == yuv::PlaneOrder::YVUA))
+    std::swap(planes[1], planes[2]);
+  return planes;
+}
+
+double calculatePSNR(double mse, int maxValue)
+{
+  if (mse <= 0.0)
+    return MaxPSNR;
+  return std::min(10.0 * std::log10(double(maxValue) * maxValue / mse), MaxPSNR);
+}
+
+// The SSIM of one window of the two planes
+double calculateWindowSSIM(const SampleReader &frame,
+                           const SampleReader &reference,
+                           unsigned            x0,
+                           unsigned            y0,
+                           unsigned            windowWidth,
+                           unsigned            windowHeight,
+                           int                 maxValue)
+{
+  int64_t sum[2]{}, sumSquared[2]{}, sumProduct{};
+  for (unsigned y = y0; y < y0 + windowHeight; y++)
+    for (unsigned x = x0; x < x0 + windowWidth; x++)
+    {
+      const int64_t a = frame.get(x, y);
+      const int64_t b = reference.get(x, y);
+      sum[0] += a;
+      sum[1] += b;
+      sumSquared[0] += a * a;
+      sumSquared[1] += b * b;
+      sumProduct += a * b;
+    }
+
+  const double n         = double(windowWidth) * windowHeight;
+  const double mean0     = sum[0] / n;
+  const double mean1     = sum[1] / n;
+  const double variance0 = sumSquared[0] / n - mean0 * mean0;
+  const double variance1 = sumSquared[1] / n - mean1 * mean1;
+  const double covar     = sumProduct / n - mean0 * mean1;
+
+  const double c1 = (0.01 * maxValue) * (0.01 * maxValue);
+  const double c2 = (0.03 * maxValue) * (0.03 * maxValue);
+  return ((2 * mean0 * mean1 + c1) * (2 * covar + c2)) /
+         ((mean0 * mean0 + mean1 * mean1 + c1) * (variance0 + variance1 + c2));
+}
+
+ComponentMetrics calculateComponentMetrics(const PlaneView &frame,
+                                           const PlaneView &reference,
+                                           unsigned         bitsPerSample,
+                                           bool             bigEndianFrame,
+                                           bool             bigEndianReference)
+{
+  const SampleReader frameReader(frame, bitsPerSample, bigEndianFrame);
+  const SampleReader referenceReader(reference, bitsPerSample, bigEndianReference);
+  const auto         maxValue = (1 << bitsPerSample) - 1;
+
+  ComponentMetrics metrics;
+  if (frame.width == 0 || frame.height == 0)
+    return metrics;
+
+  int64_t sumSquaredError = 0;
+  for (unsigned y = 0; y < frame.height; y++)
+    for (unsigned x = 0; x < frame.width; x++)
+    {
+      const int64_t diff = frameReader.get(x, y) - referenceReader.get(x, y);
+      sumSquaredError += diff * diff;
+    }
+  metrics.mse  = double(sumSquaredError) / (double(frame.width) * frame.height);
+  metrics.psnr = calculatePSNR(metrics.mse, maxValue);
+
+  // Planes that are smaller than a window are compared as one window
+  const unsigned windowSize   = 8;
+  const unsigned windowStep   = 4;
+  const auto     windowWidth  = std::min(windowSize, frame.width);
+  const auto     windowHeight = std::min(windowSize, frame.height);
+  double         ssimSum      = 0.0;
+  int64_t        nrWindows    = 0;
+  for (unsigned y = 0; y + windowHeight <= frame.height; y += windowStep)
+    for (unsigned x = 0; x + windowWidth <= frame.width; x += windowStep)
+    {
+      ssimSum += calculateWindowSSIM(
+          frameReader, referenceReader, x, y, windowWidth, windowHeight, maxValue);
+      nrWindows++;
+    }
+  metrics.ssim = ssimSum / nrWindows;
+  return metrics;
+}
+
+} // namespace
+
+std::optional<FrameMetrics> calculateFrameMetrics(const FrameBuffer &        frame,
+                                                  const yuv::PixelFormatYUV &format,
+                                                  const FrameBuffer &        reference,
+                                                  const yuv::PixelFormatYUV &referenceFormat,
+                                                  const Size &               frameSize)
+{
+  if (format.getSubsampling() != referenceFormat.getSubsampling() ||
+      format.getBitsPerSample() != referenceFormat.getBitsPerSample())
+    return {};
+
+  QByteArray packedFrame, packedReference;
+  const auto framePlanes = getComponentPlanes(frame, format, frameSize, packedFrame);
+  const auto referencePlanes =
+      getComponentPlanes(reference, referenceFormat, frameSize, packedReference);
+  if (!framePlanes || !referencePlanes)
+    return {};
+
+  FrameMetrics metrics;
+  for (size_t i = 0; i < framePlanes->size(); i++)
+    metrics.components.push_back(calculateComponentMetrics(framePlanes->at(i),
+                                                           referencePlanes->at(i),
+                                                           format.getBitsPerSample(),
+                                                           format.isBigEndian(),
+                                                           referenceFormat.isBigEndian()));
+  return metrics;
+}
+
+} // namespace video
@@ -0,0 +1,73 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "FrameBuffer.h"
+#include "PixelFormatYUV.h"
+
+#include <optional>
+#include <vector>
+
+namespace video
+{
+
+// Objective quality metrics of one component (Y, U or V) of a frame compared to a reference
+// frame. The PSNR of identical components is reported as MaxPSNR (like the HM reference software
+// does). The SSIM is the mean over 8x8 windows that are placed every 4 samples.
+struct ComponentMetrics
+{
+  double mse{};
+  double psnr{};
+  double ssim{};
+};
+
+constexpr double MaxPSNR = 999.99;
+
+// The metrics of all components in the order Y, U, V. For 4:0:0 formats, there is only Y.
+struct FrameMetrics
+{
+  std::vector<ComponentMetrics> components;
+};
+
+// Calculate the metrics of a frame compared to a reference frame. Both must be in a planar YUV
+// format with the same subsampling and bit depth (the order of the planes may differ). The frame
+// buffers can be packed or point to strided planes. Returns nothing if the frames can not be
+// compared.
+std::optional<FrameMetrics> calculateFrameMetrics(const FrameBuffer &        frame,
+                                                  const yuv::PixelFormatYUV &format,
+                                                  const FrameBuffer &        reference,
+                                                  const yuv::PixelFormatYUV &referenceFormat,
+                                                  const Size &               frameSize);
+
+} // namespace video
@@ -0,0 +1,139 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FramePrefetch.h"
+
+#include <algorithm>
+
+namespace video
+{
+
+std::vector<int> getPrefetchOrder(indexRange                range,
+                                  const FrameAccessPattern &pattern,
+                                  const std::vector<int> &  randomAccessPoints)
+{
+  std::vector<int> order;
+  if (range.first < 0 || range.second < range.first)
+    return order;
+
+  const auto nrFrames = size_t(range.second - range.first + 1);
+  order.reserve(nrFrames);
+  std::vector<bool> added(nrFrames, false);
+
+  auto addFrame = [&](int frame) {
+    const auto idx = size_t(frame - range.first);
+    if (!added[idx])
+    {
+      added[idx] = true;
+      order.push_back(frame);
+    }
+  };
+
+  auto addForward = [&](int first, int last, int step) {
+    for (int frame = first; frame <= last; frame += step)
+      addFrame(frame);
+  };
+
+  // Add every step-th frame from last down to first
+  auto addBackward = [&](int first, int last, int step) {
+    if (randomAccessPoints.empty())
+    {
+      for (int frame = last; frame >= first; frame -= step)
+        addFrame(frame);
+      return;
+    }
+
+    // Go back one random access point at a time and add the frames after it in decoding order
+    auto chunkEnd = last;
+    while (chunkEnd >= first)
+    {
+      auto it = std::upper_bound(randomAccessPoints.begin(), randomAccessPoints.end(), chunkEnd);
+      auto chunkStart = (it == randomAccessPoints.begin()) ? first : std::max(first, *(--it));
+      for (int frame = chunkStart; frame <= chunkEnd; frame++)
+        if ((last - frame) % step == 0)
+          addFrame(frame);
+      chunkEnd = chunkStart - 1;
+    }
+  };
+
+  const auto currentFrame =
+      (pattern.currentFrame < 0) ? range.first
+                                 : std::clamp(pattern.currentFrame, range.first, range.second);
+  const auto step = (pattern.step == 0) ? 1 : pattern.step;
+
+  if (step > 0)
+  {
+    // The frames that will be requested next, then the frames in between
+    addForward(currentFrame, range.second, step);
+    addForward(currentFrame, range.second, 1);
+    if (pattern.loop)
+      addForward(range.first, currentFrame - 1, 1);
+    else
+      addBackward(range.first, currentFrame - 1, 1);
+  }
+  else
+  {
+    addBackward(range.first, currentFrame, -step);
+    addBackward(range.first, currentFrame, 1);
+    addForward(currentFrame + 1, range.second, 1);
+  }
+
+  return order;
+}
+
+int getRandomAccessSegment(int frame, const std::vector<int> &randomAccessPoints)
+{
+  auto it = std::upper_bound(randomAccessPoints.begin(), randomAccessPoints.end(), frame);
+  if (it == randomAccessPoints.begin())
+    return 0;
+  return int(it - randomAccessPoints.begin()) - 1;
+}
+
+std::vector<indexRange> splitAtRandomAccessPoints(indexRange              range,
+                                                  const std::vector<int> &randomAccessPoints)
+{
+  std::vector<indexRange> segments;
+  if (range.second < range.first)
+    return segments;
+
+  auto first = range.first;
+  auto it    = std::upper_bound(randomAccessPoints.begin(), randomAccessPoints.end(), first);
+  for (; it != randomAccessPoints.end() && *it <= range.second; it++)
+  {
+    segments.push_back(indexRange(first, *it - 1));
+    first = *it;
+  }
+  segments.push_back(indexRange(first, range.second));
+  return segments;
+}
+
+} // namespace video
@@ -0,0 +1,71 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <common/Typedef.h>
+
+#include <vector>
+
+namespace video
+{
+
+// The way in which the frames of the selected item are currently requested
+struct FrameAccessPattern
+{
+  int currentFrame{-1};
+  // The distance from one requested frame to the next. This is negative when going backwards.
+  int step{1};
+  // After the last frame of the item, playback continues with the first frame (repeat one)
+  bool loop{false};
+};
+
+// Get all frames of the range in the order in which they should be cached so that the frames that
+// will be requested next (according to the access pattern) are cached first.
+// randomAccessPoints is the sorted list of frames where decoding can start. If it is empty, all
+// frames can be accessed directly. Otherwise, frames that are cached while going backwards are
+// returned in chunks from one random access point to the next so that the decoder only has to
+// seek once per chunk.
+std::vector<int> getPrefetchOrder(indexRange                range,
+                                  const FrameAccessPattern &pattern,
+                                  const std::vector<int> &  randomAccessPoints);
+
+// Get the index of the segment that the frame is in. A segment starts at a random access point and
+// ends before the next one. Frames before the first random access point are in segment 0.
+int getRandomAccessSegment(int frame, const std::vector<int> &randomAccessPoints);
+
+// Split the range into one range per segment (see getRandomAccessSegment). The segments can be
+// decoded independently of each other.
+std::vector<indexRange> splitAtRandomAccessPoints(indexRange              range,
+                                                  const std::vector<int> &randomAccessPoints);
+
+} // namespace video
@@ -36,12 +36,18 @@
 #include <QPainter>
 #include <QScrollArea>
 #include <QSettings>
-#include <QThread>
+#include <QStandardPaths>
 #include <algorithm>
+#include <cstdlib>
 
 #include <common/Functions.h>
 #include <playlistitem/playlistItem.h>
 #include <ui/playbackController.h>
+#include <video/BufferPool.h>
+#include <video/CompressedFrameCache.h>
+#include <video/DiskFrameCache.h>
+#include <video/FrameCache.h>
+#include <video/FramePrefetch.h>
 
 namespace video
 {
@@ -65,156 +71,6 @@ namespace video
 #define DEBUG_CACHING_DETAIL(fmt, ...) ((void)0)
 #endif
 
-#define CACHING_THREAD_JOBS_OUTPUT 0
-#if CACHING_THREAD_JOBS_OUTPUT && !NDEBUG
-#include <QDebug>
-#define DEBUG_JOBS qDebug
-#else
-#define DEBUG_JOBS(fmt, ...) ((void)0)
-#endif
-
-/// ------------------------ loadingWorker ------------------------
-
-class loadingWorker : public QObject
-{
-  Q_OBJECT
-public:
-  loadingWorker(QObject *parent) : QObject(parent)
-  {
-    currentCacheItem = nullptr;
-    working          = false;
-    id               = id_counter++;
-  }
-  playlistItem *getCacheItem() { return currentCacheItem; }
-  int           getCacheFrame() { return currentFrame; }
-  void          setJob(playlistItem *item, int frame, bool test = false);
-  void          setWorking(bool state) { working = state; }
-  bool          isWorking() { return working; }
-  QString       getStatus()
-  {
-    return QString("T%1: %2").arg(id).arg(working ? QString::number(currentFrame) : QString("-"));
-  }
-  // Process the job in the thread that this worker was moved to. This function can be directly
-  // called from the main thread. It will still process the call in the separate thread.
-  void processCacheJob();
-  void processLoadingJob(bool playing, bool loadRawData);
-signals:
-  void loadingFinished();
-private slots:
-  void processCacheJobInternal();
-  void processLoadingJobInternal(bool playing, bool loadRawData);
-
-private:
-  playlistItem *currentCacheItem;
-  int           currentFrame;
-  bool          working;
-  bool          testMode;
-  int           id; // A static ID of the thread. Only used in getStatus().
-  static int    id_counter;
-};
-// Initially this is 0. The threads will number themselves so that there are never two threads with
-// the same id
-int loadingWorker::id_counter = 0;
-
-void loadingWorker::setJob(playlistItem *item, int frame, bool test)
-{
-  Q_ASSERT_X(item != nullptr, Q_FUNC_INFO, "Given item is nullptr");
-  Q_ASSERT_X(frame >= 0 || !item->properties().isIndexedByFrame(),
-             Q_FUNC_INFO,
-             "Given frame index invalid");
-  currentCacheItem = item;
-  currentFrame     = frame;
-  testMode         = test;
-}
-
-void loadingWorker::processCacheJob()
-{
-  DEBUG_JOBS("loadingWorker::processCacheJob invoke processCacheJobInternal");
-  QMetaObject::invokeMethod(this, "processCacheJobInternal");
-}
-
-void loadingWorker::processLoadingJob(bool playing, bool loadRawData)
-{
-  DEBUG_JOBS("loadingWorker::processLoadingJob invoke processLoadingJobInternal");
-  QMetaObject::invokeMethod(
-      this, "processLoadingJobInternal", Q_ARG(bool, playing), Q_ARG(bool, loadRawData));
-}
-
-void loadingWorker::processCacheJobInternal()
-{
-  Q_ASSERT_X(currentCacheItem != nullptr, Q_FUNC_INFO, "Invalid Job - Item is nullptr");
-  Q_ASSERT_X(currentFrame >= 0 || !currentCacheItem->properties().isIndexedByFrame(),
-             Q_FUNC_INFO,
-             "Given frame index invalid");
-  DEBUG_JOBS("loadingWorker::processCacheJobInternal");
-
-  // Just cache the frame that was given to us.
-  // This is performed in the thread that this worker is currently placed in.
-  currentCacheItem->cacheFrame(currentFrame, testMode);
-
-  currentCacheItem = nullptr;
-  DEBUG_JOBS("loadingWorker::processCacheJobInternal emit loadingFinished");
-  emit loadingFinished();
-}
-
-void loadingWorker::processLoadingJobInternal(bool playing, bool loadRawData)
-{
-  Q_ASSERT_X(currentCacheItem != nullptr, Q_FUNC_INFO, "The set job is nullptr");
-  Q_ASSERT_X((!currentCacheItem->properties().isIndexedByFrame() || currentFrame >= 0),
-             Q_FUNC_INFO,
-             "The set frame index is invalid");
-  Q_ASSERT_X(
-      !currentCacheItem->taggedForDeletion(), Q_FUNC_INFO, "The set job was tagged for deletion");
-  DEBUG_JOBS(Q_FUNC_INFO);
-
-  // Load the frame of the item that was given to us.
-  // This is performed in the thread (the loading thread with higher priority.
-  currentCacheItem->loadFrame(currentFrame, playing, loadRawData);
-
-  currentCacheItem = nullptr;
-  emit loadingFinished();
-  DEBUG_JOBS("loadingWorker::processLoadingJobInternal emit loadingFinished");
-}
-
-/// -------------------------- VideoCache::loadingThread --------------------
-
-class VideoCache::loadingThread : public QThread
-{
-  Q_OBJECT
-public:
-  loadingThread(QObject *parent) : QThread(parent)
-  {
-    // Create a new worker and move it to this thread
-    threadWorker.reset(new loadingWorker(nullptr));
-    threadWorker->moveToThread(this);
-    quitting = false;
-  }
-  void quitWhenDone()
-  {
-    quitting = true;
-    if (threadWorker->isWorking())
-    {
-      // We must wait until the worker is done.
-      DEBUG_CACHING("loadingThread::quitWhenDone waiting for worker to finish...");
-      connect(worker(), &loadingWorker::loadingFinished, this, [=] {
-        DEBUG_CACHING("loadingThread::quitWhenDone worker done -> quit");
-        quit();
-      });
-    }
-    else
-    {
-      DEBUG_CACHING("loadingThread::quitWhenDone quit now");
-      quit();
-    }
-  }
-  loadingWorker *worker() { return threadWorker.data(); }
-  bool           isQuitting() { return quitting; }
-
-private:
-  QScopedPointer<loadingWorker> threadWorker;
-  bool quitting; // Are er quitting the job? If yes, do not push new jobs to it.
-};
-
 /// ---------------------------------- VideoCache ------------------------------
 
 VideoCache::VideoCache(PlaylistTreeWidget *playlistTreeWidget,
@@ -228,22 +84,7 @@ VideoCache::VideoCache(PlaylistTreeWidget *playlistTreeWidget,
   splitView    = view;
   parentWidget = parent;
 
-  // Create the interactive threads
-  for (int i = 0; i < 2; i++)
-  {
-    interactiveThread[i] = new loadingThread(this);
-    interactiveThread[i]->start(QThread::HighPriority);
-    connect(interactiveThread[i]->worker(),
-            &loadingWorker::loadingFinished,
-            this,
-            &VideoCache::interactiveLoaderFinished);
-
-    // Clear the slots for queued jobs
-    interactiveItemQueued[i]     = nullptr;
-    interactiveItemQueued_Idx[i] = -1;
-  }
-
-  // Update some values from the QSettings. This will also create the correct number of threads.
+  // Update some values from the QSettings. This will also set the correct number of threads.
   updateSettings();
 
   connect(playlist.data(),
@@ -264,63 +105,25 @@ VideoCache::VideoCache(PlaylistTreeWidget *playlistTreeWidget,
           &PlaybackController::signalPlaybackStarting,
           this,
           &VideoCache::updateCacheQueue);
+  connect(playback.data(),
+          &PlaybackController::signalFrameAccessPatternChanged,
+          this,
+          &VideoCache::scheduleCachingListUpdate);
+  connect(playback.data(),
+          &PlaybackController::signalFrameRangeChanged,
+          this,
+          &VideoCache::scheduleCachingListUpdate);
   connect(&statusUpdateTimer, &QTimer::timeout, this, [=] { emit updateCacheStatus(); });
   connect(&testProgrssUpdateTimer, &QTimer::timeout, this, [=] { updateTestProgress(); });
 }
 
 VideoCache::~VideoCache()
 {
-  DEBUG_CACHING("VideoCache::~VideoCache Terminate all workers and threads");
-
-  // Tell all threads to quit
-  for (loadingThread *t : cachingThreadList)
-    t->quitWhenDone();
-  interactiveThread[0]->quitWhenDone();
-  interactiveThread[1]->quitWhenDone();
-
-  // Wait for the threads to quit, otherwise terminate them
-  for (int i = 0; i < 2; i++)
-    if (!interactiveThread[i]->wait(3000))
-    {
-      interactiveThread[i]->terminate();
-      interactiveThread[i]->wait();
-    }
-  for (loadingThread *t : cachingThreadList)
-    if (!t->wait(3000))
-    {
-      t->terminate();
-      t->wait();
-    }
-
-  // Delete all threads
-  for (loadingThread *t : cachingThreadList)
-    t->deleteLater();
-}
-
-void VideoCache::startWorkerThreads(int nrThreads)
-{
-  for (int i = 0; i < nrThreads; i++)
-  {
-    loadingThread *newThread = new loadingThread(this);
-    cachingThreadList.append(newThread);
-
-    // Caching should run in the background without interrupting normal operation. Start with lowest
-    // priority.
-    newThread->start(QThread::LowestPriority);
-
-    // Connect the signals/slots to communicate with the cacheWorker.
-    connect(newThread->worker(),
-            &loadingWorker::loadingFinished,
-            this,
-            &VideoCache::threadCachingFinished);
+  DEBUG_CACHING("VideoCache::~VideoCache Cancel all tasks and wait for them");
 
-    DEBUG_CACHING("VideoCache::startWorkerThreads Started thread %p", newThread);
-
-    if (workersState == workersRunning)
-      // Push the next job to the worker. Otherwise it will not start working if caching is
-      // currently running.
-      pushNextJobToCachingThread(newThread);
-  }
+  // Running tasks finish their current frame. All queued tasks return immediately.
+  scheduler.cancelAll();
+  scheduler.waitForAll();
 }
 
 void VideoCache::updateSettings()
@@ -332,6 +135,23 @@ void VideoCache::updateSettings()
   settings.beginGroup("VideoCache");
   cachingEnabled = settings.value("Enabled", true).toBool();
   cacheLevelMax  = (int64_t)settings.value("ThresholdValueMB", 49).toUInt() * 1000 * 1000;
+  // The frames to cache and to remove are selected in updateCacheQueue. This can overshoot the
+  // limit by a frame, so the limit of the frame cache is only a safety net against wrong sizes.
+  getFrameCache().setMaxSize(cacheLevelMax * 2);
+
+  // Memory for the compressed raw frame data (0 disables the compressed cache)
+  const auto compressedCacheMax =
+      (int64_t)settings.value("CompressedCacheMB", 0).toUInt() * 1000 * 1000;
+  getCompressedFrameCache().setMaxSize(cachingEnabled ? compressedCacheMax : 0);
+
+  // Decoded frames can be saved in a cache directory on disk
+  int64_t diskCacheMax = 0;
+  if (settings.value("DiskCacheEnabled", false).toBool())
+    diskCacheMax = (int64_t)settings.value("DiskCacheMB", 10000).toUInt() * 1000 * 1000;
+  const auto defaultDiskCacheDirectory =
+      QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/frames";
+  getDiskFrameCache().setCacheDirectory(
+      settings.value("DiskCacheDirectory", defaultDiskCacheDirectory).toString(), diskCacheMax);
 
   // See if the user changed the number of threads
   int targetNrThreads = functions::getOptimalThreadCount();
@@ -348,37 +168,9 @@ void VideoCache::updateSettings()
   else
     nrThreadsPlayback = 0;
 
-  if (targetNrThreads > cachingThreadList.count())
-    // Create new threads
-    startWorkerThreads(targetNrThreads - cachingThreadList.count());
-  else if (targetNrThreads < cachingThreadList.count())
-  {
-    // Remove threads. We can only delete workers (and their threads) that are currently not
-    // working.
-    int nrThreadsToRemove = cachingThreadList.count() - targetNrThreads;
-
-    for (int i = cachingThreadList.count() - 1; i >= 0 && nrThreadsToRemove > 0; i--)
-    {
-      if (!cachingThreadList[i]->worker()->isWorking())
-      {
-        // Not working -> delete it now
-        QThread *t = cachingThreadList.takeAt(i);
-        t->exit();
-        t->deleteLater();
-
-        DEBUG_CACHING("VideoCache::updateSettings Deleting thread %p with worker %d", t, i);
-        nrThreadsToRemove--;
-      }
-    }
-
-    if (nrThreadsToRemove > 0)
-    {
-      // We need to remove more threads but the workers in these threads are still running. Do this
-      // when the workers finish.
-      DEBUG_CACHING("VideoCache::updateSettings Deleting %d threads later", nrThreadsToRemove);
-      deleteNrThreads = nrThreadsToRemove;
-    }
-  }
+  // Threads that are removed finish their current task first
+  nrThreads = targetNrThreads;
+  scheduler.setNrThreads(nrThreads);
 
   // Also update the cache status and schedule an update of the caching.
   emit updateCacheStatus();
@@ -395,124 +187,87 @@ void VideoCache::loadFrame(playlistItem *item, int frameIndex, int loadingSlot)
     return;
 
   assert(loadingSlot == 0 || loadingSlot == 1);
-  if (interactiveThread[loadingSlot]->worker()->isWorking())
+  auto &slot = interactiveSlots[loadingSlot];
+  if (slot.working)
   {
-    // The interactive worker is currently busy ...
-    if (interactiveThread[loadingSlot]->worker()->getCacheItem() != item ||
-        interactiveThread[loadingSlot]->worker()->getCacheFrame() != frameIndex)
+    // The interactive slot is currently busy ...
+    if (slot.item != item || slot.frame != frameIndex)
     {
       // ... and it is not working on the requested frame. Schedule this load request as the next
       // one.
       DEBUG_CACHING_DETAIL(
           "VideoCache::loadFrame %d queued for later - slot %d", frameIndex, loadingSlot);
-      interactiveItemQueued[loadingSlot]     = item;
-      interactiveItemQueued_Idx[loadingSlot] = frameIndex;
+      slot.queuedItem  = item;
+      slot.queuedFrame = frameIndex;
     }
   }
   else
   {
-    // Let the interactive worker work...
-    bool loadRawData = splitView->showRawData() && !playback->playing();
-    interactiveThread[loadingSlot]->worker()->setJob(item, frameIndex);
-    interactiveThread[loadingSlot]->worker()->setWorking(true);
-    interactiveThread[loadingSlot]->worker()->processLoadingJob(playback->playing(), loadRawData);
+    submitInteractiveTask(loadingSlot, item, frameIndex);
     DEBUG_CACHING_DETAIL("VideoCache::loadFrame %d started - slot %d", frameIndex, loadingSlot);
 
     emit updateCacheStatus();
   }
 }
 
-void VideoCache::interactiveLoaderFinished()
+void VideoCache::submitInteractiveTask(int loadingSlot, playlistItem *item, int frameIndex)
 {
-  // Get the thread that caused this call
-  QObject *      sender   = QObject::sender();
-  loadingWorker *worker   = dynamic_cast<loadingWorker *>(sender);
-  int            threadID = (interactiveThread[0]->worker() == worker) ? 0 : 1;
-  assert(worker == interactiveThread[0]->worker() || worker == interactiveThread[1]->worker());
-
-  // Check the list of items that are scheduled for deletion. Because a loading thread finished,
-  // maybe now we can delete the item(s).
-  for (auto it = itemsToDelete.begin(); it != itemsToDelete.end();)
-  {
-    // Is the item still being cached?
-    bool itemCaching = false;
-    for (loadingThread *t : cachingThreadList)
-      if (t->worker()->getCacheItem() == *it)
-      {
-        itemCaching = true;
-        break;
-      }
-    // Is the item still being loaded?
-    bool loadingItem = (interactiveThread[0]->worker()->getCacheItem() == *it ||
-                        interactiveThread[1]->worker()->getCacheItem() == *it);
+  auto &slot   = interactiveSlots[loadingSlot];
+  slot.item    = item;
+  slot.frame   = frameIndex;
+  slot.working = true;
+
+  const bool playing     = playback->playing();
+  const bool loadRawData = splitView->showRawData() && !playing;
+
+  // Interactive tasks have no group. They are never canceled because the user waits for them.
+  scheduler.submit(
+      TaskScheduler::Priority::Interactive,
+      nullptr,
+      [this, item, frameIndex, loadingSlot, playing, loadRawData](
+          const TaskScheduler::CancellationToken &token) {
+        if (!token.isCanceled())
+          item->loadFrame(frameIndex, playing, loadRawData);
+        QMetaObject::invokeMethod(
+            this, "interactiveTaskFinished", Qt::QueuedConnection, Q_ARG(int, loadingSlot));
+      });
+}
 
-    if (!itemCaching && !loadingItem)
-    {
-      // Remove the item from the loading queue (if in there)
-      if (interactiveItemQueued[threadID] == (*it))
-      {
-        interactiveItemQueued[threadID]     = nullptr;
-        interactiveItemQueued_Idx[threadID] = -1;
-      }
-      // Delete the item and remove it from the itemsToDelete list
-      DEBUG_CACHING("VideoCache::interactiveLoaderFinished delete item now %s",
-                    (*it)->getName().toLatin1().data());
-      (*it)->deleteLater();
-      it = itemsToDelete.erase(it);
-    }
-    else
-      ++it;
-  }
+void VideoCache::interactiveTaskFinished(int loadingSlot)
+{
+  auto &slot   = interactiveSlots[loadingSlot];
+  slot.item    = nullptr;
+  slot.frame   = -1;
+  slot.working = false;
 
-  // The worker finished. Is there another loading request in the queue?
-  if (interactiveItemQueued[threadID] != nullptr && interactiveItemQueued_Idx[threadID] >= 0)
+  // Because a loading task finished, maybe now we can delete the item(s).
+  processItemsNoLongerInUse();
+
+  // Is there another loading request in the queue?
+  if (slot.queuedItem != nullptr && slot.queuedFrame >= 0)
   {
-    // Let the interactive worker work on the queued request.
-    bool loadRawData = splitView->showRawData() && !playback->playing();
-    interactiveThread[threadID]->worker()->setJob(interactiveItemQueued[threadID],
-                                                  interactiveItemQueued_Idx[threadID]);
-    interactiveThread[threadID]->worker()->setWorking(true);
-    interactiveThread[threadID]->worker()->processLoadingJob(playback->playing(), loadRawData);
-    DEBUG_CACHING_DETAIL("VideoCache::interactiveLoaderFinished %d started - slot %d",
-                         interactiveItemQueued_Idx[threadID],
-                         threadID);
-
-    // Clear the queue slot
-    interactiveItemQueued[threadID]     = nullptr;
-    interactiveItemQueued_Idx[threadID] = -1;
+    auto item        = slot.queuedItem;
+    auto frame       = slot.queuedFrame;
+    slot.queuedItem  = nullptr;
+    slot.queuedFrame = -1;
+    submitInteractiveTask(loadingSlot, item, frame);
+    DEBUG_CACHING_DETAIL(
+        "VideoCache::interactiveTaskFinished %d started - slot %d", frame, loadingSlot);
   }
-  else
-    // No scheduled job waiting
-    interactiveThread[threadID]->worker()->setWorking(false);
 
   emit updateCacheStatus();
 }
 
 void VideoCache::scheduleCachingListUpdate()
 {
-  // The playlist changed. We have to rethink what to cache next.
-  if (workersState == workersRunning)
-  {
-    // First, the worker has to stop. Request a stop and an update of the queue.
-    workersState = workersIntReqRestart;
-    DEBUG_CACHING("VideoCache::playlistChanged new state %d (workersIntReqRestart)", workersState);
+  // The playlist changed. We have to rethink what to cache next. The running caching tasks are not
+  // interrupted. All following tasks are taken from the new queue.
+  if (!cachingEnabled || testMode)
     return;
-  }
-  else if (workersState == workersIntReqRestart)
-  {
-    // The worker is still running but we already requested an interrupt and an update of the queue.
-    DEBUG_CACHING("VideoCache::playlistChanged new state %d (workersIntReqRestart)", workersState);
-    return;
-  }
 
-  assert(workersState == workersIdle);
-  if (cachingEnabled)
-  {
-    // Update the cache queue and restart the worker.
-    updateCacheQueue();
-    startCaching();
-  }
-  DEBUG_CACHING("VideoCache::playlistChanged new state %d", workersState);
+  DEBUG_CACHING("VideoCache::scheduleCachingListUpdate");
+  updateCacheQueue();
+  startCaching();
 }
 
 void VideoCache::updateCacheQueue()
@@ -584,14 +339,8 @@ void VideoCache::updateCacheQueue()
   int64_t cacheLevel = 0;
   for (playlistItem *item : allItems)
   {
-    indexRange range         = item->properties().startEndRange;
-    QList<int> cached_frames = item->getCachedFrames();
-    for (int i : cached_frames)
-      if (i < range.first || i > range.second)
-        item->removeFrameFromCache(i);
-
-    auto cachingFrameSize = item->getCachingFrameSize();
-    cacheLevel += item->getNumberCachedFrames() * cachingFrameSize;
+    item->removeFramesOutsideOfRange(item->properties().startEndRange);
+    cacheLevel += item->getCacheSizeInBytes();
   }
   if (cacheLevel > cacheLevelMax)
   {
@@ -622,6 +371,9 @@ void VideoCache::updateCacheQueue()
         break;
     } while (cacheLevel >= cacheLevelMax);
   }
+  // The frames that are currently being cached are not in the cache yet but will be soon
+  for (const auto &task : runningCachingTasks)
+    cacheLevel += task.item->getCachingFrameSize();
   // Save the current level of the cache
   cacheLevelCurrent = cacheLevel;
 
@@ -645,6 +397,8 @@ void VideoCache::updateCacheQueue()
     // "deleting" mode where all frames of all items are removed. This is done for all items in the
     // playlist.
     bool adding = true;
+    // The frames of the current item that can be deleted are already in the right order
+    int nrDeQueuedFromCurrentItem = 0;
     do
     {
       if (allItems[i]->properties().isIndexedByFrame())
@@ -659,9 +413,20 @@ void VideoCache::updateCacheQueue()
           if (newCacheLevel + itemCacheSize <= cacheLevelMax)
           {
             // All frames of the item fit and there is even more space. We remain in "adding" mode.
-            enqueueCacheJob(allItems[i], itemRange);
+            if (i == itemPos)
+              enqueuePrefetchJobs(allItems[i], itemRange);
+            else
+              enqueueCacheJob(allItems[i], itemRange);
             newCacheLevel += itemCacheSize;
           }
+          else if (i == itemPos)
+          {
+            // Not all frames of the current item fit. Cache the ones that are played next.
+            int64_t nrFramesCachable = cacheLevelMax / allItems[i]->getCachingFrameSize();
+            enqueuePrefetchJobs(allItems[i], itemRange, nrFramesCachable);
+            nrDeQueuedFromCurrentItem = cacheDeQueue.count();
+            adding                    = false;
+          }
           else
           {
             // Not all frames fit. Enqueue the ones that fit and set the ones that don't as "can be
@@ -701,7 +466,7 @@ void VideoCache::updateCacheQueue()
 
     // Done. However, the list of frames that can be deleted is sorted the wrong way around. Reverse
     // it.
-    std::reverse(cacheDeQueue.begin(), cacheDeQueue.end());
+    std::reverse(cacheDeQueue.begin() + nrDeQueuedFromCurrentItem, cacheDeQueue.end());
   }
   else // playback is not running
   {
@@ -723,11 +488,10 @@ void VideoCache::updateCacheQueue()
         }
       }
 
-      // Adjust the range so that only the number of frames are cached that will fit
+      // Only cache the number of frames that will fit. Start with the frames that will be shown
+      // next.
       int64_t nrFramesCachable = cacheLevelMax / selection[0]->getCachingFrameSize();
-      range.second             = range.first + nrFramesCachable - 1;
-
-      enqueueCacheJob(selection[0], range);
+      enqueuePrefetchJobs(selection[0], range, nrFramesCachable);
     }
     else if (selection[0]->isCachable() &&
              additionalItemSpaceNeeded > (cacheLevelMax - cacheLevel) &&
@@ -764,9 +528,7 @@ void VideoCache::updateCacheQueue()
 
       // Get the cache level without the current item (frames from the current item do not really
       // occupy space in the cache. We want to cache them anyways)
-      int64_t cacheLevelWithoutCurrent =
-          cacheLevel -
-          selection[0]->getNumberCachedFrames() * int64_t(selection[0]->getCachingFrameSize());
+      int64_t cacheLevelWithoutCurrent = cacheLevel - selection[0]->getCacheSizeInBytes();
       while ((itemSpaceNeeded + cacheLevelWithoutCurrent) > cacheLevelMax)
       {
         if (i == itemPos)
@@ -785,9 +547,8 @@ void VideoCache::updateCacheQueue()
         }
 
         // Which frames are cached for the item at position i?
-        QList<int> cachedFrames = allItems[i]->getCachedFrames();
-        int64_t    cachedFramesSize =
-            cachedFrames.count() * int64_t(allItems[i]->getCachingFrameSize());
+        QList<int> cachedFrames     = allItems[i]->getCachedFrames();
+        int64_t    cachedFramesSize = allItems[i]->getCacheSizeInBytes();
 
         if (additionalItemSpaceNeeded < cachedFramesSize)
         {
@@ -833,7 +594,7 @@ void VideoCache::updateCacheQueue()
 
       // Enqueue the job. This is the only job.
       // We will not delete any frames from any other items to cache frames from other items.
-      enqueueCacheJob(selection[0], range);
+      enqueuePrefetchJobs(selection[0], range);
     }
     else
     {
@@ -845,7 +606,7 @@ void VideoCache::updateCacheQueue()
         // items. In case of playback, we will continue with the next items and delete all frames
         // that were already played out. Otherwise, we don't delete any frames from the cache but we
         // will cache as many items as possible.
-        enqueueCacheJob(selection[0], range);
+        enqueuePrefetchJobs(selection[0], range);
         cacheLevel = cacheLevel + additionalItemSpaceNeeded;
       }
 
@@ -918,6 +679,8 @@ void VideoCache::updateCacheQueue()
     }
   }
 
+  this->splitCacheJobsAtRandomAccessPoints();
+
 #if CACHING_DEBUG_OUTPUT && !NDEBUG
   if (!cacheQueue.isEmpty())
   {
@@ -927,7 +690,8 @@ void VideoCache::updateCacheQueue()
       QString itemStr = j.plItem->getName();
       itemStr.append(" - ");
       itemStr.append(QString::number(j.frameRange.first) + "-" +
-                     QString::number(j.frameRange.second));
+                     QString::number(j.frameRange.second) + " step " +
+                     QString::number(j.frameStep) + " segment " + QString::number(j.segment));
       qDebug() << itemStr;
     }
   }
@@ -966,23 +730,121 @@ void VideoCache::enqueueCacheJob(playlistItem *item, indexRange range)
     cacheQueue.append(cacheJob(item, range));
 }
 
+void VideoCache::enqueuePrefetchJobs(playlistItem *item, indexRange range, int64_t maxNrFrames)
+{
+  const auto pattern = playback->getFrameAccessPattern();
+  auto       frames  = getPrefetchOrder(range, pattern, item->getRandomAccessPoints());
+  if (maxNrFrames >= 0 && int64_t(frames.size()) > maxNrFrames)
+    frames.resize(size_t(maxNrFrames));
+
+  // Only schedule frames for caching that were not yet cached. Consecutive frames with the same
+  // distance are combined into one job.
+  const auto cachedFrames = item->getCachedFrames();
+  auto       isCached     = [&cachedFrames](int frame) {
+    return std::binary_search(cachedFrames.begin(), cachedFrames.end(), frame);
+  };
+
+  cacheJob job;
+  int      nrFramesInJob = 0;
+  for (auto frame : frames)
+  {
+    if (isCached(frame))
+      continue;
+
+    if (nrFramesInJob == 1)
+      job.frameStep = frame - job.frameRange.second;
+    if (nrFramesInJob > 0 && frame - job.frameRange.second == job.frameStep)
+    {
+      job.frameRange.second = frame;
+      nrFramesInJob++;
+      continue;
+    }
+
+    if (nrFramesInJob > 0)
+      cacheQueue.append(job);
+    job           = cacheJob(item, indexRange(frame, frame));
+    nrFramesInJob = 1;
+  }
+  if (nrFramesInJob > 0)
+    cacheQueue.append(job);
+
+  if (maxNrFrames < 0)
+    return;
+
+  // The cached frames which are not prefetched can be removed. Remove the frames that are furthest
+  // away from the current frame first.
+  std::sort(frames.begin(), frames.end());
+  QList<int> framesToRemove;
+  for (auto frame : cachedFrames)
+    if (!std::binary_search(frames.begin(), frames.end(), frame))
+      framesToRemove.append(frame);
+  std::sort(framesToRemove.begin(), framesToRemove.end(), [&pattern](int a, int b) {
+    return std::abs(a - pattern.currentFrame) > std::abs(b - pattern.currentFrame);
+  });
+  for (auto frame : framesToRemove)
+    cacheDeQueue.enqueue(plItemFrame(item, frame));
+}
+
+void VideoCache::splitCacheJobsAtRandomAccessPoints()
+{
+  QQueue<cacheJob> splitQueue;
+  for (const auto &job : cacheQueue)
+  {
+    const auto threadLimit = job.plItem.isNull() ? 1 : job.plItem->cachingThreadLimit();
+    if (job.frameStep != 1 || threadLimit == 1)
+    {
+      splitQueue.append(job);
+      continue;
+    }
+    const auto randomAccessPoints = job.plItem->getRandomAccessPoints();
+    if (randomAccessPoints.empty())
+    {
+      splitQueue.append(job);
+      continue;
+    }
+
+    for (const auto &range : splitAtRandomAccessPoints(job.frameRange, randomAccessPoints))
+      splitQueue.append(cacheJob(job.plItem,
+                                 range,
+                                 job.frameStep,
+                                 getRandomAccessSegment(range.first, randomAccessPoints)));
+  }
+  cacheQueue = splitQueue;
+}
+
 void VideoCache::startCaching()
 {
   DEBUG_CACHING("VideoCache::startCaching %s", testMode ? "Test mode" : "");
-  if (cacheQueue.isEmpty() && !testMode)
+
+  // Keep one loading task per thread in flight. The next task is only chosen when a task finished
+  // loading so that the order always follows the current cache queue. If too many loaded frames
+  // wait for their conversion, loading has to wait.
+  const auto maxNrRunningTasks    = getMaxNrRunningCachingTasks();
+  const auto maxNrConvertingTasks = std::max(nrThreads, 1);
+  while (getNrCachingTasks(false) < maxNrRunningTasks &&
+         getNrCachingTasks(true) < maxNrConvertingTasks)
   {
-    // Nothing in the queue to start caching for.
-    workersState = workersIdle;
+    if (!pushNextCachingTask())
+      break;
   }
-  else
-  {
-    // Push a task to all the threads and start them.
-    bool jobStarted = false;
-    for (int i = 0; i < cachingThreadList.count(); i++)
-      jobStarted |= pushNextJobToCachingThread(cachingThreadList[i]);
 
-    workersState = jobStarted ? workersRunning : workersIdle;
+  updateStatusTimer();
+}
+
+int VideoCache::getMaxNrRunningCachingTasks() const
+{
+  if (testMode)
+    return testStarted ? nrThreads : 0;
+
+  // If playback is running and playback is not waiting for a specific item to cache,
+  // obey the restriction on the number of threads to use while playback is running.
+  if (playback->playing() && watchingItem == nullptr)
+  {
+    auto selection = playlist->getSelectedItems();
+    if (selection[0] && selection[0]->properties().isIndexedByFrame())
+      return std::min(nrThreads, nrThreadsPlayback);
   }
+  return nrThreads;
 }
 
 void VideoCache::watchItemForCachingFinished(playlistItem *item)
@@ -1005,147 +867,85 @@ void VideoCache::watchItemForCachingFinished(playlistItem *item)
       playback->itemCachingFinished(watchingItem);
       watchingItem = nullptr;
     }
-    else if (workersState == workersIdle)
+    else
     {
-      // If the caching is currently not running, start it. Otherwise we will wait forever.
+      // While waiting for the item, the thread limit for playback does not apply. Start more tasks.
       DEBUG_CACHING("VideoCache::watchItemForCachingFinished waiting for item. Start caching.");
       startCaching();
     }
   }
 }
 
-// One of the workers is done with it's caching operation. Give it a new task if there is one and we
-// are not breaking the caching process.
-void VideoCache::threadCachingFinished()
+void VideoCache::cachingTaskLoaded(int taskID)
 {
-  // Get the thread that caused this call
-  QObject *      sender = QObject::sender();
-  loadingWorker *worker = dynamic_cast<loadingWorker *>(sender);
-  Q_ASSERT_X(worker->isWorking(), Q_FUNC_INFO, "The worker that just finished was not working?");
-  worker->setWorking(false);
-  DEBUG_CACHING_DETAIL(
-      "VideoCache::threadCachingFinished - state %d - worker %p", workersState, worker);
-
-  // Check if all threads have stopped.
-  bool jobsRunning = false;
-  for (loadingThread *t : cachingThreadList)
-  {
-    DEBUG_CACHING_DETAIL("VideoCache::threadCachingFinished WorkerList - worker %p - working %d",
-                         t,
-                         t->worker()->isWorking());
-    if (t->worker()->isWorking())
-      // A job is still running. Wait.
-      jobsRunning = true;
-  }
+  for (auto &task : runningCachingTasks)
+    if (task.id == taskID)
+    {
+      task.converting = true;
+      break;
+    }
+  DEBUG_CACHING_DETAIL("VideoCache::cachingTaskLoaded - task %d", taskID);
+
+  // The decoder of the segment is free again
+  startCaching();
+}
+
+// One of the caching tasks is done. Start a new task if there is one.
+void VideoCache::cachingTaskFinished(int taskID)
+{
+  for (int i = 0; i < runningCachingTasks.count(); i++)
+    if (runningCachingTasks[i].id == taskID)
+    {
+      runningCachingTasks.removeAt(i);
+      break;
+    }
+  DEBUG_CACHING_DETAIL("VideoCache::cachingTaskFinished - task %d - %d running",
+                       taskID,
+                       runningCachingTasks.count());
 
   if (testMode)
   {
-    if (workersState == workersIntReqRestart)
+    if (!testStarted)
     {
       // The test has not started yet. We are waiting for the normal caching to finish first.
-      if (!jobsRunning)
+      if (runningCachingTasks.isEmpty())
       {
-        DEBUG_CACHING("VideoCache::threadCachingFinished Start test now");
+        DEBUG_CACHING("VideoCache::cachingTaskFinished Start test now");
+        testStarted = true;
         testDuration.start();
         startCaching();
       }
     }
-    else if (testLoopCount < 0 || workersState == workersIntReqStop)
+    else if (testLoopCount <= 0 || testCanceled)
     {
-      // The test is over or was canceled.
-      // We are not going to start any new threads. Wait for the remaining threads to finish.
-      if (jobsRunning)
-        DEBUG_CACHING("VideoCache::threadCachingFinished Test over - Waiting for jobs to finish");
-      else
+      // The test is over or was canceled. Wait for the remaining tasks to finish.
+      if (runningCachingTasks.isEmpty())
       {
         // Report the results of the test
-        DEBUG_CACHING("VideoCache::threadCachingFinished Test over - All jobs finished");
+        DEBUG_CACHING("VideoCache::cachingTaskFinished Test over - All jobs finished");
         testFinished();
         // Restart normal caching
-        updateCacheQueue();
-        startCaching();
+        scheduleCachingListUpdate();
       }
     }
-    else if (workersState == workersRunning)
-    {
-      // The caching performance test is running. Just push another test job.
-      DEBUG_CACHING_DETAIL("VideoCache::threadCachingFinished Test mode - start next job");
-      for (loadingThread *t : cachingThreadList)
-        if (t->worker() == worker)
-          jobsRunning |= pushNextJobToCachingThread(t);
-    }
+    else
+      startCaching();
     return;
   }
 
-  // Check the list of items that are scheduled for deletion. Because a thread finished, maybe now
-  // we can delete the item(s).
-  bool itemDeleted = false;
-  for (auto it = itemsToDelete.begin(); it != itemsToDelete.end();)
+  // Because a task finished, maybe now we can delete or clear the item(s). If the cache of an item
+  // was cleared, the frames have to be cached again.
+  if (processItemsNoLongerInUse())
   {
-    // Is the item still being cached?
-    bool itemCaching = false;
-    for (loadingThread *t : cachingThreadList)
-      if (t->worker()->getCacheItem() == *it)
-      {
-        itemCaching = true;
-        break;
-      }
-    // Is the item still being loaded?
-    bool loadingItem = (interactiveThread[0]->worker()->getCacheItem() == *it ||
-                        interactiveThread[1]->worker()->getCacheItem() == *it);
-
-    if (!itemCaching && !loadingItem)
-    {
-      // Remove the item from the loading queue (if in there)
-      if (interactiveItemQueued[0] == (*it))
-      {
-        interactiveItemQueued[0]     = nullptr;
-        interactiveItemQueued_Idx[0] = -1;
-      }
-      if (interactiveItemQueued[1] == (*it))
-      {
-        interactiveItemQueued[1]     = nullptr;
-        interactiveItemQueued_Idx[1] = -1;
-      }
-      // Delete the item and remove it from the itemsToDelete list
-      DEBUG_CACHING("VideoCache::threadCachingFinished delete item now %s",
-                    (*it)->getName().toLatin1().data());
-      (*it)->deleteLater();
-      it          = itemsToDelete.erase(it);
-      itemDeleted = true;
-    }
-    else
-      ++it;
-  }
-  if (itemDeleted)
     emit updateCacheStatus();
-
-  // Do the same thing for the items which need to clear their cache
-  for (auto it = itemsToClearCache.begin(); it != itemsToClearCache.end();)
-  {
-    bool itemCaching = false;
-    for (loadingThread *t : cachingThreadList)
-      if (t->worker()->getCacheItem() == *it)
-      {
-        itemCaching = true;
-        break;
-      }
-
-    if (!itemCaching)
-    {
-      // No job is caching the item anymore. Clear the cache now.
-      (*it)->removeAllFramesFromCache();
-      it = itemsToClearCache.erase(it);
-    }
-    else
-      ++it;
+    scheduleCachingListUpdate();
   }
 
   if (watchingItem)
   {
     // See if there is more to be done for the item we are waiting for. If not, signal that caching
     // of the item is done.
-    bool waitOver = true;
+    bool waitOver = !isCachingTaskRunning(watchingItem);
     for (auto j : cacheQueue)
     {
       if (j.plItem == watchingItem)
@@ -1156,72 +956,144 @@ void VideoCache::threadCachingFinished()
     }
     if (waitOver)
     {
-      DEBUG_CACHING_DETAIL("VideoCache::threadCachingFinished caching of requested item done");
+      DEBUG_CACHING_DETAIL("VideoCache::cachingTaskFinished caching of requested item done");
       playback->itemCachingFinished(watchingItem);
       watchingItem = nullptr;
     }
   }
 
-  // Also check if the worker is in the cachingWorkerList. If not, do not push a new job to it.
-  if (deleteNrThreads > 0)
-  {
-    // We need to delete some threads. So this one has to go.
-    int idx = -1;
-    for (int i = 0; i < cachingThreadList.count(); i++)
-      if (cachingThreadList[i]->worker() == worker)
-        idx = i;
-    Q_ASSERT_X(
-        idx >= 0, Q_FUNC_INFO, "The thread that just finished was not found in the thread list.");
-    loadingThread *t = cachingThreadList.takeAt(idx);
-    t->exit();
-    t->deleteLater();
-
-    DEBUG_CACHING_DETAIL("VideoCache::threadCachingFinished Deleting thread %p", t);
-    deleteNrThreads--;
-  }
-  else if (workersState == workersRunning)
+  startCaching();
+  emit updateCacheStatus();
+}
+
+bool VideoCache::isCachingTaskRunning(playlistItem *item, int frame) const
+{
+  for (const auto &task : runningCachingTasks)
+    if (task.item == item && (frame == -1 || task.frame == frame))
+      return true;
+  return false;
+}
+
+bool VideoCache::isCachingSegmentRunning(playlistItem *item, int segment) const
+{
+  for (const auto &task : runningCachingTasks)
+    if (task.item == item && task.segment == segment && !task.converting)
+      return true;
+  return false;
+}
+
+int VideoCache::getNrCachingTasks(bool converting) const
+{
+  int nrTasks = 0;
+  for (const auto &task : runningCachingTasks)
+    if (task.converting == converting)
+      nrTasks++;
+  return nrTasks;
+}
+
+bool VideoCache::processItemsNoLongerInUse()
+{
+  bool itemProcessed = false;
+  for (auto it = itemsToDelete.begin(); it != itemsToDelete.end();)
   {
-    // Get the thread of the worker and push the next cache job to it
-    for (loadingThread *t : cachingThreadList)
-      if (t->worker() == worker)
-        jobsRunning |= pushNextJobToCachingThread(t);
+    // Is the item still being cached or loaded?
+    const auto item        = *it;
+    const auto loadingItem = (interactiveSlots[0].item == item || interactiveSlots[1].item == item);
+    if (!isCachingTaskRunning(item) && !loadingItem)
+    {
+      // Delete the item and remove it from the itemsToDelete list
+      DEBUG_CACHING("VideoCache::processItemsNoLongerInUse delete item now %s",
+                    item->getName().toLatin1().data());
+      item->deleteLater();
+      it            = itemsToDelete.erase(it);
+      itemProcessed = true;
+    }
+    else
+      ++it;
   }
 
-  if (!jobsRunning)
+  // Do the same thing for the items which need to clear their cache
+  for (auto it = itemsToClearCache.begin(); it != itemsToClearCache.end();)
   {
-    // All jobs are done
-    DEBUG_CACHING("VideoCache::threadCachingFinished - All jobs done");
-    if (workersState == workersIntReqStop || workersState == workersRunning)
-      workersState = workersIdle;
-    else if (workersState == workersIntReqRestart)
+    if (!isCachingTaskRunning(*it))
     {
-      updateCacheQueue();
-      startCaching();
+      // No task is caching the item anymore. Clear the cache now.
+      (*it)->removeAllFramesFromCache();
+      it            = itemsToClearCache.erase(it);
+      itemProcessed = true;
     }
+    else
+      ++it;
   }
+  return itemProcessed;
+}
 
+void VideoCache::updateStatusTimer()
+{
   // Start/stop the timer that will update the caching status widget and the debug stuff
-  if (statusUpdateTimer.isActive() && workersState == workersIdle)
+  if (statusUpdateTimer.isActive() && runningCachingTasks.isEmpty())
+  {
     // Stop the timer and update one last time
     statusUpdateTimer.stop();
-  else if (!statusUpdateTimer.isActive() && workersState != workersIdle)
+    emit updateCacheStatus();
+  }
+  else if (!statusUpdateTimer.isActive() && !runningCachingTasks.isEmpty())
     // The timer is not started yet, but it should be.
     // Update now and start the timer to trigger future updates.
     statusUpdateTimer.start(100);
+}
 
-  emit updateCacheStatus();
+void VideoCache::submitCachingTask(playlistItem *          item,
+                                   int                     frame,
+                                   TaskScheduler::Priority priority,
+                                   int                     segment)
+{
+  Q_ASSERT_X(item != nullptr, Q_FUNC_INFO, "Given item is nullptr");
+  Q_ASSERT_X(frame >= 0 || !item->properties().isIndexedByFrame(),
+             Q_FUNC_INFO,
+             "Given frame index invalid");
 
-  DEBUG_CACHING_DETAIL("VideoCache::threadCachingFinished - new state %d", workersState);
+  const auto id   = nextCachingTaskID++;
+  const auto test = testMode;
+  runningCachingTasks.append(CachingTask{id, item, frame, segment});
+
+  // The item is the group of the task. All tasks of an item can be canceled at once.
+  scheduler.submit(
+      priority,
+      item,
+      [this, item, frame, id, test, priority](const TaskScheduler::CancellationToken &token) {
+        std::function<void()> convertFrame;
+        if (!token.isCanceled())
+          convertFrame = item->cacheFrame(frame, test);
+        if (!convertFrame || token.isCanceled())
+        {
+          QMetaObject::invokeMethod(
+              this, "cachingTaskFinished", Qt::QueuedConnection, Q_ARG(int, id));
+          return;
+        }
+
+        // Convert the frame in a second task (of the same group) so that the next frame can be
+        // loaded in the meantime. The task is queued at this worker. Idle workers steal it.
+        QMetaObject::invokeMethod(this, "cachingTaskLoaded", Qt::QueuedConnection, Q_ARG(int, id));
+        scheduler.submit(
+            priority,
+            item,
+            [this, id, convertFrame](const TaskScheduler::CancellationToken &token) {
+              if (!token.isCanceled())
+                convertFrame();
+              QMetaObject::invokeMethod(
+                  this, "cachingTaskFinished", Qt::QueuedConnection, Q_ARG(int, id));
+            });
+      });
 }
 
-bool VideoCache::pushNextJobToCachingThread(loadingThread *thread)
+bool VideoCache::pushNextCachingTask()
 {
-  if ((cacheQueue.isEmpty() && !testMode) || thread->isQuitting())
-    // No more jobs in the cache queue or the thread does not accept new jobs.
-    return false;
-
   if (testMode)
   {
+    if (testLoopCount <= 0 || testCanceled)
+      return false;
+
     Q_ASSERT_X(testItem, Q_FUNC_INFO, "Test item invalid");
     auto range   = testItem->properties().startEndRange;
     int  frameNr = clip((1000 - testLoopCount) % (range.second - range.first) + range.first,
@@ -1229,111 +1101,89 @@ bool VideoCache::pushNextJobToCachingThread(loadingThread *thread)
                        range.second);
     if (frameNr < 0)
       frameNr = 0;
-    thread->worker()->setJob(testItem, frameNr, true);
-    thread->worker()->setWorking(true);
-    thread->worker()->processCacheJob();
-    DEBUG_CACHING_DETAIL("VideoCache::pushNextJobToCachingThread - %d of %s",
+    submitCachingTask(testItem, frameNr, TaskScheduler::Priority::Background);
+    DEBUG_CACHING_DETAIL("VideoCache::pushNextCachingTask - %d of %s",
                          frameNr,
                          testItem->getName().toStdString().c_str());
     testLoopCount--;
     return true;
   }
 
-  // If playback is running and playback is not waiting for a specific item to cache,
-  // only start caching of a new job if caching is enabled while playback is running.
-  if (playback->playing() && watchingItem == nullptr)
-  {
-    auto selection = playlist->getSelectedItems();
-    if (selection[0] && selection[0]->properties().isIndexedByFrame())
-    {
-      // Playback is running and the item that is currently being shown is indexed by frame.
-      // In this case, obey the restriction on nr threads while playback is running.
-
-      if (nrThreadsPlayback == 0)
-      {
-        // No caching while playback is running
-        DEBUG_CACHING_DETAIL(
-            "VideoCache::pushNextJobToCachingThread no new job started nrThreadsPlayback=0");
-        return false;
-      }
-
-      // Check if there is a limit on the number of threads to use while playback is running.
-      int threadsWorking = 0;
-      for (loadingThread *t : cachingThreadList)
-      {
-        if (t->worker()->isWorking())
-          threadsWorking++;
-      }
-
-      if (nrThreadsPlayback <= threadsWorking)
-      {
-        // The maximum number (or more) of threads are already working.
-        // Do not start another one.
-        DEBUG_CACHING_DETAIL("VideoCache::pushNextJobToCachingThread no new job started "
-                             "nrThreadsPlayback=%d threadsWorking=%d",
-                             nrThreadsPlayback,
-                             threadsWorking);
-        return false;
-      }
-    }
-  }
+  if (cacheQueue.isEmpty())
+    return false;
 
   QMutableListIterator<cacheJob> j(cacheQueue);
-  playlistItem *                 plItem = nullptr;
-  indexRange                     range;
+  playlistItem *                 plItem       = nullptr;
+  int                            frameToCache = -1;
+  int                            segment      = -1;
   while (j.hasNext())
   {
     cacheJob &job = j.next();
-    if (!job.plItem->isCachable())
+    if (job.plItem.isNull() || !job.plItem->isCachable())
       // Remove the item from the list
       j.remove();
+    else if (itemsToClearCache.contains(job.plItem))
+      // The cache of the item is cleared once its running tasks are done. Wait for that.
+      continue;
+    else if (job.segment != -1 && isCachingSegmentRunning(job.plItem, job.segment))
+      // The frames of a segment are cached one after the other by the same decoder. Another
+      // task can work on the next segment in the meantime.
+      continue;
     else
     {
       // We might be able to cache from this item. Check if there is a thread limit for the item.
       int threadLimit = job.plItem->cachingThreadLimit();
       if (threadLimit != -1)
       {
-        // How many threads are currently caching the given item?
-        int nrThreadsForItem = 0;
-        for (loadingThread *t : cachingThreadList)
-          if (t->worker()->isWorking() && t->worker()->getCacheItem() == job.plItem)
-            nrThreadsForItem++;
-        if (nrThreadsForItem >= threadLimit)
-          // Go to the next item. We can not add another thread to this one.
+        // How many tasks are currently loading frames of the given item?
+        int nrTasksForItem = 0;
+        for (const auto &task : runningCachingTasks)
+          if (task.item == job.plItem && !task.converting)
+            nrTasksForItem++;
+        if (nrTasksForItem >= threadLimit)
+          // Go to the next item. We can not add another task for this one.
           continue;
       }
 
-      // We can start another thread for this item
-      plItem = job.plItem;
-      range  = job.frameRange;
+      // We can start another task for this item
+      const auto frame = job.frameRange.first;
 
       // Check if this is the last frame to cache in the item
-      if (range.first == range.second)
+      if (job.frameRange.first == job.frameRange.second)
         j.remove();
       else
         // Update the frame range of the head item in the cache queue
-        job.frameRange.first = range.first + 1;
+        job.frameRange.first += job.frameStep;
 
+      if (isCachingTaskRunning(job.plItem, frame))
+      {
+        // The frame was queued again while it is being cached. Take the next one.
+        j.toFront();
+        continue;
+      }
+
+      plItem       = job.plItem;
+      frameToCache = frame;
+      segment      = job.segment;
       break;
     }
   }
   if (plItem == nullptr)
-    // No item found that we can start another caching thread for.
+    // No item found that we can start another caching task for.
     return false;
 
   // Get the size of one frame in bytes
   unsigned int frameSize = plItem->getCachingFrameSize();
 
-  // We found an item that we can cache. Cache the first frame of it.
-  int frameToCache = range.first;
-
   // First check if we need to free up space to cache this frame.
   while (cacheLevelCurrent + frameSize >= cacheLevelMax && !cacheDeQueue.isEmpty())
   {
-    plItemFrame  frameToRemove     = cacheDeQueue.dequeue();
+    plItemFrame frameToRemove = cacheDeQueue.dequeue();
+    if (frameToRemove.first.isNull())
+      continue;
     unsigned int frameToRemoveSize = frameToRemove.first->getCachingFrameSize();
 
-    DEBUG_CACHING_DETAIL("VideoCache::pushNextJobToCachingThread Remove frame %d of %s",
+    DEBUG_CACHING_DETAIL("VideoCache::pushNextCachingTask Remove frame %d of %s",
                          frameToRemove.second,
                          frameToRemove.first->getName().toStdString().c_str());
     frameToRemove.first->removeFrameFromCache(frameToRemove.second);
@@ -1348,12 +1198,12 @@ bool VideoCache::pushNextJobToCachingThread(loadingThread *thread)
     return false;
   }
 
-  // Push the job to the thread
-  Q_ASSERT_X(plItem != nullptr && frameToCache >= 0, Q_FUNC_INFO, "Invalid job.");
-  thread->worker()->setJob(plItem, frameToCache);
-  thread->worker()->setWorking(true);
-  thread->worker()->processCacheJob();
-  DEBUG_CACHING_DETAIL("VideoCache::pushNextJobToCachingThread - %d of %s",
+  // The frames of the selected item are needed next. Everything else is background work.
+  const auto selection = playlist->getSelectedItems();
+  const auto priority  = (plItem == selection[0]) ? TaskScheduler::Priority::NextFrames
+                                                  : TaskScheduler::Priority::Background;
+  submitCachingTask(plItem, frameToCache, priority, segment);
+  DEBUG_CACHING_DETAIL("VideoCache::pushNextCachingTask - %d of %s",
                        frameToCache,
                        plItem->getName().toStdString().c_str());
 
@@ -1365,45 +1215,34 @@ bool VideoCache::pushNextJobToCachingThread(loadingThread *thread)
 
 void VideoCache::itemAboutToBeDeleted(playlistItem *item)
 {
-  // One of the items is about to be deleted. Let's stop the caching. Then the item can be deleted
-  // and then we can re-think our caching strategy.
-
-  // Are we currently loading a frame from this item in one of the interactive loading threads?
-  bool loadingItem = (interactiveThread[0]->worker()->getCacheItem() == item ||
-                      interactiveThread[1]->worker()->getCacheItem() == item);
-  bool cachingItem = false;
-
-  if (workersState != workersIdle)
-  {
-    // Are we currently caching a frame from this item?
-    for (loadingThread *t : cachingThreadList)
-      if (t->worker()->getCacheItem() == item)
-        cachingItem = true;
-
-    // An item is about to be deleted. We need to rethink what to cache next.
-    workersState = workersIntReqRestart;
-  }
+  // One of the items is about to be deleted. Cancel all caching tasks of the item which did not
+  // start yet. The item can be deleted when all tasks that use it returned. The playlist will
+  // signal a change afterwards so that we rethink what to cache next.
+  scheduler.cancel(item);
+
+  // Remove the item from the queues
+  for (auto it = cacheQueue.begin(); it != cacheQueue.end();)
+    it = (it->plItem == item) ? cacheQueue.erase(it) : it + 1;
+  for (auto it = cacheDeQueue.begin(); it != cacheDeQueue.end();)
+    it = (it->first == item) ? cacheDeQueue.erase(it) : it + 1;
+  for (auto &slot : interactiveSlots)
+    if (slot.queuedItem == item)
+    {
+      slot.queuedItem  = nullptr;
+      slot.queuedFrame = -1;
+    }
+  itemsToClearCache.removeAll(item);
 
-  if (cachingItem || loadingItem)
+  // Are we currently loading or caching a frame from this item?
+  const auto loadingItem = (interactiveSlots[0].item == item || interactiveSlots[1].item == item);
+  if (isCachingTaskRunning(item) || loadingItem)
   {
-    // The item can be deleted when all caching/loading threads of the item returned.
     itemsToDelete.append(item);
     DEBUG_CACHING("VideoCache::itemAboutToBeDeleted delete item later %s",
                   item->getName().toLatin1().data());
   }
   else
   {
-    // Remove the item from the loading queue (if in there)
-    if (interactiveItemQueued[0] == item)
-    {
-      interactiveItemQueued[0]     = nullptr;
-      interactiveItemQueued_Idx[0] = -1;
-    }
-    if (interactiveItemQueued[1] == item)
-    {
-      interactiveItemQueued[1]     = nullptr;
-      interactiveItemQueued_Idx[1] = -1;
-    }
     // The item can be deleted now.
     item->deleteLater();
     DEBUG_CACHING("VideoCache::itemAboutToBeDeleted delete item now %s",
@@ -1422,34 +1261,20 @@ void VideoCache::itemNeedsRecache(playlistItem *item, recacheIndicator clearItem
   else
   {
     // Something about the given playlistitem changed and all items in the cache are invalid.
-    // If a thread is currently caching the given item, we have to stop caching, clear the cache,
-    // rethink what to cache and restart the caching.
-    if (workersState != workersIdle)
+    // Cancel the caching tasks of the item. If a task is currently caching the given item, the
+    // cache is cleared when all running tasks of the item are done.
+    scheduler.cancel(item);
+    if (isCachingTaskRunning(item))
     {
-      // Are we currently caching a frame from this item?
-      bool cachingItem = false;
-      for (loadingThread *t : cachingThreadList)
-        if (t->worker()->getCacheItem() == item)
-          cachingItem = true;
-
-      if (cachingItem)
-      {
-        // The cache of the item needs to be cleared when all threads working on this item finished.
-        if (!itemsToClearCache.contains(item))
-          itemsToClearCache.append(item);
-      }
-      else
-        // We can clear the cache now
-        item->removeAllFramesFromCache();
-      workersState = workersIntReqRestart;
+      if (!itemsToClearCache.contains(item))
+        itemsToClearCache.append(item);
     }
     else
-    {
-      // The worker thread is idle. We can just clear the item cache now.
+      // We can clear the cache now
       item->removeAllFramesFromCache();
-      // This also implies that we want to rethink what to cache
-      scheduleCachingListUpdate();
-    }
+
+    // This also implies that we want to rethink what to cache
+    scheduleCachingListUpdate();
   }
 
   emit updateCacheStatus();
@@ -1480,28 +1305,82 @@ void VideoCache::testConversionSpeed()
 
   testLoopCount = 1000;
   testMode      = true;
+  testCanceled  = false;
   testProgrssUpdateTimer.start(200);
 
-  if (workersState == workersIdle)
+  // No more normal caching tasks are started. The test starts when the running tasks are done.
+  cacheQueue.clear();
+  if (runningCachingTasks.isEmpty())
   {
     // Start caching (in test mode)
+    testStarted = true;
     testDuration.start();
     startCaching();
   }
-  else
-    // Request a restart (in test mode)
-    workersState = workersIntReqRestart;
 }
 
 QStringList VideoCache::getCacheStatusText()
 {
   QStringList txt;
   txt.append("Interactive:");
-  txt.append(interactiveThread[0]->worker()->getStatus());
-  txt.append(interactiveThread[1]->worker()->getStatus());
+  for (int i = 0; i < 2; i++)
+  {
+    const auto &slot = interactiveSlots[i];
+    txt.append(
+        QString("T%1: %2").arg(i).arg(slot.working ? QString::number(slot.frame) : QString("-")));
+  }
   txt.append("Caching:");
-  for (loadingThread *t : cachingThreadList)
-    txt.append(t->worker()->getStatus());
+  for (const auto &task : runningCachingTasks)
+    txt.append(QString("%1: %2%3")
+                   .arg(task.item->getName())
+                   .arg(task.frame)
+                   .arg(task.converting ? " (converting)" : ""));
+
+  const auto schedulerStatus = scheduler.getStatus();
+  txt.append("Scheduler:");
+  txt.append(QString("%1 threads, %2 running, %3 queued, %4 stolen")
+                 .arg(schedulerStatus.nrThreads)
+                 .arg(schedulerStatus.nrRunning)
+                 .arg(schedulerStatus.nrQueued)
+                 .arg(schedulerStatus.nrStolen));
+
+  const auto frameCacheStatus = getFrameCache().getStatus();
+  txt.append("Frame cache:");
+  txt.append(QString("%1 frames, %2 MB")
+                 .arg(frameCacheStatus.nrFrames)
+                 .arg(frameCacheStatus.size / 1000 / 1000));
+  txt.append(QString("Hits %1, misses %2, evictions %3")
+                 .arg(frameCacheStatus.hits)
+                 .arg(frameCacheStatus.misses)
+                 .arg(frameCacheStatus.evictions));
+
+  const auto &compressedFrameCache = getCompressedFrameCache();
+  if (compressedFrameCache.isEnabled())
+  {
+    const auto status = compressedFrameCache.getStatus();
+    const auto ratio =
+        (status.compressedSize > 0) ? double(status.uncompressedSize) / status.compressedSize : 0.0;
+    txt.append("Compressed:");
+    txt.append(QString("%1 frames, %2 MB (ratio %3), %4 dropped")
+                   .arg(status.nrFrames)
+                   .arg(status.compressedSize / 1000 / 1000)
+                   .arg(ratio, 0, 'f', 2)
+                   .arg(status.nrDroppedFrames));
+  }
+
+  const auto poolStatus = getBufferPool().getStatus();
+  const auto reuseRate  = (poolStatus.nrAllocations > 0)
+                             ? 100.0 * double(poolStatus.nrReused) / poolStatus.nrAllocations
+                             : 0.0;
+  txt.append("Buffer pool:");
+  txt.append(QString("%1 MB used, %2 MB free, peak %3 MB")
+                 .arg(poolStatus.usedSize / 1000 / 1000)
+                 .arg(poolStatus.freeSize / 1000 / 1000)
+                 .arg(poolStatus.peakSize / 1000 / 1000));
+  txt.append(QString("%1 allocations, %2% reused, %3 freed")
+                 .arg(poolStatus.nrAllocations)
+                 .arg(reuseRate, 0, 'f', 1)
+                 .arg(poolStatus.nrFreed));
   return txt;
 }
 
@@ -1512,7 +1391,7 @@ void VideoCache::updateTestProgress()
 
   // Check if the dialog was canceled
   if (testProgressDialog->wasCanceled())
-    workersState = workersIntReqStop;
+    testCanceled = true;
 
   // Update the dialog progress
   testProgressDialog->setValue(1000 - testLoopCount);
@@ -1523,12 +1402,13 @@ void VideoCache::testFinished()
   DEBUG_CACHING("VideoCache::testFinished");
 
   // Quit test mode
-  testMode = false;
+  testMode    = false;
+  testStarted = false;
   testProgrssUpdateTimer.stop();
   delete testProgressDialog;
   testProgressDialog.clear();
 
-  if (workersState == workersIntReqStop)
+  if (testCanceled)
     // The test was canceled
     return;
 
@@ -1543,6 +1423,4 @@ void VideoCache::testFinished()
           .arg(rate));
 }
 
-#include "VideoCache.moc"
-
 } // namespace video
@@ -41,6 +41,7 @@
 #include <QTimer>
 #include <QWidget>
 
+#include "common/TaskScheduler.h"
 #include "ui/widgets/PlaylistTreeWidget.h"
 
 namespace video
@@ -81,18 +82,18 @@ signals:
 private slots:
 
   // This signal is sent from the playlistTreeWidget if something changed (another item was selected
-  // ...) The video Cache will then re-evaluate what to cache next and start the cache worker. If
-  // caching is currently running, the update will be performed when the currently running caching
-  // jobs are done.
+  // ...) The video Cache will then re-evaluate what to cache next. Caching tasks that are already
+  // running are not interrupted. New tasks are started from the updated queue.
   void scheduleCachingListUpdate();
 
-  // The cacheThread finished. If we requested the interruption, update the cache queue and restart.
-  // If the thread finished by itself, push the next item into it or goto idle state if there is no
-  // more things to cache
-  void threadCachingFinished();
+  // A caching task finished (or was canceled). Start the next task if there is one.
+  void cachingTaskFinished(int taskID);
+  // A caching task loaded (decoded) its frame. The conversion of the frame runs as a separate task.
+  // The next frame can be loaded in the meantime.
+  void cachingTaskLoaded(int taskID);
 
-  // The interactiveWorker finished loading a frame
-  void interactiveLoaderFinished();
+  // The interactive task of the given loading slot finished loading a frame
+  void interactiveTaskFinished(int loadingSlot);
 
   // An item is about to be deleted. If we are currently caching something (especially from this
   // item), abort that operation immediately.
@@ -109,17 +110,24 @@ private slots:
   void updateCacheQueue();
 
 private:
-  // A cache job. Has a pointer to a playlist item and a range of frames to be cached.
+  // A cache job. Has a pointer to a playlist item and a range of frames to be cached. The frames
+  // are cached from frameRange.first to frameRange.second in steps of frameStep (which is negative
+  // if the range is cached backwards). If the job is one random access segment of the item
+  // (segment != -1), only one task at a time caches frames of the segment.
   struct cacheJob
   {
     cacheJob() {}
-    cacheJob(playlistItem *item, indexRange range)
+    cacheJob(playlistItem *item, indexRange range, int step = 1, int segment = -1)
     {
-      plItem     = item;
-      frameRange = range;
+      plItem        = item;
+      frameRange    = range;
+      frameStep     = step;
+      this->segment = segment;
     }
     QPointer<playlistItem> plItem;
     indexRange             frameRange;
+    int                    frameStep{1};
+    int                    segment{-1};
   };
   typedef QPair<QPointer<playlistItem>, int> plItemFrame;
 
@@ -144,58 +152,83 @@ private:
   // Enqueue the job in the queue. If all frames within the range are already cached in the item, do
   // nothing.
   void enqueueCacheJob(playlistItem *item, indexRange range);
-
-  // Start the given number of worker threads (if caching is running, also new jobs will be pushed
-  // to the workers)
-  void startWorkerThreads(int nrThreads);
-  // If this number is > 0, the indicated number of threads will be deleted when a worker finishes
-  // (threadCachingFinished() is called)
-  int deleteNrThreads{0};
-  // How many threads are to be used when playback is running?
-  int nrThreadsPlayback;
-
-  // Our tiny internal state machine for the workers
-  enum workersStateEnum
+  // Enqueue jobs to cache the frames of the currently selected item in the order in which they will
+  // probably be requested (see getPrefetchOrder). If not all frames fit (maxNrFrames != -1), only
+  // the first maxNrFrames frames are cached and all other cached frames of the item are added to
+  // the cacheDeQueue.
+  void enqueuePrefetchJobs(playlistItem *item, indexRange range, int64_t maxNrFrames = -1);
+  // Items that can cache with multiple threads but have to decode from a random access point (see
+  // playlistItem::cachingThreadLimit) can cache the segments between two random access points in
+  // parallel. Split the forward jobs of these items into one job per segment.
+  void splitCacheJobsAtRandomAccessPoints();
+
+  // All loading and caching runs in the task scheduler. Interactive loading has the highest
+  // priority and runs in threads that are reserved for it. Caching the selected item comes before
+  // caching all other items. The tasks of an item are canceled when the item is deleted or needs a
+  // recache.
+  TaskScheduler scheduler;
+  // The number of threads used for caching and how many of them may be used while playback is
+  // running.
+  int nrThreads{0};
+  int nrThreadsPlayback{0};
+
+  // How many caching tasks may load frames at the same time right now?
+  int getMaxNrRunningCachingTasks() const;
+
+  // The caching tasks that were submitted to the scheduler and did not finish yet. Caching a frame
+  // is a pipeline of two stages: Loading (e.g. decoding) and converting the frame. A task is
+  // converting when its frame was loaded and the conversion is queued or running. Only loading
+  // tasks count against the thread limit and occupy a segment (and its decoder). The number of
+  // converting tasks is bounded by the number of threads. If conversion is slower than loading, no
+  // more frames are loaded until a conversion finished.
+  struct CachingTask
   {
-    workersIdle,       // The workers are idle. We can update the cacheQuene and go to workerRunning
-    workersRunning,    // The workers are running. If it finishes by itself goto workerIdle. If an
-                       // interrupt is requested, goto workerInterruptRequested.
-    workersIntReqStop, // The workers are running but an interrupt was requested. When all workers
-                       // are done, goto workerIdle.
-    workersIntReqRestart // The workers are running but an interrupt was requested because the queue
-                         // needs updating. When all workers finished, we will update the queue and
-                         // goto workerRunning.
+    int           id{};
+    playlistItem *item{};
+    int           frame{};
+    int           segment{-1};
+    bool          converting{};
   };
-  workersStateEnum workersState{workersIdle};
-  // When this is set and the worker state is workersIntReqStop, the cache will be cleared once all
-  // workers have finished.
-  bool clearCacheOnStop{false};
+  QList<CachingTask> runningCachingTasks;
+  int                nextCachingTaskID{0};
+  int                getNrCachingTasks(bool converting) const;
+
+  bool isCachingTaskRunning(playlistItem *item, int frame = -1) const;
+  bool isCachingSegmentRunning(playlistItem *item, int segment) const;
+  void submitCachingTask(playlistItem *          item,
+                         int                     frame,
+                         TaskScheduler::Priority priority,
+                         int                     segment = -1);
+
+  // Get the next item and frame to cache from the queue and submit it to the scheduler.
+  // Return false if there are no more jobs to be pushed.
+  bool pushNextCachingTask();
 
   // This list contains the items that are scheduled for deletion.
-  // All items in this list will be deleted (->deleteLate()) when caching has halted.
+  // All items in this list will be deleted (->deleteLater()) when no task is using them anymore.
   QList<playlistItem *> itemsToDelete;
   // This list contains the items that are scheduled for clearing the cache.
-  // The cache of these items will be cleared when caching has halted.
+  // The cache of these items will be cleared when no caching task is running for them anymore.
   QList<playlistItem *> itemsToClearCache;
+  // Delete/clear the items in the lists above which are not used by any task anymore.
+  // Return true if an item was deleted or cleared.
+  bool processItemsNoLongerInUse();
 
-  // A simple QObject (to move to threads) that gets a pointer to a playlist item and loads a frame
-  // in that item.
-  class loadingThread;
-
-  // A list of caching threads that process caching of frames in parallel in the background
-  QList<loadingThread *> cachingThreadList;
-
-  // Two threads with a higher priority that performs interactive loading (if the user is the source
-  // of the request)
-  loadingThread *interactiveThread[2];
-  playlistItem * interactiveItemQueued[2];
-  int            interactiveItemQueued_Idx[2];
-
-  // Get the next item and frame to cache from the queue and push it to the given worker.
-  // Return false if there are no more jobs to be pushed.
-  bool pushNextJobToCachingThread(loadingThread *thread);
+  // There are two slots for interactive loading (one for each item that can be visible at the same
+  // time). Each slot has one running request and one queued request.
+  struct InteractiveSlot
+  {
+    playlistItem *item{};
+    int           frame{-1};
+    bool          working{false};
+    playlistItem *queuedItem{};
+    int           queuedFrame{-1};
+  };
+  InteractiveSlot interactiveSlots[2];
+  void            submitInteractiveTask(int loadingSlot, playlistItem *item, int frameIndex);
 
-  bool updateCacheQueueAndRestartWorker;
+  // Start/stop the status update timer depending on whether caching is running
+  void updateStatusTimer();
 
   // This item is watched. When caching of it is done, we will notify the playback controller.
   playlistItem *watchingItem{nullptr};
@@ -210,6 +243,8 @@ private:
   QPointer<QProgressDialog> testProgressDialog;
   QPointer<playlistItem>    testItem;        //< The item to use for the test
   bool                      testMode{false}; //< Set to true when the test is running
+  bool testStarted{false};  //< The test waits for the running caching tasks before it starts
+  bool testCanceled{false}; //< The user canceled the test
   int    testLoopCount; //< Set before the test starts. Count down to 0. Then the test is over.
   QTimer testProgrssUpdateTimer; //< Periodically update the progress dialog
   void   updateTestProgress();
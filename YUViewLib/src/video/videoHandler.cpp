@@ -35,6 +35,8 @@
 #include <QPainter>
 
 #include <common/FunctionsGui.h>
+#include <video/CompressedFrameCache.h>
+#include <video/FrameCache.h>
 
 namespace video
 {
@@ -49,6 +51,28 @@ namespace video
 
 videoHandler::videoHandler()
 {
+  this->cacheRawData = settings.value("VideoCache/CacheRawData", false).toBool();
+}
+
+videoHandler::~videoHandler()
+{
+  getFrameCache().removeAll(this);
+  getCompressedFrameCache().remove(this);
+}
+
+void videoHandler::updateSettings()
+{
+  const auto newCacheRawData = settings.value("VideoCache/CacheRawData", false).toBool();
+  if (newCacheRawData == this->cacheRawData)
+    return;
+
+  this->cacheRawData = newCacheRawData;
+  if (this->supportsRawDataCaching())
+  {
+    // The cached frames (and the caching frame size) do not match the new mode
+    setCacheInvalid();
+    emit signalHandlerChanged(false, RECACHE_CLEAR);
+  }
 }
 
 void videoHandler::slotVideoControlChanged()
@@ -106,7 +130,7 @@ ItemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
                   frameIdx + 1);
       return ItemLoadingState::LoadingNotNeeded;
     }
-    else if (cacheValid && imageCache.contains(frameIdx + 1))
+    else if (cacheValid && getFrameCache().containsImage(this, frameIdx + 1))
     {
       DEBUG_VIDEO(
           "videoHandler::needsLoading %d is current and %d found in cache", frameIdx, frameIdx + 1);
@@ -126,7 +150,7 @@ ItemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
   if (doubleBufferImageFrameIndex == frameIdx)
   {
     // The frame in question is in the double buffer...
-    if (cacheValid && imageCache.contains(frameIdx + 1))
+    if (cacheValid && getFrameCache().containsImage(this, frameIdx + 1))
     {
       // ... and the one after that is in the cache.
       DEBUG_VIDEO("videoHandler::needsLoading %d found in double buffer. Next frame in cache.",
@@ -144,7 +168,7 @@ ItemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
   }
 
   // Check the cache
-  if (cacheValid && imageCache.contains(frameIdx))
+  if (cacheValid && getFrameCache().containsImage(this, frameIdx))
   {
     // What about the next frame? Is it also in the cache or in the double buffer?
     if (doubleBufferImageFrameIndex == frameIdx + 1)
@@ -154,7 +178,7 @@ ItemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
                   frameIdx + 1);
       return ItemLoadingState::LoadingNotNeeded;
     }
-    else if (cacheValid && imageCache.contains(frameIdx + 1))
+    else if (cacheValid && getFrameCache().containsImage(this, frameIdx + 1))
     {
       DEBUG_VIDEO(
           "videoHandler::needsLoading %d in cache and %d found in cache", frameIdx, frameIdx + 1);
@@ -192,9 +216,8 @@ void videoHandler::drawFrame(QPainter *painter, int frameIdx, double zoomFactor,
     else
     {
       QMutexLocker lock(&imageCacheAccess);
-      if (cacheValid && imageCache.contains(frameIdx))
+      if (cacheValid && getFrameCache().getImage(this, frameIdx, currentImage))
       {
-        currentImage      = imageCache[frameIdx];
         currentImageIndex = frameIdx;
         DEBUG_VIDEO("videoHandler::drawFrame %d loaded from cache", frameIdx);
       }
@@ -261,12 +284,38 @@ QRgb videoHandler::getPixelVal(int x, int y)
 
 int videoHandler::getNrFramesCached() const
 {
-  QMutexLocker lock(&imageCacheAccess);
-  return imageCache.size();
+  return getFrameCache().getNrFrames(this);
+}
+
+FrameBuffer videoHandler::getRawFrameBuffer() const
+{
+  if (!this->rawFrameBuffer.isNull())
+    return this->rawFrameBuffer;
+  return FrameBuffer(this->rawData);
+}
+
+bool videoHandler::requestRawDataForCaching(int frameIndex, FrameBuffer &rawDataToCache)
+{
+  if (this->cachingRawDataSource)
+    return this->cachingRawDataSource(frameIndex, rawDataToCache) && !rawDataToCache.isNull();
+
+  QMutexLocker lock(&requestDataMutex);
+  emit signalRequestRawData(frameIndex, true);
+  rawDataToCache = this->getRawFrameBuffer();
+  return frameIndex == rawData_frameIndex && !rawDataToCache.isNull();
+}
+
+bool videoHandler::requestRawDataForCaching(int frameIndex, QByteArray &rawDataToCache)
+{
+  FrameBuffer frameBuffer;
+  if (!this->requestRawDataForCaching(frameIndex, frameBuffer))
+    return false;
+  rawDataToCache = frameBuffer.toByteArray();
+  return true;
 }
 
 // Put the frame into the cache (if it is not already in there)
-void videoHandler::cacheFrame(int frameIdx, bool testMode)
+std::function<void()> videoHandler::cacheFrame(int frameIdx, bool testMode)
 {
   DEBUG_VIDEO("videoHandler::cacheFrame %d %s", frameIdx, testMode ? "testMode" : "");
 
@@ -274,23 +323,58 @@ void videoHandler::cacheFrame(int frameIdx, bool testMode)
   {
     // No need to add it again
     DEBUG_VIDEO("videoHandler::cacheFrame frame %i already in cache - returning", frameIdx);
-    return;
+    return {};
   }
 
-  // Load the frame. While this is happening in the background the frame size must not change.
-  QImage cacheImage;
-  loadFrameForCaching(frameIdx, cacheImage);
+  if (this->isRawDataCachingActive())
+  {
+    // Only load the raw data. It is converted when the frame is loaded for drawing.
+    QByteArray rawDataToCache;
+    if (loadRawDataForCaching(frameIdx, rawDataToCache))
+    {
+      DEBUG_VIDEO("videoHandler::cacheFrame insert raw data of frame %i into cache", frameIdx);
+      QMutexLocker imageCacheLock(&imageCacheAccess);
+      if (cacheValid && !testMode)
+      {
+        getFrameCache().insertRawData(this, frameIdx, rawDataToCache);
+      }
+    }
+    else
+      DEBUG_VIDEO("videoHandler::cacheFrame loading raw data of frame %i failed", frameIdx);
+    return {};
+  }
+
+  auto insertImage = [this, frameIdx, testMode](const QImage &cacheImage) {
+    if (!cacheImage.isNull())
+    {
+      DEBUG_VIDEO("videoHandler::cacheFrame insert frame %i into cache", frameIdx);
+      QMutexLocker imageCacheLock(&imageCacheAccess);
+      if (cacheValid && !testMode)
+      {
+        getFrameCache().insertImage(this, frameIdx, cacheImage);
+      }
+    }
+    else
+      DEBUG_VIDEO("videoHandler::cacheFrame loading frame %i for caching failed", frameIdx);
+  };
 
-  // Put it into the cache
-  if (!cacheImage.isNull())
+  if (this->supportsStagedCaching())
   {
-    DEBUG_VIDEO("videoHandler::cacheFrame insert frame %i into cache", frameIdx);
-    QMutexLocker imageCacheLock(&imageCacheAccess);
-    if (cacheValid && !testMode)
-      imageCache.insert(frameIdx, cacheImage);
+    // Only load the raw data now. The conversion is the next stage.
+    auto convertFrame = this->loadFrameForStagedCaching(frameIdx);
+    if (!convertFrame)
+    {
+      DEBUG_VIDEO("videoHandler::cacheFrame loading frame %i for caching failed", frameIdx);
+      return {};
+    }
+    return [convertFrame, insertImage]() { insertImage(convertFrame()); };
   }
-  else
-    DEBUG_VIDEO("videoHandler::cacheFrame loading frame %i for caching failed", frameIdx);
+
+  // Load the frame. While this is happening in the background the frame size must not change.
+  QImage cacheImage;
+  loadFrameForCaching(frameIdx, cacheImage);
+  insertImage(cacheImage);
+  return {};
 }
 
 unsigned videoHandler::getCachingFrameSize() const
@@ -302,35 +386,49 @@ unsigned videoHandler::getCachingFrameSize() const
 
 QList<int> videoHandler::getCachedFrames() const
 {
-  QMutexLocker lock(&imageCacheAccess);
-  return imageCache.keys();
+  return getFrameCache().getFrames(this);
 }
 
 int videoHandler::getNumberCachedFrames() const
 {
-  QMutexLocker lock(&imageCacheAccess);
-  return imageCache.size();
+  return getFrameCache().getNrFrames(this);
+}
+
+int64_t videoHandler::getCacheSizeInBytes() const
+{
+  return getFrameCache().getSize(this);
 }
 
 bool videoHandler::isInCache(int idx) const
 {
-  QMutexLocker lock(&imageCacheAccess);
-  return imageCache.contains(idx);
+  return getFrameCache().contains(this, idx);
 }
 
 void videoHandler::removeFrameFromCache(int frameIdx)
 {
   DEBUG_VIDEO("removeFrameFromCache %d", frameIdx);
   QMutexLocker lock(&imageCacheAccess);
-  imageCache.remove(frameIdx);
+  const auto   rawDataToCompress = getFrameCache().remove(this, frameIdx);
+  const auto   cacheWasValid     = cacheValid;
   lock.unlock();
+
+  // Keep the raw data of the frame in the compressed cache
+  if (cacheWasValid && !rawDataToCompress.isEmpty())
+    getCompressedFrameCache().insert(
+        this, frameIdx, rawDataToCompress, this->getRawDataElementSize());
+}
+
+void videoHandler::removeFramesOutsideOfRange(indexRange range)
+{
+  getFrameCache().removeOutsideOfRange(this, range.first, range.second);
 }
 
 void videoHandler::removeAllFrameFromCache()
 {
   DEBUG_VIDEO("removeAllFrameFromCache");
   QMutexLocker lock(&imageCacheAccess);
-  imageCache.clear();
+  getFrameCache().removeAll(this);
+  getCompressedFrameCache().remove(this);
   cacheValid = true;
   lock.unlock();
 }
@@ -398,7 +496,8 @@ void videoHandler::invalidateAllBuffers()
   currentImageSetMutex.unlock();
   requestedFrame_idx = -1;
 
-  imageCache.clear();
+  getFrameCache().removeAll(this);
+  getCompressedFrameCache().remove(this);
   cacheValid = true;
 }
 
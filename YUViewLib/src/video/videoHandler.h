@@ -33,12 +33,15 @@
 #pragma once
 
 #include "PixelFormat.h"
+#include "FrameBuffer.h"
 #include "FrameHandler.h"
 
 #include <QBasicTimer>
 #include <QFileInfo>
 #include <QMutex>
 
+#include <functional>
+
 namespace video
 {
 
@@ -50,6 +53,7 @@ public:
   /*
    */
   videoHandler();
+  virtual ~videoHandler();
 
   // Draw the frame with the given frame index and zoom factor. If onLoadShowLasFrame is set, show
   // the last frame if the frame with the current frame index is loaded in the background.
@@ -57,15 +61,24 @@ public:
 
   // --- Caching ----
   // These methods are all thread-safe and can be invoked from any thread.
-  int              getNrFramesCached() const;
-  void             cacheFrame(int frameIndex, bool testMode);
-  virtual unsigned getCachingFrameSize() const;
+  // The frames are kept in the FrameCache which is shared by all video handlers.
+  // If the handler supports staged caching, cacheFrame only loads the raw data of the frame and
+  // returns the function that converts it and puts the image into the cache. Otherwise the frame
+  // is cached right away and the returned function is empty.
+  int                   getNrFramesCached() const;
+  std::function<void()> cacheFrame(int frameIndex, bool testMode);
+  virtual unsigned      getCachingFrameSize() const;
   QList<int>       getCachedFrames() const;
   int              getNumberCachedFrames() const;
+  int64_t          getCacheSizeInBytes() const;
   bool             isInCache(int idx) const;
   virtual void     removeFrameFromCache(int frameIndex);
+  void             removeFramesOutsideOfRange(indexRange range);
   virtual void     removeAllFrameFromCache();
 
+  // Update the caching mode from the settings. If the mode changed, the cache is cleared.
+  void updateSettings();
+
   // Get the number of bytes for one frame (RGB or YUV) with the current format (if this video
   // handler uses raw data)
   virtual int64_t getBytesPerFrame() const { return -1; }
@@ -136,6 +149,35 @@ public:
   // A buffer with the raw RGB data (this is filled if signalRequestRawData() is emitted)
   QByteArray rawData;
   int        rawData_frameIndex{-1};
+  // A source that can hand over the raw data without copying it (e.g. the planes of a decoded
+  // frame) sets this instead of rawData.
+  FrameBuffer rawFrameBuffer;
+  // Get the raw data for rawData_frameIndex from whichever of the two was set
+  FrameBuffer getRawFrameBuffer() const;
+
+  // By default, the raw data for caching is requested using signalRequestRawData which only one
+  // thread can do at a time. A source that can provide the raw data of multiple frames in parallel
+  // (e.g. using multiple decoders) can be set here. It is called from the caching threads and
+  // must write the raw data of the requested frame to the given buffer.
+  using CachingRawDataSource = std::function<bool(int frameIndex, FrameBuffer &rawData)>;
+  void setCachingRawDataSource(CachingRawDataSource source)
+  {
+    this->cachingRawDataSource = source;
+  }
+
+  // Get the raw data or the converted image of the given frame without changing the current frame
+  // or the cache. Like caching, this can be done from any thread (e.g. to process frames without
+  // drawing them).
+  bool loadRawFrame(int frameIndex, FrameBuffer &rawData)
+  {
+    return this->requestRawDataForCaching(frameIndex, rawData);
+  }
+  QImage loadFrameImage(int frameIndex)
+  {
+    QImage image;
+    this->loadFrameForCaching(frameIndex, image);
+    return image;
+  }
 
   // Scale a value with limited mpeg range (16 ... 245) to the full range (0 ... 255) for output.
   static int convScaleLimitedRange(int value);
@@ -176,9 +218,23 @@ protected:
   // background thread.
   virtual void loadFrameForCaching(int frameIndex, QImage &frameToCache);
 
+  // Caching can be split into two stages that run in different threads: Loading the raw data (e.g.
+  // decoding it) and converting it to an image. Load the raw data of the frame and return the
+  // function that converts it. The function must capture everything it needs (e.g. the format at
+  // the time of loading). Return an empty function if loading failed. Handlers that do not support
+  // this load and convert frames in one stage using loadFrameForCaching.
+  virtual bool                    supportsStagedCaching() const { return false; }
+  virtual std::function<QImage()> loadFrameForStagedCaching(int) { return {}; }
+
   // Only one thread at a time should request something to be loaded.
   QMutex requestDataMutex;
 
+  // Get the raw data of the given frame for caching (from the caching raw data source if one is
+  // set). Return false if loading failed.
+  bool                 requestRawDataForCaching(int frameIndex, FrameBuffer &rawDataToCache);
+  bool                 requestRawDataForCaching(int frameIndex, QByteArray &rawDataToCache);
+  CachingRawDataSource cachingRawDataSource;
+
   // We might need to update the currentImage
   int currentImage_frameIndex{-1};
 
@@ -198,9 +254,23 @@ protected:
   // Set the cache to be invalid until a call to removefromCache(-1) clears it.
   void setCacheInvalid() { cacheValid = false; }
 
+  // Can this handler cache the raw data instead of the converted images? If so, the handler must
+  // implement loadRawDataForCaching and take the cached raw data into account when loading frames.
+  virtual bool supportsRawDataCaching() const { return false; }
+  bool         isRawDataCachingActive() const { return cacheRawData && supportsRawDataCaching(); }
+
+  // The video handler wants to cache the raw data of a frame. Like loadFrameForCaching, this is
+  // called from a background thread and must not change the internal state of the handler.
+  virtual bool loadRawDataForCaching(int, QByteArray &) { return false; }
+  // The size of one sample of the raw data in bytes. This improves the compression of raw data
+  // that is moved to the compressed frame cache.
+  virtual unsigned getRawDataElementSize() const { return 1; }
+
   // --- Caching
+  // The FrameCache holds either the converted image or the raw data of a frame (if raw data caching
+  // is enabled). imageCacheAccess synchronizes changes of the cache with cacheValid.
   QMutex mutable imageCacheAccess;
-  QMap<int, QImage> imageCache;
+  bool cacheRawData{};
   // Is the cache valid? The cache can be ivalid in the following scenario:
   // Somethign about how an item is shown changes (e.g. the resolution) but caching of the item is
   // currently performed. If we just cleared the cache, the wrong (currently being cached) frames
@@ -36,6 +36,7 @@
 #include <algorithm>
 
 #include <common/Functions.h>
+#include <video/FrameCache.h>
 #include <video/videoHandlerYUV.h>
 
 namespace video
@@ -76,9 +77,8 @@ void videoHandlerDifference::drawDifferenceFrame(QPainter *painter,
     else
     {
       QMutexLocker lock(&imageCacheAccess);
-      if (cacheValid && imageCache.contains(frameIdx))
+      if (cacheValid && getFrameCache().getImage(this, frameIdx, currentImage))
       {
-        currentImage      = imageCache[frameIdx];
         currentImageIndex = frameIdx;
         DEBUG_VIDEO("videoHandler::drawFrame %d loaded from cache", frameIdx);
       }
@@ -36,6 +36,7 @@
 #include <common/FileInfo.h>
 #include <common/Functions.h>
 #include <common/FunctionsGui.h>
+#include <video/BufferPool.h>
 #include <video/PixelFormatRGBGuess.h>
 #include <video/videoHandlerRGBCustomFormatDialog.h>
 
@@ -731,12 +732,7 @@ void videoHandlerRGB::loadFrameForCaching(int frameIndex, QImage &frameToCache)
   // before the RGB format can change.
   rgbFormatMutex.lock();
 
-  requestDataMutex.lock();
-  emit signalRequestRawData(frameIndex, true);
-  tmpBufferRawRGBDataCaching = rawData;
-  requestDataMutex.unlock();
-
-  if (frameIndex != rawData_frameIndex)
+  if (!this->requestRawDataForCaching(frameIndex, tmpBufferRawRGBDataCaching))
   {
     // Loading failed
     currentImageIndex = -1;
@@ -767,7 +763,7 @@ bool videoHandlerRGB::loadRawRGBData(int frameIndex)
     // The raw data was loaded in the background. Now we just have to move it to the current
     // buffer. No actual loading is needed.
     requestDataMutex.lock();
-    currentFrameRawData            = rawData;
+    currentFrameRawData            = this->getRawFrameBuffer().toByteArray();
     currentFrameRawData_frameIndex = frameIndex;
     requestDataMutex.unlock();
     return true;
@@ -781,7 +777,7 @@ bool videoHandlerRGB::loadRawRGBData(int frameIndex)
   emit signalRequestRawData(frameIndex, false);
   if (frameIndex == rawData_frameIndex)
   {
-    currentFrameRawData            = rawData;
+    currentFrameRawData            = this->getRawFrameBuffer().toByteArray();
     currentFrameRawData_frameIndex = frameIndex;
   }
   requestDataMutex.unlock();
@@ -821,7 +817,9 @@ void videoHandlerRGB::convertRGBToImage(const QByteArray &sourceBuffer, QImage &
     return;
   }
 
-  outputImage = QImage(curFrameSize, format);
+  // The memory of the image is from the buffer pool. It goes back to the pool when the image is
+  // dropped from the cache.
+  outputImage = getBufferPool().allocateImage(curFrameSize, format);
 
   // Check the image buffer size before we write to it
 #if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
@@ -36,15 +36,16 @@
 #include <cstdio>
 #include <type_traits>
 #include <vector>
-#if SSE_CONVERSION_420_ALT
-#include <xmmintrin.h>
-#endif
 #include <QDir>
 #include <QPainter>
 
 #include <common/FileInfo.h>
 #include <common/Functions.h>
 #include <common/FunctionsGui.h>
+#include <video/BufferPool.h>
+#include <video/CompressedFrameCache.h>
+#include <video/ConversionYUV.h>
+#include <video/FrameCache.h>
 #include <video/PixelFormatYUVGuess.h>
 #include <video/videoHandlerYUVCustomFormatDialog.h>
 
@@ -81,20 +82,6 @@ using namespace yuv;
 namespace
 {
 
-static unsigned char clp_buf[384 + 256 + 384];
-static bool          clp_buf_initialized = false;
-
-void initClippingTable()
-{
-  // Initialize clipping table. Because of the static bool, this will only be called once.
-  memset(clp_buf, 0, 384);
-  int i;
-  for (i = 0; i < 256; i++)
-    clp_buf[384 + i] = i;
-  memset(clp_buf + 384 + 256, 255, 384);
-  clp_buf_initialized = true;
-}
-
 // Compute the MSE between the given char sources for numPixels bytes
 template <typename T> double computeMSE(T ptr, T ptr2, int numPixels)
 {
@@ -406,236 +393,6 @@ yuv_t getPixelValueV210(const QByteArray &sourceBuffer,
   return ret;
 }
 
-// This is a specialized function that can convert 8 - bit YUV 4 : 2 : 0 to RGB888 using
-// NearestNeighborInterpolation. The chroma must be 0 in x direction and 1 in y direction. No
-// yuvMath is supported.
-// TODO: Correct the chroma subsampling offset.
-template <int bitDepth>
-bool convertYUV420ToRGB(const QByteArray &   sourceBuffer,
-                        unsigned char *      targetBuffer,
-                        const Size           size,
-                        const PixelFormatYUV format)
-{
-  typedef typename std::conditional<bitDepth == 8, uint8_t *, uint16_t *>::type InValueType;
-  static_assert(bitDepth == 8 || bitDepth == 10);
-  constexpr auto rightShift = (bitDepth == 8) ? 0 : 2;
-
-  const auto frameWidth  = size.width;
-  const auto frameHeight = size.height;
-
-  // For 4:2:0, w and h must be dividible by 2
-  assert(frameWidth % 2 == 0 && frameHeight % 2 == 0);
-
-  int componentLenghtY  = frameWidth * frameHeight;
-  int componentLengthUV = componentLenghtY >> 2;
-  Q_ASSERT(sourceBuffer.size() >= componentLenghtY + componentLengthUV +
-                                      componentLengthUV); // YUV 420 must be (at least) 1.5*Y-area
-
-#if SSE_CONVERSION_420_ALT
-  quint8 *srcYRaw = (quint8 *)sourceBuffer.data();
-  quint8 *srcURaw = srcYRaw + componentLenghtY;
-  quint8 *srcVRaw = srcURaw + componentLengthUV;
-
-  quint8 *dstBuffer       = (quint8 *)targetBuffer.data();
-  quint32 dstBufferStride = frameWidth * 4;
-
-  yuv420_to_argb8888(srcYRaw,
-                     srcURaw,
-                     srcVRaw,
-                     frameWidth,
-                     frameWidth >> 1,
-                     frameWidth,
-                     frameHeight,
-                     dstBuffer,
-                     dstBufferStride);
-  return false;
-#endif
-
-#if SSE_CONVERSION
-  // Try to use SSE. If this fails use conventional algorithm
-
-  if (frameWidth % 32 == 0 && frameHeight % 2 == 0)
-  {
-    // We can use 16byte aligned read/write operations
-
-    quint8 *srcY = (quint8 *)sourceBuffer.data();
-    quint8 *srcU = srcY + componentLenghtY;
-    quint8 *srcV = srcU + componentLengthUV;
-
-    __m128i yMult  = _mm_set_epi16(75, 75, 75, 75, 75, 75, 75, 75);
-    __m128i ySub   = _mm_set_epi16(16, 16, 16, 16, 16, 16, 16, 16);
-    __m128i ugMult = _mm_set_epi16(25, 25, 25, 25, 25, 25, 25, 25);
-    //__m128i sub16  = _mm_set_epi8(16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16);
-    __m128i sub128 = _mm_set_epi8(
-        128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128);
-
-    //__m128i test = _mm_set_epi8(128, 0, 1, 2, 3, 245, 254, 255, 128, 128, 128, 128, 128, 128, 128,
-    // 128);
-
-    __m128i y, u, v, uMult, vMult;
-    __m128i RGBOut0, RGBOut1, RGBOut2;
-    __m128i tmp;
-
-    for (int yh = 0; yh < frameHeight / 2; yh++)
-    {
-      for (int x = 0; x < frameWidth / 32; x += 32)
-      {
-        // Load 16 bytes U/V
-        u = _mm_load_si128((__m128i *)&srcU[x / 2]);
-        v = _mm_load_si128((__m128i *)&srcV[x / 2]);
-        // Subtract 128 from each U/V value (16 values)
-        u = _mm_sub_epi8(u, sub128);
-        v = _mm_sub_epi8(v, sub128);
-
-        // Load 16 bytes Y from this line and the next one
-        y = _mm_load_si128((__m128i *)&srcY[x]);
-
-        // Get the lower 8 (8bit signed) Y values and put them into a 16bit register
-        tmp = _mm_srai_epi16(_mm_unpacklo_epi8(y, y), 8);
-        // Subtract 16 and multiply by 75
-        tmp = _mm_sub_epi16(tmp, ySub);
-        tmp = _mm_mullo_epi16(tmp, yMult);
-
-        // Now to add them to the 16 bit RGB output values
-        RGBOut0 = _mm_shuffle_epi32(tmp, _MM_SHUFFLE(1, 0, 1, 0));
-        RGBOut0 = _mm_shufflelo_epi16(RGBOut0, _MM_SHUFFLE(1, 0, 0, 0));
-        RGBOut0 = _mm_shufflehi_epi16(RGBOut0, _MM_SHUFFLE(2, 2, 1, 1));
-
-        RGBOut1 = _mm_shuffle_epi32(tmp, _MM_SHUFFLE(2, 1, 2, 1));
-        RGBOut1 = _mm_shufflelo_epi16(RGBOut1, _MM_SHUFFLE(1, 1, 1, 0));
-        RGBOut1 = _mm_shufflehi_epi16(RGBOut1, _MM_SHUFFLE(3, 2, 2, 2));
-
-        RGBOut2 = _mm_shuffle_epi32(tmp, _MM_SHUFFLE(3, 2, 3, 2));
-        RGBOut2 = _mm_shufflelo_epi16(RGBOut2, _MM_SHUFFLE(2, 2, 1, 1));
-        RGBOut2 = _mm_shufflehi_epi16(RGBOut2, _MM_SHUFFLE(3, 3, 3, 2));
-
-        // y2 = _mm_load_si128((__m128i *) &srcY[x + 16]);
-
-        // --- Start with the left 8 values from U/V
-
-        // Get the lower 8 (8bit signed) U/V values and put them into a 16bit register
-        uMult = _mm_srai_epi16(_mm_unpacklo_epi8(u, u), 8);
-        vMult = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
-
-        // Multiply
-
-        /*y3 = _mm_load_si128((__m128i *) &srcY[x + frameWidth]);
-        y4 = _mm_load_si128((__m128i *) &srcY[x + frameWidth + 16]);*/
-      }
-    }
-
-    return true;
-  }
-#endif
-
-  static unsigned char *clip_buf = clp_buf + 384;
-  if (!clp_buf_initialized)
-    initClippingTable();
-
-  unsigned char *restrict dst = targetBuffer;
-
-  // Get/set the parameters used for YUV -> RGB conversion
-  auto       yuvColorConversionType = ColorConversion::BT709_LimitedRange;
-  const bool fullRange              = (yuvColorConversionType == ColorConversion::BT709_FullRange ||
-                          yuvColorConversionType == ColorConversion::BT601_FullRange ||
-                          yuvColorConversionType == ColorConversion::BT2020_FullRange);
-  const int  yOffset                = (fullRange ? 0 : 16);
-  const int  cZero                  = 128;
-  int        RGBConv[5];
-  getColorConversionCoefficients(yuvColorConversionType, RGBConv);
-
-  // Get pointers to the source and the output array
-  const bool uPplaneFirst =
-      (format.getPlaneOrder() == PlaneOrder::YUV ||
-       format.getPlaneOrder() == PlaneOrder::YUVA); // Is the U plane the first or the second?
-  const auto *restrict srcY = InValueType(sourceBuffer.data());
-  const auto *restrict srcU =
-      uPplaneFirst ? srcY + componentLenghtY : srcY + componentLenghtY + componentLengthUV;
-  const auto *restrict srcV =
-      uPplaneFirst ? srcY + componentLenghtY + componentLengthUV : srcY + componentLenghtY;
-
-  for (unsigned yh = 0; yh < frameHeight / 2; yh++)
-  {
-    // Process two lines at once, always 4 RGB values at a time (they have the same U/V components)
-
-    int dstAddr1  = yh * 2 * frameWidth * 4;       // The RGB output address of line yh*2
-    int dstAddr2  = (yh * 2 + 1) * frameWidth * 4; // The RGB output address of line yh*2+1
-    int srcAddrY1 = yh * 2 * frameWidth;           // The Y source address of line yh*2
-    int srcAddrY2 = (yh * 2 + 1) * frameWidth;     // The Y source address of line yh*2+1
-    int srcAddrUV = yh * frameWidth / 2; // The UV source address of both lines (UV are identical)
-
-    for (unsigned xh = 0, x = 0; xh < frameWidth / 2; xh++, x += 2)
-    {
-      // Process four pixels (the ones for which U/V are valid
-
-      // Load UV and pre-multiply
-      const int U_tmp_G = (((int)srcU[srcAddrUV + xh] >> rightShift) - cZero) * RGBConv[2];
-      const int U_tmp_B = (((int)srcU[srcAddrUV + xh] >> rightShift) - cZero) * RGBConv[4];
-      const int V_tmp_R = (((int)srcV[srcAddrUV + xh] >> rightShift) - cZero) * RGBConv[1];
-      const int V_tmp_G = (((int)srcV[srcAddrUV + xh] >> rightShift) - cZero) * RGBConv[3];
-
-      // Pixel top left
-      {
-        const int Y_tmp = (((int)srcY[srcAddrY1 + x] >> rightShift) - yOffset) * RGBConv[0];
-
-        const int R_tmp = (Y_tmp + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B) >> 16;
-
-        dst[dstAddr1]     = clip_buf[B_tmp];
-        dst[dstAddr1 + 1] = clip_buf[G_tmp];
-        dst[dstAddr1 + 2] = clip_buf[R_tmp];
-        dst[dstAddr1 + 3] = 255;
-        dstAddr1 += 4;
-      }
-      // Pixel top right
-      {
-        const int Y_tmp = (((int)srcY[srcAddrY1 + x + 1] >> rightShift) - yOffset) * RGBConv[0];
-
-        const int R_tmp = (Y_tmp + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B) >> 16;
-
-        dst[dstAddr1]     = clip_buf[B_tmp];
-        dst[dstAddr1 + 1] = clip_buf[G_tmp];
-        dst[dstAddr1 + 2] = clip_buf[R_tmp];
-        dst[dstAddr1 + 3] = 255;
-        dstAddr1 += 4;
-      }
-      // Pixel bottom left
-      {
-        const int Y_tmp = (((int)srcY[srcAddrY2 + x] >> rightShift) - yOffset) * RGBConv[0];
-
-        const int R_tmp = (Y_tmp + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B) >> 16;
-
-        dst[dstAddr2]     = clip_buf[B_tmp];
-        dst[dstAddr2 + 1] = clip_buf[G_tmp];
-        dst[dstAddr2 + 2] = clip_buf[R_tmp];
-        dst[dstAddr2 + 3] = 255;
-        dstAddr2 += 4;
-      }
-      // Pixel bottom right
-      {
-        const int Y_tmp = (((int)srcY[srcAddrY2 + x + 1] >> rightShift) - yOffset) * RGBConv[0];
-
-        const int R_tmp = (Y_tmp + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B) >> 16;
-
-        dst[dstAddr2]     = clip_buf[B_tmp];
-        dst[dstAddr2 + 1] = clip_buf[G_tmp];
-        dst[dstAddr2 + 2] = clip_buf[R_tmp];
-        dst[dstAddr2 + 3] = 255;
-        dstAddr2 += 4;
-      }
-    }
-  }
-
-  return true;
-}
-
 } // namespace
 
 videoHandlerYUV::videoHandlerYUV() : videoHandler()
@@ -667,6 +424,9 @@ videoHandlerYUV::~videoHandlerYUV()
 
 unsigned videoHandlerYUV::getCachingFrameSize() const
 {
+  if (this->isRawDataCachingActive())
+    return unsigned(std::max(this->getBytesPerFrame(), int64_t(0)));
+
   auto hasAlpha = this->srcPixelFormat.hasAlpha();
   auto bytes    = functionsGui::bytesPerPixel(functionsGui::platformImageFormat(hasAlpha));
   return this->frameSize.width * this->frameSize.height * bytes;
@@ -703,158 +463,6 @@ void videoHandlerYUV::drawFrame(QPainter *painter,
     videoHandler::drawFrame(painter, frameIdx, zoomFactor, drawRawData);
 }
 
-/// --- Convert from the current YUV input format to YUV 444
-
-#if SSE_CONVERSION_420_ALT
-void videoHandlerYUV::yuv420_to_argb8888(quint8 *yp,
-                                         quint8 *up,
-                                         quint8 *vp,
-                                         quint32 sy,
-                                         quint32 suv,
-                                         int     width,
-                                         int     height,
-                                         quint8 *rgb,
-                                         quint32 srgb)
-{
-  __m128i  y0r0, y0r1, u0, v0;
-  __m128i  y00r0, y01r0, y00r1, y01r1;
-  __m128i  u00, u01, v00, v01;
-  __m128i  rv00, rv01, gu00, gu01, gv00, gv01, bu00, bu01;
-  __m128i  r00, r01, g00, g01, b00, b01;
-  __m128i  rgb0123, rgb4567, rgb89ab, rgbcdef;
-  __m128i  gbgb;
-  __m128i  ysub, uvsub;
-  __m128i  zero, facy, facrv, facgu, facgv, facbu;
-  __m128i *srcy128r0, *srcy128r1;
-  __m128i *dstrgb128r0, *dstrgb128r1;
-  __m64 *  srcu64, *srcv64;
-
-  //    Implement the following conversion:
-  //    B = 1.164(Y - 16)                   + 2.018(U - 128)
-  //    G = 1.164(Y - 16) - 0.813(V - 128)  - 0.391(U - 128)
-  //    R = 1.164(Y - 16) + 1.596(V - 128)
-
-  int x, y;
-  // constants
-  ysub  = _mm_set1_epi32(0x00100010); // value 16 for subtraction
-  uvsub = _mm_set1_epi32(0x00800080); // value 128
-
-  // multiplication factors bit shifted by 6
-  facy  = _mm_set1_epi32(0x004a004a);
-  facrv = _mm_set1_epi32(0x00660066);
-  facgu = _mm_set1_epi32(0x00190019);
-  facgv = _mm_set1_epi32(0x00340034);
-  facbu = _mm_set1_epi32(0x00810081);
-
-  zero = _mm_set1_epi32(0x00000000);
-
-  for (y = 0; y < height; y += 2)
-  {
-    srcy128r0 = (__m128i *)(yp + sy * y);
-    srcy128r1 = (__m128i *)(yp + sy * y + sy);
-    srcu64    = (__m64 *)(up + suv * (y / 2));
-    srcv64    = (__m64 *)(vp + suv * (y / 2));
-
-    // dst row 0 and row 1
-    dstrgb128r0 = (__m128i *)(rgb + srgb * y);
-    dstrgb128r1 = (__m128i *)(rgb + srgb * y + srgb);
-
-    for (x = 0; x < width; x += 16)
-    {
-      u0 = _mm_loadl_epi64((__m128i *)srcu64);
-      srcu64++;
-      v0 = _mm_loadl_epi64((__m128i *)srcv64);
-      srcv64++;
-
-      y0r0 = _mm_load_si128(srcy128r0++);
-      y0r1 = _mm_load_si128(srcy128r1++);
-
-      // expand to 16 bit, subtract and multiply constant y factors
-      y00r0 = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(y0r0, zero), ysub), facy);
-      y01r0 = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(y0r0, zero), ysub), facy);
-      y00r1 = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(y0r1, zero), ysub), facy);
-      y01r1 = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(y0r1, zero), ysub), facy);
-
-      // expand u and v so they're aligned with y values
-      u0  = _mm_unpacklo_epi8(u0, zero);
-      u00 = _mm_sub_epi16(_mm_unpacklo_epi16(u0, u0), uvsub);
-      u01 = _mm_sub_epi16(_mm_unpackhi_epi16(u0, u0), uvsub);
-
-      v0  = _mm_unpacklo_epi8(v0, zero);
-      v00 = _mm_sub_epi16(_mm_unpacklo_epi16(v0, v0), uvsub);
-      v01 = _mm_sub_epi16(_mm_unpackhi_epi16(v0, v0), uvsub);
-
-      // common factors on both rows.
-      rv00 = _mm_mullo_epi16(facrv, v00);
-      rv01 = _mm_mullo_epi16(facrv, v01);
-      gu00 = _mm_mullo_epi16(facgu, u00);
-      gu01 = _mm_mullo_epi16(facgu, u01);
-      gv00 = _mm_mullo_epi16(facgv, v00);
-      gv01 = _mm_mullo_epi16(facgv, v01);
-      bu00 = _mm_mullo_epi16(facbu, u00);
-      bu01 = _mm_mullo_epi16(facbu, u01);
-
-      // add together and bit shift to the right
-      r00 = _mm_srai_epi16(_mm_add_epi16(y00r0, rv00), 6);
-      r01 = _mm_srai_epi16(_mm_add_epi16(y01r0, rv01), 6);
-      g00 = _mm_srai_epi16(_mm_sub_epi16(_mm_sub_epi16(y00r0, gu00), gv00), 6);
-      g01 = _mm_srai_epi16(_mm_sub_epi16(_mm_sub_epi16(y01r0, gu01), gv01), 6);
-      b00 = _mm_srai_epi16(_mm_add_epi16(y00r0, bu00), 6);
-      b01 = _mm_srai_epi16(_mm_add_epi16(y01r0, bu01), 6);
-
-      r00 = _mm_packus_epi16(r00, r01);
-      g00 = _mm_packus_epi16(g00, g01);
-      b00 = _mm_packus_epi16(b00, b01);
-
-      // shuffle back together to lower 0rgb0rgb...
-      r01     = _mm_unpacklo_epi8(r00, zero);  // 0r0r...
-      gbgb    = _mm_unpacklo_epi8(b00, g00);   // gbgb...
-      rgb0123 = _mm_unpacklo_epi16(gbgb, r01); // lower 0rgb0rgb...
-      rgb4567 = _mm_unpackhi_epi16(gbgb, r01); // upper 0rgb0rgb...
-
-      // shuffle back together to upper 0rgb0rgb...
-      r01     = _mm_unpackhi_epi8(r00, zero);
-      gbgb    = _mm_unpackhi_epi8(b00, g00);
-      rgb89ab = _mm_unpacklo_epi16(gbgb, r01);
-      rgbcdef = _mm_unpackhi_epi16(gbgb, r01);
-
-      // write to dst
-      _mm_store_si128(dstrgb128r0++, rgb0123);
-      _mm_store_si128(dstrgb128r0++, rgb4567);
-      _mm_store_si128(dstrgb128r0++, rgb89ab);
-      _mm_store_si128(dstrgb128r0++, rgbcdef);
-
-      // row 1
-      r00 = _mm_srai_epi16(_mm_add_epi16(y00r1, rv00), 6);
-      r01 = _mm_srai_epi16(_mm_add_epi16(y01r1, rv01), 6);
-      g00 = _mm_srai_epi16(_mm_sub_epi16(_mm_sub_epi16(y00r1, gu00), gv00), 6);
-      g01 = _mm_srai_epi16(_mm_sub_epi16(_mm_sub_epi16(y01r1, gu01), gv01), 6);
-      b00 = _mm_srai_epi16(_mm_add_epi16(y00r1, bu00), 6);
-      b01 = _mm_srai_epi16(_mm_add_epi16(y01r1, bu01), 6);
-
-      r00 = _mm_packus_epi16(r00, r01);
-      g00 = _mm_packus_epi16(g00, g01);
-      b00 = _mm_packus_epi16(b00, b01);
-
-      r01     = _mm_unpacklo_epi8(r00, zero);
-      gbgb    = _mm_unpacklo_epi8(b00, g00);
-      rgb0123 = _mm_unpacklo_epi16(gbgb, r01);
-      rgb4567 = _mm_unpackhi_epi16(gbgb, r01);
-
-      r01     = _mm_unpackhi_epi8(r00, zero);
-      gbgb    = _mm_unpackhi_epi8(b00, g00);
-      rgb89ab = _mm_unpacklo_epi16(gbgb, r01);
-      rgbcdef = _mm_unpackhi_epi16(gbgb, r01);
-
-      _mm_store_si128(dstrgb128r1++, rgb0123);
-      _mm_store_si128(dstrgb128r1++, rgb4567);
-      _mm_store_si128(dstrgb128r1++, rgb89ab);
-      _mm_store_si128(dstrgb128r1++, rgbcdef);
-    }
-  }
-}
-#endif
-
 QLayout *videoHandlerYUV::createVideoHandlerControls(bool isSizeFixed)
 {
   // Absolutely always only call this function once!
@@ -1134,6 +742,8 @@ QStringPairList videoHandlerYUV::getPixelValues(const QPoint &pixelPos,
     if (currentFrameRawData_frameIndex != frameIdx ||
         yuvItem2->currentFrameRawData_frameIndex != frameIdx1)
       return QStringPairList();
+    this->packCurrentFrameRawData();
+    yuvItem2->packCurrentFrameRawData();
 
     int width  = std::min(frameSize.width, yuvItem2->frameSize.width);
     int height = std::min(frameSize.height, yuvItem2->frameSize.height);
@@ -1190,6 +800,7 @@ QStringPairList videoHandlerYUV::getPixelValues(const QPoint &pixelPos,
     // Do not get the pixel values if the buffer for the raw YUV values is out of date.
     if (currentFrameRawData_frameIndex != frameIdx)
       return QStringPairList();
+    this->packCurrentFrameRawData();
 
     if (pixelPos.x() < 0 || pixelPos.x() >= width || pixelPos.y() < 0 || pixelPos.y() >= height)
       return QStringPairList();
@@ -1265,6 +876,9 @@ void videoHandlerYUV::drawPixelValues(QPainter *    painter,
     return;
   if (yuvItem2 && yuvItem2->currentFrameRawData_frameIndex != frameIdxItem1)
     return;
+  this->packCurrentFrameRawData();
+  if (yuvItem2)
+    yuvItem2->packCurrentFrameRawData();
 
   // For difference items, we support difference bit depths for the two items.
   // If the bit depth is different, we scale to value with the lower bit depth to the higher bit
@@ -1603,24 +1217,24 @@ void videoHandlerYUV::loadFrame(int frameIndex, bool loadToDoubleBuffer)
     // We cannot load a frame if the format is not known
     return;
 
-  // Does the data in currentFrameRawData need to be updated?
+  // Does the data in currentFrameBuffer need to be updated?
   if (!loadRawYUVData(frameIndex))
     // Loading failed or it is still being performed in the background
     return;
 
-  // The data in currentFrameRawData is now up to date. If necessary
+  // The data in currentFrameBuffer is now up to date. If necessary
   // convert the data to RGB.
   if (loadToDoubleBuffer)
   {
     QImage newImage;
-    convertYUVToImage(currentFrameRawData, newImage, srcPixelFormat, frameSize);
+    convertYUVToImage(currentFrameBuffer, newImage, srcPixelFormat, frameSize);
     doubleBufferImage           = newImage;
     doubleBufferImageFrameIndex = frameIndex;
   }
   else if (currentImageIndex != frameIndex)
   {
     QImage newImage;
-    convertYUVToImage(currentFrameRawData, newImage, srcPixelFormat, frameSize);
+    convertYUVToImage(currentFrameBuffer, newImage, srcPixelFormat, frameSize);
     QMutexLocker setLock(&currentImageSetMutex);
     currentImage      = newImage;
     currentImageIndex = frameIndex;
@@ -1631,28 +1245,82 @@ void videoHandlerYUV::loadFrameForCaching(int frameIndex, QImage &frameToCache)
 {
   DEBUG_YUV("videoHandlerYUV::loadFrameForCaching " << frameIndex);
 
+  if (auto convertFrame = this->loadFrameForStagedCaching(frameIndex))
+    frameToCache = convertFrame();
+}
+
+std::function<QImage()> videoHandlerYUV::loadFrameForStagedCaching(int frameIndex)
+{
+  DEBUG_YUV("videoHandlerYUV::loadFrameForStagedCaching " << frameIndex);
+
   // Get the YUV format and the size here, so that the caching process does not crash if this
   // changes.
   const auto yuvFormat    = srcPixelFormat;
   const auto curFrameSize = frameSize;
 
-  requestDataMutex.lock();
-  emit       signalRequestRawData(frameIndex, true);
-  QByteArray tmpBufferRawYUVDataCaching = rawData;
-  requestDataMutex.unlock();
+  FrameBuffer frameBufferCaching;
+  if (!this->loadFrameBufferForCaching(frameIndex, frameBufferCaching))
+    return {};
+
+  // Convert YUV to image. This can then be cached. The frame buffer keeps the raw data (e.g. the
+  // decoded picture) alive until the conversion is done.
+  return [this, frameBufferCaching, yuvFormat, curFrameSize]() {
+    QImage frameToCache;
+    this->convertYUVToImage(frameBufferCaching, frameToCache, yuvFormat, curFrameSize);
+    return frameToCache;
+  };
+}
+
+QImage videoHandlerYUV::convertRawFrame(const FrameBuffer &rawData)
+{
+  QImage image;
+  this->convertYUVToImage(rawData, image, this->srcPixelFormat, this->frameSize);
+  return image;
+}
+
+bool videoHandlerYUV::loadRawDataForCaching(int frameIndex, QByteArray &rawDataToCache)
+{
+  FrameBuffer frameBuffer;
+  if (!this->loadFrameBufferForCaching(frameIndex, frameBuffer))
+    return false;
+  rawDataToCache = frameBuffer.toByteArray();
+  return true;
+}
+
+bool videoHandlerYUV::loadFrameBufferForCaching(int frameIndex, FrameBuffer &frameBuffer)
+{
+  DEBUG_YUV("videoHandlerYUV::loadFrameBufferForCaching " << frameIndex);
 
-  if (frameIndex != rawData_frameIndex)
+  auto &     compressedFrameCache = getCompressedFrameCache();
+  QByteArray compressedCacheData;
+  if (cacheValid && compressedFrameCache.get(this, frameIndex, compressedCacheData))
+  {
+    DEBUG_YUV("videoHandlerYUV::loadFrameBufferForCaching " << frameIndex
+                                                            << " loaded from compressed cache");
+    frameBuffer = FrameBuffer(compressedCacheData);
+    return true;
+  }
+
+  if (!this->requestRawDataForCaching(frameIndex, frameBuffer))
   {
     // Loading failed
-    DEBUG_YUV("videoHandlerYUV::loadFrameForCaching Loading failed");
-    return;
+    DEBUG_YUV("videoHandlerYUV::loadFrameBufferForCaching Loading failed");
+    return false;
   }
 
-  // Convert YUV to image. This can then be cached.
-  convertYUVToImage(tmpBufferRawYUVDataCaching, frameToCache, yuvFormat, curFrameSize);
+  // The compressed cache needs the packed data. Only pack it if the cache is used.
+  if (cacheValid && compressedFrameCache.isEnabled())
+    compressedFrameCache.insert(
+        this, frameIndex, frameBuffer.toByteArray(), this->getRawDataElementSize());
+  return true;
+}
+
+unsigned videoHandlerYUV::getRawDataElementSize() const
+{
+  return (srcPixelFormat.getBitsPerSample() > 8) ? 2 : 1;
 }
 
-// Load the raw YUV data for the given frame index into currentFrameRawData.
+// Load the raw YUV data for the given frame index into currentFrameBuffer.
 bool videoHandlerYUV::loadRawYUVData(int frameIndex)
 {
   if (currentFrameRawData_frameIndex == frameIndex && cacheValid)
@@ -1664,9 +1332,35 @@ bool videoHandlerYUV::loadRawYUVData(int frameIndex)
   // The function loadFrameForCaching also uses the signalRequesRawYUVData to request raw data.
   // However, only one thread can use this at a time.
   requestDataMutex.lock();
+
+  if (this->isRawDataCachingActive())
+  {
+    // If the raw data of the frame is cached, there is no need to request it
+    QMutexLocker cacheLock(&imageCacheAccess);
+    QByteArray   cachedRawData;
+    if (cacheValid && getFrameCache().getRawData(this, frameIndex, cachedRawData))
+    {
+      this->setCurrentFrameBuffer(cachedRawData, frameIndex);
+      requestDataMutex.unlock();
+      DEBUG_YUV("videoHandlerYUV::loadRawYUVData " << frameIndex << " loaded from cache");
+      return true;
+    }
+  }
+
+  auto &     compressedFrameCache = getCompressedFrameCache();
+  QByteArray compressedCacheData;
+  if (cacheValid && compressedFrameCache.get(this, frameIndex, compressedCacheData))
+  {
+    this->setCurrentFrameBuffer(compressedCacheData, frameIndex);
+    requestDataMutex.unlock();
+    DEBUG_YUV("videoHandlerYUV::loadRawYUVData " << frameIndex << " loaded from compressed cache");
+    return true;
+  }
+
   emit signalRequestRawData(frameIndex, false);
 
-  if (frameIndex != rawData_frameIndex || rawData.isEmpty())
+  const auto frameBuffer = this->getRawFrameBuffer();
+  if (frameIndex != rawData_frameIndex || frameBuffer.isNull())
   {
     // Loading failed
     DEBUG_YUV("videoHandlerYUV::loadRawYUVData Loading failed");
@@ -1674,14 +1368,37 @@ bool videoHandlerYUV::loadRawYUVData(int frameIndex)
     return false;
   }
 
-  currentFrameRawData            = rawData;
-  currentFrameRawData_frameIndex = frameIndex;
+  this->setCurrentFrameBuffer(frameBuffer, frameIndex);
   requestDataMutex.unlock();
 
+  if (cacheValid && compressedFrameCache.isEnabled())
+  {
+    this->packCurrentFrameRawData();
+    compressedFrameCache.insert(
+        this, frameIndex, currentFrameRawData, this->getRawDataElementSize());
+  }
+
   DEBUG_YUV("videoHandlerYUV::loadRawYUVData " << frameIndex << " Done");
   return true;
 }
 
+void videoHandlerYUV::setCurrentFrameBuffer(const FrameBuffer &frameBuffer, int frameIndex)
+{
+  this->currentFrameBuffer = frameBuffer;
+  // Packed data can be used directly. Otherwise it is only packed when it is needed.
+  if (frameBuffer.isPacked())
+    this->currentFrameRawData = frameBuffer.toByteArray();
+  else
+    this->currentFrameRawData.clear();
+  this->currentFrameRawData_frameIndex = frameIndex;
+}
+
+void videoHandlerYUV::packCurrentFrameRawData()
+{
+  if (this->currentFrameRawData.isEmpty() && !this->currentFrameBuffer.isNull())
+    this->currentFrameRawData = this->currentFrameBuffer.toByteArray();
+}
+
 inline int clip8Bit(int val)
 {
   if (val < 0)
@@ -1717,57 +1434,6 @@ inline int transformYUV(const bool         invert,
   return newValue;
 }
 
-inline void convertYUVToRGB8Bit(const unsigned int valY,
-                                const unsigned int valU,
-                                const unsigned int valV,
-                                int &              valR,
-                                int &              valG,
-                                int &              valB,
-                                const int          RGBConv[5],
-                                const bool         fullRange,
-                                const int          bps)
-{
-  if (bps > 14)
-  {
-    // The bit depth of an int (32) is not enough to perform a YUV -> RGB conversion for a bit depth
-    // > 14 bits. We could use 64 bit values but for what? We are clipping the result to 8 bit
-    // anyways so let's just get rid of 2 of the bits for the YUV values.
-    const int yOffset = (fullRange ? 0 : 16 << (bps - 10));
-    const int cZero   = 128 << (bps - 10);
-
-    const int Y_tmp = ((valY >> 2) - yOffset) * RGBConv[0];
-    const int U_tmp = (valU >> 2) - cZero;
-    const int V_tmp = (valV >> 2) - cZero;
-
-    const int R_tmp = (Y_tmp + V_tmp * RGBConv[1]) >>
-                      (16 + bps - 10); // 32 to 16 bit conversion by right shifting
-    const int G_tmp = (Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> (16 + bps - 10);
-    const int B_tmp = (Y_tmp + U_tmp * RGBConv[4]) >> (16 + bps - 10);
-
-    valR = (R_tmp < 0) ? 0 : (R_tmp > 255) ? 255 : R_tmp;
-    valG = (G_tmp < 0) ? 0 : (G_tmp > 255) ? 255 : G_tmp;
-    valB = (B_tmp < 0) ? 0 : (B_tmp > 255) ? 255 : B_tmp;
-  }
-  else
-  {
-    const int yOffset = (fullRange ? 0 : 16 << (bps - 8));
-    const int cZero   = 128 << (bps - 8);
-
-    const int Y_tmp = (valY - yOffset) * RGBConv[0];
-    const int U_tmp = valU - cZero;
-    const int V_tmp = valV - cZero;
-
-    const int R_tmp =
-        (Y_tmp + V_tmp * RGBConv[1]) >> (16 + bps - 8); // 32 to 16 bit conversion by right shifting
-    const int G_tmp = (Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> (16 + bps - 8);
-    const int B_tmp = (Y_tmp + U_tmp * RGBConv[4]) >> (16 + bps - 8);
-
-    valR = (R_tmp < 0) ? 0 : (R_tmp > 255) ? 255 : R_tmp;
-    valG = (G_tmp < 0) ? 0 : (G_tmp > 255) ? 255 : G_tmp;
-    valB = (B_tmp < 0) ? 0 : (B_tmp > 255) ? 255 : B_tmp;
-  }
-}
-
 inline int getValueFromSource(const unsigned char *restrict src,
                               const int                     idx,
                               const int                     bps,
@@ -1782,28 +1448,6 @@ inline int getValueFromSource(const unsigned char *restrict src,
     return src[idx];
 }
 
-inline void setValueInBuffer(
-    unsigned char *restrict dst, const int val, const int idx, const int bps, const bool bigEndian)
-{
-  if (bps > 8)
-  {
-    // Write two bytes
-    if (bigEndian)
-    {
-      dst[idx * 2]     = val >> 8;
-      dst[idx * 2 + 1] = val & 0xff;
-    }
-    else
-    {
-      dst[idx * 2]     = val & 0xff;
-      dst[idx * 2 + 1] = val >> 8;
-    }
-  }
-  else
-    // Write one byte
-    dst[idx] = val;
-}
-
 // For every input sample in src, apply YUV transformation, (scale to 8 bit if required) and set the
 // value as RGB (monochrome). inValSkip: skip this many values in the input for every value. For
 // pure planar formats, this 1. If the UV components are interleaved, this is 2 or 3.
@@ -2048,972 +1692,6 @@ inline void YUVPlaneToRGBMonochrome_411(const int                     componentS
   }
 }
 
-inline int interpolateUVSample(const ChromaInterpolation mode, const int sample1, const int sample2)
-{
-  if (mode == ChromaInterpolation::Bilinear)
-    // Interpolate linearly between sample1 and sample2
-    return ((sample1 + sample2) + 1) >> 1;
-  return sample1; // Sample and hold
-}
-
-inline int interpolateUVSampleQ(const ChromaInterpolation mode,
-                                const int                 sample1,
-                                const int                 sample2,
-                                const int                 quarterPos)
-{
-  if (mode == ChromaInterpolation::Bilinear)
-  {
-    // Interpolate linearly between sample1 and sample2
-    if (quarterPos == 0)
-      return sample1;
-    if (quarterPos == 1)
-      return ((sample1 * 3 + sample2) + 1) >> 2;
-    if (quarterPos == 2)
-      return ((sample1 + sample2) + 1) >> 1;
-    if (quarterPos == 3)
-      return ((sample1 + sample2 * 3) + 1) >> 2;
-  }
-  return sample1; // Sample and hold
-}
-
-// TODO: Consider sample position
-inline int interpolateUVSample2D(const ChromaInterpolation mode,
-                                 const int                 sample1,
-                                 const int                 sample2,
-                                 const int                 sample3,
-                                 const int                 sample4)
-{
-  if (mode == ChromaInterpolation::Bilinear)
-    // Interpolate linearly between sample1 - sample 4
-    return ((sample1 + sample2 + sample3 + sample4) + 2) >> 2;
-  return sample1; // Sample and hold
-}
-
-// Depending on offsetX8 (which can be 1 to 7), interpolate one of the 6 given positions between
-// prev and cur.
-inline int interpolateUV8Pos(int prev, int cur, const int offsetX8)
-{
-  if (offsetX8 == 4)
-    return (prev + cur + 1) / 2;
-  if (offsetX8 == 2)
-    return (prev + cur * 3 + 2) / 4;
-  if (offsetX8 == 6)
-    return (prev * 3 + cur + 2) / 4;
-  if (offsetX8 == 1)
-    return (prev + cur * 7 + 4) / 8;
-  if (offsetX8 == 3)
-    return (prev * 3 + cur * 5 + 4) / 8;
-  if (offsetX8 == 5)
-    return (prev * 5 + cur * 3 + 4) / 8;
-  if (offsetX8 == 7)
-    return (prev * 7 + cur + 4) / 8;
-  Q_ASSERT(false); // offsetX8 should always be between 1 and 7 (inclusive)
-  return 0;
-}
-
-// Re-sample the chroma component so that the chroma samples and the luma samples are aligned after
-// this operation.
-inline void UVPlaneResamplingChromaOffset(const PixelFormatYUV          format,
-                                          const int                     w,
-                                          const int                     h,
-                                          const unsigned char *restrict srcU,
-                                          const unsigned char *restrict srcV,
-                                          const int                     inValSkip,
-                                          unsigned char *restrict       dstU,
-                                          unsigned char *restrict       dstV)
-{
-  // We can perform linear interpolation for 7 positions (6 in between) two pixels.
-  // Which of these position is needed depends on the chromaOffset and the subsampling.
-  const int possibleValsX = getMaxPossibleChromaOffsetValues(true, format.getSubsampling());
-  const int possibleValsY = getMaxPossibleChromaOffsetValues(false, format.getSubsampling());
-  const int offsetX8      = (possibleValsX == 1)   ? format.getChromaOffset().x * 4
-                            : (possibleValsX == 3) ? format.getChromaOffset().x * 2
-                                                   : format.getChromaOffset().x;
-  const int offsetY8      = (possibleValsY == 1)   ? format.getChromaOffset().y * 4
-                            : (possibleValsY == 3) ? format.getChromaOffset().y * 2
-                                                   : format.getChromaOffset().y;
-
-  // The format to use for input/output
-  const bool bigEndian = format.isBigEndian();
-  const int  bps       = format.getBitsPerSample();
-
-  const int stride = bps > 8 ? w * 2 : w;
-  if (offsetX8 != 0)
-  {
-    // Perform horizontal re-sampling
-    for (int y = 0; y < h; y++)
-    {
-      // On the left side, there is no previous sample, so the first value is never changed.
-      const int srcIdx = y * stride * inValSkip;
-      int       prevU  = getValueFromSource(srcU, srcIdx, bps, bigEndian);
-      int       prevV  = getValueFromSource(srcV, srcIdx, bps, bigEndian);
-      setValueInBuffer(dstU, prevU, y * stride, bps, bigEndian);
-      setValueInBuffer(dstV, prevV, y * stride, bps, bigEndian);
-
-      for (int x = 0; x < w - 1; x++)
-      {
-        // Calculate the new current value using the previous and the current value
-        const int srcIdxInLine = srcIdx + (x + 1) * inValSkip;
-        int       curU         = getValueFromSource(srcU, srcIdxInLine, bps, bigEndian);
-        int       curV         = getValueFromSource(srcV, srcIdxInLine, bps, bigEndian);
-
-        // Perform interpolation and save the value for the current UV value. Goto next value.
-        int newU = interpolateUV8Pos(prevU, curU, offsetX8);
-        int newV = interpolateUV8Pos(prevV, curV, offsetX8);
-        setValueInBuffer(dstU, newU, y * stride + x, bps, bigEndian);
-        setValueInBuffer(dstV, newV, y * stride + x, bps, bigEndian);
-
-        prevU = curU;
-        prevV = curV;
-      }
-    }
-  }
-
-  // For the second step, use the filtered values (or the source if no filtering was applied)
-  const unsigned char *srcUStep2    = (offsetX8 == 0) ? srcU : dstU;
-  const unsigned char *srcVStep2    = (offsetX8 == 0) ? srcV : dstV;
-  const int            valSkipStep2 = (offsetX8 == 0) ? inValSkip : 1;
-
-  if (offsetY8 != 0)
-  {
-    // Perform vertical re-sampling. It works exactly like horizontal up-sampling but x and y are
-    // switched.
-    for (int x = 0; x < w; x++)
-    {
-      // On the top, there is no previous sample, so the first value is never changed.
-      int prevU = getValueFromSource(srcUStep2, x * valSkipStep2, bps, bigEndian);
-      int prevV = getValueFromSource(srcVStep2, x * valSkipStep2, bps, bigEndian);
-      setValueInBuffer(dstU, prevU, x, bps, bigEndian);
-      setValueInBuffer(dstV, prevV, x, bps, bigEndian);
-
-      for (int y = 0; y < h - 1; y++)
-      {
-        // Calculate the new current value using the previous and the current value
-        const int srcIdx = (y + 1) * w + x;
-        int       curU   = getValueFromSource(srcUStep2, srcIdx * valSkipStep2, bps, bigEndian);
-        int       curV   = getValueFromSource(srcVStep2, srcIdx * valSkipStep2, bps, bigEndian);
-
-        // Perform interpolation and save the value for the current UV value. Goto next value.
-        int newU = interpolateUV8Pos(prevU, curU, offsetY8);
-        int newV = interpolateUV8Pos(prevV, curV, offsetY8);
-        setValueInBuffer(dstU, newU, srcIdx, bps, bigEndian);
-        setValueInBuffer(dstV, newV, srcIdx, bps, bigEndian);
-
-        prevU = curU;
-        prevV = curV;
-      }
-    }
-  }
-}
-
-inline void YUVPlaneToRGB_444(const int                     componentSize,
-                              const MathParameters          mathY,
-                              const MathParameters          mathC,
-                              const unsigned char *restrict srcY,
-                              const unsigned char *restrict srcU,
-                              const unsigned char *restrict srcV,
-                              unsigned char *restrict       dst,
-                              const int                     RGBConv[5],
-                              const bool                    fullRange,
-                              const int                     inMax,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
-{
-  const bool applyMathLuma   = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
-
-  for (int i = 0; i < componentSize; ++i)
-  {
-    unsigned int valY = getValueFromSource(srcY, i, bps, bigEndian);
-    unsigned int valU = getValueFromSource(srcU, i * inValSkip, bps, bigEndian);
-    unsigned int valV = getValueFromSource(srcV, i * inValSkip, bps, bigEndian);
-
-    if (applyMathLuma)
-      valY = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY, inMax);
-    if (applyMathChroma)
-    {
-      valU = transformYUV(mathC.invert, mathC.scale, mathC.offset, valU, inMax);
-      valV = transformYUV(mathC.invert, mathC.scale, mathC.offset, valV, inMax);
-    }
-
-    // Get the RGB values for this sample
-    int valR, valG, valB;
-    convertYUVToRGB8Bit(valY, valU, valV, valR, valG, valB, RGBConv, fullRange, bps);
-
-    // Save the RGB values
-    dst[i * 4]     = valB;
-    dst[i * 4 + 1] = valG;
-    dst[i * 4 + 2] = valR;
-    dst[i * 4 + 3] = 255;
-  }
-}
-
-inline void YUVPlaneToRGB_422(const int                     w,
-                              const int                     h,
-                              const MathParameters          mathY,
-                              const MathParameters          mathC,
-                              const unsigned char *restrict srcY,
-                              const unsigned char *restrict srcU,
-                              const unsigned char *restrict srcV,
-                              unsigned char *restrict       dst,
-                              const int                     RGBConv[5],
-                              const bool                    fullRange,
-                              const int                     inMax,
-                              const ChromaInterpolation     interpolation,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
-{
-  const bool applyMathLuma   = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
-  // Horizontal up-sampling is required. Process two Y values at a time
-  for (int y = 0; y < h; y++)
-  {
-    const int srcIdxUV   = y * w / 2;
-    int       curUSample = getValueFromSource(srcU, srcIdxUV * inValSkip, bps, bigEndian);
-    int       curVSample = getValueFromSource(srcV, srcIdxUV * inValSkip, bps, bigEndian);
-    if (applyMathChroma)
-    {
-      curUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curUSample, inMax);
-      curVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curVSample, inMax);
-    }
-
-    for (int x = 0; x < (w / 2) - 1; x++)
-    {
-      // Get the next U/V sample
-      const int srcPosLineUV = srcIdxUV + x + 1;
-      int       nextUSample  = getValueFromSource(srcU, srcPosLineUV * inValSkip, bps, bigEndian);
-      int       nextVSample  = getValueFromSource(srcV, srcPosLineUV * inValSkip, bps, bigEndian);
-      if (applyMathChroma)
-      {
-        nextUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextUSample, inMax);
-        nextVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextVSample, inMax);
-      }
-
-      // From the current and the next U/V sample, interpolate the UV sample in between
-      int interpolatedU = interpolateUVSample(interpolation, curUSample, nextUSample);
-      int interpolatedV = interpolateUVSample(interpolation, curVSample, nextVSample);
-
-      // Get the 2 Y samples
-      int valY1 = getValueFromSource(srcY, y * w + x * 2, bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, y * w + x * 2 + 1, bps, bigEndian);
-      if (applyMathLuma)
-      {
-        valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-        valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-      }
-
-      // Convert to 2 RGB values and save them (BGRA)
-      int valR1, valR2, valG1, valG2, valB1, valB2;
-      convertYUVToRGB8Bit(
-          valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, fullRange, bps);
-      convertYUVToRGB8Bit(
-          valY2, interpolatedU, interpolatedV, valR2, valG2, valB2, RGBConv, fullRange, bps);
-      const int pos = (y * w + x * 2) * 4;
-      dst[pos]      = valB1;
-      dst[pos + 1]  = valG1;
-      dst[pos + 2]  = valR1;
-      dst[pos + 3]  = 255;
-      dst[pos + 4]  = valB2;
-      dst[pos + 5]  = valG2;
-      dst[pos + 6]  = valR2;
-      dst[pos + 7]  = 255;
-
-      // The next one is now the current one
-      curUSample = nextUSample;
-      curVSample = nextVSample;
-    }
-
-    // For the last row, there is no next sample. Just reuse the current one again. No interpolation
-    // required either.
-
-    // Get the 2 Y samples
-    int valY1 = getValueFromSource(srcY, (y + 1) * w - 2, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y + 1) * w - 1, bps, bigEndian);
-    if (applyMathLuma)
-    {
-      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-    }
-
-    // Convert to 2 RGB values and save them
-    int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(
-        valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(
-        valY2, curUSample, curVSample, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos = ((y + 1) * w) * 4;
-    dst[pos - 8]  = valB1;
-    dst[pos - 7]  = valG1;
-    dst[pos - 6]  = valR1;
-    dst[pos - 5]  = 255;
-    dst[pos - 4]  = valB2;
-    dst[pos - 3]  = valG2;
-    dst[pos - 2]  = valR2;
-    dst[pos - 1]  = 255;
-  }
-}
-
-inline void YUVPlaneToRGB_440(const int                     w,
-                              const int                     h,
-                              const MathParameters          mathY,
-                              const MathParameters          mathC,
-                              const unsigned char *restrict srcY,
-                              const unsigned char *restrict srcU,
-                              const unsigned char *restrict srcV,
-                              unsigned char *restrict       dst,
-                              const int                     RGBConv[5],
-                              const bool                    fullRange,
-                              const int                     inMax,
-                              const ChromaInterpolation     interpolation,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
-{
-  const bool applyMathLuma   = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
-  // Vertical up-sampling is required. Process two Y values at a time
-
-  for (int x = 0; x < w; x++)
-  {
-    int curUSample = getValueFromSource(srcU, x * inValSkip, bps, bigEndian);
-    int curVSample = getValueFromSource(srcV, x * inValSkip, bps, bigEndian);
-    if (applyMathChroma)
-    {
-      curUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curUSample, inMax);
-      curVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curVSample, inMax);
-    }
-
-    for (int y = 0; y < (h / 2) - 1; y++)
-    {
-      // Get the next U/V sample
-      const int srcIdxUV    = y * w + x;
-      int       nextUSample = getValueFromSource(srcU, srcIdxUV * inValSkip, bps, bigEndian);
-      int       nextVSample = getValueFromSource(srcV, srcIdxUV * inValSkip, bps, bigEndian);
-      if (applyMathChroma)
-      {
-        nextUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextUSample, inMax);
-        nextVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextVSample, inMax);
-      }
-
-      // From the current and the next U/V sample, interpolate the UV sample in between
-      int interpolatedU = interpolateUVSample(interpolation, curUSample, nextUSample);
-      int interpolatedV = interpolateUVSample(interpolation, curVSample, nextVSample);
-
-      // Get the 2 Y samples
-      int valY1 = getValueFromSource(srcY, y * 2 * w + x, bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, (y * 2 + 1) * w + x, bps, bigEndian);
-      if (applyMathLuma)
-      {
-        valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-        valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-      }
-
-      // Convert to 2 RGB values and save them
-      int valR1, valR2, valG1, valG2, valB1, valB2;
-      convertYUVToRGB8Bit(
-          valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, fullRange, bps);
-      convertYUVToRGB8Bit(
-          valY2, interpolatedU, interpolatedV, valR2, valG2, valB2, RGBConv, fullRange, bps);
-      const int pos1 = (y * 2 * w + x) * 4;
-      const int pos2 = pos1 + 4 * w;
-      dst[pos1]      = valB1;
-      dst[pos1 + 1]  = valG1;
-      dst[pos1 + 2]  = valR1;
-      dst[pos1 + 3]  = 255;
-      dst[pos2]      = valB2;
-      dst[pos2 + 1]  = valG2;
-      dst[pos2 + 2]  = valR2;
-      dst[pos2 + 3]  = 255;
-
-      // The next one is now the current one
-      curUSample = nextUSample;
-      curVSample = nextVSample;
-    }
-
-    // For the last column, there is no next sample. Just reuse the current one again. No
-    // interpolation required either.
-
-    // Get the 2 Y samples
-    int valY1 = getValueFromSource(srcY, (h - 2) * w + x, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (h - 1) * w + x, bps, bigEndian);
-    if (applyMathLuma)
-    {
-      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-    }
-
-    // Convert to 2 RGB values and save them
-    int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(
-        valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(
-        valY2, curUSample, curVSample, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos1 = ((h - 2) * w + x) * 4;
-    const int pos2 = pos1 + w * 4;
-    dst[pos1]      = valB1;
-    dst[pos1 + 1]  = valG1;
-    dst[pos1 + 2]  = valR1;
-    dst[pos1 + 3]  = 255;
-    dst[pos2]      = valB2;
-    dst[pos2 + 1]  = valG2;
-    dst[pos2 + 2]  = valR2;
-    dst[pos2 + 3]  = 255;
-  }
-}
-
-inline void YUVPlaneToRGB_420(const int                     w,
-                              const int                     h,
-                              const MathParameters          mathY,
-                              const MathParameters          mathC,
-                              const unsigned char *restrict srcY,
-                              const unsigned char *restrict srcU,
-                              const unsigned char *restrict srcV,
-                              unsigned char *restrict       dst,
-                              const int                     RGBConv[5],
-                              const bool                    fullRange,
-                              const int                     inMax,
-                              const ChromaInterpolation     interpolation,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
-{
-  const bool applyMathLuma   = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
-  // Format is YUV 4:2:0. Horizontal and vertical up-sampling is required. Process 4 Y positions at
-  // a time
-  const int hh = h / 2; // The half values
-  const int wh = w / 2;
-  for (int y = 0; y < hh - 1; y++)
-  {
-    // Get the current U/V samples for this y line and the next one (_NL)
-    const int srcIdxUV0 = y * wh;
-    const int srcIdxUV1 = (y + 1) * wh;
-    int       curU      = getValueFromSource(srcU, srcIdxUV0 * inValSkip, bps, bigEndian);
-    int       curV      = getValueFromSource(srcV, srcIdxUV0 * inValSkip, bps, bigEndian);
-    int       curU_NL   = getValueFromSource(srcU, srcIdxUV1 * inValSkip, bps, bigEndian);
-    int       curV_NL   = getValueFromSource(srcV, srcIdxUV1 * inValSkip, bps, bigEndian);
-    if (applyMathChroma)
-    {
-      curU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU, inMax);
-      curV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV, inMax);
-      curU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU_NL, inMax);
-      curV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV_NL, inMax);
-    }
-
-    for (int x = 0; x < wh - 1; x++)
-    {
-      // Get the next U/V sample for this line and the next one
-      const int srcIdxUVLine0 = srcIdxUV0 + x + 1;
-      const int srcIdxUVLine1 = srcIdxUV1 + x + 1;
-      int       nextU         = getValueFromSource(srcU, srcIdxUVLine0 * inValSkip, bps, bigEndian);
-      int       nextV         = getValueFromSource(srcV, srcIdxUVLine0 * inValSkip, bps, bigEndian);
-      int       nextU_NL      = getValueFromSource(srcU, srcIdxUVLine1 * inValSkip, bps, bigEndian);
-      int       nextV_NL      = getValueFromSource(srcV, srcIdxUVLine1 * inValSkip, bps, bigEndian);
-      if (applyMathChroma)
-      {
-        nextU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU, inMax);
-        nextV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV, inMax);
-        nextU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU_NL, inMax);
-        nextV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV_NL, inMax);
-      }
-
-      // From the current and the next U/V sample, interpolate the 3 UV samples in between
-      int interpolatedU_Hor =
-          interpolateUVSample(interpolation, curU, nextU); // Horizontal interpolation
-      int interpolatedV_Hor = interpolateUVSample(interpolation, curV, nextV);
-      int interpolatedU_Ver =
-          interpolateUVSample(interpolation, curU, curU_NL); // Vertical interpolation
-      int interpolatedV_Ver = interpolateUVSample(interpolation, curV, curV_NL);
-      int interpolatedU_Bi =
-          interpolateUVSample2D(interpolation, curU, nextU, curU_NL, nextU_NL); // 2D interpolation
-      int interpolatedV_Bi =
-          interpolateUVSample2D(interpolation, curV, nextV, curV_NL, nextV_NL); // 2D interpolation
-
-      // Get the 4 Y samples
-      int valY1 = getValueFromSource(srcY, (y * w + x) * 2, bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, (y * w + x) * 2 + 1, bps, bigEndian);
-      int valY3 = getValueFromSource(srcY, (y * 2 + 1) * w + x * 2, bps, bigEndian);
-      int valY4 = getValueFromSource(srcY, (y * 2 + 1) * w + x * 2 + 1, bps, bigEndian);
-      if (applyMathLuma)
-      {
-        valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-        valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-        valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-        valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-      }
-
-      // Convert to 4 RGB values and save them
-      int valR1, valR2, valG1, valG2, valB1, valB2;
-      convertYUVToRGB8Bit(valY1, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps);
-      convertYUVToRGB8Bit(valY2,
-                          interpolatedU_Hor,
-                          interpolatedV_Hor,
-                          valR2,
-                          valG2,
-                          valB2,
-                          RGBConv,
-                          fullRange,
-                          bps);
-      const int pos1 = (y * 2 * w + x * 2) * 4;
-      dst[pos1]      = valB1;
-      dst[pos1 + 1]  = valG1;
-      dst[pos1 + 2]  = valR1;
-      dst[pos1 + 3]  = 255;
-      dst[pos1 + 4]  = valB2;
-      dst[pos1 + 5]  = valG2;
-      dst[pos1 + 6]  = valR2;
-      dst[pos1 + 7]  = 255;
-      convertYUVToRGB8Bit(valY3,
-                          interpolatedU_Ver,
-                          interpolatedV_Ver,
-                          valR1,
-                          valG1,
-                          valB1,
-                          RGBConv,
-                          fullRange,
-                          bps); // Second line
-      convertYUVToRGB8Bit(
-          valY4, interpolatedU_Bi, interpolatedV_Bi, valR2, valG2, valB2, RGBConv, fullRange, bps);
-      const int pos2 = pos1 + w * 4; // Next line
-      dst[pos2]      = valB1;
-      dst[pos2 + 1]  = valG1;
-      dst[pos2 + 2]  = valR1;
-      dst[pos2 + 3]  = 255;
-      dst[pos2 + 4]  = valB2;
-      dst[pos2 + 5]  = valG2;
-      dst[pos2 + 6]  = valR2;
-      dst[pos2 + 7]  = 255;
-
-      // The next one is now the current one
-      curU    = nextU;
-      curV    = nextV;
-      curU_NL = nextU_NL;
-      curV_NL = nextV_NL;
-    }
-
-    // For the last x value (the right border), there is no next value. Just sample and hold. Only
-    // vertical interpolation is required.
-    int interpolatedU_Ver =
-        interpolateUVSample(interpolation, curU, curU_NL); // Vertical interpolation
-    int interpolatedV_Ver = interpolateUVSample(interpolation, curV, curV_NL);
-
-    // Get the 4 Y samples
-    int valY1 = getValueFromSource(srcY, (y * 2 + 1) * w - 2, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y * 2 + 1) * w - 1, bps, bigEndian);
-    int valY3 = getValueFromSource(srcY, (y * 2 + 2) * w - 2, bps, bigEndian);
-    int valY4 = getValueFromSource(srcY, (y * 2 + 2) * w - 1, bps, bigEndian);
-    if (applyMathLuma)
-    {
-      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-      valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-      valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-    }
-
-    // Convert to 4 RGB values and save them
-    int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(valY1, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(valY2, curU, curV, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos1 = ((y * 2 + 1) * w) * 4;
-    dst[pos1 - 8]  = valB1;
-    dst[pos1 - 7]  = valG1;
-    dst[pos1 - 6]  = valR1;
-    dst[pos1 - 5]  = 255;
-    dst[pos1 - 4]  = valB2;
-    dst[pos1 - 3]  = valG2;
-    dst[pos1 - 2]  = valR2;
-    dst[pos1 - 1]  = 255;
-    convertYUVToRGB8Bit(valY3,
-                        interpolatedU_Ver,
-                        interpolatedV_Ver,
-                        valR1,
-                        valG1,
-                        valB1,
-                        RGBConv,
-                        fullRange,
-                        bps); // Second line
-    convertYUVToRGB8Bit(
-        valY4, interpolatedU_Ver, interpolatedV_Ver, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos2 = pos1 + w * 4; // Next line
-    dst[pos2 - 8]  = valB1;
-    dst[pos2 - 7]  = valG1;
-    dst[pos2 - 6]  = valR1;
-    dst[pos2 - 5]  = 255;
-    dst[pos2 - 4]  = valB2;
-    dst[pos2 - 3]  = valG2;
-    dst[pos2 - 2]  = valR2;
-    dst[pos2 - 1]  = 255;
-  }
-
-  // At the last Y line (the bottom line) a similar scenario occurs. There is no next Y line. Just
-  // sample and hold. Only horizontal interpolation is required.
-
-  // Get the current U/V samples for this y line
-  const int y  = hh - 1; // Just process the last y line
-  const int y2 = (hh - 1) * 2;
-
-  // Get 2 chroma samples from this line
-  const int srcIdxUV = y * wh;
-  int       curU     = getValueFromSource(srcU, srcIdxUV * inValSkip, bps, bigEndian);
-  int       curV     = getValueFromSource(srcV, srcIdxUV * inValSkip, bps, bigEndian);
-  if (applyMathChroma)
-  {
-    curU = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU, inMax);
-    curV = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV, inMax);
-  }
-
-  for (int x = 0; x < (w / 2) - 1; x++)
-  {
-    // Get the next U/V sample for this line and the next one
-    const int srcIdxLineUV = srcIdxUV + x + 1;
-    int       nextU        = getValueFromSource(srcU, srcIdxLineUV * inValSkip, bps, bigEndian);
-    int       nextV        = getValueFromSource(srcV, srcIdxLineUV * inValSkip, bps, bigEndian);
-    if (applyMathChroma)
-    {
-      nextU = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU, inMax);
-      nextV = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV, inMax);
-    }
-
-    // From the current and the next U/V sample, interpolate the 3 UV samples in between
-    int interpolatedU_Hor =
-        interpolateUVSample(interpolation, curU, nextU); // Horizontal interpolation
-    int interpolatedV_Hor = interpolateUVSample(interpolation, curV, nextV);
-
-    // Get the 4 Y samples
-    int valY1 = getValueFromSource(srcY, (y * w + x) * 2, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y * w + x) * 2 + 1, bps, bigEndian);
-    int valY3 = getValueFromSource(srcY, (y2 + 1) * w + x * 2, bps, bigEndian);
-    int valY4 = getValueFromSource(srcY, (y2 + 1) * w + x * 2 + 1, bps, bigEndian);
-    if (applyMathLuma)
-    {
-      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-      valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-      valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-    }
-
-    // Convert to 4 RGB values and save them
-    int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(valY1, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(
-        valY2, interpolatedU_Hor, interpolatedV_Hor, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos1 = (y2 * w + x * 2) * 4;
-    dst[pos1]      = valB1;
-    dst[pos1 + 1]  = valG1;
-    dst[pos1 + 2]  = valR1;
-    dst[pos1 + 3]  = 255;
-    dst[pos1 + 4]  = valB2;
-    dst[pos1 + 5]  = valG2;
-    dst[pos1 + 6]  = valR2;
-    dst[pos1 + 7]  = 255;
-    convertYUVToRGB8Bit(
-        valY3, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps); // Second line
-    convertYUVToRGB8Bit(
-        valY4, interpolatedU_Hor, interpolatedV_Hor, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos2 = pos1 + w * 4; // Next line
-    dst[pos2]      = valB1;
-    dst[pos2 + 1]  = valG1;
-    dst[pos2 + 2]  = valR1;
-    dst[pos2 + 3]  = 255;
-    dst[pos2 + 4]  = valB2;
-    dst[pos2 + 5]  = valG2;
-    dst[pos2 + 6]  = valR2;
-    dst[pos2 + 7]  = 255;
-
-    // The next one is now the current one
-    curU = nextU;
-    curV = nextV;
-  }
-
-  // For the last x value in the last y row (the right bottom), there is no next value in neither
-  // direction. Just sample and hold. No interpolation is required.
-
-  // Get the 4 Y samples
-  int valY1 = getValueFromSource(srcY, (y2 + 1) * w - 2, bps, bigEndian);
-  int valY2 = getValueFromSource(srcY, (y2 + 1) * w - 1, bps, bigEndian);
-  int valY3 = getValueFromSource(srcY, (y2 + 2) * w - 2, bps, bigEndian);
-  int valY4 = getValueFromSource(srcY, (y2 + 2) * w - 1, bps, bigEndian);
-  if (applyMathLuma)
-  {
-    valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-    valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-    valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-    valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-  }
-
-  // Convert to 4 RGB values and save them
-  int valR1, valR2, valG1, valG2, valB1, valB2;
-  convertYUVToRGB8Bit(valY1, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps);
-  convertYUVToRGB8Bit(valY2, curU, curV, valR2, valG2, valB2, RGBConv, fullRange, bps);
-  const int pos1 = (y2 + 1) * w * 4;
-  dst[pos1 - 8]  = valB1;
-  dst[pos1 - 7]  = valG1;
-  dst[pos1 - 6]  = valR1;
-  dst[pos1 - 5]  = 255;
-  dst[pos1 - 4]  = valB2;
-  dst[pos1 - 3]  = valG2;
-  dst[pos1 - 2]  = valR2;
-  dst[pos1 - 1]  = 255;
-  convertYUVToRGB8Bit(
-      valY3, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps); // Second line
-  convertYUVToRGB8Bit(valY4, curU, curV, valR2, valG2, valB2, RGBConv, fullRange, bps);
-  const int pos2 = pos1 + w * 4; // Next line
-  dst[pos2 - 8]  = valB1;
-  dst[pos2 - 7]  = valG1;
-  dst[pos2 - 6]  = valR1;
-  dst[pos2 - 5]  = 255;
-  dst[pos2 - 4]  = valB2;
-  dst[pos2 - 3]  = valG2;
-  dst[pos2 - 2]  = valR2;
-  dst[pos2 - 1]  = 255;
-}
-
-inline void YUVPlaneToRGB_410(const int                     w,
-                              const int                     h,
-                              const MathParameters          mathY,
-                              const MathParameters          mathC,
-                              const unsigned char *restrict srcY,
-                              const unsigned char *restrict srcU,
-                              const unsigned char *restrict srcV,
-                              unsigned char *restrict       dst,
-                              const int                     RGBConv[5],
-                              const bool                    fullRange,
-                              const int                     inMax,
-                              const ChromaInterpolation     interpolation,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
-{
-  const bool applyMathLuma   = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
-  // Format is YUV 4:1:0. Horizontal and vertical up-sampling is required. Process 4 Y positions of
-  // 2 lines at a time Horizontal subsampling by 4, vertical subsampling by 2
-  const int hq = h / 4; // The quarter values
-  const int wq = w / 4;
-
-  for (int y = 0; y < hq; y++)
-  {
-    // Get the current U/V samples for this y line and the next one (_NL)
-    const int srcIdxUV0 = y * wq;
-    const int srcIdxUV1 = (y + 1) * wq;
-    int       curU      = getValueFromSource(srcU, srcIdxUV0 * inValSkip, bps, bigEndian);
-    int       curV      = getValueFromSource(srcV, srcIdxUV0 * inValSkip, bps, bigEndian);
-    int       curU_NL =
-        (y < hq - 1) ? getValueFromSource(srcU, srcIdxUV1 * inValSkip, bps, bigEndian) : curU;
-    int curV_NL =
-        (y < hq - 1) ? getValueFromSource(srcV, srcIdxUV1 * inValSkip, bps, bigEndian) : curV;
-    if (applyMathChroma)
-    {
-      curU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU, inMax);
-      curV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV, inMax);
-      curU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU_NL, inMax);
-      curV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV_NL, inMax);
-    }
-
-    for (int x = 0; x < wq; x++)
-    {
-      // We process 4*4 values per U/V value
-
-      // Get the next U/V sample for this line and the next one
-      const int srcIdxUVLine0 = srcIdxUV0 + x + 1;
-      const int srcIdxUVLine1 = srcIdxUV1 + x + 1;
-      int       nextU =
-          (x < wq - 1) ? getValueFromSource(srcU, srcIdxUVLine0 * inValSkip, bps, bigEndian) : curU;
-      int nextV =
-          (x < wq - 1) ? getValueFromSource(srcV, srcIdxUVLine0 * inValSkip, bps, bigEndian) : curV;
-      int nextU_NL = (x < wq - 1)
-                         ? getValueFromSource(srcU, srcIdxUVLine1 * inValSkip, bps, bigEndian)
-                         : curU_NL;
-      int nextV_NL = (x < wq - 1)
-                         ? getValueFromSource(srcV, srcIdxUVLine1 * inValSkip, bps, bigEndian)
-                         : curV_NL;
-      if (applyMathChroma)
-      {
-        nextU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU, inMax);
-        nextV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV, inMax);
-        nextU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU_NL, inMax);
-        nextV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV_NL, inMax);
-      }
-
-      // Now we interpolate and set the RGB values for the 4x4 pixels
-      for (int yo = 0; yo < 4; yo++)
-      {
-        // Interpolate vertically
-        int curU_INT  = interpolateUVSampleQ(interpolation, curU, curU_NL, yo);
-        int curV_INT  = interpolateUVSampleQ(interpolation, curV, curV_NL, yo);
-        int nextU_INT = interpolateUVSampleQ(interpolation, nextU, nextU_NL, yo);
-        int nextV_INT = interpolateUVSampleQ(interpolation, nextV, nextV_NL, yo);
-
-        for (int xo = 0; xo < 4; xo++)
-        {
-          // Interpolate horizontally
-          int U = interpolateUVSampleQ(interpolation, curU_INT, nextU_INT, xo);
-          int V = interpolateUVSampleQ(interpolation, curV_INT, nextV_INT, xo);
-          // Get the Y sample
-          int Y = getValueFromSource(srcY, (y * 4 + yo) * w + x * 4 + xo, bps, bigEndian);
-          if (applyMathLuma)
-            Y = transformYUV(mathY.invert, mathY.scale, mathY.offset, Y, inMax);
-
-          // Convert to RGB and save (BGRA)
-          int       R, G, B;
-          const int pos = ((y * 4 + yo) * w + x * 4 + xo) * 4;
-          convertYUVToRGB8Bit(Y, U, V, R, G, B, RGBConv, fullRange, bps);
-          dst[pos]     = B;
-          dst[pos + 1] = G;
-          dst[pos + 2] = R;
-          dst[pos + 3] = 255;
-        }
-      }
-
-      curU    = nextU;
-      curV    = nextV;
-      curU_NL = nextU_NL;
-      curV_NL = nextV_NL;
-    }
-  }
-}
-
-inline void YUVPlaneToRGB_411(const int                     w,
-                              const int                     h,
-                              const MathParameters          mathY,
-                              const MathParameters          mathC,
-                              const unsigned char *restrict srcY,
-                              const unsigned char *restrict srcU,
-                              const unsigned char *restrict srcV,
-                              unsigned char *restrict       dst,
-                              const int                     RGBConv[5],
-                              const bool                    fullRange,
-                              const int                     inMax,
-                              const ChromaInterpolation     interpolation,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
-{
-  // Chroma: quarter horizontal resolution
-  const bool applyMathLuma   = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
-
-  // Horizontal up-sampling is required. Process four Y values at a time.
-  for (int y = 0; y < h; y++)
-  {
-    const int srcIdxUV   = y * w / 4;
-    int       curUSample = getValueFromSource(srcU, srcIdxUV * inValSkip, bps, bigEndian);
-    int       curVSample = getValueFromSource(srcV, srcIdxUV * inValSkip, bps, bigEndian);
-    if (applyMathChroma)
-    {
-      curUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curUSample, inMax);
-      curVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curVSample, inMax);
-    }
-
-    for (int x = 0; x < (w / 4) - 1; x++)
-    {
-      // Get the next U/V sample
-      const int srcIdxUVLine = srcIdxUV + x + 1;
-      int       nextUSample  = getValueFromSource(srcU, srcIdxUVLine * inValSkip, bps, bigEndian);
-      int       nextVSample  = getValueFromSource(srcV, srcIdxUVLine * inValSkip, bps, bigEndian);
-      if (applyMathChroma)
-      {
-        nextUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextUSample, inMax);
-        nextVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextVSample, inMax);
-      }
-
-      // From the current and the next U/V sample, interpolate the UV sample in between
-      int interpolatedU1 = interpolateUVSampleQ(interpolation, curUSample, nextUSample, 1);
-      int interpolatedV1 = interpolateUVSampleQ(interpolation, curVSample, nextVSample, 1);
-      int interpolatedU2 = interpolateUVSample(interpolation, curUSample, nextUSample);
-      int interpolatedV2 = interpolateUVSample(interpolation, curVSample, nextVSample);
-      int interpolatedU3 = interpolateUVSampleQ(interpolation, curUSample, nextUSample, 3);
-      int interpolatedV3 = interpolateUVSampleQ(interpolation, curVSample, nextVSample, 3);
-
-      // Get the 4 Y samples
-      int valY1 = getValueFromSource(srcY, y * w + x * 4, bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, y * w + x * 4 + 1, bps, bigEndian);
-      int valY3 = getValueFromSource(srcY, y * w + x * 4 + 2, bps, bigEndian);
-      int valY4 = getValueFromSource(srcY, y * w + x * 4 + 3, bps, bigEndian);
-      if (applyMathLuma)
-      {
-        valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-        valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-        valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-        valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-      }
-
-      // Convert to 4 RGB values and save them
-      int       valR, valG, valB;
-      const int pos = (y * w + x * 4) * 4;
-      convertYUVToRGB8Bit(valY1, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
-      dst[pos]     = valB;
-      dst[pos + 1] = valG;
-      dst[pos + 2] = valR;
-      dst[pos + 3] = 255;
-      convertYUVToRGB8Bit(
-          valY2, interpolatedU1, interpolatedV1, valR, valG, valB, RGBConv, fullRange, bps);
-      dst[pos + 4] = valB;
-      dst[pos + 5] = valG;
-      dst[pos + 6] = valR;
-      dst[pos + 7] = 255;
-      convertYUVToRGB8Bit(
-          valY3, interpolatedU2, interpolatedV2, valR, valG, valB, RGBConv, fullRange, bps);
-      dst[pos + 8]  = valB;
-      dst[pos + 9]  = valG;
-      dst[pos + 10] = valR;
-      dst[pos + 11] = 255;
-      convertYUVToRGB8Bit(
-          valY4, interpolatedU3, interpolatedV3, valR, valG, valB, RGBConv, fullRange, bps);
-      dst[pos + 12] = valB;
-      dst[pos + 13] = valG;
-      dst[pos + 14] = valR;
-      dst[pos + 15] = 255;
-
-      // The next one is now the current one
-      curUSample = nextUSample;
-      curVSample = nextVSample;
-    }
-
-    // For the last row, there is no next sample. Just reuse the current one again. No interpolation
-    // required either.
-
-    // Get the 2 Y samples
-    int valY1 = getValueFromSource(srcY, (y + 1) * w - 4, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y + 1) * w - 3, bps, bigEndian);
-    int valY3 = getValueFromSource(srcY, (y + 1) * w - 2, bps, bigEndian);
-    int valY4 = getValueFromSource(srcY, (y + 1) * w - 1, bps, bigEndian);
-    if (applyMathLuma)
-    {
-      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-      valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-      valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-    }
-
-    // Convert to 4 RGB values and save them
-    int       valR, valG, valB;
-    const int pos = ((y + 1) * w) * 4;
-    convertYUVToRGB8Bit(valY1, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
-    dst[pos - 16] = valB;
-    dst[pos - 15] = valG;
-    dst[pos - 14] = valR;
-    dst[pos - 13] = 255;
-    convertYUVToRGB8Bit(valY2, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
-    dst[pos - 12] = valB;
-    dst[pos - 11] = valG;
-    dst[pos - 10] = valR;
-    dst[pos - 9]  = 255;
-    convertYUVToRGB8Bit(valY3, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
-    dst[pos - 8] = valB;
-    dst[pos - 7] = valG;
-    dst[pos - 6] = valR;
-    dst[pos - 5] = 255;
-    convertYUVToRGB8Bit(valY4, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
-    dst[pos - 4] = valB;
-    dst[pos - 3] = valG;
-    dst[pos - 2] = valR;
-    dst[pos - 1] = 255;
-  }
-}
-
 bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &    sourceBuffer,
                                             uchar *               targetBuffer,
                                             const Size            curFrameSize,
@@ -3149,266 +1827,64 @@ bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &    sourceBuffer,
     if (format.isUVInterleaved())
       nrBytesToNextChromaPlane = (bps > 8) ? 2 : 1;
 
-    // Get/set the parameters used for YUV -> RGB conversion
-    int RGBConv[5];
-    getColorConversionCoefficients(yuvColorConversionType, RGBConv);
-
     // We are displaying all components, so we have to perform conversion to RGB (possibly including
-    // interpolation and YUV math)
-    if (format.getSubsampling() != Subsampling::YUV_400 &&
-        (format.getChromaOffset().x != 0 || format.getChromaOffset().y != 0) &&
-        chromaInterpolation != ChromaInterpolation::NearestNeighbor)
-    {
-      // If there is a chroma offset, we must resample the chroma components before we convert them
-      // to RGB. If so, the resampled chroma values are saved in these arrays. We only ignore the
-      // chroma offset for other interpolations then nearest neighbor.
-      QByteArray uvPlaneChromaResampled[2];
-      uvPlaneChromaResampled[0].resize(nrBytesChromaPlane);
-      uvPlaneChromaResampled[1].resize(nrBytesChromaPlane);
-
-      // We have to perform pre-filtering for the U and V positions, because there is an offset
-      // between the pixel positions of Y and U/V
-      unsigned char *restrict dstU = (unsigned char *)uvPlaneChromaResampled[0].data();
-      unsigned char *restrict dstV = (unsigned char *)uvPlaneChromaResampled[1].data();
-
-      unsigned char *restrict srcY = (unsigned char *)sourceBuffer.data();
-      unsigned char *restrict srcU = uPlaneFirst
-                                         ? srcY + nrBytesLumaPlane
-                                         : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
-      unsigned char *restrict srcV = uPlaneFirst
-                                         ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane
-                                         : srcY + nrBytesLumaPlane;
-
-      UVPlaneResamplingChromaOffset(format,
-                                    w / format.getSubsamplingHor(),
-                                    h / format.getSubsamplingVer(),
-                                    srcU,
-                                    srcV,
-                                    inputValSkip,
-                                    dstU,
-                                    dstV);
+    // interpolation, chroma offset re-sampling and YUV math)
+    const ConversionSettings settings{interpolation, conversion, mathY, mathC};
 
-      if (format.getSubsampling() == Subsampling::YUV_444)
-        YUVPlaneToRGB_444(componentSizeLuma,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          bps,
-                          format.isBigEndian(),
-                          1);
-      else if (format.getSubsampling() == Subsampling::YUV_422)
-        YUVPlaneToRGB_422(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          1);
-      else if (format.getSubsampling() == Subsampling::YUV_420)
-        YUVPlaneToRGB_420(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          1);
-      else if (format.getSubsampling() == Subsampling::YUV_440)
-        YUVPlaneToRGB_440(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          1);
-      else if (format.getSubsampling() == Subsampling::YUV_410)
-        YUVPlaneToRGB_410(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          1);
-      else if (format.getSubsampling() == Subsampling::YUV_411)
-        YUVPlaneToRGB_411(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          1);
-      else
-        return false;
-    }
-    else
-    {
-      // Get the pointers to the source planes (8 bit per sample)
-      const unsigned char *restrict srcY = (unsigned char *)sourceBuffer.data();
-      const unsigned char *restrict srcU = uPlaneFirst
-                                               ? srcY + nrBytesLumaPlane
-                                               : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
-      const unsigned char *restrict srcV = uPlaneFirst
-                                               ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane
-                                               : srcY + nrBytesLumaPlane;
+    // Get the pointers to the source planes
+    const unsigned char *srcY = (unsigned char *)sourceBuffer.data();
+    const unsigned char *srcU = uPlaneFirst ? srcY + nrBytesLumaPlane
+                                            : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
+    const unsigned char *srcV = uPlaneFirst ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane
+                                            : srcY + nrBytesLumaPlane;
 
-      if (format.getSubsampling() == Subsampling::YUV_444)
-        YUVPlaneToRGB_444(componentSizeLuma,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_422)
-        YUVPlaneToRGB_422(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_420)
-        YUVPlaneToRGB_420(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_440)
-        YUVPlaneToRGB_440(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_410)
-        YUVPlaneToRGB_410(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_411)
-        YUVPlaneToRGB_411(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_400)
-        YUVPlaneToRGBMonochrome_444(
-            componentSizeLuma, mathY, srcY, dst, fullRange, inputMax, bps, format.isBigEndian(), 1);
-      else
-        return false;
-    }
+    const PlanarYUVSource source{srcY, srcU, srcV, inputValSkip};
+    return convertPlanarYUVToBGRAParallel(source, format, curFrameSize, settings, dst);
   }
 
   return true;
 }
 
+bool videoHandlerYUV::convertYUVPlanesToRGB(const FrameBuffer &   sourceBuffer,
+                                            uchar *               targetBuffer,
+                                            const Size            curFrameSize,
+                                            const PixelFormatYUV &sourceBufferFormat) const
+{
+  const auto &planes = sourceBuffer.getPlanes();
+  const auto  format = sourceBufferFormat;
+
+  if (sourceBuffer.isPacked() || planes.size() < 3 || componentDisplayMode != DisplayAll ||
+      format.getSubsampling() == Subsampling::YUV_400 || format.isUVInterleaved() ||
+      planes[1].stride != planes[2].stride)
+    return convertYUVPlanarToRGB(
+        sourceBuffer.toByteArray(), targetBuffer, curFrameSize, sourceBufferFormat);
+
+  // Is the U plane the first or the second?
+  const bool uPlaneFirst =
+      (format.getPlaneOrder() == PlaneOrder::YUV || format.getPlaneOrder() == PlaneOrder::YUVA);
+
+  PlanarYUVSource source;
+  source.y       = planes[0].data;
+  source.u       = uPlaneFirst ? planes[1].data : planes[2].data;
+  source.v       = uPlaneFirst ? planes[2].data : planes[1].data;
+  source.strideY = planes[0].stride;
+  source.strideC = planes[1].stride;
+
+  const ConversionSettings settings{chromaInterpolation,
+                                    yuvColorConversionType,
+                                    mathParameters[Component::Luma],
+                                    mathParameters[Component::Chroma]};
+  return convertPlanarYUVToBGRAParallel(source, format, curFrameSize, settings, targetBuffer);
+}
+
 // Convert the given raw YUV data in sourceBuffer (using srcPixelFormat) to image (RGB-888), using
 // the buffer tmpRGBBuffer for intermediate RGB values.
-void videoHandlerYUV::convertYUVToImage(const QByteArray &    sourceBuffer,
+void videoHandlerYUV::convertYUVToImage(const FrameBuffer &   sourceBuffer,
                                         QImage &              outputImage,
                                         const PixelFormatYUV &yuvFormat,
                                         const Size &          curFrameSize)
 {
-  if (!yuvFormat.canConvertToRGB(curFrameSize) || sourceBuffer.isEmpty())
+  if (!yuvFormat.canConvertToRGB(curFrameSize) || sourceBuffer.isNull())
   {
     outputImage = QImage();
     return;
@@ -3423,15 +1899,18 @@ void videoHandlerYUV::convertYUVToImage(const QByteArray &    sourceBuffer,
   // be multiple of 4)
   auto qFrameSize          = QSize(int(curFrameSize.width), int(curFrameSize.height));
   auto platformImageFormat = functionsGui::platformImageFormat(yuvFormat.hasAlpha());
+  // The memory of the image is from the buffer pool. It goes back to the pool when the image is
+  // dropped from the cache.
+  auto &pool = getBufferPool();
   if (is_Q_OS_WIN || is_Q_OS_MAC)
-    outputImage = QImage(qFrameSize, platformImageFormat);
+    outputImage = pool.allocateImage(qFrameSize, platformImageFormat);
   else if (is_Q_OS_LINUX)
   {
     if (platformImageFormat == QImage::Format_ARGB32_Premultiplied ||
         platformImageFormat == QImage::Format_ARGB32)
-      outputImage = QImage(qFrameSize, platformImageFormat);
+      outputImage = pool.allocateImage(qFrameSize, platformImageFormat);
     else
-      outputImage = QImage(qFrameSize, QImage::Format_RGB32);
+      outputImage = pool.allocateImage(qFrameSize, QImage::Format_RGB32);
   }
 
   // Check the image buffer size before we write to it
@@ -3446,27 +1925,12 @@ void videoHandlerYUV::convertYUVToImage(const QByteArray &    sourceBuffer,
   auto convOK = false;
   if (yuvFormat.isPlanar())
   {
-    if ((yuvFormat.getBitsPerSample() == 8 || yuvFormat.getBitsPerSample() == 10) &&
-        yuvFormat.getSubsampling() == Subsampling::YUV_420 &&
-        chromaInterpolation == ChromaInterpolation::NearestNeighbor &&
-        yuvFormat.getChromaOffset().x == 0 && yuvFormat.getChromaOffset().y == 1 &&
-        componentDisplayMode == DisplayAll && !yuvFormat.isUVInterleaved() &&
-        !mathParameters[Component::Luma].mathRequired() &&
-        !mathParameters[Component::Chroma].mathRequired())
-    // 8/10 bit 4:2:0, nearest neighbor, chroma offset (0,1) (the default for 4:2:0), all components
-    // displayed and no yuv math. We can use a specialized function for this.
-    {
-      if (yuvFormat.getBitsPerSample() == 8)
-        convOK = convertYUV420ToRGB<8>(sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat);
-      else if (yuvFormat.getBitsPerSample() == 10)
-        convOK = convertYUV420ToRGB<10>(sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat);
-    }
-    else
-      convOK = convertYUVPlanarToRGB(sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat);
+    convOK = convertYUVPlanesToRGB(sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat);
   }
   else
   {
     // Convert to a planar format first
+    const auto sourceData = sourceBuffer.toByteArray();
     QByteArray tmpPlanarYUVSource;
     // This is the current format of the buffer. The conversion function will change this.
     PixelFormatYUV newPixelFormat;
@@ -3475,13 +1939,13 @@ void videoHandlerYUV::convertYUVToImage(const QByteArray &    sourceBuffer,
     {
       if (*predefinedFormat == PredefinedPixelFormat::V210)
         std::tie(convOK, newPixelFormat) =
-            convertV210PackedToPlanar(sourceBuffer, tmpPlanarYUVSource, curFrameSize);
+            convertV210PackedToPlanar(sourceData, tmpPlanarYUVSource, curFrameSize);
       else
         convOK = false;
     }
     else
       std::tie(convOK, newPixelFormat) =
-          convertYUVPackedToPlanar(sourceBuffer, tmpPlanarYUVSource, curFrameSize, yuvFormat);
+          convertYUVPackedToPlanar(sourceData, tmpPlanarYUVSource, curFrameSize, yuvFormat);
 
     if (convOK)
       convOK &= convertYUVPlanarToRGB(
@@ -3824,6 +2288,8 @@ QImage videoHandlerYUV::calculateDifference(FrameHandler *   item2,
     return QImage(); // Loading failed
   if (!yuvItem2->loadRawYUVData(frameIdxItem1))
     return QImage(); // Loading failed
+  this->packCurrentFrameRawData();
+  yuvItem2->packCurrentFrameRawData();
 
   // Both YUV buffers are up to date. Really calculate the difference.
   DEBUG_YUV("videoHandlerYUV::calculateDifference frame idx item 0 "
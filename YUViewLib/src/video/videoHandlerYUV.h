@@ -127,6 +127,10 @@ public:
   {
     return QString::fromStdString(srcPixelFormat.getName());
   }
+  yuv::PixelFormatYUV getPixelFormatYUV() const { return this->srcPixelFormat; }
+  // Convert raw data of a frame (e.g. from loadRawFrame) to an image like loadFrameImage does. This
+  // way, a frame that is needed as raw data and as an image only has to be loaded once.
+  QImage convertRawFrame(const FrameBuffer &rawData);
   // Set the current YUV format and update the control. Only emit a signalHandlerChanged signal
   // if emitSignal is true.
   virtual void setPixelFormatYUV(const yuv::PixelFormatYUV &fmt, bool emitSignal = false);
@@ -207,14 +211,35 @@ protected:
   // Load the given frame and return it for caching. The current buffers (currentFrameRawYUVData and
   // currentFrame) will not be modified.
   virtual void loadFrameForCaching(int frameIndex, QImage &frameToCache) override;
+  // The frame is decoded (loaded) in one caching task and converted in another one. This way, the
+  // next frame can be decoded while the conversion is running.
+  virtual bool                    supportsStagedCaching() const override { return true; }
+  virtual std::function<QImage()> loadFrameForStagedCaching(int frameIndex) override;
+
+  // The raw YUV data can be cached instead of the RGB images. The cached raw data is used by
+  // loadRawYUVData and converted when the frame is loaded for drawing.
+  virtual bool     supportsRawDataCaching() const override { return true; }
+  virtual bool     loadRawDataForCaching(int frameIndex, QByteArray &rawDataToCache) override;
+  virtual unsigned getRawDataElementSize() const override;
 
 private:
   // Load the raw YUV data for the given frame index into currentFrameRawYUVData.
   // Return false is loading failed.
   bool loadRawYUVData(int frameIndex);
 
+  // The raw data of the current frame as it was handed over by the source. This may point to the
+  // buffers of a decoder. The packed currentFrameRawData is only created from it when the values of
+  // single pixels are needed (packCurrentFrameRawData).
+  FrameBuffer currentFrameBuffer;
+  void        setCurrentFrameBuffer(const FrameBuffer &frameBuffer, int frameIndex);
+  void        packCurrentFrameRawData();
+
+  // Get the raw data of the given frame for caching (from the compressed cache if possible). The
+  // frame buffer may point to the buffers of a decoder.
+  bool loadFrameBufferForCaching(int frameIndex, FrameBuffer &frameBuffer);
+
   // Convert from YUV (which ever format is selected) to image (RGB-888)
-  void convertYUVToImage(const QByteArray &         sourceBuffer,
+  void convertYUVToImage(const FrameBuffer &        sourceBuffer,
                          QImage &                   outputImage,
                          const yuv::PixelFormatYUV &yuvFormat,
                          const Size &               curFrameSize);
@@ -235,23 +260,18 @@ private:
                              unsigned char *            targetBuffer,
                              const Size                 frameSize,
                              const yuv::PixelFormatYUV &sourceBufferFormat) const;
+  // Convert the planes of the frame buffer using their strides (without packing them first). Only
+  // the plain conversion of all components is supported like this. For everything else, the packed
+  // data is converted using convertYUVPlanarToRGB.
+  bool convertYUVPlanesToRGB(const FrameBuffer &        sourceBuffer,
+                             unsigned char *            targetBuffer,
+                             const Size                 frameSize,
+                             const yuv::PixelFormatYUV &sourceBufferFormat) const;
   bool markDifferencesYUVPlanarToRGB(const QByteArray &         sourceBuffer,
                                      unsigned char *            targetBuffer,
                                      const Size                 frameSize,
                                      const yuv::PixelFormatYUV &sourceBufferFormat) const;
 
-#if SSE_CONVERSION_420_ALT
-  void yuv420_to_argb8888(quint8 *yp,
-                          quint8 *up,
-                          quint8 *vp,
-                          quint32 sy,
-                          quint32 suv,
-                          int     width,
-                          int     height,
-                          quint8 *rgb,
-                          quint32 srgb);
-#endif
-
   SafeUi<Ui::videoHandlerYUV> ui;
 
   bool                diffReady{};
@@ -0,0 +1,84 @@
+#include <QtTest>
+
+#include <common/StartCodeSearch.h>
+
+#include <random>
+
+class StartCodeSearchTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  StartCodeSearchTest(){};
+  ~StartCodeSearchTest(){};
+
+private slots:
+  void testFindStartCode_data();
+  void testFindStartCode();
+  void testSIMDMatchesScalar();
+};
+
+using functions::SIMDInstructionSet;
+
+void StartCodeSearchTest::testFindStartCode_data()
+{
+  QTest::addColumn<QByteArray>("data");
+  QTest::addColumn<int>("offset");
+  QTest::addColumn<int>("expectedPosition");
+
+  const auto filler = QByteArray(100, char(0x80));
+
+  QTest::newRow("empty") << QByteArray() << 0 << -1;
+  QTest::newRow("noStartCode") << filler << 0 << -1;
+  QTest::newRow("startCodeAtStart") << (QByteArrayLiteral("\x00\x00\x01") + filler) << 0 << 0;
+  QTest::newRow("startCodeAtEnd") << (filler + QByteArrayLiteral("\x00\x00\x01")) << 0 << 100;
+  QTest::newRow("startCodeCutAtEnd") << (filler + QByteArrayLiteral("\x00\x00")) << 0 << -1;
+  QTest::newRow("fourByteStartCode")
+      << (filler + QByteArrayLiteral("\x00\x00\x00\x01") + filler) << 0 << 101;
+  QTest::newRow("zerosWithoutOne")
+      << (filler + QByteArrayLiteral("\x00\x00\x02\x00\x00\x00\x03") + filler) << 0 << -1;
+  QTest::newRow("offsetAfterStartCode")
+      << (QByteArrayLiteral("\x00\x00\x01") + filler + QByteArrayLiteral("\x00\x00\x01")) << 1
+      << 103;
+}
+
+void StartCodeSearchTest::testFindStartCode()
+{
+  QFETCH(QByteArray, data);
+  QFETCH(int, offset);
+  QFETCH(int, expectedPosition);
+
+  for (auto instructionSet : functions::getSupportedSIMDInstructionSets())
+  {
+    const auto position =
+        functions::findStartCode(data.constData(), data.size(), offset, instructionSet);
+    QCOMPARE(position, int64_t(expectedPosition));
+  }
+}
+
+void StartCodeSearchTest::testSIMDMatchesScalar()
+{
+  // Random data with many zero and one bytes so that all kinds of partial start codes occur at
+  // all positions within the vectors
+  std::mt19937 generator(42);
+  for (int i = 0; i < 2000; i++)
+  {
+    QByteArray data(int(generator() % 200), char(0));
+    for (auto &byte : data)
+    {
+      const auto r = generator() % 8;
+      byte         = (r < 3) ? char(0) : (r < 5) ? char(1) : char(generator());
+    }
+    const auto offset = int64_t(generator() % (data.size() + 1));
+
+    const auto reference =
+        functions::findStartCode(data.constData(), data.size(), offset, SIMDInstructionSet::None);
+    for (auto instructionSet : functions::getSupportedSIMDInstructionSets())
+      QCOMPARE(functions::findStartCode(data.constData(), data.size(), offset, instructionSet),
+               reference);
+  }
+}
+
+QTEST_MAIN(StartCodeSearchTest)
+
+#include "StartCodeSearchTest.moc"
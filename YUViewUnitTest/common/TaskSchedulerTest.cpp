@@ -0,0 +1,194 @@
+#include <QtTest>
+
+#include <common/TaskScheduler.h>
+
+#include <atomic>
+
+class TaskSchedulerTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  TaskSchedulerTest(){};
+  ~TaskSchedulerTest(){};
+
+private slots:
+  void testAllTasksInvoked();
+  void testPriorities();
+  void testCancel();
+  void testInteractiveNotBlocked();
+  void testWorkStealing();
+  void testChangeNrThreads();
+};
+
+namespace
+{
+
+using Priority = TaskScheduler::Priority;
+using Token    = TaskScheduler::CancellationToken;
+
+// Occupy the only background worker until release is set
+void blockWorker(TaskScheduler &scheduler, std::atomic_bool &running, std::atomic_bool &release)
+{
+  scheduler.submit(Priority::Background, nullptr, [&running, &release](const Token &) {
+    running = true;
+    while (!release)
+      QThread::msleep(1);
+  });
+  while (!running)
+    QThread::msleep(1);
+}
+
+} // namespace
+
+void TaskSchedulerTest::testAllTasksInvoked()
+{
+  TaskScheduler   scheduler(3);
+  std::atomic_int counter{0};
+  for (int i = 0; i < 100; i++)
+  {
+    const auto priority = Priority(i % 3);
+    scheduler.submit(priority, nullptr, [&counter](const Token &) { counter++; });
+  }
+  scheduler.waitForAll();
+  QCOMPARE(counter.load(), 100);
+
+  const auto status = scheduler.getStatus();
+  QCOMPARE(status.nrThreads, 3);
+  QCOMPARE(status.nrRunning, 0);
+  QCOMPARE(status.nrQueued, 0);
+}
+
+void TaskSchedulerTest::testPriorities()
+{
+  TaskScheduler    scheduler(1);
+  std::atomic_bool running{false};
+  std::atomic_bool release{false};
+  blockWorker(scheduler, running, release);
+
+  QMutex     orderMutex;
+  QList<int> order;
+  auto       addTask = [&](Priority priority, int id) {
+    scheduler.submit(priority, nullptr, [&orderMutex, &order, id](const Token &) {
+      QMutexLocker locker(&orderMutex);
+      order.append(id);
+    });
+  };
+  addTask(Priority::Background, 2);
+  addTask(Priority::Background, 3);
+  addTask(Priority::NextFrames, 1);
+
+  release = true;
+  scheduler.waitForAll();
+  QCOMPARE(order, QList<int>({1, 2, 3}));
+}
+
+void TaskSchedulerTest::testCancel()
+{
+  TaskScheduler    scheduler(1);
+  std::atomic_bool running{false};
+  std::atomic_bool release{false};
+  blockWorker(scheduler, running, release);
+
+  const int       groupA = 0;
+  const int       groupB = 0;
+  std::atomic_int invoked{0};
+  std::atomic_int workDoneA{0};
+  std::atomic_int workDoneB{0};
+  for (int i = 0; i < 5; i++)
+  {
+    scheduler.submit(Priority::Background, &groupA, [&](const Token &token) {
+      invoked++;
+      if (!token.isCanceled())
+        workDoneA++;
+    });
+    scheduler.submit(Priority::Background, &groupB, [&](const Token &token) {
+      invoked++;
+      if (!token.isCanceled())
+        workDoneB++;
+    });
+  }
+  scheduler.cancel(&groupA);
+
+  // Tasks submitted after canceling are not affected
+  scheduler.submit(Priority::Background, &groupA, [&](const Token &token) {
+    invoked++;
+    if (!token.isCanceled())
+      workDoneA++;
+  });
+
+  release = true;
+  scheduler.waitForAll();
+  QCOMPARE(invoked.load(), 11);
+  QCOMPARE(workDoneA.load(), 1);
+  QCOMPARE(workDoneB.load(), 5);
+}
+
+void TaskSchedulerTest::testInteractiveNotBlocked()
+{
+  TaskScheduler    scheduler(1);
+  std::atomic_bool running{false};
+  std::atomic_bool release{false};
+  blockWorker(scheduler, running, release);
+
+  std::atomic_bool interactiveDone{false};
+  scheduler.submit(Priority::Interactive, nullptr, [&interactiveDone](const Token &) {
+    interactiveDone = true;
+  });
+
+  for (int i = 0; i < 5000 && !interactiveDone; i++)
+    QThread::msleep(1);
+  QVERIFY(interactiveDone);
+
+  release = true;
+  scheduler.waitForAll();
+}
+
+void TaskSchedulerTest::testWorkStealing()
+{
+  TaskScheduler   scheduler(4);
+  std::atomic_int counter{0};
+
+  // Tasks submitted from a worker are queued at that worker. The other workers have to steal them.
+  scheduler.submit(Priority::Background, nullptr, [&scheduler, &counter](const Token &) {
+    for (int i = 0; i < 20; i++)
+      scheduler.submit(Priority::Background, nullptr, [&counter](const Token &) {
+        QThread::msleep(2);
+        counter++;
+      });
+    QThread::msleep(50);
+  });
+
+  scheduler.waitForAll();
+  QCOMPARE(counter.load(), 20);
+  QVERIFY(scheduler.getStatus().nrStolen > 0);
+}
+
+void TaskSchedulerTest::testChangeNrThreads()
+{
+  TaskScheduler   scheduler(4);
+  std::atomic_int counter{0};
+  for (int i = 0; i < 50; i++)
+    scheduler.submit(Priority::Background, nullptr, [&counter](const Token &) {
+      QThread::msleep(1);
+      counter++;
+    });
+
+  scheduler.setNrThreads(1);
+  QCOMPARE(scheduler.getNrThreads(), 1);
+  scheduler.setNrThreads(0);
+  QCOMPARE(scheduler.getNrThreads(), 0);
+
+  // Without background threads, the interactive threads run everything
+  scheduler.waitForAll();
+  QCOMPARE(counter.load(), 50);
+
+  scheduler.setNrThreads(2);
+  scheduler.submit(Priority::NextFrames, nullptr, [&counter](const Token &) { counter++; });
+  scheduler.waitForAll();
+  QCOMPARE(counter.load(), 51);
+}
+
+QTEST_MAIN(TaskSchedulerTest)
+
+#include "TaskSchedulerTest.moc"
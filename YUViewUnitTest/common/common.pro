@@ -0,0 +1,6 @@
+TEMPLATE = subdirs
+
+requires(qtHaveModule(testlib))
+
+SUBDIRS = TaskSchedulerTest.pro
+SUBDIRS += StartCodeSearchTest.pro
@@ -0,0 +1,146 @@
+#include <QTemporaryDir>
+#include <QTemporaryFile>
+#include <QtTest>
+
+#include <filesource/FileIndex.h>
+
+class FileIndexTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  FileIndexTest(){};
+  ~FileIndexTest(){};
+
+private slots:
+  void initTestCase();
+  void testSaveAndLoad();
+  void testTypeMismatch();
+  void testModifiedFile();
+  void testCorruptIndex();
+
+private:
+  QTemporaryDir indexDirectory;
+};
+
+namespace
+{
+
+FileIndex createTestIndex()
+{
+  FileIndex index;
+  for (int i = 0; i < 100; i++)
+  {
+    FileIndex::Frame frame;
+    frame.timestamp         = i * 2;
+    frame.randomAccessPoint = (i % 10 == 0);
+    if (i % 3 != 0)
+      frame.fileStartEndPos = pairUint64(i * 1000, i * 1000 + 999);
+    index.frames.push_back(frame);
+  }
+
+  const auto parameterSet0 = index.addParameterSet({0x40, 0x01, 0x0c});
+  const auto parameterSet1 = index.addParameterSet({0x42, 0x01, 0x01, 0x01});
+
+  for (unsigned i = 0; i < 100; i += 10)
+  {
+    FileIndex::SeekPoint seekPoint;
+    seekPoint.frameIndex    = i;
+    seekPoint.filePos       = i * 1000;
+    seekPoint.parameterSets = {parameterSet0, parameterSet1};
+    index.seekPoints.push_back(seekPoint);
+  }
+
+  index.properties["frameRate"] = 50.0;
+  index.properties["width"]     = 1920;
+  return index;
+}
+
+void writeTestFile(QTemporaryFile &file, char value)
+{
+  QVERIFY(file.open());
+  file.write(QByteArray(200000, value));
+  file.flush();
+}
+
+} // namespace
+
+void FileIndexTest::initTestCase()
+{
+  QVERIFY(this->indexDirectory.isValid());
+  FileIndex::setIndexDirectory(this->indexDirectory.path());
+}
+
+void FileIndexTest::testSaveAndLoad()
+{
+  QTemporaryFile file;
+  writeTestFile(file, 1);
+
+  auto index = createTestIndex();
+  // Parameter sets are only saved once
+  QCOMPARE(index.addParameterSet({0x40, 0x01, 0x0c}), 0u);
+  QCOMPARE(index.parameterSets.size(), size_t(2));
+  QVERIFY(index.save(file.fileName(), "HEVC"));
+
+  const auto loaded = FileIndex::load(file.fileName(), "HEVC");
+  QVERIFY(loaded);
+  QCOMPARE(loaded->frames.size(), index.frames.size());
+  for (size_t i = 0; i < index.frames.size(); i++)
+  {
+    QCOMPARE(loaded->frames[i].timestamp, index.frames[i].timestamp);
+    QCOMPARE(loaded->frames[i].randomAccessPoint, index.frames[i].randomAccessPoint);
+    QCOMPARE(loaded->frames[i].fileStartEndPos, index.frames[i].fileStartEndPos);
+  }
+  QCOMPARE(loaded->parameterSets, index.parameterSets);
+  QCOMPARE(loaded->seekPoints.size(), index.seekPoints.size());
+  for (size_t i = 0; i < index.seekPoints.size(); i++)
+  {
+    QCOMPARE(loaded->seekPoints[i].frameIndex, index.seekPoints[i].frameIndex);
+    QCOMPARE(loaded->seekPoints[i].filePos, index.seekPoints[i].filePos);
+    QCOMPARE(loaded->seekPoints[i].parameterSets, index.seekPoints[i].parameterSets);
+  }
+  QCOMPARE(loaded->properties, index.properties);
+}
+
+void FileIndexTest::testTypeMismatch()
+{
+  QTemporaryFile file;
+  writeTestFile(file, 2);
+
+  QVERIFY(createTestIndex().save(file.fileName(), "HEVC"));
+  QVERIFY(!FileIndex::load(file.fileName(), "AVC"));
+}
+
+void FileIndexTest::testModifiedFile()
+{
+  QTemporaryFile file;
+  writeTestFile(file, 3);
+  QVERIFY(createTestIndex().save(file.fileName(), "HEVC"));
+
+  // Change the last byte. The size stays the same.
+  file.seek(file.size() - 1);
+  file.write(QByteArray(1, 4));
+  file.flush();
+  QVERIFY(!FileIndex::load(file.fileName(), "HEVC"));
+}
+
+void FileIndexTest::testCorruptIndex()
+{
+  QTemporaryFile file;
+  writeTestFile(file, 5);
+  QVERIFY(createTestIndex().save(file.fileName(), "HEVC"));
+
+  // Cut all index files in half
+  QDir directory(this->indexDirectory.path());
+  for (const auto &indexFileName : directory.entryList(QDir::Files))
+  {
+    QFile indexFile(directory.filePath(indexFileName));
+    QVERIFY(indexFile.open(QIODevice::ReadWrite));
+    QVERIFY(indexFile.resize(indexFile.size() / 2));
+  }
+  QVERIFY(!FileIndex::load(file.fileName(), "HEVC"));
+}
+
+QTEST_MAIN(FileIndexTest)
+
+#include "tst_FileIndex.moc"
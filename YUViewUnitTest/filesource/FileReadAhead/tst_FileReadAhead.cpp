@@ -0,0 +1,114 @@
+#include <QTemporaryFile>
+#include <QtTest>
+
+#include <filesource/FileReadAhead.h>
+
+class FileReadAheadTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  FileReadAheadTest(){};
+  ~FileReadAheadTest(){};
+
+private slots:
+  void testReadPrefetched();
+  void testNotPrefetched();
+  void testEndOfFile();
+  void testClear();
+};
+
+namespace
+{
+
+QByteArray createContent(int size)
+{
+  QByteArray content;
+  for (int i = 0; i < size; i++)
+    content.append(char(i * 7));
+  return content;
+}
+
+} // namespace
+
+void FileReadAheadTest::testReadPrefetched()
+{
+  const auto     content = createContent(100000);
+  QTemporaryFile tempFile;
+  QVERIFY(tempFile.open());
+  tempFile.write(content);
+  tempFile.flush();
+
+  FileReadAhead readAhead(tempFile.fileName());
+  QVERIFY(readAhead.isOk());
+
+  readAhead.prefetch(1000, 5000);
+  readAhead.prefetch(6000, 5000);
+  // Give the I/O thread some time to read the data
+  QThread::msleep(200);
+
+  QByteArray target(5000, 0);
+  QCOMPARE(readAhead.read(target.data(), 1000, 5000), int64_t(5000));
+  QCOMPARE(target, content.mid(1000, 5000));
+  // Parts of a prefetched range can be read as well
+  QCOMPARE(readAhead.read(target.data(), 7000, 1000), int64_t(1000));
+  QCOMPARE(target.left(1000), content.mid(7000, 1000));
+
+  QCOMPARE(readAhead.getStatistics().nrHits, int64_t(2));
+  QCOMPARE(readAhead.getStatistics().nrMisses, int64_t(0));
+}
+
+void FileReadAheadTest::testNotPrefetched()
+{
+  QTemporaryFile tempFile;
+  QVERIFY(tempFile.open());
+  tempFile.write(createContent(10000));
+  tempFile.flush();
+
+  FileReadAhead readAhead(tempFile.fileName());
+  QByteArray    target(1000, 0);
+  QCOMPARE(readAhead.read(target.data(), 0, 1000), int64_t(-1));
+
+  // A range that reaches beyond the prefetched range must be read by the caller
+  readAhead.prefetch(0, 500);
+  QThread::msleep(200);
+  QCOMPARE(readAhead.read(target.data(), 0, 1000), int64_t(-1));
+  QCOMPARE(readAhead.getStatistics().nrMisses, int64_t(2));
+}
+
+void FileReadAheadTest::testEndOfFile()
+{
+  const auto     content = createContent(10000);
+  QTemporaryFile tempFile;
+  QVERIFY(tempFile.open());
+  tempFile.write(content);
+  tempFile.flush();
+
+  FileReadAhead readAhead(tempFile.fileName());
+  readAhead.prefetch(9000, 5000);
+  QThread::msleep(200);
+
+  QByteArray target(5000, 0);
+  QCOMPARE(readAhead.read(target.data(), 9000, 5000), int64_t(1000));
+  QCOMPARE(target.left(1000), content.mid(9000));
+}
+
+void FileReadAheadTest::testClear()
+{
+  QTemporaryFile tempFile;
+  QVERIFY(tempFile.open());
+  tempFile.write(createContent(10000));
+  tempFile.flush();
+
+  FileReadAhead readAhead(tempFile.fileName(), 2);
+  readAhead.prefetch(0, 1000);
+  QThread::msleep(200);
+  readAhead.clear();
+
+  QByteArray target(1000, 0);
+  QCOMPARE(readAhead.read(target.data(), 0, 1000), int64_t(-1));
+}
+
+QTEST_MAIN(FileReadAheadTest)
+
+#include "tst_FileReadAhead.moc"
@@ -13,6 +13,7 @@ public:
 private slots:
   void testFormatFromFilename_data();
   void testFormatFromFilename();
+  void testMemoryMappedRead();
 };
 
 FileSourceTest::FileSourceTest()
@@ -174,6 +175,43 @@ void FileSourceTest::testFormatFromFilename()
   QCOMPARE(fileFormat.packed, packed);
 }
 
+void FileSourceTest::testMemoryMappedRead()
+{
+  QTemporaryFile tempFile;
+  QVERIFY(tempFile.open());
+  QByteArray content;
+  for (int i = 0; i < 1000; i++)
+    content.append(char(i % 256));
+  tempFile.write(content);
+  tempFile.flush();
+
+  FileSource file;
+  file.enableMemoryMapping();
+  QVERIFY(file.openFile(tempFile.fileName()));
+  QVERIFY(file.isMemoryMapped());
+
+  QByteArray mapped;
+  QCOMPARE(file.readBytesZeroCopy(mapped, 100, 200), int64_t(200));
+  QCOMPARE(mapped, content.mid(100, 200));
+
+  QByteArray copied;
+  QCOMPARE(file.readBytes(copied, 100, 200), int64_t(200));
+  QCOMPARE(copied.left(200), mapped);
+
+  // Writing to the buffer must not change the mapped file
+  mapped[0] = char(0xff);
+  QByteArray mappedAgain;
+  file.readBytesZeroCopy(mappedAgain, 100, 1);
+  QCOMPARE(mappedAgain.at(0), content.at(100));
+
+  // Data that is not mapped is read from the file
+  QByteArray pastEnd;
+  QCOMPARE(file.readBytesZeroCopy(pastEnd, 900, 200), int64_t(100));
+
+  file.adviseReadAhead(0, 500, false);
+  file.adviseReadAhead(500, 500, true);
+}
+
 QTEST_MAIN(FileSourceTest)
 
 #include "tst_Filesource.moc"
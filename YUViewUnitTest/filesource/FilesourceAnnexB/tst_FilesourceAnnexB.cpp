@@ -52,6 +52,13 @@ void FileSourceAnnexBTest::testNalUnitParsing_data()
   QTest::newRow("testBufferEdge5") << 3u << 800000u << QList<unsigned>({80, 208, 500, 50000, 500001});
   QTest::newRow("testBufferEdge6") << 3u << 800000u << QList<unsigned>({80, 208, 500, 50000, 500002});
 
+  // The same with 4 byte start codes (0x00000001)
+  QTest::newRow("testBufferEdge4Byte1") << 4u << 800000u << QList<unsigned>({80, 208, 500, 50000, 499996});
+  QTest::newRow("testBufferEdge4Byte2") << 4u << 800000u << QList<unsigned>({80, 208, 500, 50000, 499997});
+  QTest::newRow("testBufferEdge4Byte3") << 4u << 800000u << QList<unsigned>({80, 208, 500, 50000, 499998});
+  QTest::newRow("testBufferEdge4Byte4") << 4u << 800000u << QList<unsigned>({80, 208, 500, 50000, 499999});
+  QTest::newRow("testBufferEdge4Byte5") << 4u << 800000u << QList<unsigned>({80, 208, 500, 50000, 500000});
+
   QTest::newRow("testBufferEnd1") << 3u << 10000u << QList<unsigned>({80, 208, 500, 9995});
   QTest::newRow("testBufferEnd2") << 3u << 10000u << QList<unsigned>({80, 208, 500, 9996});
   QTest::newRow("testBufferEnd3") << 3u << 10000u << QList<unsigned>({80, 208, 500, 9997});
@@ -1,4 +1,6 @@
 TEMPLATE = subdirs
 
 SUBDIRS = Filesource
-SUBDIRS += FilesourceAnnexB
\ No newline at end of file
+SUBDIRS += FilesourceAnnexB
+SUBDIRS += FileReadAhead
+SUBDIRS += FileIndex
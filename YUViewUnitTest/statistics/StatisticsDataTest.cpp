@@ -0,0 +1,209 @@
+#include <QtTest>
+
+#include "statistics/StatisticsData.h"
+
+namespace
+{
+
+constexpr int TYPE_ID = 1;
+
+// Create the data of one frame with one type. The value of all blocks is the frame index so that
+// the frame can be identified.
+stats::FrameTypeDataMap createFrameData(int frameIndex)
+{
+  stats::FrameTypeDataMap frameData;
+  auto &                  typeData = frameData[TYPE_ID];
+  for (unsigned short i = 0; i < 16; i++)
+    typeData.addBlockValue(i * 8, 0, 8, 8, frameIndex);
+  return frameData;
+}
+
+size_t getFrameMemorySize() { return createFrameData(0)[TYPE_ID].getMemorySize(); }
+
+void checkCurrentFrame(stats::StatisticsData &data, int frameIndex)
+{
+  QCOMPARE(data.getFrameIndex(), frameIndex);
+  QVERIFY(data.hasDataForTypeID(TYPE_ID));
+  const auto &valueData = data[TYPE_ID].valueData;
+  QCOMPARE(valueData.size(), size_t(16));
+  for (auto value : valueData.value)
+    QCOMPARE(value, frameIndex);
+}
+
+void addType(stats::StatisticsData &data)
+{
+  stats::StatisticsType type(TYPE_ID, "Value");
+  type.render = true;
+  data.addStatType(type);
+}
+
+} // namespace
+
+class StatisticsDataTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  StatisticsDataTest(){};
+  ~StatisticsDataTest(){};
+
+private slots:
+  void testFrameIsKeptInCache();
+  void testCachePrefetchedFrames();
+  void testCacheSizeLimit();
+  void testDiscardCurrentFrame();
+  void testVectorsAndLines();
+};
+
+void StatisticsDataTest::testFrameIsKeptInCache()
+{
+  stats::StatisticsData data;
+  addType(data);
+
+  data.setFrameIndex(0);
+  QVERIFY(data.cacheFrame(0, createFrameData(0)));
+  checkCurrentFrame(data, 0);
+  QCOMPARE(data.getCacheSize(), size_t(0));
+
+  // Going to the next frame keeps the data of the previous one
+  data.setFrameIndex(1);
+  QVERIFY(!data.hasDataForTypeID(TYPE_ID));
+  QVERIFY(data.isFrameCached(0));
+  QCOMPARE(data.getCacheSize(), getFrameMemorySize());
+  QCOMPARE(data.getTypesThatNeedLoading(0).size(), size_t(0));
+  QCOMPARE(data.getTypesThatNeedLoading(1), std::vector<int>({TYPE_ID}));
+
+  // Going back takes the data from the cache
+  data.setFrameIndex(0);
+  checkCurrentFrame(data, 0);
+  QVERIFY(!data.isFrameCached(0));
+  QCOMPARE(data.getCacheSize(), size_t(0));
+
+  data.clear();
+  QVERIFY(!data.isFrameCached(0));
+  QCOMPARE(data.getFrameIndex(), -1);
+}
+
+void StatisticsDataTest::testCachePrefetchedFrames()
+{
+  stats::StatisticsData data;
+  addType(data);
+  data.setFrameIndex(0);
+
+  // Prefetch the following frames (like the prefetcher does)
+  stats::StatisticsData prefetchData;
+  for (int frameIndex = 1; frameIndex <= 3; frameIndex++)
+  {
+    prefetchData.setFrameIndex(frameIndex);
+    prefetchData.cacheFrame(frameIndex, createFrameData(frameIndex));
+    QVERIFY(data.cacheFrame(frameIndex, prefetchData.takeFrameData()));
+    QCOMPARE(prefetchData.getFrameIndex(), -1);
+    QVERIFY(!prefetchData.hasDataForTypeID(TYPE_ID));
+  }
+  QCOMPARE(data.getCacheSize(), 3 * getFrameMemorySize());
+
+  for (int frameIndex = 1; frameIndex <= 3; frameIndex++)
+  {
+    QVERIFY(data.isFrameCached(frameIndex));
+    data.setFrameIndex(frameIndex);
+    checkCurrentFrame(data, frameIndex);
+  }
+}
+
+void StatisticsDataTest::testCacheSizeLimit()
+{
+  stats::StatisticsData data;
+  addType(data);
+  data.setCacheSizeLimit(2 * getFrameMemorySize());
+  data.setFrameIndex(10);
+
+  QVERIFY(data.cacheFrame(11, createFrameData(11)));
+  QVERIFY(data.cacheFrame(12, createFrameData(12)));
+  // The cache is full. Frame 13 is further ahead than the cached frames.
+  QVERIFY(!data.cacheFrame(13, createFrameData(13)));
+  QVERIFY(!data.isFrameCached(13));
+
+  // The previous frame 10 is cached now. It is behind the current frame and is dropped first.
+  data.cacheFrame(10, createFrameData(10));
+  data.setFrameIndex(11);
+  checkCurrentFrame(data, 11);
+  QVERIFY(data.isFrameCached(10));
+  QVERIFY(data.isFrameCached(12));
+  QVERIFY(data.cacheFrame(13, createFrameData(13)));
+  QVERIFY(!data.isFrameCached(10));
+  QVERIFY(data.isFrameCached(12));
+  QVERIFY(data.isFrameCached(13));
+  QCOMPARE(data.getCacheSize(), 2 * getFrameMemorySize());
+
+  // Reducing the limit drops the furthest frame
+  data.setCacheSizeLimit(getFrameMemorySize());
+  QVERIFY(data.isFrameCached(12));
+  QVERIFY(!data.isFrameCached(13));
+
+  data.setCacheSizeLimit(0);
+  QVERIFY(!data.isFrameCached(12));
+  QCOMPARE(data.getCacheSize(), size_t(0));
+  QVERIFY(!data.cacheFrame(12, createFrameData(12)));
+}
+
+void StatisticsDataTest::testDiscardCurrentFrame()
+{
+  stats::StatisticsData data;
+  addType(data);
+
+  data.setFrameIndex(5);
+  data.cacheFrame(5, createFrameData(5));
+  data.setFrameIndex(-1);
+  QVERIFY(!data.isFrameCached(5));
+  QCOMPARE(data.getTypesThatNeedLoading(5), std::vector<int>({TYPE_ID}));
+
+  // Invalidate a cached frame
+  data.setFrameIndex(5);
+  data.cacheFrame(5, createFrameData(5));
+  data.setFrameIndex(6);
+  QVERIFY(data.isFrameCached(5));
+  data.eraseCachedFrame(5);
+  QVERIFY(!data.isFrameCached(5));
+  QCOMPARE(data.getCacheSize(), size_t(0));
+}
+
+void StatisticsDataTest::testVectorsAndLines()
+{
+  stats::FrameTypeData typeData;
+  typeData.addBlockVector(0, 0, 8, 8, 4, -4);
+  typeData.addLine(8, 0, 8, 8, 0, 0, 8, 8);
+  typeData.addBlockVector(16, 0, 8, 8, -2, 2);
+  typeData.addLine(24, 0, 8, 8, 8, 0, 0, 8);
+
+  // The second point is only stored for the lines
+  const auto &vectors = typeData.vectorData;
+  QCOMPARE(vectors.size(), size_t(4));
+  QCOMPARE(vectors.lineIndices, std::vector<uint32_t>({1, 3}));
+  QCOMPARE(vectors.lineEndX, std::vector<int32_t>({8, 0}));
+  QCOMPARE(vectors.lineEndY, std::vector<int32_t>({8, 8}));
+  QCOMPARE(vectors.getLineIndex(0), -1);
+  QCOMPARE(vectors.getLineIndex(1), 0);
+  QCOMPARE(vectors.getLineIndex(2), -1);
+  QCOMPARE(vectors.getLineIndex(3), 1);
+  QVERIFY(vectors.getPoint(2) == stats::Point(-2, 2));
+  QVERIFY(vectors.getPoint(3) == stats::Point(8, 0));
+
+  stats::StatisticsData data;
+  stats::StatisticsType type(TYPE_ID, "Vector", 2);
+  type.render = true;
+  data.addStatType(type);
+  data.setFrameIndex(0);
+  stats::FrameTypeDataMap frameData;
+  frameData[TYPE_ID] = typeData;
+  data.cacheFrame(0, std::move(frameData));
+
+  // Vectors are scaled. For lines, the difference between the points is shown.
+  QCOMPARE(data.getValuesAt(QPoint(2, 2)),
+           QStringPairList({{"Vector[x]", "2"}, {"Vector[y]", "-2"}}));
+  QCOMPARE(data.getValuesAt(QPoint(26, 2)),
+           QStringPairList({{"Vector[x]", "-4"}, {"Vector[y]", "4"}}));
+}
+
+QTEST_MAIN(StatisticsDataTest)
+
+#include "StatisticsDataTest.moc"
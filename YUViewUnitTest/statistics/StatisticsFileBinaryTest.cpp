@@ -0,0 +1,315 @@
+#include <QtTest>
+
+#include "common/TemporaryFile.h"
+#include "statistics/StatisticsData.h"
+#include "statistics/StatisticsFileBinary.h"
+#include "statistics/StatisticsFileCSV.h"
+#include "statistics/StatisticsFileVTMBMS.h"
+
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+
+void writeFile(const TemporaryFile &file, const std::string &content)
+{
+  std::ofstream o(file.getFilename());
+  o << content;
+}
+
+// Load all types of the POC. Interleaved CSV files load all types of a POC at once.
+void loadAllTypes(stats::StatisticsFileBase &file, stats::StatisticsData &data, int poc)
+{
+  data.setFrameIndex(-1);
+  for (const auto &type : data.getStatisticsTypes())
+    if (!data.hasDataForTypeID(type.typeID))
+      file.loadStatisticData(data, poc, type.typeID);
+}
+
+void compareTypes(stats::StatisticsData &data, stats::StatisticsData &checkData)
+{
+  QCOMPARE(data.getFrameSize(), checkData.getFrameSize());
+
+  const auto &types      = data.getStatisticsTypes();
+  const auto &checkTypes = checkData.getStatisticsTypes();
+  QCOMPARE(types.size(), checkTypes.size());
+  for (unsigned i = 0; i < types.size(); i++)
+  {
+    const auto &t   = types[i];
+    const auto &chk = checkTypes[i];
+    QCOMPARE(t.typeID, chk.typeID);
+    QCOMPARE(t.typeName, chk.typeName);
+    QCOMPARE(t.description, chk.description);
+    QCOMPARE(t.render, chk.render);
+    QCOMPARE(t.hasValueData, chk.hasValueData);
+    QCOMPARE(t.hasVectorData, chk.hasVectorData);
+    QCOMPARE(t.hasAffineTFData, chk.hasAffineTFData);
+    QCOMPARE(t.isPolygon, chk.isPolygon);
+    QCOMPARE(t.colorMapper.mappingType, chk.colorMapper.mappingType);
+    QCOMPARE(t.colorMapper.rangeMin, chk.colorMapper.rangeMin);
+    QCOMPARE(t.colorMapper.rangeMax, chk.colorMapper.rangeMax);
+    QCOMPARE(t.colorMapper.complexType, chk.colorMapper.complexType);
+    QVERIFY(t.colorMapper.colorMap == chk.colorMapper.colorMap);
+    QCOMPARE(t.vectorStyle.color.toHex(), chk.vectorStyle.color.toHex());
+    QCOMPARE(t.vectorScale, chk.vectorScale);
+    QCOMPARE(t.gridStyle.color.toHex(), chk.gridStyle.color.toHex());
+    QVERIFY(t.getValueMap() == chk.getValueMap());
+  }
+}
+
+void compareBlocks(const stats::BlockArray &blocks, const stats::BlockArray &checkBlocks)
+{
+  QCOMPARE(blocks.size(), checkBlocks.size());
+  QVERIFY(blocks.posX == checkBlocks.posX);
+  QVERIFY(blocks.posY == checkBlocks.posY);
+  QVERIFY(blocks.width == checkBlocks.width);
+  QVERIFY(blocks.height == checkBlocks.height);
+}
+
+void comparePolygons(const stats::PolygonArray &polygons, const stats::PolygonArray &checkPolygons)
+{
+  QCOMPARE(polygons.size(), checkPolygons.size());
+  QVERIFY(polygons.cornerOffsets == checkPolygons.cornerOffsets);
+  QVERIFY(polygons.corners == checkPolygons.corners);
+}
+
+void compareFrameTypeData(const stats::FrameTypeData &data, const stats::FrameTypeData &checkData)
+{
+  QCOMPARE(data.maxBlockSize, checkData.maxBlockSize);
+
+  compareBlocks(data.valueData, checkData.valueData);
+  QVERIFY(data.valueData.value == checkData.valueData.value);
+
+  compareBlocks(data.vectorData, checkData.vectorData);
+  QVERIFY(data.vectorData.pointX == checkData.vectorData.pointX);
+  QVERIFY(data.vectorData.pointY == checkData.vectorData.pointY);
+  QVERIFY(data.vectorData.lineIndices == checkData.vectorData.lineIndices);
+  QVERIFY(data.vectorData.lineEndX == checkData.vectorData.lineEndX);
+  QVERIFY(data.vectorData.lineEndY == checkData.vectorData.lineEndY);
+
+  compareBlocks(data.affineTFData, checkData.affineTFData);
+  QVERIFY(data.affineTFData.pointX == checkData.affineTFData.pointX);
+  QVERIFY(data.affineTFData.pointY == checkData.affineTFData.pointY);
+
+  comparePolygons(data.polygonValueData, checkData.polygonValueData);
+  QVERIFY(data.polygonValueData.value == checkData.polygonValueData.value);
+
+  comparePolygons(data.polygonVectorData, checkData.polygonVectorData);
+  QVERIFY(data.polygonVectorData.pointX == checkData.polygonVectorData.pointX);
+  QVERIFY(data.polygonVectorData.pointY == checkData.polygonVectorData.pointY);
+}
+
+// Convert the source file to a binary file and check that the binary file contains the same types
+// and data.
+void checkConversion(stats::StatisticsFileBase &source, stats::StatisticsData &sourceData)
+{
+  std::atomic_bool breakAtomic;
+  breakAtomic.store(false);
+  source.readFrameAndTypePositionsFromFile(std::ref(breakAtomic));
+  QVERIFY(source);
+
+  TemporaryFile binaryFile("yuvstats");
+  const auto    binaryFilename = QString::fromStdString(binaryFile.getFilename());
+  QString       errorMessage;
+  QVERIFY(stats::StatisticsFileBinary::convertFile(
+      source, sourceData, binaryFilename, errorMessage));
+  QVERIFY(errorMessage.isEmpty());
+
+  stats::StatisticsData       binaryData;
+  stats::StatisticsFileBinary binary(binaryFilename, binaryData);
+  QVERIFY(binary);
+  QCOMPARE(binary.getMaxPoc(), source.getMaxPoc());
+  QCOMPARE(binary.getFramerate(), source.getFramerate());
+  compareTypes(binaryData, sourceData);
+
+  for (int poc = 0; poc <= source.getMaxPoc(); poc++)
+  {
+    loadAllTypes(source, sourceData, poc);
+    for (const auto &type : binaryData.getStatisticsTypes())
+    {
+      binary.loadStatisticData(binaryData, poc, type.typeID);
+      QCOMPARE(binaryData.getFrameIndex(), poc);
+      compareFrameTypeData(binaryData[type.typeID], sourceData[type.typeID]);
+    }
+  }
+  QVERIFY(binary);
+}
+
+std::string readFile(const TemporaryFile &file)
+{
+  std::ifstream i(file.getFilename(), std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(i), std::istreambuf_iterator<char>());
+}
+
+// Overwrite nrBytes at pos with the little endian value
+void patchValue(std::string &data, size_t pos, uint64_t value, unsigned nrBytes)
+{
+  for (unsigned i = 0; i < nrBytes; i++)
+    data[pos + i] = char((value >> (i * 8)) & 0xff);
+}
+
+uint64_t readValue(const std::string &data, size_t pos, unsigned nrBytes)
+{
+  uint64_t value = 0;
+  for (unsigned i = 0; i < nrBytes; i++)
+    value |= uint64_t(uint8_t(data[pos + i])) << (i * 8);
+  return value;
+}
+
+} // namespace
+
+class StatisticsFileBinaryTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  StatisticsFileBinaryTest(){};
+  ~StatisticsFileBinaryTest(){};
+
+private slots:
+  void testConvertCSVFile();
+  void testConvertVTMBMSFile();
+  void testInvalidFile();
+  void testCorruptIndex_data();
+  void testCorruptIndex();
+};
+
+void StatisticsFileBinaryTest::testConvertCSVFile()
+{
+  TemporaryFile csvFile("csv");
+  writeFile(csvFile,
+            R"(%;syntax-version;v1.2
+%;seq-specs;TestSequence_stats;0;416;240;25;
+%;type;9;MVDL0;vector;
+%;vectorColor;100;0;0;255
+%;scaleFactor;4
+%;type;7;MVPIdxL0;range;
+%;defaultRange;0;1;jet
+%;gridColor;255;255;255;
+%;type;0;PredMode;range;
+%;defaultRange;0;1;jet
+%;type;3;Lines;vector;
+%;vectorColor;0;200;0;255
+0;0;0;64;64;0;1
+0;64;0;64;64;0;0
+1;0;32;8;16;9;1;0
+1;8;32;8;16;9;0;-4
+1;0;32;8;16;7;1
+1;0;32;8;16;3;0;0;8;16
+1;8;32;8;16;3;2;-2
+1;16;32;8;16;3;0;16;8;0
+1;128;48;32;16;7;0
+1;128;48;32;16;0;1
+3;384;0;64;64;0;0
+)");
+
+  stats::StatisticsData    statData;
+  stats::StatisticsFileCSV statFile(QString::fromStdString(csvFile.getFilename()), statData);
+  QCOMPARE(statData.getStatisticsTypes().size(), size_t(4));
+  checkConversion(statFile, statData);
+}
+
+void StatisticsFileBinaryTest::testConvertVTMBMSFile()
+{
+  TemporaryFile vtmbmsFile("vtmbmsstats");
+  writeFile(vtmbmsFile,
+            R"(# VTMBMS Block Statistics
+# Sequence size: [2048x 872]
+# Block Statistic Type: PredMode; Integer; [0, 4]
+# Block Statistic Type: MVDL0; Vector; Scale: 4
+# Block Statistic Type: AffineMVL0; AffineTFVectors; Scale: 4
+# Block Statistic Type: GeoPartitioning; Line;
+# Block Statistic Type: GeoMVL0; VectorPolygon; Scale: 4
+BlockStat: POC 0 @(   0,   0) [64x64] PredMode=1
+BlockStat: POC 0 @(  64,   0) [32x16] PredMode=1
+BlockStat: POC 2 @( 384, 128) [64x64] MVDL0={ 12,   3}
+BlockStat: POC 2 @( 384, 128) [64x64] PredMode=1
+BlockStat: POC 2 @( 488, 192) [ 8x16] MVDL0={ -234, -256}
+BlockStat: POC 8 @( 640, 128) [128x128] AffineMVL0={ -61,-128, -53,-101, -99,-139}
+BlockStat: POC 8 @(1296, 128) [32x64] AffineMVL0={ -68,  32, -65,  39, -79,  25}
+BlockStat: POC 8 @( 288, 544) [16x32] GeoPartitioning={   5,   0,   6,  32}
+BlockStat: POC 8 @[(240, 384)--(256, 384)--(256, 430)--(240, 416)--] GeoMVL0={ 291, 233}
+BlockStat: POC 8 @[(544, 760)--(545, 768)--(544, 768)--] GeoMVL0={ 180,  38}
+)");
+
+  stats::StatisticsData       statData;
+  stats::StatisticsFileVTMBMS statFile(QString::fromStdString(vtmbmsFile.getFilename()),
+                                       statData);
+  QCOMPARE(statData.getStatisticsTypes().size(), size_t(5));
+  checkConversion(statFile, statData);
+}
+
+void StatisticsFileBinaryTest::testInvalidFile()
+{
+  TemporaryFile invalidFile("yuvstats");
+  writeFile(invalidFile, "This is not a binary statistics file");
+
+  stats::StatisticsData       statData;
+  stats::StatisticsFileBinary statFile(QString::fromStdString(invalidFile.getFilename()),
+                                       statData);
+  QVERIFY(!statFile);
+}
+
+void StatisticsFileBinaryTest::testCorruptIndex_data()
+{
+  // The position of the patched value. Positive values are in the header and negative values are
+  // relative to the position of the index (offset in the first entry).
+  QTest::addColumn<int>("position");
+  QTest::addColumn<quint64>("value");
+  QTest::addColumn<unsigned>("nrBytes");
+
+  QTest::newRow("NrIndexEntriesTooBig") << 48 << quint64(0xffffffff) << 4u;
+  QTest::newRow("NrIndexEntriesExceedsFile") << 48 << quint64(2) << 4u;
+  QTest::newRow("IndexOffsetTooBig") << 40 << quint64(0x7fffffffffffffff) << 8u;
+  QTest::newRow("EntryOffsetTooBig") << -8 << quint64(0x7fffffffffffffff) << 8u;
+  QTest::newRow("EntryOffsetNegative") << -8 << quint64(0xffffffffffffffff) << 8u;
+  QTest::newRow("EntrySizeTooBig") << -16 << quint64(0x7fffffffffffffff) << 8u;
+}
+
+void StatisticsFileBinaryTest::testCorruptIndex()
+{
+  QFETCH(int, position);
+  QFETCH(quint64, value);
+  QFETCH(unsigned, nrBytes);
+
+  TemporaryFile csvFile("csv");
+  writeFile(csvFile,
+            R"(%;syntax-version;v1.2
+%;seq-specs;TestSequence_stats;0;416;240;25;
+%;type;0;PredMode;range;
+%;defaultRange;0;1;jet
+0;0;0;64;64;0;1
+0;64;0;64;64;0;0
+)");
+
+  stats::StatisticsData    csvData;
+  stats::StatisticsFileCSV csvStatFile(QString::fromStdString(csvFile.getFilename()), csvData);
+  std::atomic_bool         breakAtomic;
+  breakAtomic.store(false);
+  csvStatFile.readFrameAndTypePositionsFromFile(std::ref(breakAtomic));
+
+  TemporaryFile binaryFile("yuvstats");
+  QString       errorMessage;
+  QVERIFY(stats::StatisticsFileBinary::convertFile(
+      csvStatFile, csvData, QString::fromStdString(binaryFile.getFilename()), errorMessage));
+
+  // The file has exactly one index entry
+  auto       content     = readFile(binaryFile);
+  const auto indexOffset = readValue(content, 40, 8);
+  QCOMPARE(readValue(content, 48, 4), uint64_t(1));
+  const auto patchPosition = position >= 0 ? size_t(position) : size_t(indexOffset - position);
+  patchValue(content, patchPosition, value, nrBytes);
+
+  TemporaryFile corruptFile("yuvstats");
+  writeFile(corruptFile, content);
+
+  stats::StatisticsData       statData;
+  stats::StatisticsFileBinary statFile(QString::fromStdString(corruptFile.getFilename()),
+                                       statData);
+  QVERIFY(!statFile);
+}
+
+QTEST_MAIN(StatisticsFileBinaryTest)
+
+#include "StatisticsFileBinaryTest.moc"
@@ -16,36 +16,34 @@ struct CheckStatsItem
   int      v0{}, v1{};
 };
 
-void checkVectorList(const std::vector<stats::StatsItemVector> &vectors,
-                     const std::vector<CheckStatsItem> &              checkItems)
+void checkVectorList(const stats::VectorBlocks &          vectors,
+                     const std::vector<CheckStatsItem> &checkItems)
 {
   QCOMPARE(vectors.size(), checkItems.size());
   for (unsigned i = 0; i < vectors.size(); i++)
   {
-    auto vec = vectors[i];
     auto chk = checkItems[i];
-    QCOMPARE(unsigned(vec.pos[0]), chk.x);
-    QCOMPARE(unsigned(vec.pos[1]), chk.y);
-    QCOMPARE(unsigned(vec.size[0]), chk.w);
-    QCOMPARE(unsigned(vec.size[1]), chk.h);
-    QCOMPARE(vec.point[0].x, chk.v0);
-    QCOMPARE(vec.point[0].y, chk.v1);
+    QCOMPARE(unsigned(vectors.posX[i]), chk.x);
+    QCOMPARE(unsigned(vectors.posY[i]), chk.y);
+    QCOMPARE(unsigned(vectors.width[i]), chk.w);
+    QCOMPARE(unsigned(vectors.height[i]), chk.h);
+    QCOMPARE(vectors.getLineIndex(i), -1);
+    QCOMPARE(vectors.pointX[i], chk.v0);
+    QCOMPARE(vectors.pointY[i], chk.v1);
   }
 }
 
-void checkValueList(const std::vector<stats::StatsItemValue> &values,
-                    const std::vector<CheckStatsItem> &             checkItems)
+void checkValueList(const stats::ValueBlocks &values, const std::vector<CheckStatsItem> &checkItems)
 {
   QCOMPARE(values.size(), checkItems.size());
   for (unsigned i = 0; i < values.size(); i++)
   {
-    auto val = values[i];
     auto chk = checkItems[i];
-    QCOMPARE(unsigned(val.pos[0]), chk.x);
-    QCOMPARE(unsigned(val.pos[1]), chk.y);
-    QCOMPARE(unsigned(val.size[0]), chk.w);
-    QCOMPARE(unsigned(val.size[1]), chk.h);
-    QCOMPARE(val.value, chk.v0);
+    QCOMPARE(unsigned(values.posX[i]), chk.x);
+    QCOMPARE(unsigned(values.posY[i]), chk.y);
+    QCOMPARE(unsigned(values.width[i]), chk.w);
+    QCOMPARE(unsigned(values.height[i]), chk.h);
+    QCOMPARE(values.value[i], chk.v0);
   }
 }
 
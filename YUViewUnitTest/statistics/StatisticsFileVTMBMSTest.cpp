@@ -35,95 +35,91 @@ struct CheckPolygonVectorItem
   unsigned y[5];
 };
 
-void checkVectorList(const std::vector<stats::StatsItemVector> &vectors,
-                     const std::vector<CheckStatsItem> &              checkItems)
+void checkVectorList(const stats::VectorBlocks &          vectors,
+                     const std::vector<CheckStatsItem> &checkItems)
 {
   QCOMPARE(vectors.size(), checkItems.size());
   for (unsigned i = 0; i < vectors.size(); i++)
   {
-    auto vec = vectors[i];
     auto chk = checkItems[i];
-    QCOMPARE(unsigned(vec.pos[0]), chk.x);
-    QCOMPARE(unsigned(vec.pos[1]), chk.y);
-    QCOMPARE(unsigned(vec.size[0]), chk.w);
-    QCOMPARE(unsigned(vec.size[1]), chk.h);
-    QCOMPARE(vec.point[0].x, chk.v0);
-    QCOMPARE(vec.point[0].y, chk.v1);
+    QCOMPARE(unsigned(vectors.posX[i]), chk.x);
+    QCOMPARE(unsigned(vectors.posY[i]), chk.y);
+    QCOMPARE(unsigned(vectors.width[i]), chk.w);
+    QCOMPARE(unsigned(vectors.height[i]), chk.h);
+    QCOMPARE(vectors.getLineIndex(i), -1);
+    QCOMPARE(vectors.pointX[i], chk.v0);
+    QCOMPARE(vectors.pointY[i], chk.v1);
   }
 }
 
-void checkAffineTFVectorList(const std::vector<stats::StatsItemAffineTF> &affineTFvectors,
-                             const std::vector<CheckAffineTFItem> &             checkItems)
+void checkAffineTFVectorList(const stats::AffineTFBlocks &          affineTFvectors,
+                             const std::vector<CheckAffineTFItem> &checkItems)
 {
   QCOMPARE(affineTFvectors.size(), checkItems.size());
   for (unsigned i = 0; i < affineTFvectors.size(); i++)
   {
-    auto vec = affineTFvectors[i];
     auto chk = checkItems[i];
-    QCOMPARE(unsigned(vec.pos[0]), chk.x);
-    QCOMPARE(unsigned(vec.pos[1]), chk.y);
-    QCOMPARE(unsigned(vec.size[0]), chk.w);
-    QCOMPARE(unsigned(vec.size[1]), chk.h);
-    QCOMPARE(vec.point[0].x, chk.v0);
-    QCOMPARE(vec.point[0].y, chk.v1);
-    QCOMPARE(vec.point[1].x, chk.v2);
-    QCOMPARE(vec.point[1].y, chk.v3);
-    QCOMPARE(vec.point[2].x, chk.v4);
-    QCOMPARE(vec.point[2].y, chk.v5);
+    QCOMPARE(unsigned(affineTFvectors.posX[i]), chk.x);
+    QCOMPARE(unsigned(affineTFvectors.posY[i]), chk.y);
+    QCOMPARE(unsigned(affineTFvectors.width[i]), chk.w);
+    QCOMPARE(unsigned(affineTFvectors.height[i]), chk.h);
+    QCOMPARE(affineTFvectors.pointX[0][i], chk.v0);
+    QCOMPARE(affineTFvectors.pointY[0][i], chk.v1);
+    QCOMPARE(affineTFvectors.pointX[1][i], chk.v2);
+    QCOMPARE(affineTFvectors.pointY[1][i], chk.v3);
+    QCOMPARE(affineTFvectors.pointX[2][i], chk.v4);
+    QCOMPARE(affineTFvectors.pointY[2][i], chk.v5);
   }
 }
 
-void checkLineList(const std::vector<stats::StatsItemVector> &lines,
-                   const std::vector<CheckLineItem> &               checkItems)
+void checkLineList(const stats::VectorBlocks &lines, const std::vector<CheckLineItem> &checkItems)
 {
   QCOMPARE(lines.size(), checkItems.size());
   for (unsigned i = 0; i < lines.size(); i++)
   {
-    auto vec = lines[i];
-    auto chk = checkItems[i];
-    QCOMPARE(unsigned(vec.pos[0]), chk.x);
-    QCOMPARE(unsigned(vec.pos[1]), chk.y);
-    QCOMPARE(unsigned(vec.size[0]), chk.w);
-    QCOMPARE(unsigned(vec.size[1]), chk.h);
-    QCOMPARE(vec.point[0].x, chk.v0);
-    QCOMPARE(vec.point[0].y, chk.v1);
-    QCOMPARE(vec.point[1].x, chk.v2);
-    QCOMPARE(vec.point[1].y, chk.v3);
+    auto       chk  = checkItems[i];
+    const auto line = lines.getLineIndex(i);
+    QVERIFY(line >= 0);
+    QCOMPARE(unsigned(lines.posX[i]), chk.x);
+    QCOMPARE(unsigned(lines.posY[i]), chk.y);
+    QCOMPARE(unsigned(lines.width[i]), chk.w);
+    QCOMPARE(unsigned(lines.height[i]), chk.h);
+    QCOMPARE(lines.pointX[i], chk.v0);
+    QCOMPARE(lines.pointY[i], chk.v1);
+    QCOMPARE(lines.lineEndX[line], chk.v2);
+    QCOMPARE(lines.lineEndY[line], chk.v3);
   }
 }
 
-void checkPolygonvectorList(const std::vector<stats::StatsItemPolygonVector> &polygonList,
-                            const std::vector<CheckPolygonVectorItem> &             checkItems)
+void checkPolygonvectorList(const stats::PolygonVectors &               polygonList,
+                            const std::vector<CheckPolygonVectorItem> &checkItems)
 {
   QCOMPARE(polygonList.size(), checkItems.size());
   for (unsigned i = 0; i < polygonList.size(); i++)
   {
-    auto polygon = polygonList[i];
+    auto corners = polygonList.getCorners(i);
     auto chk     = checkItems[i];
-    for (unsigned i = 0; i < polygon.corners.size(); i++)
+    for (unsigned c = 0; c < polygonList.getNrCorners(i); c++)
     {
-      auto corner = polygon.corners[i];
-      QCOMPARE(unsigned(corner.x), chk.x[i]);
-      QCOMPARE(unsigned(corner.y), chk.y[i]);
+      QCOMPARE(unsigned(corners[c].x), chk.x[c]);
+      QCOMPARE(unsigned(corners[c].y), chk.y[c]);
     }
-    QCOMPARE(polygon.point.x, chk.v0);
-    QCOMPARE(polygon.point.y, chk.v1);
+    QCOMPARE(polygonList.pointX[i], chk.v0);
+    QCOMPARE(polygonList.pointY[i], chk.v1);
   }
 }
 
-void checkValueList(const std::vector<stats::StatsItemValue> &values,
-                    const std::vector<CheckStatsItem> &             checkItems)
+void checkValueList(const stats::ValueBlocks &values, const std::vector<CheckStatsItem> &checkItems)
 {
   QCOMPARE(values.size(), checkItems.size());
   for (unsigned i = 0; i < values.size(); i++)
   {
-    auto val = values[i];
     auto chk = checkItems[i];
-    QCOMPARE(unsigned(val.pos[0]), chk.x);
-    QCOMPARE(unsigned(val.pos[1]), chk.y);
-    QCOMPARE(unsigned(val.size[0]), chk.w);
-    QCOMPARE(unsigned(val.size[1]), chk.h);
-    QCOMPARE(val.value, chk.v0);
+    QCOMPARE(unsigned(values.posX[i]), chk.x);
+    QCOMPARE(unsigned(values.posY[i]), chk.y);
+    QCOMPARE(unsigned(values.width[i]), chk.w);
+    QCOMPARE(unsigned(values.height[i]), chk.h);
+    QCOMPARE(values.value[i], chk.v0);
   }
 }
 
@@ -139,6 +135,8 @@ public:
 
 private slots:
   void testVTMBMSParsing();
+  void testVTMBMSParsingLineEndings();
+  void testVTMBMSParsingNegativePosition();
 };
 
 void StatisticsFileVTMBMSTest::testVTMBMSParsing()
@@ -314,6 +312,79 @@ BlockStat: POC 8 @[(544, 760)--(545, 768)--(544, 768)--] GeoMVL0={ 180,  38}
       });
 }
 
+void StatisticsFileVTMBMSTest::testVTMBMSParsingLineEndings()
+{
+  TemporaryFile vtmbmsFile("vtmbmsstats");
+
+  {
+    // Windows line endings, a line that can not be parsed, lines with a log prefix before the
+    // BlockStat and no newline at the end of the file
+    const std::string stats_str = "# VTMBMS Block Statistics\r\n"
+                                  "# Sequence size: [416x 240]\r\n"
+                                  "# Block Statistic Type: PredMode; Integer; [0, 4]\r\n"
+                                  "# Block Statistic Type: MVDL0; Vector; Scale: 4\r\n"
+                                  "BlockStat: POC 0 @(   0,   0) [64x64] PredMode=1\r\n"
+                                  "BlockStat: POC 0 @(  64,   0) [32x16] PredMode={1}\r\n"
+                                  "[01] BlockStat: POC 0 @(  64,  16) [32x16] PredMode=3\r\n"
+                                  "[02] BlockStat: POC 1 @(   0,   0) [64x64] MVDL0={ -5, 7}\r\n"
+                                  "BlockStat: POC 1 @(  64,   0) [ 8x 8] MVDL0={ 1, -2}";
+    std::ofstream o(vtmbmsFile.getFilename(), std::ios::binary);
+    o << stats_str;
+  }
+
+  stats::StatisticsData       statData;
+  stats::StatisticsFileVTMBMS statFile(QString::fromStdString(vtmbmsFile.getFilename()), statData);
+
+  QCOMPARE(statData.getFrameSize(), Size(416, 240));
+  QCOMPARE(statData.getStatisticsTypes().size(), size_t(2));
+
+  std::atomic_bool breakAtomic;
+  breakAtomic.store(false);
+  statFile.readFrameAndTypePositionsFromFile(std::ref(breakAtomic));
+  QCOMPARE(statFile.getMaxPoc(), 1);
+
+  statFile.loadStatisticData(statData, 0, 1);
+  checkValueList(statData[1].valueData, {{0, 0, 64, 64, 1}, {64, 16, 32, 16, 3}});
+
+  statFile.loadStatisticData(statData, 1, 2);
+  checkVectorList(statData[2].vectorData, {{0, 0, 64, 64, -5, 7}, {64, 0, 8, 8, 1, -2}});
+}
+
+void StatisticsFileVTMBMSTest::testVTMBMSParsingNegativePosition()
+{
+  TemporaryFile vtmbmsFile("vtmbmsstats");
+
+  {
+    // Blocks with a negative position can not be stored and must be skipped
+    const std::string stats_str = R"(# VTMBMS Block Statistics
+# Sequence size: [416x 240]
+# Block Statistic Type: PredMode; Integer; [0, 4]
+# Block Statistic Type: MVDL0; Vector; Scale: 4
+BlockStat: POC 0 @(   0,   0) [64x64] PredMode=1
+BlockStat: POC 0 @(  -8,   0) [16x16] PredMode=2
+BlockStat: POC 0 @(  64,  -4) [16x16] PredMode=3
+BlockStat: POC 0 @(  64,   0) [32x16] PredMode=4
+BlockStat: POC 0 @( -16, -16) [ 8x 8] MVDL0={ 3, 4}
+BlockStat: POC 0 @(  16,  16) [ 8x 8] MVDL0={ 1, -2}
+)";
+    std::ofstream o(vtmbmsFile.getFilename(), std::ios::binary);
+    o << stats_str;
+  }
+
+  stats::StatisticsData       statData;
+  stats::StatisticsFileVTMBMS statFile(QString::fromStdString(vtmbmsFile.getFilename()), statData);
+
+  std::atomic_bool breakAtomic;
+  breakAtomic.store(false);
+  statFile.readFrameAndTypePositionsFromFile(std::ref(breakAtomic));
+
+  statFile.loadStatisticData(statData, 0, 1);
+  checkValueList(statData[1].valueData, {{0, 0, 64, 64, 1}, {64, 0, 32, 16, 4}});
+
+  statFile.loadStatisticData(statData, 0, 2);
+  checkVectorList(statData[2].vectorData, {{16, 16, 8, 8, 1, -2}});
+}
+
 QTEST_MAIN(StatisticsFileVTMBMSTest)
 
 #include "StatisticsFileVTMBMSTest.moc"
@@ -2,5 +2,7 @@ TEMPLATE = subdirs
 
 requires(qtHaveModule(testlib))
 
-SUBDIRS = StatisticsFileCSVTest.pro \
+SUBDIRS = StatisticsDataTest.pro \
+          StatisticsFileBinaryTest.pro \
+          StatisticsFileCSVTest.pro \
           StatisticsFileVTMBMSTest.pro
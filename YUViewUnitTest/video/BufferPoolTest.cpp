@@ -0,0 +1,128 @@
+#include <QtTest>
+
+#include <video/BufferPool.h>
+
+#include <cstdint>
+
+using namespace video;
+
+class BufferPoolTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  BufferPoolTest(){};
+  ~BufferPoolTest(){};
+
+private slots:
+  void testSizeClasses();
+  void testReuse();
+  void testSmallBlocksNotPooled();
+  void testImage();
+  void testMaxFreeSize();
+};
+
+void BufferPoolTest::testSizeClasses()
+{
+  QCOMPARE(BufferPool::getSizeClass(100), size_t(128));
+  QCOMPARE(BufferPool::getSizeClass(64 * 1024), size_t(64 * 1024));
+  QCOMPARE(BufferPool::getSizeClass(64 * 1024 + 1), size_t(80 * 1024));
+  // A 1080p 4:2:0 8 bit frame and a 1080p RGB32 image
+  QCOMPARE(BufferPool::getSizeClass(3110400), size_t(3 * 1024 * 1024));
+  QCOMPARE(BufferPool::getSizeClass(8294400), size_t(8 * 1024 * 1024));
+  QCOMPARE(BufferPool::getSizeClass(8 * 1024 * 1024 + 1), size_t(10 * 1024 * 1024));
+}
+
+void BufferPoolTest::testReuse()
+{
+  BufferPool pool;
+
+  void *firstBlock = nullptr;
+  {
+    auto block = pool.allocate(3110400);
+    QVERIFY(block);
+    QCOMPARE(std::uintptr_t(block.get()) % BufferPool::Alignment, std::uintptr_t(0));
+    firstBlock = block.get();
+
+    auto status = pool.getStatus();
+    QCOMPARE(status.nrAllocations, int64_t(1));
+    QCOMPARE(status.usedSize, int64_t(3 * 1024 * 1024));
+    QCOMPARE(status.freeSize, int64_t(0));
+  }
+
+  auto status = pool.getStatus();
+  QCOMPARE(status.usedSize, int64_t(0));
+  QCOMPARE(status.freeSize, int64_t(3 * 1024 * 1024));
+
+  // A slightly different size of the same size class gets the same block
+  auto block = pool.allocate(3000000);
+  QCOMPARE(static_cast<void *>(block.get()), firstBlock);
+
+  status = pool.getStatus();
+  QCOMPARE(status.nrAllocations, int64_t(2));
+  QCOMPARE(status.nrReused, int64_t(1));
+  QCOMPARE(status.peakSize, int64_t(3 * 1024 * 1024));
+}
+
+void BufferPoolTest::testSmallBlocksNotPooled()
+{
+  BufferPool pool;
+  {
+    auto block = pool.allocate(100);
+    QVERIFY(block);
+  }
+  const auto status = pool.getStatus();
+  QCOMPARE(status.nrAllocations, int64_t(0));
+  QCOMPARE(status.freeSize, int64_t(0));
+}
+
+void BufferPoolTest::testImage()
+{
+  BufferPool pool;
+
+  {
+    auto image = pool.allocateImage(QSize(1920, 1080), QImage::Format_RGB32);
+    QCOMPARE(image.size(), QSize(1920, 1080));
+    QCOMPARE(image.bytesPerLine(), 1920 * 4);
+    image.fill(Qt::red);
+
+    // A shallow copy keeps the memory in use
+    auto copy = image;
+    image     = QImage();
+    QCOMPARE(copy.pixel(10, 10), QColor(Qt::red).rgb());
+    QCOMPARE(pool.getStatus().usedSize, int64_t(8 * 1024 * 1024));
+  }
+
+  auto status = pool.getStatus();
+  QCOMPARE(status.usedSize, int64_t(0));
+  QCOMPARE(status.freeSize, int64_t(8 * 1024 * 1024));
+
+  auto image = pool.allocateImage(QSize(1920, 1080), QImage::Format_ARGB32);
+  QVERIFY(!image.isNull());
+  QCOMPARE(pool.getStatus().nrReused, int64_t(1));
+}
+
+void BufferPoolTest::testMaxFreeSize()
+{
+  BufferPool pool;
+  pool.setMaxFreeSize(5 * 1024 * 1024);
+
+  {
+    auto block1 = pool.allocate(3 * 1024 * 1024);
+    auto block2 = pool.allocate(3 * 1024 * 1024);
+  }
+
+  // Only one of the blocks fits into the free lists
+  auto status = pool.getStatus();
+  QCOMPARE(status.freeSize, int64_t(3 * 1024 * 1024));
+  QCOMPARE(status.nrFreed, int64_t(1));
+
+  pool.setMaxFreeSize(0);
+  status = pool.getStatus();
+  QCOMPARE(status.freeSize, int64_t(0));
+  QCOMPARE(status.nrFreed, int64_t(2));
+}
+
+QTEST_MAIN(BufferPoolTest)
+
+#include "BufferPoolTest.moc"
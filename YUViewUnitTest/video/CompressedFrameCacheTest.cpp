@@ -0,0 +1,238 @@
+#include <QtTest>
+
+#include <video/CompressedFrameCache.h>
+
+#include <cstring>
+#include <memory>
+#include <random>
+
+using namespace video;
+
+class CompressedFrameCacheTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  CompressedFrameCacheTest(){};
+  ~CompressedFrameCacheTest(){};
+
+private slots:
+  void testRoundTrip_data();
+  void testRoundTrip();
+  void testCorruptData();
+  void testCache();
+  void testCacheEviction();
+  void testInsertRawDataView();
+  void testRemoveWhilePending();
+  void testInsertManyFrames();
+};
+
+namespace
+{
+
+QByteArray createRandomData(int size, int maxValue)
+{
+  std::mt19937                       generator(42);
+  std::uniform_int_distribution<int> distribution(0, maxValue);
+
+  QByteArray data(size, 0);
+  for (auto &value : data)
+    value = char(distribution(generator));
+  return data;
+}
+
+QByteArray create10BitData(int nrSamples)
+{
+  // Smooth gradient of 10 bit little endian samples
+  QByteArray data(nrSamples * 2, 0);
+  for (int i = 0; i < nrSamples; i++)
+  {
+    const auto value = (i / 7) % 1024;
+    data[i * 2]      = char(value & 0xff);
+    data[i * 2 + 1]  = char(value >> 8);
+  }
+  return data;
+}
+
+} // namespace
+
+void CompressedFrameCacheTest::testRoundTrip_data()
+{
+  QTest::addColumn<QByteArray>("data");
+  QTest::addColumn<unsigned>("elementSize");
+
+  QTest::newRow("Empty") << QByteArray() << 1u;
+  QTest::newRow("Short") << QByteArray("abc") << 1u;
+  QTest::newRow("Constant") << QByteArray(100000, 'x') << 1u;
+  QTest::newRow("Random") << createRandomData(100000, 255) << 1u;
+  QTest::newRow("RandomFewValues") << createRandomData(100000, 3) << 1u;
+  QTest::newRow("10BitSamples") << create10BitData(50000) << 2u;
+  QTest::newRow("OddSizeElementSize2") << createRandomData(10001, 7) << 2u;
+}
+
+void CompressedFrameCacheTest::testRoundTrip()
+{
+  QFETCH(QByteArray, data);
+  QFETCH(unsigned, elementSize);
+
+  const auto compressed = compressFrameData(data, elementSize);
+  QVERIFY(!compressed.isEmpty());
+
+  QByteArray decompressed;
+  QVERIFY(decompressFrameData(compressed, decompressed));
+  QCOMPARE(decompressed, data);
+}
+
+void CompressedFrameCacheTest::testCorruptData()
+{
+  const auto data       = create10BitData(10000);
+  const auto compressed = compressFrameData(data, 2);
+  QVERIFY(compressed.size() < data.size() / 2);
+
+  QByteArray decompressed;
+  QVERIFY(!decompressFrameData(QByteArray(), decompressed));
+  QVERIFY(!decompressFrameData(compressed.left(compressed.size() - 3), decompressed));
+
+  // Claim a bigger uncompressed size than the data contains
+  auto wrongSize = compressed;
+  wrongSize[1]   = char(wrongSize[1] + 1);
+  QVERIFY(!decompressFrameData(wrongSize, decompressed));
+}
+
+void CompressedFrameCacheTest::testCache()
+{
+  CompressedFrameCache cache;
+  const int            owner1 = 0;
+  const int            owner2 = 0;
+  const auto           data   = create10BitData(10000);
+
+  QByteArray output;
+  cache.insert(&owner1, 0, data, 2);
+  cache.waitForPendingFrames();
+  QVERIFY(!cache.isEnabled());
+  QVERIFY(!cache.get(&owner1, 0, output));
+
+  cache.setMaxSize(1000000);
+  QVERIFY(cache.isEnabled());
+  cache.insert(&owner1, 0, data, 2);
+  cache.waitForPendingFrames();
+  cache.insert(&owner1, 1, data, 2);
+  cache.waitForPendingFrames();
+  cache.insert(&owner2, 0, data, 2);
+  cache.waitForPendingFrames();
+
+  const auto status = cache.getStatus();
+  QCOMPARE(status.nrFrames, 3);
+  QCOMPARE(status.uncompressedSize, int64_t(data.size() * 3));
+  QVERIFY(status.compressedSize < status.uncompressedSize);
+
+  QVERIFY(cache.get(&owner1, 1, output));
+  QCOMPARE(output, data);
+  QVERIFY(!cache.get(&owner1, 2, output));
+
+  cache.remove(&owner1);
+  QVERIFY(!cache.get(&owner1, 0, output));
+  QVERIFY(cache.get(&owner2, 0, output));
+  QCOMPARE(cache.getStatus().nrFrames, 1);
+}
+
+void CompressedFrameCacheTest::testCacheEviction()
+{
+  CompressedFrameCache cache;
+  const int            owner      = 0;
+  const auto           data       = create10BitData(10000);
+  const auto           frameBytes = compressFrameData(data, 2).size();
+
+  cache.setMaxSize(frameBytes * 2);
+  cache.insert(&owner, 0, data, 2);
+  cache.waitForPendingFrames();
+  cache.insert(&owner, 1, data, 2);
+  cache.waitForPendingFrames();
+
+  // Frame 0 is used more recently now so frame 1 is dropped when frame 2 is added
+  QByteArray output;
+  QVERIFY(cache.get(&owner, 0, output));
+  cache.insert(&owner, 2, data, 2);
+  cache.waitForPendingFrames();
+
+  QVERIFY(cache.get(&owner, 0, output));
+  QVERIFY(!cache.get(&owner, 1, output));
+  QVERIFY(cache.get(&owner, 2, output));
+  QCOMPARE(cache.getStatus().nrFrames, 2);
+  QVERIFY(cache.getStatus().compressedSize <= frameBytes * 2);
+
+  cache.setMaxSize(0);
+  QCOMPARE(cache.getStatus().nrFrames, 0);
+}
+
+void CompressedFrameCacheTest::testInsertRawDataView()
+{
+  CompressedFrameCache cache;
+  const int            owner = 0;
+  const auto           data  = create10BitData(10000);
+  cache.setMaxSize(1000000);
+
+  // Like a view into a memory mapped file. The memory is released right after the insert.
+  auto memory = std::make_unique<char[]>(size_t(data.size()));
+  std::memcpy(memory.get(), data.constData(), size_t(data.size()));
+  cache.insert(&owner, 0, QByteArray::fromRawData(memory.get(), data.size()), 2);
+  std::memset(memory.get(), 0, size_t(data.size()));
+  memory.reset();
+  cache.waitForPendingFrames();
+
+  QByteArray output;
+  QVERIFY(cache.get(&owner, 0, output));
+  QCOMPARE(output, data);
+}
+
+void CompressedFrameCacheTest::testRemoveWhilePending()
+{
+  CompressedFrameCache cache;
+  const int            owner = 0;
+  const auto           data  = create10BitData(10000);
+  cache.setMaxSize(1000000);
+
+  // The frame that is being compressed while the owner is removed must not be added
+  cache.insert(&owner, 0, data, 2);
+  cache.remove(&owner);
+  cache.waitForPendingFrames();
+  QByteArray output;
+  QVERIFY(!cache.get(&owner, 0, output));
+
+  // A new owner at the same address can use the cache again
+  for (int i = 0; i < 2; i++)
+  {
+    cache.insert(&owner, 0, data, 2);
+    cache.waitForPendingFrames();
+    QVERIFY(cache.get(&owner, 0, output));
+    QCOMPARE(output, data);
+    cache.remove(&owner);
+    QVERIFY(!cache.get(&owner, 0, output));
+  }
+  QCOMPARE(cache.getStatus().nrFrames, 0);
+}
+
+void CompressedFrameCacheTest::testInsertManyFrames()
+{
+  CompressedFrameCache cache;
+  const int            owner = 0;
+  const auto           data  = create10BitData(10000);
+  cache.setMaxSize(100000000);
+
+  // Like the eviction of all frames of an item. The frames are queued and none is dropped.
+  const int nrFrames = 64;
+  for (int i = 0; i < nrFrames; i++)
+    cache.insert(&owner, i, data, 2);
+  cache.waitForPendingFrames();
+
+  const auto status = cache.getStatus();
+  QCOMPARE(status.nrFrames, nrFrames);
+  QCOMPARE(status.nrDroppedFrames, 0);
+  QByteArray output;
+  QVERIFY(cache.get(&owner, nrFrames - 1, output));
+  QCOMPARE(output, data);
+}
+
+QTEST_MAIN(CompressedFrameCacheTest)
+
+#include "CompressedFrameCacheTest.moc"
@@ -0,0 +1,409 @@
+#include <QCryptographicHash>
+#include <QtTest>
+
+#include <common/CPUFeatures.h>
+#include <video/ConversionYUV.h>
+#include <video/FrameBuffer.h>
+
+#include <cstring>
+#include <random>
+
+using namespace video::yuv;
+
+class ConversionYUVTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  ConversionYUVTest(){};
+  ~ConversionYUVTest(){};
+
+private slots:
+  void testBlackAndWhite();
+  void testSIMDBitExact();
+  void testBaselineReference_data();
+  void testBaselineReference();
+  void testLineRanges();
+  void testParallelConversion();
+  void testStridedPlanes();
+};
+
+namespace
+{
+
+const auto TestFrameSize = Size(52, 20);
+
+std::vector<unsigned char> createRandomFrame(const PixelFormatYUV &format, const Size &frameSize)
+{
+  std::mt19937                       generator(42);
+  std::uniform_int_distribution<int> distribution(0, 255);
+
+  std::vector<unsigned char> data(size_t(format.bytesPerFrame(frameSize)));
+  for (auto &value : data)
+    value = (unsigned char)distribution(generator);
+  return data;
+}
+
+// Unlike createRandomFrame, all values are in the range of the bit depth and the values do not
+// depend on the standard library implementation (the output of std::mt19937 is specified).
+std::vector<unsigned char> createReferenceFrame(const PixelFormatYUV &format, const Size &frameSize)
+{
+  std::mt19937 generator(42);
+
+  const auto bitsPerSample = format.getBitsPerSample();
+  const auto bigEndian     = format.isBigEndian();
+
+  std::vector<unsigned char> data(size_t(format.bytesPerFrame(frameSize)));
+  if (bitsPerSample <= 8)
+  {
+    for (auto &value : data)
+      value = (unsigned char)(generator() % (1u << bitsPerSample));
+    return data;
+  }
+
+  for (size_t i = 0; i < data.size() / 2; i++)
+  {
+    const auto value = generator() % (1u << bitsPerSample);
+    data[i * 2]      = (unsigned char)(bigEndian ? value >> 8 : value & 0xff);
+    data[i * 2 + 1]  = (unsigned char)(bigEndian ? value & 0xff : value >> 8);
+  }
+  return data;
+}
+
+PlanarYUVSource getPlanarSource(const std::vector<unsigned char> &data,
+                                const PixelFormatYUV &            format,
+                                const Size &                      frameSize)
+{
+  const auto bytesPerSample = format.getBitsPerSample() > 8 ? 2u : 1u;
+  const auto lumaPlaneSize  = frameSize.width * frameSize.height * bytesPerSample;
+  const auto chromaPlaneSize =
+      lumaPlaneSize / format.getSubsamplingHor() / format.getSubsamplingVer();
+
+  PlanarYUVSource source;
+  source.y = data.data();
+  source.u = data.data() + lumaPlaneSize;
+  source.v = data.data() + lumaPlaneSize + chromaPlaneSize;
+  return source;
+}
+
+std::vector<unsigned char> convert(const std::vector<unsigned char> &data,
+                                   const PixelFormatYUV &            format,
+                                   const ConversionSettings &        settings,
+                                   functions::SIMDInstructionSet     instructionSet)
+{
+  std::vector<unsigned char> output(TestFrameSize.width * TestFrameSize.height * 4);
+  const auto                 source = getPlanarSource(data, format, TestFrameSize);
+  if (!convertPlanarYUVToBGRA(source,
+                              format,
+                              TestFrameSize,
+                              settings,
+                              output.data(),
+                              0,
+                              TestFrameSize.height,
+                              instructionSet))
+    return {};
+  return output;
+}
+
+} // namespace
+
+void ConversionYUVTest::testBlackAndWhite()
+{
+  const auto format = PixelFormatYUV(Subsampling::YUV_420, 8, PlaneOrder::YUV);
+  auto       data   = std::vector<unsigned char>(size_t(format.bytesPerFrame(TestFrameSize)), 128);
+
+  const auto lumaPlaneSize = TestFrameSize.width * TestFrameSize.height;
+  std::fill(data.begin(), data.begin() + lumaPlaneSize / 2, 0);
+  std::fill(data.begin() + lumaPlaneSize / 2, data.begin() + lumaPlaneSize, 255);
+
+  ConversionSettings settings;
+  settings.colorConversion = ColorConversion::BT709_FullRange;
+
+  for (auto instructionSet : functions::getSupportedSIMDInstructionSets())
+  {
+    const auto output = convert(data, format, settings, instructionSet);
+    QCOMPARE(output.size(), size_t(lumaPlaneSize * 4));
+    for (unsigned i = 0; i < lumaPlaneSize; i++)
+    {
+      const auto expected = (i < lumaPlaneSize / 2) ? 0 : 255;
+      QCOMPARE(int(output[i * 4]), expected);
+      QCOMPARE(int(output[i * 4 + 1]), expected);
+      QCOMPARE(int(output[i * 4 + 2]), expected);
+      QCOMPARE(int(output[i * 4 + 3]), 255);
+    }
+  }
+}
+
+void ConversionYUVTest::testSIMDBitExact()
+{
+  const auto instructionSets = functions::getSupportedSIMDInstructionSets();
+  if (instructionSets.size() < 2)
+    QSKIP("No SIMD instruction set supported on this CPU");
+
+  for (auto subsampling : SubsamplingMapper.getEnums())
+  {
+    if (subsampling == Subsampling::YUV_400)
+      continue;
+    for (auto bitsPerSample : BitDepthList)
+    {
+      for (auto bigEndian : {false, true})
+      {
+        const auto format = PixelFormatYUV(subsampling, bitsPerSample, PlaneOrder::YUV, bigEndian);
+        const auto data   = createRandomFrame(format, TestFrameSize);
+
+        for (auto interpolation : ChromaInterpolationMapper.getEnums())
+        {
+          for (auto colorConversion : ColorConversionMapper.getEnums())
+          {
+            for (auto math : {MathParameters(), MathParameters(3, 128, true)})
+            {
+              const ConversionSettings settings{interpolation, colorConversion, math, math};
+
+              const auto reference =
+                  convert(data, format, settings, functions::SIMDInstructionSet::None);
+              QVERIFY(!reference.empty());
+
+              for (auto instructionSet : instructionSets)
+              {
+                if (convert(data, format, settings, instructionSet) != reference)
+                {
+                  const auto errorStr =
+                      "Output of " +
+                      functions::SIMDInstructionSetMapper.getName(instructionSet) +
+                      " differs from the scalar conversion for format " + format.getName();
+                  QFAIL(errorStr.c_str());
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void ConversionYUVTest::testBaselineReference_data()
+{
+  QTest::addColumn<QString>("formatName");
+  QTest::addColumn<QString>("interpolation");
+  QTest::addColumn<QString>("colorConversion");
+  QTest::addColumn<bool>("applyMath");
+  QTest::addColumn<QByteArray>("expectedMd5");
+
+  // The MD5 of the output of the per subsampling conversion functions (YUVPlaneToRGB_*) that were
+  // used before the line based conversion. 4:4:0 is not in here because these functions used the
+  // wrong chroma line for 4:4:0. Bilinear 4:1:0 is not in here because the bottom chroma line was
+  // interpolated with values after the end of the chroma plane.
+  struct Reference
+  {
+    const char *formatName;
+    const char *interpolation;
+    const char *colorConversion;
+    bool        applyMath;
+    const char *expectedMd5;
+  };
+  const std::vector<Reference> references = {
+      {"YUV 4:4:4 8-bit",
+       "Nearest Neighbor",
+       "ITU-R.BT709",
+       false,
+       "7bf913239f1b11b17d767308880d915f"},
+      {"YUV 4:4:4 10-bit BE",
+       "Bilinear",
+       "ITU-R.BT2020 Full Range",
+       true,
+       "7363f9eea6afa4b67801d022945b1f6f"},
+      {"YUV 4:2:2 8-bit", "Bilinear", "ITU-R.BT601", false, "e24ad0366ed8e062e2d4d4c8c8ef2b06"},
+      {"YUV 4:2:2 8-bit Cy1", "Bilinear", "ITU-R.BT709", false, "4e118c728b09483dfd6d628c89be3044"},
+      {"YUV 4:2:2 12-bit LE",
+       "Interstitial",
+       "ITU-R.BT709 Full Range",
+       true,
+       "675ca1d93291b497c475ab8e64ded36f"},
+      {"YUV 4:2:0 8-bit",
+       "Nearest Neighbor",
+       "ITU-R.BT709",
+       false,
+       "a22c4a30497b714655c7120c3465d304"},
+      {"YUV 4:2:0 8-bit", "Bilinear", "ITU-R.BT709", false, "00382aa858d2fc0001cbe7d6354a93e6"},
+      {"YUV 4:2:0 8-bit Cy3",
+       "Bilinear",
+       "ITU-R.BT601 Full Range",
+       false,
+       "e2749d1c0b2144a4e196353bf6fbfc04"},
+      {"YUV 4:2:0 10-bit LE", "Bilinear", "ITU-R.BT2020", true, "fe66ca878746000599b87c4bec995761"},
+      {"YUV 4:2:0 10-bit BE",
+       "Interstitial",
+       "ITU-R.BT601 Full Range",
+       false,
+       "205e1db0c24e6add5a1c888e8eb17f89"},
+      {"YUV 4:2:0 16-bit LE", "Bilinear", "ITU-R.BT709", false, "a07c27c240d7439e0863dafae840b4b2"},
+      {"YUV 4:1:1 8-bit", "Bilinear", "ITU-R.BT709", false, "3710a774921bf653f190c308b719888c"},
+      {"YUV 4:1:1 14-bit LE",
+       "Nearest Neighbor",
+       "ITU-R.BT2020 Full Range",
+       true,
+       "9281b2fb5d4eddc77257dcdd0e2bdc57"},
+      {"YUV 4:1:0 8-bit",
+       "Nearest Neighbor",
+       "ITU-R.BT709",
+       false,
+       "91ed8f2fa6278d72ece7bcadccf38cdb"},
+      {"YUV 4:1:0 9-bit LE",
+       "Interstitial",
+       "ITU-R.BT601",
+       true,
+       "08ef79a99a6bcedd89b4894dc2a9c84f"},
+  };
+
+  for (const auto &reference : references)
+  {
+    const auto name = std::string(reference.formatName) + " " + reference.interpolation + " " +
+                      reference.colorConversion + (reference.applyMath ? " math" : "");
+    QTest::newRow(name.c_str()) << QString(reference.formatName)
+                                << QString(reference.interpolation)
+                                << QString(reference.colorConversion) << reference.applyMath
+                                << QByteArray(reference.expectedMd5);
+  }
+}
+
+void ConversionYUVTest::testBaselineReference()
+{
+  QFETCH(QString, formatName);
+  QFETCH(QString, interpolation);
+  QFETCH(QString, colorConversion);
+  QFETCH(bool, applyMath);
+  QFETCH(QByteArray, expectedMd5);
+
+  const auto format = PixelFormatYUV(formatName.toStdString());
+  QVERIFY(format.isValid());
+  QCOMPARE(QString::fromStdString(format.getName()), formatName);
+
+  const auto math = applyMath ? MathParameters(3, 128, true) : MathParameters();
+  const ConversionSettings settings{
+      *ChromaInterpolationMapper.getValue(interpolation.toStdString()),
+      *ColorConversionMapper.getValue(colorConversion.toStdString()),
+      math,
+      math};
+
+  const auto data = createReferenceFrame(format, TestFrameSize);
+  for (auto instructionSet : functions::getSupportedSIMDInstructionSets())
+  {
+    const auto output = convert(data, format, settings, instructionSet);
+    QVERIFY(!output.empty());
+    const auto md5 = QCryptographicHash::hash(
+        QByteArray(reinterpret_cast<const char *>(output.data()), int(output.size())),
+        QCryptographicHash::Md5);
+    QCOMPARE(md5.toHex(), expectedMd5);
+  }
+}
+
+void ConversionYUVTest::testLineRanges()
+{
+  // Converting the frame in parts must give the same result as converting it in one go
+  for (auto subsampling : {Subsampling::YUV_420, Subsampling::YUV_440, Subsampling::YUV_410})
+  {
+    const auto format = PixelFormatYUV(subsampling, 10, PlaneOrder::YUV);
+    const auto data   = createRandomFrame(format, TestFrameSize);
+    const auto source = getPlanarSource(data, format, TestFrameSize);
+
+    ConversionSettings settings;
+    settings.chromaInterpolation = ChromaInterpolation::Bilinear;
+
+    const auto reference = convert(data, format, settings, functions::getSIMDInstructionSet());
+
+    std::vector<unsigned char> output(reference.size());
+    for (unsigned line = 0; line < TestFrameSize.height; line += 3)
+    {
+      const auto lineEnd = std::min(line + 3, TestFrameSize.height);
+      QVERIFY(convertPlanarYUVToBGRA(
+          source, format, TestFrameSize, settings, output.data(), line, lineEnd));
+    }
+    QVERIFY(output == reference);
+  }
+}
+
+void ConversionYUVTest::testParallelConversion()
+{
+  const auto frameSize = Size(64u, MinLinesPerStripe * 7 + 6);
+  for (auto subsampling : {Subsampling::YUV_420, Subsampling::YUV_410})
+  {
+    const auto format = PixelFormatYUV(subsampling, 8, PlaneOrder::YUV);
+    const auto data   = createRandomFrame(format, frameSize);
+    const auto source = getPlanarSource(data, format, frameSize);
+
+    ConversionSettings settings;
+    settings.chromaInterpolation = ChromaInterpolation::Bilinear;
+
+    std::vector<unsigned char> reference(frameSize.width * frameSize.height * 4);
+    QVERIFY(convertPlanarYUVToBGRA(
+        source, format, frameSize, settings, reference.data(), 0, frameSize.height));
+
+    std::vector<unsigned char> output(reference.size());
+    QVERIFY(convertPlanarYUVToBGRAParallel(source, format, frameSize, settings, output.data()));
+    QVERIFY(output == reference);
+  }
+}
+
+void ConversionYUVTest::testStridedPlanes()
+{
+  // Planes with padding at the end of each line (like the buffers of a decoder) must give the same
+  // result as the packed frame. Packing the padded planes must give the packed frame again.
+  for (auto subsampling : {Subsampling::YUV_420, Subsampling::YUV_422, Subsampling::YUV_444})
+  {
+    for (auto bitsPerSample : {8, 10})
+    {
+      const auto format = PixelFormatYUV(subsampling, bitsPerSample, PlaneOrder::YUV);
+      const auto data   = createRandomFrame(format, TestFrameSize);
+      const auto packed = getPlanarSource(data, format, TestFrameSize);
+
+      ConversionSettings settings;
+      settings.chromaInterpolation = ChromaInterpolation::Bilinear;
+      const auto reference = convert(data, format, settings, functions::getSIMDInstructionSet());
+
+      const auto   bytesPerSample = (bitsPerSample > 8) ? 2u : 1u;
+      const size_t lineBytesY     = TestFrameSize.width * bytesPerSample;
+      const size_t lineBytesC     = lineBytesY / format.getSubsamplingHor();
+      const auto   heightC        = TestFrameSize.height / format.getSubsamplingVer();
+      const size_t strideY        = lineBytesY + 32;
+      const size_t strideC        = lineBytesC + 16;
+
+      std::vector<unsigned char> padded(strideY * TestFrameSize.height + strideC * heightC * 2, 0);
+      const auto                 paddedY = padded.data();
+      const auto                 paddedU = paddedY + strideY * TestFrameSize.height;
+      const auto                 paddedV = paddedU + strideC * heightC;
+      for (unsigned y = 0; y < TestFrameSize.height; y++)
+        std::memcpy(paddedY + y * strideY, packed.y + y * lineBytesY, lineBytesY);
+      for (unsigned y = 0; y < heightC; y++)
+      {
+        std::memcpy(paddedU + y * strideC, packed.u + y * lineBytesC, lineBytesC);
+        std::memcpy(paddedV + y * strideC, packed.v + y * lineBytesC, lineBytesC);
+      }
+
+      PlanarYUVSource source;
+      source.y       = paddedY;
+      source.u       = paddedU;
+      source.v       = paddedV;
+      source.strideY = strideY;
+      source.strideC = strideC;
+
+      std::vector<unsigned char> output(reference.size());
+      QVERIFY(
+          convertPlanarYUVToBGRAParallel(source, format, TestFrameSize, settings, output.data()));
+      QVERIFY(output == reference);
+
+      const video::FrameBuffer buffer({{paddedY, strideY, lineBytesY, TestFrameSize.height},
+                                       {paddedU, strideC, lineBytesC, heightC},
+                                       {paddedV, strideC, lineBytesC, heightC}},
+                                      {});
+      QVERIFY(!buffer.isPacked());
+      QCOMPARE(buffer.getSize(), data.size());
+      QCOMPARE(buffer.toByteArray(),
+               QByteArray(reinterpret_cast<const char *>(data.data()), int(data.size())));
+    }
+  }
+}
+
+QTEST_MAIN(ConversionYUVTest)
+
+#include "ConversionYUVTest.moc"
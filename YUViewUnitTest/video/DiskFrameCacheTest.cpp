@@ -0,0 +1,161 @@
+#include <QtTest>
+
+#include <QTemporaryDir>
+
+#include <video/DiskFrameCache.h>
+
+#include <random>
+
+using namespace video;
+
+class DiskFrameCacheTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  DiskFrameCacheTest(){};
+  ~DiskFrameCacheTest(){};
+
+private slots:
+  void testSaveAndLoad();
+  void testSequenceKey();
+  void testCorruptFrame();
+  void testPrune();
+};
+
+namespace
+{
+
+QByteArray createFrameData(int size, int seed)
+{
+  QByteArray data(size, 0);
+  for (int i = 0; i < size; i++)
+    data[i] = char((i / 5 + seed) % 256);
+  return data;
+}
+
+void writeFile(const QString &path, const QByteArray &data)
+{
+  QFile file(path);
+  QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+  QCOMPARE(file.write(data), qint64(data.size()));
+}
+
+} // namespace
+
+void DiskFrameCacheTest::testSaveAndLoad()
+{
+  QTemporaryDir cacheDir;
+  QVERIFY(cacheDir.isValid());
+
+  DiskFrameCache cache;
+  QVERIFY(!cache.isEnabled());
+
+  const auto key   = QString("0123456789abcdef");
+  const auto frame = createFrameData(10000, 0);
+
+  // Nothing is saved while the cache is disabled
+  cache.saveFrame(key, 0, frame, 1);
+  QVERIFY(!cache.isInCache(key, 0));
+
+  cache.setCacheDirectory(cacheDir.path(), 100 * 1000 * 1000);
+  QVERIFY(cache.isEnabled());
+  cache.saveFrame(key, 0, frame, 1);
+  cache.saveFrame(key, 3, createFrameData(10000, 3), 2);
+  QVERIFY(cache.isInCache(key, 0));
+  QVERIFY(!cache.isInCache(key, 1));
+  QVERIFY(cache.isInCache(key, 3));
+
+  QByteArray data;
+  QVERIFY(cache.loadFrame(key, 0, data));
+  QCOMPARE(data, frame);
+  QVERIFY(cache.loadFrame(key, 3, data));
+  QCOMPARE(data, createFrameData(10000, 3));
+  QVERIFY(!cache.loadFrame(key, 1, data));
+  QVERIFY(!cache.loadFrame("otherKey", 0, data));
+
+  // A second instance with the same directory finds the frames
+  DiskFrameCache secondCache;
+  secondCache.setCacheDirectory(cacheDir.path(), 100 * 1000 * 1000);
+  QVERIFY(secondCache.loadFrame(key, 0, data));
+  QCOMPARE(data, frame);
+}
+
+void DiskFrameCacheTest::testSequenceKey()
+{
+  QTemporaryDir sourceDir;
+  QVERIFY(sourceDir.isValid());
+  const auto sourcePath = sourceDir.filePath("source.vvc");
+  writeFile(sourcePath, QByteArray(100, 'a'));
+
+  const auto settings = QStringList() << "VTM" << "0" << "4:2:0 10bit";
+  const auto key      = DiskFrameCache::getSequenceKey(sourcePath, settings);
+  QCOMPARE(DiskFrameCache::getSequenceKey(sourcePath, settings), key);
+
+  const auto otherSettings = QStringList() << "VTM" << "1" << "4:2:0 10bit";
+  QVERIFY(DiskFrameCache::getSequenceKey(sourcePath, otherSettings) != key);
+  QVERIFY(DiskFrameCache::getSequenceKey(sourceDir.filePath("other.vvc"), settings) != key);
+
+  // Modifying the source file changes the key
+  writeFile(sourcePath, QByteArray(101, 'a'));
+  QVERIFY(DiskFrameCache::getSequenceKey(sourcePath, settings) != key);
+}
+
+void DiskFrameCacheTest::testCorruptFrame()
+{
+  QTemporaryDir cacheDir;
+  QVERIFY(cacheDir.isValid());
+
+  DiskFrameCache cache;
+  cache.setCacheDirectory(cacheDir.path(), 100 * 1000 * 1000);
+
+  const auto key = QString("0123456789abcdef");
+  cache.saveFrame(key, 0, createFrameData(10000, 0), 1);
+  QVERIFY(cache.isInCache(key, 0));
+
+  // Overwrite the frame with data that can not be decompressed
+  const auto framePath = cacheDir.filePath(key + "/0.frame");
+  QVERIFY(QFile::exists(framePath));
+  writeFile(framePath, QByteArray("corrupt"));
+
+  QByteArray data;
+  QVERIFY(!cache.loadFrame(key, 0, data));
+  QVERIFY(!cache.isInCache(key, 0));
+}
+
+void DiskFrameCacheTest::testPrune()
+{
+  QTemporaryDir cacheDir;
+  QVERIFY(cacheDir.isValid());
+
+  // Random data does not compress so each frame needs about 100kB on disk
+  std::mt19937                       generator(42);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  QByteArray                         frame(100000, 0);
+  for (auto &value : frame)
+    value = char(distribution(generator));
+
+  DiskFrameCache cache;
+  cache.setCacheDirectory(cacheDir.path(), 250000);
+  for (int i = 0; i < 4; i++)
+    cache.saveFrame(QString("sequence%1").arg(i), 0, frame, 1);
+
+  int framesInCache = 0;
+  for (int i = 0; i < 4; i++)
+    if (cache.isInCache(QString("sequence%1").arg(i), 0))
+      framesInCache++;
+  QVERIFY(framesInCache >= 1);
+  QVERIFY(framesInCache <= 2);
+
+  // Files which were not created by the cache are never deleted
+  QVERIFY(QDir(cacheDir.path()).mkdir("userDir"));
+  writeFile(cacheDir.filePath("userDir/userFile.txt"), QByteArray(300000, 'a'));
+  cache.setCacheDirectory(cacheDir.path(), 1);
+  QVERIFY(QFile::exists(cacheDir.filePath("userDir/userFile.txt")));
+  for (int i = 0; i < 4; i++)
+    QVERIFY(!cache.isInCache(QString("sequence%1").arg(i), 0));
+}
+
+QTEST_MAIN(DiskFrameCacheTest)
+
+#include "DiskFrameCacheTest.moc"
@@ -0,0 +1,135 @@
+#include <QtTest>
+
+#include <video/FrameCache.h>
+
+using namespace video;
+
+class FrameCacheTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  FrameCacheTest(){};
+  ~FrameCacheTest(){};
+
+private slots:
+  void testInsertAndGet();
+  void testSizeAccounting();
+  void testRemoveOutsideOfRange();
+  void testMaxSize();
+};
+
+void FrameCacheTest::testInsertAndGet()
+{
+  FrameCache cache;
+  const int  owner1 = 0;
+  const int  owner2 = 0;
+
+  const auto rawData = QByteArray(100, 'a');
+  auto       image   = QImage(4, 4, QImage::Format_RGB32);
+  image.fill(Qt::red);
+
+  cache.insertRawData(&owner1, 3, rawData);
+  cache.insertImage(&owner2, 3, image);
+
+  QByteArray outputData;
+  QImage     outputImage;
+  QVERIFY(cache.getRawData(&owner1, 3, outputData));
+  QCOMPARE(outputData, rawData);
+  QVERIFY(cache.getImage(&owner2, 3, outputImage));
+  QCOMPARE(outputImage, image);
+
+  // A frame is either cached as raw data or as an image
+  QVERIFY(!cache.getImage(&owner1, 3, outputImage));
+  QVERIFY(!cache.getRawData(&owner1, 4, outputData));
+  QVERIFY(cache.contains(&owner1, 3));
+  QVERIFY(!cache.containsImage(&owner1, 3));
+  QVERIFY(cache.containsImage(&owner2, 3));
+
+  // Replacing the raw data with an image
+  cache.insertImage(&owner1, 3, image);
+  QVERIFY(cache.containsImage(&owner1, 3));
+  QCOMPARE(cache.getNrFrames(&owner1), 1);
+
+  const auto status = cache.getStatus();
+  QCOMPARE(status.nrFrames, 2);
+  QCOMPARE(status.hits, int64_t(2));
+  QCOMPARE(status.misses, int64_t(2));
+  QCOMPARE(status.evictions, int64_t(0));
+}
+
+void FrameCacheTest::testSizeAccounting()
+{
+  FrameCache cache;
+  const int  owner1 = 0;
+  const int  owner2 = 0;
+
+  for (int i = 0; i < 10; i++)
+    cache.insertRawData(&owner1, i, QByteArray(100 + i, 'a'));
+  cache.insertRawData(&owner2, 0, QByteArray(1000, 'b'));
+
+  QCOMPARE(cache.getSize(&owner1), int64_t(1045));
+  QCOMPARE(cache.getSize(&owner2), int64_t(1000));
+  QCOMPARE(cache.getStatus().size, int64_t(2045));
+
+  // Replacing a frame must not count it twice
+  cache.insertRawData(&owner1, 0, QByteArray(200, 'a'));
+  QCOMPARE(cache.getSize(&owner1), int64_t(1145));
+  QCOMPARE(cache.getNrFrames(&owner1), 10);
+
+  QCOMPARE(cache.remove(&owner1, 5), QByteArray(105, 'a'));
+  QVERIFY(cache.remove(&owner1, 5).isEmpty());
+  QCOMPARE(cache.getSize(&owner1), int64_t(1040));
+  QCOMPARE(cache.getStatus().evictions, int64_t(1));
+
+  cache.removeAll(&owner1);
+  QCOMPARE(cache.getSize(&owner1), int64_t(0));
+  QCOMPARE(cache.getNrFrames(&owner1), 0);
+  QCOMPARE(cache.getStatus().size, int64_t(1000));
+  QCOMPARE(cache.getStatus().nrFrames, 1);
+}
+
+void FrameCacheTest::testRemoveOutsideOfRange()
+{
+  FrameCache cache;
+  const int  owner = 0;
+
+  for (auto i : {7, 2, 9, 0, 4, 5, 1})
+    cache.insertRawData(&owner, i, QByteArray(10, 'a'));
+  QCOMPARE(cache.getFrames(&owner), QList<int>({0, 1, 2, 4, 5, 7, 9}));
+
+  cache.removeOutsideOfRange(&owner, 2, 7);
+  QCOMPARE(cache.getFrames(&owner), QList<int>({2, 4, 5, 7}));
+  QCOMPARE(cache.getSize(&owner), int64_t(40));
+  QCOMPARE(cache.getStatus().evictions, int64_t(3));
+
+  cache.removeOutsideOfRange(&owner, 10, 20);
+  QVERIFY(cache.getFrames(&owner).isEmpty());
+}
+
+void FrameCacheTest::testMaxSize()
+{
+  FrameCache cache;
+  const int  owner = 0;
+  cache.setMaxSize(350);
+
+  for (int i = 0; i < 3; i++)
+    cache.insertRawData(&owner, i, QByteArray(100, 'a'));
+
+  // Frame 0 is used again so frame 1 is the least recently used one
+  QByteArray output;
+  QVERIFY(cache.getRawData(&owner, 0, output));
+
+  cache.insertRawData(&owner, 3, QByteArray(100, 'a'));
+  QCOMPARE(cache.getFrames(&owner), QList<int>({0, 2, 3}));
+  QCOMPARE(cache.getStatus().size, int64_t(300));
+  QCOMPARE(cache.getStatus().evictions, int64_t(1));
+
+  // A frame that is bigger than the limit is still cached
+  cache.insertRawData(&owner, 4, QByteArray(500, 'a'));
+  QCOMPARE(cache.getFrames(&owner), QList<int>({4}));
+}
+
+QTEST_MAIN(FrameCacheTest)
+
+#include "FrameCacheTest.moc"
@@ -0,0 +1,147 @@
+#include <QtTest>
+
+#include <video/FrameMetrics.h>
+
+#include <cmath>
+#include <cstring>
+
+using namespace video;
+
+class FrameMetricsTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  FrameMetricsTest(){};
+  ~FrameMetricsTest(){};
+
+private slots:
+  void testIdenticalFrames();
+  void testLumaOffset();
+  void testHighBitDepth();
+  void testPlaneOrder();
+  void testStridedPlanes();
+  void testIncompatibleFormats();
+};
+
+namespace
+{
+
+const auto format420 = yuv::PixelFormatYUV(yuv::Subsampling::YUV_420, 8);
+const auto frameSize = Size(32, 16);
+
+QByteArray createFrame(char luma, char u, char v)
+{
+  const auto lumaSize   = int(frameSize.width * frameSize.height);
+  const auto chromaSize = lumaSize / 4;
+  return QByteArray(lumaSize, luma) + QByteArray(chromaSize, u) + QByteArray(chromaSize, v);
+}
+
+} // namespace
+
+void FrameMetricsTest::testIdenticalFrames()
+{
+  const auto frame   = createFrame(100, 50, 60);
+  const auto metrics = calculateFrameMetrics(frame, format420, frame, format420, frameSize);
+  QVERIFY(metrics);
+  QCOMPARE(metrics->components.size(), size_t(3));
+  for (const auto &component : metrics->components)
+  {
+    QCOMPARE(component.mse, 0.0);
+    QCOMPARE(component.psnr, MaxPSNR);
+    QCOMPARE(component.ssim, 1.0);
+  }
+}
+
+void FrameMetricsTest::testLumaOffset()
+{
+  const auto metrics = calculateFrameMetrics(
+      createFrame(102, 50, 60), format420, createFrame(100, 50, 60), format420, frameSize);
+  QVERIFY(metrics);
+  QCOMPARE(metrics->components[0].mse, 4.0);
+  QCOMPARE(metrics->components[0].psnr, 10.0 * std::log10(255.0 * 255.0 / 4.0));
+  QVERIFY(metrics->components[0].ssim < 1.0);
+  QVERIFY(metrics->components[0].ssim > 0.99);
+  QCOMPARE(metrics->components[1].mse, 0.0);
+  QCOMPARE(metrics->components[2].mse, 0.0);
+}
+
+void FrameMetricsTest::testHighBitDepth()
+{
+  const auto format400 = yuv::PixelFormatYUV(yuv::Subsampling::YUV_400, 10);
+  const auto nrSamples = int(frameSize.width * frameSize.height);
+
+  // Little endian samples 512 and 515
+  QByteArray frame, reference;
+  for (int i = 0; i < nrSamples; i++)
+  {
+    frame.append(char(3)).append(char(2));
+    reference.append(char(0)).append(char(2));
+  }
+
+  const auto metrics = calculateFrameMetrics(frame, format400, reference, format400, frameSize);
+  QVERIFY(metrics);
+  QCOMPARE(metrics->components.size(), size_t(1));
+  QCOMPARE(metrics->components[0].mse, 9.0);
+  QCOMPARE(metrics->components[0].psnr, 10.0 * std::log10(1023.0 * 1023.0 / 9.0));
+}
+
+void FrameMetricsTest::testPlaneOrder()
+{
+  const auto formatYVU = yuv::PixelFormatYUV(yuv::Subsampling::YUV_420, 8, yuv::PlaneOrder::YVU);
+  const auto metrics   = calculateFrameMetrics(
+      createFrame(100, 60, 50), formatYVU, createFrame(100, 50, 60), format420, frameSize);
+  QVERIFY(metrics);
+  for (const auto &component : metrics->components)
+    QCOMPARE(component.mse, 0.0);
+}
+
+void FrameMetricsTest::testStridedPlanes()
+{
+  // The same frame in planes with a stride of 64 bytes
+  const auto packed = createFrame(100, 50, 60);
+  const auto stride = size_t(64);
+  auto       memory = std::make_shared<QByteArray>(int(stride * frameSize.height * 2), char(0));
+
+  std::vector<FrameBuffer::Plane> planes;
+
+  auto src = reinterpret_cast<const unsigned char *>(packed.constData());
+  auto dst = reinterpret_cast<unsigned char *>(memory->data());
+  for (unsigned plane = 0; plane < 3; plane++)
+  {
+    FrameBuffer::Plane p;
+    p.lineBytes = (plane == 0) ? frameSize.width : frameSize.width / 2;
+    p.nrLines   = (plane == 0) ? frameSize.height : frameSize.height / 2;
+    p.stride    = stride;
+    p.data      = dst;
+    for (unsigned y = 0; y < p.nrLines; y++)
+    {
+      std::memcpy(dst, src, p.lineBytes);
+      src += p.lineBytes;
+      dst += p.stride;
+    }
+    planes.push_back(p);
+  }
+  const auto strided = FrameBuffer(planes, memory);
+
+  const auto metrics = calculateFrameMetrics(strided, format420, packed, format420, frameSize);
+  QVERIFY(metrics);
+  for (const auto &component : metrics->components)
+    QCOMPARE(component.mse, 0.0);
+}
+
+void FrameMetricsTest::testIncompatibleFormats()
+{
+  const auto frame      = createFrame(100, 50, 60);
+  const auto format10   = yuv::PixelFormatYUV(yuv::Subsampling::YUV_420, 10);
+  const auto formatNV12 = yuv::PixelFormatYUV(
+      yuv::Subsampling::YUV_420, 8, yuv::PlaneOrder::YUV, false, {}, true);
+  QVERIFY(!calculateFrameMetrics(frame, format420, frame, format10, frameSize));
+  QVERIFY(!calculateFrameMetrics(frame, formatNV12, frame, format420, frameSize));
+  // Not enough data for the frame size
+  QVERIFY(!calculateFrameMetrics(frame.left(100), format420, frame, format420, frameSize));
+}
+
+QTEST_MAIN(FrameMetricsTest)
+
+#include "FrameMetricsTest.moc"
@@ -0,0 +1,119 @@
+#include <QtTest>
+
+#include <video/FramePrefetch.h>
+
+using namespace video;
+
+class FramePrefetchTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  FramePrefetchTest(){};
+  ~FramePrefetchTest(){};
+
+private slots:
+  void testForward();
+  void testBackward();
+  void testStride();
+  void testRandomAccessPoints();
+  void testAllFramesReturned();
+  void testRandomAccessSegments();
+};
+
+namespace
+{
+
+using Frames = std::vector<int>;
+
+FrameAccessPattern makePattern(int currentFrame, int step, bool loop = false)
+{
+  FrameAccessPattern pattern;
+  pattern.currentFrame = currentFrame;
+  pattern.step         = step;
+  pattern.loop         = loop;
+  return pattern;
+}
+
+} // namespace
+
+void FramePrefetchTest::testForward()
+{
+  QCOMPARE(getPrefetchOrder(indexRange(0, 5), makePattern(2, 1), {}), Frames({2, 3, 4, 5, 1, 0}));
+  QCOMPARE(getPrefetchOrder(indexRange(0, 5), makePattern(2, 1, true), {}),
+           Frames({2, 3, 4, 5, 0, 1}));
+  // Without a current frame, start at the beginning of the range
+  QCOMPARE(getPrefetchOrder(indexRange(3, 6), makePattern(-1, 1), {}), Frames({3, 4, 5, 6}));
+  QCOMPARE(getPrefetchOrder(indexRange(3, 6), makePattern(10, 1), {}), Frames({6, 5, 4, 3}));
+  QVERIFY(getPrefetchOrder(indexRange(-1, -1), makePattern(0, 1), {}).empty());
+}
+
+void FramePrefetchTest::testBackward()
+{
+  QCOMPARE(getPrefetchOrder(indexRange(0, 5), makePattern(3, -1), {}), Frames({3, 2, 1, 0, 4, 5}));
+}
+
+void FramePrefetchTest::testStride()
+{
+  QCOMPARE(getPrefetchOrder(indexRange(0, 9), makePattern(1, 3), {}),
+           Frames({1, 4, 7, 2, 3, 5, 6, 8, 9, 0}));
+  QCOMPARE(getPrefetchOrder(indexRange(0, 9), makePattern(8, -3), {}),
+           Frames({8, 5, 2, 7, 6, 4, 3, 1, 0, 9}));
+}
+
+void FramePrefetchTest::testRandomAccessPoints()
+{
+  const auto randomAccessPoints = Frames({0, 4, 8});
+
+  // Going backwards, the frames of each chunk are returned in decoding order
+  QCOMPARE(getPrefetchOrder(indexRange(0, 9), makePattern(6, -1), randomAccessPoints),
+           Frames({4, 5, 6, 0, 1, 2, 3, 7, 8, 9}));
+  QCOMPARE(getPrefetchOrder(indexRange(0, 9), makePattern(9, -2), randomAccessPoints),
+           Frames({9, 5, 7, 1, 3, 8, 4, 6, 0, 2}));
+  // Going forward, the random access points do not change the order
+  QCOMPARE(getPrefetchOrder(indexRange(0, 9), makePattern(6, 1), randomAccessPoints),
+           Frames({6, 7, 8, 9, 4, 5, 0, 1, 2, 3}));
+  // The range does not start at a random access point
+  QCOMPARE(getPrefetchOrder(indexRange(2, 6), makePattern(6, -1), randomAccessPoints),
+           Frames({4, 5, 6, 2, 3}));
+}
+
+void FramePrefetchTest::testAllFramesReturned()
+{
+  for (auto step : {-7, -2, -1, 1, 2, 5})
+  {
+    for (auto currentFrame : {0, 13, 49})
+    {
+      auto frames = getPrefetchOrder(
+          indexRange(0, 49), makePattern(currentFrame, step), Frames({0, 10, 20, 30, 40}));
+      if (step > 0)
+        QCOMPARE(frames.front(), currentFrame);
+      std::sort(frames.begin(), frames.end());
+      QCOMPARE(frames.size(), size_t(50));
+      for (int i = 0; i < 50; i++)
+        QCOMPARE(frames[i], i);
+    }
+  }
+}
+
+void FramePrefetchTest::testRandomAccessSegments()
+{
+  const Frames randomAccessPoints({0, 8, 16});
+  QCOMPARE(getRandomAccessSegment(0, randomAccessPoints), 0);
+  QCOMPARE(getRandomAccessSegment(7, randomAccessPoints), 0);
+  QCOMPARE(getRandomAccessSegment(8, randomAccessPoints), 1);
+  QCOMPARE(getRandomAccessSegment(20, randomAccessPoints), 2);
+  QCOMPARE(getRandomAccessSegment(3, {5}), 0);
+
+  using Ranges = std::vector<indexRange>;
+  QCOMPARE(splitAtRandomAccessPoints(indexRange(0, 20), randomAccessPoints),
+           Ranges({indexRange(0, 7), indexRange(8, 15), indexRange(16, 20)}));
+  QCOMPARE(splitAtRandomAccessPoints(indexRange(10, 16), randomAccessPoints),
+           Ranges({indexRange(10, 15), indexRange(16, 16)}));
+  QCOMPARE(splitAtRandomAccessPoints(indexRange(2, 5), {}), Ranges({indexRange(2, 5)}));
+  QVERIFY(splitAtRandomAccessPoints(indexRange(5, 2), randomAccessPoints).empty());
+}
+
+QTEST_MAIN(FramePrefetchTest)
+
+#include "FramePrefetchTest.moc"
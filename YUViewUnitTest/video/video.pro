@@ -5,4 +5,11 @@ requires(qtHaveModule(testlib))
 SUBDIRS = PixelFormatYUVTest.pro \
           PixelFormatRGBTest.pro \
           PixelFormatYUVGuessTest.pro \
-          PixelFormatRGBGuessTest.pro
+          PixelFormatRGBGuessTest.pro \
+          ConversionYUVTest.pro \
+          CompressedFrameCacheTest.pro \
+          DiskFrameCacheTest.pro \
+          FrameCacheTest.pro \
+          FramePrefetchTest.pro \
+          BufferPoolTest.pro \
+          FrameMetricsTest.pro